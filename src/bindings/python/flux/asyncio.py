@@ -0,0 +1,106 @@
+###############################################################
+# Copyright 2020 Lawrence Livermore National Security, LLC
+# (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+#
+# This file is part of the Flux resource manager framework.
+# For details, see https://github.com/flux-framework.
+#
+# SPDX-License-Identifier: LGPL-3.0
+###############################################################
+
+"""Bridge a Flux handle into an asyncio event loop.
+
+The bridge registers the handle's edge-triggered pollfd (see
+flux_pollfd(3)) with the asyncio loop and runs the flux reactor
+without blocking whenever the descriptor becomes readable, so message
+handlers and future continuations are dispatched as asyncio callbacks.
+Any number of RPCs may then be awaited concurrently on one handle
+without threads:
+
+    import asyncio
+    import flux
+    from flux.asyncio import AsyncioBridge
+
+    async def main():
+        with AsyncioBridge(flux.Flux()) as bridge:
+            results = await asyncio.gather(
+                *[bridge.rpc("attr.get", {"name": "rank"})
+                  for _ in range(1000)]
+            )
+
+    asyncio.get_event_loop().run_until_complete(main())
+
+N.B. only message-driven activity is dispatched through the pollfd.
+Timer and other non-message flux watchers on the bridged handle do not
+wake the asyncio loop; use asyncio's own timers instead.
+"""
+
+import asyncio
+import errno
+
+import flux.constants
+from flux.core.inner import raw
+
+
+class AsyncioBridge:
+    """Dispatch a Flux handle's reactor from an asyncio event loop."""
+
+    def __init__(self, flux_handle, loop=None):
+        self.flux_handle = flux_handle
+        self.loop = loop if loop is not None else asyncio.get_event_loop()
+        self.pollfd = raw.flux_pollfd(flux_handle.handle)
+        self.reactor = flux_handle.get_reactor()
+        self.loop.add_reader(self.pollfd, self._pollfd_cb)
+
+    def _pollfd_cb(self):
+        events = raw.flux_pollevents(self.flux_handle.handle)
+        if events & flux.constants.FLUX_POLLERR:
+            raise OSError(errno.EIO, "flux handle poll error")
+        if events & (flux.constants.FLUX_POLLIN | flux.constants.FLUX_POLLOUT):
+            # Dispatch whatever is ready; the pollfd is re-raised by the
+            # handle if more work remains, re-entering this callback.
+            raw.flux_reactor_run(self.reactor, raw.FLUX_REACTOR_NOWAIT)
+
+    def wrap(self, future):
+        """Return an asyncio future fulfilled with flux future.get().
+
+        The flux future's then callback runs in the bridged reactor,
+        so the returned future resolves without blocking the loop.
+        """
+        aio_future = self.loop.create_future()
+
+        def continuation(fut, _arg):
+            if aio_future.cancelled():
+                return
+            try:
+                aio_future.set_result(fut.get())
+            except OSError as exc:
+                aio_future.set_exception(exc)
+
+        future.then(continuation)
+        return aio_future
+
+    def rpc(
+        self,
+        topic,
+        payload=None,
+        nodeid=flux.constants.FLUX_NODEID_ANY,
+        flags=0,
+    ):
+        """Send an RPC and return an awaitable for the decoded response."""
+        return self.wrap(self.flux_handle.rpc(topic, payload, nodeid, flags))
+
+    def close(self):
+        if self.pollfd is not None:
+            self.loop.remove_reader(self.pollfd)
+            self.pollfd = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, type_arg, value, _):
+        self.close()
+        return False
+
+
+# vi: ts=4 sw=4 expandtab
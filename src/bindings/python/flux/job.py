@@ -585,7 +585,13 @@ class JobListRPC(RPC):
 #
 # pylint: disable=dangerous-default-value
 def job_list(
-    flux_handle, max_entries=1000, attrs=[], userid=os.getuid(), states=0, results=0
+    flux_handle,
+    max_entries=1000,
+    attrs=[],
+    userid=os.getuid(),
+    states=0,
+    results=0,
+    before=0.0,
 ):
     payload = {
         "max_entries": int(max_entries),
@@ -594,6 +600,10 @@ def job_list(
         "states": states,
         "results": results,
     }
+    # before > 0. pages through inactive jobs: only jobs with
+    # t_inactive older than the timestamp are returned
+    if before > 0.0:
+        payload["before"] = float(before)
     return JobListRPC(flux_handle, "job-info.list", payload)
 
 
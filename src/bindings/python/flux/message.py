@@ -92,9 +92,30 @@ class Message(WrapperPimpl):
     def payload_str(self, value):
         self.pimpl.set_string(value)
 
+    @property
+    def payload_bytes(self):
+        """Message payload as a zero-copy memoryview, or None.
+
+        The view aliases message-owned storage and is only valid for
+        the lifetime of this message.  String payloads include their
+        NUL terminator in the view.
+        """
+        if not self.pimpl.has_payload():
+            return None
+        buf = ffi.new("void *[1]")
+        length = ffi.new("int [1]")
+        self.pimpl.get_payload(buf, length)
+        return memoryview(ffi.buffer(buf[0], length[0]))
+
     @property
     def payload(self):
-        return json.loads(self.payload_str)
+        view = self.payload_bytes
+        if view is None:
+            return None
+        payload = view.tobytes()
+        if payload.endswith(b"\x00"):
+            payload = payload[:-1]
+        return json.loads(payload.decode("utf-8"))
 
     @payload.setter
     def payload(self, value):
@@ -73,8 +73,27 @@ class RPC(Future):
             return None
         return ffi.string(payload_str[0]).decode("utf-8")
 
+    def get_raw(self):
+        """Return the response payload as a zero-copy memoryview.
+
+        The view aliases storage owned by the underlying future and is
+        only valid until this RPC object is destroyed or reset.  String
+        payloads include their NUL terminator in the view.
+        """
+        data = ffi.new("void *[1]")
+        length = ffi.new("int [1]")
+        self.pimpl.flux_rpc_get_raw(data, length)
+        if data[0] == ffi.NULL:
+            return None
+        return memoryview(ffi.buffer(data[0], length[0]))
+
     def get(self):
-        resp_str = self.get_str()
-        if resp_str is None:
+        view = self.get_raw()
+        if view is None:
+            return None
+        payload = view.tobytes()
+        if payload.endswith(b"\x00"):
+            payload = payload[:-1]
+        if not payload:
             return None
-        return json.loads(resp_str)
+        return json.loads(payload.decode("utf-8"))
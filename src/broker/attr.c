@@ -11,16 +11,117 @@
 #if HAVE_CONFIG_H
 #include "config.h"
 #endif
+#include <pthread.h>
 #include <czmq.h>
 #include <jansson.h>
 
 #include "attr.h"
 
+/* Reader-optimized copy of the attribute set, shared with module
+ * threads.  It mirrors the subset attr.dump reports (passive entries
+ * plus immutable active ones) so that module threads can resolve
+ * rank-local attributes without a round trip to the main thread.
+ * Reads take the rwlock shared; the table is only replaced wholesale
+ * under the exclusive lock when an attribute changes, so an uncontended
+ * read costs one rwlock acquisition and a hash lookup.  Refcounted
+ * because module threads hold references that may outlive attr_destroy()
+ * during broker teardown.
+ */
+struct attr_shared {
+    pthread_rwlock_t lock;
+    zhash_t *table;         /* name -> value string copy */
+    int refcount;           /* guarded by wrlock */
+};
+
 struct broker_attr {
     zhash_t *hash;
+    uint32_t generation;    /* incremented on any change, for cache checks */
+    flux_t *h;              /* set once handlers are registered */
     flux_msg_handler_t **handlers;
+    attr_shared_t *shared;
 };
 
+static attr_shared_t *attr_shared_create (void)
+{
+    attr_shared_t *sh = calloc (1, sizeof (*sh));
+    if (!sh) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    if (!(sh->table = zhash_new ())) {
+        free (sh);
+        errno = ENOMEM;
+        return NULL;
+    }
+    pthread_rwlock_init (&sh->lock, NULL);
+    sh->refcount = 1;
+    return sh;
+}
+
+void attr_shared_incref (attr_shared_t *sh)
+{
+    if (sh) {
+        pthread_rwlock_wrlock (&sh->lock);
+        sh->refcount++;
+        pthread_rwlock_unlock (&sh->lock);
+    }
+}
+
+void attr_shared_decref (attr_shared_t *sh)
+{
+    int n;
+
+    if (!sh)
+        return;
+    pthread_rwlock_wrlock (&sh->lock);
+    n = --sh->refcount;
+    pthread_rwlock_unlock (&sh->lock);
+    if (n == 0) {
+        pthread_rwlock_destroy (&sh->lock);
+        zhash_destroy (&sh->table);
+        free (sh);
+    }
+}
+
+char *attr_shared_get (attr_shared_t *sh, const char *name)
+{
+    const char *val;
+    char *cpy = NULL;
+
+    pthread_rwlock_rdlock (&sh->lock);
+    if (!(val = zhash_lookup (sh->table, name)))
+        errno = ENOENT;
+    else if (!(cpy = strdup (val)))
+        errno = ENOMEM;
+    pthread_rwlock_unlock (&sh->lock);
+    return cpy;
+}
+
+attr_shared_t *attr_get_shared (attr_t *attrs)
+{
+    return attrs->shared;
+}
+
+static void shared_update (attr_t *attrs);
+
+/* Announce a change to the attribute set so that clients holding a bulk
+ * cache (see attr.dump below) can invalidate it.  Fire and forget; the
+ * event is advisory and a lost one only costs cache effectiveness.
+ */
+static void publish_change (attr_t *attrs)
+{
+    flux_future_t *f;
+
+    attrs->generation++;
+    shared_update (attrs);
+    if (!attrs->h)
+        return;
+    if (!(f = flux_event_publish_pack (attrs->h, "attr", 0, "{s:i}",
+                                       "generation", attrs->generation)))
+        FLUX_LOG_ERROR (attrs->h);
+    flux_future_destroy (f);
+}
+
 struct entry {
     char *name;
     char *val;
@@ -68,6 +169,44 @@ cleanup:
     return NULL;
 }
 
+/* Rebuild the shared table from the current attribute set and swap it
+ * in under the write lock, so readers never see a partial update.
+ * Entries whose value can change without a generation bump (active,
+ * not immutable) are omitted; module-side lookups fall back to
+ * attr.get for those.  On allocation failure the old table is kept;
+ * readers see stale values until the next change.
+ */
+static void shared_update (attr_t *attrs)
+{
+    attr_shared_t *sh = attrs->shared;
+    zhash_t *table, *old;
+    struct entry *e;
+
+    if (!sh)
+        return;
+    if (!(table = zhash_new ()))
+        return;
+    e = zhash_first (attrs->hash);
+    while (e) {
+        if (e->val && (!(e->flags & FLUX_ATTRFLAG_ACTIVE)
+                        || (e->flags & FLUX_ATTRFLAG_IMMUTABLE))) {
+            char *cpy;
+            if ((cpy = strdup (e->val))) {
+                if (zhash_insert (table, e->name, cpy) == 0)
+                    zhash_freefn (table, e->name, free);
+                else
+                    free (cpy);
+            }
+        }
+        e = zhash_next (attrs->hash);
+    }
+    pthread_rwlock_wrlock (&sh->lock);
+    old = sh->table;
+    sh->table = table;
+    pthread_rwlock_unlock (&sh->lock);
+    zhash_destroy (&old);
+}
+
 int attr_delete (attr_t *attrs, const char *name, bool force)
 {
     struct entry *e;
@@ -84,6 +223,7 @@ int attr_delete (attr_t *attrs, const char *name, bool force)
             goto done;
         }
         zhash_delete (attrs->hash, name);
+        publish_change (attrs);
     }
     rc = 0;
 done:
@@ -105,6 +245,7 @@ int attr_add (attr_t *attrs, const char *name, const char *val, int flags)
     e = entry_create (name, val, flags);
     zhash_update (attrs->hash, name, e);
     zhash_freefn (attrs->hash, name, entry_destroy);
+    publish_change (attrs);
     return 0;
 }
 
@@ -129,6 +270,7 @@ int attr_add_active (attr_t *attrs, const char *name, int flags,
     e->flags |= FLUX_ATTRFLAG_ACTIVE;
     zhash_update (attrs->hash, name, e);
     zhash_freefn (attrs->hash, name, entry_destroy);
+    publish_change (attrs);
     rc = 0;
 done:
     return rc;
@@ -200,6 +342,7 @@ int attr_set (attr_t *attrs, const char *name, const char *val, bool force)
     }
     else
         e->val = NULL;
+    publish_change (attrs);
     rc = 0;
 done:
     return rc;
@@ -397,6 +540,59 @@ error:
         FLUX_LOG_ERROR (h);
 }
 
+/* Return all attributes and their flags in one response, tagged with the
+ * current generation number so that clients can cache the whole set and
+ * invalidate it when an 'attr' event announces a newer generation.
+ * Active attributes that are not immutable are omitted since their values
+ * can change without a generation bump; clients fall back to attr.get
+ * for those.
+ */
+void dumpattr_request_cb (flux_t *h, flux_msg_handler_t *mh,
+                          const flux_msg_t *msg, void *arg)
+{
+    attr_t *attrs = arg;
+    const char *name;
+    const char *val;
+    int flags;
+    json_t *dump = NULL, *entry;
+
+    if (flux_request_decode (msg, NULL, NULL) < 0)
+        goto error;
+    if (!(dump = json_object ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    name = attr_first (attrs);
+    while (name) {
+        if (attr_get (attrs, name, &val, &flags) == 0 && val != NULL
+            && (!(flags & FLUX_ATTRFLAG_ACTIVE)
+                || (flags & FLUX_ATTRFLAG_IMMUTABLE))) {
+            if (!(entry = json_pack ("{s:s s:i}",
+                                     "value", val,
+                                     "flags", flags))) {
+                errno = ENOMEM;
+                goto error;
+            }
+            if (json_object_set_new (dump, name, entry) < 0) {
+                json_decref (entry);
+                errno = ENOMEM;
+                goto error;
+            }
+        }
+        name = attr_next (attrs);
+    }
+    if (flux_respond_pack (h, msg, "{s:i s:O}",
+                                   "generation", attrs->generation,
+                                   "attrs", dump) < 0)
+        FLUX_LOG_ERROR (h);
+    json_decref (dump);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        FLUX_LOG_ERROR (h);
+    json_decref (dump);
+}
+
 void lsattr_request_cb (flux_t *h, flux_msg_handler_t *mh,
                         const flux_msg_t *msg, void *arg)
 {
@@ -439,6 +635,7 @@ error:
 
 static const struct flux_msg_handler_spec handlers[] = {
     { FLUX_MSGTYPE_REQUEST, "attr.get",    getattr_request_cb, FLUX_ROLE_ALL },
+    { FLUX_MSGTYPE_REQUEST, "attr.dump",   dumpattr_request_cb, FLUX_ROLE_ALL },
     { FLUX_MSGTYPE_REQUEST, "attr.list",   lsattr_request_cb, FLUX_ROLE_ALL },
     { FLUX_MSGTYPE_REQUEST, "attr.set",    setattr_request_cb, 0 },
     { FLUX_MSGTYPE_REQUEST, "attr.rm",     rmattr_request_cb, 0 },
@@ -450,6 +647,7 @@ int attr_register_handlers (attr_t *attrs, flux_t *h)
 {
     if (flux_msg_handler_addvec (h, handlers, attrs, &attrs->handlers) < 0)
         return -1;
+    attrs->h = h;
     return 0;
 }
 
@@ -465,6 +663,11 @@ attr_t *attr_create (void)
         errno = ENOMEM;
         return NULL;
     }
+    if (!(attrs->shared = attr_shared_create ())) {
+        attr_destroy (attrs);
+        errno = ENOMEM;
+        return NULL;
+    }
     return attrs;
 }
 
@@ -473,6 +676,7 @@ void attr_destroy (attr_t *attrs)
     if (attrs) {
         if (attrs->handlers)
             flux_msg_handler_delvec (attrs->handlers);
+        attr_shared_decref (attrs->shared);
         zhash_destroy (&attrs->hash);
         free (attrs);
     }
@@ -29,6 +29,11 @@ typedef int (*attr_set_f)(const char *name, const char *val, void *arg);
 
 typedef struct broker_attr attr_t;
 
+/* Reader-optimized view of the attribute set, shared with module
+ * threads (see attr_get_shared below).
+ */
+typedef struct attr_shared attr_shared_t;
+
 /* Create/destroy attribute cache
  */
 attr_t *attr_create (void);
@@ -80,6 +85,20 @@ int attr_add_active_uint32 (attr_t *attrs, const char *name, uint32_t *val,
 const char *attr_first (attr_t *attrs);
 const char *attr_next (attr_t *attrs);
 
+/* Get the shared view, covering the same subset as attr.dump (passive
+ * attributes plus immutable active ones).  It is owned by 'attrs';
+ * holders that may outlive attr_destroy() must take a reference.
+ */
+attr_shared_t *attr_get_shared (attr_t *attrs);
+void attr_shared_incref (attr_shared_t *sh);
+void attr_shared_decref (attr_shared_t *sh);
+
+/* Thread-safe lookup in the shared view, callable from any thread.
+ * Returns a copy of the value (caller must free), or NULL with errno
+ * set (ENOENT if not present in the view).
+ */
+char *attr_shared_get (attr_shared_t *sh, const char *name);
+
 #endif /* BROKER_ATTR_H */
 
 /*
@@ -15,6 +15,7 @@
 #endif
 #include <unistd.h>
 #include <stdbool.h>
+#include <string.h>
 #include <assert.h>
 #include <jansson.h>
 #include <flux/core.h>
@@ -22,6 +23,7 @@
 #include "src/common/libutil/log.h"
 #include "src/common/libutil/kary.h"
 #include "src/common/libutil/errno_safe.h"
+#include "src/common/libutil/hostcache.h"
 #include "src/common/libidset/idset.h"
 
 #include "attr.h"
@@ -356,6 +358,48 @@ int boot_config_geturibyrank (json_t *hosts,
     return 0;
 }
 
+/* Pre-resolve the host portion of a tcp:// URI to a numeric address,
+ * consulting a per-user cache persisted across restarts, so that the
+ * overlay connect cannot block on a slow DNS server while the broker
+ * boots.  On any parse or resolution failure the URI is left unmodified
+ * and name resolution is deferred to the connect, as before.
+ */
+static void boot_config_resolve_uri (char *uri, int bufsz)
+{
+    struct hostcache *hc;
+    char host[MAX_URI + 1];
+    char addr[MAX_URI + 1];
+    char nuri[MAX_URI + 1];
+    const char *p = uri;
+    const char *colon;
+    int len;
+    int n;
+
+    if (strncmp (p, "tcp://", 6) != 0)
+        return;
+    p += 6;
+    if (*p == '[') /* bracketed IPv6 literal - already numeric */
+        return;
+    if (!(colon = strrchr (p, ':')))
+        return;
+    len = colon - p;
+    if (len <= 0 || len >= (int)sizeof (host))
+        return;
+    memcpy (host, p, len);
+    host[len] = '\0';
+    if (!(hc = hostcache_create (NULL)))
+        return;
+    if (hostcache_resolve (hc, host, addr, sizeof (addr)) == 0) {
+        if (strchr (addr, ':')) /* IPv6 literal must be bracketed */
+            n = snprintf (nuri, sizeof (nuri), "tcp://[%s]%s", addr, colon);
+        else
+            n = snprintf (nuri, sizeof (nuri), "tcp://%s%s", addr, colon);
+        if (n < (int)sizeof (nuri) && n < bufsz)
+            strcpy (uri, nuri);
+    }
+    hostcache_destroy (hc);
+}
+
 int boot_config (flux_t *h, struct overlay *overlay, attr_t *attrs, int tbon_k)
 {
     struct boot_conf conf;
@@ -463,6 +507,7 @@ int boot_config (flux_t *h, struct overlay *overlay, attr_t *attrs, int tbon_k)
                                       parent_uri,
                                       sizeof (parent_uri)) < 0)
             goto error;
+        boot_config_resolve_uri (parent_uri, sizeof (parent_uri));
         if (overlay_set_parent (overlay, parent_uri) < 0) {
             log_err ("overlay_set_parent %s", parent_uri);
             goto error;
@@ -271,12 +271,18 @@ int boot_pmi (struct overlay *overlay, attr_t *attrs, int tbon_k)
     }
 
     /* The PMI barrier (which is implicitly over 'size' ranks) ensures that
-     * all KVS puts are complete before any PMI gets.
+     * all KVS puts are complete before any PMI gets.  The exchange is
+     * deliberately O(1) keys per rank: each rank publishes only its child
+     * endpoint and fetches only its TBON parent's, so boot volume scales
+     * with the broker count, not its square.  A single-broker instance
+     * has nothing to exchange, so the barriers are skipped entirely.
      */
-    result = broker_pmi_barrier (pmi);
-    if (result != PMI_SUCCESS) {
-        log_msg ("broker_pmi_barrier: %s", pmi_strerror (result));
-        goto error;
+    if (pmi_params.size > 1) {
+        result = broker_pmi_barrier (pmi);
+        if (result != PMI_SUCCESS) {
+            log_msg ("broker_pmi_barrier: %s", pmi_strerror (result));
+            goto error;
+        }
     }
 
     /* If there is to be an upstream peer, fetch its URI from PMI KVS.
@@ -301,10 +307,12 @@ int boot_pmi (struct overlay *overlay, attr_t *attrs, int tbon_k)
         }
     }
 
-    result = broker_pmi_barrier (pmi);
-    if (result != PMI_SUCCESS) {
-        log_msg ("broker_pmi_barrier: %s", pmi_strerror (result));
-        goto error;
+    if (pmi_params.size > 1) {
+        result = broker_pmi_barrier (pmi);
+        if (result != PMI_SUCCESS) {
+            log_msg ("broker_pmi_barrier: %s", pmi_strerror (result));
+            goto error;
+        }
     }
 
     result = broker_pmi_finalize (pmi);
@@ -70,9 +70,11 @@
 #include "content-cache.h"
 #include "runat.h"
 #include "heaptrace.h"
+#include "flightrec.h"
 #include "exec.h"
 #include "ping.h"
 #include "rusage.h"
+#include "reactorstats.h"
 #include "boot_config.h"
 #include "boot_pmi.h"
 #include "publisher.h"
@@ -81,11 +83,16 @@
 #include "broker.h"
 
 
+/* The request/response routing functions may take ownership of '*msg'
+ * (setting it to NULL) when the message is delivered to a co-resident
+ * endpoint by reference rather than by copy.  On failure, ownership
+ * remains with the caller.
+ */
 static int broker_event_sendmsg (broker_ctx_t *ctx, const flux_msg_t *msg);
-static int broker_response_sendmsg (broker_ctx_t *ctx, const flux_msg_t *msg);
-static void broker_request_sendmsg (broker_ctx_t *ctx, const flux_msg_t *msg);
+static int broker_response_sendmsg (broker_ctx_t *ctx, flux_msg_t **msg);
+static void broker_request_sendmsg (broker_ctx_t *ctx, flux_msg_t **msg);
 static int broker_request_sendmsg_internal (broker_ctx_t *ctx,
-                                            const flux_msg_t *msg);
+                                            flux_msg_t **msg);
 
 static void parent_cb (struct overlay *ov, void *sock, void *arg);
 static void child_cb (struct overlay *ov, void *sock, void *arg);
@@ -514,6 +521,10 @@ int main (int argc, char *argv[])
         log_err ("heaptrace_initialize");
         goto cleanup;
     }
+    if (flightrec_initialize (ctx.h) < 0) {
+        log_err ("flightrec_initialize");
+        goto cleanup;
+    }
     if (exec_initialize (ctx.h, ctx.rank, ctx.attrs) < 0) {
         log_err ("exec_initialize");
         goto cleanup;
@@ -526,6 +537,10 @@ int main (int argc, char *argv[])
         log_err ("rusage_initialize");
         goto cleanup;
     }
+    if (reactorstats_initialize (ctx.h, "cmb") < 0) {
+        log_err ("reactorstats_initialize");
+        goto cleanup;
+    }
 
     if (!(handlers = broker_add_services (&ctx))) {
         log_err ("broker_add_services");
@@ -539,6 +554,7 @@ int main (int argc, char *argv[])
     modhash_set_rank (ctx.modhash, ctx.rank);
     modhash_set_flux (ctx.modhash, ctx.h);
     modhash_set_heartbeat (ctx.modhash, ctx.heartbeat);
+    modhash_set_attr_shared (ctx.modhash, attr_get_shared (ctx.attrs));
 
     /* install heartbeat (including timer on rank 0)
      */
@@ -559,6 +575,15 @@ int main (int argc, char *argv[])
         log_msg ("installing session heartbeat: T=%0.1fs",
                   heartbeat_get_rate (ctx.heartbeat));
 
+    /* Pace content cache purge off the heartbeat interval, with a
+     * per-process jittered phase to avoid synchronized wakeups.
+     */
+    if (content_cache_set_purge_interval (ctx.cache,
+                                heartbeat_get_rate (ctx.heartbeat)) < 0) {
+        log_err ("content_cache_set_purge_interval");
+        goto cleanup;
+    }
+
     /* Configure broker state machine
      */
     if (!(ctx.state_machine = state_machine_create (&ctx))) {
@@ -1010,10 +1035,10 @@ static bool nodeset_member (const char *s, uint32_t rank)
     return member;
 }
 
-static int mod_svc_cb (const flux_msg_t *msg, void *arg)
+static int mod_svc_cb (flux_msg_t **msg, void *arg)
 {
     module_t *p = arg;
-    int rc = module_sendmsg (p, msg);
+    int rc = module_sendmsg_take (p, msg);
     return rc;
 }
 
@@ -1314,10 +1339,10 @@ error:
     free (uuid);
 }
 
-static int route_to_handle (const flux_msg_t *msg, void *arg)
+static int route_to_handle (flux_msg_t **msg, void *arg)
 {
     broker_ctx_t *ctx = arg;
-    if (flux_requeue (ctx->h, msg, FLUX_RQ_TAIL) < 0)
+    if (flux_requeue (ctx->h, *msg, FLUX_RQ_TAIL) < 0)
         flux_log_error (ctx->h, "%s: flux_requeue\n", __FUNCTION__);
     return 0;
 }
@@ -1480,6 +1505,7 @@ static struct internal_service services[] = {
     { "hello",              NULL },
     { "attr",               NULL },
     { "heaptrace",          NULL },
+    { "trace",              NULL },
     { "event",              "[0]" },
     { "service",            NULL },
     { "overlay",            NULL },
@@ -1536,16 +1562,21 @@ static void child_cb (struct overlay *ov, void *sock, void *arg)
 
     if (!msg)
         goto done;
+    flightrec_record (flightrec_ring ("overlay-child"), FLIGHTREC_RX, msg);
     if (flux_msg_get_type (msg, &type) < 0)
         goto done;
     if (flux_msg_get_route_last (msg, &uuid) < 0)
         goto done;
     overlay_checkin_child (ctx->overlay, uuid);
     switch (type) {
-        case FLUX_MSGTYPE_KEEPALIVE:
+        case FLUX_MSGTYPE_KEEPALIVE: {
+            int ka_errnum, ka_status;
+            if (flux_keepalive_decode (msg, &ka_errnum, &ka_status) == 0)
+                overlay_keepalive_child (ctx->overlay, uuid, ka_status);
             break;
+        }
         case FLUX_MSGTYPE_REQUEST:
-            broker_request_sendmsg (ctx, msg);
+            broker_request_sendmsg (ctx, &msg);
             break;
         case FLUX_MSGTYPE_RESPONSE:
             /* TRICKY:  Fix up ROUTER socket used in reverse direction.
@@ -1560,7 +1591,7 @@ static void child_cb (struct overlay *ov, void *sock, void *arg)
              */
             (void)flux_msg_pop_route (msg, NULL);
             (void)flux_msg_pop_route (msg, NULL);
-            if (broker_response_sendmsg (ctx, msg) < 0)
+            if (broker_response_sendmsg (ctx, &msg) < 0)
                 goto done;
             break;
         case FLUX_MSGTYPE_EVENT:
@@ -1631,11 +1662,12 @@ static void parent_cb (struct overlay *ov, void *sock, void *arg)
 
     if (!msg)
         goto done;
+    flightrec_record (flightrec_ring ("overlay-parent"), FLIGHTREC_RX, msg);
     if (flux_msg_get_type (msg, &type) < 0)
         goto done;
     switch (type) {
         case FLUX_MSGTYPE_RESPONSE:
-            if (broker_response_sendmsg (ctx, msg) < 0)
+            if (broker_response_sendmsg (ctx, &msg) < 0)
                 goto done;
             break;
         case FLUX_MSGTYPE_EVENT:
@@ -1647,7 +1679,7 @@ static void parent_cb (struct overlay *ov, void *sock, void *arg)
                 goto done;
             break;
         case FLUX_MSGTYPE_REQUEST:
-            broker_request_sendmsg (ctx, msg);
+            broker_request_sendmsg (ctx, &msg);
             break;
         default:
             flux_log (ctx->h, LOG_ERR, "%s: unexpected %s", __FUNCTION__,
@@ -1663,7 +1695,12 @@ done:
 void disconnect_send_cb (const flux_msg_t *msg, void *arg)
 {
     broker_ctx_t *ctx = arg;
-    broker_request_sendmsg (ctx, msg);
+    flux_msg_t *cpy;
+
+    if (!(cpy = flux_msg_copy (msg, true)))
+        return;
+    broker_request_sendmsg (ctx, &cpy);
+    flux_msg_destroy (cpy);
 }
 
 /* Handle messages on the service socket of a comms module.
@@ -1681,16 +1718,19 @@ static void module_cb (module_t *p, void *arg)
         goto done;
     switch (type) {
         case FLUX_MSGTYPE_RESPONSE:
-            (void)broker_response_sendmsg (ctx, msg);
+            (void)broker_response_sendmsg (ctx, &msg);
             break;
         case FLUX_MSGTYPE_REQUEST:
-            broker_request_sendmsg (ctx, msg);
+            /* Arm disconnect notification before routing - the router may
+             * take ownership of the message.
+             */
             if (flux_msg_get_route_count (msg) == 1
                 && module_disconnect_arm (p, msg, disconnect_send_cb, ctx) < 0) {
                     flux_log_error (ctx->h,
                                     "%s: module_disconnect_arm",
                                     module_get_name (p));
             }
+            broker_request_sendmsg (ctx, &msg);
             break;
         case FLUX_MSGTYPE_EVENT:
             if (broker_event_sendmsg (ctx, msg) < 0) {
@@ -1848,23 +1888,24 @@ done:
     return rc;
 }
 
-/* Route request.
- * On success, return 0.  On failure, return -1 with errno set.
+/* Route request.  A local service callback may take ownership of '*msg'.
+ * On success, return 0.  On failure, return -1 with errno set and
+ * ownership retained by the caller.
  */
 static int broker_request_sendmsg_internal (broker_ctx_t *ctx,
-                                            const flux_msg_t *msg)
+                                            flux_msg_t **msg)
 {
     uint32_t nodeid;
     uint8_t flags;
 
-    if (flux_msg_get_nodeid (msg, &nodeid) < 0)
+    if (flux_msg_get_nodeid (*msg, &nodeid) < 0)
         return -1;
-    if (flux_msg_get_flags (msg, &flags) < 0)
+    if (flux_msg_get_flags (*msg, &flags) < 0)
         return -1;
     /* Route up TBON if destination if upstream of this broker.
      */
     if ((flags & FLUX_MSGFLAG_UPSTREAM) && nodeid == ctx->rank) {
-        if (overlay_sendmsg_parent (ctx->overlay, msg) < 0)
+        if (overlay_sendmsg_parent (ctx->overlay, *msg) < 0)
             return -1;
     }
     /* Deliver to local service if destination *could* be this broker.
@@ -1875,7 +1916,7 @@ static int broker_request_sendmsg_internal (broker_ctx_t *ctx,
         if (service_send (ctx->services, msg) < 0) {
             if (errno != ENOSYS)
                 return -1;
-            if (overlay_sendmsg_parent (ctx->overlay, msg) < 0) {
+            if (overlay_sendmsg_parent (ctx->overlay, *msg) < 0) {
                 if (errno == EHOSTUNREACH)
                     errno = ENOSYS;
                 return -1;
@@ -1894,11 +1935,11 @@ static int broker_request_sendmsg_internal (broker_ctx_t *ctx,
         uint32_t down_rank;
         down_rank = kary_child_route (ctx->tbon_k, ctx->size, ctx->rank, nodeid);
         if (down_rank == KARY_NONE) { // up
-            if (overlay_sendmsg_parent (ctx->overlay, msg) < 0)
+            if (overlay_sendmsg_parent (ctx->overlay, *msg) < 0)
                 return -1;
         }
         else { // down
-            if (sendmsg_child_request (ctx, msg, down_rank) < 0)
+            if (sendmsg_child_request (ctx, *msg, down_rank) < 0)
                 return -1;
         }
     }
@@ -1909,20 +1950,20 @@ static int broker_request_sendmsg_internal (broker_ctx_t *ctx,
  * generate an error response.  Make an extra effort to return a useful
  * error message if ENOSYS indicates an unmatched service name.
  */
-static void broker_request_sendmsg (broker_ctx_t *ctx, const flux_msg_t *msg)
+static void broker_request_sendmsg (broker_ctx_t *ctx, flux_msg_t **msg)
 {
     if (broker_request_sendmsg_internal (ctx, msg) < 0) {
         const char *topic;
         char errbuf[64];
         const char *errstr = NULL;
 
-        if (errno == ENOSYS && flux_msg_get_topic (msg, &topic) == 0) {
+        if (errno == ENOSYS && flux_msg_get_topic (*msg, &topic) == 0) {
             snprintf (errbuf,
                       sizeof (errbuf),
                       "No service matching %s is registered", topic);
             errstr = errbuf;
         }
-        if (flux_respond_error (ctx->h, msg, errno, errstr) < 0)
+        if (flux_respond_error (ctx->h, *msg, errno, errstr) < 0)
             flux_log_error (ctx->h, "flux_respond");
     }
 }
@@ -1966,16 +2007,16 @@ static bool is_my_parent (broker_ctx_t *ctx, uint32_t rank)
  * If the next hop is a rank, route up or down the TBON.
  * If not a rank, look up a comms module by uuid.
  */
-static int broker_response_sendmsg (broker_ctx_t *ctx, const flux_msg_t *msg)
+static int broker_response_sendmsg (broker_ctx_t *ctx, flux_msg_t **msg)
 {
     int rc = -1;
     char *uuid = NULL;
     uint32_t rank;
 
-    if (flux_msg_get_route_last (msg, &uuid) < 0)
+    if (flux_msg_get_route_last (*msg, &uuid) < 0)
         goto done;
     if (uuid == NULL) { // broker resident service
-        if (flux_requeue (ctx->h, msg, FLUX_RQ_TAIL) < 0)
+        if (flux_requeue (ctx->h, *msg, FLUX_RQ_TAIL) < 0)
             goto done;
     }
     else if (uuid_to_rank (uuid, ctx->size, &rank)) {
@@ -1985,11 +2026,11 @@ static int broker_response_sendmsg (broker_ctx_t *ctx, const flux_msg_t *msg)
              * on, so the upstream broker must to detect this case and pop
              * *two* off to maintain route stack integrity.  See child_cb().
              */
-            if (overlay_sendmsg_parent (ctx->overlay, msg) < 0)
+            if (overlay_sendmsg_parent (ctx->overlay, *msg) < 0)
                 goto done;
         }
         else {
-            if (overlay_sendmsg_child (ctx->overlay, msg) < 0) {
+            if (overlay_sendmsg_child (ctx->overlay, *msg) < 0) {
                 if (errno == EINVAL)
                     errno = EHOSTUNREACH;
                 goto done;
@@ -2061,10 +2102,10 @@ static int broker_send (void *impl, const flux_msg_t *msg, int flags)
 
     switch (type) {
         case FLUX_MSGTYPE_REQUEST:
-            rc = broker_request_sendmsg_internal (ctx, cpy);
+            rc = broker_request_sendmsg_internal (ctx, &cpy);
             break;
         case FLUX_MSGTYPE_RESPONSE:
-            rc = broker_response_sendmsg (ctx, cpy);
+            rc = broker_response_sendmsg (ctx, &cpy);
             break;
         case FLUX_MSGTYPE_EVENT:
             rc = broker_event_sendmsg (ctx, cpy);
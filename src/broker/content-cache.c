@@ -13,13 +13,18 @@
 #if HAVE_CONFIG_H
 #include "config.h"
 #endif
+#include <stdio.h>
 #include <inttypes.h>
+#include <unistd.h>
 #include <czmq.h>
+#include <jansson.h>
 #include <flux/core.h>
 #include "src/common/libutil/errno_safe.h"
 #include "src/common/libutil/blobref.h"
 #include "src/common/libutil/iterators.h"
 #include "src/common/libutil/log.h"
+#include "src/common/libutil/monotime.h"
+#include "src/common/libutil/tstat.h"
 
 #include "attr.h"
 #include "content-cache.h"
@@ -30,6 +35,16 @@ static const uint32_t default_cache_purge_target_size = 1024*1024*16;
 static const uint32_t default_cache_purge_old_entry = 5;
 static const uint32_t default_cache_purge_large_entry = 256;
 
+/* Memory-pressure driven purge:  when the broker RSS exceeds this
+ * fraction of the content.memory-budget attribute, the purge targets
+ * above are scaled down proportionally, reaching zero (purge everything
+ * purgeable) at the budget itself.  Over budget, several shards are
+ * scanned per tick instead of one so the cache drains faster.
+ * A budget of 0 disables pressure and preserves the fixed targets.
+ */
+static const double memory_pressure_floor = 0.80;
+static const int over_budget_shard_count = 4;
+
 /* Raise the max blob size value to 1GB so that large KVS values
  * (including KVS directories) can be supported while the KVS transitions
  * to the RFC 11 treeobj data representation.
@@ -39,10 +54,42 @@ static const uint32_t default_blob_size_limit = 1048576*1024;
 
 static const uint32_t default_flush_batch_limit = 256;
 
+/* Entries are sharded by the leading bytes of the blobref digest so that
+ * periodic maintenance (purge) can scan one shard per heartbeat instead
+ * of walking the entire cache in one reactor callback.
+ * Must be a power of two.
+ */
+#define CACHE_SHARD_COUNT 64
+#define CACHE_SHARD_MASK (CACHE_SHARD_COUNT - 1)
+
+/* Hit/miss counters are kept per blob size class so cache tunables can
+ * be sized from production traffic (see content.stats.full).
+ */
+static const uint32_t size_class_limit[] = { 4096, 65536, 1048576 };
+static const char *size_class_name[] = { "<=4K", "<=64K", "<=1M", ">1M" };
+#define SIZE_CLASS_COUNT 4
+
+static int size_class (int len)
+{
+    int i;
+    for (i = 0; i < SIZE_CLASS_COUNT - 1; i++)
+        if (len <= size_class_limit[i])
+            break;
+    return i;
+}
+
+/* Entry data is zero-copy where possible:  blobs ingested via content.store
+ * alias the request message payload (with a message reference held), and
+ * blobs fetched from upstream/backing alias the load RPC response (with the
+ * future kept alive).  Only when neither reference is held does the entry
+ * own 'data' outright.
+ */
 struct cache_entry {
     flux_t *h;
     void *data;
     int len;
+    const flux_msg_t *data_msg;     /* store request whose payload is 'data' */
+    flux_future_t *data_f;          /* load RPC whose payload is 'data' */
     char *blobref;
     uint8_t valid:1;                /* entry contains valid data */
     uint8_t dirty:1;                /* entry needs to be stored upstream */
@@ -52,13 +99,17 @@ struct cache_entry {
     zlist_t *load_requests;
     zlist_t *store_requests;
     int lastused;
+    int dirty_epoch;                /* epoch when entry became dirty */
 };
 
 struct content_cache {
     flux_t *h;
     flux_msg_handler_t **handlers;
+    flux_metrics_t *metrics;        /* typed registry for content.stats.metrics */
     uint32_t rank;
-    zhash_t *entries;
+    zhash_t *shards[CACHE_SHARD_COUNT];
+    int purge_shard;                /* next shard to scan for purge */
+    flux_watcher_t *purge_timer;    /* jittered periodic purge */
     uint8_t backing:1;              /* 'content.backing' service available */
     char *backing_name;
     char hash_name[BLOBREF_MAX_STRING_SIZE];
@@ -74,14 +125,52 @@ struct content_cache {
     uint32_t purge_old_entry;
     uint32_t purge_large_entry;
 
+    uint64_t memory_budget;         /* broker RSS budget (bytes, 0=none) */
+    uint64_t memory_rss;            /* RSS sampled at last purge tick */
+    double memory_pressure;         /* rss/budget at last purge tick */
+
+    uint32_t acct_entries;          /* count of cache entries (all shards) */
     uint32_t acct_size;             /* total size of all cache entries */
     uint32_t acct_valid;            /* count of valid cache entries */
     uint32_t acct_dirty;            /* count of dirty cache entries */
+
+    /* Instrumentation for content.stats.full (cheap per-event counters).
+     */
+    uint64_t acct_hit[SIZE_CLASS_COUNT];   /* loads served from cache */
+    uint64_t acct_miss[SIZE_CLASS_COUNT];  /* loads that went downstream */
+    uint64_t acct_load_errors;
+    uint64_t acct_store_errors;
+    tstat_t load_time;              /* load RPC round trip (msec) */
+    tstat_t store_time;             /* store RPC round trip (msec) */
+    uint32_t flush_batch_hiwat;     /* max in-flight store RPCs seen */
 };
 
 static void flush_respond (content_cache_t *cache);
 static int cache_flush (content_cache_t *cache);
 
+/* Attach the current time to a load/store RPC future so that its
+ * continuation can account the round trip.  Best effort - accounting
+ * is skipped if the timestamp cannot be attached.
+ */
+static void future_mark_start (flux_future_t *f)
+{
+    struct timespec *t0;
+
+    if (!(t0 = malloc (sizeof (*t0))))
+        return;
+    monotime (t0);
+    if (flux_future_aux_set (f, "t0", t0, free) < 0)
+        free (t0);
+}
+
+static void future_account_elapsed (flux_future_t *f, tstat_t *ts)
+{
+    struct timespec *t0 = flux_future_aux_get (f, "t0");
+
+    if (t0)
+        tstat_push (ts, monotime_since (*t0));
+}
+
 static void request_list_destroy (zlist_t **l)
 {
     const flux_msg_t *msg;
@@ -157,7 +246,11 @@ static void cache_entry_destroy (void *arg)
 {
     struct cache_entry *e = arg;
     if (e) {
-        if (e->data)
+        if (e->data_msg)
+            flux_msg_decref (e->data_msg);
+        else if (e->data_f)
+            flux_future_destroy (e->data_f);
+        else if (e->data)
             free (e->data);
         if (e->blobref)
             free (e->blobref);
@@ -194,26 +287,58 @@ static struct cache_entry *cache_entry_create (flux_t *h, const char *blobref)
     return e;
 }
 
-/* Make an invalid cache entry valid, filling in its data.
- * Returns 0 on success, -1 on failure with errno set.
+/* Make an invalid cache entry valid by aliasing the payload of 'msg',
+ * holding a message reference so the payload remains valid for the life
+ * of the entry.  No data is copied.
  */
-static int cache_entry_fill (struct cache_entry *e, const void *data, int len)
+static void cache_entry_fill_msg (struct cache_entry *e,
+                                  const flux_msg_t *msg,
+                                  const void *data,
+                                  int len)
 {
-    int rc = -1;
+    if (!e->valid) {
+        assert (!e->data);
+        assert (e->len == 0);
+        e->data_msg = flux_msg_incref (msg);
+        e->data = (void *)data;
+        e->len = len;
+    }
+}
 
+/* Same, but alias the payload of load RPC future 'f', which is kept
+ * alive (and owns the data) until the entry is destroyed.
+ */
+static void cache_entry_fill_future (struct cache_entry *e,
+                                     flux_future_t *f,
+                                     const void *data,
+                                     int len)
+{
     if (!e->valid) {
         assert (!e->data);
         assert (e->len == 0);
-        if (len > 0 && !(e->data = malloc (len))) {
-            errno = ENOMEM;
-            goto done;
-        }
-        memcpy (e->data, data, len);
+        e->data_f = f;
+        e->data = (void *)data;
         e->len = len;
     }
-    rc = 0;
-done:
-    return rc;
+}
+
+/* Select a shard from the leading hex digits of the blobref digest.
+ * The digest follows the "name-" prefix and is uniformly distributed,
+ * so a couple of hex digits suffice to spread entries across shards.
+ */
+static zhash_t *lookup_shard (content_cache_t *cache, const char *blobref)
+{
+    const char *digest = strchr (blobref, '-');
+    unsigned int n = 0;
+    int i;
+
+    if (digest) {
+        char hex[3] = { 0 };
+        for (i = 0; i < 2 && digest[i + 1] != '\0'; i++)
+            hex[i] = digest[i + 1];
+        n = strtoul (hex, NULL, 16);
+    }
+    return cache->shards[n & CACHE_SHARD_MASK];
 }
 
 /* Insert a cache entry, by blobref.
@@ -222,12 +347,15 @@ done:
  */
 static int insert_entry (content_cache_t *cache, struct cache_entry *e)
 {
-    if (zhash_insert (cache->entries, e->blobref, e) < 0) {
+    zhash_t *shard = lookup_shard (cache, e->blobref);
+
+    if (zhash_insert (shard, e->blobref, e) < 0) {
         cache_entry_destroy (e);
         errno = ENOMEM;
         return -1;
     }
-    zhash_freefn (cache->entries, e->blobref, cache_entry_destroy);
+    zhash_freefn (shard, e->blobref, cache_entry_destroy);
+    cache->acct_entries++;
     if (e->valid) {
         cache->acct_size += e->len;
         cache->acct_valid++;
@@ -244,7 +372,7 @@ static int insert_entry (content_cache_t *cache, struct cache_entry *e)
 static struct cache_entry *lookup_entry (content_cache_t *cache,
                                          const char *blobref)
 {
-    return zhash_lookup (cache->entries, blobref);
+    return zhash_lookup (lookup_shard (cache, blobref), blobref);
 }
 
 /* Remove a cache entry.
@@ -259,7 +387,8 @@ static void remove_entry (content_cache_t *cache, struct cache_entry *e)
     }
     if (e->dirty)
         cache->acct_dirty--;
-    zhash_delete (cache->entries, e->blobref);
+    cache->acct_entries--;
+    zhash_delete (lookup_shard (cache, e->blobref), e->blobref);
 }
 
 /* Load operation
@@ -286,12 +415,19 @@ static void cache_load_continuation (flux_future_t *f, void *arg)
             errno = ENOENT;
         if (errno != ENOENT)
             flux_log_error (cache->h, "content load");
+        cache->acct_load_errors++;
         goto error;
     }
-    if (cache_entry_fill (e, data, len) < 0) {
-        flux_log_error (cache->h, "content load");
-        goto error;
-    }
+    future_account_elapsed (f, &cache->load_time);
+    /* Count one miss per request parked on this entry (minimum one,
+     * for the fetch itself, if the requests were already answered by
+     * an intervening store).
+     */
+    if (e->load_requests && zlist_size (e->load_requests) > 0)
+        cache->acct_miss[size_class (len)] += zlist_size (e->load_requests);
+    else
+        cache->acct_miss[size_class (len)]++;
+    cache_entry_fill_future (e, f, data, len);
     if (!e->valid) {
         e->valid = 1;
         cache->acct_valid++;
@@ -303,7 +439,8 @@ static void cache_load_continuation (flux_future_t *f, void *arg)
                               e->data,
                               e->len,
                               "load");
-    flux_future_destroy (f);
+    if (e->data_f != f)
+        flux_future_destroy (f);
     return;
 error:
     request_list_respond_error (&e->load_requests,
@@ -344,6 +481,7 @@ static int cache_load (content_cache_t *cache, struct cache_entry *e)
         flux_future_destroy (f);
         goto done;
     }
+    future_mark_start (f);
     e->load_pending = 1;
     rc = 0;
 done:
@@ -390,6 +528,7 @@ void content_load_request (flux_t *h, flux_msg_handler_t *mh,
         return; /* RPC continuation will respond to msg */
     }
     e->lastused = cache->epoch;
+    cache->acct_hit[size_class (e->len)]++;
     data = e->data;
     len = e->len;
     if (flux_respond_raw (h, msg, data, len) < 0)
@@ -450,8 +589,10 @@ static void cache_store_continuation (flux_future_t *f, void *arg)
                       "backing store service unavailable");
         else
             flux_log_error (cache->h, "content store");
+        cache->acct_store_errors++;
         goto error;
     }
+    future_account_elapsed (f, &cache->store_time);
     if (strcmp (blobref, e->blobref)) {
         flux_log (cache->h, LOG_ERR, "content store: wrong blobref");
         errno = EIO;
@@ -510,8 +651,11 @@ static int cache_store (content_cache_t *cache, struct cache_entry *e)
         flux_future_destroy (f);
         goto done;
     }
+    future_mark_start (f);
     e->store_pending = 1;
     cache->flush_batch_count++;
+    if (cache->flush_batch_count > cache->flush_batch_hiwat)
+        cache->flush_batch_hiwat = cache->flush_batch_count;
     rc = 0;
 done:
     if (rc < 0)
@@ -545,8 +689,7 @@ static void content_store_request (flux_t *h, flux_msg_handler_t *mh,
             goto error; /* insert destroys 'e' on failure */
     }
     if (!e->valid) {
-        if (cache_entry_fill (e, data, len) < 0)
-            goto error;
+        cache_entry_fill_msg (e, msg, data, len);
         if (!e->valid) {
             e->valid = 1;
             cache->acct_valid++;
@@ -559,6 +702,7 @@ static void content_store_request (flux_t *h, flux_msg_handler_t *mh,
                                   "load");
         if (!e->dirty) {
             e->dirty = 1;
+            e->dirty_epoch = cache->epoch;
             cache->acct_dirty++;
         }
     }
@@ -580,6 +724,7 @@ static void content_store_request (flux_t *h, flux_msg_handler_t *mh,
          */
         if (cache->rank == 0 && !cache->backing) {
             e->dirty = 1;
+            e->dirty_epoch = cache->epoch;
             cache->acct_dirty++;
         }
     }
@@ -598,22 +743,60 @@ error:
  * dropping from the rank 0 cache.
  */
 
+/* Sort comparator for flush candidates:  largest blobs first, so that
+ * flush time tracks backend bandwidth rather than per-RPC latency and
+ * the biggest memory consumers leave the cache soonest.
+ */
+static int flush_cmp (void *item1, void *item2)
+{
+    struct cache_entry *e1 = item1;
+    struct cache_entry *e2 = item2;
+
+    if (e1->len > e2->len)
+        return -1;
+    if (e1->len < e2->len)
+        return 1;
+    return 0;
+}
+
+/* Refill the pipeline of in-flight content.store RPCs up to
+ * cache->flush_batch_limit, choosing dirty entries largest-first.
+ * Called initially from content.flush / backing store registration,
+ * then again from store continuations as responses arrive, so a full
+ * window stays in flight until the dirty set is drained.
+ */
 static int cache_flush (content_cache_t *cache)
 {
     struct cache_entry *e;
     const char *key;
+    zlist_t *candidates = NULL;
     int saved_errno = 0;
     int count = 0;
     int rc = 0;
+    int i;
 
     if (cache->acct_dirty - cache->flush_batch_count == 0
             || cache->flush_batch_count >= cache->flush_batch_limit)
         return 0;
 
     flux_log (cache->h, LOG_DEBUG, "content flush begin");
-    FOREACH_ZHASH (cache->entries, key, e) {
-        if (!e->dirty || e->store_pending)
-            continue;
+    if (!(candidates = zlist_new ())) {
+        errno = ENOMEM;
+        return -1;
+    }
+    for (i = 0; i < CACHE_SHARD_COUNT; i++) {
+        FOREACH_ZHASH (cache->shards[i], key, e) {
+            if (!e->dirty || e->store_pending)
+                continue;
+            if (zlist_append (candidates, e) < 0) {
+                zlist_destroy (&candidates);
+                errno = ENOMEM;
+                return -1;
+            }
+        }
+    }
+    zlist_sort (candidates, flush_cmp);
+    while ((e = zlist_pop (candidates))) {
         if (cache_store (cache, e) < 0) {
             saved_errno = errno;
             rc = -1;
@@ -622,6 +805,7 @@ static int cache_flush (content_cache_t *cache)
         if (cache->flush_batch_count >= cache->flush_batch_limit)
             break;
     }
+    zlist_destroy (&candidates);
     flux_log (cache->h, LOG_DEBUG, "content flush +%d (dirty=%d pending=%d)",
               count, cache->acct_dirty, cache->flush_batch_count);
     if (rc < 0)
@@ -715,23 +899,27 @@ static void content_dropcache_request (flux_t *h, flux_msg_handler_t *mh,
     char *key;
     struct cache_entry *e;
     int orig_size;
+    int i;
 
     if (flux_request_decode (msg, NULL, NULL) < 0)
         goto error;
-    orig_size = zhash_size (cache->entries);
-    if (!(keys = zhash_keys (cache->entries))) {
-        errno = ENOMEM;
-        goto error;
-    }
-    while ((key = zlist_pop (keys))) {
-        e = zhash_lookup (cache->entries, key);
-        assert (e != NULL);
-        if (e->valid && !e->dirty)
-            remove_entry (cache, e);
-        free (key);
+    orig_size = cache->acct_entries;
+    for (i = 0; i < CACHE_SHARD_COUNT; i++) {
+        if (!(keys = zhash_keys (cache->shards[i]))) {
+            errno = ENOMEM;
+            goto error;
+        }
+        while ((key = zlist_pop (keys))) {
+            e = zhash_lookup (cache->shards[i], key);
+            assert (e != NULL);
+            if (e->valid && !e->dirty)
+                remove_entry (cache, e);
+            free (key);
+        }
+        zlist_destroy (&keys);
     }
     flux_log (h, LOG_DEBUG, "content dropcache %d/%d",
-              orig_size - (int)zhash_size (cache->entries), orig_size);
+              orig_size - (int)cache->acct_entries, orig_size);
     if (flux_respond (h, msg, NULL) < 0)
         flux_log_error (h, "content dropcache");
     zlist_destroy (&keys);
@@ -753,11 +941,14 @@ static void content_stats_request (flux_t *h, flux_msg_handler_t *mh,
 
     if (flux_request_decode (msg, NULL, NULL) < 0)
         goto error;
-    if (flux_respond_pack (h, msg, "{ s:i s:i s:i s:i}",
-                           "count", zhash_size (cache->entries),
+    if (flux_respond_pack (h, msg, "{ s:i s:i s:i s:i s:I s:I s:f}",
+                           "count", cache->acct_entries,
                            "valid", cache->acct_valid,
                            "dirty", cache->acct_dirty,
-                           "size", cache->acct_size) < 0)
+                           "size", cache->acct_size,
+                           "memory-budget", (json_int_t)cache->memory_budget,
+                           "memory-rss", (json_int_t)cache->memory_rss,
+                           "memory-pressure", cache->memory_pressure) < 0)
         flux_log_error (h, "content stats");
     return;
 error:
@@ -765,6 +956,83 @@ error:
         flux_log_error (h, "content stats");
 }
 
+/* Return the full instrumentation surface:  per size class hit/miss
+ * counters, load/store RPC latency, backing store queue depth, and the
+ * age distribution of the dirty set.  The dirty-set scan walks the
+ * whole cache in one go like dropcache does, which is acceptable for
+ * an operator diagnostic.
+ */
+
+static void content_stats_full_request (flux_t *h, flux_msg_handler_t *mh,
+                                        const flux_msg_t *msg, void *arg)
+{
+    content_cache_t *cache = arg;
+    json_t *hits = NULL;
+    json_t *misses = NULL;
+    struct cache_entry *e;
+    const char *key;
+    tstat_t dirty_age;
+    int i;
+
+    if (flux_request_decode (msg, NULL, NULL) < 0)
+        goto error;
+    memset (&dirty_age, 0, sizeof (dirty_age));
+    for (i = 0; i < CACHE_SHARD_COUNT; i++) {
+        FOREACH_ZHASH (cache->shards[i], key, e) {
+            if (e->dirty)
+                tstat_push (&dirty_age,
+                            (double)(cache->epoch - e->dirty_epoch));
+        }
+    }
+    if (!(hits = json_object ()) || !(misses = json_object ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    for (i = 0; i < SIZE_CLASS_COUNT; i++) {
+        if (json_object_set_new (hits,
+                                 size_class_name[i],
+                                 json_integer (cache->acct_hit[i])) < 0
+            || json_object_set_new (misses,
+                                    size_class_name[i],
+                                    json_integer (cache->acct_miss[i])) < 0) {
+            errno = ENOMEM;
+            goto error;
+        }
+    }
+    if (flux_respond_pack (h, msg,
+                           "{s:i s:i s:i s:i"
+                           " s:I s:I s:f"
+                           " s:O s:O s:I s:I"
+                           " s:o s:o s:o"
+                           " s:i s:i s:i}",
+                           "count", cache->acct_entries,
+                           "valid", cache->acct_valid,
+                           "dirty", cache->acct_dirty,
+                           "size", cache->acct_size,
+                           "memory-budget", (json_int_t)cache->memory_budget,
+                           "memory-rss", (json_int_t)cache->memory_rss,
+                           "memory-pressure", cache->memory_pressure,
+                           "hit", hits,
+                           "miss", misses,
+                           "load-errors", (json_int_t)cache->acct_load_errors,
+                           "store-errors", (json_int_t)cache->acct_store_errors,
+                           "load (ms)", tstat_tojson (&cache->load_time),
+                           "store (ms)", tstat_tojson (&cache->store_time),
+                           "dirty-age (epochs)", tstat_tojson (&dirty_age),
+                           "flush-batch-count", cache->flush_batch_count,
+                           "flush-batch-limit", cache->flush_batch_limit,
+                           "flush-batch-hiwat", cache->flush_batch_hiwat) < 0)
+        flux_log_error (h, "content stats.full");
+    json_decref (hits);
+    json_decref (misses);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "content stats.full");
+    json_decref (hits);
+    json_decref (misses);
+}
+
 /* Flush all dirty entries by walking the entire cache, issuing store
  * requests for all dirty entries.  Responses are handled asynchronously
  * using RPC continuations.  A response to the flush request is not sent
@@ -828,36 +1096,101 @@ error:
 /* Heartbeat drives periodic cache purge
  */
 
+/* Sample the broker's resident set size from /proc/self/statm.
+ * Returns 0 if unavailable (non-Linux), which disables pressure.
+ */
+static uint64_t read_rss (void)
+{
+    unsigned long size, resident;
+    uint64_t rss = 0;
+    FILE *f;
+
+    if ((f = fopen ("/proc/self/statm", "r"))) {
+        if (fscanf (f, "%lu %lu", &size, &resident) == 2)
+            rss = (uint64_t)resident * sysconf (_SC_PAGESIZE);
+        fclose (f);
+    }
+    return rss;
+}
+
+/* Update the RSS sample and return rss/budget, or 0. if no budget is
+ * in force (or RSS could not be read).
+ */
+static double update_memory_pressure (content_cache_t *cache)
+{
+    cache->memory_rss = read_rss ();
+    if (cache->memory_budget == 0 || cache->memory_rss == 0)
+        cache->memory_pressure = 0.;
+    else
+        cache->memory_pressure = (double)cache->memory_rss
+                               / cache->memory_budget;
+    return cache->memory_pressure;
+}
+
+/* Scan a single shard per heartbeat, advancing a cursor, so that expiry
+ * work is bounded per reactor callback.  Purge targets are interpreted
+ * globally; the scan stops early once they are met.
+ *
+ * If a memory budget is set and the broker RSS is approaching it, the
+ * effective targets (including the age threshold) shrink with pressure,
+ * and over budget the scan covers extra shards per tick.
+ */
 static int cache_purge (content_cache_t *cache)
 {
-    int after_entries = zhash_size (cache->entries);
+    int after_entries = cache->acct_entries;
     int after_size = cache->acct_size;
+    uint32_t target_entries = cache->purge_target_entries;
+    uint32_t target_size = cache->purge_target_size;
+    uint32_t old_entry = cache->purge_old_entry;
     struct cache_entry *e;
     zlist_t *purge = NULL;
+    int nshards = 1;
     int rc = -1;
     const char *key;
+    zhash_t *shard;
+    double pressure;
+
+    pressure = update_memory_pressure (cache);
+    if (pressure > memory_pressure_floor) {
+        double x = (pressure - memory_pressure_floor)
+                 / (1. - memory_pressure_floor);
+        if (x > 1.)
+            x = 1.;
+        target_entries = (uint32_t)(target_entries * (1. - x));
+        target_size = (uint32_t)(target_size * (1. - x));
+        if (old_entry > 1)
+            old_entry = 1 + (uint32_t)((old_entry - 1) * (1. - x));
+        if (pressure >= 1.)
+            nshards = over_budget_shard_count;
+    }
 
-    if (cache->acct_dirty == zhash_size (cache->entries))
+    if (cache->acct_dirty == cache->acct_entries)
         return 0;
 
-    FOREACH_ZHASH (cache->entries, key, e) {
-        if (after_size <= cache->purge_target_size
-                        && after_entries <= cache->purge_target_entries)
+    while (nshards-- > 0) {
+        if (after_size <= target_size && after_entries <= target_entries)
             break;
-        if (!e->valid || e->dirty)
-            continue;
-        if (cache->epoch - e->lastused < cache->purge_old_entry)
-            continue;
-        if (after_entries <= cache->purge_target_entries
-                    && e->len < cache->purge_large_entry)
-            continue;
-        if ((!purge && !(purge = zlist_new ()))
-                    || zlist_append (purge, e) < 0) {
-            errno = ENOMEM;
-            goto done;
+        shard = cache->shards[cache->purge_shard];
+        cache->purge_shard = (cache->purge_shard + 1) & CACHE_SHARD_MASK;
+
+        FOREACH_ZHASH (shard, key, e) {
+            if (after_size <= target_size && after_entries <= target_entries)
+                break;
+            if (!e->valid || e->dirty)
+                continue;
+            if (cache->epoch - e->lastused < old_entry)
+                continue;
+            if (after_entries <= target_entries
+                        && e->len < cache->purge_large_entry)
+                continue;
+            if ((!purge && !(purge = zlist_new ()))
+                        || zlist_append (purge, e) < 0) {
+                errno = ENOMEM;
+                goto done;
+            }
+            after_size -= e->len;
+            after_entries--;
         }
-        after_size -= e->len;
-        after_entries--;
     }
     if (purge) {
         flux_log (cache->h, LOG_DEBUG, "content purge: %d entries",
@@ -878,9 +1211,77 @@ static void heartbeat_event (flux_t *h, flux_msg_handler_t *mh,
 
     if (flux_heartbeat_decode (msg, &cache->epoch) < 0)
         return; /* ignore mangled heartbeat */
+    /* Purge runs on a jittered timer, not here, unless no timer was
+     * configured (see content_cache_set_purge_interval()).
+     */
+    if (!cache->purge_timer)
+        cache_purge (cache);
+}
+
+static void purge_timer_cb (flux_reactor_t *r, flux_watcher_t *w,
+                            int revents, void *arg)
+{
+    content_cache_t *cache = arg;
+
     cache_purge (cache);
 }
 
+/* Decouple cache purge from the heartbeat event:  run it on a
+ * repeating timer with the same period but a per-process random phase,
+ * so all the heartbeat-paced maintenance does not pile onto the same
+ * reactor iteration.
+ */
+int content_cache_set_purge_interval (content_cache_t *cache, double interval)
+{
+    flux_watcher_t *w;
+
+    if (!cache->h) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!(w = flux_heartbeat_timer_create (cache->h,
+                                           interval,
+                                           purge_timer_cb,
+                                           cache)))
+        return -1;
+    flux_watcher_destroy (cache->purge_timer);
+    cache->purge_timer = w;
+    /* housekeeping: let pending message-path callbacks run first */
+    flux_watcher_set_priority (w, FLUX_WATCHER_PRIORITY_IDLE);
+    flux_watcher_start (w);
+    return 0;
+}
+
+/* Probe the cgroup memory limit so a containerized broker gets a
+ * sensible default budget without configuration.  Tries the cgroup v2
+ * unified hierarchy first, then v1.  A missing file, "max", or an
+ * unlimited sentinel value all mean no limit is in force (return 0).
+ */
+static uint64_t cgroup_memory_limit (void)
+{
+    const char *paths[] = {
+        "/sys/fs/cgroup/memory.max",                    /* v2 */
+        "/sys/fs/cgroup/memory/memory.limit_in_bytes",  /* v1 */
+    };
+    char buf[64];
+    FILE *f;
+    int i;
+
+    for (i = 0; i < (int)(sizeof (paths) / sizeof (paths[0])); i++) {
+        if (!(f = fopen (paths[i], "r")))
+            continue;
+        if (fgets (buf, sizeof (buf), f)) {
+            uint64_t limit = strtoull (buf, NULL, 10);
+            if (limit > 0 && limit < (1ULL << 62)) {
+                fclose (f);
+                return limit;
+            }
+        }
+        fclose (f);
+    }
+    return 0;
+}
+
 /* Initialization
  */
 
@@ -921,6 +1322,12 @@ static const struct flux_msg_handler_spec htab[] = {
         content_stats_request,
         0
     },
+    {
+        FLUX_MSGTYPE_REQUEST,
+        "content.stats.full",
+        content_stats_full_request,
+        0
+    },
     {
         FLUX_MSGTYPE_REQUEST,
         "content.flush",
@@ -936,6 +1343,106 @@ static const struct flux_msg_handler_spec htab[] = {
     FLUX_MSGHANDLER_TABLE_END,
 };
 
+/* Callback-backed metrics sample the accounting fields above at scrape
+ * time, so the hot paths keep updating plain struct members and nothing
+ * is double-counted.
+ */
+static uint64_t metrics_hits (void *arg)
+{
+    content_cache_t *cache = arg;
+    uint64_t n = 0;
+
+    for (int i = 0; i < SIZE_CLASS_COUNT; i++)
+        n += cache->acct_hit[i];
+    return n;
+}
+
+static uint64_t metrics_misses (void *arg)
+{
+    content_cache_t *cache = arg;
+    uint64_t n = 0;
+
+    for (int i = 0; i < SIZE_CLASS_COUNT; i++)
+        n += cache->acct_miss[i];
+    return n;
+}
+
+static uint64_t metrics_load_errors (void *arg)
+{
+    content_cache_t *cache = arg;
+    return cache->acct_load_errors;
+}
+
+static uint64_t metrics_store_errors (void *arg)
+{
+    content_cache_t *cache = arg;
+    return cache->acct_store_errors;
+}
+
+static double metrics_entries (void *arg)
+{
+    content_cache_t *cache = arg;
+    return (double)cache->acct_entries;
+}
+
+static double metrics_size (void *arg)
+{
+    content_cache_t *cache = arg;
+    return (double)cache->acct_size;
+}
+
+static double metrics_valid (void *arg)
+{
+    content_cache_t *cache = arg;
+    return (double)cache->acct_valid;
+}
+
+static double metrics_dirty (void *arg)
+{
+    content_cache_t *cache = arg;
+    return (double)cache->acct_dirty;
+}
+
+static double metrics_memory_pressure (void *arg)
+{
+    content_cache_t *cache = arg;
+    return cache->memory_pressure;
+}
+
+static double metrics_flush_batch_count (void *arg)
+{
+    content_cache_t *cache = arg;
+    return (double)cache->flush_batch_count;
+}
+
+static int register_metrics (content_cache_t *cache)
+{
+    flux_metrics_t *m = cache->metrics;
+
+    if (flux_metrics_counter_register (m, "cache.hits",
+                                       metrics_hits, cache) < 0
+        || flux_metrics_counter_register (m, "cache.misses",
+                                          metrics_misses, cache) < 0
+        || flux_metrics_counter_register (m, "cache.load-errors",
+                                          metrics_load_errors, cache) < 0
+        || flux_metrics_counter_register (m, "cache.store-errors",
+                                          metrics_store_errors, cache) < 0
+        || flux_metrics_gauge_register (m, "cache.entries",
+                                        metrics_entries, cache) < 0
+        || flux_metrics_gauge_register (m, "cache.size",
+                                        metrics_size, cache) < 0
+        || flux_metrics_gauge_register (m, "cache.valid",
+                                        metrics_valid, cache) < 0
+        || flux_metrics_gauge_register (m, "cache.dirty",
+                                        metrics_dirty, cache) < 0
+        || flux_metrics_gauge_register (m, "cache.memory-pressure",
+                                        metrics_memory_pressure, cache) < 0
+        || flux_metrics_gauge_register (m, "cache.flush-batch-count",
+                                        metrics_flush_batch_count, cache) < 0)
+        return -1;
+    return 0;
+}
+
 int content_cache_set_flux (content_cache_t *cache, flux_t *h)
 {
     cache->h = h;
@@ -946,6 +1453,11 @@ int content_cache_set_flux (content_cache_t *cache, flux_t *h)
         return -1;
     if (flux_event_subscribe (h, "hb") < 0)
         return -1;
+    if (!(cache->metrics = flux_metrics_create ("content")))
+        return -1;
+    if (register_metrics (cache) < 0
+        || flux_metrics_service_register (h, cache->metrics) < 0)
+        return -1;
     return 0;
 }
 
@@ -957,6 +1469,14 @@ static int content_cache_setattr (const char *name, const char *val, void *arg)
         if (blobref_validate_hashtype (val) < 0)
             goto invalid;
         strcpy (cache->hash_name, val);
+    } else if (!strcmp (name, "content.memory-budget")) {
+        char *endptr;
+        uint64_t n;
+        errno = 0;
+        n = strtoull (val, &endptr, 10);
+        if (errno != 0 || *endptr != '\0' || endptr == val)
+            goto invalid;
+        cache->memory_budget = n;
     } else
         goto invalid;
     return 0;
@@ -975,7 +1495,13 @@ static int content_cache_getattr (const char *name, const char **val, void *arg)
     else if (!strcmp (name, "content.backing-module"))
         *val = cache->backing_name;
     else if (!strcmp (name, "content.acct-entries")) {
-        snprintf (s, sizeof (s), "%zd", zhash_size (cache->entries));
+        snprintf (s, sizeof (s), "%" PRIu32, cache->acct_entries);
+        *val = s;
+    } else if (!strcmp (name, "content.memory-budget")) {
+        snprintf (s, sizeof (s), "%" PRIu64, cache->memory_budget);
+        *val = s;
+    } else if (!strcmp (name, "content.memory-rss")) {
+        snprintf (s, sizeof (s), "%" PRIu64, cache->memory_rss);
         *val = s;
     } else
         return -1;
@@ -1010,6 +1536,16 @@ int content_cache_register_attrs (content_cache_t *cache, attr_t *attr)
     if (attr_add_active_uint32 (attr, "content.purge-large-entry",
                 &cache->purge_large_entry, 0) < 0)
         return -1;
+    /* Memory budget (bytes; defaults to the cgroup limit if one is
+     * in force, 0 disables pressure-driven purge)
+     */
+    if (attr_add_active (attr, "content.memory-budget", 0,
+                         content_cache_getattr,
+                         content_cache_setattr, cache) < 0)
+        return -1;
+    if (attr_add_active (attr, "content.memory-rss", FLUX_ATTRFLAG_READONLY,
+                         content_cache_getattr, NULL, cache) < 0)
+        return -1;
     /* Accounting numbers
      */
     if (attr_add_active_uint32 (attr, "content.acct-size",
@@ -1055,9 +1591,12 @@ void content_cache_destroy (content_cache_t *cache)
             (void)flux_event_unsubscribe (cache->h, "hb");
             flux_msg_handler_delvec (cache->handlers);
         }
+        flux_watcher_destroy (cache->purge_timer);
+        flux_metrics_destroy (cache->metrics);
         if (cache->backing_name)
             free (cache->backing_name);
-        zhash_destroy (&cache->entries);
+        for (int i = 0; i < CACHE_SHARD_COUNT; i++)
+            zhash_destroy (&cache->shards[i]);
         request_list_destroy (&cache->flush_requests);
         free (cache);
     }
@@ -1070,10 +1609,12 @@ content_cache_t *content_cache_create (void)
         errno = ENOMEM;
         return NULL;
     }
-    if (!(cache->entries = zhash_new ())) {
-        content_cache_destroy (cache);
-        errno = ENOMEM;
-        return NULL;
+    for (int i = 0; i < CACHE_SHARD_COUNT; i++) {
+        if (!(cache->shards[i] = zhash_new ())) {
+            content_cache_destroy (cache);
+            errno = ENOMEM;
+            return NULL;
+        }
     }
     cache->rank = FLUX_NODEID_ANY;
     cache->blob_size_limit = default_blob_size_limit;
@@ -1082,6 +1623,7 @@ content_cache_t *content_cache_create (void)
     cache->purge_target_size = default_cache_purge_target_size;
     cache->purge_old_entry = default_cache_purge_old_entry;
     cache->purge_large_entry = default_cache_purge_large_entry;
+    cache->memory_budget = cgroup_memory_limit ();
     strcpy (cache->hash_name, "sha1");
     return cache;
 }
@@ -14,6 +14,7 @@
 typedef struct content_cache content_cache_t;
 
 int content_cache_set_flux (content_cache_t *cache, flux_t *h);
+int content_cache_set_purge_interval (content_cache_t *cache, double interval);
 
 content_cache_t *content_cache_create (void);
 void content_cache_destroy (content_cache_t *cache);
@@ -0,0 +1,213 @@
+/************************************************************\
+ * Copyright 2020 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <errno.h>
+#include <czmq.h>
+#include <jansson.h>
+#include <flux/core.h>
+
+#include "flightrec.h"
+
+/* Entries per ring - must be a power of two.  At 32 bytes per entry
+ * a ring costs 128K, retaining the last 4096 messages per endpoint.
+ */
+#define FLIGHTREC_ENTRIES 4096
+
+struct flightrec_entry {
+    double timestamp;       /* CLOCK_MONOTONIC */
+    uint32_t size;          /* payload size, 0 if none */
+    uint8_t type;           /* FLUX_MSGTYPE_* */
+    uint8_t dir;            /* FLIGHTREC_RX/TX */
+    char topic[18];         /* truncated - identifies the message */
+};
+
+struct flightrec {
+    char *name;
+    unsigned int head;      /* total records; next slot is head % size */
+    struct flightrec_entry entries[FLIGHTREC_ENTRIES];
+};
+
+static zhash_t *rings = NULL;
+static flux_msg_handler_t **handlers = NULL;
+
+static void flightrec_ring_destroy (void *arg)
+{
+    struct flightrec *fr = arg;
+    if (fr) {
+        free (fr->name);
+        free (fr);
+    }
+}
+
+struct flightrec *flightrec_ring (const char *name)
+{
+    struct flightrec *fr;
+
+    if (!rings && !(rings = zhash_new ()))
+        return NULL;
+    if ((fr = zhash_lookup (rings, name)))
+        return fr;
+    if (!(fr = calloc (1, sizeof (*fr))))
+        return NULL;
+    if (!(fr->name = strdup (name))) {
+        free (fr);
+        return NULL;
+    }
+    if (zhash_insert (rings, name, fr) < 0) {
+        flightrec_ring_destroy (fr);
+        return NULL;
+    }
+    zhash_freefn (rings, name, flightrec_ring_destroy);
+    return fr;
+}
+
+void flightrec_record (struct flightrec *fr, int dir, const flux_msg_t *msg)
+{
+    struct flightrec_entry *entry;
+    struct timespec ts;
+    const char *topic;
+    const void *buf;
+    int type;
+    int size = 0;
+
+    if (!fr || !msg)
+        return;
+    entry = &fr->entries[fr->head % FLIGHTREC_ENTRIES];
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    entry->timestamp = (double)ts.tv_sec + 1E-9 * ts.tv_nsec;
+    if (flux_msg_get_type (msg, &type) < 0)
+        type = 0;
+    entry->type = type;
+    entry->dir = dir;
+    if (flux_msg_get_payload (msg, &buf, &size) < 0)
+        size = 0;
+    entry->size = size;
+    if (flux_msg_get_topic (msg, &topic) < 0)
+        topic = "";
+    strncpy (entry->topic, topic, sizeof (entry->topic) - 1);
+    entry->topic[sizeof (entry->topic) - 1] = '\0';
+    fr->head++;
+}
+
+/* Dump one ring as {name, count, entries}, oldest first.  Entries
+ * are [timestamp, type, dir, size, topic] tuples to keep the dump
+ * compact at 4K entries per ring.
+ */
+static json_t *ring_to_json (struct flightrec *fr)
+{
+    json_t *entries;
+    json_t *o;
+    unsigned int n = fr->head;
+    unsigned int first = n > FLIGHTREC_ENTRIES ? n - FLIGHTREC_ENTRIES : 0;
+    unsigned int i;
+
+    if (!(entries = json_array ()))
+        return NULL;
+    for (i = first; i < n; i++) {
+        struct flightrec_entry *entry = &fr->entries[i % FLIGHTREC_ENTRIES];
+        json_t *e;
+        if (!(e = json_pack ("[f,i,i,i,s]",
+                             entry->timestamp,
+                             (int)entry->type,
+                             (int)entry->dir,
+                             (int)entry->size,
+                             entry->topic))
+            || json_array_append_new (entries, e) < 0) {
+            json_decref (e);
+            goto error;
+        }
+    }
+    if (!(o = json_pack ("{s:s s:i s:o}",
+                         "name", fr->name,
+                         "count", (int)fr->head,
+                         "entries", entries)))
+        goto error;
+    return o;
+error:
+    json_decref (entries);
+    return NULL;
+}
+
+static void dump_cb (flux_t *h, flux_msg_handler_t *mh,
+                     const flux_msg_t *msg, void *arg)
+{
+    const char *name = NULL;
+    json_t *out = NULL;
+    struct flightrec *fr;
+
+    if (flux_request_unpack (msg, NULL, "{s?:s}", "name", &name) < 0)
+        goto error;
+    if (!(out = json_array ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (name) {
+        if (!rings || !(fr = zhash_lookup (rings, name))) {
+            errno = ENOENT;
+            goto error;
+        }
+        json_t *o = ring_to_json (fr);
+        if (!o || json_array_append_new (out, o) < 0) {
+            json_decref (o);
+            errno = ENOMEM;
+            goto error;
+        }
+    }
+    else if (rings) {
+        for (fr = zhash_first (rings); fr; fr = zhash_next (rings)) {
+            json_t *o = ring_to_json (fr);
+            if (!o || json_array_append_new (out, o) < 0) {
+                json_decref (o);
+                errno = ENOMEM;
+                goto error;
+            }
+        }
+    }
+    if (flux_respond_pack (h, msg, "{s:O}", "rings", out) < 0)
+        FLUX_LOG_ERROR (h);
+    json_decref (out);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        FLUX_LOG_ERROR (h);
+    json_decref (out);
+}
+
+static const struct flux_msg_handler_spec htab[] = {
+    { FLUX_MSGTYPE_REQUEST, "trace.dump",  dump_cb, 0 },
+    FLUX_MSGHANDLER_TABLE_END,
+};
+
+static void flightrec_finalize (void *arg)
+{
+    flux_msg_handler_delvec (handlers);
+    handlers = NULL;
+    zhash_destroy (&rings);
+}
+
+int flightrec_initialize (flux_t *h)
+{
+    char *dummy = "hello";
+    if (flux_msg_handler_addvec (h, htab, NULL, &handlers) < 0)
+        return -1;
+    flux_aux_set (h, "flux::flightrec", dummy, flightrec_finalize);
+    return 0;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
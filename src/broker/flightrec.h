@@ -0,0 +1,53 @@
+/************************************************************\
+ * Copyright 2020 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef BROKER_FLIGHTREC_H
+#define BROKER_FLIGHTREC_H
+
+#include <flux/core.h>
+
+/* Always-on message flight recorder.
+ *
+ * Each broker message endpoint (one per loaded module, one per
+ * overlay direction) gets a fixed-size ring of small records
+ * (timestamp, message type, direction, payload size, truncated
+ * topic).  Recording is a handful of loads/stores with no locking -
+ * each ring has a single writer, the broker thread - so it can stay
+ * enabled in production and be dumped after the fact via the
+ * trace.dump RPC to reconstruct what the broker was doing when a
+ * stall occurred.
+ */
+
+enum {
+    FLIGHTREC_RX = 0,       /* message received from the endpoint */
+    FLIGHTREC_TX = 1,       /* message sent to the endpoint */
+};
+
+struct flightrec;
+
+/* Get (creating on first use) the ring for endpoint 'name'.
+ * Returns NULL on allocation failure; flightrec_record() tolerates
+ * a NULL ring so callers need not check.
+ */
+struct flightrec *flightrec_ring (const char *name);
+
+/* Record one message on 'fr' (no-op if fr is NULL).
+ */
+void flightrec_record (struct flightrec *fr, int dir, const flux_msg_t *msg);
+
+/* Register the trace.dump service / free all rings.
+ */
+int flightrec_initialize (flux_t *h);
+
+#endif /* !BROKER_FLIGHTREC_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
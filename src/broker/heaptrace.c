@@ -20,6 +20,13 @@
   #error gperftools headers not configured
 #endif
 #endif /* WITH_TCMALLOC */
+#if HAVE_MALLINFO2 || HAVE_MALLINFO || HAVE_MALLOC_INFO
+#include <malloc.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <jansson.h>
 
 #include <flux/core.h>
 #include "heaptrace.h"
@@ -99,10 +106,104 @@ error:
         FLUX_LOG_ERROR (h);
 }
 
+/* Read resident set size (bytes) from /proc/self/statm.
+ * Returns 0 if unavailable.
+ */
+static uint64_t heap_rss (void)
+{
+    unsigned long size, resident;
+    uint64_t rss = 0;
+    FILE *f;
+
+    if (!(f = fopen ("/proc/self/statm", "r")))
+        return 0;
+    if (fscanf (f, "%lu %lu", &size, &resident) == 2)
+        rss = (uint64_t)resident * sysconf (_SC_PAGESIZE);
+    fclose (f);
+    return rss;
+}
+
+/* Allocator totals from mallinfo2(3) (or the legacy mallinfo(3),
+ * whose counters wrap at 4G), plus process RSS for context.
+ */
+static json_t *heap_summary (void)
+{
+#if HAVE_MALLINFO2
+    struct mallinfo2 mi = mallinfo2 ();
+#elif HAVE_MALLINFO
+    struct mallinfo mi = mallinfo ();
+#endif
+#if HAVE_MALLINFO2 || HAVE_MALLINFO
+    return json_pack ("{s:I s:I s:I s:I s:I s:I}",
+                      "arena", (json_int_t)mi.arena,
+                      "mmapped", (json_int_t)mi.hblkhd,
+                      "used", (json_int_t)mi.uordblks,
+                      "free", (json_int_t)mi.fordblks,
+                      "trimmable", (json_int_t)mi.keepcost,
+                      "rss", (json_int_t)heap_rss ());
+#else
+    return json_pack ("{s:I}", "rss", (json_int_t)heap_rss ());
+#endif
+}
+
+/* Per-arena allocator breakdown from malloc_info(3).  glibc assigns
+ * each thread to an arena, and broker modules each run in their own
+ * thread, so the per-arena byte counts attribute heap growth to module
+ * threads.  Returns malloc'd XML string or NULL if unavailable.
+ */
+static char *heap_arenas (void)
+{
+#if HAVE_MALLOC_INFO
+    char *buf = NULL;
+    size_t size = 0;
+    FILE *f;
+
+    if (!(f = open_memstream (&buf, &size)))
+        return NULL;
+    if (malloc_info (0, f) < 0) {
+        fclose (f);
+        free (buf);
+        return NULL;
+    }
+    fclose (f);
+    return buf;
+#else
+    errno = ENOSYS;
+    return NULL;
+#endif
+}
+
+static void query_cb (flux_t *h, flux_msg_handler_t *mh,
+                      const flux_msg_t *msg, void *arg)
+{
+    json_t *summary = NULL;
+    char *arenas = NULL;
+
+    if (flux_request_decode (msg, NULL, NULL) < 0)
+        goto error;
+    if (!(summary = heap_summary ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    arenas = heap_arenas ();
+    if (flux_respond_pack (h, msg, "{s:o s:s}",
+                           "summary", summary,
+                           "arenas", arenas ? arenas : "") < 0)
+        FLUX_LOG_ERROR (h);
+    free (arenas);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        FLUX_LOG_ERROR (h);
+    json_decref (summary);
+    free (arenas);
+}
+
 static const struct flux_msg_handler_spec htab[] = {
     { FLUX_MSGTYPE_REQUEST, "heaptrace.start",  start_cb, 0 },
     { FLUX_MSGTYPE_REQUEST, "heaptrace.dump",   dump_cb, 0 },
     { FLUX_MSGTYPE_REQUEST, "heaptrace.stop",   stop_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "heaptrace.query",  query_cb, 0 },
     FLUX_MSGHANDLER_TABLE_END,
 };
 
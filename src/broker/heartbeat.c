@@ -137,6 +137,8 @@ int heartbeat_start (heartbeat_t *hb)
         if (!(hb->timer = flux_timer_watcher_create (r, hb->rate, hb->rate,
                                                      timer_cb, hb)))
             return -1;
+        /* housekeeping: let pending message-path callbacks run first */
+        flux_watcher_set_priority (hb->timer, FLUX_WATCHER_PRIORITY_IDLE);
         flux_watcher_start (hb->timer);
     }
     match.topic_glob = "hb";
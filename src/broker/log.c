@@ -16,6 +16,7 @@
 #include "src/common/libutil/log.h"
 #include "src/common/libutil/wallclock.h"
 #include "src/common/libutil/stdlog.h"
+#include "src/common/libidset/idset.h"
 
 #include "log.h"
 
@@ -26,6 +27,40 @@ static const int default_critical_level = LOG_CRIT;
 static const int default_stderr_level = LOG_ERR;
 static const int default_level = LOG_DEBUG;
 
+/* A cluster-wide failure (filesystem down, network partition) makes
+ * every rank log the same message, and each TBON hop forwards them all
+ * to rank 0, flooding its ring buffer just when the logs most need to
+ * be readable.  Records that differ only in rank and timestamp are
+ * therefore deduplicated on the forwarding path: the first occurrence
+ * is forwarded immediately, duplicates arriving within the dedup
+ * window are absorbed, and one summary annotated with a rank idset and
+ * count is forwarded when the window closes.  A window of 0 disables
+ * dedup; the entry cap bounds memory and falls back to plain
+ * forwarding when distinct messages exceed it.
+ */
+static const double default_dedup_window = 1.;
+static const int dedup_max_entries = 64;
+
+/* One distinct in-window record awaiting its summary.
+ */
+struct dedup_entry {
+    char buf[FLUX_MAX_LOGBUF + 1];  /* first record, basis for summary */
+    int len;
+    struct idset *ranks;            /* ranks of absorbed duplicates */
+    int count;                      /* duplicates absorbed, not forwarded */
+};
+
+/* Ring entries are fixed size and preallocated, so appending a log
+ * entry on the fast path is a bounded memcpy with no allocation.
+ * RFC 5988-format entries from flux_log() never exceed FLUX_MAX_LOGBUF;
+ * anything longer (e.g. from a raw log.append request) is truncated.
+ */
+struct logbuf_entry {
+    char buf[FLUX_MAX_LOGBUF + 1];
+    int len;
+    int seq;
+};
+
 #define LOGBUF_MAGIC 0xe1e2e3e4
 typedef struct {
     int magic;
@@ -38,18 +73,17 @@ typedef struct {
     int critical_level;
     int stderr_level;
     int level;
-    zlist_t *buf;
+    struct logbuf_entry *ring;  /* preallocated circular buffer */
+    int ring_head;              /* index of oldest entry */
+    int ring_used;              /* entries currently stored */
     int ring_size;
     int seq;
     zlist_t *sleepers;
+    double dedup_window;
+    zhash_t *dedup;             /* dedup key => struct dedup_entry */
+    flux_watcher_t *dedup_timer;
 } logbuf_t;
 
-struct logbuf_entry {
-    char *buf;
-    int len;
-    int seq;
-};
-
 #define SLEEPER_MAGIC 0xe4e3e2e1
 struct sleeper {
     int magic;
@@ -61,6 +95,7 @@ struct sleeper {
 };
 
 void logbuf_destroy (logbuf_t *logbuf);
+static void dedup_flush (logbuf_t *logbuf);
 
 static void sleeper_destroy (struct sleeper *s)
 {
@@ -91,49 +126,31 @@ static struct sleeper *sleeper_create (flux_msg_handler_f fun,
     return s;
 }
 
-static void logbuf_entry_destroy (struct logbuf_entry *e)
-{
-    if (e) {
-        if (e->buf)
-            free (e->buf);
-        free (e);
-    }
-}
-
-static struct logbuf_entry *logbuf_entry_create (const char *buf, int len)
+/* Return the i'th oldest entry in the ring (i in [0:ring_used)).
+ */
+static struct logbuf_entry *logbuf_index (logbuf_t *logbuf, int i)
 {
-    struct logbuf_entry *e = calloc (1, sizeof (*e));
-    if (!e)
-        return NULL;
-    if (!(e->buf = calloc (1, len))) {
-        free (e);
-        return NULL;
-    }
-    memcpy (e->buf, buf, len);
-    e->len = len;
-    return e;
+    return &logbuf->ring[(logbuf->ring_head + i) % logbuf->ring_size];
 }
 
 static void logbuf_trim (logbuf_t *logbuf, int size)
 {
     assert (logbuf->magic == LOGBUF_MAGIC);
-    struct logbuf_entry *e;
-    while (zlist_size (logbuf->buf) > size) {
-        e = zlist_pop (logbuf->buf);
-        logbuf_entry_destroy (e);
+    while (logbuf->ring_used > size) {
+        logbuf->ring_head = (logbuf->ring_head + 1) % logbuf->ring_size;
+        logbuf->ring_used--;
     }
 }
 
 static void logbuf_clear (logbuf_t *logbuf, int seq_index)
 {
-    struct logbuf_entry *e;
-
     if (seq_index == -1)
         logbuf_trim (logbuf, 0);
     else {
-        while ((e = zlist_first (logbuf->buf)) && e->seq <= seq_index) {
-            e = zlist_pop (logbuf->buf);
-            logbuf_entry_destroy (e);
+        while (logbuf->ring_used > 0
+                && logbuf_index (logbuf, 0)->seq <= seq_index) {
+            logbuf->ring_head = (logbuf->ring_head + 1) % logbuf->ring_size;
+            logbuf->ring_used--;
         }
     }
 }
@@ -141,10 +158,15 @@ static void logbuf_clear (logbuf_t *logbuf, int seq_index)
 static int logbuf_get (logbuf_t *logbuf, int seq_index, int *seq,
                        const char **buf, int *len)
 {
-    struct logbuf_entry *e = zlist_first (logbuf->buf);
-
-    while (e && e->seq <= seq_index)
-        e = zlist_next (logbuf->buf);
+    struct logbuf_entry *e = NULL;
+    int i;
+
+    for (i = 0; i < logbuf->ring_used; i++) {
+        e = logbuf_index (logbuf, i);
+        if (e->seq > seq_index)
+            break;
+        e = NULL;
+    }
     if (!e) {
         errno = ENOENT;
         return -1;
@@ -182,16 +204,13 @@ static int append_new_entry (logbuf_t *logbuf, const char *buf, int len)
 
     if (logbuf->ring_size > 0) {
         logbuf_trim (logbuf, logbuf->ring_size - 1);
-        if (!(e = logbuf_entry_create (buf, len))) {
-            errno = ENOMEM;
-            return -1;
-        }
+        e = logbuf_index (logbuf, logbuf->ring_used++);
+        if (len > FLUX_MAX_LOGBUF)
+            len = FLUX_MAX_LOGBUF;
+        memcpy (e->buf, buf, len);
+        e->buf[len] = '\0';
+        e->len = len;
         e->seq = logbuf->seq++;
-        if (zlist_append (logbuf->buf, e) < 0) {
-            logbuf_entry_destroy (e);
-            errno = ENOMEM;
-            return -1;
-        }
         while ((s = zlist_pop (logbuf->sleepers))) {
             s->fun (s->h, s->mh, s->msg, s->arg);
             sleeper_destroy (s);
@@ -213,7 +232,9 @@ static logbuf_t *logbuf_create (void)
     logbuf->stderr_level = default_stderr_level;
     logbuf->level = default_level;
     logbuf->ring_size = default_ring_size;
-    if (!(logbuf->buf = zlist_new ())) {
+    logbuf->dedup_window = default_dedup_window;
+    if (!(logbuf->ring = calloc (logbuf->ring_size,
+                                 sizeof (struct logbuf_entry)))) {
         errno = ENOMEM;
         goto cleanup;
     }
@@ -221,6 +242,10 @@ static logbuf_t *logbuf_create (void)
         errno = ENOMEM;
         goto cleanup;
     }
+    if (!(logbuf->dedup = zhash_new ())) {
+        errno = ENOMEM;
+        goto cleanup;
+    }
     return logbuf;
 cleanup:
     logbuf_destroy (logbuf);
@@ -231,10 +256,7 @@ void logbuf_destroy (logbuf_t *logbuf)
 {
     if (logbuf) {
         assert (logbuf->magic == LOGBUF_MAGIC);
-        if (logbuf->buf) {
-            logbuf_trim (logbuf, 0);
-            zlist_destroy (&logbuf->buf);
-        }
+        free (logbuf->ring);
         if (logbuf->sleepers) {
             struct sleeper *s;
             while ((s = zlist_pop (logbuf->sleepers)))
@@ -245,6 +267,8 @@ void logbuf_destroy (logbuf_t *logbuf)
             (void)fclose (logbuf->f);
         if (logbuf->filename)
             free (logbuf->filename);
+        flux_watcher_destroy (logbuf->dedup_timer);
+        zhash_destroy (&logbuf->dedup);
         logbuf->magic = ~LOGBUF_MAGIC;
         free (logbuf);
     }
@@ -290,14 +314,41 @@ static int logbuf_set_level (logbuf_t *logbuf, int level)
     return 0;
 }
 
+static int logbuf_set_dedup_window (logbuf_t *logbuf, double window)
+{
+    if (window < 0.) {
+        errno = EINVAL;
+        return -1;
+    }
+    logbuf->dedup_window = window;
+    if (window == 0.)
+        dedup_flush (logbuf);
+    return 0;
+}
+
 
 static int logbuf_set_ring_size (logbuf_t *logbuf, int size)
 {
+    struct logbuf_entry *ring = NULL;
+    int n, i;
+
     if (size < 0) {
         errno = EINVAL;
         return -1;
     }
-    logbuf_trim (logbuf, size);
+    if (size > 0 && !(ring = calloc (size, sizeof (*ring)))) {
+        errno = ENOMEM;
+        return -1;
+    }
+    /* Carry over the newest entries that fit.
+     */
+    n = logbuf->ring_used < size ? logbuf->ring_used : size;
+    for (i = 0; i < n; i++)
+        ring[i] = *logbuf_index (logbuf, logbuf->ring_used - n + i);
+    free (logbuf->ring);
+    logbuf->ring = ring;
+    logbuf->ring_head = 0;
+    logbuf->ring_used = n;
     logbuf->ring_size = size;
     return 0;
 }
@@ -350,7 +401,7 @@ static int attr_get_log (const char *name, const char **val, void *arg)
         assert (n < sizeof (s));
         *val = s;
     } else if (!strcmp (name, "log-ring-used")) {
-        n = snprintf (s, sizeof (s), "%zd", zlist_size (logbuf->buf));
+        n = snprintf (s, sizeof (s), "%d", logbuf->ring_used);
         assert (n < sizeof (s));
         *val = s;
     } else if (!strcmp (name, "log-count")) {
@@ -363,6 +414,10 @@ static int attr_get_log (const char *name, const char **val, void *arg)
         n = snprintf (s, sizeof (s), "%d", logbuf->level);
         assert (n < sizeof (s));
         *val = s;
+    } else if (!strcmp (name, "log-dedup-window")) {
+        n = snprintf (s, sizeof (s), "%.3f", logbuf->dedup_window);
+        assert (n < sizeof (s));
+        *val = s;
     } else {
         errno = ENOENT;
         goto done;
@@ -400,6 +455,10 @@ static int attr_set_log (const char *name, const char *val, void *arg)
         int level = strtol (val, NULL, 10);
         if (logbuf_set_level (logbuf, level) < 0)
             goto done;
+    } else if (!strcmp (name, "log-dedup-window")) {
+        double window = strtod (val, NULL);
+        if (logbuf_set_dedup_window (logbuf, window) < 0)
+            goto done;
     } else {
         errno = ENOENT;
         goto done;
@@ -444,6 +503,9 @@ static int logbuf_register_attrs (logbuf_t *logbuf, attr_t *attrs)
     if (attr_add_active (attrs, "log-ring-size", 0,
                          attr_get_log, attr_set_log, logbuf) < 0)
         goto done;
+    if (attr_add_active (attrs, "log-dedup-window", 0,
+                         attr_get_log, attr_set_log, logbuf) < 0)
+        goto done;
     if (attr_add_active (attrs, "log-ring-used", 0,
                          attr_get_log, NULL, logbuf) < 0)
         goto done;
@@ -467,6 +529,130 @@ static int logbuf_forward (logbuf_t *logbuf, const char *buf, int len)
     return 0;
 }
 
+static void dedup_entry_destroy (void *data)
+{
+    struct dedup_entry *e = data;
+    if (e) {
+        idset_destroy (e->ranks);
+        free (e);
+    }
+}
+
+/* Compute the dedup identity of a log record, ignoring the per-rank
+ * fields (hostname carries the rank, plus the timestamp): two records
+ * match if priority, appname, and message text are equal.
+ * Also parse the originating rank for the summary idset.
+ */
+static int dedup_key (const char *buf, int len, char *key, int keysz,
+                      uint32_t *rankp)
+{
+    struct stdlog_header hdr;
+    const char *msg;
+    int msglen;
+
+    stdlog_init (&hdr);
+    if (stdlog_decode (buf, len, &hdr, NULL, NULL, &msg, &msglen) < 0)
+        return -1;
+    if (snprintf (key, keysz, "%d:%s:%.*s",
+                  hdr.pri, hdr.appname, msglen, msg) >= keysz)
+        return -1;
+    *rankp = strtoul (hdr.hostname, NULL, 10);
+    return 0;
+}
+
+/* Forward one summary record for duplicates absorbed by 'e', if any.
+ * The summary is the first record with the duplicate count and rank
+ * idset appended to the message text (the last RFC 5424 field).
+ */
+static void dedup_summary_forward (logbuf_t *logbuf, struct dedup_entry *e)
+{
+    char buf[FLUX_MAX_LOGBUF + 1];
+    char *ranks;
+    int n;
+
+    if (e->count == 0)
+        return;
+    ranks = idset_encode (e->ranks, IDSET_FLAG_RANGE);
+    n = snprintf (buf, sizeof (buf), "%.*s [+%d duplicates from ranks %s]",
+                  e->len, e->buf, e->count, ranks ? ranks : "?");
+    if (n > FLUX_MAX_LOGBUF)
+        n = FLUX_MAX_LOGBUF;
+    (void)logbuf_forward (logbuf, buf, n);
+    free (ranks);
+}
+
+static void dedup_flush (logbuf_t *logbuf)
+{
+    zlist_t *keys;
+    char *key;
+
+    if (zhash_size (logbuf->dedup) == 0)
+        return;
+    if (!(keys = zhash_keys (logbuf->dedup)))
+        return;
+    while ((key = zlist_pop (keys))) {
+        struct dedup_entry *e = zhash_lookup (logbuf->dedup, key);
+        if (e)
+            dedup_summary_forward (logbuf, e);
+        zhash_delete (logbuf->dedup, key);
+        free (key);
+    }
+    zlist_destroy (&keys);
+}
+
+static void dedup_timer_cb (flux_reactor_t *r, flux_watcher_t *w,
+                            int revents, void *arg)
+{
+    logbuf_t *logbuf = arg;
+    dedup_flush (logbuf);
+}
+
+/* Forward a record upstream, absorbing in-window duplicates.
+ * The first occurrence is forwarded immediately so logs stay timely;
+ * the one-shot timer emits summaries when the window closes.  Records
+ * that cannot be deduplicated (window disabled, undecodable record,
+ * table full, alloc failure) are forwarded as-is.
+ */
+static int logbuf_forward_dedup (logbuf_t *logbuf, const char *buf, int len)
+{
+    char key[FLUX_MAX_LOGBUF + 64];
+    uint32_t rank;
+    struct dedup_entry *e;
+
+    if (logbuf->dedup_window <= 0.
+            || !logbuf->dedup_timer
+            || dedup_key (buf, len, key, sizeof (key), &rank) < 0)
+        return logbuf_forward (logbuf, buf, len);
+    if ((e = zhash_lookup (logbuf->dedup, key))) {
+        e->count++;
+        (void)idset_set (e->ranks, rank);
+        return 0;
+    }
+    if ((int)zhash_size (logbuf->dedup) >= dedup_max_entries)
+        return logbuf_forward (logbuf, buf, len);
+    if (!(e = calloc (1, sizeof (*e)))
+            || !(e->ranks = idset_create (0, IDSET_FLAG_AUTOGROW))) {
+        dedup_entry_destroy (e);
+        return logbuf_forward (logbuf, buf, len);
+    }
+    if (len > FLUX_MAX_LOGBUF)
+        len = FLUX_MAX_LOGBUF;
+    memcpy (e->buf, buf, len);
+    e->buf[len] = '\0';
+    e->len = len;
+    if (zhash_insert (logbuf->dedup, key, e) < 0) {
+        dedup_entry_destroy (e);
+        return logbuf_forward (logbuf, buf, len);
+    }
+    zhash_freefn (logbuf->dedup, key, dedup_entry_destroy);
+    if (zhash_size (logbuf->dedup) == 1) {
+        flux_timer_watcher_reset (logbuf->dedup_timer,
+                                  logbuf->dedup_window, 0.);
+        flux_watcher_start (logbuf->dedup_timer);
+    }
+    return logbuf_forward (logbuf, buf, len);
+}
+
 static int logbuf_append (logbuf_t *logbuf, const char *buf, int len)
 {
     assert (logbuf->magic == LOGBUF_MAGIC);
@@ -496,7 +682,7 @@ static int logbuf_append (logbuf_t *logbuf, const char *buf, int len)
         if (logbuf->rank == 0) {
             flux_log_fprint (buf, len, logbuf->f);
         } else {
-            if (logbuf_forward (logbuf, buf, len) < 0)
+            if (logbuf_forward_dedup (logbuf, buf, len) < 0)
                 rc = -1;
         }
     }
@@ -649,6 +835,7 @@ static const struct flux_msg_handler_spec htab[] = {
 static void logbuf_finalize (void *arg)
 {
     logbuf_t *logbuf = arg;
+    dedup_flush (logbuf);
     flux_msg_handler_delvec (logbuf->handlers);
     logbuf_destroy (logbuf);
     /* FIXME: need logbuf_unregister_attrs() */
@@ -661,6 +848,11 @@ int logbuf_initialize (flux_t *h, uint32_t rank, attr_t *attrs)
         goto error;
     logbuf->h = h;
     logbuf->rank = rank;
+    if (!(logbuf->dedup_timer = flux_timer_watcher_create (
+                                        flux_get_reactor (h),
+                                        logbuf->dedup_window, 0.,
+                                        dedup_timer_cb, logbuf)))
+        goto error;
     if (logbuf_register_attrs (logbuf, attrs) < 0)
         goto error;
     if (flux_msg_handler_addvec (h, htab, logbuf, &logbuf->handlers) < 0)
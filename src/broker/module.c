@@ -27,25 +27,23 @@
 #include <inttypes.h>
 #include <argz.h>
 #include <czmq.h>
-#include <uuid.h>
 #include <flux/core.h>
 #include <jansson.h>
+#include <sys/syscall.h>
 #if HAVE_CALIPER
 #include <caliper/cali.h>
-#include <sys/syscall.h>
 #endif
 
 #include "src/common/libutil/log.h"
 #include "src/common/libutil/iterators.h"
+#include "src/common/libutil/monotime.h"
+#include "src/common/libutil/topictrie.h"
 
+#include "attr.h"
 #include "heartbeat.h"
 #include "module.h"
 #include "modservice.h"
-
-#ifndef UUID_STR_LEN
-#define UUID_STR_LEN 37     // defined in later libuuid headers
-#endif
-
+#include "flightrec.h"
 
 #define MODULE_MAGIC    0xfeefbe01
 struct broker_module {
@@ -61,9 +59,9 @@ struct broker_module {
     zsock_t *sock;          /* broker end of PAIR socket */
     struct flux_msg_cred cred; /* cred of connection */
 
-    uuid_t uuid;            /* uuid for unique request sender identity */
-    char uuid_str[UUID_STR_LEN];
+    char uuid_str[64];      /* compact unique request sender identity */
     pthread_t t;            /* module thread */
+    pid_t tid;              /* kernel tid of module thread, 0 until started */
     mod_main_f *main;       /* dlopened mod_main() */
     char *name;
     void *dso;              /* reference on dlopened module */
@@ -73,7 +71,22 @@ struct broker_module {
     char *argz;
     int status;
     int errnum;
+    struct timespec t_start; /* set by module_start() */
+    double load_time;       /* ms from start to leaving INIT, for lsmod */
     bool muted;             /* module is under directive 42, no new messages */
+    struct flightrec *fr;   /* flight recorder ring (broker side) */
+    attr_shared_t *attr_shared; /* direct attr reads from module thread */
+
+    /* Always-on message accounting, broker-side view:  tx is broker
+     * to module, rx is module to broker.  Cumulative, so consumers
+     * can derive rates from two samples.  The difference between
+     * broker tx-count and the module's own rx counters (from
+     * <name>.stats.get) approximates its input backlog.
+     */
+    uint64_t tx_count;
+    uint64_t rx_count;
+    uint64_t tx_bytes;
+    uint64_t rx_bytes;
 
     modpoller_cb_f poller_cb;
     void *poller_arg;
@@ -87,7 +100,7 @@ struct broker_module {
 
     flux_t *h;               /* module's handle */
 
-    zlist_t *subs;          /* subscription strings */
+    struct topictrie *subs; /* subscription topic prefixes */
 };
 
 struct modhash {
@@ -95,6 +108,7 @@ struct modhash {
     uint32_t rank;
     flux_t *broker_h;
     heartbeat_t *heartbeat;
+    attr_shared_t *attr_shared;
 };
 
 static int setup_module_profiling (module_t *p)
@@ -143,6 +157,13 @@ done:
     return rc;
 }
 
+/* Adapt attr_shared_get() to the flux_attr_lookup_f signature.
+ */
+static char *module_attr_lookup (const char *name, void *arg)
+{
+    return attr_shared_get (arg, name);
+}
+
 static void *module_thread (void *arg)
 {
     module_t *p = arg;
@@ -157,11 +178,16 @@ static void *module_thread (void *arg)
     flux_msg_t *msg;
     flux_conf_t *conf;
 
+    /* Written once here, read by the broker thread for lsmod stats.
+     * A broker read before this point sees 0 and skips the stats.
+     */
+    p->tid = syscall (SYS_gettid);
+
     setup_module_profiling (p);
 
     /* Connect to broker socket, enable logging, register built-in services
      */
-    if (asprintf (&uri, "shmem://%s", p->uuid_str) < 0) {
+    if (asprintf (&uri, "shmem://%s&ptr", p->uuid_str) < 0) {
         log_err ("asprintf");
         goto done;
     }
@@ -177,6 +203,15 @@ static void *module_thread (void *arg)
         log_err ("%s: error faking rank attribute", p->name);
         goto done;
     }
+    /* Resolve rank-local attributes directly from the broker's shared
+     * table instead of sending attr.get RPCs to a co-located thread.
+     */
+    if (p->attr_shared
+        && flux_attr_set_lookup (p->h, module_attr_lookup,
+                                 p->attr_shared) < 0) {
+        log_err ("%s: flux_attr_set_lookup", p->name);
+        goto done;
+    }
     flux_log_set_appname (p->h, p->name);
     /* Copy the broker's config object so that modules
      * can call flux_get_conf() and expect it to always succeed.
@@ -270,6 +305,41 @@ static int module_get_idle (module_t *p)
     return heartbeat_get_epoch (p->heartbeat) - p->lastseen;
 }
 
+/* Messages cross the broker/module-thread boundary as a single
+ * pointer-sized frame with ownership transferred to the receiver,
+ * skipping zmq framing for intra-process delivery.  The module end of
+ * the pair opts into the same mode via the shmem connector's "&ptr"
+ * path option (see module_thread()).
+ */
+static int module_sendmsg_ptr (module_t *p, flux_msg_t **msg)
+{
+    zframe_t *zf;
+
+    if (!(zf = zframe_new (msg, sizeof (*msg)))) {
+        errno = ENOMEM;
+        return -1;
+    }
+    if (zframe_send (&zf, p->sock, 0) < 0) {
+        zframe_destroy (&zf);
+        return -1;
+    }
+    *msg = NULL;
+    return 0;
+}
+
+static flux_msg_t *module_recvmsg_ptr (module_t *p)
+{
+    zframe_t *zf;
+    flux_msg_t *msg;
+
+    if (!(zf = zframe_recv (p->sock)))
+        return NULL;
+    assert (zframe_size (zf) == sizeof (msg));
+    memcpy (&msg, zframe_data (zf), sizeof (msg));
+    zframe_destroy (&zf);
+    return msg;
+}
+
 flux_msg_t *module_recvmsg (module_t *p)
 {
     flux_msg_t *msg = NULL;
@@ -278,7 +348,7 @@ flux_msg_t *module_recvmsg (module_t *p)
 
     assert (p->magic == MODULE_MAGIC);
 
-    if (!(msg = flux_msg_recvzsock (p->sock)))
+    if (!(msg = module_recvmsg_ptr (p)))
         goto error;
     if (flux_msg_get_type (msg, &type) < 0)
         goto error;
@@ -310,70 +380,86 @@ flux_msg_t *module_recvmsg (module_t *p)
         cred.rolemask = p->cred.rolemask;
     if (flux_msg_set_cred (msg, cred) < 0)
         goto error;
+    p->rx_count++;
+    p->rx_bytes += flux_msg_encode_size (msg);
+    flightrec_record (p->fr, FLIGHTREC_RX, msg);
     return msg;
 error:
     flux_msg_destroy (msg);
     return NULL;
 }
 
-int module_sendmsg (module_t *p, const flux_msg_t *msg)
+/* Send '*msg' to the module, transferring ownership on success (setting
+ * '*msg' to NULL) so that a message relayed from a co-resident endpoint
+ * crosses the thread boundary without being copied.  Route fix-up is
+ * performed on the message in place;  on failure the caller retains
+ * ownership, but should only destroy the message or use it to generate
+ * an error response, as its route stack may have been altered.
+ */
+int module_sendmsg_take (module_t *p, flux_msg_t **msg)
 {
-    flux_msg_t *cpy = NULL;
     int type;
-    int rc = -1;
+    size_t size;
 
-    if (!msg)
+    if (!msg || !*msg)
         return 0;
-    if (flux_msg_get_type (msg, &type) < 0)
-        goto done;
+    if (flux_msg_get_type (*msg, &type) < 0)
+        return -1;
     if (p->muted && type != FLUX_MSGTYPE_KEEPALIVE) {
         /* Muted modules only accept keepalive messages */
-        const char *topic;
-        (void) flux_msg_get_topic (msg, &topic);
         errno = ENOSYS;
-        goto done;
+        return -1;
     }
     switch (type) {
         case FLUX_MSGTYPE_REQUEST: { /* simulate DEALER socket */
             char uuid[16];
             snprintf (uuid, sizeof (uuid), "%"PRIu32, p->rank);
-            if (!(cpy = flux_msg_copy (msg, true)))
-                goto done;
-            if (flux_msg_push_route (cpy, uuid) < 0)
-                goto done;
-            if (flux_msg_sendzsock (p->sock, cpy) < 0)
-                goto done;
+            if (flux_msg_push_route (*msg, uuid) < 0)
+                return -1;
             break;
         }
-        case FLUX_MSGTYPE_RESPONSE: { /* simulate ROUTER socket */
-            if (!(cpy = flux_msg_copy (msg, true)))
-                goto done;
-            if (flux_msg_pop_route (cpy, NULL) < 0)
-                goto done;
-            if (flux_msg_sendzsock (p->sock, cpy) < 0)
-                goto done;
+        case FLUX_MSGTYPE_RESPONSE: /* simulate ROUTER socket */
+            if (flux_msg_pop_route (*msg, NULL) < 0)
+                return -1;
             break;
-        }
         default:
-            if (flux_msg_sendzsock (p->sock, msg) < 0)
-                goto done;
             break;
     }
-    rc = 0;
-done:
+    /* Account and record before the send - once ownership is transferred
+     * the module thread may destroy the message at any time.
+     */
+    size = flux_msg_encode_size (*msg);
+    flightrec_record (p->fr, FLIGHTREC_TX, *msg);
+    if (module_sendmsg_ptr (p, msg) < 0)
+        return -1;
+    p->tx_count++;
+    p->tx_bytes += size;
+    return 0;
+}
+
+int module_sendmsg (module_t *p, const flux_msg_t *msg)
+{
+    flux_msg_t *cpy;
+    int rc;
+
+    if (!msg)
+        return 0;
+    if (!(cpy = flux_msg_copy (msg, true)))
+        return -1;
+    rc = module_sendmsg_take (p, &cpy);
     flux_msg_destroy (cpy);
     return rc;
 }
 
-int module_response_sendmsg (modhash_t *mh, const flux_msg_t *msg)
+int module_response_sendmsg (modhash_t *mh, flux_msg_t **msg)
 {
     char *uuid = NULL;
     int rc = -1;
     module_t *p;
 
-    if (!msg)
+    if (!msg || !*msg)
         return 0;
-    if (flux_msg_get_route_last (msg, &uuid) < 0)
+    if (flux_msg_get_route_last (*msg, &uuid) < 0)
         goto done;
     if (!uuid) {
         errno = EPROTO;
@@ -383,7 +469,7 @@ int module_response_sendmsg (modhash_t *mh, const flux_msg_t *msg)
         errno = ENOSYS;
         goto done;
     }
-    rc = module_sendmsg (p, msg);
+    rc = module_sendmsg_take (p, msg);
 done:
     if (uuid)
         free (uuid);
@@ -425,6 +511,15 @@ static void module_destroy (module_t *p)
 
     flux_watcher_stop (p->broker_w);
     flux_watcher_destroy (p->broker_w);
+    /* Drain any messages still queued on the pair socket - in pointer
+     * transfer mode they are owned by the receiver once sent.
+     */
+    {
+        flux_msg_t *msg;
+        while (p->sock && (zsock_events (p->sock) & ZMQ_POLLIN)
+                       && (msg = module_recvmsg_ptr (p)))
+            flux_msg_destroy (msg);
+    }
     zsock_destroy (&p->sock);
 
 #ifndef __SANITIZE_ADDRESS__
@@ -439,12 +534,8 @@ static void module_destroy (module_t *p)
             flux_msg_destroy (msg);
     }
     flux_msg_destroy (p->insmod);
-    if (p->subs) {
-        char *s;
-        while ((s = zlist_pop (p->subs)))
-            free (s);
-        zlist_destroy (&p->subs);
-    }
+    topictrie_destroy (p->subs);
+    attr_shared_decref (p->attr_shared);
     zlist_destroy (&p->rmmod);
     p->magic = ~MODULE_MAGIC;
     free (p);
@@ -493,6 +584,7 @@ int module_start (module_t *p)
     int rc = -1;
 
     flux_watcher_start (p->broker_w);
+    monotime (&p->t_start);
     if ((errnum = pthread_create (&p->t, NULL, module_thread, p))) {
         errno = errnum;
         goto done;
@@ -545,6 +637,8 @@ void module_set_status (module_t *p, int new_status)
     assert (new_status != FLUX_MODSTATE_INIT);  /* illegal state transition */
     assert (p->status != FLUX_MODSTATE_EXITED); /* illegal state transition */
     int prev_status = p->status;
+    if (prev_status == FLUX_MODSTATE_INIT)
+        p->load_time = monotime_since (p->t_start);
     p->status = new_status;
     if (p->status_cb)
         p->status_cb (p, prev_status, p->status_arg);
@@ -614,7 +708,6 @@ module_t *module_add (modhash_t *mh, const char *path)
     const char **mod_namep;
     mod_main_f *mod_main;
     zfile_t *zf;
-    int rc;
 
     dlerror ();
     if (!(dso = dlopen (path, RTLD_NOW | RTLD_LOCAL | FLUX_DEEPBIND))) {
@@ -641,6 +734,7 @@ module_t *module_add (modhash_t *mh, const char *path)
         errno = ENOMEM;
         goto cleanup;
     }
+    p->fr = flightrec_ring (p->name); /* NULL (disabled) on alloc failure */
     zf = zfile_new (NULL, path);
     if (!(p->digest = strdup (zfile_digest (zf)))) {
         errno = ENOMEM;
@@ -648,20 +742,38 @@ module_t *module_add (modhash_t *mh, const char *path)
     }
     p->size = (int)zfile_cursize (zf);
     zfile_destroy (&zf);
-    uuid_generate (p->uuid);
-    uuid_unparse (p->uuid, p->uuid_str);
     if (!(p->rmmod = zlist_new ())) {
         errno = ENOMEM;
         goto cleanup;
     }
-    if (!(p->subs = zlist_new ())) {
+    if (!(p->subs = topictrie_create ())) {
         errno = ENOMEM;
         goto cleanup;
     }
 
     p->rank = mh->rank;
+
+    /* Sender identity, pushed as the first route frame on every request
+     * the module originates.  This frame rides along on every overlay
+     * hop and back in the response, so use a compact "<rank>-<name>" id
+     * instead of a uuid string - globally unique since module names are
+     * unique within a broker (enforced by the modhash insert below).
+     */
+    if (snprintf (p->uuid_str,
+                  sizeof (p->uuid_str),
+                  "%"PRIu32"-%s",
+                  p->rank,
+                  p->name) >= (int)sizeof (p->uuid_str)) {
+        errno = EINVAL;
+        goto cleanup;
+    }
+
     p->broker_h = mh->broker_h;
     p->heartbeat = mh->heartbeat;
+    if (mh->attr_shared) {
+        p->attr_shared = mh->attr_shared;
+        attr_shared_incref (p->attr_shared);
+    }
 
     /* Broker end of PAIR socket is opened here.
      */
@@ -679,6 +791,8 @@ module_t *module_add (modhash_t *mh, const char *path)
         log_err ("flux_zmq_watcher_create");
         goto cleanup;
     }
+    /* message path: stay ahead of housekeeping watchers under load */
+    flux_watcher_set_priority (p->broker_w, FLUX_WATCHER_PRIORITY_HIGH);
     /* Set creds for connection.
      * Since this is a point to point connection between broker threads,
      * credentials are always those of the instance owner.
@@ -688,8 +802,11 @@ module_t *module_add (modhash_t *mh, const char *path)
 
     /* Update the modhash.
      */
-    rc = zhash_insert (mh->zh_byuuid, module_get_uuid (p), p);
-    assert (rc == 0); /* uuids are by definition unique */
+    if (zhash_insert (mh->zh_byuuid, module_get_uuid (p), p) < 0) {
+        log_msg ("module '%s' is already loaded", p->name);
+        errno = EEXIST;
+        goto cleanup;
+    }
     zhash_freefn (mh->zh_byuuid, module_get_uuid (p),
                   (zhash_free_fn *)module_destroy);
     return p;
@@ -755,6 +872,48 @@ void modhash_set_heartbeat (modhash_t *mh, heartbeat_t *hb)
     mh->heartbeat = hb;
 }
 
+void modhash_set_attr_shared (modhash_t *mh, attr_shared_t *sh)
+{
+    mh->attr_shared = sh;
+}
+
+/* Read minor/major page fault counts for the module thread from
+ * /proc/self/task/<tid>/stat.  Threads share the process address space
+ * so there is no per-thread RSS, but the kernel maintains fault counts
+ * per thread, attributing memory growth to the thread that caused it.
+ * Returns -1 if unavailable (thread not yet started, or no procfs).
+ */
+static int module_get_pgfaults (module_t *p,
+                                uint64_t *minflt,
+                                uint64_t *majflt)
+{
+    char path[64];
+    char buf[1024];
+    unsigned long minf, majf;
+    char *s = NULL;
+    FILE *f;
+
+    if (p->tid <= 0)
+        return -1;
+    snprintf (path, sizeof (path), "/proc/self/task/%d/stat", (int)p->tid);
+    if (!(f = fopen (path, "r")))
+        return -1;
+    if (fgets (buf, sizeof (buf), f))
+        s = strrchr (buf, ')'); /* comm field may contain spaces */
+    fclose (f);
+    if (!s)
+        return -1;
+    /* after comm: state ppid pgrp session tty tpgid flags minflt cminflt
+     * majflt ... (proc(5))
+     */
+    if (sscanf (s + 1, " %*c %*d %*d %*d %*d %*d %*u %lu %*u %lu",
+                &minf, &majf) != 2)
+        return -1;
+    *minflt = minf;
+    *majflt = majf;
+    return 0;
+}
+
 json_t *module_get_modlist (modhash_t *mh, struct service_switch *sw)
 {
     json_t *mods = NULL;
@@ -769,18 +928,29 @@ json_t *module_get_modlist (modhash_t *mh, struct service_switch *sw)
     uuid = zlist_first (uuids);
     while (uuid) {
         if ((p = zhash_lookup (mh->zh_byuuid, uuid))) {
+            uint64_t minflt = 0;
+            uint64_t majflt = 0;
             json_t *svcs;
             json_t *entry;
 
+            (void)module_get_pgfaults (p, &minflt, &majflt);
             if (!(svcs  = service_list_byuuid (sw, uuid)))
                 goto nomem;
-            if (!(entry = json_pack ("{s:s s:i s:s s:i s:i s:o}",
+            if (!(entry = json_pack ("{s:s s:i s:s s:i s:i s:f s:o"
+                                     " s:I s:I s:I s:I s:I s:I}",
                                      "name", module_get_name (p),
                                      "size", p->size,
                                      "digest", p->digest,
                                       "idle", module_get_idle (p),
                                       "status", p->status,
-                                      "services", svcs))) {
+                                      "loadtime", p->load_time,
+                                      "services", svcs,
+                                      "tx-count", (json_int_t)p->tx_count,
+                                      "rx-count", (json_int_t)p->rx_count,
+                                      "tx-bytes", (json_int_t)p->tx_bytes,
+                                      "rx-bytes", (json_int_t)p->rx_bytes,
+                                      "minflt", (json_int_t)minflt,
+                                      "majflt", (json_int_t)majflt))) {
                 json_decref (svcs);
                 goto nomem;
             }
@@ -833,22 +1003,14 @@ module_t *module_lookup_byname (modhash_t *mh, const char *name)
 int module_subscribe (modhash_t *mh, const char *uuid, const char *topic)
 {
     module_t *p = zhash_lookup (mh->zh_byuuid, uuid);
-    char *cpy = NULL;
     int rc = -1;
 
     if (!p) {
         errno = ENOENT;
         goto done;
     }
-    if (!(cpy = strdup (topic))) {
-        errno = ENOMEM;
-        goto done;
-    }
-    if (zlist_push (p->subs, cpy) < 0) {
-        free (cpy);
-        errno = ENOMEM;
+    if (topictrie_add (p->subs, topic) < 0)
         goto done;
-    }
     rc = 0;
 done:
     return rc;
@@ -857,22 +1019,13 @@ done:
 int module_unsubscribe (modhash_t *mh, const char *uuid, const char *topic)
 {
     module_t *p = zhash_lookup (mh->zh_byuuid, uuid);
-    char *s;
     int rc = -1;
 
     if (!p) {
         errno = ENOENT;
         goto done;
     }
-    s = zlist_first (p->subs);
-    while (s) {
-        if (!strcmp (topic, s)) {
-            zlist_remove (p->subs, s);
-            free (s);
-            break;
-        }
-        s = zlist_next (p->subs);
-    }
+    (void)topictrie_remove (p->subs, topic); /* unmatched unsub is a no-op */
     rc = 0;
 done:
     return rc;
@@ -880,14 +1033,7 @@ done:
 
 static bool match_sub (module_t *p, const char *topic)
 {
-    char *s = zlist_first (p->subs);
-
-    while (s) {
-        if (!strncmp (topic, s, strlen (s)))
-            return true;
-        s = zlist_next (p->subs);
-    }
-    return false;
+    return topictrie_match (p->subs, topic);
 }
 
 int module_event_mcast (modhash_t *mh, const flux_msg_t *msg)
@@ -15,6 +15,7 @@
 
 #include "src/common/librouter/disconnect.h"
 
+#include "attr.h"
 #include "heartbeat.h"
 #include "service.h"
 
@@ -31,6 +32,7 @@ void modhash_destroy (modhash_t *mh);
 void modhash_set_rank (modhash_t *mh, uint32_t rank);
 void modhash_set_flux (modhash_t *mh, flux_t *h);
 void modhash_set_heartbeat (modhash_t *mh, heartbeat_t *hb);
+void modhash_set_attr_shared (modhash_t *mh, attr_shared_t *sh);
 
 /* Prepare module at 'path' for starting.
  */
@@ -56,9 +58,14 @@ const char *module_get_uuid (module_t *p);
 void module_set_poller_cb (module_t *p, modpoller_cb_f cb, void *arg);
 
 /* Send/recv a message for to/from a specific module.
+ * module_sendmsg_take() transfers ownership of '*msg' on success (setting
+ * it to NULL), avoiding a copy;  route fix-up is done in place, so on
+ * failure the caller should only destroy the message or use it to
+ * generate an error response.  module_sendmsg() copies.
  */
 flux_msg_t *module_recvmsg (module_t *p);
 int module_sendmsg (module_t *p, const flux_msg_t *msg);
+int module_sendmsg_take (module_t *p, flux_msg_t **msg);
 
 /* Pass module's requests through this function to enable disconnect
  * messages to be sent when the module is unloaded.  The callback will
@@ -94,8 +101,9 @@ void module_set_errnum (module_t *p, int errnum);
 
 /* Send a response message to the module whose uuid matches the
  * next hop in the routing stack.
+ * Ownership of '*msg' is transferred on success (see module_sendmsg_take).
  */
-int module_response_sendmsg (modhash_t *mh, const flux_msg_t *msg);
+int module_response_sendmsg (modhash_t *mh, flux_msg_t **msg);
 
 /* Find a module matching 'uuid'.
  */
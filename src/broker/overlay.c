@@ -28,6 +28,18 @@
 #include "heartbeat.h"
 #include "overlay.h"
 #include "attr.h"
+#include "flightrec.h"
+
+/* Liveness on overlay links is inferred from data traffic:  any message
+ * counts, so keepalives are only sent on idle links.  While a link stays
+ * idle, the keepalive interval doubles from min to max (in heartbeat
+ * epochs), and each keepalive announces the sender's next interval in
+ * the keepalive status field so the peer knows how long a healthy link
+ * may legitimately remain silent.  Data traffic resets the interval to
+ * the minimum.
+ */
+static const int keepalive_min_interval = 2;
+static const int keepalive_max_interval = 32;
 
 struct endpoint {
     zsock_t *zs;
@@ -54,6 +66,8 @@ struct overlay {
     overlay_sock_cb_f parent_cb;
     void *parent_arg;
     int parent_lastsent;
+    int parent_keepalive_epoch;     /* epoch of last keepalive sent up */
+    int parent_keepalive_interval;  /* epochs until the next one is due */
 
     struct endpoint *child;     /* ROUTER - requests from children */
     overlay_sock_cb_f child_cb;
@@ -68,11 +82,42 @@ struct overlay {
     overlay_init_cb_f init_cb;
     void *init_arg;
 
+    /* Coalescing send mode:  when send_batch_limit > 0, messages are
+     * queued per socket and written back to back, either when the
+     * watermark is reached or before the reactor blocks in poll, so
+     * that bursts of small messages amortize socket overhead.
+     */
+    uint32_t send_batch_limit;
+    zlist_t *parent_sendq;
+    zlist_t *child_sendq;
+    flux_watcher_t *sendq_prep;
+
+    /* Per-peer egress backpressure:  when nonzero, a send to a child
+     * whose queued bytes would exceed the limit fails with ENOBUFS
+     * instead of letting one stalled subtree consume rank memory.
+     */
+    uint32_t child_sendq_bytes_limit;
+
+    /* Latency injection for TBON scaling experiments:  when nonzero,
+     * each overlay send is held for the configured time before going
+     * on the wire, emulating a per-hop network delay so that a large
+     * single-node instance (flux start -s N) behaves like a
+     * distributed one.  Not for production use.
+     */
+    uint32_t inject_latency_msec;
+    zlist_t *delayq;            /* struct delayed_msg, in due order */
+    flux_watcher_t *delay_timer;
+
     int idle_warning;
 };
 
 typedef struct {
     int lastseen;
+    int quiet_interval;         /* max silence (epochs) peer announced */
+    uint64_t tx_count;          /* cumulative messages sent to this peer */
+    uint64_t tx_bytes;          /* cumulative bytes sent to this peer */
+    uint32_t sendq_count;       /* messages queued for this peer */
+    uint32_t sendq_bytes;       /* bytes queued for this peer */
 } child_t;
 
 static void endpoint_destroy (struct endpoint *ep)
@@ -148,8 +193,12 @@ void overlay_log_idle_children (struct overlay *ov)
 
     if (ov->idle_warning > 0) {
         FOREACH_ZHASH (ov->children, uuid, child) {
+            /* A child backing off its keepalives announces how long it
+             * may stay silent - extend the warning threshold by that
+             * much so an idle-but-healthy child isn't reported.
+             */
             idle = ov->epoch - child->lastseen;
-            if (idle >= ov->idle_warning)
+            if (idle >= ov->idle_warning + child->quiet_interval)
                 flux_log (ov->h, LOG_CRIT, "child %s idle for %d heartbeats",
                           uuid, idle);
         }
@@ -167,6 +216,15 @@ void overlay_checkin_child (struct overlay *ov, const char *uuid)
     child->lastseen = ov->epoch;
 }
 
+void overlay_keepalive_child (struct overlay *ov,
+                              const char *uuid,
+                              int quiet_interval)
+{
+    child_t *child = zhash_lookup (ov->children, uuid);
+    if (child)
+        child->quiet_interval = quiet_interval;
+}
+
 int overlay_set_parent (struct overlay *ov, const char *fmt, ...)
 {
     int rc = -1;
@@ -187,7 +245,103 @@ const char *overlay_get_parent (struct overlay *ov)
     return ov->parent->uri;
 }
 
-int overlay_sendmsg_parent (struct overlay *ov, const flux_msg_t *msg)
+/* Look up the child peer a message is destined for, by its route stack.
+ * Returns NULL if the route is missing or the peer is unknown.
+ */
+static child_t *child_lookup_route (struct overlay *ov, const flux_msg_t *msg)
+{
+    char *uuid = NULL;
+    child_t *child = NULL;
+
+    if (flux_msg_get_route_last (msg, &uuid) == 0 && uuid != NULL)
+        child = zhash_lookup (ov->children, uuid);
+    free (uuid);
+    return child;
+}
+
+static void child_account_tx (struct overlay *ov, child_t *child, size_t size)
+{
+    child->tx_count++;
+    child->tx_bytes += size;
+}
+
+/* Drain a send queue to a zmq socket, writing queued messages back to
+ * back so that zmq can pipeline them onto the wire in a single batch.
+ * Messages that cannot be sent are logged and dropped;  by the time they
+ * are flushed the originating send has already returned success.
+ * When draining the child queue, per-peer queue depth and egress
+ * counters are updated along the way.
+ */
+static void sendq_flush_one (struct overlay *ov, zlist_t *sendq, void *zs,
+                             bool to_child)
+{
+    flux_msg_t *msg;
+
+    while ((msg = zlist_pop (sendq))) {
+        if (to_child) {
+            child_t *child = child_lookup_route (ov, msg);
+            if (child) {
+                size_t size = flux_msg_encode_size (msg);
+                child->sendq_count--;
+                child->sendq_bytes -= size;
+                child_account_tx (ov, child, size);
+            }
+        }
+        if (flux_msg_sendzsock (zs, msg) < 0 && errno != EHOSTUNREACH)
+            flux_log_error (ov->h, "%s: flux_msg_sendzsock", __FUNCTION__);
+        flux_msg_destroy (msg);
+    }
+}
+
+static void sendq_flush (struct overlay *ov)
+{
+    if (ov->parent_sendq && zlist_size (ov->parent_sendq) > 0
+                         && ov->parent && ov->parent->zs)
+        sendq_flush_one (ov, ov->parent_sendq, ov->parent->zs, false);
+    if (ov->child_sendq && zlist_size (ov->child_sendq) > 0
+                        && ov->child && ov->child->zs)
+        sendq_flush_one (ov, ov->child_sendq, ov->child->zs, true);
+    if (ov->sendq_prep)
+        flux_watcher_stop (ov->sendq_prep);
+}
+
+/* Runs just before the reactor blocks in poll - the loop boundary.
+ */
+static void sendq_prep_cb (flux_reactor_t *r,
+                           flux_watcher_t *w,
+                           int revents,
+                           void *arg)
+{
+    struct overlay *ov = arg;
+
+    sendq_flush (ov);
+}
+
+/* Append a copy of 'msg' to 'sendq', flushing if the watermark is reached,
+ * otherwise arming the prep watcher so the queue drains at the end of the
+ * current reactor iteration.
+ * Returns 0 on success, -1 on failure with errno set.
+ */
+static int sendq_append (struct overlay *ov, zlist_t *sendq,
+                         const flux_msg_t *msg)
+{
+    flux_msg_t *cpy;
+
+    if (!(cpy = flux_msg_copy (msg, true)))
+        return -1;
+    if (zlist_append (sendq, cpy) < 0) {
+        flux_msg_destroy (cpy);
+        errno = ENOMEM;
+        return -1;
+    }
+    if (zlist_size (sendq) >= ov->send_batch_limit)
+        sendq_flush (ov);
+    else if (ov->sendq_prep)
+        flux_watcher_start (ov->sendq_prep);
+    return 0;
+}
+
+static int sendmsg_parent_now (struct overlay *ov, const flux_msg_t *msg)
 {
     int rc = -1;
 
@@ -195,9 +349,17 @@ int overlay_sendmsg_parent (struct overlay *ov, const flux_msg_t *msg)
         errno = EHOSTUNREACH;
         goto done;
     }
-    rc = flux_msg_sendzsock (ov->parent->zs, msg);
-    if (rc == 0)
+    if (ov->send_batch_limit > 0)
+        rc = sendq_append (ov, ov->parent_sendq, msg);
+    else
+        rc = flux_msg_sendzsock (ov->parent->zs, msg);
+    if (rc == 0) {
         ov->parent_lastsent = ov->epoch;
+        ov->parent_keepalive_interval = keepalive_min_interval;
+        flightrec_record (flightrec_ring ("overlay-parent"),
+                          FLIGHTREC_TX,
+                          msg);
+    }
 done:
     return rc;
 }
@@ -205,16 +367,28 @@ done:
 static int overlay_keepalive_parent (struct overlay *ov)
 {
     int idle = ov->epoch - ov->parent_lastsent;
+    int next_interval;
     flux_msg_t *msg = NULL;
     int rc = -1;
 
     if (!ov->parent || !ov->parent->zs || idle <= 1)
         return 0;
-    if (!(msg = flux_keepalive_encode (0, 0)))
+    if (ov->epoch - ov->parent_keepalive_epoch < ov->parent_keepalive_interval)
+        return 0;
+    /* Announce the next interval in the status field so the parent can
+     * distinguish a long-idle child from a dead one.
+     */
+    next_interval = ov->parent_keepalive_interval * 2;
+    if (next_interval > keepalive_max_interval)
+        next_interval = keepalive_max_interval;
+    if (!(msg = flux_keepalive_encode (0, next_interval)))
         goto done;
     if (flux_msg_enable_route (msg) < 0)
         goto done;
-    rc = flux_msg_sendzsock (ov->parent->zs, msg);
+    if ((rc = flux_msg_sendzsock (ov->parent->zs, msg)) == 0) {
+        ov->parent_keepalive_epoch = ov->epoch;
+        ov->parent_keepalive_interval = next_interval;
+    }
 done:
     flux_msg_destroy (msg);
     return rc;
@@ -265,7 +439,7 @@ void overlay_set_child_cb (struct overlay *ov, overlay_sock_cb_f cb, void *arg)
     ov->child_arg = arg;
 }
 
-int overlay_sendmsg_child (struct overlay *ov, const flux_msg_t *msg)
+static int sendmsg_child_now (struct overlay *ov, const flux_msg_t *msg)
 {
     int rc = -1;
 
@@ -273,16 +447,145 @@ int overlay_sendmsg_child (struct overlay *ov, const flux_msg_t *msg)
         errno = EINVAL;
         goto done;
     }
-    rc = flux_msg_sendzsock (ov->child->zs, msg);
+    child_t *child = child_lookup_route (ov, msg);
+    size_t size = flux_msg_encode_size (msg);
+    if (ov->send_batch_limit > 0) {
+        if (child && ov->child_sendq_bytes_limit > 0
+                && child->sendq_bytes + size > ov->child_sendq_bytes_limit) {
+            errno = ENOBUFS;
+            goto done;
+        }
+        /* Account before appending - sendq_append may flush immediately,
+         * and the flush path decrements these counters.
+         */
+        if (child) {
+            child->sendq_count++;
+            child->sendq_bytes += size;
+        }
+        if ((rc = sendq_append (ov, ov->child_sendq, msg)) < 0 && child) {
+            child->sendq_count--;
+            child->sendq_bytes -= size;
+        }
+    }
+    else {
+        if ((rc = flux_msg_sendzsock (ov->child->zs, msg)) == 0 && child)
+            child_account_tx (ov, child, size);
+    }
+    if (rc == 0)
+        flightrec_record (flightrec_ring ("overlay-child"),
+                          FLIGHTREC_TX,
+                          msg);
 done:
     return rc;
 }
 
-static int overlay_mcast_child_one (void *zsock,
+struct delayed_msg {
+    flux_msg_t *msg;
+    double due;                 /* reactor time */
+    bool to_child;
+};
+
+static void delayed_msg_destroy (struct delayed_msg *dmsg)
+{
+    if (dmsg) {
+        flux_msg_destroy (dmsg->msg);
+        free (dmsg);
+    }
+}
+
+/* Release messages whose hold time has elapsed, then re-arm the timer
+ * for the next one.  Since every message is held for the same time,
+ * the queue is already in due order.  Send errors are logged and the
+ * message dropped, as in sendq_flush_one() - the originating send has
+ * long since returned success.
+ */
+static void delayq_timer_cb (flux_reactor_t *r,
+                             flux_watcher_t *w,
+                             int revents,
+                             void *arg)
+{
+    struct overlay *ov = arg;
+    struct delayed_msg *dmsg;
+    double now = flux_reactor_now (r);
+
+    while ((dmsg = zlist_first (ov->delayq)) && dmsg->due <= now) {
+        zlist_remove (ov->delayq, dmsg);
+        if ((dmsg->to_child ? sendmsg_child_now (ov, dmsg->msg)
+                            : sendmsg_parent_now (ov, dmsg->msg)) < 0
+                && errno != EHOSTUNREACH)
+            flux_log_error (ov->h, "%s: delayed send", __FUNCTION__);
+        delayed_msg_destroy (dmsg);
+    }
+    if ((dmsg = zlist_first (ov->delayq))) {
+        flux_timer_watcher_reset (w, dmsg->due - now, 0.);
+        flux_watcher_start (w);
+    }
+}
+
+static int delayq_append (struct overlay *ov,
+                          const flux_msg_t *msg,
+                          bool to_child)
+{
+    struct delayed_msg *dmsg;
+    double delay = ov->inject_latency_msec * 1E-3;
+
+    if (!(dmsg = calloc (1, sizeof (*dmsg))))
+        return -1;
+    if (!(dmsg->msg = flux_msg_copy (msg, true))) {
+        free (dmsg);
+        return -1;
+    }
+    dmsg->due = flux_reactor_now (flux_get_reactor (ov->h)) + delay;
+    dmsg->to_child = to_child;
+    if (zlist_append (ov->delayq, dmsg) < 0) {
+        delayed_msg_destroy (dmsg);
+        errno = ENOMEM;
+        return -1;
+    }
+    if (zlist_size (ov->delayq) == 1) {
+        flux_timer_watcher_reset (ov->delay_timer, delay, 0.);
+        flux_watcher_start (ov->delay_timer);
+    }
+    return 0;
+}
+
+static void delayq_flush (struct overlay *ov)
+{
+    struct delayed_msg *dmsg;
+
+    if (ov->delayq) {
+        while ((dmsg = zlist_pop (ov->delayq))) {
+            if ((dmsg->to_child ? sendmsg_child_now (ov, dmsg->msg)
+                                : sendmsg_parent_now (ov, dmsg->msg)) < 0
+                    && errno != EHOSTUNREACH)
+                flux_log_error (ov->h, "%s: delayed send", __FUNCTION__);
+            delayed_msg_destroy (dmsg);
+        }
+    }
+    if (ov->delay_timer)
+        flux_watcher_stop (ov->delay_timer);
+}
+
+int overlay_sendmsg_parent (struct overlay *ov, const flux_msg_t *msg)
+{
+    if (ov->inject_latency_msec > 0 && ov->parent && ov->parent->zs)
+        return delayq_append (ov, msg, false);
+    return sendmsg_parent_now (ov, msg);
+}
+
+int overlay_sendmsg_child (struct overlay *ov, const flux_msg_t *msg)
+{
+    if (ov->inject_latency_msec > 0 && ov->child && ov->child->zs)
+        return delayq_append (ov, msg, true);
+    return sendmsg_child_now (ov, msg);
+}
+
+static int overlay_mcast_child_one (struct overlay *ov,
                                     const flux_msg_t *msg,
                                     const char *uuid)
 {
     flux_msg_t *cpy;
+    child_t *child;
     int rc = -1;
 
     if (!(cpy = flux_msg_copy (msg, true)))
@@ -291,10 +594,12 @@ static int overlay_mcast_child_one (void *zsock,
         goto done;
     if (flux_msg_push_route (cpy, uuid) < 0)
         goto done;
-    if (flux_msg_sendzsock (zsock, cpy) < 0) {
+    if (flux_msg_sendzsock (ov->child->zs, cpy) < 0) {
         if (errno != EHOSTUNREACH) // a child has disconnected - not an error
             goto done;
     }
+    else if ((child = zhash_lookup (ov->children, uuid)))
+        child_account_tx (ov, child, flux_msg_encode_size (cpy));
     rc = 0;
 done:
     flux_msg_destroy (cpy);
@@ -311,7 +616,7 @@ int overlay_mcast_child (struct overlay *ov, const flux_msg_t *msg)
     if (!ov->child || !ov->child->zs || !ov->children)
         return 0;
     FOREACH_ZHASH (ov->children, uuid, child) {
-        if (overlay_mcast_child_one (ov->child->zs, msg, uuid) < 0) {
+        if (overlay_mcast_child_one (ov, msg, uuid) < 0) {
             if (failures == 0)
                 first_errno = errno;
             failures++;
@@ -384,6 +689,8 @@ static int child_monitor_init (struct overlay *ov, struct endpoint *ep)
         log_err ("flux_zmq_watcher_create");
         return -1;
     }
+    flux_watcher_set_priority (ov->child_monitor_w,
+                               FLUX_WATCHER_PRIORITY_HIGH);
     flux_watcher_start (ov->child_monitor_w);
     return 0;
 }
@@ -425,6 +732,8 @@ static int bind_child (struct overlay *ov, struct endpoint *ep)
         log_err ("flux_zmq_watcher_create");
         return -1;
     }
+    /* message path: stay ahead of housekeeping watchers under load */
+    flux_watcher_set_priority (ep->w, FLUX_WATCHER_PRIORITY_HIGH);
     flux_watcher_start (ep->w);
     /* Ensure that ipc files are removed when the broker exits.
      */
@@ -463,6 +772,7 @@ static int connect_parent (struct overlay *ov, struct endpoint *ep)
     if (!(ep->w = flux_zmq_watcher_create (flux_get_reactor (ov->h),
                                            ep->zs, FLUX_POLLIN, parent_cb, ov)))
         goto error;
+    flux_watcher_set_priority (ep->w, FLUX_WATCHER_PRIORITY_HIGH);
     flux_watcher_start (ep->w);
     return 0;
 error:
@@ -571,6 +881,23 @@ int overlay_register_attrs (struct overlay *overlay, attr_t *attrs)
     if (attr_add_int (attrs, "tbon.descendants", overlay->tbon_descendants,
                       FLUX_ATTRFLAG_IMMUTABLE) < 0)
         return -1;
+    /* Batch window for the coalescing send path (0 = send immediately).
+     */
+    if (attr_add_active_uint32 (attrs, "tbon.send-batch-limit",
+                                &overlay->send_batch_limit, 0) < 0)
+        return -1;
+    /* Per-child egress queue byte limit (0 = unlimited).  Sends that
+     * would exceed it fail with ENOBUFS.
+     */
+    if (attr_add_active_uint32 (attrs, "tbon.child-sendq-bytes-limit",
+                                &overlay->child_sendq_bytes_limit, 0) < 0)
+        return -1;
+    /* Artificial per-hop send delay for scaling experiments
+     * (0 = disabled).  See src/test/tbon-sim.sh.
+     */
+    if (attr_add_active_uint32 (attrs, "tbon.inject-latency-msec",
+                                &overlay->inject_latency_msec, 0) < 0)
+        return -1;
 
     return 0;
 }
@@ -610,6 +937,58 @@ nomem:
 }
 
 
+/* Per-peer egress statistics:  cumulative tx message/byte counts and
+ * current send queue depth, keyed by peer uuid.
+ */
+static json_t *stats_object_create (struct overlay *ov)
+{
+    json_t *o = NULL;
+    json_t *child_o;
+    const char *uuid;
+    child_t *child;
+
+    if (!(o = json_object ()))
+        goto nomem;
+    FOREACH_ZHASH (ov->children, uuid, child) {
+        if (!(child_o = json_pack ("{s:I s:I s:i s:i}",
+                                   "tx-count", (json_int_t)child->tx_count,
+                                   "tx-bytes", (json_int_t)child->tx_bytes,
+                                   "sendq-count", child->sendq_count,
+                                   "sendq-bytes", child->sendq_bytes)))
+            goto nomem;
+        if (json_object_set_new (o, uuid, child_o) < 0) {
+            json_decref (child_o);
+            goto nomem;
+        }
+    }
+    return o;
+nomem:
+    json_decref (o);
+    errno = ENOMEM;
+    return NULL;
+}
+
+static void stats_cb (flux_t *h,
+                      flux_msg_handler_t *mh,
+                      const flux_msg_t *msg,
+                      void *arg)
+{
+    struct overlay *ov = arg;
+    json_t *o;
+
+    if (flux_request_decode (msg, NULL, NULL) < 0)
+        goto error;
+    if (!(o = stats_object_create (ov)))
+        goto error;
+    if (flux_respond_pack (h, msg, "O", o) < 0)
+        flux_log_error (h, "%s: flux_respond", __FUNCTION__);
+    json_decref (o);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+}
+
 static void lspeer_cb (flux_t *h,
                        flux_msg_handler_t *mh,
                        const flux_msg_t *msg,
@@ -643,6 +1022,15 @@ void overlay_destroy (struct overlay *ov)
         flux_watcher_destroy (ov->child_monitor_w);
         zsock_destroy (&ov->child_monitor_sock);
 
+        delayq_flush (ov);
+        flux_watcher_destroy (ov->delay_timer);
+        zlist_destroy (&ov->delayq);
+
+        sendq_flush (ov);
+        flux_watcher_destroy (ov->sendq_prep);
+        zlist_destroy (&ov->parent_sendq);
+        zlist_destroy (&ov->child_sendq);
+
         flux_msg_handler_delvec (ov->handlers);
         endpoint_destroy (ov->parent);
         endpoint_destroy (ov->child);
@@ -655,6 +1043,7 @@ void overlay_destroy (struct overlay *ov)
 static const struct flux_msg_handler_spec htab[] = {
     { FLUX_MSGTYPE_EVENT,  "heartbeat", heartbeat_cb, 0 },
     { FLUX_MSGTYPE_REQUEST,  "overlay.lspeer", lspeer_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST,  "overlay.stats.get", stats_cb, 0 },
     FLUX_MSGHANDLER_TABLE_END,
 };
 
@@ -666,11 +1055,32 @@ struct overlay *overlay_create (flux_t *h, int sec_typemask, const char *keydir)
         return NULL;
     ov->rank = FLUX_NODEID_ANY;
     ov->parent_lastsent = -1;
+    ov->parent_keepalive_epoch = -1;
+    ov->parent_keepalive_interval = keepalive_min_interval;
     ov->h = h;
     if (!(ov->children = zhash_new ())) {
         errno = ENOMEM;
         goto error;
     }
+    if (!(ov->parent_sendq = zlist_new ())
+            || !(ov->child_sendq = zlist_new ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (!(ov->sendq_prep = flux_prepare_watcher_create (flux_get_reactor (h),
+                                                        sendq_prep_cb,
+                                                        ov)))
+        goto error;
+    if (!(ov->delayq = zlist_new ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (!(ov->delay_timer = flux_timer_watcher_create (flux_get_reactor (h),
+                                                       0.,
+                                                       0.,
+                                                       delayq_timer_cb,
+                                                       ov)))
+        goto error;
     if (!(ov->sec = zsecurity_create (sec_typemask, keydir)))
         goto error;
 
@@ -70,6 +70,14 @@ int overlay_mcast_child (struct overlay *ov, const flux_msg_t *msg);
  */
 void overlay_checkin_child (struct overlay *ov, const char *uuid);
 
+/* Call when a keepalive is received from child 'uuid'.  'quiet_interval'
+ * is the number of heartbeats the child announced it may remain silent
+ * before its next keepalive, used to scale the idle warning threshold.
+ */
+void overlay_keepalive_child (struct overlay *ov,
+                              const char *uuid,
+                              int quiet_interval);
+
 /* Register callback that will be called each time a child connects/disconnects.
  * Use overlay_get_child_peer_count() to access the actual count.
  */
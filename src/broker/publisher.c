@@ -19,6 +19,7 @@
 #include <sodium.h>
 
 #include "src/common/libutil/macros.h"
+#include "src/common/libutil/monotime.h"
 
 #include "publisher.h"
 
@@ -28,11 +29,21 @@ struct sender {
     char name[32];
 };
 
+/* Published events are retained in a replay ring so that a subscriber
+ * that detects a sequence gap can refetch the missed range with
+ * event.replay instead of rebuilding its state from scratch.
+ */
+static const int replay_max = 1024;
+
 struct publisher {
     flux_t *h;
     flux_msg_handler_t **handlers;
     int seq;
     zlist_t *senders;
+    zlist_t *replay;            /* last replay_max events, oldest first */
+    int send_count;             /* events distributed */
+    int send_errors;            /* sender callback failures */
+    double fanout_msec;         /* cumulative time in send_event() */
 };
 
 void publisher_destroy (struct publisher *pub)
@@ -46,6 +57,12 @@ void publisher_destroy (struct publisher *pub)
                 free (sender);
             zlist_destroy (&pub->senders);
         }
+        if (pub->replay) {
+            flux_msg_t *msg;
+            while ((msg = zlist_pop (pub->replay)))
+                flux_msg_destroy (msg);
+            zlist_destroy (&pub->replay);
+        }
         free (pub);
         errno = saved_errno;
     }
@@ -59,7 +76,8 @@ struct publisher *publisher_create (void)
         errno = ENOMEM;
         return NULL;
     }
-    if (!(pub->senders = zlist_new ())) {
+    if (!(pub->senders = zlist_new ())
+            || !(pub->replay = zlist_new ())) {
         publisher_destroy (pub);
         errno = ENOMEM;
         return NULL;
@@ -115,20 +133,194 @@ error:
     return NULL;
 }
 
+/* Retain a copy of 'msg' in the replay ring, aging out the oldest
+ * entry once the ring is full.  Replay is best effort - on failure the
+ * event is still delivered, it just cannot be refetched later.
+ */
+static void replay_append (struct publisher *pub, const flux_msg_t *msg)
+{
+    flux_msg_t *cpy;
+
+    if (!(cpy = flux_msg_copy (msg, true))
+            || zlist_append (pub->replay, cpy) < 0) {
+        flux_msg_destroy (cpy);
+        return;
+    }
+    while (zlist_size (pub->replay) > replay_max) {
+        flux_msg_t *old = zlist_pop (pub->replay);
+        flux_msg_destroy (old);
+    }
+}
+
 /* Broadcast event using all senders.
  * Log failure, but don't abort the event at this point.
  */
 static void send_event (struct publisher *pub, const flux_msg_t *msg)
 {
     struct sender *sender;
+    struct timespec t0;
 
+    monotime (&t0);
+    replay_append (pub, msg);
     sender = zlist_first (pub->senders);
     while (sender != NULL) {
-        if (sender->send (sender->arg, msg) < 0)
+        if (sender->send (sender->arg, msg) < 0) {
+            pub->send_errors++;
             flux_log_error (pub->h, "%s: sender=%s",
                             __FUNCTION__, sender->name);
+        }
         sender = zlist_next (pub->senders);
     }
+    pub->send_count++;
+    pub->fanout_msec += monotime_since (t0);
+}
+
+static void stats_cb (flux_t *h, flux_msg_handler_t *mh,
+                      const flux_msg_t *msg, void *arg)
+{
+    struct publisher *pub = arg;
+
+    if (flux_request_decode (msg, NULL, NULL) < 0)
+        goto error;
+    if (flux_respond_pack (h, msg, "{s:i s:i s:i s:i s:i s:f}",
+                           "seq", pub->seq,
+                           "send-count", pub->send_count,
+                           "send-errors", pub->send_errors,
+                           "senders", (int)zlist_size (pub->senders),
+                           "replay-depth", (int)zlist_size (pub->replay),
+                           "fanout-msec", pub->fanout_msec) < 0)
+        flux_log_error (h, "%s: flux_respond", __FUNCTION__);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+}
+
+/* An event may be replayed to a requester under the same rules as
+ * normal delivery: private events go only to the instance owner or the
+ * user that published them.
+ */
+static bool replay_authorized (const flux_msg_t *event,
+                               struct flux_msg_cred cred)
+{
+    struct flux_msg_cred ecred;
+
+    if (!flux_msg_is_private (event))
+        return true;
+    if (flux_msg_get_cred (event, &ecred) < 0)
+        return false;
+    return flux_msg_cred_authorize (cred, ecred.userid) == 0;
+}
+
+/* Encode one buffered event in the same form event.pub accepts:
+ * topic, flags, and base64 payload (omitted if the event has none).
+ */
+static json_t *replay_encode_entry (const flux_msg_t *event, uint32_t seq)
+{
+    const char *topic;
+    const void *buf;
+    int len;
+    char *payload = NULL;
+    int flags = 0;
+    json_t *entry;
+
+    if (flux_msg_get_topic (event, &topic) < 0)
+        return NULL;
+    if (flux_msg_is_private (event))
+        flags |= FLUX_MSGFLAG_PRIVATE;
+    if (flux_msg_get_payload (event, &buf, &len) == 0) {
+        size_t dstlen = sodium_base64_encoded_len (len,
+                                           sodium_base64_VARIANT_ORIGINAL);
+        if (!(payload = malloc (dstlen)))
+            return NULL;
+        sodium_bin2base64 (payload, dstlen,
+                           (const unsigned char *)buf, len,
+                           sodium_base64_VARIANT_ORIGINAL);
+    }
+    if (payload)
+        entry = json_pack ("{s:i s:s s:i s:s}",
+                           "seq", (int)seq,
+                           "topic", topic,
+                           "flags", flags,
+                           "payload", payload);
+    else
+        entry = json_pack ("{s:i s:s s:i}",
+                           "seq", (int)seq,
+                           "topic", topic,
+                           "flags", flags);
+    free (payload);
+    return entry;
+}
+
+/* Refetch events in the sequence range [first, last] (last defaults to
+ * the current sequence number).  A subscriber that observes a gap can
+ * recover the missed events here instead of rebuilding its state from
+ * scratch.  If the start of the range has already aged out of the
+ * replay ring the request fails with ENODATA, and the consumer must
+ * fall back to a full resync.  Private events the requester is not
+ * authorized to see are elided, matching normal delivery.
+ */
+static void replay_cb (flux_t *h, flux_msg_handler_t *mh,
+                       const flux_msg_t *msg, void *arg)
+{
+    struct publisher *pub = arg;
+    struct flux_msg_cred cred;
+    int first;
+    int last = -1;
+    uint32_t oldest = pub->seq + 1;
+    uint32_t seq;
+    json_t *events = NULL;
+    flux_msg_t *event;
+
+    if (flux_request_unpack (msg, NULL, "{s:i s?:i}",
+                                        "first", &first,
+                                        "last", &last) < 0)
+        goto error;
+    if (last == -1)
+        last = pub->seq;
+    if (first < 1 || first > last || last > pub->seq) {
+        errno = EINVAL;
+        goto error;
+    }
+    if (flux_msg_get_cred (msg, &cred) < 0)
+        goto error;
+    if ((event = zlist_first (pub->replay))) {
+        if (flux_msg_get_seq (event, &oldest) < 0)
+            goto error;
+    }
+    if ((uint32_t)first < oldest) {
+        errno = ENODATA;
+        goto error;
+    }
+    if (!(events = json_array ()))
+        goto nomem;
+    event = zlist_first (pub->replay);
+    while (event != NULL) {
+        if (flux_msg_get_seq (event, &seq) < 0)
+            goto error;
+        if (seq > (uint32_t)last)
+            break;
+        if (seq >= (uint32_t)first && replay_authorized (event, cred)) {
+            json_t *entry;
+
+            if (!(entry = replay_encode_entry (event, seq)))
+                goto nomem;
+            if (json_array_append_new (events, entry) < 0) {
+                json_decref (entry);
+                goto nomem;
+            }
+        }
+        event = zlist_next (pub->replay);
+    }
+    if (flux_respond_pack (h, msg, "{s:o}", "events", events) < 0)
+        flux_log_error (h, "%s: flux_respond", __FUNCTION__);
+    return;
+nomem:
+    errno = ENOMEM;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+    json_decref (events);
 }
 
 void pub_cb (flux_t *h, flux_msg_handler_t *mh,
@@ -189,6 +381,8 @@ error:
 
 static const struct flux_msg_handler_spec htab[] = {
     { FLUX_MSGTYPE_REQUEST, "event.pub",  pub_cb, FLUX_ROLE_USER },
+    { FLUX_MSGTYPE_REQUEST, "event.replay",  replay_cb, FLUX_ROLE_USER },
+    { FLUX_MSGTYPE_REQUEST, "event.stats.get",  stats_cb, 0 },
     FLUX_MSGHANDLER_TABLE_END,
 };
 
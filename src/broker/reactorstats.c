@@ -0,0 +1,126 @@
+/************************************************************\
+ * Copyright 2020 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* reactorstats - per-watcher-type reactor callback profiling
+ *
+ * The <service>.reactorstats request reports callback counts and
+ * cumulative time per watcher type, so broker CPU use can be
+ * attributed to a specific watcher class (hot timer, leaky fd
+ * watcher, ...) without attaching a debugger.  Profiling is off by
+ * default; a request may include {"enable":b} to turn it on or off.
+ * Enabling resets the counters.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <jansson.h>
+#include <flux/core.h>
+#include "reactorstats.h"
+
+struct reactorstats_context {
+    flux_msg_handler_t *mh;
+    bool enabled;
+};
+
+static json_t *stats_tojson (flux_reactor_t *r)
+{
+    struct flux_reactor_stats stats[32];
+    int count = 32;
+    json_t *a;
+    json_t *o;
+    int i;
+
+    if (flux_reactor_stats_get (r, stats, &count) < 0)
+        return NULL;
+    if (!(a = json_array ()))
+        goto nomem;
+    for (i = 0; i < count; i++) {
+        if (!(o = json_pack ("{s:s s:I s:f}",
+                             "name", stats[i].name,
+                             "calls", (json_int_t)stats[i].calls,
+                             "time", stats[i].time)))
+            goto nomem;
+        if (json_array_append_new (a, o) < 0) {
+            json_decref (o);
+            goto nomem;
+        }
+    }
+    return a;
+nomem:
+    json_decref (a);
+    errno = ENOMEM;
+    return NULL;
+}
+
+static void reactorstats_request_cb (flux_t *h, flux_msg_handler_t *mh,
+                                     const flux_msg_t *msg, void *arg)
+{
+    struct reactorstats_context *ctx = arg;
+    flux_reactor_t *r = flux_get_reactor (h);
+    int enable = -1;
+    json_t *watchers;
+
+    if (flux_request_unpack (msg, NULL, "{s?:b}", "enable", &enable) < 0)
+        goto error;
+    if (enable != -1) {
+        flux_reactor_profile (r, enable);
+        ctx->enabled = enable;
+    }
+    if (!(watchers = stats_tojson (r)))
+        goto error;
+    if (flux_respond_pack (h, msg, "{s:b s:o}",
+                           "enabled", ctx->enabled,
+                           "watchers", watchers) < 0)
+        flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+}
+
+static void reactorstats_finalize (void *arg)
+{
+    struct reactorstats_context *ctx = arg;
+    flux_msg_handler_stop (ctx->mh);
+    flux_msg_handler_destroy (ctx->mh);
+    free (ctx);
+}
+
+int reactorstats_initialize (flux_t *h, const char *service)
+{
+    struct flux_match match = FLUX_MATCH_ANY;
+    struct reactorstats_context *ctx = calloc (1, sizeof (*ctx));
+    if (!ctx) {
+        errno = ENOMEM;
+        goto error;
+    }
+    match.typemask = FLUX_MSGTYPE_REQUEST;
+    if (flux_match_asprintf (&match, "%s.reactorstats", service) < 0) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (!(ctx->mh = flux_msg_handler_create (h, match,
+                                             reactorstats_request_cb, ctx)))
+        goto error;
+    flux_msg_handler_start (ctx->mh);
+    flux_aux_set (h, "flux::reactorstats", ctx, reactorstats_finalize);
+    flux_match_free (match);
+    return 0;
+error:
+    if (ctx)
+        reactorstats_finalize (ctx);
+    flux_match_free (match);
+    return -1;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -14,6 +14,10 @@
  * - Command env is inherited from broker, minus blocklist, plus FLUX_URI.
  * - All commands in a list are executed, even if one fails.
  * - The exit code of the first failed command is captured.
+ * - Commands tagged with the same nonzero group that are adjacent in the
+ *   list run concurrently; the list does not advance past the group until
+ *   all of its commands have completed.  Untagged commands (group of 0)
+ *   run one at a time as before.
  */
 
 #if HAVE_CONFIG_H
@@ -35,14 +39,18 @@ struct runat_command {
     flux_subprocess_t *p;
     flux_cmd_t *cmd;
     int flags;
+    int group;              /* nonzero = may run concurrently with group */
+    int index;              /* position in execution order, for logging */
     struct timespec t_start;
 };
 
 struct runat_entry {
     char *name;
-    zlist_t *commands;
+    zlist_t *commands;      /* commands not yet started */
+    zlist_t *running;       /* commands started, awaiting completion */
     int exit_code;
     int count;
+    int next_index;
     bool aborted;
     bool completed;
     runat_completion_f cb;
@@ -94,19 +102,18 @@ static char *get_cmdline (flux_cmd_t *cmd)
 
 static void log_command (flux_t *h,
                          struct runat_entry *entry,
+                         struct runat_command *command,
                          int rc,
                          double elapsed,
                          const char *s)
 {
-    struct runat_command *command = zlist_head (entry->commands);
-    int command_index = entry->count - zlist_size (entry->commands);
     char *cmdline = get_cmdline (command->cmd);
 
     flux_log (h,
               rc == 0 ? LOG_INFO : LOG_ERR,
               "%s.%d: %s %s (rc=%d) %.1fs",
               entry->name,
-              command_index,
+              command->index,
               cmdline ? cmdline : "???",
               s,
               rc,
@@ -122,29 +129,32 @@ static void completion_cb (flux_subprocess_t *p)
 {
     struct runat *r = flux_subprocess_aux_get (p, "runat");
     struct runat_entry *entry = flux_subprocess_aux_get (p, "runat_entry");
-    struct runat_command *cmd = zlist_head (entry->commands);
+    struct runat_command *cmd = flux_subprocess_aux_get (p, "runat_command");
     double elapsed = monotime_since (cmd->t_start) / 1000;
     int rc = flux_subprocess_exit_code (p);
     int signum;
 
     if (rc == 0 && entry->aborted) {
         rc = 1;
-        log_command (r->h, entry, rc, elapsed, "aborted after exit with rc=0");
+        log_command (r->h, entry, cmd, rc, elapsed,
+                     "aborted after exit with rc=0");
     }
     else if (rc >= 0)
-        log_command (r->h, entry, rc, elapsed, "Exited");
+        log_command (r->h, entry, cmd, rc, elapsed, "Exited");
     else if ((signum = flux_subprocess_signaled (p)) > 0) { // signaled
         rc = signum + 128;
-        log_command (r->h, entry, rc, elapsed, strsignal (signum));
+        log_command (r->h, entry, cmd, rc, elapsed, strsignal (signum));
     }
     else { // ???
         rc = 1;
-        log_command (r->h, entry, rc, elapsed, "???");
+        log_command (r->h, entry, cmd, rc, elapsed, "???");
     }
     if (rc != 0 && entry->exit_code == 0) // capture first exit error
         entry->exit_code = rc;
-    runat_command_destroy (zlist_pop (entry->commands));
-    start_next_command (r, entry);
+    zlist_remove (entry->running, cmd);
+    runat_command_destroy (cmd);
+    if (zlist_size (entry->running) == 0)
+        start_next_command (r, entry);
 }
 
 /* If state changes to running and the abort flag is set, send abort_signal.
@@ -178,7 +188,8 @@ static void stdio_cb (flux_subprocess_t *p, const char *stream)
 {
     struct runat *r = flux_subprocess_aux_get (p, "runat");
     struct runat_entry *entry = flux_subprocess_aux_get (p, "runat_entry");
-    int index = entry->count - zlist_size (entry->commands);
+    struct runat_command *cmd = flux_subprocess_aux_get (p, "runat_command");
+    int index = cmd->index;
     const char *line;
     int len;
 
@@ -214,6 +225,8 @@ static flux_subprocess_t *start_command (struct runat *r,
         goto error;
     if (flux_subprocess_aux_set (p, "runat", r, NULL) < 0)
         goto error;
+    if (flux_subprocess_aux_set (p, "runat_command", cmd, NULL) < 0)
+        goto error;
     monotime (&cmd->t_start);
     return p;
 error:
@@ -221,31 +234,54 @@ error:
     return NULL;
 }
 
-/* Start the next command.
- * If startup fails, try the next, and so on.
+/* Start the command at the head of the list and, if it is tagged with a
+ * nonzero group, any immediately following commands in the same group.
+ * If startup fails, the failure is logged and counted, and the next
+ * command is considered.
+ */
+static void start_next_group (struct runat *r, struct runat_entry *entry)
+{
+    struct runat_command *cmd;
+    int group = 0;
+
+    while ((cmd = zlist_head (entry->commands))) {
+        if (group != 0 && cmd->group != group)
+            break;
+        group = cmd->group;
+        (void)zlist_pop (entry->commands);
+        cmd->index = entry->next_index++;
+        if (!(cmd->p = start_command (r, entry, cmd))) {
+            log_command (r->h, entry, cmd, 1, 0, "error starting command");
+            if (entry->exit_code == 0)
+                entry->exit_code = 1;
+            runat_command_destroy (cmd);
+        }
+        else {
+            if (zlist_append (entry->running, cmd) < 0)
+                flux_log (r->h, LOG_ERR, "%s: out of memory", entry->name);
+            if (group == 0)
+                break;
+        }
+    }
+}
+
+/* Start the next command (or group of commands).
  */
 static void start_next_command (struct runat *r, struct runat_entry *entry)
 {
     struct runat_command *cmd;
-    bool started = false;
 
     if (entry->aborted) {
         while ((cmd = zlist_pop (entry->commands)))
             runat_command_destroy (cmd);
     }
     else {
-        while (!started && (cmd = zlist_head (entry->commands))) {
-            if (!(cmd->p = start_command (r, entry, cmd))) {
-                log_command (r->h, entry, 1, 0, "error starting command");
-                if (entry->exit_code == 0)
-                    entry->exit_code = 1;
-                runat_command_destroy (zlist_pop (entry->commands));
-            }
-            else
-                started = true;
-        }
+        while (zlist_size (entry->running) == 0
+            && zlist_size (entry->commands) > 0)
+            start_next_group (r, entry);
     }
-    if (zlist_size (entry->commands) == 0) {
+    if (zlist_size (entry->commands) == 0
+        && zlist_size (entry->running) == 0) {
         entry->completed = true;
         if (entry->cb)
             entry->cb (r, entry->name, entry->cb_arg);
@@ -335,6 +371,12 @@ static void runat_entry_destroy (struct runat_entry *entry)
                 runat_command_destroy (cmd);
             zlist_destroy (&entry->commands);
         }
+        if (entry->running) {
+            struct runat_command *cmd;
+            while ((cmd = zlist_pop (entry->running)))
+                runat_command_destroy (cmd);
+            zlist_destroy (&entry->running);
+        }
         free (entry->name);
         free (entry);
         errno = saved_errno;
@@ -351,6 +393,8 @@ static struct runat_entry *runat_entry_create (const char *name)
         goto error;
     if (!(entry->commands = zlist_new ()))
         goto error;
+    if (!(entry->running = zlist_new ()))
+        goto error;
     return entry;
 error:
     runat_entry_destroy (entry);
@@ -391,19 +435,21 @@ static int runat_push (struct runat *r,
     return 0;
 }
 
-int runat_push_shell_command (struct runat *r,
-                              const char *name,
-                              const char *cmdline,
-                              bool log_stdio)
+int runat_push_shell_command_group (struct runat *r,
+                                    const char *name,
+                                    const char *cmdline,
+                                    bool log_stdio,
+                                    int group)
 {
     struct runat_command *cmd;
 
-    if (!r || !name || !cmdline) {
+    if (!r || !name || !cmdline || group < 0) {
         errno = EINVAL;
         return -1;
     }
     if (!(cmd = runat_command_create (environ, log_stdio)))
         return -1;
+    cmd->group = group;
     if (runat_command_set_cmdline (cmd, cmdline) < 0)
         goto error;
     if (runat_command_modenv (cmd, env_blocklist, r->local_uri) < 0)
@@ -416,6 +462,14 @@ error:
     return -1;
 }
 
+int runat_push_shell_command (struct runat *r,
+                              const char *name,
+                              const char *cmdline,
+                              bool log_stdio)
+{
+    return runat_push_shell_command_group (r, name, cmdline, log_stdio, 0);
+}
+
 int runat_push_shell (struct runat *r, const char *name)
 {
     struct runat_command *cmd;
@@ -530,11 +584,15 @@ int runat_abort (struct runat *r, const char *name)
         errno = ENOENT;
         return -1;
     }
-    if ((cmd = zlist_head (entry->commands)) && cmd->p != NULL) {
-        flux_future_t *f;
-        if (!(f = flux_subprocess_kill (cmd->p, abort_signal)))
-            flux_log_error (r->h, "%s: error aborting", entry->name);
-        flux_future_destroy (f);
+    cmd = zlist_first (entry->running);
+    while (cmd) {
+        if (cmd->p != NULL) {
+            flux_future_t *f;
+            if (!(f = flux_subprocess_kill (cmd->p, abort_signal)))
+                flux_log_error (r->h, "%s: error aborting", entry->name);
+            flux_future_destroy (f);
+        }
+        cmd = zlist_next (entry->running);
     }
     entry->aborted = true;
     return 0;
@@ -566,13 +624,27 @@ static void runat_push_cb (flux_t *h,
         goto error;
     }
     json_array_foreach (commands, index, el) {
-        const char *cmdline = json_string_value (el);
+        const char *cmdline;
+        int group = 0;
+
+        /* Each element is either a command line string, or an object
+         * with a command line and a concurrency group tag.
+         */
+        if (json_is_string (el))
+            cmdline = json_string_value (el);
+        else if (json_unpack (el, "{s:s s?:i}",
+                                  "cmdline", &cmdline,
+                                  "group", &group) < 0 || group < 0) {
+            errno = EPROTO;
+            errstr = "malformed command entry";
+            goto error;
+        }
         if (!cmdline || strlen (cmdline) == 0) {
             errno = EPROTO;
             errstr = "cannot push an empty command line";
             goto error;
         }
-        if (runat_push_shell_command (r, name, cmdline, true) < 0)
+        if (runat_push_shell_command_group (r, name, cmdline, true, group) < 0)
             goto error;
     }
     if (flux_respond (h, msg, NULL) < 0)
@@ -9,6 +9,8 @@
 \************************************************************/
 
 /* Execute list of commands, sequentially, by name.
+ * Adjacent commands tagged with the same nonzero group run concurrently;
+ * the list advances once all commands in the group have completed.
  */
 
 #ifndef _BROKER_RUNAT_H
@@ -31,6 +33,14 @@ int runat_push_shell_command (struct runat *r,
                               const char *cmdline,
                               bool log_stdio);
 
+/* Same, tagged with a concurrency group (0 = run sequentially).
+ */
+int runat_push_shell_command_group (struct runat *r,
+                                    const char *name,
+                                    const char *cmdline,
+                                    bool log_stdio,
+                                    int group);
+
 /* Push interactive shell onto named list.
  */
 int runat_push_shell (struct runat *r, const char *name);
@@ -24,8 +24,26 @@ struct service {
     char *uuid;
 };
 
+/* Route cache:  a small direct-mapped cache of recent name lookups so
+ * that repeated RPCs to the same service skip substring extraction and
+ * hash resolution.  Entries are validated against a switch-wide
+ * generation count that is bumped on every service add/remove, which
+ * invalidates the whole cache in O(1).
+ */
+#define ROUTE_CACHE_SIZE        64      /* must be a power of 2 */
+#define ROUTE_CACHE_NAME_MAX    32
+
+struct route_cache_entry {
+    char name[ROUTE_CACHE_NAME_MAX];
+    int length;
+    struct service *svc;
+    uint32_t generation;
+};
+
 struct service_switch {
     zhash_t *services;
+    uint32_t generation;
+    struct route_cache_entry cache[ROUTE_CACHE_SIZE];
 };
 
 struct service_switch *service_switch_create (void)
@@ -37,6 +55,7 @@ struct service_switch *service_switch_create (void)
         errno = ENOMEM;
         goto error;
     }
+    sw->generation = 1; /* zeroed cache entries never match */
     return sw;
 error:
     service_switch_destroy (sw);
@@ -78,6 +97,7 @@ error:
 void service_remove (struct service_switch *sw, const char *name)
 {
     zhash_delete (sw->services, name);
+    sw->generation++;
 }
 
 const char *service_get_uuid (struct service_switch *sw, const char *name)
@@ -138,6 +158,7 @@ void service_remove_byuuid (struct service_switch *sw, const char *uuid)
         while ((key = zlist_pop (trash)))
             zhash_delete (sw->services, key);
         zlist_destroy (&trash);
+        sw->generation++;
     }
 }
 
@@ -162,6 +183,7 @@ int service_add (struct service_switch *sh, const char *name,
         goto error;
     }
     zhash_freefn (sh->services, name, (zhash_free_fn *)service_destroy);
+    sh->generation++;
     return 0;
 error:
     service_destroy (svc);
@@ -178,6 +200,22 @@ static struct service *service_lookup_subtopic (struct service_switch *sw,
     char *cpy = NULL;
     char *service;
     struct service *svc = NULL;
+    struct route_cache_entry *rc = NULL;
+
+    /* Consult the route cache first (djb2 hash of the prefix).
+     */
+    if (length < ROUTE_CACHE_NAME_MAX) {
+        uint32_t hash = 5381;
+        int i;
+        for (i = 0; i < length; i++)
+            hash = (hash << 5) + hash + (uint8_t)topic[i];
+        rc = &sw->cache[hash & (ROUTE_CACHE_SIZE - 1)];
+        if (rc->generation == sw->generation
+                && rc->length == length
+                && rc->svc != NULL
+                && memcmp (rc->name, topic, length) == 0)
+            return rc->svc;
+    }
 
     if (length < sizeof (buf))
         service = buf;
@@ -193,6 +231,12 @@ static struct service *service_lookup_subtopic (struct service_switch *sw,
         errno = ENOSYS;
         goto done;
     }
+    if (rc) {
+        memcpy (rc->name, topic, length);
+        rc->length = length;
+        rc->svc = svc;
+        rc->generation = sw->generation;
+    }
 done:
     free (cpy);
     return svc;
@@ -200,15 +244,16 @@ done:
 
 /* Look up a service by first "word" of topic string.
  * If found, call the service's callback and return its return value.
+ * The callback may take ownership of '*msg' (see service.h).
  * If not found, return -1 with errno set (usually ENOSYS).
  */
-int service_send (struct service_switch *sw, const flux_msg_t *msg)
+int service_send (struct service_switch *sw, flux_msg_t **msg)
 {
     const char *topic, *p;
     int length;
     struct service *svc;
 
-    if (flux_msg_get_topic (msg, &topic) < 0)
+    if (flux_msg_get_topic (*msg, &topic) < 0)
         return -1;
     if ((p = strchr (topic, '.')))
         length = p - topic;
@@ -13,7 +13,12 @@
 
 #include <jansson.h>
 
-typedef int (*service_send_f)(const flux_msg_t *msg, void *arg);
+/* Service callback.  The callback may take ownership of '*msg' by setting
+ * it to NULL, avoiding a copy when the message is relayed to a co-resident
+ * endpoint.  On failure (nonzero return), ownership must remain with the
+ * caller so it can generate an error response.
+ */
+typedef int (*service_send_f)(flux_msg_t **msg, void *arg);
 
 struct service_switch *service_switch_create (void);
 void service_switch_destroy (struct service_switch *sw);
@@ -25,7 +30,7 @@ void service_remove (struct service_switch *sw, const char *name);
 
 void service_remove_byuuid (struct service_switch *sw, const char *uuid);
 
-int service_send (struct service_switch *sw, const flux_msg_t *msg);
+int service_send (struct service_switch *sw, flux_msg_t **msg);
 
 /* Return the UUID currently registered for service `name` */
 const char *service_get_uuid (struct service_switch *sw, const char *name);
@@ -15,6 +15,7 @@
 #include <czmq.h>
 
 #include "src/common/libutil/log.h"
+#include "src/common/libutil/monotime.h"
 
 #include "state_machine.h"
 
@@ -28,6 +29,7 @@ struct state_machine {
     broker_state_t state;
 
     zlist_t *events;
+    struct timespec t_entered;
     flux_watcher_t *prep;
     flux_watcher_t *check;
     flux_watcher_t *idle;
@@ -163,11 +165,16 @@ static void process_event (struct state_machine *s, const char *event)
     next_state = state_next (s->state, event);
 
     if (next_state != s->state) {
+        /* Log time spent in the state being left so each phase of
+         * startup/shutdown is visible in the log.
+         */
         flux_log (s->ctx->h,
-                  LOG_INFO, "%s: %s->%s",
+                  LOG_INFO, "%s: %s->%s (%.1fms)",
                   event,
                   statestr (s->state),
-                  statestr (next_state));
+                  statestr (next_state),
+                  monotime_since (s->t_entered));
+        monotime (&s->t_entered);
         s->state = next_state;
         state_action (s, s->state);
     }
@@ -299,6 +306,7 @@ struct state_machine *state_machine_create (struct broker *ctx)
         return NULL;
     s->ctx = ctx;
     s->state = STATE_NONE;
+    monotime (&s->t_entered);
     if (!(s->events = zlist_new ()))
         goto nomem;
     zlist_autofree (s->events);
@@ -216,6 +216,29 @@ void basic (flux_t *h)
         "process termination was logged");
     rc = -1;
 
+    /* run false+true concurrently in one group */
+    clear_list (logs);
+    ok (runat_push_shell_command_group (r, "test8", "/bin/true", false, 1) == 0
+        && runat_push_shell_command_group (r,
+                                           "test8",
+                                           "/bin/false",
+                                           false,
+                                           1) == 0,
+        "pushed group of true and false");
+    ok (runat_start (r, "test8", test_completion, &ctx) == 0,
+        "runat_start works");
+    completion_called = 0;
+    ok (flux_reactor_run (flux_get_reactor (h), 0) >= 0
+        && completion_called == 1,
+        "completion called once");
+    rc = -1;
+    ok (runat_get_exit_code (r, "test8", &rc) == 0 && rc == 1,
+        "exit code is 1");
+    ok (match_list (logs, "Exited") == 2,
+        "Both commands' exit status were logged");
+    ok (runat_is_completed (r, "test8") == true,
+        "runat_is_completed returns true");
+
     runat_destroy (r);
 }
 
@@ -305,6 +328,10 @@ void badinput (flux_t *h)
     errno = 0;
     ok (runat_push_shell_command (r, "foo", NULL, false) < 0 && errno == EINVAL,
         "runat_push_shell_command cmdline=NULL fails with EINVAL");
+    errno = 0;
+    ok (runat_push_shell_command_group (r, "foo", "a", false, -1) < 0
+        && errno == EINVAL,
+        "runat_push_shell_command_group group=-1 fails with EINVAL");
 
     errno = 0;
     ok (runat_push_command (NULL, "a", "a", 1, false) < 0 && errno == EINVAL,
@@ -11,6 +11,7 @@
 #include <flux/core.h>
 #include <czmq.h>
 #include <stdio.h>
+#include <stdbool.h>
 
 #include <flux/core.h>
 
@@ -23,13 +24,18 @@ void *foo_cb_arg;
 int foo_cb_called;
 int foo_cb_rc;
 int foo_cb_errno;
+bool foo_cb_take;
 
-static int foo_cb (const flux_msg_t *msg, void *arg)
+static int foo_cb (flux_msg_t **msg, void *arg)
 {
-    foo_cb_msg = msg;
+    foo_cb_msg = *msg;
     foo_cb_arg = arg;
     foo_cb_called++;
 
+    if (foo_cb_take) {
+        flux_msg_destroy (*msg);
+        *msg = NULL;
+    }
     if (foo_cb_rc != 0)
         errno = foo_cb_errno;
 
@@ -52,7 +58,7 @@ int main (int argc, char **argv)
     if (!msg)
         BAIL_OUT ("flux_request_encode: %s", flux_strerror (errno));
     errno = 0;
-    ok (service_send (sw, msg) < 0 && errno == ENOSYS,
+    ok (service_send (sw, &msg) < 0 && errno == ENOSYS,
         "service_send to 'foo' fails with ENOSYS");
 
     ok (service_add (sw, "foo", NULL, foo_cb, NULL) == 0,
@@ -62,7 +68,7 @@ int main (int argc, char **argv)
     foo_cb_arg = (void *)(uintptr_t)1;
     foo_cb_called = 0;
     foo_cb_rc = 0;
-    ok (service_send (sw, msg) == 0,
+    ok (service_send (sw, &msg) == 0,
         "service_send to 'foo' works");
     ok (foo_cb_called == 1 && foo_cb_arg == NULL && foo_cb_msg == msg,
         "and callback was called with expected arguments");
@@ -70,12 +76,12 @@ int main (int argc, char **argv)
     foo_cb_rc = 42;
     foo_cb_errno = ENXIO;
     errno = 0;
-    ok (service_send (sw, msg) == 42 && errno == ENXIO,
+    ok (service_send (sw, &msg) == 42 && errno == ENXIO,
         "service_send returns callback's return code and preserves errno");
 
     service_remove (sw, "foo");
     errno = 0;
-    ok (service_send (sw, msg) < 0 && errno == ENOSYS,
+    ok (service_send (sw, &msg) < 0 && errno == ENOSYS,
         "service_remove works");
 
     flux_msg_destroy (msg);
@@ -87,7 +93,7 @@ int main (int argc, char **argv)
     ok (service_add (sw, "bar", NULL, foo_cb, NULL) == 0,
         "service_add bar works");
     foo_cb_rc = 0;
-    ok (service_send (sw, msg) == 0,
+    ok (service_send (sw, &msg) == 0,
         "service_send to 'bar.baz' works");
     flux_msg_destroy (msg);
 
@@ -113,11 +119,11 @@ int main (int argc, char **argv)
 
     foo_cb_rc = 0;
     foo_cb_called = 0;
-    ok (service_send (sw, msg) == 0 && foo_cb_called == 1,
+    ok (service_send (sw, &msg) == 0 && foo_cb_called == 1,
         "service_send matched long service name");
-    ok (service_send (sw, msg2) == 0 && foo_cb_called == 2,
+    ok (service_send (sw, &msg2) == 0 && foo_cb_called == 2,
         "service_send matched first alternate name");
-    ok (service_send (sw, msg3) == 0 && foo_cb_called == 3,
+    ok (service_send (sw, &msg3) == 0 && foo_cb_called == 3,
         "service_send matched second alternate name");
 
     service_remove_byuuid (sw, "fakeuuid");
@@ -125,19 +131,28 @@ int main (int argc, char **argv)
     foo_cb_rc = 0;
     foo_cb_called = 0;
     errno = 0;
-    ok (service_send (sw, msg) < 0 && errno == ENOSYS && foo_cb_called == 0,
+    ok (service_send (sw, &msg) < 0 && errno == ENOSYS && foo_cb_called == 0,
         "service_send to long service name fails after remove_byuuid");
     errno = 0;
-    ok (service_send (sw, msg2) < 0 && errno == ENOSYS && foo_cb_called == 0,
+    ok (service_send (sw, &msg2) < 0 && errno == ENOSYS && foo_cb_called == 0,
         "service_send to first alternate name fails after remove_byuuid");
     errno = 0;
-    ok (service_send (sw, msg3) < 0  && errno == ENOSYS && foo_cb_called == 0,
+    ok (service_send (sw, &msg3) < 0  && errno == ENOSYS && foo_cb_called == 0,
         "service_send to second alternate name fails after remove_byuuid");
 
     flux_msg_destroy (msg);
     flux_msg_destroy (msg2);
     flux_msg_destroy (msg3);
 
+    msg = flux_request_encode ("bar.take", NULL);
+    if (!msg)
+        BAIL_OUT ("flux_request_encode: %s", flux_strerror (errno));
+    foo_cb_rc = 0;
+    foo_cb_take = true;
+    ok (service_send (sw, &msg) == 0 && msg == NULL,
+        "service_send callback may take ownership of the message");
+    foo_cb_take = false;
+
     service_switch_destroy (sw);
 
     done_testing ();
@@ -11,6 +11,8 @@
 #include "builtin.h"
 
 #include <unistd.h>
+#include <limits.h>
+#include <jansson.h>
 
 #include "src/common/libutil/blobref.h"
 #include "src/common/libutil/read_all.h"
@@ -116,6 +118,65 @@ static int internal_content_dropcache (optparse_t *p, int ac, char *av[])
     return (0);
 }
 
+/* The export/import work happens in the rank 0 backing store module,
+ * which reads/writes the archive file directly so migration runs at
+ * disk bandwidth.  We just hand it an absolute path and report totals.
+ * N.B. the module's working directory is the broker's, so a relative
+ * PATH must be qualified here.
+ */
+static int content_migrate (optparse_t *p,
+                            int ac,
+                            char *av[],
+                            const char *topic)
+{
+    int n;
+    flux_t *h;
+    flux_future_t *f;
+    const char *path;
+    char *fqpath = NULL;
+    int count;
+    json_int_t bytes;
+
+    n = optparse_option_index (p);
+    if (n != ac - 1) {
+        optparse_print_usage (p);
+        exit (1);
+    }
+    path = av[n];
+    if (path[0] != '/') {
+        char cwd[PATH_MAX];
+        if (!getcwd (cwd, sizeof (cwd)))
+            log_err_exit ("getcwd");
+        if (asprintf (&fqpath, "%s/%s", cwd, path) < 0)
+            log_err_exit ("asprintf");
+        path = fqpath;
+    }
+    if (!(h = builtin_get_flux_handle (p)))
+        log_err_exit ("flux_open");
+    if (!(f = flux_rpc_pack (h, topic, 0, 0, "{s:s}", "path", path)))
+        log_err_exit ("%s", topic);
+    if (flux_rpc_get_unpack (f,
+                             "{s:i s:I}",
+                             "count", &count,
+                             "bytes", &bytes) < 0)
+        log_msg_exit ("%s: %s", topic, future_strerror (f, errno));
+    printf ("%d blobs (%ju bytes)\n", count, (uintmax_t)bytes);
+    flux_future_destroy (f);
+    flux_close (h);
+    free (fqpath);
+    return (0);
+}
+
+static int internal_content_export (optparse_t *p, int ac, char *av[])
+{
+    return content_migrate (p, ac, av, "content-backing.export");
+}
+
+static int internal_content_import (optparse_t *p, int ac, char *av[])
+{
+    return content_migrate (p, ac, av, "content-backing.import");
+}
+
 static int spam_max_inflight;
 static int spam_cur_inflight;
 
@@ -221,6 +282,20 @@ static struct optparse_subcommand content_subcmds[] = {
       0,
       NULL,
     },
+    { "export",
+      "PATH",
+      "Dump all blobs from the backing store to an archive at PATH",
+      internal_content_export,
+      0,
+      NULL,
+    },
+    { "import",
+      "PATH",
+      "Load all blobs from the archive at PATH into the backing store",
+      internal_content_import,
+      0,
+      NULL,
+    },
     { "spam",
       "N [M]",
       "Store N random entries, keeping M requests in flight (default 1)",
@@ -16,11 +16,15 @@
 #include <sys/types.h>
 #include <sys/param.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
 #include <sys/un.h>
+#include <sys/wait.h>
+#include <fcntl.h>
 #include <stdio.h>
 #include <assert.h>
 #include <stdlib.h>
 #include <string.h>
+#include <signal.h>
 #include <errno.h>
 #include <libgen.h>
 #include <stdbool.h>
@@ -29,6 +33,7 @@
 #include <czmq.h>
 #include <inttypes.h>
 
+#include "src/common/libutil/blobref.h"
 #include "src/common/libutil/cleanup.h"
 #include "src/common/librouter/usock.h"
 #include "src/common/librouter/router.h"
@@ -45,6 +50,198 @@ struct proxy_command {
 
 static const char *route_auxkey = "flux::route";
 
+/*  Construct the deterministic rendezvous socket path for 'uri' in a
+ *   per-user directory, creating the directory if 'create' is true.
+ *   The file name is a content hash of the target URI so that repeat
+ *   invocations for the same URI find the same daemon.
+ */
+static int proxy_sockpath (char *buf, int size, const char *uri, bool create)
+{
+    const char *tmpdir = getenv ("TMPDIR");
+    char hash[BLOBREF_MAX_STRING_SIZE];
+    char dir[PATH_MAX + 1];
+    struct stat sb;
+    int n;
+
+    if (blobref_hash ("sha1", uri, strlen (uri), hash, sizeof (hash)) < 0)
+        return -1;
+    n = snprintf (dir, sizeof (dir), "%s/flux-proxy-%u",
+                  tmpdir ? tmpdir : "/tmp",
+                  (unsigned int)getuid ());
+    if (n >= sizeof (dir)) {
+        errno = EOVERFLOW;
+        return -1;
+    }
+    if (create && mkdir (dir, 0700) < 0 && errno != EEXIST)
+        return -1;
+    if (lstat (dir, &sb) < 0)
+        return -1;
+    /*  Refuse to rendezvous through a directory that could have been
+     *   planted or modified by another user.
+     */
+    if (!S_ISDIR (sb.st_mode)
+        || sb.st_uid != getuid ()
+        || (sb.st_mode & (S_IWGRP | S_IWOTH))) {
+        errno = EPERM;
+        return -1;
+    }
+    n = snprintf (buf, size, "%s/%s", dir, hash);
+    if (n >= size) {
+        errno = EOVERFLOW;
+        return -1;
+    }
+    return 0;
+}
+
+/*  Test whether a proxy daemon is accepting connections on 'sockpath'.
+ */
+static bool proxy_daemon_alive (const char *sockpath)
+{
+    char uri[PATH_MAX + 16];
+    flux_t *h;
+
+    if (snprintf (uri, sizeof (uri), "local://%s", sockpath)
+                                                >= sizeof (uri))
+        return false;
+    if (!(h = flux_open (uri, 0)))
+        return false;
+    flux_close (h);
+    return true;
+}
+
+/*  Run COMMAND (or an interactive shell) directly against a running
+ *   proxy daemon's socket.  No upstream dial, no router - the daemon
+ *   already holds the authenticated connection.  Does not return on
+ *   success.
+ */
+static void exec_command (int ac, char **av, const char *sockpath)
+{
+    const char *shell = getenv ("SHELL");
+    char uri[PATH_MAX + 16];
+    char *argz = NULL;
+    size_t argz_len = 0;
+    char *argv[4];
+    int n = 0;
+    int i;
+
+    if (!shell)
+        shell = "/bin/sh";
+    if (snprintf (uri, sizeof (uri), "local://%s", sockpath)
+                                                >= sizeof (uri))
+        log_msg_exit ("socket path too long");
+    if (setenv ("FLUX_URI", uri, 1) < 0)
+        log_err_exit ("setenv");
+
+    argv[n++] = (char *)shell;
+    if (ac > 0) {
+        for (i = 0; i < ac; i++) {
+            if (argz_add (&argz, &argz_len, av[i]) != 0)
+                log_msg_exit ("argz_add: Out of memory");
+        }
+        argz_stringify (argz, argz_len, ' ');
+        argv[n++] = "-c";
+        argv[n++] = argz;
+    }
+    argv[n] = NULL;
+    execvp (shell, argv);
+    log_err_exit ("exec %s", shell);
+}
+
+/*  Fork twice so the proxy daemon is reparented to init, then block
+ *   in the original process until the daemon signals readiness (or
+ *   failure) over a pipe.  Returns the pipe's write end in the
+ *   grandchild, which continues into server setup; all other
+ *   processes exit here.
+ */
+static int proxy_daemonize (const char *uri)
+{
+    pid_t pid;
+    int pfds[2];
+    int result = 0;
+    ssize_t n;
+
+    if (pipe (pfds) < 0)
+        log_err_exit ("pipe");
+    if ((pid = fork ()) < 0)
+        log_err_exit ("fork");
+    if (pid == 0) {
+        close (pfds[0]);
+        setsid ();
+        if ((pid = fork ()) < 0)
+            log_err_exit ("fork");
+        if (pid == 0)
+            return pfds[1];
+        exit (0);
+    }
+    (void)waitpid (pid, NULL, 0);
+    close (pfds[1]);
+    n = read (pfds[0], &result, sizeof (int));
+    close (pfds[0]);
+    if (n < (ssize_t)sizeof (int))
+        log_msg_exit ("proxy daemon startup failed");
+    if (result != 0) {
+        errno = result;
+        log_err_exit ("proxy daemon for %s", uri);
+    }
+    log_msg ("proxy daemon started for %s", uri);
+    exit (0);
+}
+
+/*  Stop the reactor so the daemon exits through the normal cleanup
+ *   path (removing its socket and pidfile) on SIGTERM.
+ */
+static void daemon_signal_cb (flux_reactor_t *r,
+                              flux_watcher_t *w,
+                              int revents,
+                              void *arg)
+{
+    flux_reactor_stop (r);
+}
+
+/*  Terminate the proxy daemon for 'uri', located via its pidfile.
+ */
+static void proxy_daemon_stop (const char *uri)
+{
+    char sockpath[PATH_MAX + 1];
+    char pidpath[PATH_MAX + 8];
+    FILE *fp;
+    int pid = -1;
+
+    if (proxy_sockpath (sockpath, sizeof (sockpath), uri, false) < 0
+        || snprintf (pidpath, sizeof (pidpath), "%s.pid", sockpath)
+                                               >= sizeof (pidpath)
+        || !(fp = fopen (pidpath, "r")))
+        log_msg_exit ("no proxy daemon found for %s", uri);
+    if (fscanf (fp, "%d", &pid) != 1 || pid <= 0) {
+        fclose (fp);
+        log_msg_exit ("error reading %s", pidpath);
+    }
+    fclose (fp);
+    if (kill ((pid_t)pid, SIGTERM) < 0)
+        log_err_exit ("kill %d", pid);
+}
+
+/*  Daemon is listening: signal readiness to the waiting parent and
+ *   detach from the controlling terminal's stdio.
+ */
+static void proxy_daemon_ready (int ready_fd)
+{
+    int result = 0;
+    int fd;
+
+    if (write (ready_fd, &result, sizeof (int)) < 0)
+        log_err ("write");
+    close (ready_fd);
+
+    if ((fd = open ("/dev/null", O_RDWR)) >= 0) {
+        (void)dup2 (fd, STDIN_FILENO);
+        (void)dup2 (fd, STDOUT_FILENO);
+        (void)dup2 (fd, STDERR_FILENO);
+        if (fd > 2)
+            close (fd);
+    }
+}
+
 static void completion_cb (flux_subprocess_t *p)
 {
     struct proxy_command *ctx = flux_subprocess_aux_get (p, "ctx");
@@ -232,6 +429,9 @@ static int cmd_proxy (optparse_t *p, int ac, char *av[])
     const char *uri;
     int optindex;
     flux_reactor_t *r;
+    flux_watcher_t *sigw = NULL;
+    bool daemonize;
+    int ready_fd = -1;
 
     log_init ("flux-proxy");
 
@@ -239,6 +439,39 @@ static int cmd_proxy (optparse_t *p, int ac, char *av[])
     if (optindex == ac)
         optparse_fatal_usage (p, 1, "URI argument is required\n");
     uri = av[optindex++];
+    daemonize = optparse_hasopt (p, "daemon");
+
+    if (optparse_hasopt (p, "stop")) {
+        if (daemonize || optindex < ac)
+            optparse_fatal_usage (p, 1, "--stop takes only a URI argument\n");
+        proxy_daemon_stop (uri);
+        return (0);
+    }
+
+    if (daemonize) {
+        if (optindex < ac)
+            optparse_fatal_usage (p, 1, "COMMAND is not accepted "
+                                        "with --daemon\n");
+        if (proxy_sockpath (sockpath, sizeof (sockpath), uri, true) < 0)
+            log_err_exit ("cannot construct proxy socket path");
+        if (proxy_daemon_alive (sockpath)) {
+            log_msg ("proxy daemon already running for %s", uri);
+            return (0);
+        }
+        /*  Only the daemon-to-be returns from here; the caller's
+         *   process blocks until readiness, reports, and exits.
+         */
+        ready_fd = proxy_daemonize (uri);
+    }
+    else {
+        /*  If a proxy daemon for this URI is accepting connections,
+         *   run COMMAND against its socket: no new upstream dial or
+         *   handshake.  Does not return.
+         */
+        if (proxy_sockpath (sockpath, sizeof (sockpath), uri, false) == 0
+            && proxy_daemon_alive (sockpath))
+            exec_command (ac - optindex, av + optindex, sockpath);
+    }
 
     memset (&ctx, 0, sizeof (ctx));
     if (!(ctx.h = flux_open (uri, 0)))
@@ -255,17 +488,20 @@ static int cmd_proxy (optparse_t *p, int ac, char *av[])
     if (!(ctx.router = router_create (ctx.h)))
         log_err_exit ("router_create");
 
-    /* Create socket directory.
+    /* Create socket directory, unless in daemon mode, where the
+     * rendezvous socket path was determined above.
      */
-    n = snprintf (workpath, sizeof (workpath), "%s/flux-proxy-XXXXXX",
-                             tmpdir ? tmpdir : "/tmp");
-    assert (n < sizeof (workpath));
-    if (!mkdtemp (workpath))
-        log_err_exit ("error creating proxy socket directory");
-    cleanup_push_string(cleanup_directory, workpath);
-
-    n = snprintf (sockpath, sizeof (sockpath), "%s/local", workpath);
-    assert (n < sizeof (sockpath));
+    if (!daemonize) {
+        n = snprintf (workpath, sizeof (workpath), "%s/flux-proxy-XXXXXX",
+                                 tmpdir ? tmpdir : "/tmp");
+        assert (n < sizeof (workpath));
+        if (!mkdtemp (workpath))
+            log_err_exit ("error creating proxy socket directory");
+        cleanup_push_string(cleanup_directory, workpath);
+
+        n = snprintf (sockpath, sizeof (sockpath), "%s/local", workpath);
+        assert (n < sizeof (sockpath));
+    }
 
     /* Create listen socket and watcher to handle new connections
      */
@@ -274,10 +510,34 @@ static int cmd_proxy (optparse_t *p, int ac, char *av[])
     cleanup_push_string (cleanup_file, sockpath);
     usock_server_set_acceptor (ctx.server, acceptor_cb, &ctx);
 
-    /* Create child
+    /* Create child, or in daemon mode write the pidfile, signal
+     * readiness, and serve until terminated.
      */
-    if (child_create (&ctx, ac - optindex, av + optindex, sockpath) < 0)
-        log_err_exit ("child_create");
+    if (!daemonize) {
+        if (child_create (&ctx, ac - optindex, av + optindex, sockpath) < 0)
+            log_err_exit ("child_create");
+    }
+    else {
+        char pidpath[PATH_MAX + 8];
+        FILE *fp;
+
+        n = snprintf (pidpath, sizeof (pidpath), "%s.pid", sockpath);
+        assert (n < sizeof (pidpath));
+        if (!(fp = fopen (pidpath, "w"))
+            || fprintf (fp, "%d\n", (int)getpid ()) < 0
+            || fclose (fp) != 0)
+            log_err_exit ("error writing %s", pidpath);
+        cleanup_push_string (cleanup_file, pidpath);
+
+        if (!(sigw = flux_signal_watcher_create (r,
+                                                 SIGTERM,
+                                                 daemon_signal_cb,
+                                                 NULL)))
+            log_err_exit ("flux_signal_watcher_create");
+        flux_watcher_start (sigw);
+
+        proxy_daemon_ready (ready_fd);
+    }
 
     /* Start reactor
      */
@@ -286,6 +546,7 @@ static int cmd_proxy (optparse_t *p, int ac, char *av[])
         goto done;
     }
 done:
+    flux_watcher_destroy (sigw);
     usock_server_destroy (ctx.server); // destroy before router
     router_destroy (ctx.router);
 
@@ -296,6 +557,16 @@ done:
     return (0);
 }
 
+static struct optparse_option proxy_opts[] = {
+    { .name = "daemon",  .key = 'd',  .has_arg = 0,
+      .usage = "Start a persistent proxy daemon for URI and return. "
+               "Later invocations for the same URI reuse its connection "
+               "instead of dialing and authenticating per command.", },
+    { .name = "stop",  .has_arg = 0,
+      .usage = "Terminate the proxy daemon for URI.", },
+    OPTPARSE_TABLE_END,
+};
+
 int subcommand_proxy_register (optparse_t *p)
 {
     optparse_err_t e;
@@ -304,7 +575,7 @@ int subcommand_proxy_register (optparse_t *p)
         "[OPTIONS] URI [COMMAND...]",
         "Route messages to/from Flux instance",
         0,
-        NULL);
+        proxy_opts);
     if (e != OPTPARSE_SUCCESS)
         return (-1);
 
@@ -40,6 +40,7 @@ int cmd_move (optparse_t *p, int argc, char **argv);
 int cmd_dir (optparse_t *p, int argc, char **argv);
 int cmd_ls (optparse_t *p, int argc, char **argv);
 int cmd_getroot (optparse_t *p, int argc, char **argv);
+int cmd_dump (optparse_t *p, int argc, char **argv);
 int cmd_eventlog (optparse_t *p, int argc, char **argv);
 
 static int get_window_width (optparse_t *p, int fd);
@@ -98,6 +99,9 @@ static struct optparse_option get_opts[] =  {
     { .name = "count", .key = 'c', .has_arg = 1, .arginfo = "COUNT",
       .usage = "Display at most COUNT changes",
     },
+    { .name = "stream", .key = 'S', .has_arg = 0,
+      .usage = "Write raw value to stdout chunk by chunk (bounded memory)",
+    },
     OPTPARSE_TABLE_END
 };
 
@@ -123,6 +127,9 @@ static struct optparse_option put_opts[] =  {
     { .name = "append", .key = 'A', .has_arg = 0,
       .usage = "Append value(s) to key instead of overwriting",
     },
+    { .name = "stream", .key = 'S', .has_arg = 0,
+      .usage = "Read raw value from stdin chunk by chunk (bounded memory)",
+    },
     OPTPARSE_TABLE_END
 };
 
@@ -206,6 +213,16 @@ static struct optparse_option getroot_opts[] =  {
     OPTPARSE_TABLE_END
 };
 
+static struct optparse_option dump_opts[] =  {
+    { .name = "namespace", .key = 'N', .has_arg = 1,
+      .usage = "Specify KVS namespace to use.",
+    },
+    { .name = "at", .key = 'a', .has_arg = 1,
+      .usage = "Dump relative to RFC 11 snapshot reference",
+    },
+    OPTPARSE_TABLE_END
+};
+
 static struct optparse_option copy_opts[] =  {
     { .name = "src-namespace", .key = 'S', .has_arg = 1,
       .usage = "Specify source key's namespace",
@@ -261,7 +278,7 @@ static struct optparse_subcommand subcommands[] = {
       NULL,
     },
     { "get",
-      "[-N ns] [-r|-t] [-a treeobj] [-l] [-W] [-w] [-u] [-A] [-f] "
+      "[-N ns] [-r|-t|-S] [-a treeobj] [-l] [-W] [-w] [-u] [-A] [-f] "
         "[-c COUNT] key [key...]",
       "Get value stored under key",
       cmd_get,
@@ -269,7 +286,7 @@ static struct optparse_subcommand subcommands[] = {
       get_opts
     },
     { "put",
-      "[-N ns] [-O|-s] [-r|-t] [-n] [-A] key=value [key=value...]",
+      "[-N ns] [-O|-s] [-r|-t|-S] [-n] [-A] key=value [key=value...]",
       "Store value under key",
       cmd_put,
       0,
@@ -359,6 +376,13 @@ static struct optparse_subcommand subcommands[] = {
       0,
       getroot_opts
     },
+    { "dump",
+      "[-N ns] [-a treeobj]",
+      "Dump a namespace snapshot as a JSON-lines archive",
+      cmd_dump,
+      0,
+      dump_opts
+    },
     { "eventlog",
       NULL,
       "Manipulate a KVS eventlog",
@@ -635,6 +659,169 @@ kv_printf (const char *key, int maxcol, const char *fmt, ...)
     free (kv);
 }
 
+/* Chunking parameters for get/put --stream.  Each chunk is one content
+ * blob referenced from a valref treeobj, and at most 'stream_window'
+ * content RPCs are in flight, so client memory stays bounded by
+ * roughly stream_blobsize * stream_window regardless of value size.
+ */
+static const int stream_blobsize = 1048576;
+static const int stream_window = 16;
+
+/* Read up to 'count' bytes, continuing past short reads (e.g. pipes)
+ * until the buffer is full or EOF.
+ * Returns bytes read, or -1 on error with errno set.
+ */
+static ssize_t read_chunk (int fd, void *buf, size_t count)
+{
+    size_t total = 0;
+    ssize_t n;
+
+    while (total < count) {
+        if ((n = read (fd, (char *)buf + total, count - total)) < 0)
+            return -1;
+        if (n == 0)
+            break;
+        total += n;
+    }
+    return total;
+}
+
+/* Retire the oldest outstanding content.store futures until at most
+ * 'max' remain, appending each returned blobref to 'valref' so chunk
+ * order is preserved.
+ */
+static void put_stream_drain (zlist_t *fs, json_t *valref, int max)
+{
+    flux_future_t *f;
+
+    while ((int)zlist_size (fs) > max && (f = zlist_pop (fs))) {
+        const char *blobref;
+
+        if (flux_content_store_get (f, &blobref) < 0)
+            log_err_exit ("flux_content_store");
+        if (treeobj_append_blobref (valref, blobref) < 0)
+            log_err_exit ("treeobj_append_blobref");
+        flux_future_destroy (f);
+    }
+}
+
+/* Stream stdin into the content store in bounded chunks and add a
+ * valref treeobj referencing them to 'txn'.
+ */
+static void cmd_put_stream (flux_t *h, flux_kvs_txn_t *txn, const char *key)
+{
+    char *buf = xzmalloc (stream_blobsize);
+    json_t *valref;
+    zlist_t *fs;
+    char *s;
+    ssize_t n;
+    int count = 0;
+
+    if (!(valref = treeobj_create_valref (NULL)))
+        log_err_exit ("treeobj_create_valref");
+    if (!(fs = zlist_new ()))
+        log_msg_exit ("zlist_new failed");
+    for (;;) {
+        flux_future_t *f;
+
+        if ((n = read_chunk (STDIN_FILENO, buf, stream_blobsize)) < 0)
+            log_err_exit ("stdin");
+        if (n == 0 && count > 0)
+            break;
+        /* n == 0 with count == 0 stores one empty blob so the valref
+         * is valid for a zero length value */
+        if (!(f = flux_content_store (h, buf, n, 0))
+            || zlist_append (fs, f) < 0)
+            log_err_exit ("flux_content_store");
+        count++;
+        put_stream_drain (fs, valref, stream_window - 1);
+        if (n < stream_blobsize)
+            break;
+    }
+    put_stream_drain (fs, valref, 0);
+    zlist_destroy (&fs);
+    if (!(s = treeobj_encode (valref)))
+        log_err_exit ("treeobj_encode");
+    if (flux_kvs_txn_put_treeobj (txn, 0, key, s) < 0)
+        log_err_exit ("%s", key);
+    free (s);
+    json_decref (valref);
+    free (buf);
+}
+
+/* Stream a value to stdout chunk by chunk.  The key's treeobj is
+ * looked up, then valref chunks are fetched from the content store
+ * with a bounded prefetch window and written out in order.
+ */
+static void cmd_get_stream (flux_t *h,
+                            const char *ns,
+                            optparse_t *p,
+                            const char *key)
+{
+    flux_future_t *f;
+    const char *json_str;
+    json_t *treeobj;
+
+    if (optparse_hasopt (p, "at")) {
+        const char *reference = optparse_get_str (p, "at", NULL);
+        if (!(f = flux_kvs_lookupat (h, FLUX_KVS_TREEOBJ, key, reference)))
+            log_err_exit ("%s", key);
+    }
+    else {
+        if (!(f = flux_kvs_lookup (h, ns, FLUX_KVS_TREEOBJ, key)))
+            log_err_exit ("%s", key);
+    }
+    if (flux_kvs_lookup_get_treeobj (f, &json_str) < 0)
+        log_err_exit ("%s", key);
+    if (!(treeobj = treeobj_decode (json_str)))
+        log_err_exit ("%s", key);
+    if (treeobj_is_val (treeobj)) {
+        void *data;
+        int len;
+
+        if (treeobj_decode_val (treeobj, &data, &len) < 0)
+            log_err_exit ("%s", key);
+        if (write_all (STDOUT_FILENO, data, len) < 0)
+            log_err_exit ("%s", key);
+        free (data);
+    }
+    else if (treeobj_is_valref (treeobj)) {
+        int count = treeobj_get_count (treeobj);
+        zlist_t *fs;
+        int sent = 0;
+        int received = 0;
+
+        if (!(fs = zlist_new ()))
+            log_msg_exit ("zlist_new failed");
+        while (received < count) {
+            flux_future_t *fl;
+            const void *data;
+            int len;
+
+            while (sent < count && (int)zlist_size (fs) < stream_window) {
+                const char *blobref = treeobj_get_blobref (treeobj, sent);
+                if (!blobref
+                    || !(fl = flux_content_load (h, blobref, 0))
+                    || zlist_append (fs, fl) < 0)
+                    log_err_exit ("flux_content_load");
+                sent++;
+            }
+            fl = zlist_pop (fs);
+            if (flux_content_load_get (fl, &data, &len) < 0)
+                log_err_exit ("%s", key);
+            if (write_all (STDOUT_FILENO, data, len) < 0)
+                log_err_exit ("%s", key);
+            flux_future_destroy (fl);
+            received++;
+        }
+        zlist_destroy (&fs);
+    }
+    else
+        log_msg_exit ("%s: not a val or valref", key);
+    json_decref (treeobj);
+    flux_future_destroy (f);
+}
+
 struct lookup_ctx {
     optparse_t *p;
     int maxcount;
@@ -744,6 +931,15 @@ int cmd_get (optparse_t *p, int argc, char **argv)
     ctx.maxcount = optparse_get_int (p, "count", 0);
     ctx.ns = optparse_get_str (p, "namespace", NULL);
 
+    if (optparse_hasopt (p, "stream")) {
+        if (optparse_hasopt (p, "watch")
+            || optparse_hasopt (p, "treeobj")
+            || optparse_hasopt (p, "raw"))
+            log_msg_exit ("--stream cannot be combined with -w, -t, or -r");
+        for (i = optindex; i < argc; i++)
+            cmd_get_stream (h, ctx.ns, p, argv[i]);
+        return (0);
+    }
     for (i = optindex; i < argc; i++)
         cmd_get_one (h, argv[i], &ctx);
     /* Unless --watch is specified, cmd_get_one() starts the reactor and
@@ -807,7 +1003,17 @@ int cmd_put (optparse_t *p, int argc, char **argv)
             log_msg_exit ("put: you must specify a value as key=value");
         *val++ = '\0';
 
-        if (optparse_hasopt (p, "treeobj")) {
+        if (optparse_hasopt (p, "stream")) {
+            if (strcmp (val, "-") != 0)
+                log_msg_exit ("--stream requires %s=- (value read from stdin)",
+                              key);
+            if (optparse_hasopt (p, "treeobj")
+                || optparse_hasopt (p, "raw")
+                || optparse_hasopt (p, "append"))
+                log_msg_exit ("--stream cannot be combined with -t, -r, or -A");
+            cmd_put_stream (h, txn, key);
+        }
+        else if (optparse_hasopt (p, "treeobj")) {
             int len;
             uint8_t *buf = NULL;
 
@@ -1725,6 +1931,125 @@ int cmd_getroot (optparse_t *p, int argc, char **argv)
     return (0);
 }
 
+/* Emit one archive line for a terminal entry (val, valref, or symlink).
+ */
+static void dump_snapshot_entry (const char *key, json_t *entry)
+{
+    json_t *line;
+    char *s;
+
+    if (!(line = json_pack ("{s:s s:O}",
+                            "key", key,
+                            "treeobj", entry)))
+        log_msg_exit ("%s: failed to encode archive entry", key);
+    if (!(s = json_dumps (line, JSON_COMPACT)))
+        log_msg_exit ("%s: failed to encode archive entry", key);
+    printf ("%s\n", s);
+    free (s);
+    json_decref (line);
+}
+
+/* Walk directory treeobj 'dir' at 'path', looking up dirrefs relative
+ * to 'snapshot' so the walk sees a single consistent root.
+ */
+static void dump_snapshot_dir (flux_t *h, const char *snapshot,
+                               const char *path, json_t *dir)
+{
+    json_t *data = treeobj_get_data (dir);
+    const char *name;
+    json_t *entry;
+    char *key;
+
+    json_object_foreach (data, name, entry) {
+        if (!strcmp (path, "."))
+            key = xstrdup (name);
+        else
+            key = xasprintf ("%s.%s", path, name);
+        if (treeobj_is_dirref (entry)) {
+            flux_future_t *f;
+            const char *s;
+            json_t *ndir;
+            if (!(f = flux_kvs_lookupat (h,
+                                         FLUX_KVS_READDIR | FLUX_KVS_TREEOBJ,
+                                         key, snapshot)))
+                log_err_exit ("%s", key);
+            if (flux_kvs_lookup_get_treeobj (f, &s) < 0)
+                log_err_exit ("%s", key);
+            if (!(ndir = treeobj_decode (s)))
+                log_err_exit ("%s: treeobj_decode", key);
+            dump_snapshot_dir (h, snapshot, key, ndir);
+            json_decref (ndir);
+            flux_future_destroy (f);
+        }
+        else if (treeobj_is_dir (entry))
+            dump_snapshot_dir (h, snapshot, key, entry);
+        else
+            dump_snapshot_entry (key, entry);
+        free (key);
+    }
+}
+
+int cmd_dump (optparse_t *p, int argc, char **argv)
+{
+    flux_t *h = optparse_get_data (p, "flux_handle");
+    int optindex = optparse_option_index (p);
+    const char *ns = NULL;
+    char *snapshot;
+    json_t *snapobj;
+    json_t *header;
+    flux_future_t *f;
+    const char *s;
+    json_t *rootdir;
+    char *str;
+
+    if (optindex != argc) {
+        optparse_print_usage (p);
+        exit (1);
+    }
+    ns = optparse_get_str (p, "namespace", NULL);
+
+    /* Pin the snapshot up front so the recursive walk below is
+     * consistent even if the namespace is being written concurrently.
+     */
+    if (optparse_hasopt (p, "at"))
+        snapshot = xstrdup (optparse_get_str (p, "at", NULL));
+    else {
+        const char *treeobj;
+        if (!(f = flux_kvs_getroot (h, ns, 0)))
+            log_err_exit ("flux_kvs_getroot");
+        if (flux_kvs_getroot_get_treeobj (f, &treeobj) < 0)
+            log_err_exit ("flux_kvs_getroot");
+        snapshot = xstrdup (treeobj);
+        flux_future_destroy (f);
+    }
+
+    if (!(snapobj = treeobj_decode (snapshot)))
+        log_err_exit ("treeobj_decode");
+    if (!(header = json_pack ("{s:i s:O}",
+                              "version", 1,
+                              "snapshot", snapobj)))
+        log_msg_exit ("failed to encode archive header");
+    if (!(str = json_dumps (header, JSON_COMPACT)))
+        log_msg_exit ("failed to encode archive header");
+    printf ("%s\n", str);
+    free (str);
+    json_decref (header);
+    json_decref (snapobj);
+
+    if (!(f = flux_kvs_lookupat (h, FLUX_KVS_READDIR | FLUX_KVS_TREEOBJ,
+                                 ".", snapshot)))
+        log_err_exit ("flux_kvs_lookupat");
+    if (flux_kvs_lookup_get_treeobj (f, &s) < 0)
+        log_err_exit (".");
+    if (!(rootdir = treeobj_decode (s)))
+        log_err_exit ("treeobj_decode");
+    dump_snapshot_dir (h, snapshot, ".", rootdir);
+    json_decref (rootdir);
+    flux_future_destroy (f);
+    free (snapshot);
+    return (0);
+}
+
 /* combine 'argv' elements into one space-separated string (caller must free).
  * assumes 'argv' is NULL terminated.
  */
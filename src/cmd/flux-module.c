@@ -13,6 +13,7 @@
 #endif
 #include <stdio.h>
 #include <getopt.h>
+#include <inttypes.h>
 #include <dlfcn.h>
 #include <flux/core.h>
 #include <flux/optparse.h>
@@ -54,6 +55,13 @@ static struct optparse_option remove_opts[] =  {
     OPTPARSE_TABLE_END,
 };
 
+static struct optparse_option list_opts[] =  {
+    { .name = "stats", .key = 's', .has_arg = 0,
+      .usage = "Show per-module message counters instead of services",
+    },
+    OPTPARSE_TABLE_END,
+};
+
 static struct optparse_option stats_opts[] =  {
     { .name = "parse", .key = 'p', .has_arg = 1, .arginfo = "OBJNAME",
       .usage = "Parse object period-delimited object name",
@@ -93,7 +101,7 @@ static struct optparse_subcommand subcommands[] = {
       "List loaded modules",
       cmd_list,
       0,
-      NULL,
+      list_opts,
     },
     { "remove",
       "[OPTIONS] module",
@@ -455,36 +463,61 @@ char lsmod_state_char (int state)
     }
 }
 
-void lsmod_print_header (FILE *f)
+void lsmod_print_header (FILE *f, bool stats)
 {
-    fprintf (f, "%-20s %8s %-7s %4s  %c %s\n",
-            "Module", "Size", "Digest", "Idle", 'S', "Service");
+    if (stats)
+        fprintf (f, "%-20s %4s  %c %10s %10s %12s %12s %10s %7s\n",
+                "Module", "Idle", 'S',
+                "TX-count", "RX-count", "TX-bytes", "RX-bytes",
+                "Minflt", "Majflt");
+    else
+        fprintf (f, "%-20s %8s %-7s %4s  %c %s\n",
+                "Module", "Size", "Digest", "Idle", 'S', "Service");
 }
 
 void lsmod_print_entry (FILE *f,
+                       bool stats,
                        const char *name,
                        int size,
                        const char *digest,
                        int idle,
                        int status,
-                       json_t *services)
+                       json_t *services,
+                       json_int_t tx_count,
+                       json_int_t rx_count,
+                       json_int_t tx_bytes,
+                       json_int_t rx_bytes,
+                       json_int_t minflt,
+                       json_int_t majflt)
 {
     int digest_len = strlen (digest);
     char *serv_s = lsmod_services_string (services, name);
     char idle_s[16];
 
-    fprintf (f, "%-20.20s %8d %7s %4s  %c %s\n",
-             name,
-             size,
-             digest_len > 7 ? digest + digest_len - 7 : digest,
-             lsmod_idle_string (idle, idle_s, sizeof (idle_s)),
-             lsmod_state_char (status),
-             serv_s ? serv_s : "");
+    if (stats)
+        fprintf (f, "%-20.20s %4s  %c %10ju %10ju %12ju %12ju %10ju %7ju\n",
+                 name,
+                 lsmod_idle_string (idle, idle_s, sizeof (idle_s)),
+                 lsmod_state_char (status),
+                 (uintmax_t)tx_count,
+                 (uintmax_t)rx_count,
+                 (uintmax_t)tx_bytes,
+                 (uintmax_t)rx_bytes,
+                 (uintmax_t)minflt,
+                 (uintmax_t)majflt);
+    else
+        fprintf (f, "%-20.20s %8d %7s %4s  %c %s\n",
+                 name,
+                 size,
+                 digest_len > 7 ? digest + digest_len - 7 : digest,
+                 lsmod_idle_string (idle, idle_s, sizeof (idle_s)),
+                 lsmod_state_char (status),
+                 serv_s ? serv_s : "");
 
     free (serv_s);
 }
 
-void lsmod_print_list (FILE *f, json_t *o)
+void lsmod_print_list (FILE *f, json_t *o, bool stats)
 {
     size_t index;
     json_t *value;
@@ -494,25 +527,43 @@ void lsmod_print_list (FILE *f, json_t *o)
     int idle;
     int status;
     json_t *services;
+    json_int_t tx_count, rx_count, tx_bytes, rx_bytes;
+    json_int_t minflt, majflt;
 
     json_array_foreach (o, index, value) {
-        if (json_unpack (value, "{s:s s:i s:s s:i s:i s:o}",
+        tx_count = rx_count = tx_bytes = rx_bytes = 0;
+        minflt = majflt = 0;
+        if (json_unpack (value, "{s:s s:i s:s s:i s:i s:o"
+                         " s?:I s?:I s?:I s?:I s?:I s?:I}",
                          "name", &name,
                          "size", &size,
                          "digest", &digest,
                          "idle", &idle,
                          "status", &status,
-                         "services", &services) < 0)
+                         "services", &services,
+                         "tx-count", &tx_count,
+                         "rx-count", &rx_count,
+                         "tx-bytes", &tx_bytes,
+                         "rx-bytes", &rx_bytes,
+                         "minflt", &minflt,
+                         "majflt", &majflt) < 0)
             log_msg_exit ("Erorr parsing lsmod response");
         if (!json_is_array (services))
             log_msg_exit ("Erorr parsing lsmod services array");
         lsmod_print_entry (f,
+                           stats,
                            name,
                            size,
                            digest,
                            idle,
                            status,
-                           services);
+                           services,
+                           tx_count,
+                           rx_count,
+                           tx_bytes,
+                           rx_bytes,
+                           minflt,
+                           majflt);
     }
 }
 
@@ -546,8 +597,8 @@ int cmd_list (optparse_t *p, int argc, char **argv)
         log_err_exit ("%s", topic);
     if (!json_is_array (o))
         log_msg_exit ("%s: module list is not an array", topic);
-    lsmod_print_header (stdout);
-    lsmod_print_list (stdout, o);
+    lsmod_print_header (stdout, optparse_hasopt (p, "stats"));
+    lsmod_print_list (stdout, o, optparse_hasopt (p, "stats"));
     flux_future_destroy (f);
     free (topic);
     flux_close (h);
@@ -22,6 +22,18 @@
 #include "src/common/libutil/monotime.h"
 #include "src/common/libutil/tstat.h"
 #include "src/common/libutil/log.h"
+#include "src/common/libidset/idset.h"
+
+/* One benchmark target rank: latency samples plus hop count parsed
+ * from the route string the remote ping service echoes back.
+ */
+struct bench_target {
+    uint32_t nodeid;
+    tstat_t tstat;
+    int hops;
+    int sent;
+    int completed;
+};
 
 struct ping_ctx {
     double interval;    /* interval between sends, in seconds */
@@ -34,6 +46,15 @@ struct ping_ctx {
     flux_t *h;
     flux_reactor_t *reactor;
     bool userid_flag;   /* include userid/rolemask in output */
+
+    /* benchmark mode */
+    bool bench;
+    int concurrency;    /* max in-flight requests */
+    int inflight;
+    struct bench_target *targets;
+    int ntargets;
+    int next_target;    /* round robin cursor */
+    tstat_t bench_all;  /* aggregate across targets */
 };
 
 struct ping_data {
@@ -62,6 +83,16 @@ static struct optparse_option cmdopts[] = {
     { .name = "userid",   .key = 'u', .has_arg = 0,
       .usage = "Include userid and rolemask in ping output",
     },
+    { .name = "bench",    .key = 'B', .has_arg = 0,
+      .usage = "Benchmark mode: drive concurrent pings against a set of "
+               "ranks and report latency percentiles per rank",
+    },
+    { .name = "ranks",    .key = 'R', .has_arg = 1, .arginfo = "IDSET",
+      .usage = "With --bench, target this set of ranks (default: all)",
+    },
+    { .name = "concurrency", .key = 'n', .has_arg = 1, .arginfo = "N",
+      .usage = "With --bench, keep N requests in flight (default 16)",
+    },
     OPTPARSE_TABLE_END
 };
 
@@ -214,6 +245,171 @@ void timer_cb (flux_reactor_t *r, flux_watcher_t *w, int revents, void *arg)
     }
 }
 
+/* The route string is '!'-delimited, one element per hop taken by
+ * the request, e.g. "uuid!uuid!uuid".
+ */
+static int count_hops (const char *route)
+{
+    int hops = 1;
+
+    while (*route) {
+        if (*route++ == '!')
+            hops++;
+    }
+    return hops;
+}
+
+static void bench_fill (struct ping_ctx *ctx);
+
+void bench_continuation (flux_future_t *f, void *arg)
+{
+    struct ping_ctx *ctx = arg;
+    struct bench_target *t = flux_future_aux_get (f, "target");
+    const char *route, *pad;
+    int64_t sec, nsec;
+    struct timespec t0;
+    int seq;
+    double ms;
+    char rbuf[32];
+
+    if (flux_rpc_get_unpack (f,
+                             "{ s:i s:I s:I s:s s:s }",
+                             "seq", &seq,
+                             "time.tv_sec", &sec,
+                             "time.tv_nsec", &nsec,
+                             "pad", &pad,
+                             "route", &route) < 0)
+        log_err_exit ("%s%s",
+                      rank_bang_str (t->nodeid, rbuf, sizeof (rbuf)),
+                      ctx->topic);
+    t0.tv_sec = sec;
+    t0.tv_nsec = nsec;
+    ms = monotime_since (t0);
+    tstat_push (&t->tstat, ms);
+    tstat_push (&ctx->bench_all, ms);
+    t->hops = count_hops (route);
+    t->completed++;
+    ctx->inflight--;
+    flux_future_destroy (f);
+    bench_fill (ctx);
+}
+
+void bench_send (struct ping_ctx *ctx, struct bench_target *t)
+{
+    struct timespec t0;
+    flux_future_t *f;
+
+    monotime (&t0);
+    if (!(f = flux_rpc_pack (ctx->h,
+                             ctx->topic, t->nodeid,
+                             0,
+                             "{s:i s:I s:I s:s}",
+                             "seq", t->sent,
+                             "time.tv_sec", (uint64_t)t0.tv_sec,
+                             "time.tv_nsec", (uint64_t)t0.tv_nsec,
+                             "pad", ctx->pad)))
+        log_err_exit ("flux_rpc_pack");
+    if (flux_future_aux_set (f, "target", t, NULL) < 0)
+        log_err_exit ("flux_future_aux_set");
+    if (flux_future_then (f, -1., bench_continuation, ctx) < 0)
+        log_err_exit ("flux_future_then");
+    t->sent++;
+    ctx->inflight++;
+}
+
+/* Top off the in-flight window, round robin across targets so all
+ * ranks are exercised simultaneously.  When nothing remains to send
+ * the reactor exits as the last responses are consumed.
+ */
+static void bench_fill (struct ping_ctx *ctx)
+{
+    int idle = 0;
+
+    while (ctx->inflight < ctx->concurrency && idle < ctx->ntargets) {
+        struct bench_target *t = &ctx->targets[ctx->next_target];
+        ctx->next_target = (ctx->next_target + 1) % ctx->ntargets;
+        if (t->sent < ctx->count) {
+            bench_send (ctx, t);
+            idle = 0;
+        }
+        else
+            idle++;
+    }
+}
+
+static void bench_report_line (const char *label, tstat_t *ts, int hops)
+{
+    printf ("%-8s %7d %8.3f %8.3f %8.3f %8.3f %8.3f %8.3f",
+            label,
+            tstat_count (ts),
+            tstat_min (ts),
+            tstat_mean (ts),
+            tstat_percentile (ts, 50.),
+            tstat_percentile (ts, 95.),
+            tstat_percentile (ts, 99.),
+            tstat_max (ts));
+    if (hops > 0)
+        printf (" %5d %8.3f", hops, tstat_percentile (ts, 50.) / hops);
+    printf ("\n");
+}
+
+static void bench_report (struct ping_ctx *ctx)
+{
+    char label[32];
+    int i;
+
+    printf ("%s pad=%zu concurrency=%d count=%d/rank\n",
+            ctx->topic,
+            strlen (ctx->pad),
+            ctx->concurrency,
+            ctx->count);
+    printf ("%-8s %7s %8s %8s %8s %8s %8s %8s %5s %8s\n",
+            "rank", "count", "min(ms)", "mean",
+            "p50", "p95", "p99", "max", "hops", "p50/hop");
+    for (i = 0; i < ctx->ntargets; i++) {
+        struct bench_target *t = &ctx->targets[i];
+        snprintf (label, sizeof (label), "%" PRIu32, t->nodeid);
+        bench_report_line (label, &t->tstat, t->hops);
+    }
+    if (ctx->ntargets > 1)
+        bench_report_line ("all", &ctx->bench_all, 0);
+}
+
+/* Build the target array from an idset string, or all ranks if
+ * 'ranks' is NULL.
+ */
+static void bench_setup_targets (struct ping_ctx *ctx, const char *ranks)
+{
+    struct idset *ids = NULL;
+    uint32_t size;
+    unsigned int id;
+    int i;
+
+    if (ranks) {
+        if (!(ids = idset_decode (ranks)))
+            log_err_exit ("error decoding --ranks");
+    }
+    else {
+        if (flux_get_size (ctx->h, &size) < 0)
+            log_err_exit ("flux_get_size");
+        if (!(ids = idset_create (0, IDSET_FLAG_AUTOGROW)))
+            log_err_exit ("idset_create");
+        if (idset_range_set (ids, 0, size - 1) < 0)
+            log_err_exit ("idset_range_set");
+    }
+    ctx->ntargets = idset_count (ids);
+    if (ctx->ntargets == 0)
+        log_msg_exit ("--ranks must contain at least one rank");
+    ctx->targets = xzmalloc (sizeof (ctx->targets[0]) * ctx->ntargets);
+    i = 0;
+    id = idset_first (ids);
+    while (id != IDSET_INVALID_ID) {
+        ctx->targets[i++].nodeid = id;
+        id = idset_next (ids, id);
+    }
+    idset_destroy (ids);
+}
+
 int parse_nodeid (const char *s, uint32_t *np)
 {
     uint32_t n;
@@ -313,12 +509,27 @@ int main (int argc, char *argv[])
     if (ctx.batch && ctx.count == 0)
         log_msg_exit ("--batch should only be used with --count");
 
+    ctx.bench = optparse_hasopt (opts, "bench");
+    if (ctx.bench) {
+        if (ctx.batch || optparse_hasopt (opts, "rank"))
+            log_msg_exit ("--bench conflicts with --batch and --rank");
+        ctx.concurrency = optparse_get_int (opts, "concurrency", 16);
+        if (ctx.concurrency < 1)
+            log_msg_exit ("concurrency must be >= 1");
+        if (ctx.count == 0)
+            ctx.count = 100;
+    }
+    else if (optparse_hasopt (opts, "ranks")
+             || optparse_hasopt (opts, "concurrency"))
+        log_msg_exit ("--ranks and --concurrency require --bench");
+
     if (optindex != argc - 1) {
         optparse_print_usage (opts);
         exit (1);
     }
     parse_service (argv[optindex++],
-                   optparse_hasopt (opts, "rank") ? NULL : &ctx.nodeid,
+                   optparse_hasopt (opts, "rank") || ctx.bench
+                       ? NULL : &ctx.nodeid,
                    &ctx.topic);
 
     /* Create null terminated pad string for reuse in each message.
@@ -333,10 +544,16 @@ int main (int argc, char *argv[])
     if (!(ctx.reactor = flux_get_reactor (ctx.h)))
         log_err_exit ("flux_get_reactor");
 
-    /* In batch mode, requests are sent before reactor is started
-     * to process responses.  o/w requests are set in a timer watcher.
+    /* In bench mode, a window of up to 'concurrency' requests is kept
+     * in flight across all target ranks until each has been sent
+     * 'count' requests, then a summary is printed.  In batch mode,
+     * requests are sent before reactor is started to process
+     * responses.  o/w requests are set in a timer watcher.
      */
-    if (ctx.batch) {
+    if (ctx.bench) {
+        bench_setup_targets (&ctx, optparse_get_str (opts, "ranks", NULL));
+        bench_fill (&ctx);
+    } else if (ctx.batch) {
         while (ctx.send_count < ctx.count) {
             send_ping (&ctx);
             usleep ((useconds_t)(ctx.interval * 1E6));
@@ -351,10 +568,14 @@ int main (int argc, char *argv[])
     if (flux_reactor_run (ctx.reactor, 0) < 0)
         log_err_exit ("flux_reactor_run");
 
+    if (ctx.bench)
+        bench_report (&ctx);
+
     /* Clean up.
      */
     flux_watcher_destroy (tw);
 
+    free (ctx.targets);
     free (ctx.topic);
     free (ctx.pad);
 
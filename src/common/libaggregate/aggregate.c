@@ -12,6 +12,8 @@
 
 #include <flux/core.h>
 
+#include "src/common/libidset/idset.h"
+
 static void aggregate_wait_set_errnum (flux_future_t *f, int errnum)
 {
     if (flux_future_aux_set (f, "aggregate::errnum",
@@ -193,5 +195,41 @@ flux_future_t *aggregator_push_json (flux_t *h, int fwd_count, double timeout,
                              "entries", rankstr, o);
 }
 
+flux_future_t *aggregator_push_idset_json (flux_t *h, int fwd_count,
+                                           double timeout, const char *key,
+                                           const struct idset *ids, json_t *o)
+{
+    uint32_t size;
+    char *idstr = NULL;
+    flux_future_t *f = NULL;
+
+    if (ids == NULL || idset_count (ids) == 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if ((flux_get_size (h, &size) < 0)
+        || !(idstr = idset_encode (ids, IDSET_FLAG_RANGE
+                                        | IDSET_FLAG_BRACKETS)))
+        return NULL;
+
+    if (timeout >= 0.)
+        f = flux_rpc_pack (h, "aggregator.push", FLUX_NODEID_ANY, 0,
+                           "{s:s,s:i,s:i,s:f,s:{s:o}}",
+                           "key", key,
+                           "total", size,
+                           "fwd_count", fwd_count,
+                           "timeout" , timeout,
+                           "entries", idstr, o);
+    else
+        f = flux_rpc_pack (h, "aggregator.push", FLUX_NODEID_ANY, 0,
+                           "{s:s,s:i,s:i,s:{s:o}}",
+                           "key", key,
+                           "total", size,
+                           "fwd_count", fwd_count,
+                           "entries", idstr, o);
+    free (idstr);
+    return (f);
+}
+
 /* vi: ts=4 sw=4 expandtab
  */
@@ -11,6 +11,8 @@
 #ifndef HAVE_LIBAGGREGATE_AGGREGATE_H
 #define HAVE_LIBAGGREGATE_AGGREGATE_H 1
 
+struct idset;
+
 /*
  *  Push single json object `o` to local aggregator module via RPC.
  *   Steals the reference to `o`. If fwd_count > 0, then set local
@@ -20,6 +22,16 @@
 flux_future_t *aggregator_push_json (flux_t *h, int fwd_count, double t,
 		                     const char *key, json_t *o);
 
+/*
+ *  Like aggregator_push_json(), but push `o` on behalf of all ranks in
+ *   idset `ids`, packed as a single sparse idset-keyed entry. Useful
+ *   when one caller holds the identical result for many ranks, so the
+ *   value is transferred once rather than once per rank.
+ */
+flux_future_t *aggregator_push_idset_json (flux_t *h, int fwd_count, double t,
+		                           const char *key,
+		                           const struct idset *ids, json_t *o);
+
 /*  Fulfill future when aggregate at `key` is "complete", i.e.
  *   count == total. Use aggreate_wait_get_unpack () to unpack final
  *   aggregate kvs value after successful fulfillment.
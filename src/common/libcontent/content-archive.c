@@ -0,0 +1,303 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <czmq.h>
+
+#include "src/common/libutil/blobref.h"
+#include "src/common/libutil/errno_safe.h"
+
+#include "content-archive.h"
+
+static const char archive_magic[8] = "FLUXBLOB";
+static const char trailer_magic[8] = "FLUXIDX\0";
+static const uint32_t archive_version = 1;
+static const size_t archive_bufsize = 1024 * 1024;
+
+struct index_entry {
+    char blobref[BLOBREF_MAX_STRING_SIZE];
+    uint64_t offset;
+};
+
+struct content_archive_writer {
+    FILE *fp;
+    char *iobuf;
+    zlist_t *index;
+    uint64_t offset;
+};
+
+struct content_archive_reader {
+    FILE *fp;
+    char *iobuf;
+    void *data;
+    size_t data_size;
+    uint64_t offset;
+    uint64_t index_offset;
+};
+
+/* Fixed little endian integer helpers, so archives are portable
+ * across hosts.
+ */
+static void put_u32 (uint8_t *buf, uint32_t val)
+{
+    buf[0] = val;
+    buf[1] = val >> 8;
+    buf[2] = val >> 16;
+    buf[3] = val >> 24;
+}
+
+static void put_u64 (uint8_t *buf, uint64_t val)
+{
+    put_u32 (buf, val);
+    put_u32 (buf + 4, val >> 32);
+}
+
+static uint32_t get_u32 (const uint8_t *buf)
+{
+    return (uint32_t)buf[0] | (uint32_t)buf[1] << 8
+         | (uint32_t)buf[2] << 16 | (uint32_t)buf[3] << 24;
+}
+
+static uint64_t get_u64 (const uint8_t *buf)
+{
+    return (uint64_t)get_u32 (buf) | (uint64_t)get_u32 (buf + 4) << 32;
+}
+
+struct content_archive_writer *content_archive_writer_create (
+                                                    const char *path,
+                                                    const char *hash_name)
+{
+    struct content_archive_writer *w;
+    uint8_t hdr[8 + 4 + 16];
+
+    if (!path || !hash_name || strlen (hash_name) >= 16) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(w = calloc (1, sizeof (*w))))
+        return NULL;
+    if (!(w->index = zlist_new ()) || !(w->iobuf = malloc (archive_bufsize))) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (!(w->fp = fopen (path, "w")))
+        goto error;
+    setvbuf (w->fp, w->iobuf, _IOFBF, archive_bufsize);
+    memcpy (hdr, archive_magic, 8);
+    put_u32 (hdr + 8, archive_version);
+    memset (hdr + 12, 0, 16);
+    strcpy ((char *)hdr + 12, hash_name);
+    if (fwrite (hdr, sizeof (hdr), 1, w->fp) != 1)
+        goto error;
+    w->offset = sizeof (hdr);
+    return w;
+error:
+    content_archive_writer_destroy (w);
+    return NULL;
+}
+
+int content_archive_append (struct content_archive_writer *w,
+                            const char *blobref,
+                            const void *data,
+                            uint32_t len)
+{
+    struct index_entry *ie;
+    uint8_t lenbuf[4];
+
+    if (!w || !blobref || strlen (blobref) >= BLOBREF_MAX_STRING_SIZE
+           || (len > 0 && !data)) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!(ie = malloc (sizeof (*ie))))
+        return -1;
+    strcpy (ie->blobref, blobref);
+    ie->offset = w->offset;
+    if (zlist_append (w->index, ie) < 0) {
+        free (ie);
+        errno = ENOMEM;
+        return -1;
+    }
+    zlist_freefn (w->index, ie, free, true);
+    put_u32 (lenbuf, len);
+    if (fwrite (lenbuf, sizeof (lenbuf), 1, w->fp) != 1
+        || (len > 0 && fwrite (data, len, 1, w->fp) != 1)) {
+        errno = EIO;
+        return -1;
+    }
+    w->offset += sizeof (lenbuf) + len;
+    return 0;
+}
+
+int content_archive_writer_close (struct content_archive_writer *w)
+{
+    struct index_entry *ie;
+    uint8_t buf[1 + BLOBREF_MAX_STRING_SIZE + 8];
+    uint8_t trailer[8 + 8];
+    uint64_t index_offset;
+    int rc = -1;
+
+    if (!w) {
+        errno = EINVAL;
+        return -1;
+    }
+    index_offset = w->offset;
+    put_u32 (buf, zlist_size (w->index));
+    if (fwrite (buf, 4, 1, w->fp) != 1) {
+        errno = EIO;
+        goto done;
+    }
+    ie = zlist_first (w->index);
+    while (ie) {
+        uint8_t reflen = strlen (ie->blobref);
+        buf[0] = reflen;
+        memcpy (buf + 1, ie->blobref, reflen);
+        put_u64 (buf + 1 + reflen, ie->offset);
+        if (fwrite (buf, 1 + reflen + 8, 1, w->fp) != 1) {
+            errno = EIO;
+            goto done;
+        }
+        ie = zlist_next (w->index);
+    }
+    put_u64 (trailer, index_offset);
+    memcpy (trailer + 8, trailer_magic, 8);
+    if (fwrite (trailer, sizeof (trailer), 1, w->fp) != 1
+        || fflush (w->fp) != 0) {
+        errno = EIO;
+        goto done;
+    }
+    rc = 0;
+done:
+    ERRNO_SAFE_WRAP (content_archive_writer_destroy, w);
+    return rc;
+}
+
+void content_archive_writer_destroy (struct content_archive_writer *w)
+{
+    if (w) {
+        int saved_errno = errno;
+        if (w->fp)
+            fclose (w->fp);
+        zlist_destroy (&w->index);
+        free (w->iobuf);
+        free (w);
+        errno = saved_errno;
+    }
+}
+
+struct content_archive_reader *content_archive_reader_create (
+                                                    const char *path,
+                                                    char *hash_name,
+                                                    int hash_name_len)
+{
+    struct content_archive_reader *r;
+    uint8_t hdr[8 + 4 + 16];
+    uint8_t trailer[8 + 8];
+
+    if (!path || !hash_name || hash_name_len < 16) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(r = calloc (1, sizeof (*r))))
+        return NULL;
+    if (!(r->iobuf = malloc (archive_bufsize))) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (!(r->fp = fopen (path, "r")))
+        goto error;
+    setvbuf (r->fp, r->iobuf, _IOFBF, archive_bufsize);
+    /* Locate the index from the trailer so sequential record reads
+     * know where to stop, then rewind behind the header.
+     */
+    if (fseek (r->fp, -(long)sizeof (trailer), SEEK_END) < 0
+        || fread (trailer, sizeof (trailer), 1, r->fp) != 1
+        || memcmp (trailer + 8, trailer_magic, 8) != 0) {
+        errno = EINVAL;
+        goto error;
+    }
+    r->index_offset = get_u64 (trailer);
+    if (fseek (r->fp, 0, SEEK_SET) < 0
+        || fread (hdr, sizeof (hdr), 1, r->fp) != 1
+        || memcmp (hdr, archive_magic, 8) != 0
+        || get_u32 (hdr + 8) != archive_version
+        || hdr[12 + 15] != '\0') {
+        errno = EINVAL;
+        goto error;
+    }
+    strcpy (hash_name, (char *)hdr + 12);
+    r->offset = sizeof (hdr);
+    return r;
+error:
+    content_archive_reader_destroy (r);
+    return NULL;
+}
+
+int content_archive_next (struct content_archive_reader *r,
+                          const void **datap,
+                          uint32_t *lenp)
+{
+    uint8_t lenbuf[4];
+    uint32_t len;
+
+    if (!r || !datap || !lenp) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (r->offset >= r->index_offset)
+        return 0;
+    if (fread (lenbuf, sizeof (lenbuf), 1, r->fp) != 1) {
+        errno = EINVAL;
+        return -1;
+    }
+    len = get_u32 (lenbuf);
+    if (r->offset + sizeof (lenbuf) + len > r->index_offset) {
+        errno = EINVAL; /* truncated/corrupt record */
+        return -1;
+    }
+    if (len > r->data_size) {
+        void *tmp;
+        if (!(tmp = realloc (r->data, len)))
+            return -1;
+        r->data = tmp;
+        r->data_size = len;
+    }
+    if (len > 0 && fread (r->data, len, 1, r->fp) != 1) {
+        errno = EINVAL;
+        return -1;
+    }
+    r->offset += sizeof (lenbuf) + len;
+    *datap = r->data;
+    *lenp = len;
+    return 1;
+}
+
+void content_archive_reader_destroy (struct content_archive_reader *r)
+{
+    if (r) {
+        int saved_errno = errno;
+        if (r->fp)
+            fclose (r->fp);
+        free (r->data);
+        free (r->iobuf);
+        free (r);
+        errno = saved_errno;
+    }
+}
+
+/*
+ * vi:ts=4 sw=4 expandtab
+ */
@@ -0,0 +1,79 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _FLUX_CONTENT_ARCHIVE_H
+#define _FLUX_CONTENT_ARCHIVE_H
+
+#include <stdint.h>
+
+/* Streaming blob archive for content store migration.
+ *
+ * Layout (all integers little endian):
+ *   header:  8 byte magic, u32 version, 16 byte NUL-padded hash name
+ *   records: u32 length, blob data  (repeated)
+ *   index:   u32 count, then per blob: u8 reflen, blobref, u64 offset
+ *   trailer: u64 index offset, 8 byte magic
+ *
+ * Records are written and read strictly sequentially through a large
+ * buffer, so a dump or restore runs at disk bandwidth.  The index
+ * permits random access by other tools but is not needed for import,
+ * since blobrefs are recomputable from the data.
+ */
+
+struct content_archive_writer;
+struct content_archive_reader;
+
+/* Create an archive at 'path' (O_TRUNC), recording 'hash_name' (e.g.
+ * "sha1") in the header.  Returns NULL with errno set on failure.
+ */
+struct content_archive_writer *content_archive_writer_create (
+                                                    const char *path,
+                                                    const char *hash_name);
+
+/* Append one blob.  Returns 0 on success, -1 with errno set.
+ */
+int content_archive_append (struct content_archive_writer *w,
+                            const char *blobref,
+                            const void *data,
+                            uint32_t len);
+
+/* Write index and trailer, flush, and destroy the writer.
+ * Returns 0 on success, -1 with errno set (archive is incomplete).
+ */
+int content_archive_writer_close (struct content_archive_writer *w);
+
+/* Destroy the writer without completing the archive (error cleanup).
+ */
+void content_archive_writer_destroy (struct content_archive_writer *w);
+
+/* Open an archive for sequential reading.  The header hash name is
+ * copied to 'hash_name' (size 'hash_name_len').
+ * Returns NULL with errno set on failure.
+ */
+struct content_archive_reader *content_archive_reader_create (
+                                                    const char *path,
+                                                    char *hash_name,
+                                                    int hash_name_len);
+
+/* Read the next record.  '*datap' points to an internal buffer valid
+ * until the next call.
+ * Returns 1 on success, 0 at end of records, -1 with errno set.
+ */
+int content_archive_next (struct content_archive_reader *r,
+                          const void **datap,
+                          uint32_t *lenp);
+
+void content_archive_reader_destroy (struct content_archive_reader *r);
+
+#endif /* !_FLUX_CONTENT_ARCHIVE_H */
+
+/*
+ * vi:ts=4 sw=4 expandtab
+ */
@@ -18,8 +18,7 @@
 
 #include "eventlog.h"
 
-static json_t *eventlog_entry_decode_common (const char *event,
-                                             bool trailing_newline);
+static json_t *entry_decode_buf (const char *entry, size_t len);
 
 int eventlog_entry_parse (json_t *entry,
                           double *timestamp,
@@ -61,65 +60,52 @@ int eventlog_entry_parse (json_t *entry,
     return 0;
 }
 
-static int eventlog_entry_append (json_t *a, const char *event)
-{
-    json_t *o = NULL;
-
-    if (!(o = eventlog_entry_decode_common (event, false)))
-        return -1;
-
-    if (json_array_append_new (a, o) < 0) {
-        json_decref (o);
-        errno = ENOMEM;
-        return -1;
-    }
-
-    return 0;
-}
-
 json_t *eventlog_decode (const char *s)
 {
-    char *copy = NULL;
-    char *input;
+    const char *input;
     json_t *a = NULL;
     int save_errno;
-    char *ptr;
+    const char *ptr;
 
     if (!s) {
         errno = EINVAL;
         return NULL;
     }
 
-    if (!(copy = strdup (s)))
-        return NULL;
-    input = copy;
-
     /* gotta have atleast 1 newline, if not empty string */
-    if (strlen (s) && !(ptr = strchr (input, '\n'))) {
+    if (strlen (s) && !strchr (s, '\n')) {
         errno = EINVAL;
-        goto error;
+        return NULL;
     }
 
     if (!(a = json_array ())) {
         errno = ENOMEM;
-        goto error;
+        return NULL;
     }
 
+    /* Parse each line in place - no need to copy the log just to
+     * NUL-terminate entries, since json_loadb() takes a length.
+     */
+    input = s;
     while ((ptr = strchr (input, '\n'))) {
-        (*ptr++) = '\0';
+        json_t *o;
 
-        if (eventlog_entry_append (a, input) < 0)
+        if (!(o = entry_decode_buf (input, ptr - input)))
             goto error;
 
-        input = ptr;
+        if (json_array_append_new (a, o) < 0) {
+            json_decref (o);
+            errno = ENOMEM;
+            goto error;
+        }
+
+        input = ptr + 1;
     }
 
-    free (copy);
     return a;
 
  error:
     save_errno = errno;
-    free (copy);
     json_decref (a);
     errno = save_errno;
     return NULL;
@@ -146,33 +132,14 @@ bool eventlog_entry_validate (json_t *entry)
     return true;
 }
 
-static json_t *eventlog_entry_decode_common (const char *entry,
-                                             bool trailing_newline)
+static json_t *entry_decode_buf (const char *entry, size_t len)
 {
-    int len;
-    char *ptr;
     json_t *o;
 
-    if (!entry)
+    if (len == 0 || memchr (entry, '\n', len))
         goto einval;
 
-    if (!(len = strlen (entry)))
-        goto einval;
-
-    if (trailing_newline) {
-        if (entry[len - 1] != '\n')
-            goto einval;
-
-        ptr = strchr (entry, '\n');
-        if (ptr != &entry[len - 1])
-            goto einval;
-    }
-    else {
-        if ((ptr = strchr (entry, '\n')))
-            goto einval;
-    }
-
-    if (!(o = json_loads (entry, 0, NULL)))
+    if (!(o = json_loadb (entry, len, 0, NULL)))
         goto einval;
 
     if (!eventlog_entry_validate (o)) {
@@ -189,7 +156,24 @@ static json_t *eventlog_entry_decode_common (const char *entry,
 
 json_t *eventlog_entry_decode (const char *entry)
 {
-    return eventlog_entry_decode_common (entry, true);
+    size_t len;
+
+    if (!entry || !(len = strlen (entry)) || entry[len - 1] != '\n') {
+        errno = EINVAL;
+        return NULL;
+    }
+    return entry_decode_buf (entry, len - 1);
+}
+
+json_t *eventlog_first_entry_decode (const char *s)
+{
+    const char *nl;
+
+    if (!s || !(nl = strchr (s, '\n'))) {
+        errno = EINVAL;
+        return NULL;
+    }
+    return entry_decode_buf (s, nl - s);
 }
 
 static int get_timestamp_now (double *timestamp)
@@ -301,10 +285,16 @@ static int append_string_nl (char **buf, int *bufsz, int used, const char *s)
 {
     int slen = strlen (s);
 
-    /* Grow buf for s + \n + \0 */
+    /* Grow buf for s + \n + \0, doubling to avoid a realloc+copy
+     * per entry when encoding a long eventlog.
+     */
     if (*bufsz < used + slen + 2) {
-        int nbufsz = used + slen + 2;
-        char *nbuf = realloc (*buf, nbufsz);
+        int nbufsz = *bufsz > 0 ? *bufsz : 64;
+        char *nbuf;
+
+        while (nbufsz < used + slen + 2)
+            nbufsz *= 2;
+        nbuf = realloc (*buf, nbufsz);
         if (!nbuf)
             return -1;
         *buf = nbuf;
@@ -319,8 +309,8 @@ static int append_string_nl (char **buf, int *bufsz, int used, const char *s)
 char *eventlog_entry_encode (json_t *entry)
 {
     char *s;
-    char *buf = NULL;
-    int bufsz = 0;
+    char *buf;
+    size_t len;
 
     if (!entry || !eventlog_entry_validate (entry)) {
         errno = EINVAL;
@@ -330,12 +320,17 @@ char *eventlog_entry_encode (json_t *entry)
         errno = ENOMEM;
         return NULL;
     }
-    if (append_string_nl (&buf, &bufsz, 0, s) < 0) {
+    /* Append \n in place rather than copying into a second buffer.
+     * json_dumps() result is plain malloc'd memory, so realloc is fine.
+     */
+    len = strlen (s);
+    if (!(buf = realloc (s, len + 2))) {
         free (s);
         errno = ENOMEM;
         return NULL;
     }
-    free (s);
+    buf[len] = '\n';
+    buf[len + 1] = '\0';
     return buf;
 }
 
@@ -29,6 +29,10 @@ char *eventlog_encode (json_t *o);
 /* decode a single eventlog entry into a json object */
 json_t *eventlog_entry_decode (const char *entry);
 
+/* decode only the first entry of an eventlog into a json object,
+ * without parsing the remainder of the log */
+json_t *eventlog_first_entry_decode (const char *s);
+
 /* build an eventlog entry.  Specify timestamp = 0.0 to get current
  * time. context must be a json object.  Set context to NULL if no
  * context necessary.  */
@@ -15,7 +15,7 @@
 #include <czmq.h>
 #include <flux/core.h>
 
-#include "src/common/libeventlog/eventlog.h"
+#include "eventlog.h"
 #include "eventlogger.h"
 
 struct eventlog_batch {
@@ -28,14 +28,41 @@ struct eventlog_batch {
 struct eventlogger {
     int refcount;
     flux_t *h;
+    char *ns;               /* KVS namespace (NULL = default) */
     double batch_timeout;
     double commit_timeout;
+    int batch_limit;        /* commit early after this many entries (0=off) */
     zlist_t *pending;
     struct eventlog_batch *current;
     struct eventlogger_ops ops;
     void *arg;
 };
 
+int eventlogger_set_namespace (struct eventlogger *ev, const char *ns)
+{
+    char *cpy = NULL;
+
+    if (!ev) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (ns && !(cpy = strdup (ns)))
+        return -1;
+    free (ev->ns);
+    ev->ns = cpy;
+    return 0;
+}
+
+int eventlogger_set_batch_limit (struct eventlogger *ev, int n)
+{
+    if (!ev || n < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    ev->batch_limit = n;
+    return 0;
+}
+
 int eventlogger_set_commit_timeout (struct eventlogger *ev, double timeout)
 {
     if (!ev || (timeout < 0. && timeout != -1.)) {
@@ -103,22 +130,32 @@ static void commit_cb (flux_future_t *f, void *arg)
     flux_future_destroy (f);
 }
 
-static void
-timer_cb (flux_reactor_t *r, flux_watcher_t *w, int revents, void *arg)
+/* Commit 'batch' asynchronously and stop filling it.  Completion (and
+ * errors) are handled in commit_cb().
+ */
+static void eventlog_batch_commit (struct eventlog_batch *batch)
 {
-    struct eventlog_batch *batch = arg;
     struct eventlogger *ev = batch->ev;
-    flux_t *h = ev->h;
-    double timeout = ev->commit_timeout;
     flux_future_t *f = NULL;
     int flags = FLUX_KVS_TXN_COMPACT;
 
-    if (!(f = flux_kvs_commit (h, NULL, flags, batch->txn))
-        || flux_future_then (f, timeout, commit_cb, batch) < 0) {
+    flux_watcher_stop (batch->timer);
+    if (!(f = flux_kvs_commit (ev->h, ev->ns, flags, batch->txn))
+        || flux_future_then (f, ev->commit_timeout, commit_cb, batch) < 0) {
         eventlog_batch_error (batch, errno);
+        flux_future_destroy (f);
         return;
     }
-    batch->ev->current = NULL;
+    if (ev->current == batch)
+        ev->current = NULL;
+}
+
+static void
+timer_cb (flux_reactor_t *r, flux_watcher_t *w, int revents, void *arg)
+{
+    struct eventlog_batch *batch = arg;
+
+    eventlog_batch_commit (batch);
 }
 
 static struct eventlog_batch * eventlog_batch_create (struct eventlogger *ev)
@@ -147,6 +184,7 @@ void eventlogger_destroy (struct eventlogger *ev)
     if (ev) {
         if (ev->pending)
             zlist_destroy (&ev->pending);
+        free (ev->ns);
         free (ev);
     }
 }
@@ -224,6 +262,9 @@ static int append_async (struct eventlogger *ev,
                   entry,
                   (zlist_free_fn *) json_decref,
                   true);
+    if (ev->batch_limit > 0
+        && (int)zlist_size (batch->entries) >= ev->batch_limit)
+        eventlog_batch_commit (batch);
     return 0;
 }
 
@@ -270,10 +311,12 @@ int eventlogger_flush (struct eventlogger *ev)
     struct eventlog_batch *batch;
     int flags = FLUX_KVS_TXN_COMPACT;
 
-    if (!(batch = eventlog_batch_get (ev)))
-        return -1;
+    /*  Nothing to flush if no batch is currently being filled */
+    if (!(batch = ev->current))
+        return 0;
 
-    if (!(f = flux_kvs_commit (ev->h, NULL, flags, ev->current->txn))
+    flux_watcher_stop (batch->timer);
+    if (!(f = flux_kvs_commit (ev->h, ev->ns, flags, ev->current->txn))
         || flux_future_wait_for (f, ev->commit_timeout) < 0)
         goto out;
     if ((rc = flux_future_get (f, NULL)) < 0)
@@ -286,6 +329,17 @@ out:
     return rc;
 }
 
+int eventlogger_flush_async (struct eventlogger *ev)
+{
+    if (!ev) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (ev->current)
+        eventlog_batch_commit (ev->current);
+    return 0;
+}
+
 /*
  * vi:tabstop=4 shiftwidth=4 expandtab
  */
@@ -8,8 +8,8 @@
  * SPDX-License-Identifier: LGPL-3.0
 \************************************************************/
 
-#ifndef FLUX_SHELL_EVENTLOGGER_H
-#define FLUX_SHELL_EVENTLOGGER_H
+#ifndef _EVENTLOG_EVENTLOGGER_H
+#define _EVENTLOG_EVENTLOGGER_H
 
 #include <flux/core.h>
 #include <jansson.h>
@@ -60,10 +60,28 @@ int eventlogger_append_entry (struct eventlogger *ev,
 
 int eventlogger_set_commit_timeout (struct eventlogger *ev, double timeout);
 
+/*  Append to eventlogs in KVS namespace `ns` rather than the default.
+ */
+int eventlogger_set_namespace (struct eventlogger *ev, const char *ns);
+
+/*  Commit the current batch as soon as `n` entries accumulate rather
+ *   than waiting out the batch timeout (0 = no limit, the default).
+ */
+int eventlogger_set_batch_limit (struct eventlogger *ev, int n);
+
+/*  Synchronously commit the current batch, waiting for completion.
+ */
 int eventlogger_flush (struct eventlogger *ev);
 
+/*  Start committing the current batch without waiting for completion.
+ *   Completion/errors are reported through `ops` as usual.  Appends
+ *   sent after this call start a new batch, and the KVS applies the
+ *   commits in submission order.
+ */
+int eventlogger_flush_async (struct eventlogger *ev);
+
 #ifdef __cplusplus
 }
 #endif
 
-#endif /* !FLUX_SHELL_EVENTLOGGER_H */
+#endif /* !_EVENTLOG_EVENTLOGGER_H */
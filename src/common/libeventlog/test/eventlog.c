@@ -234,6 +234,31 @@ void eventlog_entry_decoding (void)
     }
 }
 
+void eventlog_first_entry_decoding (void)
+{
+    json_t *o;
+    const char *name;
+
+    o = eventlog_first_entry_decode ("{\"timestamp\":42.2,\"name\":\"foo\"}\n"
+                                     "{\"timestamp\":42.3,\"name\":\"bar\"}\n");
+    ok (o != NULL
+        && eventlog_entry_parse (o, NULL, &name, NULL) == 0
+        && !strcmp (name, "foo"),
+        "eventlog_first_entry_decode returns first entry of multi-entry log");
+    json_decref (o);
+
+    errno = 0;
+    ok (eventlog_first_entry_decode (NULL) == NULL
+        && errno == EINVAL,
+        "eventlog_first_entry_decode fails with EINVAL on NULL input");
+
+    errno = 0;
+    ok (eventlog_first_entry_decode ("{\"timestamp\":42.2,\"name\":\"foo\"}")
+        == NULL
+        && errno == EINVAL,
+        "eventlog_first_entry_decode fails with EINVAL on unterminated entry");
+}
+
 void eventlog_entry_decoding_errors (void)
 {
     char buf[512];
@@ -487,6 +512,7 @@ int main (int argc, char *argv[])
     eventlog_decoding ();
     eventlog_decoding_errors ();
     eventlog_entry_decoding ();
+    eventlog_first_entry_decoding ();
     eventlog_entry_decoding_errors ();
     eventlog_entry_encoding ();
     /* eventlog_entry_encoding_errors (); */
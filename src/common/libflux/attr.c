@@ -18,6 +18,7 @@
 
 #include "attr.h"
 #include "rpc.h"
+#include "msg_handler.h"
 
 enum {
     FLUX_ATTRFLAG_IMMUTABLE = 1,
@@ -26,14 +27,22 @@ enum {
 struct attr_cache {
     zhashx_t *cache;        // immutable values
     zhashx_t *temp;         // values that stay valid until next lookup
+    zhashx_t *bulk;         // mutable values from last attr.dump
+    flux_msg_handler_t *mh; // invalidates bulk on 'attr' event
+    bool primed;            // bulk reflects a complete attr.dump
+    bool bulk_disabled;     // server lacks attr.dump or events; use attr.get
+    flux_attr_lookup_f lookup_fn;   // direct lookup, tried before any RPC
+    void *lookup_arg;
 };
 
 static void attr_cache_destroy (struct attr_cache *c)
 {
     if (c) {
         int saved_errno = errno;
+        flux_msg_handler_destroy (c->mh);
         zhashx_destroy (&c->cache);
         zhashx_destroy (&c->temp);
+        zhashx_destroy (&c->bulk);
         free (c);
         errno = saved_errno;
     }
@@ -58,6 +67,9 @@ static struct attr_cache *attr_cache_create (flux_t *h)
     if (!(c->temp = zhashx_new ()))
         goto nomem;
     zhashx_set_destructor (c->temp, valfree);
+    if (!(c->bulk = zhashx_new ()))
+        goto nomem;
+    zhashx_set_destructor (c->bulk, valfree);
     return c;
 nomem:
     errno = ENOMEM;
@@ -80,6 +92,71 @@ static struct attr_cache *get_attr_cache (flux_t *h)
     return c;
 }
 
+/* Any change to the attribute set invalidates the bulk cache.  The next
+ * lookup re-fetches it with a fresh attr.dump.
+ */
+static void attr_event_cb (flux_t *h, flux_msg_handler_t *mh,
+                           const flux_msg_t *msg, void *arg)
+{
+    struct attr_cache *c = arg;
+
+    zhashx_purge (c->bulk);
+    c->primed = false;
+}
+
+/* Fetch all attributes in one attr.dump RPC and populate the caches,
+ * arranging first for push invalidation via the 'attr' event.
+ * If the event cannot be subscribed to or the server does not support
+ * attr.dump (e.g. it is not a broker), disable bulk caching for the
+ * life of the handle so lookups simply fall back to attr.get.
+ */
+static int prime_cache (flux_t *h, struct attr_cache *c)
+{
+    flux_future_t *f = NULL;
+    json_t *dump;
+    const char *name;
+    json_t *entry;
+
+    if (c->bulk_disabled)
+        return -1;
+    if (!c->mh) {
+        struct flux_match match = FLUX_MATCH_EVENT;
+        match.topic_glob = "attr";
+        if (flux_event_subscribe (h, "attr") < 0)
+            goto disable;
+        if (!(c->mh = flux_msg_handler_create (h, match, attr_event_cb, c)))
+            goto disable;
+        flux_msg_handler_start (c->mh);
+    }
+    if (!(f = flux_rpc (h, "attr.dump", NULL, FLUX_NODEID_ANY, 0)))
+        goto disable;
+    if (flux_rpc_get_unpack (f, "{s:o}", "attrs", &dump) < 0)
+        goto disable;
+    json_object_foreach (dump, name, entry) {
+        const char *val;
+        int flags;
+        char *cpy;
+
+        if (json_unpack (entry, "{s:s s:i}", "value", &val,
+                                             "flags", &flags) < 0)
+            continue;
+        if (!(cpy = strdup (val)))
+            goto error;
+        if ((flags & FLUX_ATTRFLAG_IMMUTABLE))
+            zhashx_update (c->cache, name, cpy);
+        else
+            zhashx_update (c->bulk, name, cpy);
+    }
+    c->primed = true;
+    flux_future_destroy (f);
+    return 0;
+disable:
+    c->bulk_disabled = true;
+error:
+    flux_future_destroy (f);
+    return -1;
+}
+
 const char *flux_attr_get (flux_t *h, const char *name)
 {
     struct attr_cache *c;
@@ -96,6 +173,29 @@ const char *flux_attr_get (flux_t *h, const char *name)
         return NULL;
     if ((val = zhashx_lookup (c->cache, name)))
         return val;
+    if (c->lookup_fn) {
+        if ((cpy = c->lookup_fn (name, c->lookup_arg))) {
+            zhashx_update (c->temp, name, cpy);
+            return cpy;
+        }
+        if (errno != ENOENT)
+            return NULL;
+        /* Fall through to attr.get for names the direct lookup
+         * does not cover (e.g. active attributes).
+         */
+    }
+    else {
+        if (!c->primed)
+            (void)prime_cache (h, c);
+        if ((val = zhashx_lookup (c->cache, name)))
+            return val;
+        if (c->primed && (val = zhashx_lookup (c->bulk, name))) {
+            if (!(cpy = strdup (val)))
+                return NULL;
+            zhashx_update (c->temp, name, cpy);
+            return cpy;
+        }
+    }
     if (!(f = flux_rpc_pack (h, "attr.get", FLUX_NODEID_ANY, 0, "{s:s}",
                                                                 "name", name)))
         return NULL;
@@ -142,6 +242,21 @@ int flux_attr_set (flux_t *h, const char *name, const char *val)
     return 0;
 }
 
+int flux_attr_set_lookup (flux_t *h, flux_attr_lookup_f fn, void *arg)
+{
+    struct attr_cache *c;
+
+    if (!h) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!(c = get_attr_cache (h)))
+        return -1;
+    c->lookup_fn = fn;
+    c->lookup_arg = arg;
+    return 0;
+}
+
 int flux_attr_set_cacheonly (flux_t *h, const char *name, const char *val)
 {
     struct attr_cache *c;
@@ -160,6 +275,7 @@ int flux_attr_set_cacheonly (flux_t *h, const char *name, const char *val)
     }
     else
         zhashx_delete (c->cache, name);
+    zhashx_delete (c->bulk, name);
     return 0;
 }
 
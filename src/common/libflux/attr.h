@@ -50,6 +50,17 @@ int flux_attr_set (flux_t *h, const char *name, const char *val);
 /* hotwire flux_attr_get()'s cache for testing */
 int flux_attr_set_cacheonly (flux_t *h, const char *name, const char *val);
 
+/* Install a lookup function consulted by flux_attr_get() before any RPC
+ * is sent.  'fn' returns a copy of the value (ownership is transferred),
+ * or NULL with errno set; ENOENT falls through to the normal attr.get
+ * path so that attributes outside the function's purview still resolve.
+ * The broker uses this to let module threads read rank-local attributes
+ * directly from shared memory instead of RPC-ing the main thread.
+ * Pass fn=NULL to uninstall.
+ */
+typedef char *(*flux_attr_lookup_f)(const char *name, void *arg);
+int flux_attr_set_lookup (flux_t *h, flux_attr_lookup_f fn, void *arg);
+
 
 /* Get "rank" attribute, and convert to an unsigned integer.
  * Returns 0 on success, or -1 on failure with errno set.
@@ -21,6 +21,8 @@ struct composite_future {
     int seq;             /* sequence for anonymous children          */
     unsigned int any:1;  /* true if this future is a "wait any" type */
     zhash_t *children;   /* hash of child futures by name            */
+    int count;           /* fulfilled children (wait_all)            */
+    int errnum;          /* last child errno seen (wait_all)         */
 };
 
 static void composite_future_destroy (struct composite_future *f)
@@ -52,20 +54,26 @@ static struct composite_future * composite_get (flux_future_t *f)
 }
 
 /*
- *  Return true if all futures in this composite are ready
+ *  Count newly fulfilled child 'f' and return true when all children
+ *   are fulfilled.  A running count makes readiness O(1) per child
+ *   completion rather than a walk of all children, which matters for
+ *   wide fan-ins (e.g. a wait-all over thousands of subprocesses).
+ *  Each child is counted at most once, in case its continuation is
+ *   registered in more than one dispatch context.
  */
-static bool wait_all_is_ready (struct composite_future *cf, int *errnum)
+static bool wait_all_is_ready (struct composite_future *cf,
+                               flux_future_t *f,
+                               int *errnum)
 {
-    int err = 0;
-    flux_future_t *f = zhash_first (cf->children);
-    while (f) {
-        if (!flux_future_is_ready (f))
-            return (false);
-        if (flux_future_get (f, NULL) < 0)
-            err = errno;
-        f = zhash_next (cf->children);
-    }
-    *errnum = err;
+    if (flux_future_aux_get (f, "flux::counted"))
+        return (false);
+    if (flux_future_aux_set (f, "flux::counted", f, NULL) < 0)
+        return (false);
+    if (flux_future_get (f, NULL) < 0)
+        cf->errnum = errno;
+    if (++cf->count < (int)zhash_size (cf->children))
+        return (false);
+    *errnum = cf->errnum;
     return (true);
 }
 
@@ -83,7 +91,7 @@ static bool composite_is_ready (struct composite_future *cf,
         *errp = flux_future_get (f, NULL) < 0 ? errno : 0;
         return true;
     }
-    return wait_all_is_ready (cf, errp);
+    return wait_all_is_ready (cf, f, errp);
 }
 
 /*  Continuation for children of a composition future -- simply check
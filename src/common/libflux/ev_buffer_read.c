@@ -29,7 +29,12 @@ static bool data_to_read (struct ev_buffer_read *ebr, bool *is_eof)
             return true;
     }
     else {
-        if (flux_buffer_bytes (ebr->fb) > 0)
+        if (flux_buffer_bytes (ebr->fb) > ebr->low)
+            return true;
+        /* data below the watermark must still be flushed to the user
+         * once eof has been read */
+        else if (ebr->eof_read
+                 && flux_buffer_bytes (ebr->fb))
             return true;
     }
 
@@ -33,6 +33,8 @@ struct ev_buffer_read {
     bool             eof_read;  /* flag, if EOF on stream seen */
     bool             eof_sent;  /* flag, if EOF to user sent */
     bool             line;      /* flag, if line buffered */
+    int              low;       /* callback watermark (bytes), if not line
+                                 * buffered.  0 = callback on any data */
     void             *data;
 };
 
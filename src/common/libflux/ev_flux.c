@@ -94,6 +94,16 @@ void ev_flux_stop (struct ev_loop *loop, struct ev_flux *w)
     ev_idle_stop (loop, &w->idle_w);
 }
 
+/* Must be called while the watcher is stopped.
+ */
+void ev_flux_set_priority (struct ev_flux *w, int priority)
+{
+    ev_set_priority (&w->prepare_w, priority);
+    ev_set_priority (&w->check_w, priority);
+    ev_set_priority (&w->io_w, priority);
+    ev_set_priority (&w->idle_w, priority);
+}
+
 /*
  * vi:tabstop=4 shiftwidth=4 expandtab
  */
@@ -35,6 +35,8 @@ typedef struct {
     char appname[STDLOG_MAX_APPNAME + 1];
     char procid[STDLOG_MAX_PROCID + 1];
     char buf[FLUX_MAX_LOGBUF + 1];
+    struct stdlog_fixed fixed; /* cached header tail for the hot path */
+    bool fixed_valid;
     flux_log_f cb;
     void *cb_arg;
 } logctx_t;
@@ -78,15 +80,19 @@ static logctx_t *getctx (flux_t *h)
 void flux_log_set_appname (flux_t *h, const char *s)
 {
     logctx_t *ctx = getctx (h);
-    if (ctx)
+    if (ctx) {
         snprintf (ctx->appname, sizeof (ctx->appname), "%s", s);
+        ctx->fixed_valid = false;
+    }
 }
 
 void flux_log_set_procid (flux_t *h, const char *s)
 {
     logctx_t *ctx = getctx (h);
-    if (ctx)
+    if (ctx) {
         snprintf (ctx->procid, sizeof (ctx->procid), "%s", s);
+        ctx->fixed_valid = false;
+    }
 }
 
 
@@ -129,8 +135,6 @@ int flux_vlog (flux_t *h, int level, const char *fmt, va_list ap)
     uint32_t rank;
     int len;
     char timestamp[WALLCLOCK_MAXLEN];
-    char hostname[STDLOG_MAX_HOSTNAME + 1];
-    struct stdlog_header hdr;
     char *xtra = NULL;
 
     if (!h) {
@@ -148,19 +152,32 @@ int flux_vlog (flux_t *h, int level, const char *fmt, va_list ap)
         goto fatal;
     }
 
-    stdlog_init (&hdr);
-    hdr.pri = STDLOG_PRI (level, LOG_USER);
-    if (wallclock_get_zulu (timestamp, sizeof (timestamp)) >= 0)
-        hdr.timestamp = timestamp;
-    if (flux_get_rank (h, &rank) == 0) {
-        snprintf (hostname, sizeof (hostname), "%" PRIu32, rank);
-        hdr.hostname = hostname;
+    /* hostname (rank), appname, and procid rarely change: render them
+     * once and reuse the result, so each log call only formats the
+     * priority, timestamp, and message into ctx->buf.
+     * The cache is invalidated by the appname/procid setters and not
+     * primed until the rank is known.
+     */
+    if (!ctx->fixed_valid) {
+        char hostname[STDLOG_MAX_HOSTNAME + 1];
+        const char *host = STDLOG_NILVALUE;
+        bool valid = false;
+        if (flux_get_rank (h, &rank) == 0) {
+            snprintf (hostname, sizeof (hostname), "%" PRIu32, rank);
+            host = hostname;
+            valid = true;
+        }
+        if (stdlog_fixed_init (&ctx->fixed, host, ctx->appname,
+                               ctx->procid, STDLOG_NILVALUE) < 0)
+            goto fatal;
+        ctx->fixed_valid = valid;
     }
-    hdr.appname = ctx->appname;
-    hdr.procid = ctx->procid;
+    if (wallclock_get_zulu (timestamp, sizeof (timestamp)) < 0)
+        snprintf (timestamp, sizeof (timestamp), "%s", STDLOG_NILVALUE);
 
-    len = stdlog_vencodef (ctx->buf, sizeof (ctx->buf), &hdr,
-                           STDLOG_NILVALUE, fmt, ap);
+    len = stdlog_vencode_fast (ctx->buf, sizeof (ctx->buf), &ctx->fixed,
+                               STDLOG_PRI (level, LOG_USER), timestamp,
+                               fmt, ap);
     if (len >= sizeof (ctx->buf))
         len = sizeof (ctx->buf);
     /* If log message contains multiple lines, log the first
@@ -33,6 +33,7 @@
 #include "barrier.h"
 #include "buffer.h"
 #include "service.h"
+#include "metrics.h"
 #include "version.h"
 #include "plugin.h"
 
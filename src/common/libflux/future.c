@@ -64,8 +64,23 @@ struct flux_future {
     zlist_t *queue;
     flux_future_t *embed;
     int refcount;
+    flux_future_t *pool_next;
 };
 
+/* Chained async operations (e.g. libkvs lookups) create and destroy
+ * futures at a high rate.  Recycle the bare struct through a
+ * thread-local freelist, like the message pool in message.c.  Aux
+ * items, contexts, and results hold external resources and are always
+ * freed on destroy; a recycled struct is zeroed before reuse so
+ * semantics match calloc.
+ */
+#define FUTURE_POOL_MAX 256
+
+static __thread struct future_pool {
+    flux_future_t *head;
+    int count;
+} future_pool;
+
 static void check_cb (flux_reactor_t *r, flux_watcher_t *w,
                       int revents, void *arg);
 static void now_timer_cb (flux_reactor_t *r, flux_watcher_t *w,
@@ -304,7 +319,13 @@ void flux_future_destroy (flux_future_t *f)
         then_context_destroy (f->then);
         zlist_destroy (&f->queue);
         flux_decref (f->h);
-        free (f);
+        if (future_pool.count < FUTURE_POOL_MAX) {
+            f->pool_next = future_pool.head;
+            future_pool.head = f;
+            future_pool.count++;
+        }
+        else
+            free (f);
         errno = saved_errno;
     }
 }
@@ -313,8 +334,14 @@ void flux_future_destroy (flux_future_t *f)
  */
 flux_future_t *flux_future_create (flux_future_init_f cb, void *arg)
 {
-    flux_future_t *f = calloc (1, sizeof (*f));
-    if (!f) {
+    flux_future_t *f;
+
+    if ((f = future_pool.head)) {
+        future_pool.head = f->pool_next;
+        future_pool.count--;
+        memset (f, 0, sizeof (*f));
+    }
+    else if (!(f = calloc (1, sizeof (*f)))) {
         errno = ENOMEM;
         goto error;
     }
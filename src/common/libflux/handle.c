@@ -194,7 +194,8 @@ static char *find_file (const char *name, const char *searchpath)
 {
     char *path;
     zlist_t *l;
-    if (!(l = dirwalk_find (searchpath, DIRWALK_REALPATH, name, 1, NULL, NULL)))
+    if (!(l = dirwalk_find (searchpath, DIRWALK_REALPATH | DIRWALK_NO_STAT,
+                            name, 1, NULL, NULL)))
         return NULL;
     path = zlist_pop (l);
     zlist_destroy (&l);
@@ -351,6 +352,13 @@ flux_t *flux_clone (flux_t *orig)
     h->parent = flux_incref (orig);
     h->usecount = 1;
     h->flags = orig->flags | FLUX_O_CLONE;
+    /* Allow the clone's dispatcher to find the parent's (see
+     * dispatch_message_parent() in msg_handler.c).
+     */
+    if (flux_aux_set (h, "flux::parent", orig, NULL) < 0) {
+        flux_handle_destroy (h);
+        return NULL;
+    }
     return h;
 nomem:
     free (h);
@@ -13,9 +13,13 @@
 #endif
 #include <string.h>
 #include <errno.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
 
 #include "event.h"
 #include "message.h"
+#include "heartbeat.h"
 
 
 flux_msg_t *flux_heartbeat_encode (int epoch)
@@ -43,6 +47,46 @@ done:
     return rc;
 }
 
+double flux_heartbeat_jitter (double interval)
+{
+    static double fraction = -1.;
+
+    if (fraction < 0.) {
+        struct timespec ts;
+        uint32_t x;
+
+        clock_gettime (CLOCK_MONOTONIC, &ts);
+        x = (uint32_t)getpid () ^ (uint32_t)ts.tv_nsec;
+        x ^= x << 13;   /* xorshift32 */
+        x ^= x >> 17;
+        x ^= x << 5;
+        fraction = (double)(x % 10000) / 10000.;
+    }
+    if (interval < 0.)
+        interval = 0.;
+    return interval * fraction;
+}
+
+flux_watcher_t *flux_heartbeat_timer_create (flux_t *h,
+                                             double interval,
+                                             flux_watcher_f cb,
+                                             void *arg)
+{
+    flux_reactor_t *r;
+
+    if (!h || interval <= 0. || !cb) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(r = flux_get_reactor (h)))
+        return NULL;
+    return flux_timer_watcher_create (r,
+                                      flux_heartbeat_jitter (interval),
+                                      interval,
+                                      cb,
+                                      arg);
+}
+
 /*
  * vi:tabstop=4 shiftwidth=4 expandtab
  */
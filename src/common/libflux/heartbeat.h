@@ -12,6 +12,8 @@
 #define _FLUX_CORE_HEARTBEAT
 
 #include "message.h"
+#include "handle.h"
+#include "reactor.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -20,6 +22,24 @@ extern "C" {
 flux_msg_t *flux_heartbeat_encode (int epoch);
 int flux_heartbeat_decode (const flux_msg_t *msg, int *epoch);
 
+/* Return a stable pseudo-random offset in [0, interval) seconds.
+ * The offset is computed once per process, so callers that size
+ * periodic work off the heartbeat interval are spread across it
+ * rather than waking in lockstep on every rank.
+ */
+double flux_heartbeat_jitter (double interval);
+
+/* Create a repeating reactor timer with period 'interval' seconds
+ * whose initial expiration is offset by flux_heartbeat_jitter (interval).
+ * Intended for heartbeat-paced maintenance that need not be
+ * synchronized with the actual hb event.
+ * The caller must start the watcher, and destroy it when done.
+ */
+flux_watcher_t *flux_heartbeat_timer_create (flux_t *h,
+                                             double interval,
+                                             flux_watcher_f cb,
+                                             void *arg);
+
 #ifdef __cplusplus
 }
 #endif
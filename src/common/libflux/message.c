@@ -47,8 +47,26 @@ struct flux_msg {
     char *lasterr;
     struct aux_item *aux;
     int refcount;
+    flux_msg_t *pool_next;
 };
 
+/* Per-thread pool of recycled messages.  Brokers create and destroy
+ * messages at a high rate, and the struct flux_msg + zmsg_t container
+ * allocations dominate; recycling them through a thread-local freelist
+ * avoids both the mallocs and allocator lock contention between handle
+ * threads.  The zmsg_t is retained empty (its internal frame list,
+ * including any grown route stack capacity, stays allocated); frame
+ * data buffers are owned by czmq and are always freed on destroy.
+ */
+#define MSGPOOL_MAX 1024
+
+static __thread struct msgpool {
+    flux_msg_t *head;
+    int count;
+    uint64_t hits;
+    uint64_t misses;
+} msgpool;
+
 /* Begin manual codec
  * PROTO consists of 4 byte prelude followed by a fixed length
  * array of u32's in network byte order.
@@ -185,12 +203,43 @@ static flux_msg_t *flux_msg_create_common (void)
 {
     flux_msg_t *msg;
 
-    if (!(msg = calloc (1, sizeof (*msg))))
-        return NULL;
+    if ((msg = msgpool.head)) {
+        msgpool.head = msg->pool_next;
+        msgpool.count--;
+        msgpool.hits++;
+        msg->pool_next = NULL;
+    }
+    else {
+        if (!(msg = calloc (1, sizeof (*msg))))
+            return NULL;
+        msgpool.misses++;
+    }
     msg->refcount = 1;
     return msg;
 }
 
+/* Ensure 'msg' has a zmsg container, reusing one retained from the
+ * pool if present.
+ */
+static int msg_zmsg_init (flux_msg_t *msg)
+{
+    if (!msg->zmsg && !(msg->zmsg = zmsg_new ())) {
+        errno = ENOMEM;
+        return -1;
+    }
+    return 0;
+}
+
+void flux_msg_pool_stats (int *countp, uint64_t *hitsp, uint64_t *missesp)
+{
+    if (countp)
+        *countp = msgpool.count;
+    if (hitsp)
+        *hitsp = msgpool.hits;
+    if (missesp)
+        *missesp = msgpool.misses;
+}
+
 flux_msg_t *flux_msg_create (int type)
 {
     uint8_t proto[PROTO_SIZE];
@@ -203,10 +252,8 @@ flux_msg_t *flux_msg_create (int type)
         errno = EINVAL;
         goto error;
     }
-    if (!(msg->zmsg = zmsg_new ())) {
-        errno = ENOMEM;
+    if (msg_zmsg_init (msg) < 0)
         goto error;
-    }
     if (zmsg_addmem (msg->zmsg, proto, PROTO_SIZE) < 0)
         goto error;
     return msg;
@@ -220,10 +267,24 @@ void flux_msg_destroy (flux_msg_t *msg)
     if (msg && --msg->refcount == 0) {
         int saved_errno = errno;
         json_decref (msg->json);
-        zmsg_destroy (&msg->zmsg);
+        msg->json = NULL;
         aux_destroy (&msg->aux);
         free (msg->lasterr);
-        free (msg);
+        msg->lasterr = NULL;
+        if (msgpool.count < MSGPOOL_MAX) {
+            if (msg->zmsg) {
+                zframe_t *zf;
+                while ((zf = zmsg_pop (msg->zmsg)))
+                    zframe_destroy (&zf);
+            }
+            msg->pool_next = msgpool.head;
+            msgpool.head = msg;
+            msgpool.count++;
+        }
+        else {
+            zmsg_destroy (&msg->zmsg);
+            free (msg);
+        }
         errno = saved_errno;
     }
 }
@@ -323,6 +384,45 @@ nospace:
     return -1;
 }
 
+int flux_msg_encode_iovec (const flux_msg_t *msg,
+                           uint8_t *pfx, size_t pfxsize,
+                           struct iovec *iov, int maxiov)
+{
+    zframe_t *zf;
+    size_t pfxused = 0;
+    int niov = 0;
+
+    if (!msg || !pfx || !iov) {
+        errno = EINVAL;
+        return -1;
+    }
+    zf = zmsg_first (msg->zmsg);
+    while (zf) {
+        size_t n = zframe_size (zf);
+        size_t plen = n < 0xff ? 1 : 5;
+
+        if (niov + 2 > maxiov || pfxused + plen > pfxsize) {
+            errno = EINVAL;
+            return -1;
+        }
+        if (n < 0xff)
+            pfx[pfxused] = (uint8_t)n;
+        else {
+            pfx[pfxused] = 0xff;
+            *(uint32_t *)&pfx[pfxused + 1] = htonl (n);
+        }
+        iov[niov].iov_base = &pfx[pfxused];
+        iov[niov].iov_len = plen;
+        niov++;
+        iov[niov].iov_base = zframe_data (zf);
+        iov[niov].iov_len = n;
+        niov++;
+        pfxused += plen;
+        zf = zmsg_next (msg->zmsg);
+    }
+    return niov;
+}
+
 flux_msg_t *flux_msg_decode (const void *buf, size_t size)
 {
     flux_msg_t *msg;
@@ -331,8 +431,8 @@ flux_msg_t *flux_msg_decode (const void *buf, size_t size)
 
     if (!(msg = flux_msg_create_common ()))
         return NULL;
-    if (!(msg->zmsg = zmsg_new ()))
-        goto nomem;
+    if (msg_zmsg_init (msg) < 0)
+        goto error;
     while (p - (uint8_t *)buf < size) {
         size_t n = *p++;
         if (n == 0xff) {
@@ -386,7 +486,7 @@ int flux_msg_set_flags (flux_msg_t *msg, uint8_t fl)
     const uint8_t valid_flags = FLUX_MSGFLAG_TOPIC | FLUX_MSGFLAG_PAYLOAD
                               | FLUX_MSGFLAG_ROUTE | FLUX_MSGFLAG_UPSTREAM
                               | FLUX_MSGFLAG_PRIVATE | FLUX_MSGFLAG_STREAMING
-                              | FLUX_MSGFLAG_NORESPONSE;
+                              | FLUX_MSGFLAG_NORESPONSE | FLUX_MSGFLAG_CONTROL;
 
     if (!msg || fl & ~valid_flags || ((fl & FLUX_MSGFLAG_STREAMING)
                                    && (fl & FLUX_MSGFLAG_NORESPONSE)) != 0) {
@@ -471,6 +571,24 @@ bool flux_msg_is_noresponse (const flux_msg_t *msg)
     return (flags & FLUX_MSGFLAG_NORESPONSE) ? true : false;
 }
 
+int flux_msg_set_control (flux_msg_t *msg)
+{
+    uint8_t flags;
+    if (flux_msg_get_flags (msg, &flags) < 0)
+        return -1;
+    if (flux_msg_set_flags (msg, flags | FLUX_MSGFLAG_CONTROL) < 0)
+        return -1;
+    return 0;
+}
+
+bool flux_msg_is_control (const flux_msg_t *msg)
+{
+    uint8_t flags;
+    if (flux_msg_get_flags (msg, &flags) < 0)
+        return false;
+    return (flags & FLUX_MSGFLAG_CONTROL) ? true : false;
+}
+
 int flux_msg_set_userid (flux_msg_t *msg, uint32_t userid)
 {
     zframe_t *zf;
@@ -1183,7 +1301,16 @@ int flux_msg_vpack (flux_msg_t *msg, const char *fmt, va_list ap)
         goto error;
     }
     free (json_str);
-    json_decref (json);
+    /* Retain the tree just built as the cached json object (set_payload
+     * above invalidated any stale cache), so unpacking this message
+     * does not re-parse the payload.  This makes pack-then-unpack hot
+     * paths (e.g. a service examining a request it is forwarding, or
+     * self-delivered events) jansson-parse free.
+     * N.B. objects packed by reference (o/O) must not be modified by
+     * the caller afterwards, per the existing rule that a message's
+     * content is immutable once set.
+     */
+    msg->json = json;
     return 0;
 error_inval:
     errno = EINVAL;
@@ -1464,8 +1591,8 @@ flux_msg_t *flux_msg_copy (const flux_msg_t *msg, bool payload)
     }
     if (!(cpy = flux_msg_create_common ()))
         return NULL;
-    if (!(cpy->zmsg = zmsg_new ()))
-        goto nomem;
+    if (msg_zmsg_init (cpy) < 0)
+        goto error;
 
     /* Copy frames from 'msg' to 'cpy'.
      * 'count' indexes frames from 0 to zmsg_size (msg) - 1.
@@ -1614,6 +1741,7 @@ flux_msg_t *flux_msg_recvzsock (void *sock)
         errno = ENOMEM;
         return NULL;
     }
+    zmsg_destroy (&msg->zmsg); /* discard container retained by pool */
     msg->zmsg = zmsg;
     return msg;
 }
@@ -16,6 +16,7 @@
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/uio.h>
 #include "types.h"
 
 #ifdef __cplusplus
@@ -41,6 +42,8 @@ enum {
     FLUX_MSGFLAG_UPSTREAM   = 0x10, /* request nodeid is sender (route away) */
     FLUX_MSGFLAG_PRIVATE    = 0x20, /* private to instance owner and sender */
     FLUX_MSGFLAG_STREAMING  = 0x40, /* request/response is streaming RPC */
+    FLUX_MSGFLAG_CONTROL    = 0x80, /* latency-sensitive; may bypass queued
+                                     * bulk data on a connection */
 };
 
 /* N.B. FLUX_NODEID_UPSTREAM should be used in the RPC interface only.
@@ -116,10 +119,29 @@ void flux_msg_decref (const flux_msg_t *msg);
 size_t flux_msg_encode_size (const flux_msg_t *msg);
 int flux_msg_encode (const flux_msg_t *msg, void *buf, size_t size);
 
+/* Fill 'iov' (capacity 'maxiov' entries) with the encoded wire
+ * representation of 'msg' without copying frame data.  Each frame
+ * contributes two entries: a length prefix, written into caller-supplied
+ * scratch space 'pfx' of size 'pfxsize', and the frame data itself,
+ * referenced in place.  The iovec contents are byte-identical to
+ * flux_msg_encode() output and remain valid until 'msg' is modified
+ * or destroyed.  Returns the number of entries filled, or -1 with
+ * errno set if either caller-supplied array is too small.
+ */
+int flux_msg_encode_iovec (const flux_msg_t *msg,
+                           uint8_t *pfx, size_t pfxsize,
+                           struct iovec *iov, int maxiov);
+
 /* Get the number of message frames in 'msg'.
  */
 int flux_msg_frames (const flux_msg_t *msg);
 
+/* Get statistics for the calling thread's message recycling pool:
+ * current pool size, and the number of creates satisfied from the
+ * pool (hits) vs. from the heap (misses).  Any pointer may be NULL.
+ */
+void flux_msg_pool_stats (int *count, uint64_t *hits, uint64_t *misses);
+
 /* Decode a flux_msg_t from buffer.
  * Returns message on success, NULL on failure with errno set.
  * Caller must destroy message with flux_msg_destroy().
@@ -163,6 +185,14 @@ bool flux_msg_is_streaming (const flux_msg_t *msg);
 int flux_msg_set_noresponse (flux_msg_t *msg);
 bool flux_msg_is_noresponse (const flux_msg_t *msg);
 
+/* Get/set control flag.
+ * A small, latency-sensitive message (e.g. cancel, disconnect, or their
+ * responses) may set this flag to bypass queued bulk data on a connection.
+ * Only set it where ordering relative to other traffic does not matter.
+ */
+int flux_msg_set_control (flux_msg_t *msg);
+bool flux_msg_is_control (const flux_msg_t *msg);
+
 /* Get/set/compare message topic string.
  * set adds/deletes/replaces topic frame as needed.
  */
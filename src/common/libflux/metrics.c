@@ -0,0 +1,314 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <string.h>
+#include <errno.h>
+#include <czmq.h>
+#include <jansson.h>
+
+#include "handle.h"
+#include "message.h"
+#include "msg_handler.h"
+#include "request.h"
+#include "response.h"
+#include "flog.h"
+#include "metrics.h"
+
+#include "src/common/libutil/tstat.h"
+#include "src/common/libutil/xzmalloc.h"
+
+enum metric_type {
+    METRIC_COUNTER = 1,
+    METRIC_GAUGE = 2,
+    METRIC_HISTOGRAM = 3,
+};
+
+struct metric {
+    enum metric_type type;
+    uint64_t count;                 /* counter */
+    double value;                   /* gauge */
+    tstat_t ts;                     /* histogram */
+    flux_metrics_counter_f counter_cb;
+    flux_metrics_gauge_f gauge_cb;
+    void *cb_arg;
+};
+
+struct flux_metrics {
+    char *prefix;
+    zhash_t *metrics;
+    flux_msg_handler_t *mh;
+};
+
+static void metric_destroy (void *arg)
+{
+    free (arg);
+}
+
+/* Look up 'name', creating it with 'type' if missing.
+ * Returns NULL with errno set on alloc failure or type mismatch.
+ */
+static struct metric *metric_get (flux_metrics_t *m, const char *name,
+                                  enum metric_type type)
+{
+    struct metric *me;
+
+    if (!m || !name) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(me = zhash_lookup (m->metrics, name))) {
+        me = xzmalloc (sizeof (*me));
+        me->type = type;
+        if (zhash_insert (m->metrics, name, me) < 0) {
+            free (me);
+            errno = ENOMEM;
+            return NULL;
+        }
+        zhash_freefn (m->metrics, name, metric_destroy);
+    }
+    else if (me->type != type) {
+        errno = EINVAL;
+        return NULL;
+    }
+    return me;
+}
+
+flux_metrics_t *flux_metrics_create (const char *prefix)
+{
+    flux_metrics_t *m;
+
+    if (!prefix || strlen (prefix) == 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+    m = xzmalloc (sizeof (*m));
+    m->prefix = xstrdup (prefix);
+    if (!(m->metrics = zhash_new ())) {
+        flux_metrics_destroy (m);
+        errno = ENOMEM;
+        return NULL;
+    }
+    return m;
+}
+
+void flux_metrics_destroy (flux_metrics_t *m)
+{
+    if (m) {
+        int saved_errno = errno;
+        flux_msg_handler_destroy (m->mh);
+        zhash_destroy (&m->metrics);
+        free (m->prefix);
+        free (m);
+        errno = saved_errno;
+    }
+}
+
+int flux_metrics_counter_add (flux_metrics_t *m, const char *name, uint64_t n)
+{
+    struct metric *me;
+
+    if (!(me = metric_get (m, name, METRIC_COUNTER)))
+        return -1;
+    if (me->counter_cb) {
+        errno = EINVAL;
+        return -1;
+    }
+    me->count += n;
+    return 0;
+}
+
+int flux_metrics_counter_register (flux_metrics_t *m, const char *name,
+                                   flux_metrics_counter_f cb, void *arg)
+{
+    struct metric *me;
+
+    if (!cb) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!(me = metric_get (m, name, METRIC_COUNTER)))
+        return -1;
+    me->counter_cb = cb;
+    me->cb_arg = arg;
+    return 0;
+}
+
+int flux_metrics_counter_get (flux_metrics_t *m, const char *name,
+                              uint64_t *value)
+{
+    struct metric *me;
+
+    if (!value) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!(me = metric_get (m, name, METRIC_COUNTER)))
+        return -1;
+    *value = me->counter_cb ? me->counter_cb (me->cb_arg) : me->count;
+    return 0;
+}
+
+int flux_metrics_gauge_set (flux_metrics_t *m, const char *name, double value)
+{
+    struct metric *me;
+
+    if (!(me = metric_get (m, name, METRIC_GAUGE)))
+        return -1;
+    if (me->gauge_cb) {
+        errno = EINVAL;
+        return -1;
+    }
+    me->value = value;
+    return 0;
+}
+
+int flux_metrics_gauge_register (flux_metrics_t *m, const char *name,
+                                 flux_metrics_gauge_f cb, void *arg)
+{
+    struct metric *me;
+
+    if (!cb) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!(me = metric_get (m, name, METRIC_GAUGE)))
+        return -1;
+    me->gauge_cb = cb;
+    me->cb_arg = arg;
+    return 0;
+}
+
+int flux_metrics_gauge_get (flux_metrics_t *m, const char *name,
+                            double *value)
+{
+    struct metric *me;
+
+    if (!value) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!(me = metric_get (m, name, METRIC_GAUGE)))
+        return -1;
+    *value = me->gauge_cb ? me->gauge_cb (me->cb_arg) : me->value;
+    return 0;
+}
+
+int flux_metrics_observe (flux_metrics_t *m, const char *name, double value)
+{
+    struct metric *me;
+
+    if (!(me = metric_get (m, name, METRIC_HISTOGRAM)))
+        return -1;
+    tstat_push (&me->ts, value);
+    return 0;
+}
+
+/* Serialize one metric as a JSON object.  Callback-backed counters and
+ * gauges are sampled here, at scrape time.
+ */
+static json_t *metric_tojson (const char *name, struct metric *me)
+{
+    switch (me->type) {
+        case METRIC_COUNTER:
+            return json_pack ("{s:s s:s s:I}",
+                              "name", name,
+                              "type", "counter",
+                              "value", (json_int_t)(me->counter_cb
+                                  ? me->counter_cb (me->cb_arg) : me->count));
+        case METRIC_GAUGE:
+            return json_pack ("{s:s s:s s:f}",
+                              "name", name,
+                              "type", "gauge",
+                              "value", me->gauge_cb
+                                  ? me->gauge_cb (me->cb_arg) : me->value);
+        case METRIC_HISTOGRAM: {
+            json_t *h, *o;
+            if (!(h = tstat_tojson (&me->ts)))
+                return NULL;
+            if (!(o = json_pack ("{s:s s:s s:o}",
+                                 "name", name,
+                                 "type", "histogram",
+                                 "value", h))) {
+                json_decref (h);
+                return NULL;
+            }
+            return o;
+        }
+    }
+    errno = EINVAL;
+    return NULL;
+}
+
+static void metrics_request_cb (flux_t *h, flux_msg_handler_t *mh,
+                                const flux_msg_t *msg, void *arg)
+{
+    flux_metrics_t *m = arg;
+    json_t *metrics = NULL;
+    struct metric *me;
+
+    if (flux_request_decode (msg, NULL, NULL) < 0)
+        goto error;
+    if (!(metrics = json_array ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    me = zhash_first (m->metrics);
+    while (me) {
+        json_t *o;
+        if (!(o = metric_tojson (zhash_cursor (m->metrics), me))) {
+            errno = ENOMEM;
+            goto error;
+        }
+        if (json_array_append_new (metrics, o) < 0) {
+            json_decref (o);
+            errno = ENOMEM;
+            goto error;
+        }
+        me = zhash_next (m->metrics);
+    }
+    if (flux_respond_pack (h, msg, "{s:s s:O}",
+                           "prefix", m->prefix,
+                           "metrics", metrics) < 0)
+        flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+    json_decref (metrics);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+    json_decref (metrics);
+}
+
+int flux_metrics_service_register (flux_t *h, flux_metrics_t *m)
+{
+    struct flux_match match = FLUX_MATCH_REQUEST;
+    char *topic = NULL;
+
+    if (!h || !m || m->mh != NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+    topic = xasprintf ("%s.stats.metrics", m->prefix);
+    match.topic_glob = topic;
+    if (!(m->mh = flux_msg_handler_create (h, match, metrics_request_cb, m))) {
+        free (topic);
+        return -1;
+    }
+    flux_msg_handler_allow_rolemask (m->mh, FLUX_ROLE_ALL);
+    flux_msg_handler_start (m->mh);
+    free (topic);
+    return 0;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
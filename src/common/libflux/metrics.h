@@ -0,0 +1,74 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _FLUX_CORE_METRICS_H
+#define _FLUX_CORE_METRICS_H
+
+#include <stdint.h>
+
+#include "handle.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Typed metrics registry, replacing hand-rolled stats.get JSON.
+ *
+ * A service creates one registry and updates typed metrics through it:
+ *   counter    monotonically increasing uint64 (e.g. cache hits)
+ *   gauge      instantaneous double (e.g. entries, bytes, pressure)
+ *   histogram  value distribution: count/min/max/mean/stddev
+ *
+ * Counters and gauges may be backed by a callback sampled at scrape
+ * time, so a service can export existing struct members without
+ * maintaining a second copy.  Stored metrics are auto-created on
+ * first update; updating a name registered with a different type
+ * fails with EINVAL.
+ *
+ * flux_metrics_service_register() installs a "<prefix>.stats.metrics"
+ * request handler that returns every metric in one standard payload:
+ *   {"prefix":s "metrics":[{"name":s "type":s ...} ...]}
+ * so a scraper needs one RPC and no per-service parsing, and metric
+ * naming is uniform across services.
+ */
+
+typedef struct flux_metrics flux_metrics_t;
+
+typedef uint64_t (*flux_metrics_counter_f)(void *arg);
+typedef double (*flux_metrics_gauge_f)(void *arg);
+
+flux_metrics_t *flux_metrics_create (const char *prefix);
+void flux_metrics_destroy (flux_metrics_t *m);
+
+int flux_metrics_counter_add (flux_metrics_t *m, const char *name, uint64_t n);
+int flux_metrics_counter_register (flux_metrics_t *m, const char *name,
+                                   flux_metrics_counter_f cb, void *arg);
+int flux_metrics_counter_get (flux_metrics_t *m, const char *name,
+                              uint64_t *value);
+
+int flux_metrics_gauge_set (flux_metrics_t *m, const char *name, double value);
+int flux_metrics_gauge_register (flux_metrics_t *m, const char *name,
+                                 flux_metrics_gauge_f cb, void *arg);
+int flux_metrics_gauge_get (flux_metrics_t *m, const char *name,
+                            double *value);
+
+int flux_metrics_observe (flux_metrics_t *m, const char *name, double value);
+
+int flux_metrics_service_register (flux_t *h, flux_metrics_t *m);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_FLUX_CORE_METRICS_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -105,7 +105,8 @@ char *flux_modfind (const char *searchpath, const char *modname,
     ctx.cb = cb;
     ctx.arg = arg;
 
-    l = dirwalk_find (searchpath, 0, "*.so", 1, mod_find_f, &ctx);
+    l = dirwalk_find (searchpath, DIRWALK_NO_STAT, "*.so", 1,
+                      mod_find_f, &ctx);
     if (l) {
         result = zlist_pop (l);
         zlist_destroy (&l);
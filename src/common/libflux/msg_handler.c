@@ -33,6 +33,7 @@ struct dispatch {
     zhashx_t *handlers_rpc; // matchtag => response handler
     zhashx_t *handlers_method; // topic => request handler (non-glob only)
     flux_watcher_t *w;
+    int batch_limit;
     int running_count;
     int usecount;
     zlist_t *unmatched;
@@ -130,6 +131,7 @@ static struct dispatch *dispatch_get (flux_t *h)
             return NULL;
         memset (d, 0, sizeof (*d));
         d->usecount = 1;
+        d->batch_limit = 1;
         if (!(d->handlers = zlist_new ()))
             goto nomem;
         if (!(d->handlers_new = zlist_new ()))
@@ -273,6 +275,13 @@ static bool dispatch_message (struct dispatch *d,
         FOREACH_ZLIST (d->handlers, mh) {
             if (!mh->running)
                 continue;
+            /* Cheap typemask pre-filter using the already-decoded type,
+             * so handlers for other message types (e.g. event handlers
+             * while scanning a request) don't pay for a full
+             * flux_msg_cmp() including proto re-decode and topic match.
+             */
+            if (mh->match.typemask != 0 && !(type & mh->match.typemask))
+                continue;
             if (flux_msg_cmp (msg, mh->match)) {
                 call_handler (mh, msg);
                 if (type != FLUX_MSGTYPE_EVENT) {
@@ -325,19 +334,41 @@ done:
     return rc;
 }
 
-static void handle_cb (flux_reactor_t *r,
-                       flux_watcher_t *hw,
-                       int revents,
-                       void *arg)
+/* Try to dispatch a message to handlers registered on the clone's
+ * parent handle.  A request arriving on a cloned handle (e.g. the
+ * temporary dispatcher behind a blocking flux_future_get) may target
+ * a service registered on the parent - a self-directed RPC.  Running
+ * the parent's handler inline lets such an RPC complete within the
+ * blocking call instead of parking the request until the main reactor
+ * runs again.  Handlers see the parent handle, so responses flow
+ * normally.
+ * Returns true if the message was consumed.
+ */
+static bool dispatch_message_parent (struct dispatch *d,
+                                     const flux_msg_t *msg,
+                                     int type)
+{
+    flux_t *parent = flux_aux_get (d->h, "flux::parent");
+    struct dispatch *dp;
+
+    if (!parent || !(dp = flux_aux_get (parent, "flux::dispatch")))
+        return false;
+    if (transfer_items_zlist (dp->handlers_new, dp->handlers) < 0)
+        return false;
+    return dispatch_message (dp, msg, type);
+}
+
+/* Receive and dispatch one message, if one is queued.
+ * Returns 1 if a message was handled, 0 if there was nothing to do,
+ * or -1 on fatal error.
+ */
+static int dispatch_one (struct dispatch *d)
 {
-    struct dispatch *d = arg;
     flux_msg_t *msg = NULL;
     int rc = -1;
     int type;
     bool match;
 
-    if (revents & FLUX_POLLERR)
-        goto done;
     if (!(msg = flux_recv (d->h, FLUX_MATCH_ANY, FLUX_O_NONBLOCK))) {
         if (errno == EAGAIN && errno == EWOULDBLOCK)
             rc = 0; /* ignore spurious wakeup */
@@ -381,6 +412,15 @@ static void handle_cb (flux_reactor_t *r,
      */
     if (!match) {
         if ((flux_flags_get (d->h) & FLUX_O_CLONE)) {
+            /* Fast path for self-directed RPCs: dispatch unmatched
+             * requests to the parent's handlers inline.  Other types
+             * keep their park-and-requeue semantics.
+             */
+            if (type == FLUX_MSGTYPE_REQUEST
+                && dispatch_message_parent (d, msg, type)) {
+                rc = 1;
+                goto done;
+            }
             if (!d->unmatched && !(d->unmatched = zlist_new ())) {
                 errno = ENOMEM;
                 goto done;
@@ -418,13 +458,44 @@ static void handle_cb (flux_reactor_t *r,
             }
         }
     }
-    rc = 0;
+    rc = 1;
 done:
+    flux_msg_destroy (msg);
+    return rc;
+}
+
+static void handle_cb (flux_reactor_t *r,
+                       flux_watcher_t *hw,
+                       int revents,
+                       void *arg)
+{
+    struct dispatch *d = arg;
+    int i;
+    int rc = 0;
+
+    /* Drain up to batch_limit queued messages per watcher invocation,
+     * amortizing the reactor loop overhead across a burst.  The limit
+     * bounds how long other watchers can be starved; the default of 1
+     * preserves the historical one-message-per-loop behavior.
+     * Hold a dispatch reference since handlers may destroy their
+     * message handlers (and thus drop the usecount) while we loop.
+     */
+    dispatch_usecount_incr (d);
+    if (revents & FLUX_POLLERR)
+        rc = -1;
+    else {
+        for (i = 0; i < d->batch_limit; i++) {
+            if ((rc = dispatch_one (d)) <= 0)
+                break;
+            if (d->running_count == 0)
+                break; /* watcher was stopped by a handler */
+        }
+    }
     if (rc < 0) {
         flux_reactor_stop_error (r);
         FLUX_FATAL (d->h);
     }
-    flux_msg_destroy (msg);
+    dispatch_usecount_decr (d);
 }
 
 void flux_msg_handler_start (flux_msg_handler_t *mh)
@@ -626,6 +697,20 @@ void flux_msg_handler_delvec (flux_msg_handler_t *handlers[])
     }
 }
 
+int flux_dispatch_set_batch_limit (flux_t *h, int limit)
+{
+    struct dispatch *d;
+
+    if (!h || limit < 1) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!(d = dispatch_get (h)))
+        return -1;
+    d->batch_limit = limit;
+    return 0;
+}
+
 int flux_dispatch_requeue (flux_t *h)
 {
     struct dispatch *d;
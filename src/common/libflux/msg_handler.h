@@ -59,6 +59,13 @@ void flux_msg_handler_delvec (flux_msg_handler_t *msg_handlers[]);
  */
 int flux_dispatch_requeue (flux_t *h);
 
+/* Set the maximum number of queued messages dispatched per reactor
+ * loop iteration (default 1).  Raising the limit amortizes reactor
+ * overhead across message bursts, at the cost of delaying other
+ * watchers by up to 'limit' handler invocations.
+ */
+int flux_dispatch_set_batch_limit (flux_t *h, int limit);
+
 #ifdef __cplusplus
 }
 #endif
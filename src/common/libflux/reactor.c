@@ -29,11 +29,54 @@
 #include "src/common/libutil/ev_zmq.h"
 #include "src/common/libutil/log.h"
 #include "src/common/libutil/fdutils.h"
+#include "src/common/libutil/monotime.h"
+
+/* Watcher types, for attributing callback counts and time when
+ * profiling is enabled.  Custom watchers created directly with
+ * flux_watcher_create() are lumped under "other".
+ */
+enum {
+    WATCHER_HANDLE,
+    WATCHER_FD,
+    WATCHER_BUFFER_READ,
+    WATCHER_BUFFER_WRITE,
+    WATCHER_ZMQ,
+    WATCHER_TIMER,
+    WATCHER_PERIODIC,
+    WATCHER_PREPARE,
+    WATCHER_CHECK,
+    WATCHER_IDLE,
+    WATCHER_CHILD,
+    WATCHER_SIGNAL,
+    WATCHER_STAT,
+    WATCHER_OTHER,
+    WATCHER_TYPE_COUNT,
+};
+
+static const char *watcher_type_name[WATCHER_TYPE_COUNT] = {
+    "handle",
+    "fd",
+    "buffer-read",
+    "buffer-write",
+    "zmq",
+    "timer",
+    "periodic",
+    "prepare",
+    "check",
+    "idle",
+    "child",
+    "signal",
+    "stat",
+    "other",
+};
 
 struct flux_reactor {
     struct ev_loop *loop;
     int usecount;
     unsigned int errflag:1;
+    unsigned int profiling:1;
+    uint64_t calls[WATCHER_TYPE_COUNT];
+    double time[WATCHER_TYPE_COUNT];    /* cumulative callback seconds */
 };
 
 struct flux_watcher {
@@ -42,6 +85,7 @@ struct flux_watcher {
     void *arg;
     struct flux_watcher_ops *ops;
     void *data;
+    int type;
 };
 
 static void reactor_usecount_decr (flux_reactor_t *r)
@@ -127,6 +171,38 @@ int flux_reactor_run (flux_reactor_t *r, int flags)
     return (r->errflag ? -1 : count);
 }
 
+void flux_reactor_profile (flux_reactor_t *r, bool enable)
+{
+    if (r) {
+        if (enable && !r->profiling) {
+            memset (r->calls, 0, sizeof (r->calls));
+            memset (r->time, 0, sizeof (r->time));
+        }
+        r->profiling = enable ? 1 : 0;
+    }
+}
+
+int flux_reactor_stats_get (flux_reactor_t *r,
+                            struct flux_reactor_stats *stats,
+                            int *count)
+{
+    int i;
+    int n;
+
+    if (!r || !stats || !count || *count < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    n = *count < WATCHER_TYPE_COUNT ? *count : WATCHER_TYPE_COUNT;
+    for (i = 0; i < n; i++) {
+        stats[i].name = watcher_type_name[i];
+        stats[i].calls = r->calls[i];
+        stats[i].time = r->time[i];
+    }
+    *count = n;
+    return 0;
+}
+
 double flux_reactor_time (void)
 {
     return ev_time ();
@@ -194,6 +270,32 @@ static int libev_to_events (int events)
  ** Watchers
  **/
 
+/* Invoke the user callback for watcher 'w'.  When profiling is enabled,
+ * charge the callback count and elapsed time to the watcher's type.
+ * N.B. the callback is free to destroy 'w', so only 'r' (kept alive
+ * by the running reactor) may be referenced after it returns.
+ */
+static void watcher_call (struct ev_loop *loop,
+                          struct flux_watcher *w,
+                          int revents)
+{
+    flux_reactor_t *r = ev_userdata (loop);
+
+    if (!w->fn)
+        return;
+    if (r->profiling) {
+        int type = w->type;
+        struct timespec t0;
+
+        monotime (&t0);
+        r->calls[type]++;
+        w->fn (r, w, libev_to_events (revents), w->arg);
+        r->time[type] += monotime_since (t0) * 1E-3;
+    }
+    else
+        w->fn (r, w, libev_to_events (revents), w->arg);
+}
+
 flux_watcher_t *flux_watcher_create (flux_reactor_t *r,
                                      size_t data_size,
                                      struct flux_watcher_ops *ops,
@@ -207,6 +309,7 @@ flux_watcher_t *flux_watcher_create (flux_reactor_t *r,
     w->data = w + 1;
     w->fn = fun;
     w->arg = arg;
+    w->type = WATCHER_OTHER;
     reactor_usecount_incr (r);
     return w;
 }
@@ -241,6 +344,24 @@ void flux_watcher_stop (flux_watcher_t *w)
     }
 }
 
+void flux_watcher_set_priority (flux_watcher_t *w, int priority)
+{
+    if (w) {
+        if (w->ops->set_priority)
+            w->ops->set_priority (w, priority);
+    }
+}
+
+/* Shared set_priority op for watcher types whose implementation data
+ * begins with the libev watcher struct; ev_set_priority only touches
+ * the common libev watcher header.  Composite watcher types provide
+ * their own op so all constituent libev watchers are adjusted.
+ */
+static void watcher_set_ev_priority (flux_watcher_t *w, int priority)
+{
+    ev_set_priority ((ev_watcher *)w->data, priority);
+}
+
 void flux_watcher_destroy (flux_watcher_t *w)
 {
     if (w) {
@@ -294,15 +415,19 @@ static void handle_stop (flux_watcher_t *w)
 
 static void handle_cb (struct ev_loop *loop, struct ev_flux *fw, int revents)
 {
-    struct flux_watcher *w = fw->data;
-    if (w->fn)
-        w->fn (ev_userdata (loop), w, libev_to_events (revents), w->arg);
+    watcher_call (loop, fw->data, revents);
+}
+
+static void handle_set_priority (flux_watcher_t *w, int priority)
+{
+    ev_flux_set_priority ((struct ev_flux *)w->data, priority);
 }
 
 static struct flux_watcher_ops handle_watcher = {
     .start = handle_start,
     .stop = handle_stop,
     .destroy = NULL,
+    .set_priority = handle_set_priority,
 };
 
 flux_watcher_t *flux_handle_watcher_create (flux_reactor_t *r,
@@ -316,6 +441,7 @@ flux_watcher_t *flux_handle_watcher_create (flux_reactor_t *r,
     fw = flux_watcher_get_data (w);
     ev_flux_init (fw, handle_cb, h, events_to_libev (events) & ~EV_ERROR);
     fw->data = w;
+    w->type = WATCHER_HANDLE;
 
     return w;
 }
@@ -342,15 +468,14 @@ static void fd_stop (flux_watcher_t *w)
 
 static void fd_cb (struct ev_loop *loop, ev_io *iow, int revents)
 {
-    struct flux_watcher *w = iow->data;
-    if (w->fn)
-        w->fn (ev_userdata (loop), w, libev_to_events (revents), w->arg);
+    watcher_call (loop, iow->data, revents);
 }
 
 static struct flux_watcher_ops fd_watcher = {
     .start = fd_start,
     .stop = fd_stop,
-    .destroy = NULL
+    .destroy = NULL,
+    .set_priority = watcher_set_ev_priority,
 };
 
 flux_watcher_t *flux_fd_watcher_create (flux_reactor_t *r, int fd, int events,
@@ -364,6 +489,7 @@ flux_watcher_t *flux_fd_watcher_create (flux_reactor_t *r, int fd, int events,
     iow = flux_watcher_get_data (w);
     ev_io_init (iow, fd_cb, fd, events_to_libev (events) & ~EV_ERROR);
     iow->data = w;
+    w->type = WATCHER_FD;
 
     return w;
 }
@@ -400,9 +526,7 @@ static void buffer_read_cb (struct ev_loop *loop,
                             struct ev_buffer_read *ebr,
                             int revents)
 {
-    struct flux_watcher *w = ebr->data;
-    if (w->fn)
-        w->fn (ev_userdata (loop), w, libev_to_events (revents), w->arg);
+    watcher_call (loop, ebr->data, revents);
 }
 
 static struct flux_watcher_ops buffer_read_watcher = {
@@ -450,6 +574,7 @@ flux_watcher_t *flux_buffer_read_watcher_create (flux_reactor_t *r, int fd,
         ebr->line = true;
 
     ebr->data = w;
+    w->type = WATCHER_BUFFER_READ;
 
     return w;
 
@@ -465,6 +590,19 @@ flux_buffer_t *flux_buffer_read_watcher_get_buffer (flux_watcher_t *w)
     return NULL;
 }
 
+int flux_buffer_read_watcher_set_watermark (flux_watcher_t *w, int bytes)
+{
+    struct ev_buffer_read *ebr;
+
+    if (!w || bytes < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    ebr = w->data;
+    ebr->low = bytes;
+    return 0;
+}
+
 static void buffer_write_start (flux_watcher_t *w)
 {
     struct ev_buffer_write *ebw = (struct ev_buffer_write *)w->data;
@@ -487,9 +625,7 @@ static void buffer_write_cb (struct ev_loop *loop,
                              struct ev_buffer_write *ebw,
                              int revents)
 {
-    struct flux_watcher *w = ebw->data;
-    if (w->fn)
-        w->fn (ev_userdata (loop), w, libev_to_events (revents), w->arg);
+    watcher_call (loop, ebw->data, revents);
 }
 
 static struct flux_watcher_ops buffer_write_watcher = {
@@ -535,6 +671,7 @@ flux_watcher_t *flux_buffer_write_watcher_create (flux_reactor_t *r, int fd,
         goto cleanup;
 
     ebw->data = w;
+    w->type = WATCHER_BUFFER_WRITE;
 
     return w;
 
@@ -598,15 +735,19 @@ static void zmq_stop (flux_watcher_t *w)
 
 static void zmq_cb (struct ev_loop *loop, ev_zmq *pw, int revents)
 {
-    struct flux_watcher *w = pw->data;
-    if (w->fn)
-        w->fn (ev_userdata (loop), w, libev_to_events (revents), w->arg);
+    watcher_call (loop, pw->data, revents);
+}
+
+static void zmq_set_priority (flux_watcher_t *w, int priority)
+{
+    ev_zmq_set_priority ((ev_zmq *)w->data, priority);
 }
 
 static struct flux_watcher_ops zmq_watcher  = {
     .start = zmq_start,
     .stop = zmq_stop,
     .destroy = NULL,
+    .set_priority = zmq_set_priority,
 };
 
 flux_watcher_t *flux_zmq_watcher_create (flux_reactor_t *r,
@@ -621,6 +762,7 @@ flux_watcher_t *flux_zmq_watcher_create (flux_reactor_t *r,
     zw = flux_watcher_get_data (w);
     ev_zmq_init (zw, zmq_cb, zsock, events_to_libev (events) & ~EV_ERROR);
     zw->data = w;
+    w->type = WATCHER_ZMQ;
 
     return w;
 }
@@ -650,15 +792,14 @@ static void timer_stop (flux_watcher_t *w)
 
 static void timer_cb (struct ev_loop *loop, ev_timer *tw, int revents)
 {
-    struct flux_watcher *w = tw->data;
-    if (w->fn)
-        w->fn (ev_userdata (loop), w, libev_to_events (revents), w->arg);
+    watcher_call (loop, tw->data, revents);
 }
 
 static struct flux_watcher_ops timer_watcher = {
     .start = timer_start,
     .stop = timer_stop,
     .destroy = NULL,
+    .set_priority = watcher_set_ev_priority,
 };
 
 flux_watcher_t *flux_timer_watcher_create (flux_reactor_t *r,
@@ -676,6 +817,7 @@ flux_watcher_t *flux_timer_watcher_create (flux_reactor_t *r,
     tw = flux_watcher_get_data (w);
     ev_timer_init (tw, timer_cb, after, repeat);
     tw->data = w;
+    w->type = WATCHER_TIMER;
 
     return w;
 }
@@ -710,9 +852,7 @@ static void periodic_stop (flux_watcher_t *w)
 static void periodic_cb (struct ev_loop *loop, ev_periodic *pw, int revents)
 {
     struct f_periodic *fp = pw->data;
-    struct flux_watcher *w = fp->w;
-    if (w->fn)
-        fp->w->fn (ev_userdata (loop), w, libev_to_events (revents), w->arg);
+    watcher_call (loop, fp->w, revents);
 }
 
 static ev_tstamp periodic_reschedule_cb (ev_periodic *pw, ev_tstamp now)
@@ -734,10 +874,17 @@ static ev_tstamp periodic_reschedule_cb (ev_periodic *pw, ev_tstamp now)
     return rc;
 }
 
+static void periodic_set_priority (flux_watcher_t *w, int priority)
+{
+    struct f_periodic *fp = w->data;
+    ev_set_priority (&fp->evp, priority);
+}
+
 static struct flux_watcher_ops periodic_watcher = {
     .start = periodic_start,
     .stop = periodic_stop,
     .destroy = NULL,
+    .set_priority = periodic_set_priority,
 };
 
 flux_watcher_t *flux_periodic_watcher_create (flux_reactor_t *r,
@@ -761,6 +908,7 @@ flux_watcher_t *flux_periodic_watcher_create (flux_reactor_t *r,
 
     ev_periodic_init (&fp->evp, periodic_cb, offset, interval,
                       reschedule_cb ? periodic_reschedule_cb : NULL);
+    w->type = WATCHER_PERIODIC;
 
     return w;
 }
@@ -807,15 +955,14 @@ static void prepare_stop (flux_watcher_t *w)
 
 static void prepare_cb (struct ev_loop *loop, ev_prepare *pw, int revents)
 {
-    struct flux_watcher *w = pw->data;
-    if (w->fn)
-        w->fn (ev_userdata (loop), w, libev_to_events (revents), w->arg);
+    watcher_call (loop, pw->data, revents);
 }
 
 static struct flux_watcher_ops prepare_watcher = {
     .start = prepare_start,
     .stop = prepare_stop,
     .destroy = NULL,
+    .set_priority = watcher_set_ev_priority,
 };
 
 flux_watcher_t *flux_prepare_watcher_create (flux_reactor_t *r,
@@ -829,6 +976,7 @@ flux_watcher_t *flux_prepare_watcher_create (flux_reactor_t *r,
     pw = flux_watcher_get_data (w);
     ev_prepare_init (pw, prepare_cb);
     pw->data = w;
+    w->type = WATCHER_PREPARE;
 
     return w;
 }
@@ -848,15 +996,14 @@ static void check_stop (flux_watcher_t *w)
 
 static void check_cb (struct ev_loop *loop, ev_check *cw, int revents)
 {
-    struct flux_watcher *w = cw->data;
-    if (w->fn)
-        w->fn (ev_userdata (loop), w, libev_to_events (revents), w->arg);
+    watcher_call (loop, cw->data, revents);
 }
 
 static struct flux_watcher_ops check_watcher = {
     .start = check_start,
     .stop = check_stop,
     .destroy = NULL,
+    .set_priority = watcher_set_ev_priority,
 };
 
 flux_watcher_t *flux_check_watcher_create (flux_reactor_t *r,
@@ -870,6 +1017,7 @@ flux_watcher_t *flux_check_watcher_create (flux_reactor_t *r,
     cw = flux_watcher_get_data (w);
     ev_check_init (cw, check_cb);
     cw->data = w;
+    w->type = WATCHER_CHECK;
 
     return w;
 }
@@ -889,15 +1037,14 @@ static void idle_stop (flux_watcher_t *w)
 
 static void idle_cb (struct ev_loop *loop, ev_idle *iw, int revents)
 {
-    struct flux_watcher *w = iw->data;
-    if (w->fn)
-        w->fn (ev_userdata (loop), w, libev_to_events (revents), w->arg);
+    watcher_call (loop, iw->data, revents);
 }
 
 static struct flux_watcher_ops idle_watcher = {
     .start = idle_start,
     .stop = idle_stop,
     .destroy = NULL,
+    .set_priority = watcher_set_ev_priority,
 };
 
 flux_watcher_t *flux_idle_watcher_create (flux_reactor_t *r,
@@ -911,6 +1058,7 @@ flux_watcher_t *flux_idle_watcher_create (flux_reactor_t *r,
     iw = flux_watcher_get_data (w);
     ev_idle_init (iw, idle_cb);
     iw->data = w;
+    w->type = WATCHER_IDLE;
 
     return w;
 }
@@ -930,15 +1078,14 @@ static void child_stop (flux_watcher_t *w)
 
 static void child_cb (struct ev_loop *loop, ev_child *cw, int revents)
 {
-    struct flux_watcher *w = cw->data;
-    if (w->fn)
-        w->fn (ev_userdata (loop), w, libev_to_events (revents), w->arg);
+    watcher_call (loop, cw->data, revents);
 }
 
 static struct flux_watcher_ops child_watcher = {
     .start = child_start,
     .stop = child_stop,
     .destroy = NULL,
+    .set_priority = watcher_set_ev_priority,
 };
 
 
@@ -958,6 +1105,7 @@ flux_watcher_t *flux_child_watcher_create (flux_reactor_t *r,
     cw = flux_watcher_get_data (w);
     ev_child_init (cw, child_cb, pid, trace ? 1 : 0);
     cw->data = w;
+    w->type = WATCHER_CHILD;
 
     return w;
 }
@@ -997,15 +1145,14 @@ static void signal_stop (flux_watcher_t *w)
 
 static void signal_cb (struct ev_loop *loop, ev_signal *sw, int revents)
 {
-    struct flux_watcher *w = sw->data;
-    if (w->fn)
-        w->fn (ev_userdata (loop), w, libev_to_events (revents), w->arg);
+    watcher_call (loop, sw->data, revents);
 }
 
 static struct flux_watcher_ops signal_watcher = {
     .start = signal_start,
     .stop = signal_stop,
     .destroy = NULL,
+    .set_priority = watcher_set_ev_priority,
 };
 
 flux_watcher_t *flux_signal_watcher_create (flux_reactor_t *r, int signum,
@@ -1019,6 +1166,7 @@ flux_watcher_t *flux_signal_watcher_create (flux_reactor_t *r, int signum,
     sw = flux_watcher_get_data (w);
     ev_signal_init (sw, signal_cb, signum);
     sw->data = w;
+    w->type = WATCHER_SIGNAL;
 
     return w;
 }
@@ -1048,15 +1196,14 @@ static void stat_stop (flux_watcher_t *w)
 
 static void stat_cb (struct ev_loop *loop, ev_stat *sw, int revents)
 {
-    struct flux_watcher *w = sw->data;
-    if (w->fn)
-        w->fn (ev_userdata (loop), w, libev_to_events (revents), w->arg);
+    watcher_call (loop, sw->data, revents);
 }
 
 static struct flux_watcher_ops stat_watcher = {
     .start = stat_start,
     .stop = stat_stop,
     .destroy = NULL,
+    .set_priority = watcher_set_ev_priority,
 };
 
 flux_watcher_t *flux_stat_watcher_create (flux_reactor_t *r,
@@ -1071,6 +1218,7 @@ flux_watcher_t *flux_stat_watcher_create (flux_reactor_t *r,
     sw = flux_watcher_get_data (w);
     ev_stat_init (sw, stat_cb, path, interval);
     sw->data = w;
+    w->type = WATCHER_STAT;
 
     return w;
 }
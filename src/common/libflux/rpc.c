@@ -16,6 +16,7 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <stdarg.h>
+#include <string.h>
 #if HAVE_CALIPER
 #include <caliper/cali.h>
 #include <sys/syscall.h>
@@ -37,6 +38,8 @@ struct flux_rpc {
     int flags;
     flux_future_t *f;
     bool sent;
+    char *topic;        // saved for streaming RPCs (flux_rpc_credit)
+    uint32_t nodeid;    // ditto
 };
 
 static void log_matchtag_leak (flux_t *h, const char *msg, int matchtag)
@@ -86,6 +89,7 @@ static void rpc_destroy (struct flux_rpc *rpc)
                                     ? "unterminated streaming RPC"
                                     : "unfulfilled RPC",
                                rpc->matchtag);
+        free (rpc->topic);
         free (rpc);
     }
 }
@@ -257,8 +261,18 @@ static flux_future_t *flux_rpc_message_nocopy (flux_t *h,
         if (flux_get_rank (h, &nodeid) < 0)
             goto error;
     }
-    if ((flags & FLUX_RPC_STREAMING))
+    if ((flags & FLUX_RPC_STREAMING)) {
+        const char *topic;
+        /* Save topic and destination so flux_rpc_credit() can address
+         * the producing service later.
+         */
+        if (flux_msg_get_topic (msg, &topic) < 0)
+            goto error;
+        if (!(rpc->topic = strdup (topic)))
+            goto error;
         msgflags |= FLUX_MSGFLAG_STREAMING;
+    }
+    rpc->nodeid = nodeid;
     if ((flags & FLUX_RPC_NORESPONSE))
         msgflags |= FLUX_MSGFLAG_NORESPONSE;
     if (flux_msg_set_flags (msg, msgflags) < 0)
@@ -412,6 +426,48 @@ uint32_t flux_rpc_get_matchtag (flux_future_t *f)
     return rpc ? rpc->matchtag : FLUX_MATCHTAG_NONE;
 }
 
+int flux_rpc_credit (flux_future_t *f, int credits)
+{
+    struct flux_rpc *rpc;
+    flux_future_t *f2;
+    const char *p;
+    int len;
+    char *topic;
+    int saved_errno;
+
+    if (!f || credits <= 0
+        || !(rpc = flux_future_aux_get (f, "flux::rpc"))
+        || !(rpc->flags & FLUX_RPC_STREAMING)
+        || rpc->matchtag == FLUX_MATCHTAG_NONE) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* The credit request is addressed to "<service>.credit", where
+     * <service> is the streaming RPC topic minus its final word.
+     */
+    if ((p = strrchr (rpc->topic, '.')))
+        len = p - rpc->topic;
+    else
+        len = strlen (rpc->topic);
+    if (asprintf (&topic, "%.*s.credit", len, rpc->topic) < 0)
+        return -1;
+    if (!(f2 = flux_rpc_pack (flux_future_get_flux (f),
+                              topic,
+                              rpc->nodeid,
+                              FLUX_RPC_NORESPONSE,
+                              "{s:i s:i}",
+                              "matchtag", (int)rpc->matchtag,
+                              "credits", credits))) {
+        saved_errno = errno;
+        free (topic);
+        errno = saved_errno;
+        return -1;
+    }
+    free (topic);
+    flux_future_destroy (f2);
+    return 0;
+}
+
 /*
  * vi:tabstop=4 shiftwidth=4 expandtab
  */
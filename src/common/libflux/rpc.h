@@ -52,6 +52,17 @@ int flux_rpc_get_raw (flux_future_t *f, const void **data, int *len);
  */
 uint32_t flux_rpc_get_matchtag (flux_future_t *f);
 
+/* Grant 'credits' additional streaming response credits to the service
+ * producing responses for streaming RPC 'f'.  The grant is sent as a
+ * "<service>.credit" request containing the RPC matchtag.  Services
+ * supporting flow control stop sending responses once granted credits
+ * are exhausted, queueing them until more arrive; the first grant opts
+ * the stream in to flow control.  Grants to services without credit
+ * support are silently ignored.
+ * Returns 0 on success, -1 on failure with errno set.
+ */
+int flux_rpc_credit (flux_future_t *f, int credits);
+
 #ifdef __cplusplus
 }
 #endif
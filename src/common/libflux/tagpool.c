@@ -27,43 +27,40 @@
 #include "tagpool.h"
 #include "message.h"
 
-#include "src/common/libutil/veb.h"
 #include "src/common/libutil/log.h"
 
 #define TAGPOOL_COUNT (1UL<<20)
 #define TAGPOOL_START (1UL<<10)
 
+/* Tags are allocated from a LIFO stack of freed tags, falling back to
+ * a bump pointer over never-used values, so both alloc and free are
+ * O(1) regardless of how many tags are outstanding or how the pool
+ * has fragmented.  The stack storage starts small and doubles on
+ * demand, bounded by one uint32_t per concurrently freed tag.
+ */
 #define TAGPOOL_MAGIC   0x34447ff2
 struct tagpool {
     int             magic;
-    Veb             veb;
+    uint32_t        *free_tags;
+    uint32_t        nfree;
+    uint32_t        freesize;
+    uint32_t        next;
     int             avail;
     tagpool_grow_f  grow_cb;
     void            *grow_arg;
     int             grow_depth;
 };
 
-static void pool_set (Veb veb, uint32_t from, uint32_t to, uint8_t value)
-{
-    while (from < to) {
-        if (value)
-            vebput (veb, from);
-        else
-            vebdel (veb, from);
-        from++;
-    }
-}
-
 struct tagpool *tagpool_create (void)
 {
     struct tagpool *t = calloc (1, sizeof (*t));
     if (!t)
         goto nomem;
     t->magic = TAGPOOL_MAGIC;
-    t->veb = vebnew (TAGPOOL_START, 1);
-    if (!t->veb.D)
+    if (!(t->free_tags = calloc (TAGPOOL_START, sizeof (uint32_t))))
         goto nomem;
-    vebdel (t->veb, FLUX_MATCHTAG_NONE); /* allocate reserved value */
+    t->freesize = TAGPOOL_START;
+    t->next = FLUX_MATCHTAG_NONE + 1; /* skip reserved value */
     t->avail = TAGPOOL_COUNT - 1;
     return t;
 nomem:
@@ -76,7 +73,7 @@ void tagpool_destroy (struct tagpool *t)
 {
     if (t) {
         assert (t->magic == TAGPOOL_MAGIC);
-        free (t->veb.D);
+        free (t->free_tags);
         t->magic = ~TAGPOOL_MAGIC;
         free (t);
     }
@@ -88,56 +85,40 @@ void tagpool_set_grow_cb (struct tagpool *t, tagpool_grow_f cb, void *arg)
     t->grow_arg = arg;
 }
 
-static uint32_t alloc_with_resize (struct tagpool *t)
-{
-    uint32_t max = TAGPOOL_COUNT;
-    uint32_t oldsize, newsize, tag;
-
-    oldsize = t->veb.M;
-    newsize = oldsize << 1;
-    tag = vebsucc (t->veb, 0);
-
-    if (tag == t->veb.M && newsize <= max) {
-        if (t->grow_cb && t->grow_depth == 0) {
-            t->grow_depth++;
-            t->grow_cb (t->grow_arg, oldsize, newsize);
-            t->grow_depth--;
-        }
-        Veb new = vebnew (newsize, 0);
-        if (new.D) {
-            pool_set (new, oldsize, newsize, 1);
-            free (t->veb.D);
-            t->veb = new;
-            tag = vebsucc (t->veb, oldsize);
-            assert (tag == oldsize);
-        }
-    }
-    if (tag < t->veb.M)
-        vebdel (t->veb, tag);
-    return tag;
-}
-
 uint32_t tagpool_alloc (struct tagpool *t)
 {
     assert (t->magic == TAGPOOL_MAGIC);
-    uint32_t tag;
+    uint32_t tag = FLUX_MATCHTAG_NONE;
 
-    tag = alloc_with_resize (t);
-    if (tag < t->veb.M) {
+    if (t->nfree > 0)
+        tag = t->free_tags[--t->nfree];
+    else if (t->next < TAGPOOL_COUNT)
+        tag = t->next++;
+    if (tag != FLUX_MATCHTAG_NONE)
         t->avail--;
-        return tag;
-    }
-    return FLUX_MATCHTAG_NONE;
+    return tag;
 }
 
 void tagpool_free (struct tagpool *t, uint32_t tag)
 {
     assert (t->magic == TAGPOOL_MAGIC);
-    if (tag != FLUX_MATCHTAG_NONE) {
-        if (tag < t->veb.M) {
-            vebput (t->veb, tag);
-            t->avail++;
+    if (tag != FLUX_MATCHTAG_NONE && tag < TAGPOOL_COUNT) {
+        if (t->nfree == t->freesize) {
+            uint32_t newsize = t->freesize << 1;
+            uint32_t *new;
+            if (!(new = realloc (t->free_tags,
+                                 newsize * sizeof (uint32_t))))
+                return; /* tag is leaked; allocation continues via next */
+            t->free_tags = new;
+            t->freesize = newsize;
+            if (t->grow_cb && t->grow_depth == 0) {
+                t->grow_depth++;
+                t->grow_cb (t->grow_arg, t->nfree, newsize);
+                t->grow_depth--;
+            }
         }
+        t->free_tags[t->nfree++] = tag;
+        t->avail++;
     }
 }
 
@@ -164,6 +164,18 @@ int test_server (flux_t *h, void *arg)
     return 0;
 }
 
+static char *direct_lookup (const char *name, void *arg)
+{
+    zhashx_t *tab = arg;
+    const char *val;
+
+    if (!(val = zhashx_lookup (tab, name))) {
+        errno = ENOENT;
+        return NULL;
+    }
+    return strdup (val);
+}
+
 int main (int argc, char *argv[])
 {
     flux_t *h;
@@ -258,6 +270,43 @@ int main (int argc, char *argv[])
     ok (flux_attr_get (h, "fake") == NULL && errno == ENOENT && get_count == 1,
         "flux_attr_get fake failed with ENOENT (with rpc)");
 
+    /* direct lookup */
+
+    zhashx_t *direct;
+    if (!(direct = zhashx_new ()))
+        BAIL_OUT ("zhashx_new failed");
+    zhashx_set_duplicator (direct, valdup);
+    zhashx_set_destructor (direct, valfree);
+    zhashx_update (direct, "pig", "oink");
+
+    ok (flux_attr_set_lookup (h, direct_lookup, direct) == 0,
+        "flux_attr_set_lookup works");
+    get_count = 0;
+    value = flux_attr_get (h, "pig");
+    ok (value && !strcmp (value, "oink") && get_count == 0,
+        "flux_attr_get pig=oink (direct, no rpc)");
+    get_count = 0;
+    value = flux_attr_get (h, "baz");
+    ok (value && !strcmp (value, "meep") && get_count == 1,
+        "flux_attr_get baz=meep falls back to rpc on direct miss");
+    get_count = 0;
+    value = flux_attr_get (h, "cow");
+    ok (value && !strcmp (value, "moo") && get_count == 0,
+        "flux_attr_get cow=moo still served from immutable cache");
+
+    ok (flux_attr_set_lookup (h, NULL, NULL) == 0,
+        "flux_attr_set_lookup fn=NULL uninstalls");
+    get_count = 0;
+    errno = 0;
+    ok (flux_attr_get (h, "pig") == NULL && errno == ENOENT && get_count == 1,
+        "flux_attr_get pig fails with ENOENT after uninstall (with rpc)");
+    zhashx_destroy (&direct);
+
+    errno = 0;
+    ok (flux_attr_set_lookup (NULL, direct_lookup, NULL) < 0
+        && errno == EINVAL,
+        "flux_attr_set_lookup h=NULL fails with EINVAL");
+
     /* set - invalid args */
     errno = 0;
     ok (flux_attr_set (NULL, "foo", "bar") < 0 && errno == EINVAL,
@@ -0,0 +1,289 @@
+/************************************************************\
+ * Copyright 2014 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* bench.c - microbenchmarks for libflux messaging primitives
+ *
+ * Not a TAP test:  this program times tight loops over message
+ * create/encode/decode, msg_handler dispatch, future fulfillment, and
+ * RPC round trips through the test server, and reports ns/op.
+ *
+ * Usage: bench_core [-o FILE] [BASELINE]
+ *
+ * With BASELINE (a file previously written with -o), each result is
+ * compared against the stored value and the delta is reported, so the
+ * effect of a messaging change can be measured:
+ *
+ *   ./bench_core -o bench_baseline    # before
+ *   ./bench_core bench_baseline      # after
+ *
+ * Results are machine- and load-dependent; baselines are only
+ * meaningful on the machine that produced them.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <flux/core.h>
+
+#include "src/common/libtestutil/util.h"
+#include "src/common/libutil/log.h"
+
+static flux_t *loop;        /* loopback connector */
+static flux_t *server;      /* test server connection */
+static int dispatch_count;
+
+static double timestamp (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1E9 + ts.tv_nsec;
+}
+
+static void bench_msg_create (int n)
+{
+    flux_msg_t *msg;
+    int i;
+
+    for (i = 0; i < n; i++) {
+        if (!(msg = flux_msg_create (FLUX_MSGTYPE_REQUEST)))
+            log_err_exit ("flux_msg_create");
+        flux_msg_destroy (msg);
+    }
+}
+
+static void bench_msg_encode_decode (int n)
+{
+    flux_msg_t *msg;
+    flux_msg_t *msg2;
+    char payload[64];
+    void *buf;
+    size_t size;
+    int i;
+
+    memset (payload, 'x', sizeof (payload));
+    if (!(msg = flux_msg_create (FLUX_MSGTYPE_REQUEST))
+        || flux_msg_set_topic (msg, "bench.topic") < 0
+        || flux_msg_set_payload (msg, payload, sizeof (payload)) < 0)
+        log_err_exit ("error creating message");
+    for (i = 0; i < n; i++) {
+        if (flux_msg_encode (msg, &buf, &size) < 0)
+            log_err_exit ("flux_msg_encode");
+        if (!(msg2 = flux_msg_decode (buf, size)))
+            log_err_exit ("flux_msg_decode");
+        flux_msg_destroy (msg2);
+        free (buf);
+    }
+    flux_msg_destroy (msg);
+}
+
+static void bench_future_fulfill (int n)
+{
+    flux_future_t *f;
+    int i;
+
+    for (i = 0; i < n; i++) {
+        if (!(f = flux_future_create (NULL, NULL)))
+            log_err_exit ("flux_future_create");
+        flux_future_fulfill (f, NULL, NULL);
+        if (flux_future_get (f, NULL) < 0)
+            log_err_exit ("flux_future_get");
+        flux_future_destroy (f);
+    }
+}
+
+static void dispatch_cb (flux_t *h,
+                         flux_msg_handler_t *mh,
+                         const flux_msg_t *msg,
+                         void *arg)
+{
+    dispatch_count++;
+}
+
+/* Send a request over the loopback connector, then dispatch it to a
+ * registered msg_handler, per iteration.
+ */
+static void bench_dispatch (int n)
+{
+    flux_msg_handler_t *mh;
+    struct flux_match match = FLUX_MATCH_REQUEST;
+    flux_msg_t *msg;
+    int i;
+
+    match.topic_glob = "bench.dispatch";
+    if (!(mh = flux_msg_handler_create (loop, match, dispatch_cb, NULL)))
+        log_err_exit ("flux_msg_handler_create");
+    flux_msg_handler_start (mh);
+    if (!(msg = flux_msg_create (FLUX_MSGTYPE_REQUEST))
+        || flux_msg_set_topic (msg, "bench.dispatch") < 0)
+        log_err_exit ("error creating message");
+    dispatch_count = 0;
+    for (i = 0; i < n; i++) {
+        if (flux_send (loop, msg, 0) < 0)
+            log_err_exit ("flux_send");
+        if (flux_reactor_run (flux_get_reactor (loop),
+                              FLUX_REACTOR_NOWAIT) < 0)
+            log_err_exit ("flux_reactor_run");
+    }
+    if (dispatch_count != n)
+        log_msg_exit ("dispatch: %d of %d messages handled",
+                      dispatch_count,
+                      n);
+    flux_msg_destroy (msg);
+    flux_msg_handler_stop (mh);
+    flux_msg_handler_destroy (mh);
+}
+
+static void bench_rpc (int n)
+{
+    flux_future_t *f;
+    int i;
+
+    for (i = 0; i < n; i++) {
+        if (!(f = flux_rpc (server, "bench.echo", NULL, FLUX_NODEID_ANY, 0)))
+            log_err_exit ("flux_rpc");
+        if (flux_future_get (f, NULL) < 0)
+            log_err_exit ("bench.echo");
+        flux_future_destroy (f);
+    }
+}
+
+static void echo_cb (flux_t *h,
+                     flux_msg_handler_t *mh,
+                     const flux_msg_t *msg,
+                     void *arg)
+{
+    if (flux_respond (h, msg, NULL) < 0)
+        log_err_exit ("flux_respond");
+}
+
+static const struct flux_msg_handler_spec server_htab[] = {
+    { FLUX_MSGTYPE_REQUEST, "bench.echo", echo_cb, 0 },
+    FLUX_MSGHANDLER_TABLE_END,
+};
+
+static int echo_server (flux_t *h, void *arg)
+{
+    flux_msg_handler_t **handlers;
+
+    if (flux_msg_handler_addvec (h, server_htab, NULL, &handlers) < 0)
+        return -1;
+    if (flux_reactor_run (flux_get_reactor (h), 0) < 0)
+        return -1;
+    flux_msg_handler_delvec (handlers);
+    return 0;
+}
+
+static const struct bench {
+    const char *name;
+    int iterations;
+    void (*fn)(int n);
+} benchtab[] = {
+    { "msg_create",         1000000,    bench_msg_create },
+    { "msg_encode_decode",  200000,     bench_msg_encode_decode },
+    { "future_fulfill",     1000000,    bench_future_fulfill },
+    { "dispatch",           200000,     bench_dispatch },
+    { "rpc",                20000,      bench_rpc },
+    { NULL, 0, NULL },
+};
+
+/* Look up 'name' in the baseline file, a sequence of "name ns_op"
+ * lines as written by -o.  Returns ns/op or -1 if unavailable.
+ */
+static double baseline_lookup (const char *path, const char *name)
+{
+    FILE *f;
+    char line[256];
+    char key[128];
+    double val = -1;
+
+    if (!path || !(f = fopen (path, "r")))
+        return -1;
+    while (fgets (line, sizeof (line), f)) {
+        double v;
+        if (sscanf (line, "%127s %lf", key, &v) == 2
+            && !strcmp (key, name)) {
+            val = v;
+            break;
+        }
+    }
+    fclose (f);
+    return val;
+}
+
+int main (int argc, char *argv[])
+{
+    const struct bench *b;
+    const char *baseline_path = NULL;
+    const char *output_path = NULL;
+    FILE *out = NULL;
+    int ch;
+
+    log_init ("bench_core");
+
+    while ((ch = getopt (argc, argv, "o:")) != -1) {
+        switch (ch) {
+        case 'o':
+            output_path = optarg;
+            break;
+        default:
+            log_msg_exit ("Usage: bench_core [-o FILE] [BASELINE]");
+        }
+    }
+    if (optind < argc)
+        baseline_path = argv[optind++];
+    if (optind < argc)
+        log_msg_exit ("Usage: bench_core [-o FILE] [BASELINE]");
+
+    if (output_path && !(out = fopen (output_path, "w")))
+        log_err_exit ("%s", output_path);
+
+    test_server_environment_init ("bench_core");
+    if (!(loop = loopback_create (0)))
+        log_err_exit ("loopback_create");
+    if (!(server = test_server_create (echo_server, NULL)))
+        log_err_exit ("test_server_create");
+
+    printf ("%-20s %10s %10s %10s %8s\n",
+            "benchmark", "iterations", "ns/op", "base", "delta");
+    for (b = &benchtab[0]; b->name != NULL; b++) {
+        double t0, ns_op, base;
+
+        t0 = timestamp ();
+        b->fn (b->iterations);
+        ns_op = (timestamp () - t0) / b->iterations;
+
+        printf ("%-20s %10d %10.1f", b->name, b->iterations, ns_op);
+        if ((base = baseline_lookup (baseline_path, b->name)) > 0)
+            printf (" %10.1f %+7.1f%%", base, (ns_op - base) / base * 100);
+        printf ("\n");
+        if (out)
+            fprintf (out, "%s %.1f\n", b->name, ns_op);
+    }
+
+    if (out)
+        fclose (out);
+    if (test_server_stop (server) < 0)
+        log_err_exit ("test_server_stop");
+    flux_close (server);
+    flux_close (loop);
+    log_fini ();
+
+    return 0;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -462,6 +462,76 @@ void test_cloned_dispatch (flux_t *orig)
     diag ("destroyed reactor, closed clone");
 }
 
+/* Verify that raising the dispatch batch limit drains multiple queued
+ * messages in a single reactor loop iteration, and that the default
+ * remains one message per loop.
+ */
+void test_batch_limit (flux_t *h)
+{
+    flux_msg_handler_t *mh;
+    flux_msg_t *msg;
+    int i, rc;
+
+    ok ((mh = flux_msg_handler_create (h, FLUX_MATCH_EVENT, cb, NULL)) != NULL,
+        "created event handler");
+    flux_msg_handler_start (mh);
+    ok ((msg = flux_event_encode ("test.batch", NULL)) != NULL,
+        "encoded event message");
+    for (i = 0; i < 3; i++) {
+        if (flux_send (h, msg, 0) < 0)
+            BAIL_OUT ("flux_send failed");
+    }
+    cb_called = 0;
+    rc = flux_reactor_run (flux_get_reactor (h), FLUX_REACTOR_NOWAIT);
+    ok (rc >= 0 && cb_called == 1,
+        "default batch limit handles one message per loop");
+    ok (flux_dispatch_set_batch_limit (h, 16) == 0,
+        "flux_dispatch_set_batch_limit works");
+    rc = flux_reactor_run (flux_get_reactor (h), FLUX_REACTOR_NOWAIT);
+    ok (rc >= 0 && cb_called == 3,
+        "remaining queued messages drained in one loop");
+    errno = 0;
+    ok (flux_dispatch_set_batch_limit (h, 0) < 0 && errno == EINVAL,
+        "flux_dispatch_set_batch_limit limit=0 fails with EINVAL");
+    ok (flux_dispatch_set_batch_limit (h, 1) == 0,
+        "restored default batch limit");
+    flux_msg_destroy (msg);
+    flux_msg_handler_destroy (mh);
+}
+
+static void selfrpc_echo_cb (flux_t *h,
+                             flux_msg_handler_t *mh,
+                             const flux_msg_t *msg,
+                             void *arg)
+{
+    if (flux_respond (h, msg, NULL) < 0)
+        diag ("selfrpc_echo_cb: flux_respond failed");
+}
+
+/* Verify that an RPC to a service registered on the same handle
+ * completes inside a blocking flux_future_get(), via inline dispatch
+ * of unmatched requests to the clone's parent handlers.
+ */
+void test_selfrpc (flux_t *h)
+{
+    struct flux_match m = FLUX_MATCH_REQUEST;
+    flux_msg_handler_t *mh;
+    flux_future_t *f;
+
+    m.topic_glob = "selfrpc.echo";
+    ok ((mh = flux_msg_handler_create (h, m, selfrpc_echo_cb, NULL)) != NULL,
+        "created handler for selfrpc.echo request");
+    flux_msg_handler_start (mh);
+    ok ((f = flux_rpc (h, "selfrpc.echo", NULL, FLUX_NODEID_ANY, 0)) != NULL,
+        "sent rpc to service on same handle");
+    ok (flux_future_get (f, NULL) == 0,
+        "flux_future_get completed rpc without running main reactor");
+    flux_future_destroy (f);
+    flux_msg_handler_destroy (mh);
+    ok (flux_recv (h, FLUX_MATCH_ANY, FLUX_O_NONBLOCK) == NULL,
+        "no stray messages remain on handle");
+}
+
 int main (int argc, char *argv[])
 {
     flux_t *h;
@@ -477,6 +547,8 @@ int main (int argc, char *argv[])
     test_simple_msg_handler (h);
     test_fastpath (h);
     test_cloned_dispatch (h);
+    test_selfrpc (h);
+    test_batch_limit (h);
     test_method_override (h);
     test_request_catchall (h);
     test_response_catchall (h);
@@ -678,6 +678,58 @@ void check_encode (void)
     flux_msg_destroy (msg2);
 }
 
+void check_encode_iovec (void)
+{
+    flux_msg_t *msg;
+    struct iovec iov[16];
+    uint8_t pfx[64];
+    char gathered[512];
+    void *buf;
+    size_t size;
+    size_t used;
+    int niov;
+    int i;
+
+    ok ((msg = flux_msg_create (FLUX_MSGTYPE_REQUEST)) != NULL,
+        "flux_msg_create works");
+    ok (flux_msg_set_topic (msg, "foo.bar") == 0,
+        "flux_msg_set_topic works");
+    ok (flux_msg_set_payload (msg, "abcdefgh", 8) == 0,
+        "flux_msg_set_payload works");
+
+    size = flux_msg_encode_size (msg);
+    ok (size > 0 && size <= sizeof (gathered),
+        "flux_msg_encode_size works");
+    buf = malloc (size);
+    assert (buf != NULL);
+    ok (flux_msg_encode (msg, buf, size) == 0,
+        "flux_msg_encode works");
+
+    niov = flux_msg_encode_iovec (msg, pfx, sizeof (pfx), iov, 16);
+    ok (niov == 2 * flux_msg_frames (msg),
+        "flux_msg_encode_iovec returned two iovecs per frame");
+    used = 0;
+    for (i = 0; i < niov; i++) {
+        assert (used + iov[i].iov_len <= sizeof (gathered));
+        memcpy (gathered + used, iov[i].iov_base, iov[i].iov_len);
+        used += iov[i].iov_len;
+    }
+    ok (used == size && memcmp (gathered, buf, size) == 0,
+        "gathered iovecs match flux_msg_encode output");
+
+    errno = 0;
+    ok (flux_msg_encode_iovec (msg, pfx, sizeof (pfx), iov, 1) < 0
+        && errno == EINVAL,
+        "flux_msg_encode_iovec fails with EINVAL on short iovec array");
+    errno = 0;
+    ok (flux_msg_encode_iovec (msg, pfx, 1, iov, 16) < 0
+        && errno == EINVAL,
+        "flux_msg_encode_iovec fails with EINVAL on short prefix buffer");
+
+    free (buf);
+    flux_msg_destroy (msg);
+}
+
 void check_sendzsock (void)
 {
     zsock_t *zsock[2] = { NULL, NULL };
@@ -918,6 +970,14 @@ void check_flags (void)
     ok (flux_msg_is_noresponse (msg) == true,
         "flux_msg_is_noresponse = true");
 
+    /* FLUX_MSGFLAG_CONTROL */
+    ok (flux_msg_is_control (msg) == false,
+        "flux_msg_is_control = false");
+    ok (flux_msg_set_control (msg) == 0,
+        "flux_msg_set_control_works");
+    ok (flux_msg_is_control (msg) == true,
+        "flux_msg_is_control = true");
+
     /* noresponse and streaming are mutually exclusive */
     ok (flux_msg_set_streaming (msg) == 0
         && flux_msg_set_noresponse (msg) == 0
@@ -1013,6 +1073,29 @@ void check_refcount (void)
         "flux_msg_destroy msg=NULL doesnt crash crash");
 }
 
+void check_pool (void)
+{
+    flux_msg_t *msg;
+    int count;
+    uint64_t hits, misses;
+
+    flux_msg_pool_stats (&count, &hits, &misses);
+    ok (count >= 0 && misses > 0,
+        "flux_msg_pool_stats works after earlier message traffic");
+    if (!(msg = flux_msg_create (FLUX_MSGTYPE_REQUEST)))
+        BAIL_OUT ("failed to create test message");
+    flux_msg_destroy (msg);
+    flux_msg_pool_stats (&count, NULL, NULL);
+    ok (count > 0,
+        "destroyed message was returned to the pool");
+    if (!(msg = flux_msg_create (FLUX_MSGTYPE_REQUEST)))
+        BAIL_OUT ("failed to create test message");
+    flux_msg_pool_stats (NULL, &hits, NULL);
+    ok (hits > 0,
+        "subsequent create was satisfied from the pool");
+    flux_msg_destroy (msg);
+}
+
 int main (int argc, char *argv[])
 {
     plan (NO_PLAN);
@@ -1032,11 +1115,13 @@ int main (int argc, char *argv[])
     check_cmp ();
 
     check_encode ();
+    check_encode_iovec ();
     check_sendzsock ();
 
     check_params ();
 
     check_refcount();
+    check_pool();
 
     //check_print ();
 
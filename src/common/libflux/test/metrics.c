@@ -0,0 +1,178 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#include <errno.h>
+#include <string.h>
+
+#include "src/common/libflux/metrics.h"
+#include "src/common/libtap/tap.h"
+
+static uint64_t sample_counter (void *arg)
+{
+    return *(uint64_t *)arg;
+}
+
+static double sample_gauge (void *arg)
+{
+    return *(double *)arg;
+}
+
+static void test_badargs (void)
+{
+    flux_metrics_t *m;
+    uint64_t u;
+    double d;
+
+    errno = 0;
+    ok (flux_metrics_create (NULL) == NULL && errno == EINVAL,
+        "flux_metrics_create prefix=NULL fails with EINVAL");
+    errno = 0;
+    ok (flux_metrics_create ("") == NULL && errno == EINVAL,
+        "flux_metrics_create prefix=\"\" fails with EINVAL");
+
+    if (!(m = flux_metrics_create ("test")))
+        BAIL_OUT ("flux_metrics_create failed");
+
+    errno = 0;
+    ok (flux_metrics_counter_add (NULL, "x", 1) < 0 && errno == EINVAL,
+        "flux_metrics_counter_add m=NULL fails with EINVAL");
+    errno = 0;
+    ok (flux_metrics_counter_add (m, NULL, 1) < 0 && errno == EINVAL,
+        "flux_metrics_counter_add name=NULL fails with EINVAL");
+    errno = 0;
+    ok (flux_metrics_counter_get (m, "x", NULL) < 0 && errno == EINVAL,
+        "flux_metrics_counter_get value=NULL fails with EINVAL");
+    errno = 0;
+    ok (flux_metrics_counter_register (m, "x", NULL, NULL) < 0
+        && errno == EINVAL,
+        "flux_metrics_counter_register cb=NULL fails with EINVAL");
+    errno = 0;
+    ok (flux_metrics_gauge_register (m, "x", NULL, NULL) < 0
+        && errno == EINVAL,
+        "flux_metrics_gauge_register cb=NULL fails with EINVAL");
+
+    /* type mismatch on an existing name */
+    ok (flux_metrics_counter_add (m, "hits", 1) == 0,
+        "flux_metrics_counter_add created counter");
+    errno = 0;
+    ok (flux_metrics_gauge_set (m, "hits", 1.) < 0 && errno == EINVAL,
+        "flux_metrics_gauge_set on counter name fails with EINVAL");
+    errno = 0;
+    ok (flux_metrics_observe (m, "hits", 1.) < 0 && errno == EINVAL,
+        "flux_metrics_observe on counter name fails with EINVAL");
+    errno = 0;
+    ok (flux_metrics_counter_get (m, "hits", &u) == 0 && u == 1,
+        "counter value unchanged by failed type-mismatch updates");
+    errno = 0;
+    ok (flux_metrics_gauge_get (m, "hits", &d) < 0 && errno == EINVAL,
+        "flux_metrics_gauge_get on counter name fails with EINVAL");
+
+    flux_metrics_destroy (m);
+    lives_ok ({flux_metrics_destroy (NULL);},
+        "flux_metrics_destroy m=NULL doesn't crash");
+}
+
+static void test_counter (void)
+{
+    flux_metrics_t *m;
+    uint64_t sampled = 42;
+    uint64_t u = 0;
+
+    if (!(m = flux_metrics_create ("test")))
+        BAIL_OUT ("flux_metrics_create failed");
+
+    ok (flux_metrics_counter_add (m, "hits", 1) == 0
+        && flux_metrics_counter_add (m, "hits", 2) == 0
+        && flux_metrics_counter_get (m, "hits", &u) == 0
+        && u == 3,
+        "stored counter accumulates adds");
+
+    ok (flux_metrics_counter_register (m, "sampled", sample_counter,
+                                       &sampled) == 0
+        && flux_metrics_counter_get (m, "sampled", &u) == 0
+        && u == 42,
+        "callback counter samples at get time");
+    sampled = 43;
+    ok (flux_metrics_counter_get (m, "sampled", &u) == 0 && u == 43,
+        "callback counter reflects updated source");
+    errno = 0;
+    ok (flux_metrics_counter_add (m, "sampled", 1) < 0 && errno == EINVAL,
+        "flux_metrics_counter_add on callback counter fails with EINVAL");
+
+    flux_metrics_destroy (m);
+}
+
+static void test_gauge (void)
+{
+    flux_metrics_t *m;
+    double sampled = 0.5;
+    double d = 0.;
+
+    if (!(m = flux_metrics_create ("test")))
+        BAIL_OUT ("flux_metrics_create failed");
+
+    ok (flux_metrics_gauge_set (m, "level", 1.5) == 0
+        && flux_metrics_gauge_set (m, "level", 2.5) == 0
+        && flux_metrics_gauge_get (m, "level", &d) == 0
+        && d == 2.5,
+        "stored gauge holds last set value");
+
+    ok (flux_metrics_gauge_register (m, "sampled", sample_gauge,
+                                     &sampled) == 0
+        && flux_metrics_gauge_get (m, "sampled", &d) == 0
+        && d == 0.5,
+        "callback gauge samples at get time");
+    sampled = 0.75;
+    ok (flux_metrics_gauge_get (m, "sampled", &d) == 0 && d == 0.75,
+        "callback gauge reflects updated source");
+    errno = 0;
+    ok (flux_metrics_gauge_set (m, "sampled", 1.) < 0 && errno == EINVAL,
+        "flux_metrics_gauge_set on callback gauge fails with EINVAL");
+
+    flux_metrics_destroy (m);
+}
+
+static void test_histogram (void)
+{
+    flux_metrics_t *m;
+    int i;
+
+    if (!(m = flux_metrics_create ("test")))
+        BAIL_OUT ("flux_metrics_create failed");
+
+    for (i = 0; i < 100; i++) {
+        if (flux_metrics_observe (m, "latency", (double)i) < 0)
+            break;
+    }
+    ok (i == 100,
+        "flux_metrics_observe accepted 100 samples");
+    errno = 0;
+    ok (flux_metrics_counter_add (m, "latency", 1) < 0 && errno == EINVAL,
+        "flux_metrics_counter_add on histogram name fails with EINVAL");
+
+    flux_metrics_destroy (m);
+}
+
+int main (int argc, char *argv[])
+{
+    plan (NO_PLAN);
+
+    test_badargs ();
+    test_counter ();
+    test_gauge ();
+    test_histogram ();
+
+    done_testing ();
+    return (0);
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
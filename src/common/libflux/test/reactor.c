@@ -1428,6 +1428,105 @@ static void test_active_ref (flux_reactor_t *r)
     flux_watcher_destroy (w);
 }
 
+static void test_profile (flux_reactor_t *reactor)
+{
+    struct flux_reactor_stats stats[32];
+    int count;
+    flux_watcher_t *w;
+    uint64_t timer_calls;
+    double timer_time;
+    int i;
+
+    errno = 0;
+    count = 32;
+    ok (flux_reactor_stats_get (NULL, stats, &count) < 0 && errno == EINVAL,
+        "profile: stats_get with NULL reactor fails with EINVAL");
+
+    flux_reactor_profile (reactor, true);
+    if (!(w = flux_timer_watcher_create (reactor, 0, 0, oneshot, NULL)))
+        BAIL_OUT ("flux_timer_watcher_create failed");
+    oneshot_runs = 0;
+    oneshot_errno = 0;
+    flux_watcher_start (w);
+    ok (flux_reactor_run (reactor, 0) == 0,
+        "profile: reactor exited normally");
+    flux_watcher_destroy (w);
+
+    count = 32;
+    ok (flux_reactor_stats_get (reactor, stats, &count) == 0 && count > 0,
+        "profile: stats_get works");
+    timer_calls = 0;
+    timer_time = -1.;
+    for (i = 0; i < count; i++) {
+        if (!strcmp (stats[i].name, "timer")) {
+            timer_calls = stats[i].calls;
+            timer_time = stats[i].time;
+        }
+    }
+    ok (timer_calls == 1 && timer_time >= 0.,
+        "profile: one timer callback was charged to type timer");
+
+    /* Re-enabling resets counters.
+     */
+    flux_reactor_profile (reactor, false);
+    flux_reactor_profile (reactor, true);
+    count = 32;
+    ok (flux_reactor_stats_get (reactor, stats, &count) == 0,
+        "profile: stats_get works after re-enable");
+    timer_calls = 1;
+    for (i = 0; i < count; i++) {
+        if (!strcmp (stats[i].name, "timer"))
+            timer_calls = stats[i].calls;
+    }
+    ok (timer_calls == 0,
+        "profile: re-enabling profiling reset counters");
+    flux_reactor_profile (reactor, false);
+}
+
+static int priority_order[2];
+static int priority_next = 0;
+
+static void priority_cb (flux_reactor_t *r, flux_watcher_t *w,
+                         int revents, void *arg)
+{
+    if (priority_next < 2)
+        priority_order[priority_next++] = *(int *)arg;
+    flux_watcher_stop (w);
+}
+
+static void test_priority (flux_reactor_t *reactor)
+{
+    flux_watcher_t *w1, *w2;
+    int id1 = 1;
+    int id2 = 2;
+
+    /* Both timers expire immediately, so both are pending in the same
+     * loop iteration; the high priority callback must run first even
+     * though it was created (and started) second.
+     */
+    if (!(w1 = flux_timer_watcher_create (reactor, 0, 0, priority_cb, &id1))
+        || !(w2 = flux_timer_watcher_create (reactor, 0, 0, priority_cb,
+                                             &id2)))
+        BAIL_OUT ("flux_timer_watcher_create failed");
+    flux_watcher_set_priority (w2, FLUX_WATCHER_PRIORITY_HIGH);
+    priority_next = 0;
+    flux_watcher_start (w1);
+    flux_watcher_start (w2);
+    ok (flux_reactor_run (reactor, 0) == 0,
+        "priority: reactor exited normally");
+    ok (priority_next == 2
+        && priority_order[0] == 2
+        && priority_order[1] == 1,
+        "priority: high priority watcher ran before normal one");
+
+    lives_ok ({flux_watcher_set_priority (w1, FLUX_WATCHER_PRIORITY_IDLE);},
+        "priority: set_priority on stopped watcher works");
+    lives_ok ({flux_watcher_set_priority (NULL, 0);},
+        "priority: set_priority with NULL watcher doesn't crash");
+    flux_watcher_destroy (w1);
+    flux_watcher_destroy (w2);
+}
+
 static void reactor_destroy_early (void)
 {
     flux_reactor_t *r;
@@ -1468,6 +1567,8 @@ int main (int argc, char *argv[])
     test_child (reactor);
     test_stat (reactor);
     test_active_ref (reactor);
+    test_profile (reactor);
+    test_priority (reactor);
 
     flux_reactor_destroy (reactor);
 
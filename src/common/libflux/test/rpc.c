@@ -240,6 +240,11 @@ void test_corner_case (flux_t *h)
         && errno == EINVAL,
         "flux_rpc_message fails with EINVAL on NULL msg");
 
+    errno = 0;
+    ok (flux_rpc_credit (NULL, 1) < 0
+        && errno == EINVAL,
+        "flux_rpc_credit fails with EINVAL on NULL future");
+
     errno = 0;
     ok (flux_rpc (h, NULL, "data", 0, 0) == NULL
         && errno == EINVAL,
@@ -273,21 +273,91 @@ bool idset_equal (const struct idset *idset1,
     if (idset_count (idset1) != idset_count (idset2))
         return false;
 
+    /* The counts are equal, so idset1 being a subset of idset2
+     * implies equality.
+     */
     id = vebsucc (idset1->T, 0);
     while (id < idset1->T.M) {
         if (vebsucc (idset2->T, id) != id)
             return false; // id in idset1 not set in idset2
         id = vebsucc (idset1->T, id + 1);
     }
-    id = vebsucc (idset2->T, 0);
-    while (id < idset2->T.M) {
-        if (vebsucc (idset1->T, id) != id)
-            return false; // id in idset2 not set in idset1
-        id = vebsucc (idset2->T, id + 1);
-    }
     return true;
 }
 
+int idset_add (struct idset *a, const struct idset *b)
+{
+    unsigned int id;
+
+    if (!a) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!b || b->count == 0)
+        return 0;
+    if (idset_grow (a, idset_last (b) + 1) < 0)
+        return -1;
+    id = vebsucc (b->T, 0);
+    while (id < b->T.M) {
+        idset_put (a, id);
+        id = vebsucc (b->T, id + 1);
+    }
+    return 0;
+}
+
+int idset_subtract (struct idset *a, const struct idset *b)
+{
+    unsigned int id;
+
+    if (!a) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (b) {
+        id = vebsucc (b->T, 0);
+        while (id < b->T.M && id < a->T.M) {
+            idset_del (a, id);
+            id = vebsucc (b->T, id + 1);
+        }
+    }
+    return 0;
+}
+
+struct idset *idset_union (const struct idset *a, const struct idset *b)
+{
+    struct idset *result;
+
+    if (!a) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(result = idset_copy (a)))
+        return NULL;
+    result->flags |= IDSET_FLAG_AUTOGROW; // allow for ids in b >= a's size
+    if (idset_add (result, b) < 0) {
+        idset_destroy (result);
+        return NULL;
+    }
+    return result;
+}
+
+struct idset *idset_difference (const struct idset *a, const struct idset *b)
+{
+    struct idset *result;
+
+    if (!a) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(result = idset_copy (a)))
+        return NULL;
+    if (idset_subtract (result, b) < 0) {
+        idset_destroy (result);
+        return NULL;
+    }
+    return result;
+}
+
 /*
  * vi:tabstop=4 shiftwidth=4 expandtab
  */
@@ -54,9 +54,32 @@ struct idset *idset_decode (const char *s);
 
 /* Decode 'len' chars of string 's' to an idset.
  * Returns idset on success, or NULL on failure with errno set.
+ * Buffers in the idset_encode_raw() binary form are recognized by their
+ * leading magic byte and accepted as well.
  */
 struct idset *idset_ndecode (const char *s, size_t len);
 
+/* Binary idset codec: a compact alternative to the text form for sized
+ * message payloads (the encoding may contain NUL bytes, so it cannot be
+ * used where a string is expected).  The format is a magic byte, a
+ * version byte, then one base-128 varint pair per range of consecutive
+ * ids: the gap from the end of the previous range, and the range length
+ * minus one.
+ */
+#define IDSET_BINARY_MAGIC 0xeb
+
+/* Encode 'idset' in binary form to 'buf'.
+ * Returns the number of bytes written, or -1 on failure with errno set
+ * (EOVERFLOW if 'buf' is too small).  If 'buf' is NULL, the required
+ * size is returned and nothing is written.
+ */
+ssize_t idset_encode_raw (const struct idset *idset, void *buf, size_t size);
+
+/* Decode 'size' bytes of binary-encoded 'buf' to an idset.
+ * Returns idset on success, or NULL on failure with errno set.
+ */
+struct idset *idset_decode_raw (const void *buf, size_t size);
+
 /* Add id (or range [lo-hi]) to idset.
  * Return 0 on success, -1 on failure with errno set.
  */
@@ -100,6 +123,29 @@ size_t idset_count (const struct idset *idset);
  */
 bool idset_equal (const struct idset *set1, const struct idset *set2);
 
+/* Add the members of 'b' to 'a', walking 'b' internally rather than
+ * setting one id at a time.  A NULL 'b' is treated as the empty set.
+ * Return 0 on success, -1 on failure with errno set.
+ */
+int idset_add (struct idset *a, const struct idset *b);
+
+/* Remove the members of 'b' from 'a'.  Ids in 'b' that are not members
+ * of 'a' are ignored.  A NULL 'b' is treated as the empty set.
+ * Return 0 on success, -1 on failure with errno set.
+ */
+int idset_subtract (struct idset *a, const struct idset *b);
+
+/* Return a new idset that is the union of 'a' and 'b'.
+ * The result has IDSET_FLAG_AUTOGROW set.
+ * Returns idset on success, or NULL on failure with errno set.
+ */
+struct idset *idset_union (const struct idset *a, const struct idset *b);
+
+/* Return a new idset containing the members of 'a' not in 'b'.
+ * Returns idset on success, or NULL on failure with errno set.
+ */
+struct idset *idset_difference (const struct idset *a, const struct idset *b);
+
 /* Expand bracketed idset string(s) in 's', calling 'fun()' for each
  * expanded string.  'fun()' should return 0 on success, or -1 on failure
  * with errno set.  A fun() failure causes idset_format_map () to immediately
@@ -18,6 +18,7 @@
 #include <stdio.h>
 #include <stdarg.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "idset.h"
 #include "idset_private.h"
@@ -61,6 +62,69 @@ static char *trim_brackets (char *s)
     return p;
 }
 
+/* Fetch the next base-128 varint from 'buf', advancing *offset past it.
+ * Returns 0 on success, -1 if the varint is truncated or overflows
+ * unsigned int.
+ */
+static int getvarint (const uint8_t *buf, size_t size, size_t *offset,
+                      unsigned int *np)
+{
+    unsigned int n = 0;
+    int shift = 0;
+
+    while (*offset < size) {
+        uint8_t b = buf[(*offset)++];
+        if (shift == 28 && (b & 0x7f) > 0xf)
+            return -1;
+        n |= (unsigned int)(b & 0x7f) << shift;
+        if (!(b & 0x80)) {
+            *np = n;
+            return 0;
+        }
+        shift += 7;
+        if (shift > 28)
+            return -1;
+    }
+    return -1;
+}
+
+struct idset *idset_decode_raw (const void *buf, size_t size)
+{
+    const uint8_t *in = buf;
+    struct idset *idset;
+    size_t offset = 2;
+    unsigned int prev = 0;
+    int saved_errno;
+
+    if (!in || size < 2 || in[0] != IDSET_BINARY_MAGIC || in[1] != 1) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(idset = idset_create (0, IDSET_FLAG_AUTOGROW)))
+        return NULL;
+    while (offset < size) {
+        unsigned int gap, runlen, lo, hi;
+        if (getvarint (in, size, &offset, &gap) < 0
+            || getvarint (in, size, &offset, &runlen) < 0)
+            goto inval;
+        lo = prev + gap;
+        hi = lo + runlen;
+        if (lo < prev || hi < lo || hi >= IDSET_INVALID_ID)
+            goto inval;
+        if (idset_range_set (idset, lo, hi) < 0)
+            goto error;
+        prev = hi + 1;
+    }
+    return idset;
+inval:
+    errno = EINVAL;
+error:
+    saved_errno = errno;
+    idset_destroy (idset);
+    errno = saved_errno;
+    return NULL;
+}
+
 struct idset *idset_ndecode (const char *str, size_t size)
 {
     struct idset *idset;
@@ -72,6 +136,8 @@ struct idset *idset_ndecode (const char *str, size_t size)
         errno = EINVAL;
         return NULL;
     }
+    if (size >= 2 && (unsigned char)str[0] == IDSET_BINARY_MAGIC)
+        return idset_decode_raw (str, size);
     if (!(idset = idset_create (0, IDSET_FLAG_AUTOGROW)))
         return NULL;
     if (!(cpy = strndup (str, size)))
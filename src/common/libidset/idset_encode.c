@@ -18,6 +18,7 @@
 #include <stdio.h>
 #include <stdarg.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "idset.h"
 #include "idset_private.h"
@@ -133,6 +134,65 @@ static int encode_simple (const struct idset *idset,
     return count;
 }
 
+/* Append 'n' to *len bytes of 'buf' as a base-128 varint, 7 bits per
+ * byte, least significant group first, high bit set on all but the
+ * final byte.  If 'buf' is NULL, just count the bytes.
+ * Returns 0 on success, -1 on failure with errno = EOVERFLOW.
+ */
+static int catvarint (uint8_t *buf, size_t size, size_t *len, unsigned int n)
+{
+    do {
+        uint8_t b = n & 0x7f;
+        n >>= 7;
+        if (n > 0)
+            b |= 0x80;
+        if (buf) {
+            if (*len >= size) {
+                errno = EOVERFLOW;
+                return -1;
+            }
+            buf[*len] = b;
+        }
+        (*len)++;
+    } while (n > 0);
+    return 0;
+}
+
+ssize_t idset_encode_raw (const struct idset *idset, void *buf, size_t size)
+{
+    uint8_t *out = buf;
+    size_t len = 2;
+    unsigned int id;
+    unsigned int prev = 0;
+
+    if (!idset) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (out) {
+        if (size < 2) {
+            errno = EOVERFLOW;
+            return -1;
+        }
+        out[0] = IDSET_BINARY_MAGIC;
+        out[1] = 1;                         // version
+    }
+    id = vebsucc (idset->T, 0);
+    while (id < idset->T.M) {
+        unsigned int lo = id;
+        unsigned int hi = id;
+
+        while ((id = vebsucc (idset->T, id + 1)) < idset->T.M
+                                                && id == hi + 1)
+            hi = id;
+        if (catvarint (out, size, &len, lo - prev) < 0
+            || catvarint (out, size, &len, hi - lo) < 0)
+            return -1;
+        prev = hi + 1;
+    }
+    return len;
+}
+
 char *idset_encode (const struct idset *idset, int flags)
 {
     char *str = NULL;
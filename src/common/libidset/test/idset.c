@@ -133,6 +133,71 @@ void test_codec_large (void)
     idset_destroy (idset);
 }
 
+void test_codec_raw (void)
+{
+    const char *input = "0-4,7,9-12,100,1048576";
+    struct idset *idset;
+    struct idset *idset2;
+    char buf[64];
+    char *s;
+    ssize_t need;
+    ssize_t len;
+
+    if (!(idset = idset_decode (input)))
+        BAIL_OUT ("idset_decode failed");
+
+    errno = 0;
+    ok (idset_encode_raw (NULL, buf, sizeof (buf)) < 0 && errno == EINVAL,
+        "idset_encode_raw(idset=NULL) fails with EINVAL");
+    errno = 0;
+    ok (idset_encode_raw (idset, buf, 1) < 0 && errno == EOVERFLOW,
+        "idset_encode_raw(size=1) fails with EOVERFLOW");
+
+    need = idset_encode_raw (idset, NULL, 0);
+    ok (need > 2,
+        "idset_encode_raw(buf=NULL) returned size %zd", need);
+    len = idset_encode_raw (idset, buf, sizeof (buf));
+    ok (len == need,
+        "idset_encode_raw encoded '%s' in %zd bytes", input, len);
+    s = idset_encode (idset, IDSET_FLAG_RANGE);
+    ok (s != NULL && len < strlen (s),
+        "binary form is smaller than text form (%zu bytes)",
+        s ? strlen (s) : 0);
+    free (s);
+
+    idset2 = idset_decode_raw (buf, len);
+    ok (idset2 != NULL && idset_equal (idset, idset2),
+        "idset_decode_raw round trip preserved the set");
+    idset_destroy (idset2);
+
+    idset2 = idset_ndecode (buf, len);
+    ok (idset2 != NULL && idset_equal (idset, idset2),
+        "idset_ndecode recognized the binary magic");
+    idset_destroy (idset2);
+
+    errno = 0;
+    ok (idset_decode_raw (buf, len - 1) == NULL && errno == EINVAL,
+        "idset_decode_raw on truncated buffer fails with EINVAL");
+    errno = 0;
+    ok (idset_decode_raw (NULL, 0) == NULL && errno == EINVAL,
+        "idset_decode_raw(buf=NULL) fails with EINVAL");
+    buf[1] = 0xff;
+    errno = 0;
+    ok (idset_decode_raw (buf, len) == NULL && errno == EINVAL,
+        "idset_decode_raw on unknown version fails with EINVAL");
+    idset_destroy (idset);
+
+    /* empty set is just the two byte header */
+    if (!(idset = idset_create (0, 0)))
+        BAIL_OUT ("idset_create failed");
+    len = idset_encode_raw (idset, buf, sizeof (buf));
+    idset2 = idset_decode_raw (buf, len);
+    ok (len == 2 && idset2 != NULL && idset_count (idset2) == 0,
+        "idset_encode_raw/decode_raw handle the empty set");
+    idset_destroy (idset2);
+    idset_destroy (idset);
+}
+
 void test_badparam (void)
 {
     struct idset *idset;
@@ -492,6 +557,69 @@ void test_copy (void)
     idset_destroy (idset);
 }
 
+void test_setops (void)
+{
+    struct idset *a;
+    struct idset *b;
+    struct idset *big;
+    struct idset *small;
+    struct idset *r;
+
+    if (!(a = idset_decode ("0-3")) || !(b = idset_decode ("2-5")))
+        BAIL_OUT ("idset_decode failed");
+
+    errno = 0;
+    ok (idset_add (NULL, b) < 0 && errno == EINVAL,
+        "idset_add a=NULL fails with EINVAL");
+    errno = 0;
+    ok (idset_subtract (NULL, b) < 0 && errno == EINVAL,
+        "idset_subtract a=NULL fails with EINVAL");
+    errno = 0;
+    ok (idset_union (NULL, b) == NULL && errno == EINVAL,
+        "idset_union a=NULL fails with EINVAL");
+    errno = 0;
+    ok (idset_difference (NULL, b) == NULL && errno == EINVAL,
+        "idset_difference a=NULL fails with EINVAL");
+
+    r = idset_union (a, b);
+    ok (r != NULL && idset_count (r) == 6
+        && idset_first (r) == 0 && idset_last (r) == 5,
+        "idset_union [0-3] [2-5] = [0-5]");
+    idset_destroy (r);
+
+    r = idset_difference (a, b);
+    ok (r != NULL && idset_count (r) == 2
+        && idset_test (r, 0) && idset_test (r, 1),
+        "idset_difference [0-3] [2-5] = [0-1]");
+    idset_destroy (r);
+
+    ok (idset_add (a, b) == 0 && idset_count (a) == 6,
+        "idset_add [2-5] to [0-3] makes [0-5]");
+    ok (idset_subtract (a, b) == 0 && idset_count (a) == 2
+        && idset_test (a, 0) && idset_test (a, 1),
+        "idset_subtract [2-5] from [0-5] makes [0-1]");
+    ok (idset_add (a, NULL) == 0 && idset_count (a) == 2,
+        "idset_add b=NULL is a no-op");
+    ok (idset_subtract (a, NULL) == 0 && idset_count (a) == 2,
+        "idset_subtract b=NULL is a no-op");
+
+    if (!(small = idset_create (4, 0)) || idset_range_set (small, 0, 3) < 0
+        || !(big = idset_decode ("100")))
+        BAIL_OUT ("could not create test idsets");
+    errno = 0;
+    ok (idset_add (small, big) < 0 && errno == EINVAL,
+        "idset_add to fixed-size idset that is too small fails with EINVAL");
+    r = idset_union (small, big);
+    ok (r != NULL && idset_count (r) == 5 && idset_test (r, 100),
+        "idset_union result grows beyond a's fixed size");
+    idset_destroy (r);
+
+    idset_destroy (small);
+    idset_destroy (big);
+    idset_destroy (a);
+    idset_destroy (b);
+}
+
 void test_autogrow (void)
 {
     struct idset *idset;
@@ -752,6 +880,7 @@ int main (int argc, char *argv[])
     test_badparam ();
     test_codec ();
     test_codec_large ();
+    test_codec_raw ();
     test_iter ();
     test_set ();
     test_range_set ();
@@ -759,6 +888,7 @@ int main (int argc, char *argv[])
     test_range_clear ();
     test_equal ();
     test_copy ();
+    test_setops ();
     test_autogrow ();
     test_format_first ();
     test_format_map ();
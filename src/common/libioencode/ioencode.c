@@ -64,16 +64,16 @@ error:
     return rv;
 }
 
-int iodecode (json_t *o,
-              const char **streamp,
-              const char **rankp,
-              char **datap,
-              int *lenp,
-              bool *eofp)
+int iodecode_ref (json_t *o,
+                  const char **streamp,
+                  const char **rankp,
+                  const char **datap,
+                  int *lenp,
+                  bool *eofp)
 {
     const char *stream;
     const char *rank;
-    char *bin_data = NULL;
+    const char *bin_data = NULL;
     size_t bin_len = 0;
     int eof = 0;
     bool has_data = false;
@@ -104,23 +104,41 @@ int iodecode (json_t *o,
         (*streamp) = stream;
     if (rankp)
         (*rankp) = rank;
+    if (datap)
+        (*datap) = bin_data;
+    if (lenp)
+        (*lenp) = bin_len;
+    if (eofp)
+        (*eofp) = eof;
+
+    rv = 0;
+cleanup:
+    return rv;
+}
+
+int iodecode (json_t *o,
+              const char **streamp,
+              const char **rankp,
+              char **datap,
+              int *lenp,
+              bool *eofp)
+{
+    const char *bin_data;
+    int bin_len;
+
+    if (iodecode_ref (o, streamp, rankp, &bin_data, &bin_len, eofp) < 0)
+        return -1;
     if (datap) {
         *datap = NULL;
         if (bin_data) {
             if (!(*datap = malloc (bin_len)))
-                goto cleanup;
+                return -1;
             memcpy (*datap, bin_data, bin_len);
-            bin_data = NULL;
         }
     }
     if (lenp)
         (*lenp) = bin_len;
-    if (eofp)
-        (*eofp) = eof;
-
-    rv = 0;
-cleanup:
-    return rv;
+    return 0;
 }
 
 /*
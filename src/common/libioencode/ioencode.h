@@ -37,4 +37,16 @@ int iodecode (json_t *o,
               int *len,
               bool *eof);
 
+/* Like iodecode(), but data borrows storage from the object rather
+ * than being copied - valid only while the object is referenced.
+ * Prefer this on hot paths where data is consumed before the object
+ * is released.
+ */
+int iodecode_ref (json_t *o,
+                  const char **stream,
+                  const char **rank,
+                  const char **data,
+                  int *len,
+                  bool *eof);
+
 #endif /* !_IOENCODE_H */
@@ -27,6 +27,43 @@ void basic_corner_case (void)
     ok (iodecode (NULL, NULL, NULL, NULL, NULL, NULL) < 0
         && errno == EINVAL,
         "iodecode returns EINVAL on bad input");
+
+    errno = 0;
+    ok (iodecode_ref (NULL, NULL, NULL, NULL, NULL, NULL) < 0
+        && errno == EINVAL,
+        "iodecode_ref returns EINVAL on bad input");
+}
+
+void basic_ref (void)
+{
+    json_t *o;
+    const char *stream;
+    const char *rank;
+    const char *data;
+    int len;
+    bool eof;
+
+    ok ((o = ioencode ("stdout", "2", "baz", 3, true)) != NULL,
+        "ioencode success (data, eof = true)");
+    ok (!iodecode_ref (o, &stream, &rank, &data, &len, &eof),
+        "iodecode_ref success");
+    ok (!strcmp (stream, "stdout")
+        && !strcmp (rank, "2")
+        && len == 3
+        && !strncmp (data, "baz", len)
+        && eof == true,
+        "iodecode_ref returned correct info");
+    json_decref (o);
+
+    ok ((o = ioencode ("stderr", "0", NULL, 0, true)) != NULL,
+        "ioencode success (no data, eof = true)");
+    ok (!iodecode_ref (o, &stream, &rank, &data, &len, &eof),
+        "iodecode_ref success");
+    ok (data == NULL
+        && len == 0
+        && eof == true,
+        "iodecode_ref returned correct info");
+    json_decref (o);
 }
 
 void basic (void)
@@ -83,6 +120,7 @@ int main (int argc, char *argv[])
 
     basic_corner_case ();
     basic ();
+    basic_ref ();
 
     done_testing ();
 
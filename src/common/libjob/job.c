@@ -112,6 +112,110 @@ error:
     return NULL;
 }
 
+flux_future_t *flux_job_submit_bulk (flux_t *h,
+                                     const char **jobspecs,
+                                     int count,
+                                     int priority,
+                                     int flags)
+{
+    flux_future_t *f = NULL;
+    json_t *jobs = NULL;
+    int saved_errno;
+    int i;
+
+    if (!h || !jobspecs || count <= 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(jobs = json_array ())) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    for (i = 0; i < count; i++) {
+        const char *J;
+        char *s = NULL;
+        json_t *el;
+
+        if (!jobspecs[i]) {
+            errno = EINVAL;
+            goto error;
+        }
+        if (!(flags & FLUX_JOB_PRE_SIGNED)) {
+#if HAVE_FLUX_SECURITY
+            flux_security_t *sec;
+            flux_future_t *f_error;
+            if (!(sec = get_security_ctx (h, &f_error))) {
+                json_decref (jobs);
+                return f_error;
+            }
+            if (!(J = flux_sign_wrap (sec, jobspecs[i], strlen (jobspecs[i]),
+                                      NULL, 0))) {
+                f_error = get_security_error (sec);
+                json_decref (jobs);
+                return f_error;
+            }
+#else
+            if (!(s = sign_none_wrap (jobspecs[i], strlen (jobspecs[i]),
+                                      getuid ())))
+                goto error;
+            J = s;
+#endif
+        }
+        else
+            J = jobspecs[i];
+        el = json_string (J);
+        free (s);
+        if (!el || json_array_append_new (jobs, el) < 0) {
+            json_decref (el);
+            errno = ENOMEM;
+            goto error;
+        }
+    }
+    flags &= ~FLUX_JOB_PRE_SIGNED; // client only flag
+    f = flux_rpc_pack (h, "job-ingest.bulk-submit", FLUX_NODEID_ANY, 0,
+                       "{s:O s:i s:i}",
+                       "jobs", jobs,
+                       "priority", priority,
+                       "flags", flags);
+    json_decref (jobs);
+    return f;
+error:
+    saved_errno = errno;
+    json_decref (jobs);
+    errno = saved_errno;
+    return NULL;
+}
+
+int flux_job_submit_bulk_get_id (flux_future_t *f, int index,
+                                 flux_jobid_t *jobid)
+{
+    json_t *jobs;
+    json_t *entry;
+    flux_jobid_t id;
+    int errnum;
+
+    if (!f || index < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (flux_rpc_get_unpack (f, "{s:o}", "jobs", &jobs) < 0)
+        return -1;
+    if (!(entry = json_array_get (jobs, index))) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (json_unpack (entry, "{s:I}", "id", &id) < 0) {
+        if (json_unpack (entry, "{s:i}", "errnum", &errnum) == 0)
+            errno = errnum;
+        else
+            errno = EPROTO;
+        return -1;
+    }
+    if (jobid)
+        *jobid = id;
+    return 0;
+}
+
 int flux_job_submit_get_id (flux_future_t *f, flux_jobid_t *jobid)
 {
     flux_jobid_t id;
@@ -102,6 +102,26 @@ flux_future_t *flux_job_submit (flux_t *h, const char *jobspec,
  */
 int flux_job_submit_get_id (flux_future_t *f, flux_jobid_t *id);
 
+/* Submit a batch of jobs to the system in one request.
+ * 'jobspecs' is an array of 'count' RFC 14 jobspecs.
+ * 'priority' and 'flags' apply to every job in the batch.
+ * Each job is assigned its own jobid, returned in request order.
+ */
+flux_future_t *flux_job_submit_bulk (flux_t *h,
+                                     const char **jobspecs,
+                                     int count,
+                                     int priority,
+                                     int flags);
+
+/* Parse the jobid assigned to the 'index'-th jobspec from the response
+ * to a flux_job_submit_bulk() request.
+ * Returns 0 on success, -1 on failure with errno set to the per-job
+ * ingest error for that jobspec.
+ */
+int flux_job_submit_bulk_get_id (flux_future_t *f,
+                                 int index,
+                                 flux_jobid_t *id);
+
 /* Wait for jobid to enter INACTIVE state.
  * If jobid=FLUX_JOBID_ANY, wait for the next waitable job.
  * Fails with ECHILD if there is nothing to wait for.
@@ -0,0 +1,77 @@
+/************************************************************\
+ * Copyright 2020 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <errno.h>
+#include <jansson.h>
+
+#include "src/common/libutil/blobref.h"
+#include "src/common/libutil/lru_cache.h"
+
+#include "jobspec_cache.h"
+
+/* Bound on distinct cached jobspecs per thread.  At high submit rates
+ * jobspecs tend to be either byte-identical (bulk resubmission) or
+ * unique, so a modest bound keeps the hit path hot without letting
+ * the cache grow with unique traffic.
+ */
+static const int jobspec_cache_maxsize = 256;
+
+static __thread lru_cache_t *cache = NULL;
+
+static void jobspec_free (void *arg)
+{
+    json_t *o = arg;
+    json_decref (o);
+}
+
+json_t *jobspec_cache_parse (const char *buf, int len, json_error_t *error)
+{
+    char blobref[BLOBREF_MAX_STRING_SIZE];
+    json_t *o;
+
+    if (!buf || len <= 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (blobref_hash ("sha1", buf, len, blobref, sizeof (blobref)) < 0)
+        return NULL;
+    if (!cache) {
+        if (!(cache = lru_cache_create (jobspec_cache_maxsize)))
+            return NULL;
+        lru_cache_set_free_f (cache, jobspec_free);
+    }
+    if ((o = lru_cache_get (cache, blobref)))
+        return json_incref (o);
+    if (!(o = json_loadb (buf, len, 0, error))) {
+        errno = EINVAL;
+        return NULL;
+    }
+    /* Cache keeps one reference; the caller gets its own.  If the
+     * insert fails the caller's reference is still valid, the parse
+     * just isn't shared.
+     */
+    if (lru_cache_put (cache, blobref, o) == 0)
+        json_incref (o);
+    return o;
+}
+
+void jobspec_cache_purge (void)
+{
+    lru_cache_destroy (cache);
+    cache = NULL;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
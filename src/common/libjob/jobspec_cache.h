@@ -0,0 +1,44 @@
+/************************************************************\
+ * Copyright 2020 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _FLUX_JOB_JOBSPEC_CACHE_H
+#define _FLUX_JOB_JOBSPEC_CACHE_H
+
+#include <jansson.h>
+
+/* Cache of parsed jobspec objects, keyed by a hash of the raw jobspec
+ * bytes.  Repeat parses of byte-identical jobspecs (common at high
+ * submit rates when workflow engines submit in bulk) share a single
+ * canonical parsed representation, including one copy of every
+ * attribute path key, instead of re-running the JSON parser.
+ *
+ * The cache is thread local, so each broker module thread parses a
+ * given jobspec at most once and no locking or cross-thread reference
+ * counting is required.
+ *
+ * The returned object is shared with the cache:  the caller receives
+ * its own reference, MUST treat the object as immutable, and drops it
+ * with json_decref() when finished.
+ *
+ * On parse failure, returns NULL with errno set (EINVAL if the buffer
+ * is not valid JSON, with 'error' filled in if non-NULL).
+ */
+json_t *jobspec_cache_parse (const char *buf, int len, json_error_t *error);
+
+/* Drop all entries cached by the calling thread (mainly for tests and
+ * leak checkers).
+ */
+void jobspec_cache_purge (void);
+
+#endif /* !_FLUX_JOB_JOBSPEC_CACHE_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
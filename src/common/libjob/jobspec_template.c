@@ -0,0 +1,246 @@
+/************************************************************\
+ * Copyright 2020 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <jansson.h>
+
+#include "jobspec_template.h"
+
+struct jobspec_template {
+    char **parts;       // count+1 literal segments of serialized jobspec
+    char **names;       // count placeholder names, in serialization order
+    int count;
+    size_t parts_len;   // total length of all literal segments
+};
+
+/* Match a placeholder starting at 's' (which points at '{').
+ * Return the length of the name, or 0 if this is not a placeholder.
+ * N.B. structural braces in compact-serialized JSON are never followed
+ * by a name character, so placeholders can only match inside strings.
+ */
+static size_t placeholder_match (const char *s)
+{
+    size_t len = 0;
+
+    if (s[0] != '{')
+        return 0;
+    if (!isalpha ((unsigned char)s[1]) && s[1] != '_')
+        return 0;
+    len = 1;
+    while (isalnum ((unsigned char)s[1 + len]) || s[1 + len] == '_')
+        len++;
+    if (s[1 + len] != '}')
+        return 0;
+    return len;
+}
+
+void jobspec_template_destroy (struct jobspec_template *t)
+{
+    if (t) {
+        int saved_errno = errno;
+        int i;
+        if (t->parts) {
+            for (i = 0; i < t->count + 1; i++)
+                free (t->parts[i]);
+            free (t->parts);
+        }
+        if (t->names) {
+            for (i = 0; i < t->count; i++)
+                free (t->names[i]);
+            free (t->names);
+        }
+        free (t);
+        errno = saved_errno;
+    }
+}
+
+struct jobspec_template *jobspec_template_create (const char *jobspec)
+{
+    struct jobspec_template *t;
+    json_t *o = NULL;
+    char *buf = NULL;
+    const char *p;
+    const char *start;
+    size_t len;
+    int count;
+    int i;
+    int saved_errno;
+
+    if (!jobspec) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(t = calloc (1, sizeof (*t))))
+        return NULL;
+    if (!(o = json_loads (jobspec, 0, NULL))) {
+        errno = EINVAL;
+        goto error;
+    }
+    if (!(buf = json_dumps (o, JSON_COMPACT))) {
+        errno = ENOMEM;
+        goto error;
+    }
+    /* First pass: count placeholders so arrays can be sized exactly.
+     */
+    count = 0;
+    for (p = buf; *p != '\0'; p++) {
+        if ((len = placeholder_match (p)) > 0) {
+            count++;
+            p += len + 1;
+        }
+    }
+    if (!(t->parts = calloc (count + 1, sizeof (t->parts[0]))))
+        goto error;
+    if (count > 0 && !(t->names = calloc (count, sizeof (t->names[0]))))
+        goto error;
+    /* Second pass: split the serialized buffer into literal segments
+     * around each placeholder, capturing placeholder names.
+     */
+    i = 0;
+    start = buf;
+    for (p = buf; *p != '\0'; p++) {
+        if ((len = placeholder_match (p)) > 0) {
+            if (!(t->parts[i] = strndup (start, p - start)))
+                goto error;
+            if (!(t->names[i] = strndup (p + 1, len)))
+                goto error;
+            t->parts_len += p - start;
+            t->count = ++i;
+            p += len + 1;
+            start = p + 1;
+        }
+    }
+    if (!(t->parts[i] = strdup (start)))
+        goto error;
+    t->parts_len += strlen (start);
+    json_decref (o);
+    free (buf);
+    return t;
+error:
+    saved_errno = errno;
+    jobspec_template_destroy (t);
+    json_decref (o);
+    free (buf);
+    errno = saved_errno;
+    return NULL;
+}
+
+int jobspec_template_placeholder_count (struct jobspec_template *t)
+{
+    if (!t) {
+        errno = EINVAL;
+        return -1;
+    }
+    return t->count;
+}
+
+const char *jobspec_template_placeholder (struct jobspec_template *t,
+                                          int index)
+{
+    if (!t || index < 0 || index >= t->count) {
+        errno = EINVAL;
+        return NULL;
+    }
+    return t->names[index];
+}
+
+/* Return the length of 's' once escaped for inclusion in a JSON string.
+ */
+static size_t escaped_length (const char *s)
+{
+    size_t len = 0;
+
+    while (*s != '\0') {
+        if (*s == '"' || *s == '\\')
+            len += 2;
+        else if ((unsigned char)*s < 0x20)
+            len += 6;   // \u00XX
+        else
+            len++;
+        s++;
+    }
+    return len;
+}
+
+/* Copy 's' to 'dst', escaping for inclusion in a JSON string.
+ * Return a pointer just past the copied characters.
+ */
+static char *escaped_copy (char *dst, const char *s)
+{
+    while (*s != '\0') {
+        if (*s == '"' || *s == '\\') {
+            *dst++ = '\\';
+            *dst++ = *s;
+        }
+        else if ((unsigned char)*s < 0x20) {
+            snprintf (dst, 7, "\\u%04x", (unsigned char)*s);
+            dst += 6;
+        }
+        else
+            *dst++ = *s;
+        s++;
+    }
+    return dst;
+}
+
+char *jobspec_template_render (struct jobspec_template *t, json_t *subs)
+{
+    const char **vals;
+    char *out = NULL;
+    char *cp;
+    size_t len;
+    int i;
+    int saved_errno;
+
+    if (!t || (t->count > 0 && !subs)) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(vals = calloc (t->count > 0 ? t->count : 1, sizeof (vals[0]))))
+        return NULL;
+    len = t->parts_len;
+    for (i = 0; i < t->count; i++) {
+        if (!(vals[i] = json_string_value (json_object_get (subs,
+                                                            t->names[i])))) {
+            errno = EINVAL;
+            goto error;
+        }
+        len += escaped_length (vals[i]);
+    }
+    if (!(out = malloc (len + 1)))
+        goto error;
+    cp = out;
+    for (i = 0; i < t->count; i++) {
+        size_t n = strlen (t->parts[i]);
+        memcpy (cp, t->parts[i], n);
+        cp += n;
+        cp = escaped_copy (cp, vals[i]);
+    }
+    strcpy (cp, t->parts[t->count]);
+    free (vals);
+    return out;
+error:
+    saved_errno = errno;
+    free (vals);
+    free (out);
+    errno = saved_errno;
+    return NULL;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -0,0 +1,53 @@
+/************************************************************\
+ * Copyright 2020 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _FLUX_JOB_JOBSPEC_TEMPLATE_H
+#define _FLUX_JOB_JOBSPEC_TEMPLATE_H
+
+#include <jansson.h>
+
+/* Compile a jobspec containing "{name}" placeholders in its string
+ * values into a template that can be rendered repeatedly without
+ * re-parsing or re-serializing the invariant parts.  The jobspec is
+ * parsed and serialized once at create time; each render only splices
+ * substitution values (JSON-escaped) into the preserialized buffer.
+ *
+ * Placeholder names match [A-Za-z_][A-Za-z0-9_]* and may appear more
+ * than once.  A jobspec with no placeholders is a valid template.
+ */
+
+struct jobspec_template;
+
+/* Create/destroy a template from RFC 14 jobspec 'jobspec'.
+ * On error, create returns NULL with errno set (EINVAL if the jobspec
+ * is not valid JSON).
+ */
+struct jobspec_template *jobspec_template_create (const char *jobspec);
+void jobspec_template_destroy (struct jobspec_template *t);
+
+/* Access the distinct placeholder occurrences in serialization order.
+ */
+int jobspec_template_placeholder_count (struct jobspec_template *t);
+const char *jobspec_template_placeholder (struct jobspec_template *t,
+                                          int index);
+
+/* Render the template, substituting each placeholder with its string
+ * value from the 'subs' JSON object.  All placeholders must be
+ * satisfied.  Returns a serialized jobspec that the caller must free,
+ * or NULL with errno set (EINVAL if a substitution is missing or not
+ * a string).
+ */
+char *jobspec_template_render (struct jobspec_template *t, json_t *subs);
+
+#endif /* !_FLUX_JOB_JOBSPEC_TEMPLATE_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
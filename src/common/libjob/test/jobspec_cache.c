@@ -0,0 +1,124 @@
+/************************************************************\
+ * Copyright 2020 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <errno.h>
+#include <string.h>
+#include <stdio.h>
+#include <jansson.h>
+
+#include "src/common/libjob/jobspec_cache.h"
+#include "src/common/libtap/tap.h"
+
+static const char *spec =
+    "{\"tasks\":[{\"command\":[\"hostname\"]}],"
+    "\"attributes\":{\"system\":{\"duration\":0}},\"version\":1}";
+
+static void check_badargs (void)
+{
+    errno = 0;
+    ok (jobspec_cache_parse (NULL, 1, NULL) == NULL && errno == EINVAL,
+        "jobspec_cache_parse (NULL, ...) returns EINVAL");
+    errno = 0;
+    ok (jobspec_cache_parse (spec, 0, NULL) == NULL && errno == EINVAL,
+        "jobspec_cache_parse with len=0 returns EINVAL");
+}
+
+static void check_invalid_json (void)
+{
+    json_error_t error;
+    const char *bad = "{not json";
+
+    memset (&error, 0, sizeof (error));
+    errno = 0;
+    ok (jobspec_cache_parse (bad, strlen (bad), &error) == NULL
+        && errno == EINVAL,
+        "jobspec_cache_parse of invalid JSON returns EINVAL");
+    ok (strlen (error.text) > 0,
+        "and error.text is set: %s", error.text);
+}
+
+static void check_sharing (void)
+{
+    json_t *o1;
+    json_t *o2;
+    int version = 0;
+
+    o1 = jobspec_cache_parse (spec, strlen (spec), NULL);
+    ok (o1 != NULL,
+        "jobspec_cache_parse works");
+    ok (json_unpack (o1, "{s:i}", "version", &version) == 0 && version == 1,
+        "parsed jobspec has expected content");
+
+    o2 = jobspec_cache_parse (spec, strlen (spec), NULL);
+    ok (o2 != NULL,
+        "jobspec_cache_parse of identical buffer works");
+    ok (o1 == o2,
+        "and returns the same shared object");
+
+    json_decref (o1);
+    json_decref (o2);
+}
+
+static void check_eviction (void)
+{
+    json_t *first;
+    json_t *o;
+    char buf[256];
+    int i;
+
+    jobspec_cache_purge ();
+
+    first = jobspec_cache_parse (spec, strlen (spec), NULL);
+    ok (first != NULL,
+        "parsed jobspec after purge");
+
+    /*  Push enough distinct jobspecs through the cache to evict the
+     *   first entry (cache is bounded at 256 entries).
+     */
+    for (i = 0; i < 300; i++) {
+        snprintf (buf, sizeof (buf),
+                  "{\"tasks\":[{\"command\":[\"job%d\"]}],\"version\":1}",
+                  i);
+        if (!(o = jobspec_cache_parse (buf, strlen (buf), NULL)))
+            break;
+        json_decref (o);
+    }
+    ok (i == 300,
+        "parsed 300 distinct jobspecs");
+
+    o = jobspec_cache_parse (spec, strlen (spec), NULL);
+    ok (o != NULL && o != first,
+        "evicted jobspec is re-parsed, not shared");
+
+    json_decref (o);
+    json_decref (first);
+}
+
+int main (int argc, char *argv[])
+{
+    plan (NO_PLAN);
+
+    check_badargs ();
+    check_invalid_json ();
+    check_sharing ();
+    check_eviction ();
+
+    jobspec_cache_purge ();
+
+    done_testing ();
+    return 0;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
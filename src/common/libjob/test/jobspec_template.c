@@ -0,0 +1,160 @@
+/************************************************************\
+ * Copyright 2020 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <errno.h>
+#include <string.h>
+#include <jansson.h>
+
+#include "src/common/libjob/jobspec_template.h"
+#include "src/common/libtap/tap.h"
+
+/* Minimal jobspec-shaped JSON with two placeholders, one repeated.
+ */
+static const char *spec =
+    "{\"tasks\":[{\"command\":[\"{cmd}\",\"{arg}\",\"{arg}\"]}],"
+    "\"attributes\":{\"system\":{\"duration\":0}},\"version\":1}";
+
+static const char *spec_noplaceholder =
+    "{\"tasks\":[{\"command\":[\"hostname\"]}],\"version\":1}";
+
+void check_render (void)
+{
+    struct jobspec_template *t;
+    json_t *subs;
+    json_t *o;
+    char *s;
+    const char *cmd;
+    const char *arg;
+
+    t = jobspec_template_create (spec);
+    ok (t != NULL,
+        "jobspec_template_create works");
+    ok (jobspec_template_placeholder_count (t) == 3,
+        "template has three placeholder occurrences");
+    ok (jobspec_template_placeholder (t, 0) != NULL
+        && !strcmp (jobspec_template_placeholder (t, 0), "cmd"),
+        "first placeholder is cmd");
+    ok (jobspec_template_placeholder (t, 1) != NULL
+        && !strcmp (jobspec_template_placeholder (t, 1), "arg"),
+        "second placeholder is arg");
+
+    if (!(subs = json_pack ("{s:s s:s}", "cmd", "hostname", "arg", "-f")))
+        BAIL_OUT ("json_pack failed");
+    s = jobspec_template_render (t, subs);
+    ok (s != NULL,
+        "jobspec_template_render works");
+    o = s ? json_loads (s, 0, NULL) : NULL;
+    ok (o != NULL,
+        "render output is valid JSON");
+    ok (o != NULL
+        && json_unpack (o, "{s:[{s:[s,s,s]}]}", "tasks",
+                        "command", &cmd, &arg, &arg) == 0
+        && !strcmp (cmd, "hostname")
+        && !strcmp (arg, "-f"),
+        "substitutions were spliced into the command");
+    json_decref (o);
+    free (s);
+
+    /* values requiring JSON escapes survive a render */
+    json_decref (subs);
+    if (!(subs = json_pack ("{s:s s:s}", "cmd", "echo", "arg", "a\"b\\c")))
+        BAIL_OUT ("json_pack failed");
+    s = jobspec_template_render (t, subs);
+    o = s ? json_loads (s, 0, NULL) : NULL;
+    ok (o != NULL
+        && json_unpack (o, "{s:[{s:[s,s,s]}]}", "tasks",
+                        "command", &cmd, &arg, &arg) == 0
+        && !strcmp (arg, "a\"b\\c"),
+        "substitution values are JSON-escaped");
+    json_decref (o);
+    free (s);
+
+    /* missing substitution fails */
+    json_object_del (subs, "arg");
+    errno = 0;
+    ok (jobspec_template_render (t, subs) == NULL && errno == EINVAL,
+        "render with missing substitution fails with EINVAL");
+
+    json_decref (subs);
+    jobspec_template_destroy (t);
+}
+
+void check_noplaceholder (void)
+{
+    struct jobspec_template *t;
+    json_t *o;
+    char *s;
+
+    t = jobspec_template_create (spec_noplaceholder);
+    ok (t != NULL,
+        "jobspec_template_create works with no placeholders");
+    ok (jobspec_template_placeholder_count (t) == 0,
+        "placeholder count is zero");
+    s = jobspec_template_render (t, NULL);
+    o = s ? json_loads (s, 0, NULL) : NULL;
+    ok (o != NULL,
+        "render with subs=NULL returns valid JSON");
+    json_decref (o);
+    free (s);
+    jobspec_template_destroy (t);
+}
+
+void check_badinput (void)
+{
+    struct jobspec_template *t;
+
+    errno = 0;
+    ok (jobspec_template_create (NULL) == NULL && errno == EINVAL,
+        "jobspec_template_create jobspec=NULL fails with EINVAL");
+    errno = 0;
+    ok (jobspec_template_create ("}not json{") == NULL && errno == EINVAL,
+        "jobspec_template_create with bad JSON fails with EINVAL");
+    errno = 0;
+    ok (jobspec_template_placeholder_count (NULL) < 0 && errno == EINVAL,
+        "jobspec_template_placeholder_count t=NULL fails with EINVAL");
+    errno = 0;
+    ok (jobspec_template_placeholder (NULL, 0) == NULL && errno == EINVAL,
+        "jobspec_template_placeholder t=NULL fails with EINVAL");
+    errno = 0;
+    ok (jobspec_template_render (NULL, NULL) == NULL && errno == EINVAL,
+        "jobspec_template_render t=NULL fails with EINVAL");
+
+    if (!(t = jobspec_template_create (spec)))
+        BAIL_OUT ("jobspec_template_create failed");
+    errno = 0;
+    ok (jobspec_template_placeholder (t, 99) == NULL && errno == EINVAL,
+        "jobspec_template_placeholder index=99 fails with EINVAL");
+    errno = 0;
+    ok (jobspec_template_render (t, NULL) == NULL && errno == EINVAL,
+        "jobspec_template_render subs=NULL fails with EINVAL");
+    jobspec_template_destroy (t);
+
+    lives_ok ({jobspec_template_destroy (NULL);},
+        "jobspec_template_destroy t=NULL doesn't crash");
+}
+
+int main (int argc, char *argv[])
+{
+    plan (NO_PLAN);
+
+    check_render ();
+    check_noplaceholder ();
+    check_badinput ();
+
+    done_testing ();
+    return 0;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -46,6 +46,104 @@ flux_future_t *flux_kvs_namespace_remove (flux_t *h, const char *ns)
                           "namespace", ns);
 }
 
+flux_future_t *flux_kvs_namespace_create_multi (flux_t *h, const char **ns,
+                                                int count, uint32_t owner,
+                                                int flags)
+{
+    json_t *namespaces;
+    flux_future_t *f;
+    int saved_errno;
+    int i;
+
+    if (!ns || count <= 0 || flags) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(namespaces = json_array ())) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    for (i = 0; i < count; i++) {
+        json_t *entry;
+
+        if (!ns[i]) {
+            errno = EINVAL;
+            goto error;
+        }
+        /* N.B. owner cast to int */
+        if (!(entry = json_pack ("{ s:s s:i s:i }",
+                                 "namespace", ns[i],
+                                 "owner", owner,
+                                 "flags", flags))) {
+            errno = ENOMEM;
+            goto error;
+        }
+        if (json_array_append_new (namespaces, entry) < 0) {
+            json_decref (entry);
+            errno = ENOMEM;
+            goto error;
+        }
+    }
+    f = flux_rpc_pack (h, "kvs.namespace-create-multi", 0, 0,
+                       "{ s:O }",
+                       "namespaces", namespaces);
+    saved_errno = errno;
+    json_decref (namespaces);
+    errno = saved_errno;
+    return f;
+error:
+    saved_errno = errno;
+    json_decref (namespaces);
+    errno = saved_errno;
+    return NULL;
+}
+
+flux_future_t *flux_kvs_namespace_remove_multi (flux_t *h, const char **ns,
+                                                int count)
+{
+    json_t *namespaces;
+    json_t *entry;
+    flux_future_t *f;
+    int saved_errno;
+    int i;
+
+    if (!ns || count <= 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(namespaces = json_array ())) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    for (i = 0; i < count; i++) {
+        if (!ns[i]) {
+            errno = EINVAL;
+            goto error;
+        }
+        if (!(entry = json_string (ns[i]))) {
+            errno = ENOMEM;
+            goto error;
+        }
+        if (json_array_append_new (namespaces, entry) < 0) {
+            json_decref (entry);
+            errno = ENOMEM;
+            goto error;
+        }
+    }
+    f = flux_rpc_pack (h, "kvs.namespace-remove-multi", 0, 0,
+                       "{ s:O }",
+                       "namespaces", namespaces);
+    saved_errno = errno;
+    json_decref (namespaces);
+    errno = saved_errno;
+    return f;
+error:
+    saved_errno = errno;
+    json_decref (namespaces);
+    errno = saved_errno;
+    return NULL;
+}
+
 int flux_kvs_get_version (flux_t *h, const char *ns, int *versionp)
 {
     flux_future_t *f;
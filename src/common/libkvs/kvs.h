@@ -35,7 +35,9 @@ enum kvs_op {
     FLUX_KVS_APPEND = 32,
     FLUX_KVS_WATCH_FULL = 64,
     FLUX_KVS_WATCH_UNIQ = 128,
-    FLUX_KVS_WATCH_APPEND = 256
+    FLUX_KVS_WATCH_APPEND = 256,
+    FLUX_KVS_CACHED = 512,     // lookupat only: consult client lookup cache
+    FLUX_KVS_WATCH_TAIL = 1024 // WATCH_APPEND: skip replay of current value
 };
 
 /* Namespace
@@ -51,6 +53,17 @@ flux_future_t *flux_kvs_namespace_create (flux_t *h, const char *ns,
                                           uint32_t owner, int flags);
 flux_future_t *flux_kvs_namespace_remove (flux_t *h, const char *ns);
 
+/* Batched forms of namespace create/remove: 'count' namespaces are
+ * created (all with the same owner and flags) or removed in one RPC.
+ * Operations are applied in order; on error the response names the
+ * first failing namespace, and earlier operations remain applied.
+ */
+flux_future_t *flux_kvs_namespace_create_multi (flux_t *h, const char **ns,
+                                                int count, uint32_t owner,
+                                                int flags);
+flux_future_t *flux_kvs_namespace_remove_multi (flux_t *h, const char **ns,
+                                                int count);
+
 /* Synchronization:
  * Process A commits data, then gets the store version V and sends it to B.
  * Process B waits for the store version to be >= V, then reads data.
@@ -13,7 +13,9 @@
 #endif
 #include <assert.h>
 #include <errno.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <jansson.h>
 #include <czmq.h>
 #include <flux/core.h>
@@ -156,6 +158,178 @@ int flux_kvs_getroot_get_treeobj (flux_future_t *f, const char **treeobj)
     return 0;
 }
 
+/* Root mirror - track current root info for a namespace by listening
+ * for its setroot events, so sync-heavy users can poll root sequence
+ * numbers without a kvs.getroot RPC per check.
+ */
+
+static const char *mirror_auxkey = "flux::rootmirror_ctx";
+
+struct rootmirror_ns {
+    flux_t *h;
+    flux_msg_handler_t *mh;
+    char *topic;
+    char *rootref;          /* NULL until first setroot event arrives */
+    int rootseq;
+    uint32_t owner;
+};
+
+struct rootmirror {
+    zhashx_t *roots;        /* namespace => struct rootmirror_ns */
+};
+
+static void rootmirror_ns_destroy (struct rootmirror_ns *mr)
+{
+    if (mr) {
+        int saved_errno = errno;
+        if (mr->topic)
+            (void)flux_event_unsubscribe (mr->h, mr->topic);
+        flux_msg_handler_destroy (mr->mh);
+        free (mr->topic);
+        free (mr->rootref);
+        free (mr);
+        errno = saved_errno;
+    }
+}
+
+/* zhashx_destructor_fn footprint */
+static void rootmirror_ns_destroy_wrapper (void **data)
+{
+    if (data) {
+        rootmirror_ns_destroy (*data);
+        (*data) = NULL;
+    }
+}
+
+static void rootmirror_destroy (struct rootmirror *rm)
+{
+    if (rm) {
+        int saved_errno = errno;
+        zhashx_destroy (&rm->roots);
+        free (rm);
+        errno = saved_errno;
+    }
+}
+
+static void rootmirror_event_cb (flux_t *h, flux_msg_handler_t *mh,
+                                 const flux_msg_t *msg, void *arg)
+{
+    struct rootmirror_ns *mr = arg;
+    const char *rootref;
+    int rootseq;
+    int owner;
+    char *cpy;
+
+    if (flux_event_unpack (msg, NULL, "{ s:i s:s s:i }",
+                           "rootseq", &rootseq,
+                           "rootref", &rootref,
+                           "owner", &owner) < 0)
+        return;
+    if (!(cpy = strdup (rootref)))
+        return;
+    free (mr->rootref);
+    mr->rootref = cpy;
+    mr->rootseq = rootseq;
+    mr->owner = (uint32_t)owner;
+}
+
+int flux_kvs_root_mirror_start (flux_t *h, const char *ns)
+{
+    struct rootmirror *rm;
+    struct rootmirror_ns *mr = NULL;
+    struct flux_match match = FLUX_MATCH_EVENT;
+
+    if (!h) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!ns && !(ns = kvs_get_namespace ()))
+        return -1;
+    if (!(rm = flux_aux_get (h, mirror_auxkey))) {
+        if (!(rm = calloc (1, sizeof (*rm))))
+            return -1;
+        if (!(rm->roots = zhashx_new ())) {
+            rootmirror_destroy (rm);
+            errno = ENOMEM;
+            return -1;
+        }
+        zhashx_set_destructor (rm->roots, rootmirror_ns_destroy_wrapper);
+        if (flux_aux_set (h, mirror_auxkey, rm,
+                          (flux_free_f)rootmirror_destroy) < 0) {
+            rootmirror_destroy (rm);
+            return -1;
+        }
+    }
+    if (zhashx_lookup (rm->roots, ns))
+        return 0;
+    if (!(mr = calloc (1, sizeof (*mr))))
+        return -1;
+    mr->h = h;
+    if (asprintf (&mr->topic, "kvs.namespace-%s-setroot", ns) < 0) {
+        errno = ENOMEM;
+        goto error;
+    }
+    match.topic_glob = mr->topic;
+    if (!(mr->mh = flux_msg_handler_create (h, match,
+                                            rootmirror_event_cb, mr)))
+        goto error;
+    flux_msg_handler_start (mr->mh);
+    if (flux_event_subscribe (h, mr->topic) < 0)
+        goto error;
+    if (zhashx_insert (rm->roots, ns, mr) < 0) {
+        errno = ENOMEM;
+        goto error;
+    }
+    return 0;
+
+error:
+    rootmirror_ns_destroy (mr);
+    return -1;
+}
+
+int flux_kvs_root_mirror_stop (flux_t *h, const char *ns)
+{
+    struct rootmirror *rm;
+
+    if (!h) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!ns && !(ns = kvs_get_namespace ()))
+        return -1;
+    if ((rm = flux_aux_get (h, mirror_auxkey)))
+        zhashx_delete (rm->roots, ns);
+    return 0;
+}
+
+int flux_kvs_root_mirror_get (flux_t *h, const char *ns,
+                              const char **rootref, int *rootseq,
+                              uint32_t *owner)
+{
+    struct rootmirror *rm;
+    struct rootmirror_ns *mr;
+
+    if (!h) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!ns && !(ns = kvs_get_namespace ()))
+        return -1;
+    if (!(rm = flux_aux_get (h, mirror_auxkey))
+        || !(mr = zhashx_lookup (rm->roots, ns))
+        || !mr->rootref) {
+        errno = EAGAIN;
+        return -1;
+    }
+    if (rootref)
+        *rootref = mr->rootref;
+    if (rootseq)
+        *rootseq = mr->rootseq;
+    if (owner)
+        *owner = mr->owner;
+    return 0;
+}
+
 /*
  * vi:tabstop=4 shiftwidth=4 expandtab
  */
@@ -30,6 +30,26 @@ int flux_kvs_getroot_get_blobref (flux_future_t *f, const char **blobref);
 int flux_kvs_getroot_get_sequence (flux_future_t *f, int *seq);
 int flux_kvs_getroot_get_owner (flux_future_t *f, uint32_t *owner);
 
+/* Maintain a local mirror of root info for namespace 'ns', updated
+ * from its setroot events as the reactor runs, as a cheap alternative
+ * to repeated flux_kvs_getroot() RPCs.
+ *
+ * flux_kvs_root_mirror_get() returns the most recently seen root
+ * blobref / sequence / owner.  It fails with EAGAIN if the mirror was
+ * not started or no setroot event has been seen yet, in which case
+ * the caller should fall back to flux_kvs_getroot().  Returned
+ * rootref remains owned by the handle and is valid until the next
+ * reactor run or flux_kvs_root_mirror_stop().
+ *
+ * Note that setroot events are not delivered to guest connections;
+ * guests must use flux_kvs_getroot().
+ */
+int flux_kvs_root_mirror_start (flux_t *h, const char *ns);
+int flux_kvs_root_mirror_stop (flux_t *h, const char *ns);
+int flux_kvs_root_mirror_get (flux_t *h, const char *ns,
+                              const char **rootref, int *rootseq,
+                              uint32_t *owner);
+
 #ifdef __cplusplus
 }
 #endif
@@ -18,16 +18,27 @@
 #include <czmq.h>
 #include <flux/core.h>
 
+#include "src/common/libutil/lru_cache.h"
+
 #include "kvs_dir_private.h"
 #include "kvs_lookup.h"
 #include "kvs_util_private.h"
 #include "treeobj.h"
 
+/* Max entries in the per-handle cache of FLUX_KVS_CACHED lookupat
+ * results.  Results are keyed by (root treeobj, key, flags), which are
+ * immutable by construction since the root reference is
+ * content-addressed, so no invalidation is required.
+ */
+static const int lookup_cache_maxsize = 256;
+
 struct lookup_ctx {
     flux_t *h;
     char *key;
     char *atref;
     int flags;
+    char *cache_key;   // non-NULL if result should be inserted in cache
+    bool cached;       // result was served from cache
 
     json_t *treeobj;
     char *treeobj_str; // json_dumps of tree object returned from lookup
@@ -42,13 +53,15 @@ static const char *auxkey = "flux::lookup_ctx";
 
 #define FLUX_KVS_WATCH_FLAGS (FLUX_KVS_WATCH_FULL \
                               | FLUX_KVS_WATCH_UNIQ \
-                              | FLUX_KVS_WATCH_APPEND)
+                              | FLUX_KVS_WATCH_APPEND \
+                              | FLUX_KVS_WATCH_TAIL)
 
 static void free_ctx (struct lookup_ctx *ctx)
 {
     if (ctx) {
         free (ctx->key);
         free (ctx->atref);
+        free (ctx->cache_key);
         json_decref (ctx->treeobj);
         free (ctx->treeobj_str);
         free (ctx->val_data);
@@ -82,6 +95,9 @@ static int validate_lookup_flags (int flags, bool watch_ok)
     if ((flags & FLUX_KVS_WATCH_FLAGS)
         && !(flags & FLUX_KVS_WATCH))
         return -1;
+    if ((flags & FLUX_KVS_WATCH_TAIL)
+        && !(flags & FLUX_KVS_WATCH_APPEND))
+        return -1;
     /* FLUX_KVS_WAITCREATE does not require FLUX_KVS_WATCH to be set,
      * but it requires that we be able to communicate with the
      * kvs-watch module, so we use the watch_ok bool here.
@@ -94,6 +110,8 @@ static int validate_lookup_flags (int flags, bool watch_ok)
 
     flags &= ~FLUX_KVS_WAITCREATE;
 
+    flags &= ~FLUX_KVS_CACHED;
+
     switch (flags) {
         case 0:
         case FLUX_KVS_TREEOBJ:
@@ -106,17 +124,25 @@ static int validate_lookup_flags (int flags, bool watch_ok)
     }
 }
 
-flux_future_t *flux_kvs_lookup (flux_t *h,
-                                const char *ns,
-                                int flags,
-                                const char *key)
+/* Common implementation of flux_kvs_lookup() and flux_kvs_lookup_offset().
+ * 'offset' < 0 means no offset was supplied.
+ */
+static flux_future_t *lookup_rpc (flux_t *h,
+                                  const char *ns,
+                                  int flags,
+                                  const char *key,
+                                  int offset)
 {
     struct lookup_ctx *ctx;
     flux_future_t *f;
     const char *topic = "kvs.lookup";
     int rpc_flags = 0;
 
+    /* N.B. FLUX_KVS_CACHED requires an immutable root snapshot, so it
+     * is only valid with flux_kvs_lookupat().
+     */
     if (!h || !key || strlen (key) == 0
+        || (flags & FLUX_KVS_CACHED)
         || validate_lookup_flags (flags, true) < 0) {
         errno = EINVAL;
         return NULL;
@@ -132,11 +158,20 @@ flux_future_t *flux_kvs_lookup (flux_t *h,
         topic = "kvs-watch.lookup"; // redirect to kvs-watch module
     if ((flags & FLUX_KVS_WATCH))
         rpc_flags |= FLUX_RPC_STREAMING;
-    if (!(f = flux_rpc_pack (h, topic, FLUX_NODEID_ANY, rpc_flags,
-                             "{s:s s:s s:i}",
-                             "key", key,
-                             "namespace", ns,
-                             "flags", flags))) {
+    if (offset >= 0)
+        f = flux_rpc_pack (h, topic, FLUX_NODEID_ANY, rpc_flags,
+                           "{s:s s:s s:i s:i}",
+                           "key", key,
+                           "namespace", ns,
+                           "flags", flags,
+                           "offset", offset);
+    else
+        f = flux_rpc_pack (h, topic, FLUX_NODEID_ANY, rpc_flags,
+                           "{s:s s:s s:i}",
+                           "key", key,
+                           "namespace", ns,
+                           "flags", flags);
+    if (!f) {
         free_ctx (ctx);
         return NULL;
     }
@@ -148,6 +183,71 @@ flux_future_t *flux_kvs_lookup (flux_t *h,
     return f;
 }
 
+flux_future_t *flux_kvs_lookup (flux_t *h,
+                                const char *ns,
+                                int flags,
+                                const char *key)
+{
+    return lookup_rpc (h, ns, flags, key, -1);
+}
+
+flux_future_t *flux_kvs_lookup_offset (flux_t *h,
+                                       const char *ns,
+                                       int flags,
+                                       const char *key,
+                                       int offset)
+{
+    /* An offset is only meaningful to a watch that replays appends.
+     */
+    if (offset < 0
+        || !(flags & FLUX_KVS_WATCH)
+        || !(flags & FLUX_KVS_WATCH_APPEND)) {
+        errno = EINVAL;
+        return NULL;
+    }
+    return lookup_rpc (h, ns, flags, key, offset);
+}
+
+static lru_cache_t *lookup_cache_get (flux_t *h)
+{
+    const char *auxname = "flux::lookupat_cache";
+    lru_cache_t *lru;
+
+    if (!(lru = flux_aux_get (h, auxname))) {
+        if (!(lru = lru_cache_create (lookup_cache_maxsize)))
+            return NULL;
+        lru_cache_set_free_f (lru, free);
+        if (flux_aux_set (h, auxname, lru,
+                          (flux_free_f)lru_cache_destroy) < 0) {
+            lru_cache_destroy (lru);
+            return NULL;
+        }
+    }
+    return lru;
+}
+
+/* Serve a FLUX_KVS_CACHED lookupat from the cached treeobj string 's',
+ * fulfilling the returned future without an RPC.
+ */
+static flux_future_t *lookup_cache_hit (flux_t *h, struct lookup_ctx *ctx,
+                                        const char *s)
+{
+    flux_future_t *f;
+
+    if (!(ctx->treeobj = treeobj_decode (s)))
+        return NULL;
+    ctx->cached = true;
+    if (!(f = flux_future_create (NULL, NULL)))
+        return NULL;
+    flux_future_set_flux (f, h);
+    if (flux_future_aux_set (f, auxkey, ctx, (flux_free_f)free_ctx) < 0) {
+        flux_future_destroy (f);
+        return NULL;
+    }
+    flux_future_fulfill (f, NULL, NULL);
+    return f;
+}
+
 flux_future_t *flux_kvs_lookupat (flux_t *h, int flags, const char *key,
                                   const char *treeobj)
 {
@@ -166,6 +266,22 @@ flux_future_t *flux_kvs_lookupat (flux_t *h, int flags, const char *key,
         return NULL;
     if (!(ctx->atref = strdup (treeobj)))
         return NULL;
+    if ((flags & FLUX_KVS_CACHED)) {
+        lru_cache_t *lru;
+        const char *s;
+
+        if (asprintf (&ctx->cache_key, "%d:%s:%s",
+                      flags, treeobj, key) < 0) {
+            free_ctx (ctx);
+            return NULL;
+        }
+        if ((lru = lookup_cache_get (h))
+            && (s = lru_cache_get (lru, ctx->cache_key))) {
+            if (!(f = lookup_cache_hit (h, ctx, s)))
+                free_ctx (ctx);
+            return f;
+        }
+    }
     if (!(obj = json_loads (treeobj, 0, NULL))) {
         errno = EINVAL;
         return NULL;
@@ -173,7 +289,7 @@ flux_future_t *flux_kvs_lookupat (flux_t *h, int flags, const char *key,
     if (!(f = flux_rpc_pack (h, "kvs.lookup", FLUX_NODEID_ANY, 0,
                              "{s:s s:i s:O}",
                              "key", key,
-                             "flags", flags,
+                             "flags", flags & ~FLUX_KVS_CACHED,
                              "rootdir", obj))) {
         free_ctx (ctx);
         json_decref (obj);
@@ -223,8 +339,24 @@ static int parse_response (flux_future_t *f, struct lookup_ctx *ctx)
 {
     json_t *treeobj2;
 
+    /* Result was served from the lookup cache - ctx->treeobj is
+     * already populated and there is no RPC response to parse.
+     */
+    if (ctx->cached)
+        return 0;
     if (decode_treeobj (f, &treeobj2) < 0)
         return -1;
+    if (ctx->cache_key && !ctx->treeobj) {
+        lru_cache_t *lru;
+        char *s;
+
+        if ((lru = lookup_cache_get (ctx->h))
+            && !lru_cache_check (lru, ctx->cache_key)
+            && (s = treeobj_encode (treeobj2))) {
+            if (lru_cache_put (lru, ctx->cache_key, s) < 0)
+                free (s);
+        }
+    }
     if (!ctx->treeobj || !json_equal (ctx->treeobj, treeobj2)) {
         json_decref (ctx->treeobj);
         ctx->treeobj = json_incref (treeobj2);
@@ -390,6 +522,193 @@ const char *flux_kvs_lookup_get_key (flux_future_t *f)
 }
 
 
+/* Multi-key lookup from one consistent snapshot:  a getroot RPC pins
+ * the root, then each key is fetched with flux_kvs_lookupat() against
+ * the pinned root in parallel.  Per-key results are delegated to the
+ * child lookup futures, so all flux_kvs_lookup_get() machinery (val
+ * decode, caching, etc.) is reused.
+ */
+
+static const char *multi_auxkey = "flux::lookup_multi";
+
+struct multi_ctx {
+    flux_t *h;
+    char *ns;
+    int flags;
+    char **keys;
+    int count;
+
+    flux_future_t *f_root;
+    flux_future_t **children;
+    int pending;
+    bool done;
+};
+
+static void multi_ctx_destroy (struct multi_ctx *ctx)
+{
+    if (ctx) {
+        int saved_errno = errno;
+        int i;
+        flux_future_destroy (ctx->f_root);
+        for (i = 0; i < ctx->count; i++) {
+            if (ctx->keys)
+                free (ctx->keys[i]);
+            if (ctx->children)
+                flux_future_destroy (ctx->children[i]);
+        }
+        free (ctx->keys);
+        free (ctx->children);
+        free (ctx->ns);
+        free (ctx);
+        errno = saved_errno;
+    }
+}
+
+static struct multi_ctx *multi_ctx_create (flux_t *h, const char *ns,
+                                           int flags, const char **keys,
+                                           int count)
+{
+    struct multi_ctx *ctx;
+    int i;
+
+    if (!(ctx = calloc (1, sizeof (*ctx))))
+        return NULL;
+    ctx->h = h;
+    ctx->flags = flags;
+    ctx->count = count;
+    ctx->pending = count;
+    if (!(ctx->ns = strdup (ns))
+        || !(ctx->keys = calloc (count, sizeof (ctx->keys[0])))
+        || !(ctx->children = calloc (count, sizeof (ctx->children[0]))))
+        goto error;
+    for (i = 0; i < count; i++) {
+        if (!(ctx->keys[i] = strdup (keys[i])))
+            goto error;
+    }
+    return ctx;
+error:
+    multi_ctx_destroy (ctx);
+    errno = ENOMEM;
+    return NULL;
+}
+
+static void multi_fail (flux_future_t *f, struct multi_ctx *ctx, int errnum)
+{
+    if (!ctx->done) {
+        ctx->done = true;
+        flux_future_fulfill_error (f, errnum, NULL);
+    }
+}
+
+static void multi_lookup_cb (flux_future_t *fc, void *arg)
+{
+    flux_future_t *f = arg;
+    struct multi_ctx *ctx = flux_future_aux_get (f, multi_auxkey);
+
+    if (!ctx || ctx->done)
+        return;
+    if (flux_future_get (fc, NULL) < 0) {
+        multi_fail (f, ctx, errno);
+        return;
+    }
+    if (--ctx->pending == 0) {
+        ctx->done = true;
+        flux_future_fulfill (f, NULL, NULL);
+    }
+}
+
+static void multi_root_cb (flux_future_t *fr, void *arg)
+{
+    flux_future_t *f = arg;
+    struct multi_ctx *ctx = flux_future_aux_get (f, multi_auxkey);
+    const char *treeobj;
+    int i;
+
+    if (!ctx)
+        return;
+    if (flux_kvs_getroot_get_treeobj (fr, &treeobj) < 0)
+        goto error;
+    for (i = 0; i < ctx->count; i++) {
+        if (!(ctx->children[i] = flux_kvs_lookupat (ctx->h, ctx->flags,
+                                                    ctx->keys[i], treeobj))
+            || flux_future_then (ctx->children[i], -1.,
+                                 multi_lookup_cb, f) < 0)
+            goto error;
+    }
+    return;
+error:
+    multi_fail (f, ctx, errno);
+}
+
+static void multi_init_cb (flux_future_t *f, void *arg)
+{
+    struct multi_ctx *ctx = arg;
+
+    if (ctx->f_root)  // initialization may run once per dispatch context
+        return;
+    if (!(ctx->f_root = flux_kvs_getroot (ctx->h, ctx->ns, 0))
+        || flux_future_then (ctx->f_root, -1., multi_root_cb, f) < 0)
+        multi_fail (f, ctx, errno);
+}
+
+flux_future_t *flux_kvs_lookup_multi (flux_t *h, const char *ns, int flags,
+                                      const char **keys, int count)
+{
+    struct multi_ctx *ctx;
+    flux_future_t *f;
+    int i;
+
+    if (!h || !keys || count <= 0
+        || validate_lookup_flags (flags, false) < 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+    for (i = 0; i < count; i++) {
+        if (!keys[i] || strlen (keys[i]) == 0) {
+            errno = EINVAL;
+            return NULL;
+        }
+    }
+    if (!ns) {
+        if (!(ns = kvs_get_namespace ()))
+            return NULL;
+    }
+    if (!(ctx = multi_ctx_create (h, ns, flags, keys, count)))
+        return NULL;
+    if (!(f = flux_future_create (multi_init_cb, ctx))) {
+        multi_ctx_destroy (ctx);
+        return NULL;
+    }
+    flux_future_set_flux (f, h);
+    if (flux_future_aux_set (f, multi_auxkey, ctx,
+                             (flux_free_f)multi_ctx_destroy) < 0) {
+        multi_ctx_destroy (ctx);
+        flux_future_destroy (f);
+        return NULL;
+    }
+    return f;
+}
+
+int flux_kvs_lookup_multi_get (flux_future_t *f, const char *key,
+                               const char **value)
+{
+    struct multi_ctx *ctx;
+    int i;
+
+    if (!f || !key || !(ctx = flux_future_aux_get (f, multi_auxkey))) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (flux_future_get (f, NULL) < 0)
+        return -1;
+    for (i = 0; i < ctx->count; i++) {
+        if (!strcmp (ctx->keys[i], key))
+            return flux_kvs_lookup_get (ctx->children[i], value);
+    }
+    errno = ENOENT;
+    return -1;
+}
+
 /* This only applies with FLUX_KVS_WATCH.
  * Causes a stream of lookup responses to end with an ENODATA response.
  */
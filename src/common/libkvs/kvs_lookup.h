@@ -31,6 +31,34 @@ int flux_kvs_lookup_get_symlink (flux_future_t *f,
 
 const char *flux_kvs_lookup_get_key (flux_future_t *f);
 
+/* Like flux_kvs_lookup() with FLUX_KVS_WATCH | FLUX_KVS_WATCH_APPEND
+ * (which must both be set in 'flags'), except replay of the current
+ * value starts at byte 'offset' instead of the beginning, e.g. to
+ * resume a watch after counting the bytes received so far.  An offset
+ * past the current end of the value starts at the end, like
+ * FLUX_KVS_WATCH_TAIL.
+ * Returns future on success, NULL on failure with errno set.
+ */
+flux_future_t *flux_kvs_lookup_offset (flux_t *h, const char *ns, int flags,
+                                       const char *key, int offset);
+
+/* Look up 'count' keys from one consistent root snapshot.  The root is
+ * pinned with a single getroot RPC, then all keys are fetched against
+ * it in parallel, so values can never straddle a commit.  'flags' are
+ * as for flux_kvs_lookupat() (FLUX_KVS_WATCH is not valid).
+ * The future is fulfilled once all keys have been fetched.
+ * Returns future on success, NULL on failure with errno set.
+ */
+flux_future_t *flux_kvs_lookup_multi (flux_t *h, const char *ns, int flags,
+                                      const char **keys, int count);
+
+/* Access the value fetched for 'key' by flux_kvs_lookup_multi().
+ * Semantics match flux_kvs_lookup_get().  Fails with ENOENT if 'key'
+ * was not in the looked-up set.
+ */
+int flux_kvs_lookup_multi_get (flux_future_t *f, const char *key,
+                               const char **value);
+
 /* Cancel a FLUX_KVS_WATCH "stream".
  * Once the cancel request is processed, an ENODATA error response is sent,
  * thus the user should continue to reset and consume responses until an
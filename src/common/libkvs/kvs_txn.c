@@ -64,6 +64,25 @@ error:
     return NULL;
 }
 
+int flux_kvs_txn_clear (flux_kvs_txn_t *txn)
+{
+    if (!txn) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* Operations are serialized into the commit request when
+     * flux_kvs_commit() is called, so a transaction may be cleared and
+     * refilled for the next commit as soon as that call returns.  The
+     * ops array keeps its allocated capacity across clears, so bulk
+     * writers reusing one transaction avoid repeated array growth.
+     */
+    if (json_array_clear (txn->ops) < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    return 0;
+}
+
 static int validate_flags (int flags, int allowed)
 {
     if ((flags & allowed) != flags) {
@@ -22,6 +22,13 @@ typedef struct flux_kvs_txn flux_kvs_txn_t;
 flux_kvs_txn_t *flux_kvs_txn_create (void);
 void flux_kvs_txn_destroy (flux_kvs_txn_t *txn);
 
+/* Remove all operations so the transaction can be reused for another
+ * commit.  Safe once flux_kvs_commit()/flux_kvs_fence() has returned,
+ * as operations are copied into the request message at that point.
+ * Returns 0 on success, -1 on failure with errno set.
+ */
+int flux_kvs_txn_clear (flux_kvs_txn_t *txn);
+
 int flux_kvs_txn_put (flux_kvs_txn_t *txn, int flags,
                       const char *key, const char *value);
 
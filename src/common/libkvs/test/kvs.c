@@ -31,6 +31,16 @@ void errors (void)
     ok (flux_kvs_namespace_remove (NULL, NULL) == NULL && errno == EINVAL,
         "flux_kvs_namespace_remove fails on bad input");
 
+    errno = 0;
+    ok (flux_kvs_namespace_create_multi (NULL, NULL, 0, 0, 0) == NULL
+        && errno == EINVAL,
+        "flux_kvs_namespace_create_multi fails on bad input");
+
+    errno = 0;
+    ok (flux_kvs_namespace_remove_multi (NULL, NULL, 0) == NULL
+        && errno == EINVAL,
+        "flux_kvs_namespace_remove_multi fails on bad input");
+
     errno = 0;
     ok (flux_kvs_get_version (NULL, NULL, NULL) < 0 && errno == EINVAL,
         "flux_kvs_get_version fails on bad input");
@@ -66,6 +66,17 @@ void errors (void)
     ok (flux_kvs_getroot_get_treeobj (f, &s) < 0 && errno == EINVAL,
         "flux_kvs_getroot_get_treeobj f=(non-getroot) fails with EINVAL");
 
+    errno = 0;
+    ok (flux_kvs_root_mirror_start (NULL, "foo") < 0 && errno == EINVAL,
+        "flux_kvs_root_mirror_start h=NULL fails with EINVAL");
+    errno = 0;
+    ok (flux_kvs_root_mirror_stop (NULL, "foo") < 0 && errno == EINVAL,
+        "flux_kvs_root_mirror_stop h=NULL fails with EINVAL");
+    errno = 0;
+    ok (flux_kvs_root_mirror_get (NULL, "foo", &s, &i, &u32) < 0
+        && errno == EINVAL,
+        "flux_kvs_root_mirror_get h=NULL fails with EINVAL");
+
     flux_future_destroy (f);
 }
 
@@ -33,6 +33,39 @@ void errors (void)
     ok (flux_kvs_lookupat (NULL, 0, NULL, NULL) == NULL && errno == EINVAL,
         "flux_kvs_lookupat fails on bad input");
 
+    errno = 0;
+    ok (flux_kvs_lookup (NULL, NULL, FLUX_KVS_CACHED, "foo") == NULL
+        && errno == EINVAL,
+        "flux_kvs_lookup fails with FLUX_KVS_CACHED (lookupat only)");
+
+    errno = 0;
+    ok (flux_kvs_lookup (NULL, NULL,
+                         FLUX_KVS_WATCH | FLUX_KVS_WATCH_TAIL,
+                         "foo") == NULL
+        && errno == EINVAL,
+        "flux_kvs_lookup fails with WATCH_TAIL but not WATCH_APPEND");
+
+    errno = 0;
+    ok (flux_kvs_lookup_offset (NULL, NULL, 0, "foo", 0) == NULL
+        && errno == EINVAL,
+        "flux_kvs_lookup_offset fails without watch append flags");
+
+    errno = 0;
+    ok (flux_kvs_lookup_offset (NULL, NULL,
+                                FLUX_KVS_WATCH | FLUX_KVS_WATCH_APPEND,
+                                "foo", -1) == NULL
+        && errno == EINVAL,
+        "flux_kvs_lookup_offset fails with negative offset");
+
+    errno = 0;
+    ok (flux_kvs_lookup_multi (NULL, NULL, 0, NULL, 0) == NULL
+        && errno == EINVAL,
+        "flux_kvs_lookup_multi fails on bad input");
+
+    errno = 0;
+    ok (flux_kvs_lookup_multi_get (NULL, NULL, NULL) < 0 && errno == EINVAL,
+        "flux_kvs_lookup_multi_get fails on bad input");
+
     errno = 0;
     ok (flux_kvs_lookup_get (NULL, NULL) < 0 && errno == EINVAL,
         "flux_kvs_lookup_get fails on bad input");
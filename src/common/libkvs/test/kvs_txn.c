@@ -292,6 +292,19 @@ void basic (void)
     ok (txn_get_op (txn, 9, &entry) < 0 && errno == EINVAL,
         "10: invalid (end of transaction)");
 
+    /* Clear and reuse the transaction.
+     */
+    errno = 0;
+    ok (flux_kvs_txn_clear (NULL) < 0 && errno == EINVAL,
+        "flux_kvs_txn_clear fails on NULL txn");
+    ok (flux_kvs_txn_clear (txn) == 0,
+        "flux_kvs_txn_clear works");
+    ok (txn_get_op_count (txn) == 0,
+        "cleared txn has zero ops");
+    ok (flux_kvs_txn_put (txn, 0, "a.b.c", "val") == 0
+        && txn_get_op_count (txn) == 1,
+        "cleared txn can be refilled");
+
     flux_kvs_txn_destroy (txn);
 }
 
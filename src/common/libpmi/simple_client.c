@@ -188,6 +188,15 @@ int pmi_simple_client_kvs_get_my_name (struct pmi_simple_client *pmi,
         return PMI_ERR_INIT;
     if (!kvsname || length <= 0)
         return PMI_ERR_INVALID_ARG;
+    /* The kvsname is fixed for the life of the client, so it is only
+     * fetched over the wire once.
+     */
+    if (pmi->kvsname) {
+        if (strlen (pmi->kvsname) >= (size_t)length)
+            return PMI_ERR_INVALID_LENGTH;
+        strcpy (kvsname, pmi->kvsname);
+        return PMI_SUCCESS;
+    }
     if (dprintf (pmi->fd, "cmd=get_my_kvsname\n") < 0)
         goto done;
     if (dgetline (pmi->fd, pmi->buf, pmi->buflen) < 0)
@@ -200,6 +209,7 @@ int pmi_simple_client_kvs_get_my_name (struct pmi_simple_client *pmi,
     }
     if (keyval_parse_word (pmi->buf, "kvsname", kvsname, length) < 0)
         goto done;
+    pmi->kvsname = strdup (kvsname); // cache best effort (NULL ok)
     result = PMI_SUCCESS;
 done:
     return result;
@@ -266,7 +276,10 @@ done:
 /* Helper for get_clique_size(), get_clique_ranks().
  * Fetch 'PMI_process_mapping' from the KVS and parse.
  * On success, results are placed in blocks, nblocks, nodeid.
- * The caller must free 'blocks'.
+ * The parsed blocks are cached in the client (the mapping is set by
+ * the process manager before clients start and never changes), so only
+ * the first call costs wire protocol round trips.  'blocks' is owned
+ * by the client and must not be freed by the caller.
  */
 static int fetch_process_mapping (struct pmi_simple_client *pmi,
                                   struct pmi_map_block **blocks,
@@ -275,27 +288,34 @@ static int fetch_process_mapping (struct pmi_simple_client *pmi,
 {
     const char *key = "PMI_process_mapping";
     int result;
-    char *nom;
-    char *val;
+    char *nom = NULL;
+    char *val = NULL;
 
     assert (pmi != NULL);
     assert (pmi->initialized);
 
-    nom = calloc (1, pmi->kvsname_max);
-    val = calloc (1, pmi->vallen_max);
-    if (!nom || !val) {
-        result = PMI_ERR_NOMEM;
-        goto done;
+    if (!pmi->blocks) {
+        nom = calloc (1, pmi->kvsname_max);
+        val = calloc (1, pmi->vallen_max);
+        if (!nom || !val) {
+            result = PMI_ERR_NOMEM;
+            goto done;
+        }
+        result = pmi_simple_client_kvs_get_my_name (pmi, nom,
+                                                    pmi->kvsname_max);
+        if (result != PMI_SUCCESS)
+            goto done;
+        result = pmi_simple_client_kvs_get (pmi, nom, key, val,
+                                            pmi->vallen_max);
+        if (result != PMI_SUCCESS)
+            goto done;
+        result = pmi_process_mapping_parse (val, &pmi->blocks, &pmi->nblocks);
+        if (result != PMI_SUCCESS)
+            goto done;
     }
-    result = pmi_simple_client_kvs_get_my_name (pmi, nom, pmi->kvsname_max);
-    if (result != PMI_SUCCESS)
-        goto done;
-    result = pmi_simple_client_kvs_get (pmi, nom, key, val, pmi->vallen_max);
-    if (result != PMI_SUCCESS)
-        goto done;
-    result = pmi_process_mapping_parse (val, blocks, nblocks);
-    if (result != PMI_SUCCESS)
-        goto done;
+    *blocks = pmi->blocks;
+    *nblocks = pmi->nblocks;
+    result = PMI_SUCCESS;
     if (pmi_process_mapping_find_nodeid (*blocks, *nblocks,
                                          pmi->rank, nodeid) != PMI_SUCCESS)
         *nodeid = -1;
@@ -325,7 +345,6 @@ int pmi_simple_client_get_clique_size (struct pmi_simple_client *pmi,
     else
         result = pmi_process_mapping_find_nranks (blocks, nblocks, nodeid,
                                                   pmi->size, size);
-    free (blocks);
     return result;
 }
 
@@ -352,7 +371,6 @@ int pmi_simple_client_get_clique_ranks (struct pmi_simple_client *pmi,
     else
         result = pmi_process_mapping_find_ranks (blocks, nblocks, nodeid,
                                                  pmi->size, ranks, length);
-    free (blocks);
     return result;
 }
 
@@ -408,6 +426,8 @@ void pmi_simple_client_destroy (struct pmi_simple_client *pmi)
         if (pmi->fd != -1)
             (void)close (pmi->fd);
         free (pmi->buf);
+        free (pmi->kvsname);
+        free (pmi->blocks);
         free (pmi);
         errno = saved_errno;
     }
@@ -14,6 +14,8 @@
 #include "src/common/libutil/aux.h"
 #include "src/common/libflux/types.h"
 
+struct pmi_map_block; // clique.h
+
 struct pmi_simple_client {
     // valid upon creation
     int rank;
@@ -31,6 +33,12 @@ struct pmi_simple_client {
     int buflen;
     int fd;
     struct aux_item *aux;
+
+    // cached server responses that cannot change for the life of the
+    // client, so repeated queries avoid wire protocol round trips
+    char *kvsname;
+    struct pmi_map_block *blocks;
+    int nblocks;
 };
 
 /* Create/destroy
@@ -16,6 +16,7 @@
 #include <flux/core.h>
 
 #include "src/common/libutil/errno_safe.h"
+#include "src/common/libutil/monotime.h"
 
 #include "router.h"
 #include "subhash.h"
@@ -39,6 +40,12 @@ struct router {
     struct servhash *services;
     flux_msg_handler_t **handlers;
     bool mute;
+    struct {                        // event fanout statistics
+        int nevents;
+        int nsent;
+        double total_ms;
+        double max_ms;
+    } fanout;
 };
 
 /* Generate internal response and 'msg' (success or failure only,
@@ -67,6 +74,12 @@ static void router_entry_respond (struct router_entry *entry,
         goto done;
     if (flux_msg_set_matchtag (rmsg, matchtag) < 0)
         goto done;
+    /* Internal responses (sub/unsub, service add/remove, disconnect)
+     * are small and latency-sensitive with no ordering relationship to
+     * other traffic - let them bypass queued bulk data.
+     */
+    if (flux_msg_set_control (rmsg) < 0)
+        goto done;
     if (entry->send (rmsg, entry->arg) < 0) {
         if (errno != EPIPE && errnum != ECONNRESET) {
             flux_log_error (rtr->h,
@@ -236,12 +249,13 @@ static int broker_unsubscribe (const char *topic, void *arg)
 
 /* A client asks the router to subscribe.
  * This might generate a broker_subscribe() or just usecount++.
+ * The client entry is indexed on the topic for event fanout.
  */
 static int router_subscribe (const char *topic, void *arg)
 {
-    struct router *rtr = arg;
+    struct router_entry *entry = arg;
 
-    return subhash_subscribe (rtr->subscriptions, topic);
+    return subhash_subscribe_owner (entry->rtr->subscriptions, topic, entry);
 }
 
 /* A client asks the router to unsubscribe.
@@ -249,9 +263,9 @@ static int router_subscribe (const char *topic, void *arg)
  */
 static int router_unsubscribe (const char *topic, void *arg)
 {
-    struct router *rtr = arg;
+    struct router_entry *entry = arg;
 
-    return subhash_unsubscribe (rtr->subscriptions, topic);
+    return subhash_unsubscribe_owner (entry->rtr->subscriptions, topic, entry);
 }
 
 static void disconnect_cb (const flux_msg_t *msg, void *arg)
@@ -326,16 +340,16 @@ struct router_entry *router_entry_add (struct router *rtr,
 
     if (!(entry = router_entry_create (uuid, cb, arg)))
         return NULL;
+    entry->rtr = rtr;
 
-    subhash_set_subscribe (entry->subscriptions, router_subscribe, rtr);
-    subhash_set_unsubscribe (entry->subscriptions, router_unsubscribe, rtr);
+    subhash_set_subscribe (entry->subscriptions, router_subscribe, entry);
+    subhash_set_unsubscribe (entry->subscriptions, router_unsubscribe, entry);
 
     if (zhashx_insert (rtr->routes, uuid, entry) < 0) {
         router_entry_destroy (entry);
         errno = EEXIST;
         return NULL;
     }
-    entry->rtr = rtr;
     return entry;
 }
 
@@ -409,8 +423,28 @@ error:
     flux_msg_destroy (cpy);
 }
 
+struct event_fanout {
+    flux_t *h;
+    const flux_msg_t *msg;
+    int nsent;
+};
+
+/* subhash_owner_f footprint - deliver event to one subscribed client.
+ */
+static void event_fanout_cb (void *owner, void *arg)
+{
+    struct router_entry *entry = owner;
+    struct event_fanout *fan = arg;
+
+    if (entry->send (fan->msg, entry->arg) < 0)
+        flux_log_error (fan->h, "router: event > client=%.5s", entry->uuid);
+    fan->nsent++;
+}
+
 /* Receive event from broker.
- * Distribute to all router entries with matching subscriptions.
+ * Distribute via the router's subscriber index, which visits exactly
+ * the entries with matching subscriptions rather than testing every
+ * client's subscriptions against the topic.
  */
 static void event_cb (flux_t *h,
                       flux_msg_handler_t *mh,
@@ -418,22 +452,50 @@ static void event_cb (flux_t *h,
                       void *arg)
 {
     struct router *rtr = arg;
-    struct router_entry *entry;
+    struct event_fanout fan = { .h = h, .msg = msg, .nsent = 0 };
     const char *topic;
+    struct timespec t0;
+    double ms;
 
     if (flux_msg_get_topic (msg, &topic) < 0) {
         flux_log_error (h, "router: event > client");
         return;
     }
 
-    entry = zhashx_first (rtr->routes);
-    while ((entry)) {
-        if (subhash_topic_match (entry->subscriptions, topic)) {
-            if (entry->send (msg, entry->arg) < 0)
-                flux_log_error (h, "router: event > client=%.5s", entry->uuid);
-        }
-        entry = zhashx_next (rtr->routes);
+    monotime (&t0);
+    if (subhash_match_foreach (rtr->subscriptions,
+                               topic,
+                               event_fanout_cb,
+                               &fan) < 0)
+        flux_log_error (h, "router: event %s > clients", topic);
+    ms = monotime_since (t0);
+
+    rtr->fanout.nevents++;
+    rtr->fanout.nsent += fan.nsent;
+    rtr->fanout.total_ms += ms;
+    if (ms > rtr->fanout.max_ms)
+        rtr->fanout.max_ms = ms;
+}
+
+int router_get_fanout_stats (struct router *rtr,
+                             int *nevents,
+                             int *nsent,
+                             double *total_ms,
+                             double *max_ms)
+{
+    if (!rtr) {
+        errno = EINVAL;
+        return -1;
     }
+    if (nevents)
+        *nevents = rtr->fanout.nevents;
+    if (nsent)
+        *nsent = rtr->fanout.nsent;
+    if (total_ms)
+        *total_ms = rtr->fanout.total_ms;
+    if (max_ms)
+        *max_ms = rtr->fanout.max_ms;
+    return 0;
 }
 
 static const struct flux_msg_handler_spec htab[] = {
@@ -45,6 +45,16 @@ void router_destroy (struct router *rtr);
  */
 void router_mute (struct router *rtr);
 
+/* Fetch event fanout statistics: events distributed, total client
+ * deliveries, and total/max fanout time in milliseconds.  Any of the
+ * result pointers may be NULL.
+ */
+int router_get_fanout_stats (struct router *rtr,
+                             int *nevents,
+                             int *nsent,
+                             double *total_ms,
+                             double *max_ms);
+
 
 #endif /* !_ROUTER_ROUTER_H */
 
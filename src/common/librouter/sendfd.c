@@ -49,12 +49,108 @@
 #endif
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <sys/uio.h>
 #include <flux/core.h>
 
 #include "sendfd.h"
 
 #define IOBUF_MAGIC 0xffee0012
 
+/* Max iovec entries for gathered sends: the 8 byte header plus
+ * two entries (length prefix + data) per message frame.
+ */
+#define SENDFD_MAXIOV (1 + 2*16)
+
+/* Gather the message frames straight to the socket with writev(2),
+ * skipping assembly into a contiguous buffer.  The 8 byte header and
+ * the frame length prefixes are staged in io->buf_fixed, which is
+ * otherwise unused since this path is only taken for messages too big
+ * to assemble there.  Returns bytes written (possibly short), or -1
+ * with errno set.
+ */
+static ssize_t sendfd_writev (int fd, const flux_msg_t *msg, struct iobuf *io)
+{
+    struct iovec iov[SENDFD_MAXIOV];
+    int niov;
+
+    *(uint32_t *)&io->buf_fixed[0] = IOBUF_MAGIC;
+    *(uint32_t *)&io->buf_fixed[4] = htonl (io->size - 8);
+    iov[0].iov_base = io->buf_fixed;
+    iov[0].iov_len = 8;
+    if ((niov = flux_msg_encode_iovec (msg,
+                                       &io->buf_fixed[8],
+                                       sizeof (io->buf_fixed) - 8,
+                                       &iov[1],
+                                       SENDFD_MAXIOV - 1)) < 0)
+        return -1;
+    return writev (fd, iov, niov + 1);
+}
+
+/* Cap on bytes encoded into one batch, so a long queue of large
+ * messages does not provoke a huge temporary allocation.  A batch
+ * always admits at least one message regardless of size.
+ */
+#define SENDFD_BATCH_BYTES 1048576
+
+int sendfd_batch (int fd,
+                  const flux_msg_t **msgs,
+                  int count,
+                  struct iobuf *iobuf,
+                  int *consumed)
+{
+    int rc = -1;
+
+    if (fd < 0 || !iobuf || !consumed || count < 0 || (count > 0 && !msgs)) {
+        errno = EINVAL;
+        return -1;
+    }
+    *consumed = 0;
+    if (!iobuf->buf) {
+        size_t total = 0;
+        size_t off = 0;
+        int n = 0;
+        int i;
+
+        if (count == 0) {
+            errno = EINVAL;
+            return -1;
+        }
+        for (i = 0; i < count; i++) {
+            size_t need = flux_msg_encode_size (msgs[i]) + 8;
+            if (i > 0 && total + need > SENDFD_BATCH_BYTES)
+                break;
+            total += need;
+            n++;
+        }
+        if (total <= sizeof (iobuf->buf_fixed))
+            iobuf->buf = iobuf->buf_fixed;
+        else if (!(iobuf->buf = malloc (total)))
+            return -1;
+        iobuf->size = total;
+        iobuf->done = 0;
+        for (i = 0; i < n; i++) {
+            size_t size = flux_msg_encode_size (msgs[i]) + 8;
+            *(uint32_t *)&iobuf->buf[off] = IOBUF_MAGIC;
+            *(uint32_t *)&iobuf->buf[off + 4] = htonl (size - 8);
+            if (flux_msg_encode (msgs[i], &iobuf->buf[off + 8], size - 8) < 0)
+                goto done;
+            off += size;
+        }
+        *consumed = n;
+    }
+    do {
+        rc = write (fd, iobuf->buf + iobuf->done, iobuf->size - iobuf->done);
+        if (rc < 0)
+            goto done;
+        iobuf->done += rc;
+    } while (iobuf->done < iobuf->size);
+    rc = 0;
+done:
+    if (rc == 0 || (errno != EAGAIN && errno != EWOULDBLOCK))
+        iobuf_clean (iobuf);
+    return rc == 0 ? 0 : -1;
+}
+
 void iobuf_init (struct iobuf *iobuf)
 {
     memset (iobuf, 0, sizeof (*iobuf));
@@ -80,7 +176,24 @@ int sendfd (int fd, const flux_msg_t *msg, struct iobuf *iobuf)
     if (!iobuf)
         iobuf_init (&local);
     if (!io->buf) {
+        size_t done = 0;
+
         io->size = flux_msg_encode_size (msg) + 8;
+        /* Large messages: gather frames to the socket with writev(2)
+         * if they fit in the iovec.  On a short write, fall through and
+         * assemble the unsent remainder for the normal restartable path.
+         */
+        if (io->size > sizeof (io->buf_fixed)
+            && flux_msg_frames (msg) * 2 + 1 <= SENDFD_MAXIOV) {
+            ssize_t n = sendfd_writev (fd, msg, io);
+            if (n < 0)
+                goto done;
+            if (n == io->size) {
+                rc = 0;
+                goto done;
+            }
+            done = n;
+        }
         if (io->size <= sizeof (io->buf_fixed))
             io->buf = io->buf_fixed;
         else if (!(io->buf = malloc (io->size)))
@@ -89,7 +202,7 @@ int sendfd (int fd, const flux_msg_t *msg, struct iobuf *iobuf)
         *(uint32_t *)&io->buf[4] = htonl (io->size - 8);
         if (flux_msg_encode (msg, &io->buf[8], io->size - 8) < 0)
             goto done;
-        io->done = 0;
+        io->done = done;
     }
     do {
         rc = write (fd, io->buf + io->done, io->size - io->done);
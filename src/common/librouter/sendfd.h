@@ -26,6 +26,20 @@ struct iobuf {
  */
 int sendfd (int fd, const flux_msg_t *msg, struct iobuf *iobuf);
 
+/* Send up to 'count' messages from 'msgs' as one gathered write.
+ * Messages admitted to the batch are encoded into the iobuf up front and
+ * their number stored in 'consumed'; the caller may release them
+ * immediately since further calls on the same iobuf complete transmission
+ * after EAGAIN/EWOULDBLOCK (a resumed call consumes no new messages).
+ * A non-NULL iobuf is required.
+ * Returns 0 when the iobuf is fully flushed, -1 on failure with errno set.
+ */
+int sendfd_batch (int fd,
+                  const flux_msg_t **msgs,
+                  int count,
+                  struct iobuf *iobuf,
+                  int *consumed);
+
 /* Receive message from file descriptor.
  * iobuf captures intermediate state to make EAGAIN/EWOULDBLOCK restartable.
  * Returns message on success, NULL on failure with errno set.
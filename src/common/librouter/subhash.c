@@ -30,6 +30,13 @@
  *
  * subhash_topic_match() can be used to test if a message topic matches any
  * subscription topics for a given subhash, as an aid to event distribution.
+ *
+ * For fanout, a subhash may additionally index subscribers: registering
+ * with subhash_subscribe_owner() attaches an opaque 'owner' (e.g. the
+ * client) to the topic entry, and subhash_match_foreach() visits each
+ * distinct owner with a matching subscription.  Since topic entries are
+ * deduplicated across owners, distribution cost scales with the number
+ * of distinct subscription topics rather than the number of clients.
  */
 
 #if HAVE_CONFIG_H
@@ -47,6 +54,7 @@ struct subhash_entry {
     char *topic;
     int refcount;
     struct subhash *sh;
+    zlistx_t *owners;   // one item per subhash_subscribe_owner(), not owned
 };
 
 struct subhash {
@@ -66,6 +74,7 @@ static void subhash_entry_destroy (struct subhash_entry *entry)
     if (entry) {
         if (entry->sh && entry->sh->unsub)
             (void)entry->sh->unsub (entry->topic, entry->sh->unsub_arg);
+        ERRNO_SAFE_WRAP (zlistx_destroy, &entry->owners);
         ERRNO_SAFE_WRAP (free, entry->topic);
         ERRNO_SAFE_WRAP (free, entry);
     }
@@ -148,6 +157,94 @@ int subhash_subscribe (struct subhash *sh, const char *topic)
     return 0;
 }
 
+int subhash_subscribe_owner (struct subhash *sh, const char *topic, void *owner)
+{
+    struct subhash_entry *entry;
+
+    if (!owner) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (subhash_subscribe (sh, topic) < 0)
+        return -1;
+    entry = zhashx_lookup (sh->subs, topic);
+    if (!entry->owners && !(entry->owners = zlistx_new ())) {
+        (void)subhash_unsubscribe (sh, topic);
+        errno = ENOMEM;
+        return -1;
+    }
+    if (!zlistx_add_end (entry->owners, owner)) {
+        (void)subhash_unsubscribe (sh, topic);
+        errno = ENOMEM;
+        return -1;
+    }
+    return 0;
+}
+
+int subhash_unsubscribe_owner (struct subhash *sh,
+                               const char *topic,
+                               void *owner)
+{
+    struct subhash_entry *entry;
+
+    if (!owner) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (sh && topic
+        && (entry = zhashx_lookup (sh->subs, topic))
+        && entry->owners) {
+        void *handle;
+        if ((handle = zlistx_find (entry->owners, owner)))
+            zlistx_detach (entry->owners, handle);
+    }
+    return subhash_unsubscribe (sh, topic);
+}
+
+int subhash_match_foreach (struct subhash *sh,
+                           const char *topic,
+                           subhash_owner_f cb,
+                           void *arg)
+{
+    struct subhash_entry *entry;
+    zlistx_t *visited;
+    int rc = -1;
+
+    if (!sh || !topic || !cb) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* An owner subscribed to multiple topics matching this one must
+     * only be visited once, so track who has been seen.  Match sets
+     * are expected to be small, so a linear membership test suffices.
+     */
+    if (!(visited = zlistx_new ())) {
+        errno = ENOMEM;
+        return -1;
+    }
+    entry = zhashx_first (sh->subs);
+    while (entry) {
+        if (entry->owners && match_event (entry->topic, topic)) {
+            void *owner = zlistx_first (entry->owners);
+            while (owner) {
+                if (!zlistx_find (visited, owner)) {
+                    if (!zlistx_add_end (visited, owner)) {
+                        errno = ENOMEM;
+                        goto done;
+                    }
+                    cb (owner, arg);
+                }
+                owner = zlistx_next (entry->owners);
+            }
+        }
+        entry = zhashx_next (sh->subs);
+    }
+    rc = 0;
+done:
+    ERRNO_SAFE_WRAP (zlistx_destroy, &visited);
+    return rc;
+}
+
 int subhash_unsubscribe (struct subhash *sh, const char *topic)
 {
     struct subhash_entry *entry;
@@ -14,6 +14,9 @@
 // same proto used for both subscribe and unsubscribe
 typedef int (*subscribe_f)(const char *topic, void *arg);
 
+// called once per distinct matching owner by subhash_match_foreach()
+typedef void (*subhash_owner_f)(void *owner, void *arg);
+
 struct subhash *subhash_create (void);
 void subhash_destroy (struct subhash *sub);
 
@@ -25,6 +28,25 @@ bool subhash_topic_match (struct subhash *sh, const char *topic);
 int subhash_subscribe (struct subhash *sh, const char *topic);
 int subhash_unsubscribe (struct subhash *sh, const char *topic);
 
+/* Like subhash_subscribe() / subhash_unsubscribe(), but also maintain
+ * an index of subscribers: each subscribe attaches one reference to
+ * opaque 'owner' on the topic entry, and each unsubscribe removes one.
+ */
+int subhash_subscribe_owner (struct subhash *sh,
+                             const char *topic,
+                             void *owner);
+int subhash_unsubscribe_owner (struct subhash *sh,
+                               const char *topic,
+                               void *owner);
+
+/* Call 'cb' once for each distinct owner with a subscription matching
+ * 'topic'.  Only subscriptions registered with an owner are visited.
+ */
+int subhash_match_foreach (struct subhash *sh,
+                           const char *topic,
+                           subhash_owner_f cb,
+                           void *arg);
+
 
 
 #endif /* !_ROUTER_SUBHASH_H */
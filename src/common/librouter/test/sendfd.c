@@ -292,9 +292,49 @@ next:
     free (buf);
 }
 
+void test_batch (void)
+{
+    int pfd[2];
+    flux_msg_t *msg[3];
+    const flux_msg_t *cmsgs[3];
+    flux_msg_t *msg2;
+    struct iobuf iobuf;
+    const char *topic;
+    int consumed = -1;
+    char name[32];
+    int i;
+
+    if (pipe2 (pfd, O_CLOEXEC) < 0)
+        BAIL_OUT ("pipe2 failed");
+    iobuf_init (&iobuf);
+    for (i = 0; i < 3; i++) {
+        snprintf (name, sizeof (name), "foo.%d", i);
+        if (!(msg[i] = flux_request_encode (name, NULL)))
+            BAIL_OUT ("flux_request_encode failed");
+        cmsgs[i] = msg[i];
+    }
+    ok (sendfd_batch (pfd[1], cmsgs, 3, &iobuf, &consumed) == 0
+        && consumed == 3,
+        "sendfd_batch sent 3 messages");
+    for (i = 0; i < 3; i++) {
+        snprintf (name, sizeof (name), "foo.%d", i);
+        ok ((msg2 = recvfd (pfd[0], NULL)) != NULL
+            && flux_request_decode (msg2, &topic, NULL) == 0
+            && !strcmp (topic, name),
+            "recvfd returned batched message %d intact", i);
+        flux_msg_destroy (msg2);
+        flux_msg_destroy (msg[i]);
+    }
+    iobuf_clean (&iobuf);
+    close (pfd[0]);
+    close (pfd[1]);
+}
+
 void test_inval (void)
 {
     flux_msg_t *msg;
+    struct iobuf iobuf;
+    int consumed;
 
     if (!(msg = flux_msg_create (FLUX_MSGTYPE_REQUEST)))
         BAIL_OUT ("flux_msg_create failed");
@@ -310,6 +350,19 @@ void test_inval (void)
     ok (sendfd (0, NULL, NULL) < 0 && errno == EINVAL,
         "senfd msg=NULL fails with EINVAL");
 
+    iobuf_init (&iobuf);
+    errno = 0;
+    ok (sendfd_batch (0, NULL, 1, &iobuf, &consumed) < 0 && errno == EINVAL,
+        "sendfd_batch msgs=NULL fails with EINVAL");
+    errno = 0;
+    ok (sendfd_batch (0, (const flux_msg_t **)&msg, 1, &iobuf, NULL) < 0
+        && errno == EINVAL,
+        "sendfd_batch consumed=NULL fails with EINVAL");
+    errno = 0;
+    ok (sendfd_batch (0, (const flux_msg_t **)&msg, 1, NULL, &consumed) < 0
+        && errno == EINVAL,
+        "sendfd_batch iobuf=NULL fails with EINVAL");
+
     flux_msg_destroy (msg);
 }
 
@@ -324,6 +377,7 @@ int main (int argc, char *argv[])
     test_nonblock (4096, 256);
     test_nonblock (16384, 64);
     test_nonblock (1048586, 1);
+    test_batch ();
     test_inval ();
 
     done_testing();
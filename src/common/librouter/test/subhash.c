@@ -11,6 +11,7 @@
 #if HAVE_CONFIG_H
 #include "config.h"
 #endif
+#include <string.h>
 #include <flux/core.h>
 
 #include "src/common/libtap/tap.h"
@@ -150,6 +151,72 @@ void test_callbacks_rc (void)
     subhash_destroy (sub);
 }
 
+struct visit {
+    void *owners[8];
+    int count;
+};
+
+void visit_cb (void *owner, void *arg)
+{
+    struct visit *v = arg;
+
+    if (v->count < 8)
+        v->owners[v->count] = owner;
+    v->count++;
+}
+
+void test_owners (void)
+{
+    struct subhash *sub;
+    struct visit v;
+    int client1, client2;
+
+    if (!(sub = subhash_create ()))
+        BAIL_OUT ("subhash_create failed");
+
+    ok (subhash_subscribe_owner (sub, "foo", &client1) == 0,
+        "subhash_subscribe_owner foo client1");
+    ok (subhash_subscribe_owner (sub, "foo", &client2) == 0,
+        "subhash_subscribe_owner foo client2");
+    ok (subhash_subscribe_owner (sub, "foo.bar", &client2) == 0,
+        "subhash_subscribe_owner foo.bar client2");
+    ok (subhash_subscribe_owner (sub, "baz", &client2) == 0,
+        "subhash_subscribe_owner baz client2");
+
+    memset (&v, 0, sizeof (v));
+    ok (subhash_match_foreach (sub, "foo.bar.event", visit_cb, &v) == 0
+        && v.count == 2,
+        "subhash_match_foreach visits client2 once despite two matches");
+
+    memset (&v, 0, sizeof (v));
+    ok (subhash_match_foreach (sub, "baz.event", visit_cb, &v) == 0
+        && v.count == 1
+        && v.owners[0] == &client2,
+        "subhash_match_foreach baz.event visits only client2");
+
+    memset (&v, 0, sizeof (v));
+    ok (subhash_match_foreach (sub, "nomatch", visit_cb, &v) == 0
+        && v.count == 0,
+        "subhash_match_foreach visits nobody on no match");
+
+    ok (subhash_unsubscribe_owner (sub, "foo", &client1) == 0,
+        "subhash_unsubscribe_owner foo client1");
+    memset (&v, 0, sizeof (v));
+    ok (subhash_match_foreach (sub, "foo.event", visit_cb, &v) == 0
+        && v.count == 1
+        && v.owners[0] == &client2,
+        "subhash_match_foreach foo.event now visits only client2");
+
+    errno = 0;
+    ok (subhash_subscribe_owner (sub, "foo", NULL) < 0 && errno == EINVAL,
+        "subhash_subscribe_owner owner=NULL fails with EINVAL");
+    errno = 0;
+    ok (subhash_match_foreach (sub, "foo", NULL, NULL) < 0 && errno == EINVAL,
+        "subhash_match_foreach cb=NULL fails with EINVAL");
+
+    subhash_destroy (sub);
+}
+
 void test_errors (void)
 {
     struct subhash *sub;
@@ -192,6 +259,7 @@ int main (int argc, char *argv[])
     test_topic_match ();
     test_callbacks ();
     test_callbacks_rc ();
+    test_owners ();
     test_errors ();
 
     done_testing ();
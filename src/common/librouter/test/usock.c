@@ -142,6 +142,32 @@ void conn_invalid (void)
     ok (usock_conn_send (conn, NULL) < 0 && errno == EINVAL,
         "usock_conn_send msg=NULL fails with EINVAL");
 
+    errno = 0;
+    ok (usock_conn_get_queue_stats (NULL, NULL, NULL, NULL) < 0
+        && errno == EINVAL,
+        "usock_conn_get_queue_stats conn=NULL fails with EINVAL");
+
+    usock_conn_set_queue_limit (conn, 1);
+    ok (usock_conn_send (conn, msg) == 0,
+        "usock_conn_send works with queue at limit-1");
+    errno = 0;
+    ok (usock_conn_send (conn, msg) < 0 && errno == ENOBUFS,
+        "usock_conn_send fails with ENOBUFS with queue at limit");
+    int depth, maxdepth, full;
+    ok (usock_conn_get_queue_stats (conn, &depth, &maxdepth, &full) == 0
+        && depth == 1
+        && maxdepth == 1
+        && full == 1,
+        "usock_conn_get_queue_stats reports depth=1 maxdepth=1 full=1");
+
+    if (flux_msg_set_control (msg) < 0)
+        BAIL_OUT ("flux_msg_set_control failed");
+    ok (usock_conn_send (conn, msg) == 0,
+        "usock_conn_send accepts control message with queue at limit");
+    ok (usock_conn_get_queue_stats (conn, &depth, NULL, NULL) == 0
+        && depth == 2,
+        "and queue depth includes the control lane");
+
     errno = 0;
     ok (usock_conn_create (NULL, 0, 0) == NULL && errno == EINVAL,
         "usock_conn_create r=NULL fails with EINVAL");
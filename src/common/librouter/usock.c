@@ -55,7 +55,13 @@
 #include "usock.h"
 #include "sendfd.h"
 
-#define LISTEN_BACKLOG 5
+#define LISTEN_BACKLOG 128
+
+/* Connections accepted per server wakeup.  Draining a burst in one
+ * callback avoids a reactor loop per connection, while the cap keeps
+ * an accept stampede from starving other watchers.
+ */
+#define ACCEPT_BATCH_COUNT 16
 
 #ifndef UUID_STR_LEN
 #define UUID_STR_LEN 37     // defined in later libuuid headers
@@ -81,7 +87,11 @@ struct usock_conn {
     struct flux_msg_cred cred;
     struct usock_io in;
     struct usock_io out;
-    zlist_t *outqueue;
+    zlist_t *outqueue;          /* bulk lane */
+    zlist_t *outqueue_hi;       /* control lane - drained first */
+    int send_queue_limit;       // max outqueue depth (0 = unlimited)
+    int send_queue_maxdepth;    // high watermark for stats
+    int send_queue_full;        // sends refused at the limit
 
     usock_conn_close_f close_cb;
     void *close_arg;
@@ -180,17 +190,67 @@ static void conn_io_error (struct usock_conn *conn, int errnum)
     }
 }
 
+void usock_conn_set_queue_limit (struct usock_conn *conn, int limit)
+{
+    if (conn && limit >= 0)
+        conn->send_queue_limit = limit;
+}
+
+int usock_conn_get_queue_stats (struct usock_conn *conn,
+                                int *depth,
+                                int *maxdepth,
+                                int *full)
+{
+    if (!conn) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (depth)
+        *depth = zlist_size (conn->outqueue) + zlist_size (conn->outqueue_hi);
+    if (maxdepth)
+        *maxdepth = conn->send_queue_maxdepth;
+    if (full)
+        *full = conn->send_queue_full;
+    return 0;
+}
+
 int usock_conn_send (struct usock_conn *conn, const flux_msg_t *msg)
 {
+    zlist_t *q;
+    int depth;
+
     if (!conn || !msg) {
         errno = EINVAL;
         return -1;
     }
-    if (zlist_append (conn->outqueue, (void *)flux_msg_incref (msg)) < 0) {
+    /* Messages marked with the control flag go out on a priority lane
+     * that is drained ahead of queued bulk data, and are admitted even
+     * when the queue is at its limit, so e.g. a cancel response is not
+     * delayed (or refused) because of a large transfer in progress.
+     */
+    if (flux_msg_is_control (msg))
+        q = conn->outqueue_hi;
+    else {
+        /* Bound memory consumed on behalf of a peer that has stopped
+         * reading.  The caller decides whether a refused send is fatal
+         * to the connection or the message is simply dropped.
+         */
+        if (conn->send_queue_limit > 0
+            && zlist_size (conn->outqueue) >= conn->send_queue_limit) {
+            conn->send_queue_full++;
+            errno = ENOBUFS;
+            return -1;
+        }
+        q = conn->outqueue;
+    }
+    if (zlist_append (q, (void *)flux_msg_incref (msg)) < 0) {
         flux_msg_decref (msg);
         errno = ENOMEM;
         return -1;
     }
+    depth = zlist_size (conn->outqueue) + zlist_size (conn->outqueue_hi);
+    if (depth > conn->send_queue_maxdepth)
+        conn->send_queue_maxdepth = depth;
     flux_watcher_start (conn->out.w);
     return 0;
 }
@@ -229,15 +289,24 @@ error:
     conn_io_error (conn, errno);
 }
 
+/* Drop the next queued message, control lane first - mirroring the
+ * order messages are gathered for encoding in conn_write_cb().
+ */
 static int conn_outqueue_drop (struct usock_conn *conn)
 {
-    flux_msg_t *msg = zlist_pop (conn->outqueue);
+    flux_msg_t *msg = zlist_pop (conn->outqueue_hi);
+    if (msg == NULL)
+        msg = zlist_pop (conn->outqueue);
     if (msg == NULL)
         return 0;
     flux_msg_decref (msg);
     return 1;
 }
 
+/* Max messages gathered into one sendfd_batch() call per POLLOUT event.
+ */
+#define SEND_BATCH_COUNT 64
+
 static void conn_write_cb (flux_reactor_t *r,
                            flux_watcher_t *w,
                            int revents,
@@ -251,9 +320,35 @@ static void conn_write_cb (flux_reactor_t *r,
     }
 
     if ((revents & FLUX_POLLOUT)) {
-        const flux_msg_t *msg = zlist_head (conn->outqueue);
-        if (msg) {
-            if (sendfd (conn->out.fd, msg, &conn->out.iobuf) < 0) {
+        const flux_msg_t *msgs[SEND_BATCH_COUNT];
+        const flux_msg_t *msg;
+        int count = 0;
+        int consumed = 0;
+
+        /* Gather queued messages so they go out in one write, rather
+         * than one write (and one reactor loop) per message.  Batched
+         * messages are dropped from the queue as soon as they are
+         * encoded into the iobuf, so the queue may be empty here while
+         * a partially written batch remains to be flushed.
+         */
+        msg = zlist_first (conn->outqueue_hi);
+        while (msg && count < SEND_BATCH_COUNT) {
+            msgs[count++] = msg;
+            msg = zlist_next (conn->outqueue_hi);
+        }
+        msg = zlist_first (conn->outqueue);
+        while (msg && count < SEND_BATCH_COUNT) {
+            msgs[count++] = msg;
+            msg = zlist_next (conn->outqueue);
+        }
+        if (count > 0 || conn->out.iobuf.buf != NULL) {
+            if (sendfd_batch (conn->out.fd,
+                              msgs,
+                              count,
+                              &conn->out.iobuf,
+                              &consumed) < 0) {
+                while (consumed-- > 0)
+                    (void) conn_outqueue_drop (conn);
                 if (errno == EPIPE) {
                     /* Remote peer has closed connection.
                      * However, there may still be pending messages sent
@@ -270,8 +365,10 @@ static void conn_write_cb (flux_reactor_t *r,
                     goto error;
             }
             else {
-                (void) conn_outqueue_drop (conn);
-                if (zlist_size (conn->outqueue) == 0)
+                while (consumed-- > 0)
+                    (void) conn_outqueue_drop (conn);
+                if (zlist_size (conn->outqueue) == 0
+                        && zlist_size (conn->outqueue_hi) == 0)
                     flux_watcher_stop (conn->out.w);
             }
         }
@@ -337,6 +434,12 @@ void usock_conn_destroy (struct usock_conn *conn)
                 flux_msg_decref (msg);
             zlist_destroy (&conn->outqueue);
         }
+        if (conn->outqueue_hi) {
+            const flux_msg_t *msg;
+            while ((msg = zlist_pop (conn->outqueue_hi)))
+                flux_msg_decref (msg);
+            zlist_destroy (&conn->outqueue_hi);
+        }
         flux_watcher_destroy (conn->out.w);
         iobuf_clean (&conn->out.iobuf);
         if (conn->server)
@@ -362,6 +465,25 @@ void usock_server_set_acceptor (struct usock_server *server,
     }
 }
 
+int usock_server_foreach (struct usock_server *server,
+                          usock_server_conn_f cb,
+                          void *arg)
+{
+    struct usock_conn *conn;
+
+    if (!server || !cb) {
+        errno = EINVAL;
+        return -1;
+    }
+    conn = zlist_first (server->connections);
+    while (conn) {
+        if (cb (conn, arg) < 0)
+            return -1;
+        conn = zlist_next (server->connections);
+    }
+    return 0;
+}
+
 void usock_server_destroy (struct usock_server *server)
 {
     if (server) {
@@ -440,7 +562,8 @@ struct usock_conn *usock_conn_create (flux_reactor_t *r, int infd, int outfd)
     uuid_generate (conn->uuid);
     uuid_unparse (conn->uuid, conn->uuid_str);
 
-    if (!(conn->outqueue = zlist_new ())) {
+    if (!(conn->outqueue = zlist_new ())
+            || !(conn->outqueue_hi = zlist_new ())) {
         errno = ENOMEM;
         goto error;
     }
@@ -477,21 +600,28 @@ static void server_cb (flux_reactor_t *r,
 
     if ((revents & FLUX_POLLIN)) {
         struct usock_conn *conn;
+        int count;
 
-        if (!(conn = server_accept (server, r)))
-            return;
-        if (zlist_append (server->connections, conn) < 0) {
-            usock_conn_destroy (conn);
-            return;
-        }
-        conn->server = server; // now decref will also delist
-
-        /* Acceptor should call (or arrange to later call) either
-         * usock_conn_accept() or usock_conn_reject() to complete
-         * auth handshake and start recv watcher.
+        /* The listen fd is nonblocking, so accept until the backlog
+         * is drained (up to the batch cap) rather than taking one
+         * connection per reactor wakeup.
          */
-        if (server->acceptor)
-            server->acceptor (conn, server->arg);
+        for (count = 0; count < ACCEPT_BATCH_COUNT; count++) {
+            if (!(conn = server_accept (server, r)))
+                return;
+            if (zlist_append (server->connections, conn) < 0) {
+                usock_conn_destroy (conn);
+                return;
+            }
+            conn->server = server; // now decref will also delist
+
+            /* Acceptor should call (or arrange to later call) either
+             * usock_conn_accept() or usock_conn_reject() to complete
+             * auth handshake and start recv watcher.
+             */
+            if (server->acceptor)
+                server->acceptor (conn, server->arg);
+        }
     }
 }
 
@@ -524,6 +654,11 @@ struct usock_server *usock_server_create (flux_reactor_t *r,
         goto error;
     if (chmod (sockpath, mode) < 0)
         goto error;
+    /* Nonblocking so the accept loop in server_cb() can drain the
+     * backlog without blocking on the last accept.
+     */
+    if (fd_set_nonblocking (server->fd) < 0)
+        goto error;
     if (listen (server->fd, LISTEN_BACKLOG) < 0)
         goto error;
     if (!(server->w = flux_fd_watcher_create (r,
@@ -46,6 +46,7 @@ typedef void (*usock_conn_error_f)(struct usock_conn *conn,
 typedef void (*usock_conn_recv_f)(struct usock_conn *conn,
                                   flux_msg_t *msg,
                                   void *arg);
+typedef int (*usock_server_conn_f)(struct usock_conn *conn, void *arg);
 
 /* Server
  */
@@ -59,11 +60,38 @@ void usock_server_set_acceptor (struct usock_server *server,
                                 usock_acceptor_f cb,
                                 void *arg);
 
+/* Call 'cb' for each active connection.  Iteration stops if 'cb'
+ * returns -1, and -1 is returned to the caller.
+ */
+int usock_server_foreach (struct usock_server *server,
+                          usock_server_conn_f cb,
+                          void *arg);
+
 /* Server connection for one client
  */
 
+/* Queue a message for transmission to the client.  Messages with the
+ * control flag set (see flux_msg_set_control()) travel in a priority
+ * lane that is drained ahead of queued bulk data.
+ */
 int usock_conn_send (struct usock_conn *conn, const flux_msg_t *msg);
 
+/* Limit the depth of the connection's send queue (0 = unlimited, the
+ * default).  Once 'limit' messages are queued, further sends fail with
+ * ENOBUFS until the peer drains some of the backlog.  Control-flagged
+ * messages are admitted even at the limit.
+ */
+void usock_conn_set_queue_limit (struct usock_conn *conn, int limit);
+
+/* Fetch send queue statistics: current depth, high watermark, and
+ * count of sends refused at the queue limit.  Any of the result
+ * pointers may be NULL.
+ */
+int usock_conn_get_queue_stats (struct usock_conn *conn,
+                                int *depth,
+                                int *maxdepth,
+                                int *full);
+
 const struct flux_msg_cred *usock_conn_get_cred (struct usock_conn *conn);
 
 const char *usock_conn_get_uuid (struct usock_conn *conn);
@@ -13,53 +13,89 @@
 #endif
 #include <flux/core.h>
 #include <jansson.h>
+#include <czmq.h>
 
 #include "schedutil_private.h"
 #include "init.h"
 #include "hello.h"
 
-static int schedutil_hello_job (flux_t *h,
-                                flux_jobid_t id,
-                                int priority,
-                                uint32_t userid,
-                                double t_submit,
-                                schedutil_hello_cb_f *cb,
-                                void *arg)
+/* Max number of R lookups in flight during hello.  Lookups are
+ * pipelined so that scheduler reattach time on a busy system is
+ * dominated by bandwidth rather than per-job round trips.
+ */
+static const int hello_lookup_window = 32;
+
+/* Send a lookup for the R of the job described by 'entry'.
+ * 'entry' is attached to the future for retrieval on completion.
+ */
+static flux_future_t *hello_lookup (flux_t *h, json_t *entry)
 {
     char key[64];
+    flux_jobid_t id;
     flux_future_t *f;
-    const char *R;
 
-    if (!h) {
-        errno = EINVAL;
-        return -1;
+    if (json_unpack (entry, "{s:I}", "id", &id) < 0) {
+        errno = EPROTO;
+        return NULL;
     }
-
     if (flux_job_kvs_key (key, sizeof (key), id, "R") < 0) {
         errno = EPROTO;
-        return -1;
+        return NULL;
     }
     if (!(f = flux_kvs_lookup (h, NULL, 0, key)))
+        return NULL;
+    json_incref (entry);
+    if (flux_future_aux_set (f, "entry", entry,
+                             (flux_free_f)json_decref) < 0) {
+        json_decref (entry);
+        flux_future_destroy (f);
+        return NULL;
+    }
+    return f;
+}
+
+/* Wait for R lookup 'f' to complete and make the hello callback for
+ * its job.  The caller retains ownership of 'f'.
+ */
+static int hello_lookup_finish (flux_t *h,
+                                flux_future_t *f,
+                                schedutil_hello_cb_f *cb,
+                                void *arg)
+{
+    json_t *entry = flux_future_aux_get (f, "entry");
+    flux_jobid_t id;
+    int priority;
+    uint32_t userid;
+    double t_submit;
+    const char *R;
+
+    if (json_unpack (entry, "{s:I s:i s:i s:f}",
+                            "id", &id,
+                            "priority", &priority,
+                            "userid", &userid,
+                            "t_submit", &t_submit) < 0) {
+        errno = EPROTO;
         return -1;
-    if (flux_kvs_lookup_get (f, &R) < 0)
-        goto error;
+    }
+    if (flux_kvs_lookup_get (f, &R) < 0) {
+        flux_log_error (h, "hello: error loading R for id=%ju",
+                        (uintmax_t)id);
+        return -1;
+    }
     if (cb (h, id, priority, userid, t_submit, R, arg) < 0)
-        goto error;
-    flux_future_destroy (f);
+        return -1;
     return 0;
-error:
-    flux_log_error (h, "hello: error loading R for id=%ju",
-                    (uintmax_t)id);
-    flux_future_destroy (f);
-    return -1;
 }
 
 int schedutil_hello (schedutil_t *util, schedutil_hello_cb_f *cb, void *arg)
 {
     flux_future_t *f;
+    flux_future_t *lookup_f;
+    zlist_t *lookups = NULL;
     json_t *jobs;
-    json_t *entry;
     size_t index;
+    size_t count;
+    int saved_errno;
 
     if (!util || !cb) {
         errno = EINVAL;
@@ -70,33 +106,48 @@ int schedutil_hello (schedutil_t *util, schedutil_hello_cb_f *cb, void *arg)
         return -1;
     if (flux_rpc_get_unpack (f, "{s:o}", "alloc", &jobs) < 0)
         goto error;
-    json_array_foreach (jobs, index, entry) {
-        flux_jobid_t id;
-        int priority;
-        uint32_t userid;
-        double t_submit;
-
-        if (json_unpack (entry, "{s:I s:i s:i s:f}",
-                                "id", &id,
-                                "priority", &priority,
-                                "userid", &userid,
-                                "t_submit", &t_submit) < 0) {
-            errno = EPROTO;
-            goto error;
+    if (!(lookups = zlist_new ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    /* Callbacks are made in array order: lookups are appended to
+     * 'lookups' in order and the head blocked on, while up to
+     * hello_lookup_window lookups are kept in flight behind it.
+     */
+    count = json_array_size (jobs);
+    index = 0;
+    while (index < count || zlist_size (lookups) > 0) {
+        while (index < count
+               && zlist_size (lookups) < hello_lookup_window) {
+            if (!(lookup_f = hello_lookup (util->h,
+                                           json_array_get (jobs, index))))
+                goto error;
+            if (zlist_append (lookups, lookup_f) < 0) {
+                flux_future_destroy (lookup_f);
+                errno = ENOMEM;
+                goto error;
+            }
+            index++;
         }
-        if (schedutil_hello_job (util->h,
-                                 id,
-                                 priority,
-                                 userid,
-                                 t_submit,
-                                 cb,
-                                 arg) < 0)
+        lookup_f = zlist_pop (lookups);
+        if (hello_lookup_finish (util->h, lookup_f, cb, arg) < 0) {
+            flux_future_destroy (lookup_f);
             goto error;
+        }
+        flux_future_destroy (lookup_f);
     }
+    zlist_destroy (&lookups);
     flux_future_destroy (f);
     return 0;
 error:
+    saved_errno = errno;
+    if (lookups) {
+        while ((lookup_f = zlist_pop (lookups)))
+            flux_future_destroy (lookup_f);
+        zlist_destroy (&lookups);
+    }
     flux_future_destroy (f);
+    errno = saved_errno;
     return -1;
 }
 
@@ -49,27 +49,25 @@ static void alloc_continuation (flux_future_t *f, void *arg)
     }
 }
 
-static void alloc_cb (flux_t *h, flux_msg_handler_t *mh,
-                      const flux_msg_t *msg, void *arg)
+/* Initiate the jobspec lookup for one alloc request and queue it for
+ * the alloc callback.  'msg' must decode with
+ * schedutil_alloc_request_decode(), i.e. carry exactly one job.
+ * Returns 0 on success, -1 on failure with errno set.
+ */
+static int alloc_request_start (schedutil_t *util,
+                                const flux_msg_t *msg,
+                                flux_jobid_t id)
 {
-    schedutil_t *util = arg;
-    flux_jobid_t id;
+    flux_t *h = util->h;
     char key[64];
     flux_future_t *f;
 
-    if (util == NULL) {
-        errno = EINVAL;
-        goto error;
-    }
-
-    if (flux_request_unpack (msg, NULL, "{s:I}", "id", &id) < 0)
-        goto error;
     if (flux_job_kvs_key (key, sizeof (key), id, "jobspec") < 0) {
         errno = EPROTO;
-        goto error;
+        return -1;
     }
     if (!(f = flux_kvs_lookup (h, NULL, 0, key)))
-        goto error;
+        return -1;
     if (flux_future_aux_set (f,
                              "schedutil::msg",
                              (void *)flux_msg_incref (msg),
@@ -85,10 +83,77 @@ static void alloc_cb (flux_t *h, flux_msg_handler_t *mh,
     // outstanding request for testing
     if (schedutil_enqueue_alloc (util, f) < 0)
         flux_log_error (h, "sched.alloc unable to enqueue alloc request");
-
-    return;
+    return 0;
 error_future:
     flux_future_destroy (f);
+    return -1;
+}
+
+/* Unpack a batched alloc request (see ready.c negotiation) and start
+ * each job, synthesizing a single-job request message per entry so the
+ * alloc callback and the alloc respond helpers see the same messages
+ * they would have for unbatched requests.
+ * Returns 0 on success, -1 on failure with errno set.
+ */
+static int alloc_request_batch (schedutil_t *util,
+                                const flux_msg_t *msg,
+                                json_t *jobs)
+{
+    size_t index;
+    json_t *entry;
+
+    json_array_foreach (jobs, index, entry) {
+        flux_jobid_t id;
+        int priority;
+        int userid;
+        double t_submit;
+        flux_msg_t *cpy;
+
+        if (json_unpack (entry, "{s:I s:i s:i s:F}",
+                                "id", &id,
+                                "priority", &priority,
+                                "userid", &userid,
+                                "t_submit", &t_submit) < 0) {
+            errno = EPROTO;
+            return -1;
+        }
+        if (!(cpy = flux_msg_copy (msg, false)))
+            return -1;
+        if (flux_msg_pack (cpy, "{s:I s:i s:i s:f}",
+                                "id", id,
+                                "priority", priority,
+                                "userid", userid,
+                                "t_submit", t_submit) < 0
+            || alloc_request_start (util, cpy, id) < 0) {
+            flux_msg_destroy (cpy);
+            return -1;
+        }
+        flux_msg_destroy (cpy);
+    }
+    return 0;
+}
+
+static void alloc_cb (flux_t *h, flux_msg_handler_t *mh,
+                      const flux_msg_t *msg, void *arg)
+{
+    schedutil_t *util = arg;
+    flux_jobid_t id;
+    json_t *jobs;
+
+    if (util == NULL) {
+        errno = EINVAL;
+        goto error;
+    }
+    if (flux_request_unpack (msg, NULL, "{s:o}", "jobs", &jobs) == 0) {
+        if (alloc_request_batch (util, msg, jobs) < 0)
+            goto error;
+        return;
+    }
+    if (flux_request_unpack (msg, NULL, "{s:I}", "id", &id) < 0)
+        goto error;
+    if (alloc_request_start (util, msg, id) < 0)
+        goto error;
+    return;
 error:
     flux_log_error (h, "sched.alloc");
     if (flux_respond_error (h, msg, errno, NULL) < 0)
@@ -27,9 +27,13 @@ int schedutil_ready (schedutil_t *util, const char *mode, int *queue_depth)
         errno = EINVAL;
         return -1;
     }
+    /* N.B. batch=1 advertises that this schedutil can unpack batched
+     * alloc requests (multiple jobs per sched.alloc message), so the
+     * job manager may vectorize them.  Older job managers ignore it.
+     */
     if (!(f = flux_rpc_pack (util->h, "job-manager.sched-ready",
                              FLUX_NODEID_ANY, 0,
-                             "{s:s}", "mode", mode)))
+                             "{s:s s:b}", "mode", mode, "batch", 1)))
         return -1;
     if (flux_rpc_get_unpack (f, "{s:i}", "count", &count) < 0)
         goto error;
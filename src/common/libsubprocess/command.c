@@ -13,9 +13,9 @@
 #endif
 
 #include <stdlib.h>
+#include <stdbool.h>
 #include <sys/types.h>
 #include <argz.h>
-#include <envz.h>
 
 #include <jansson.h>
 #include <czmq.h>
@@ -29,9 +29,15 @@ struct flux_command {
     size_t argz_len;
     char *argz;
 
-    /* Command environment hash */
+    /* Command environment hash (NAME -> VALUE, autofree strings) */
+    zhash_t *env;
+
+    /* Pre-serialized envz cache of `env` backing the envp array for
+     *  exec; rebuilt lazily after environment updates.
+     */
     size_t envz_len;
     char *envz;
+    bool envz_valid;
 
     /* Extra key=value options */
     zhash_t *opts;
@@ -115,32 +121,6 @@ static char **expand_argz (char *argz, size_t argz_len)
     return (argv);
 }
 
-/*
- *  Return the "name" portion of an environment entry of the form
- *   "NAME=VALUE", copying the name into the destination buffer `dst`
- *   of size `len`. If the result cannot fit in `dst`, NULL is returned
- *   as opposed to truncation.
- *
- *  On success, a pointer to `dst` is returned.
- */
-static char *env_entry_name (char *entry, char *dst, size_t len)
-{
-    char *p;
-    if (!entry)
-        return NULL;
-    /* If there is no '=' in entry, then "name" is the entire entry. */
-    if (!(p = strchr (entry, '=')))
-        p = entry + strlen (entry) + 1;
-
-    /* Refuse to truncate */
-    if (len-1 < p - entry)
-        return NULL;
-
-    /* strncat(3): safer than strncpy(3), faster than by-hand: */
-    *dst = '\0';
-    return strncat (dst, entry, p - entry);
-}
-
 /*
  *  Return a pointer to the "value" portion of an environment entry
  *   of the form "NAME=VALUE". The result should not be modified as
@@ -203,59 +183,55 @@ fail:
 }
 
 /*
- *  Convert and envz array (argz with NAME=VALUE entries) to a json
- *   dictionary object.
+ *  Populate environment hash `h` from a NULL-terminated environ(7)
+ *   style array of "NAME=VALUE" entries. An entry without '=' is
+ *   stored with an empty value.
  */
-static json_t * envz_tojson (const char *envz, size_t envz_len)
+static int env_hash_from_environ (zhash_t *h, char * const env[])
 {
-    char buf [1024];
-    const char *name, *value;
-    char *entry = NULL;
-    json_t *o = json_object ();
-
-    if (o == NULL)
-        goto err;
-
-    while ((entry = argz_next (envz, envz_len, entry))) {
-        json_t *v;
-        if (!(name = env_entry_name (entry, buf, sizeof (buf))))
-            continue;
-        if (!(value = env_entry_value (entry)))
-            continue;
-        if (!(v = json_string (value)) || json_object_set_new (o, name, v)) {
-            json_decref (v);
-            goto err;
-        }
+    int i;
+    for (i = 0; env[i] != NULL; i++) {
+        const char *value = env_entry_value (env[i]);
+        const char *p = strchr (env[i], '=');
+        char *name;
+        if (!(name = strndup (env[i], p ? p - env[i] : strlen (env[i]))))
+            return -1;
+        zhash_update (h, name, (char *) (value ? value : ""));
+        free (name);
     }
-    return o;
-err:
-    json_decref (o);
-    return NULL;
+    return 0;
 }
 
-static int envz_fromjson (json_t *o, char **envzp, size_t *envz_lenp)
-{
-    const char *var;
-    json_t *val;
-    int errnum = EINVAL;
-
-    assert (*envzp == NULL && *envz_lenp == 0);
-    if (!json_is_object (o))
-        goto fail;
-
-    json_object_foreach (o, var, val) {
-        if (!json_is_string (val))
-            goto fail;
-        if (envz_add (envzp, envz_lenp, var, json_string_value (val)))
-            goto fail;
+/*
+ *  Rebuild the pre-serialized envz cache from the environment hash.
+ *   Entries are appended without the usual envz dedup scan since hash
+ *   keys are already unique.
+ */
+static int cmd_env_serialize (flux_cmd_t *cmd)
+{
+    const char *value;
+
+    if (cmd->envz_valid)
+        return 0;
+    free (cmd->envz);
+    cmd->envz = NULL;
+    cmd->envz_len = 0;
+    value = zhash_first (cmd->env);
+    while (value) {
+        char *entry;
+        int e;
+        if (asprintf (&entry, "%s=%s", zhash_cursor (cmd->env), value) < 0)
+            return -1;
+        e = argz_add (&cmd->envz, &cmd->envz_len, entry);
+        free (entry);
+        if (e != 0) {
+            errno = e;
+            return -1;
+        }
+        value = zhash_next (cmd->env);
     }
+    cmd->envz_valid = true;
     return 0;
-fail:
-    free (*envzp);
-    *envzp = NULL;
-    *envz_lenp = 0;
-    errno = errnum;
-    return -1;
 }
 
 /*
@@ -412,6 +388,7 @@ static void flux_cmd_free (flux_cmd_t *cmd)
         free (cmd->cwd);
         free (cmd->argz);
         free (cmd->envz);
+        zhash_destroy (&cmd->env);
         zhash_destroy (&cmd->opts);
         zlist_destroy (&cmd->channels);
         free (cmd);
@@ -432,25 +409,28 @@ flux_cmd_t *flux_cmd_create (int argc, char *argv[], char **env)
         return NULL;
     if (argv && init_argz_count (&cmd->argz, &cmd->argz_len, argc, argv) < 0)
         goto fail;
-    if (env && init_argz (&cmd->envz, &cmd->envz_len, env) < 0)
-        goto fail;
 
-    if (!(cmd->opts = zhash_new ())
+    if (!(cmd->env = zhash_new ())
+       || !(cmd->opts = zhash_new ())
        || !(cmd->channels = zlist_new ())) {
         errno = ENOMEM;
         goto fail;
     }
 
-    /* Set autofree on both the opts hash and the channels list.
+    /* Set autofree on the env and opts hashes and the channels list.
      *
-     * This means keys in the hash and items in the list will automatically
-     *  be strdup'd on insertion, and freed on destruction. For zlist
-     *  it also makes zlist_dup() duplicate values instead of referencing
-     *  the originals.
+     * This means keys in the hashes and items in the list will
+     *  automatically be strdup'd on insertion, and freed on destruction.
+     *  For zlist it also makes zlist_dup() duplicate values instead of
+     *  referencing the originals.
      */
+    zhash_autofree (cmd->env);
     zhash_autofree (cmd->opts);
     zlist_autofree (cmd->channels);
 
+    if (env && env_hash_from_environ (cmd->env, env) < 0)
+        goto fail;
+
     return (cmd);
 fail:
     flux_cmd_free (cmd);
@@ -550,14 +530,13 @@ int flux_cmd_argv_append (flux_cmd_t *cmd, const char *arg)
 static int flux_cmd_setenv (flux_cmd_t *cmd, const char *k, const char *v,
                             int overwrite)
 {
-    if (!overwrite && envz_entry (cmd->envz, cmd->envz_len, k)) {
+    if (!overwrite && zhash_lookup (cmd->env, k)) {
         errno = EEXIST;
         return -1;
     }
-    if (envz_add (&cmd->envz, &cmd->envz_len, k, v) != 0) {
-        errno = ENOMEM;
-        return -1;
-    }
+    /* autofree is set on cmd->env, so v is automatically strdup'd */
+    zhash_update (cmd->env, k, (char *) v);
+    cmd->envz_valid = false;
     return 0;
 }
 
@@ -580,12 +559,13 @@ int flux_cmd_setenvf (flux_cmd_t *cmd, int overwrite,
 
 void flux_cmd_unsetenv (flux_cmd_t *cmd, const char *name)
 {
-    envz_remove (&cmd->envz, &cmd->envz_len, name);
+    zhash_delete (cmd->env, name);
+    cmd->envz_valid = false;
 }
 
 const char * flux_cmd_getenv (const flux_cmd_t *cmd, const char *name)
 {
-    return (envz_get (cmd->envz, cmd->envz_len, name));
+    return (zhash_lookup (cmd->env, name));
 }
 
 int flux_cmd_setcwd (flux_cmd_t *cmd, const char *path)
@@ -639,13 +619,11 @@ flux_cmd_t * flux_cmd_copy (const flux_cmd_t *src)
     if (cmd == NULL)
         goto err;
     e = argz_append (&cmd->argz, &cmd->argz_len, src->argz, src->argz_len);
-    if (e != 0)
-        goto err;
-    e = argz_append (&cmd->envz, &cmd->envz_len, src->envz, src->envz_len);
     if (e != 0)
         goto err;
     if (src->cwd && !(cmd->cwd = strdup (src->cwd)))
         goto err;
+    cmd->env = z_hash_dup (src->env);
     cmd->channels = zlist_dup (src->channels);
     cmd->opts = z_hash_dup (src->opts);
     return (cmd);
@@ -684,7 +662,7 @@ flux_cmd_t * flux_cmd_fromjson (const char *json_str, json_error_t *errp)
     }
     if (!(cmd->cwd = strdup (cwd))
         || (argz_fromjson (jargv, &cmd->argz, &cmd->argz_len) < 0)
-        || (envz_fromjson (jenv, &cmd->envz, &cmd->envz_len) < 0)
+        || !(cmd->env = zhash_fromjson (jenv))
         || !(cmd->opts = zhash_fromjson (jopts))
         || !(cmd->channels = zlist_fromjson (jchans))) {
         errnum = errno;
@@ -730,8 +708,8 @@ char * flux_cmd_tojson (const flux_cmd_t *cmd)
     }
 
     /* Pack env */
-    if (cmd->envz) {
-        if (!(a = envz_tojson (cmd->envz, cmd->envz_len)))
+    if (zhash_size (cmd->env) > 0) {
+        if (!(a = zhash_tojson (cmd->env)))
             goto err;
         if (json_object_set_new (o, "env", a) != 0) {
             json_decref (a);
@@ -764,6 +742,8 @@ err:
 
 char **flux_cmd_env_expand (flux_cmd_t *cmd)
 {
+    if (cmd_env_serialize (cmd) < 0)
+        return NULL;
     return expand_argz (cmd->envz, cmd->envz_len);
 }
 
@@ -774,16 +754,20 @@ char **flux_cmd_argv_expand (flux_cmd_t *cmd)
 
 int flux_cmd_set_env (flux_cmd_t *cmd, char **env)
 {
-    size_t new_envz_len = 0;
-    char *new_envz = NULL;
+    zhash_t *new;
 
-    if (init_argz (&new_envz, &new_envz_len, env) < 0)
+    if (!(new = zhash_new ())) {
+        errno = ENOMEM;
         return -1;
-
-    if (cmd->envz)
-        free (cmd->envz);
-    cmd->envz = new_envz;
-    cmd->envz_len = new_envz_len;
+    }
+    zhash_autofree (new);
+    if (env_hash_from_environ (new, env) < 0) {
+        zhash_destroy (&new);
+        return -1;
+    }
+    zhash_destroy (&cmd->env);
+    cmd->env = new;
+    cmd->envz_valid = false;
 
     return 0;
 }
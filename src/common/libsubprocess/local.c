@@ -16,6 +16,11 @@
 #include <wait.h>
 #include <unistd.h>
 #include <errno.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
 
 #include <czmq.h>
 
@@ -208,6 +213,7 @@ static int channel_local_setup (flux_subprocess_t *p,
 
     if ((channel_flags & CHANNEL_READ) && out_cb) {
         int wflag;
+        int watermark;
 
         if ((wflag = cmd_option_line_buffer (p, name)) < 0) {
             flux_log_error (p->h, "cmd_option_line_buffer");
@@ -217,6 +223,11 @@ static int channel_local_setup (flux_subprocess_t *p,
         if (wflag)
             c->line_buffered = true;
 
+        if ((watermark = cmd_option_watermark (p, name)) < 0) {
+            flux_log_error (p->h, "cmd_option_watermark");
+            goto error;
+        }
+
         c->buffer_read_w = flux_buffer_read_watcher_create (p->reactor,
                                                             c->parent_fd,
                                                             buffer_size,
@@ -228,6 +239,13 @@ static int channel_local_setup (flux_subprocess_t *p,
             goto error;
         }
 
+        if (watermark > 0
+            && flux_buffer_read_watcher_set_watermark (c->buffer_read_w,
+                                                       watermark) < 0) {
+            flux_log_error (p->h, "flux_buffer_read_watcher_set_watermark");
+            goto error;
+        }
+
         p->channels_eof_expected++;
     }
 
@@ -274,8 +292,51 @@ error:
     return -1;
 }
 
+/* Set up the output sink for 'stream' if the "SINK" option is set.
+ * "fd:N" routes to caller-owned descriptor N, inherited across fork(2).
+ * Anything else is a path, opened append-mode and owned by the
+ * subprocess.  Returns 0 if no sink is configured, 1 if one was set
+ * up, -1 on error with errno set.
+ */
+static int local_sink_setup (flux_subprocess_t *p, const char *stream,
+                             int *fdp, bool *ownedp)
+{
+    const char *val;
+
+    if (!(val = cmd_option_sink (p, stream)))
+        return 0;
+
+    if (!strncmp (val, "fd:", 3)) {
+        char *endptr;
+        long n;
+        errno = 0;
+        n = strtol (val + 3, &endptr, 10);
+        if (errno
+            || endptr == val + 3
+            || endptr[0] != '\0'
+            || n < 0) {
+            errno = EINVAL;
+            return -1;
+        }
+        *fdp = n;
+        *ownedp = false;
+    }
+    else {
+        int fd;
+        if ((fd = open (val, O_WRONLY | O_CREAT | O_APPEND, 0644)) < 0) {
+            flux_log_error (p->h, "open %s", val);
+            return -1;
+        }
+        *fdp = fd;
+        *ownedp = true;
+    }
+    return 1;
+}
+
 static int local_setup_stdio (flux_subprocess_t *p)
 {
+    int ret;
+
     if (p->flags & FLUX_SUBPROCESS_FLAGS_STDIO_FALLTHROUGH)
         return 0;
 
@@ -291,7 +352,15 @@ static int local_setup_stdio (flux_subprocess_t *p)
                              CHANNEL_WRITE) < 0)
         return -1;
 
-    if (p->ops.on_stdout) {
+    /* a sink takes precedence over the stream's output callback - the
+     * child writes to the sink fd directly and no channel is created */
+
+    if ((ret = local_sink_setup (p,
+                                 "stdout",
+                                 &p->stdout_sink_fd,
+                                 &p->stdout_sink_owned)) < 0)
+        return -1;
+    if (!ret && p->ops.on_stdout) {
         if (channel_local_setup (p,
                                  p->ops.on_stdout,
                                  NULL,
@@ -301,7 +370,12 @@ static int local_setup_stdio (flux_subprocess_t *p)
             return -1;
     }
 
-    if (p->ops.on_stderr) {
+    if ((ret = local_sink_setup (p,
+                                 "stderr",
+                                 &p->stderr_sink_fd,
+                                 &p->stderr_sink_owned)) < 0)
+        return -1;
+    if (!ret && p->ops.on_stderr) {
         if (channel_local_setup (p,
                                  p->ops.on_stderr,
                                  NULL,
@@ -405,6 +479,59 @@ static void closefd_child (void *arg, int fd)
     close (fd);
 }
 
+static int fd_cmp (const void *a, const void *b)
+{
+    return *(const int *)a - *(const int *)b;
+}
+
+/*  Close all fds >= 3 in the child except the child side of the sync
+ *   socketpair and any channel fds (which also need O_CLOEXEC cleared
+ *   before exec(2)).  On Linux, batch the closes with close_range(2)
+ *   so the cost does not scale with RLIMIT_NOFILE.  Returns -1 with
+ *   errno = ENOSYS if the syscall is unavailable, in which case the
+ *   caller should fall back to walking open fds.
+ */
+static int closefds_child_ranged (flux_subprocess_t *p)
+{
+#if defined(__linux__) && defined(SYS_close_range)
+    struct subprocess_channel *c;
+    int *keep;
+    int nkeep = 0;
+    unsigned int first = 3;
+    int i;
+
+    if (!(keep = calloc (zhash_size (p->channels) + 1, sizeof (int))))
+        return -1;
+    keep[nkeep++] = p->sync_fds[1];
+    c = zhash_first (p->channels);
+    while (c) {
+        if (c->child_fd >= 3) {
+            (void) fd_unset_cloexec (c->child_fd);
+            keep[nkeep++] = c->child_fd;
+        }
+        c = zhash_next (p->channels);
+    }
+    qsort (keep, nkeep, sizeof (int), fd_cmp);
+    for (i = 0; i < nkeep; i++) {
+        if (keep[i] >= 0 && (unsigned int)keep[i] > first
+            && syscall (SYS_close_range, first, keep[i] - 1, 0) < 0)
+            goto error;
+        if (keep[i] >= 0 && (unsigned int)(keep[i] + 1) > first)
+            first = keep[i] + 1;
+    }
+    if (syscall (SYS_close_range, first, ~0U, 0) < 0)
+        goto error;
+    free (keep);
+    return 0;
+error:
+    free (keep);
+    return -1;
+#else
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
 /*  Signal parent that child is ready for exec(2) and wait for parent's
  *   signal to proceed. This is done by writing 1 byte to child side of
  *   socketpair, and waiting for parent to write one byte back.
@@ -470,7 +597,13 @@ static int local_child (flux_subprocess_t *p)
             }
         }
 
-        if ((c = zhash_lookup (p->channels, "stdout"))) {
+        if (p->stdout_sink_fd != -1) {
+            if (dup2 (p->stdout_sink_fd, STDOUT_FILENO) < 0) {
+                fprintf (stderr, "dup2: %s\n", strerror (errno));
+                _exit (1);
+            }
+        }
+        else if ((c = zhash_lookup (p->channels, "stdout"))) {
             if (dup2 (c->child_fd, STDOUT_FILENO) < 0) {
                 fprintf (stderr, "dup2: %s\n", strerror (errno));
                 _exit (1);
@@ -479,7 +612,13 @@ static int local_child (flux_subprocess_t *p)
         else
             close (STDOUT_FILENO);
 
-        if ((c = zhash_lookup (p->channels, "stderr"))) {
+        if (p->stderr_sink_fd != -1) {
+            if (dup2 (p->stderr_sink_fd, STDERR_FILENO) < 0) {
+                fprintf (stderr, "dup2: %s\n", strerror (errno));
+                _exit (1);
+            }
+        }
+        else if ((c = zhash_lookup (p->channels, "stderr"))) {
             if (dup2 (c->child_fd, STDERR_FILENO) < 0) {
                 fprintf (stderr, "dup2: %s\n", strerror (errno));
                 _exit (1);
@@ -503,7 +642,8 @@ static int local_child (flux_subprocess_t *p)
         _exit (1);
 
     // Close fds
-    if (fdwalk (closefd_child, (void *) p) < 0) {
+    if (closefds_child_ranged (p) < 0
+        && fdwalk (closefd_child, (void *) p) < 0) {
         fprintf (stderr, "Failed closing all fds: %s", strerror (errno));
         _exit (1);
     }
@@ -606,6 +746,17 @@ static int local_fork (flux_subprocess_t *p)
 
     close_child_fds (p);
 
+    /* the child has dup2(2)'d sink fds onto stdout/stderr; drop fds we
+     * opened, but leave caller-owned "fd:N" targets alone */
+    if (p->stdout_sink_owned && p->stdout_sink_fd != -1) {
+        close (p->stdout_sink_fd);
+        p->stdout_sink_fd = -1;
+    }
+    if (p->stderr_sink_owned && p->stderr_sink_fd != -1) {
+        close (p->stderr_sink_fd);
+        p->stderr_sink_fd = -1;
+    }
+
     /* no-op if reactor is !FLUX_REACTOR_SIGCHLD */
     if (!(p->child_w = flux_child_watcher_create (p->reactor,
                                                   p->pid,
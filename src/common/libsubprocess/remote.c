@@ -474,7 +474,11 @@ static int remote_setup_stdio (flux_subprocess_t *p)
                               CHANNEL_WRITE) < 0)
         return -1;
 
-    if (p->ops.on_stdout) {
+    /* a sinked stream (see "SINK" option) is written directly to its
+     * target on the rank where the process runs - no output flows back,
+     * so don't create a read channel expecting an EOF */
+
+    if (p->ops.on_stdout && !cmd_option_sink (p, "stdout")) {
         if (remote_channel_setup (p,
                                   p->ops.on_stdout,
                                   "stdout",
@@ -482,7 +486,7 @@ static int remote_setup_stdio (flux_subprocess_t *p)
             return -1;
     }
 
-    if (p->ops.on_stderr) {
+    if (p->ops.on_stderr && !cmd_option_sink (p, "stderr")) {
         if (remote_channel_setup (p,
                                   p->ops.on_stderr,
                                   "stderr",
@@ -578,7 +582,7 @@ static int remote_output (flux_subprocess_t *p, flux_future_t *f,
 {
     struct subprocess_channel *c;
     const char *stream = NULL;
-    char *data = NULL;
+    const char *data = NULL;
     int len = 0;
     bool eof = false;
     json_t *io = NULL;
@@ -589,7 +593,7 @@ static int remote_output (flux_subprocess_t *p, flux_future_t *f,
         goto cleanup;
     }
 
-    if (iodecode (io, &stream, NULL, &data, &len, &eof) < 0) {
+    if (iodecode_ref (io, &stream, NULL, &data, &len, &eof) < 0) {
         flux_log_error (p->h, "iodecode");
         goto cleanup;
     }
@@ -626,7 +630,6 @@ static int remote_output (flux_subprocess_t *p, flux_future_t *f,
 
     rv = 0;
 cleanup:
-    free (data);
     return rv;
 }
 
@@ -435,7 +435,7 @@ static void server_write_cb (flux_t *h, flux_msg_handler_t *mh,
     flux_subprocess_t *p;
     flux_subprocess_server_t *s = arg;
     const char *stream = NULL;
-    char *data = NULL;
+    const char *data = NULL;
     int len = 0;
     bool eof = false;
     pid_t pid;
@@ -450,7 +450,7 @@ static void server_write_cb (flux_t *h, flux_msg_handler_t *mh,
         return;
     }
 
-    if (iodecode (io, &stream, NULL, &data, &len, &eof) < 0) {
+    if (iodecode_ref (io, &stream, NULL, &data, &len, &eof) < 0) {
         flux_log_error (s->h, "%s: iodecode", __FUNCTION__);
         return;
     }
@@ -484,11 +484,9 @@ static void server_write_cb (flux_t *h, flux_msg_handler_t *mh,
     }
 
 out:
-    free (data);
     return;
 
 error:
-    free (data);
     internal_fatal (s, p);
 }
 
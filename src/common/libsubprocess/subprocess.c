@@ -130,6 +130,11 @@ static void subprocess_free (flux_subprocess_t *p)
 
         close_pair_fds (p->sync_fds);
 
+        if (p->stdout_sink_owned && p->stdout_sink_fd != -1)
+            close (p->stdout_sink_fd);
+        if (p->stderr_sink_owned && p->stderr_sink_fd != -1)
+            close (p->stderr_sink_fd);
+
         flux_watcher_destroy (p->state_prep_w);
         flux_watcher_destroy (p->state_idle_w);
         flux_watcher_destroy (p->state_check_w);
@@ -167,6 +172,8 @@ static flux_subprocess_t * subprocess_create (flux_t *h,
      * (i.e. fd == 0)
      */
     init_pair_fds (p->sync_fds);
+    p->stdout_sink_fd = -1;
+    p->stderr_sink_fd = -1;
 
     /* set CLOEXEC on sync_fds, so on exec(), child sync_fd is closed
      * and seen by parent */
@@ -282,6 +282,21 @@ int flux_cmd_add_channel (flux_cmd_t *cmd, const char *name);
  *    - stdout_LINE_BUFFER - configure line buffering for stdout
  *    - stderr_LINE_BUFFER - configure line buffering for stderr
  *
+ *  "WATERMARK" option
+ *
+ *    When line buffering is disabled (see LINE_BUFFER above), output
+ *    callbacks are by default called whenever any amount of data is
+ *    available.  Setting this option to a byte count delays output
+ *    callbacks until more than that much data has been buffered, so
+ *    consumers of high-rate streams drain large chunks per callback
+ *    with flux_subprocess_read().  Any remaining data below the
+ *    watermark is delivered when the stream reaches EOF.  This option
+ *    has no effect on a line buffered channel.
+ *
+ *    - name + "_WATERMARK" - set callback watermark on channel name
+ *    - stdout_WATERMARK - set callback watermark for stdout
+ *    - stderr_WATERMARK - set callback watermark for stderr
+ *
  *  "STREAM_STOP" option
  *
  *    By default, the output callbacks such as 'on_stdout' and
@@ -297,6 +312,25 @@ int flux_cmd_add_channel (flux_cmd_t *cmd, const char *name);
  *    - name + "_STREAM_STOP" - configure start/stop on channel name
  *    - stdout_STREAM_STOP - configure start/stop for stdout
  *    - stderr_STREAM_STOP - configure start/stop for stderr
+ *
+ *  "SINK" option
+ *
+ *    Route a stream's output directly to a file or file descriptor
+ *    instead of delivering it via output callbacks.  The child
+ *    dup2(2)s the sink onto the stream before exec(2), so high-volume
+ *    output bypasses the parent entirely - no buffering, user-space
+ *    copies, or reactor wakeups.  Set the option value to a path
+ *    (opened append-mode, created 0644 if necessary) or to "fd:N" to
+ *    route to caller-provided open descriptor N.  A sink takes
+ *    precedence over 'on_stdout' / 'on_stderr' - no data or EOF is
+ *    delivered for a sinked stream and flux_subprocess_read() on it
+ *    will fail.  For remote processes the sink is opened on the rank
+ *    where the process runs and no output flows back.  Sinks apply
+ *    only to stdout and stderr; the option is ignored with the
+ *    STDIO_FALLTHROUGH flag.
+ *
+ *    - stdout_SINK - route stdout
+ *    - stderr_SINK - route stderr
  */
 int flux_cmd_setopt (flux_cmd_t *cmd, const char *var, const char *val);
 const char *flux_cmd_getopt (flux_cmd_t *cmd, const char *var);
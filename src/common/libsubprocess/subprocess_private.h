@@ -106,6 +106,13 @@ struct flux_subprocess {
 
     /* fds[0] is parent/user, fds[1] is child */
     int sync_fds[2];                /* socketpair for fork/exec sync      */
+    /* output sinks, see "SINK" option.  The child dup2(2)s the sink fd
+     * onto stdout/stderr so no channel, buffering, or reactor watcher
+     * is created for that stream. */
+    int stdout_sink_fd;
+    int stderr_sink_fd;
+    bool stdout_sink_owned;         /* fd opened here, not caller's       */
+    bool stderr_sink_owned;
     bool in_hook;                   /* if presently in a hook */
     flux_watcher_t *child_w;
     flux_subprocess_hooks_t hooks;
@@ -2133,6 +2133,152 @@ void test_line_buffer_error (flux_reactor_t *r)
     flux_cmd_destroy (cmd);
 }
 
+void test_watermark (flux_reactor_t *r)
+{
+    char *av[] = { TEST_SUBPROCESS_DIR "test_multi_echo", "-O", "-c", "2200", "hi", NULL };
+    flux_cmd_t *cmd;
+    flux_subprocess_t *p = NULL;
+
+    ok ((cmd = flux_cmd_create (5, av, environ)) != NULL, "flux_cmd_create");
+
+    ok (flux_cmd_setopt (cmd, "stdout_LINE_BUFFER", "false") == 0,
+        "flux_cmd_setopt set stdout_LINE_BUFFER success");
+
+    /* watermark above the total output, so data is delivered in a
+     * single callback when flushed at EOF */
+    ok (flux_cmd_setopt (cmd, "stdout_WATERMARK", "5000") == 0,
+        "flux_cmd_setopt set stdout_WATERMARK success");
+
+    flux_subprocess_ops_t ops = {
+        .on_completion = completion_cb,
+        .on_stdout = count_output_cb
+    };
+    completion_cb_count = 0;
+    stdout_output_cb_count = 0;
+    stderr_output_cb_count = 0;
+    p = flux_local_exec (r, 0, cmd, &ops, NULL);
+    ok (p != NULL, "flux_local_exec");
+
+    ok (flux_subprocess_state (p) == FLUX_SUBPROCESS_RUNNING,
+        "subprocess state == RUNNING after flux_local_exec");
+
+    int rc = flux_reactor_run (r, 0);
+    ok (rc == 0, "flux_reactor_run returned zero status");
+    ok (completion_cb_count == 1, "completion callback called 1 time");
+    /* == 2 times means we got all the data at once and EOF */
+    ok (stdout_output_cb_count == 2, "stdout output callback called 2 times");
+    ok (stderr_output_cb_count == 0, "stderr output callback called 0 times");
+    flux_subprocess_destroy (p);
+    flux_cmd_destroy (cmd);
+}
+
+void test_watermark_error (flux_reactor_t *r)
+{
+    char *av[] = { "/bin/true", NULL };
+    flux_cmd_t *cmd;
+    flux_subprocess_t *p = NULL;
+
+    ok ((cmd = flux_cmd_create (1, av, NULL)) != NULL, "flux_cmd_create");
+
+    ok (flux_cmd_setopt (cmd, "stdout_WATERMARK", "ABCD") == 0,
+        "flux_cmd_setopt set stdout_WATERMARK success");
+
+    flux_subprocess_ops_t ops = {
+        .on_completion = completion_cb,
+        .on_channel_out = flux_standard_output,
+        .on_stdout = flux_standard_output,
+        .on_stderr = flux_standard_output
+    };
+    p = flux_local_exec (r, 0, cmd, &ops, NULL);
+    ok (p == NULL
+        && errno == EINVAL,
+        "flux_local_exec fails with EINVAL due to bad watermark input");
+
+    flux_cmd_destroy (cmd);
+}
+
+void test_sink (flux_reactor_t *r)
+{
+    char *av[] = { TEST_SUBPROCESS_DIR "test_echo", "-O", "hi", NULL };
+    char path[] = "/tmp/subprocess_sink_XXXXXX";
+    char buf[64];
+    int fd, len;
+    flux_cmd_t *cmd;
+    flux_subprocess_t *p = NULL;
+
+    fd = mkstemp (path);
+    ok (fd >= 0, "mkstemp success");
+    close (fd);
+
+    ok ((cmd = flux_cmd_create (3, av, environ)) != NULL, "flux_cmd_create");
+
+    ok (flux_cmd_setopt (cmd, "stdout_SINK", path) == 0,
+        "flux_cmd_setopt set stdout_SINK success");
+
+    flux_subprocess_ops_t ops = {
+        .on_completion = completion_cb,
+        .on_stdout = count_output_cb
+    };
+    completion_cb_count = 0;
+    stdout_output_cb_count = 0;
+    p = flux_local_exec (r, 0, cmd, &ops, NULL);
+    ok (p != NULL, "flux_local_exec");
+
+    int rc = flux_reactor_run (r, 0);
+    ok (rc == 0, "flux_reactor_run returned zero status");
+    ok (completion_cb_count == 1, "completion callback called 1 time");
+    ok (stdout_output_cb_count == 0,
+        "stdout output callback not called on sinked stream");
+
+    fd = open (path, O_RDONLY);
+    ok (fd >= 0, "open sink file success");
+    len = read (fd, buf, sizeof (buf));
+    ok (len == 3 && !memcmp (buf, "hi\n", 3),
+        "sink file contains subprocess output");
+    close (fd);
+    unlink (path);
+
+    flux_subprocess_destroy (p);
+    flux_cmd_destroy (cmd);
+}
+
+void test_sink_error (flux_reactor_t *r)
+{
+    char *av[] = { "/bin/true", NULL };
+    flux_cmd_t *cmd;
+    flux_subprocess_t *p = NULL;
+
+    ok ((cmd = flux_cmd_create (1, av, NULL)) != NULL, "flux_cmd_create");
+
+    ok (flux_cmd_setopt (cmd, "stdout_SINK", "fd:ABCD") == 0,
+        "flux_cmd_setopt set stdout_SINK success");
+
+    flux_subprocess_ops_t ops = {
+        .on_completion = completion_cb,
+        .on_stdout = flux_standard_output
+    };
+    p = flux_local_exec (r, 0, cmd, &ops, NULL);
+    ok (p == NULL
+        && errno == EINVAL,
+        "flux_local_exec fails with EINVAL due to bad sink fd input");
+
+    flux_cmd_destroy (cmd);
+
+    ok ((cmd = flux_cmd_create (1, av, NULL)) != NULL, "flux_cmd_create");
+
+    ok (flux_cmd_setopt (cmd,
+                         "stdout_SINK",
+                         "/subprocess-sink-noexist/out") == 0,
+        "flux_cmd_setopt set stdout_SINK success");
+
+    p = flux_local_exec (r, 0, cmd, &ops, NULL);
+    ok (p == NULL
+        && errno == ENOENT,
+        "flux_local_exec fails with ENOENT due to unopenable sink path");
+
+    flux_cmd_destroy (cmd);
+}
+
 void test_stream_start_stop_basic (flux_reactor_t *r)
 {
     char *av[] = { TEST_SUBPROCESS_DIR "test_echo", "-P", "-O", "-E", "hi", NULL };
@@ -2688,6 +2834,14 @@ int main (int argc, char *argv[])
     test_line_buffer_disable (r);
     diag ("line_buffer_error");
     test_line_buffer_error (r);
+    diag ("watermark");
+    test_watermark (r);
+    diag ("watermark_error");
+    test_watermark_error (r);
+    diag ("sink");
+    test_sink (r);
+    diag ("sink_error");
+    test_sink_error (r);
     diag ("stream_start_stop_basic");
     test_stream_start_stop_basic (r);
     diag ("stream_start_stop_initial_stop");
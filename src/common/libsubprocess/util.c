@@ -97,6 +97,35 @@ cleanup:
     return rv;
 }
 
+int cmd_option_watermark (flux_subprocess_t *p, const char *name)
+{
+    char *var;
+    const char *val;
+    int rv = -1;
+
+    if (asprintf (&var, "%s_WATERMARK", name) < 0)
+        goto cleanup;
+
+    if ((val = flux_cmd_getopt (p->cmd, var))) {
+        char *endptr;
+        errno = 0;
+        rv = strtol (val, &endptr, 10);
+        if (errno
+            || endptr[0] != '\0'
+            || rv < 0) {
+            rv = -1;
+            errno = EINVAL;
+            goto cleanup;
+        }
+    }
+    else
+        rv = 0;
+
+cleanup:
+    free (var);
+    return rv;
+}
+
 int cmd_option_stream_stop (flux_subprocess_t *p, const char *name)
 {
     char *var;
@@ -122,6 +151,23 @@ cleanup:
     return rv;
 }
 
+/* Returns the sink target for stream 'name' or NULL if the option is
+ * not set.  The returned string is owned by the command object.
+ */
+const char *cmd_option_sink (flux_subprocess_t *p, const char *name)
+{
+    char *var;
+    const char *val = NULL;
+
+    if (asprintf (&var, "%s_SINK", name) < 0)
+        return NULL;
+
+    val = flux_cmd_getopt (p->cmd, var);
+
+    free (var);
+    return val;
+}
+
 /*
  * vi: ts=4 sw=4 expandtab
  */
@@ -21,6 +21,10 @@ int cmd_option_bufsize (flux_subprocess_t *p, const char *name);
 
 int cmd_option_line_buffer (flux_subprocess_t *p, const char *name);
 
+int cmd_option_watermark (flux_subprocess_t *p, const char *name);
+
 int cmd_option_stream_stop (flux_subprocess_t *p, const char *name);
 
+const char *cmd_option_sink (flux_subprocess_t *p, const char *name);
+
 #endif /* !_SUBPROCESS_UTIL_H */
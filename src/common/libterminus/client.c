@@ -23,9 +23,12 @@
 #include <czmq.h>
 
 #include <jansson.h>
+#include <sodium.h>
 
 #include "src/common/libutil/fdutils.h"
 #include "src/common/libutil/llog.h"
+#include "src/common/libutil/macros.h"
+#include "src/common/libutil/errno_safe.h"
 
 #include "pty.h"
 
@@ -50,6 +53,11 @@ struct flux_pty_client {
 
     flux_watcher_t *fdw;  /* fd watcher for STDIN */
     flux_watcher_t *sw;   /* signal watcher       */
+    flux_watcher_t *ow;   /* POLLOUT watcher for terminal writes */
+
+    char *obuf;           /* terminal output awaiting write */
+    int obuf_len;
+    int obuf_size;
 
     struct termios term;
 
@@ -69,7 +77,9 @@ void flux_pty_client_destroy (struct flux_pty_client *c)
         int saved_errno = errno;
         flux_watcher_destroy (c->fdw);
         flux_watcher_destroy (c->sw);
+        flux_watcher_destroy (c->ow);
         zlist_destroy (&c->exit_waiters);
+        free (c->obuf);
         free (c->exit_message);
         free (c->service);
         free (c);
@@ -179,6 +189,21 @@ static void flux_pty_client_stop (struct flux_pty_client *c)
 {
     flux_watcher_stop (c->fdw);
     flux_watcher_stop (c->sw);
+
+    /*  Drain any buffered terminal output before detach/exit so the
+     *   tail of the session is not lost.
+     */
+    while (c->obuf_len > 0) {
+        ssize_t n = write (STDIN_FILENO, c->obuf, c->obuf_len);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EINTR)
+                continue;
+            break;
+        }
+        c->obuf_len -= n;
+        memmove (c->obuf, c->obuf + n, c->obuf_len);
+    }
+    flux_watcher_stop (c->ow);
 }
 
 static int flux_pty_client_set_server (struct flux_pty_client *c,
@@ -247,19 +272,90 @@ static void pty_client_attached (struct flux_pty_client *c)
     c->attached = true;
 }
 
+/*  Write as much buffered output as the terminal will accept, without
+ *   blocking the reactor, so a slow terminal applies backpressure to
+ *   rendering instead of stalling message processing.
+ */
+static void terminal_write_cb (flux_reactor_t *r,
+                               flux_watcher_t *w,
+                               int revents,
+                               void *arg)
+{
+    struct flux_pty_client *c = arg;
+    ssize_t n;
+
+    if (c->obuf_len > 0) {
+        if ((n = write (STDIN_FILENO, c->obuf, c->obuf_len)) < 0) {
+            if (errno != EAGAIN && errno != EINTR)
+                llog_error (c, "write: %s", strerror (errno));
+            return;
+        }
+        c->obuf_len -= n;
+        memmove (c->obuf, c->obuf + n, c->obuf_len);
+    }
+    if (c->obuf_len == 0)
+        flux_watcher_stop (w);
+}
+
+static int pty_client_render (struct flux_pty_client *c,
+                              const char *data,
+                              size_t len)
+{
+    if (c->obuf_len + len > c->obuf_size) {
+        int nsize = c->obuf_size > 0 ? c->obuf_size : 4096;
+        char *nbuf;
+        while (nsize < c->obuf_len + len)
+            nsize *= 2;
+        if (!(nbuf = realloc (c->obuf, nsize)))
+            return -1;
+        c->obuf = nbuf;
+        c->obuf_size = nsize;
+    }
+    memcpy (c->obuf + c->obuf_len, data, len);
+    c->obuf_len += len;
+    flux_watcher_start (c->ow);
+    return 0;
+}
+
 static void pty_client_data (struct flux_pty_client *c, flux_future_t *f)
 {
     const char *data;
+    const char *encoding = NULL;
+    char *bin = NULL;
     size_t len;
 
-    if (flux_rpc_get_unpack (f, "{s:s%}", "data", &data, &len) < 0) {
+    if (flux_rpc_get_unpack (f,
+                             "{s:s% s?s}",
+                             "data", &data, &len,
+                             "encoding", &encoding) < 0) {
         llog_error (c, "unpack: %s", future_strerror (f, errno));
         return;
     }
-    if (write (STDIN_FILENO, data, len) < 0) {
-        llog_error (c, "data decode failed: %s", strerror (errno));
-        return;
+    /*  Data that is not valid utf-8 arrives in a base64 frame.
+     */
+    if (encoding) {
+        size_t binlen = BASE64_DECODE_SIZE (len);
+        if (strcmp (encoding, "base64") != 0) {
+            llog_error (c, "unknown data encoding: %s", encoding);
+            return;
+        }
+        if (!(bin = malloc (binlen))) {
+            llog_error (c, "out of memory decoding %zu bytes", len);
+            return;
+        }
+        if (sodium_base642bin ((unsigned char *) bin, binlen, data, len,
+                               NULL, &binlen, NULL,
+                               sodium_base64_VARIANT_ORIGINAL) < 0) {
+            llog_error (c, "data decode failed");
+            free (bin);
+            return;
+        }
+        data = bin;
+        len = binlen;
     }
+    if (pty_client_render (c, data, len) < 0)
+        llog_error (c, "data render failed: %s", strerror (errno));
+    free (bin);
 }
 
 static void client_resize_cb (flux_future_t *f, void *arg)
@@ -376,14 +472,40 @@ flux_future_t *flux_pty_client_write (struct flux_pty_client *c,
                                       const void *buf,
                                       ssize_t len)
 {
+    flux_future_t *f;
+    json_t *o;
+
     if (!c || !buf || len <= 0) {
         errno = EINVAL;
         return NULL;
     }
-    return flux_rpc_pack (c->h, c->service, c->rank, 0,
-                          "{s:s s:s%}",
-                          "type", "data",
-                          "data", buf, len);
+    /*  Input that is not valid utf-8 (e.g. a paste of binary data, or
+     *   a multibyte sequence split across reads) cannot be carried by
+     *   the JSON codec directly; send it in a base64 frame.
+     */
+    if ((o = json_stringn (buf, len))) {
+        json_decref (o);
+        f = flux_rpc_pack (c->h, c->service, c->rank, 0,
+                           "{s:s s:s%}",
+                           "type", "data",
+                           "data", buf, len);
+    }
+    else {
+        size_t b64len = sodium_base64_encoded_len (len,
+                                           sodium_base64_VARIANT_ORIGINAL);
+        char *b64;
+        if (!(b64 = malloc (b64len)))
+            return NULL;
+        sodium_bin2base64 (b64, b64len, (const unsigned char *) buf, len,
+                           sodium_base64_VARIANT_ORIGINAL);
+        f = flux_rpc_pack (c->h, c->service, c->rank, 0,
+                           "{s:s s:s s:s}",
+                           "type", "data",
+                           "data", b64,
+                           "encoding", "base64");
+        ERRNO_SAFE_WRAP (free, b64);
+    }
+    return f;
 }
 
 static void pty_read_cb (flux_reactor_t *r,
@@ -472,7 +594,12 @@ int flux_pty_client_attach (struct flux_pty_client *c,
                                         SIGWINCH,
                                         sigwinch_cb,
                                         c);
-    if (!c->fdw || !c->sw)
+    c->ow = flux_fd_watcher_create (flux_get_reactor (h),
+                                    STDIN_FILENO,
+                                    FLUX_POLLOUT,
+                                    terminal_write_cb,
+                                    c);
+    if (!c->fdw || !c->sw || !c->ow)
         return -1;
 
     mode = c->flags & FLUX_PTY_CLIENT_STDIN_PIPE ? "wo" : "rw";
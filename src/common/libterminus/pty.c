@@ -25,8 +25,10 @@
  *  Resize request: (client->server or server->client)
  *  { "type":"resize", "winsize"?{"rows":i,"colums":i} }
  *
- *  Client/server write raw data to tty (string is utf-8)
- *  { "type":"data", "data":s% }
+ *  Client/server write raw data to tty.  Data that is not valid utf-8
+ *  (which the JSON codec refuses to carry) is base64 encoded and
+ *  tagged with an encoding hint:
+ *  { "type":"data", "data":s%, "encoding"?:"base64" }
  *
  *  Client detach:
  *  { "type":"detach" }
@@ -50,14 +52,26 @@
 
 #include <jansson.h>
 #include <czmq.h>
+#include <sodium.h>
 
 #include "src/common/libutil/fdutils.h"
 #include "src/common/libutil/errno_safe.h"
+#include "src/common/libutil/macros.h"
 
 #include "src/common/libutil/llog.h"
 
 #include "pty.h"
 
+/*  Coalesce tty output in a write-behind buffer, flushed when it
+ *  exceeds the high watermark or a short timer expires, whichever
+ *  comes first.  This bounds added interactive latency while turning
+ *  a flood of small reads into a few large messages under bulk output.
+ */
+static const int pty_obuf_hiwat = 65536;
+static const double pty_flush_timeout = 0.01;
+
+static void pty_output_flush (struct flux_pty *pty);
+
 struct pty_client {
     char *uuid;
     const flux_msg_t *req;
@@ -76,6 +90,12 @@ struct flux_pty {
     char *follower;
     flux_watcher_t *fdw;
 
+    char *obuf;               /* coalesced tty output awaiting flush */
+    int obuf_len;
+    int obuf_size;
+    flux_watcher_t *flush_timer;
+    bool flush_timer_armed;
+
     int flags;
     int exit_status;
 
@@ -168,6 +188,10 @@ static int pty_clients_notify_exit (struct flux_pty *pty, int status)
 static int pty_client_detach (struct flux_pty *pty, struct pty_client *c)
 {
     if (c) {
+        /*  Push out any coalesced output so the tail of the session
+         *   is not lost on detach.
+         */
+        pty_output_flush (pty);
         pty_client_send_exit (pty, c, "Client requested detach", 0);
         zlist_remove (pty->clients, c);
         pty_client_destroy (c);
@@ -216,11 +240,14 @@ void flux_pty_close (struct flux_pty *pty, int status)
 {
     if (pty) {
         flux_watcher_destroy (pty->fdw);
+        pty_output_flush (pty);
+        flux_watcher_destroy (pty->flush_timer);
         pty_clients_notify_exit (pty, status);
         pty_clients_destroy (pty);
         zlist_destroy (&pty->clients);
         if (pty->leader >= 0)
             close (pty->leader);
+        free (pty->obuf);
         free (pty->follower);
         free (pty);
     }
@@ -332,19 +359,92 @@ int flux_pty_attach (struct flux_pty *pty)
 
 static void pty_client_send_data (struct flux_pty *pty, void *data, int len)
 {
-    struct pty_client *c = zlist_first (pty->clients);
+    struct pty_client *c;
+    const char *encoding = NULL;
+    char *b64 = NULL;
+    json_t *o;
+
+    /*  Terminal output need not be valid utf-8 (alternate charsets,
+     *   multibyte sequences split at buffer boundaries), and the JSON
+     *   codec refuses to carry strings that are not.  Send such data
+     *   in a base64 frame; valid utf-8 passes through unchanged.
+     */
+    if ((o = json_stringn (data, len)))
+        json_decref (o);
+    else {
+        size_t b64len = sodium_base64_encoded_len (len,
+                                           sodium_base64_VARIANT_ORIGINAL);
+        if (!(b64 = malloc (b64len))) {
+            llog_error (pty, "failed to encode %d bytes of tty data", len);
+            return;
+        }
+        sodium_bin2base64 (b64, b64len, (unsigned char *) data, len,
+                           sodium_base64_VARIANT_ORIGINAL);
+        encoding = "base64";
+    }
 
+    c = zlist_first (pty->clients);
     while (c) {
         if (c->read_enabled) {
-            if (flux_respond_pack (pty->h,
-                                   c->req,
-                                   "{s:s s:s#}",
-                                   "type", "data",
-                                   "data", (char *) data, len) < 0)
+            int rc;
+            if (encoding)
+                rc = flux_respond_pack (pty->h,
+                                        c->req,
+                                        "{s:s s:s s:s}",
+                                        "type", "data",
+                                        "data", b64,
+                                        "encoding", encoding);
+            else
+                rc = flux_respond_pack (pty->h,
+                                        c->req,
+                                        "{s:s s:s#}",
+                                        "type", "data",
+                                        "data", (char *) data, len);
+            if (rc < 0)
                 llog_error (pty, "send data: %s", strerror (errno));
         }
         c = zlist_next (pty->clients);
     }
+    free (b64);
+}
+
+static void pty_output_flush (struct flux_pty *pty)
+{
+    if (pty->obuf_len > 0) {
+        pty_client_send_data (pty, pty->obuf, pty->obuf_len);
+        pty->obuf_len = 0;
+    }
+    if (pty->flush_timer_armed) {
+        flux_watcher_stop (pty->flush_timer);
+        pty->flush_timer_armed = false;
+    }
+}
+
+static void pty_flush_timer_cb (flux_reactor_t *r,
+                                flux_watcher_t *w,
+                                int revents,
+                                void *arg)
+{
+    struct flux_pty *pty = arg;
+    pty->flush_timer_armed = false;
+    pty_output_flush (pty);
+}
+
+static int pty_output_append (struct flux_pty *pty, const char *buf, int len)
+{
+    if (pty->obuf_len + len > pty->obuf_size) {
+        int nsize = pty->obuf_size > 0 ? pty->obuf_size : 4096;
+        char *nbuf;
+        while (nsize < pty->obuf_len + len)
+            nsize *= 2;
+        if (!(nbuf = realloc (pty->obuf, nsize)))
+            return -1;
+        pty->obuf = nbuf;
+        pty->obuf_size = nsize;
+    }
+    memcpy (pty->obuf + pty->obuf_len, buf, len);
+    pty->obuf_len += len;
+    return 0;
 }
 
 static void pty_read (flux_reactor_t *r,
@@ -370,13 +470,25 @@ static void pty_read (flux_reactor_t *r,
          */
         if (errno == EIO) {
             flux_watcher_stop (pty->fdw);
+            pty_output_flush (pty);
             return;
         }
         llog_error (pty, "read: %s", strerror (errno));
         return;
     }
-    else if (n > 0)
-        pty_client_send_data (pty, buf, n);
+    else if (n > 0) {
+        if (pty_output_append (pty, buf, n) < 0) {
+            llog_error (pty, "output append: %s", strerror (errno));
+            return;
+        }
+        if (pty->obuf_len >= pty_obuf_hiwat)
+            pty_output_flush (pty);
+        else if (!pty->flush_timer_armed) {
+            flux_timer_watcher_reset (pty->flush_timer, pty_flush_timeout, 0.);
+            flux_watcher_start (pty->flush_timer);
+            pty->flush_timer_armed = true;
+        }
+    }
 }
 
 static int pty_resize (struct flux_pty *pty, const flux_msg_t *msg)
@@ -481,16 +593,45 @@ err:
 static int pty_write (struct flux_pty *pty, const flux_msg_t *msg)
 {
     const char *data;
+    const char *encoding = NULL;
+    char *bin = NULL;
     size_t len;
-    if (flux_msg_unpack (msg, "{s:s%}", "data", &data, &len) < 0) {
+    int rc = -1;
+
+    if (flux_msg_unpack (msg,
+                         "{s:s% s?s}",
+                         "data", &data, &len,
+                         "encoding", &encoding) < 0) {
         llog_error (pty, "msg_unpack failed");
         return -1;
     }
+    if (encoding) {
+        size_t binlen = BASE64_DECODE_SIZE (len);
+        if (strcmp (encoding, "base64") != 0) {
+            llog_error (pty, "unknown data encoding: %s", encoding);
+            errno = EPROTO;
+            return -1;
+        }
+        if (!(bin = malloc (binlen)))
+            return -1;
+        if (sodium_base642bin ((unsigned char *) bin, binlen, data, len,
+                               NULL, &binlen, NULL,
+                               sodium_base64_VARIANT_ORIGINAL) < 0) {
+            llog_error (pty, "base64 decode of data failed");
+            errno = EPROTO;
+            goto out;
+        }
+        data = bin;
+        len = binlen;
+    }
     if (write (pty->leader, data, len) < 0) {
         llog_error (pty, "write: %s", strerror (errno));
-        return -1;
+        goto out;
     }
-    return 0;
+    rc = 0;
+out:
+    ERRNO_SAFE_WRAP (free, bin);
+    return rc;
 }
 
 int flux_pty_sendmsg (struct flux_pty *pty, const flux_msg_t *msg)
@@ -589,6 +730,13 @@ int flux_pty_set_flux (struct flux_pty *pty, flux_t *h)
     if (!pty->fdw)
         return -1;
 
+    pty->flush_timer = flux_timer_watcher_create (flux_get_reactor (h),
+                                                  pty_flush_timeout, 0.,
+                                                  pty_flush_timer_cb,
+                                                  pty);
+    if (!pty->flush_timer)
+        return -1;
+
     fd_set_nonblocking (pty->leader);
 
     return 0;
@@ -328,6 +328,42 @@ static void test_basic_protocol (void)
     flux_future_destroy (f);
 
 
+    /* write from attached client, base64 encoded data */
+    ok ((f = flux_rpc_pack (h, "pty", 0, 0,
+                            "{s:s s:s s:s}",
+                            "type", "data",
+                            "data", "AAECAwQF",
+                            "encoding", "base64")) != NULL,
+        "request: type data, base64 encoding");
+    ok (flux_rpc_get (f, NULL) == 0,
+        "response: OK");
+    flux_future_destroy (f);
+
+
+    /* write from attached client, unknown encoding */
+    ok ((f = flux_rpc_pack (h, "pty", 0, 0,
+                            "{s:s s:s s:s}",
+                            "type", "data",
+                            "data", "AAECAwQF",
+                            "encoding", "rot13")) != NULL,
+        "request: type data, unknown encoding");
+    ok (flux_rpc_get (f, NULL) < 0 && errno == EPROTO,
+        "response: EPROTO");
+    flux_future_destroy (f);
+
+
+    /* write from attached client, data is not valid base64 */
+    ok ((f = flux_rpc_pack (h, "pty", 0, 0,
+                            "{s:s s:s s:s}",
+                            "type", "data",
+                            "data", "!!not base64!!",
+                            "encoding", "base64")) != NULL,
+        "request: type data, invalid base64 data");
+    ok (flux_rpc_get (f, NULL) < 0 && errno == EPROTO,
+        "response: EPROTO");
+    flux_future_destroy (f);
+
+
     /* invalid msg type from attached client */
     ok ((f = flux_rpc_pack (h, "pty", 0, 0,
                             "{s:s}",
@@ -417,6 +453,16 @@ static void test_client()
         rc == 0 ? "Success" : strerror (errno));
     flux_future_destroy (f);
 
+    /*  \xc3\x28 is an invalid utf-8 sequence, forcing a base64 frame */
+    f = flux_pty_client_write (c, "\xc3\x28\r", 3);
+    ok (f != NULL,
+        "flux_pty_client_write with non-utf-8 data");
+    rc = flux_future_get (f, NULL);
+    ok (rc == 0,
+        "flux_pty_client_write non-utf-8: %s",
+        rc == 0 ? "Success" : strerror (errno));
+    flux_future_destroy (f);
+
     ok (flux_pty_client_detach (c) == 0,
         "flux_pty_client_detach");
 
@@ -488,16 +488,27 @@ again:
     return 0;
 }
 
-double cronodate_remaining (cronodate_t *d, double now)
+int cronodate_next_time (cronodate_t *d, time_t now, time_t *nextp)
 {
     struct tm tm;
-    time_t t = (time_t) now;
-    if (localtime_r (&t, &tm) == NULL)
-        return (-1.);
+    if (d == NULL || nextp == NULL) {
+        errno = EINVAL;
+        return (-1);
+    }
+    if (localtime_r (&now, &tm) == NULL)
+        return (-1);
     if (cronodate_next (d, &tm) < 0)
+        return (-1);
+    *nextp = mktime (&tm);
+    return (0);
+}
+
+double cronodate_remaining (cronodate_t *d, double now)
+{
+    time_t next;
+    if (cronodate_next_time (d, (time_t) now, &next) < 0)
         return (-1.);
-    t = mktime (&tm);
-    return ((double) t - now);
+    return ((double) next - now);
 }
  /* vi:tabstop=4 shiftwidth=4 expandtab
  */
@@ -93,6 +93,13 @@ bool cronodate_match (cronodate_t *d, struct tm *tm);
  */
 int cronodate_next (cronodate_t *d, struct tm *now);
 
+/*
+ *  Compute the next date/time matching `d` strictly after epoch time
+ *   `now` and return it in `nextp`. The computation advances whole
+ *   date/time fields (it does not scan tick by tick).
+ */
+int cronodate_next_time (cronodate_t *d, time_t now, time_t *nextp);
+
 /*
  *  Given epoch in floating points seconds `now` return the time
  *   remaining in floating point seconds until the next matching
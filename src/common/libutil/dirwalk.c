@@ -28,6 +28,8 @@ struct direntry {
     int dirfd;
     char *path;
     const char *basename;
+    unsigned char d_type;
+    int stat_valid;
     struct stat sb;
 };
 
@@ -60,15 +62,24 @@ static void direntry_destroy (struct direntry *e)
  *   directory entry `dent`.
  */
 static struct direntry *direntry_create (int fd, const char *dir,
-                                         struct dirent *dent)
+                                         struct dirent *dent, int flags)
 {
     struct direntry *e = calloc (1, sizeof (*e));
     if (!e)
         return NULL;
     if (asprintf (&e->path, "%s/%s", dir, dent->d_name) < 0)
         goto out_err;
-    if (fstatat (fd, dent->d_name, &e->sb, AT_SYMLINK_NOFOLLOW) < 0)
-        goto out_err;
+    e->d_type = dent->d_type;
+    /*
+     *  Elide the per-entry stat(2) where the filesystem supplies a
+     *   usable d_type and the caller requested DIRWALK_NO_STAT.
+     *   dirwalk_stat() will stat on demand if a visitor needs it.
+     */
+    if (!(flags & DIRWALK_NO_STAT) || e->d_type == DT_UNKNOWN) {
+        if (fstatat (fd, dent->d_name, &e->sb, AT_SYMLINK_NOFOLLOW) < 0)
+            goto out_err;
+        e->stat_valid = 1;
+    }
     e->dirfd = fd;
     return (e);
 out_err:
@@ -76,6 +87,13 @@ out_err:
     return NULL;
 }
 
+static int direntry_isdir (struct direntry *e)
+{
+    if (e->stat_valid)
+        return S_ISDIR (e->sb.st_mode);
+    return (e->d_type == DT_DIR);
+}
+
 /*
  *  Create a direntry for an initial dirpath. Force open the parent dirfd
  *   from `dir/..` for this special object.
@@ -99,6 +117,8 @@ static struct direntry *direntry_create_dir (const char *dirpath)
      */
     if (stat (dirpath, &e->sb) < 0)
         goto out_err;
+    e->stat_valid = 1;
+    e->d_type = DT_DIR;
 
     free (parent);
     return e;
@@ -159,9 +179,16 @@ const char * dirwalk_path (dirwalk_t *d)
 
 const struct stat * dirwalk_stat (dirwalk_t *d)
 {
-    if (!d->current)
+    struct direntry *e = d->current;
+    if (!e)
         return NULL;
-    return &d->current->sb;
+    if (!e->stat_valid) {
+        if (fstatat (e->dirfd, dirwalk_name (d), &e->sb,
+                     AT_SYMLINK_NOFOLLOW) < 0)
+            return NULL;
+        e->stat_valid = 1;
+    }
+    return &e->sb;
 }
 
 int dirwalk_dirfd (dirwalk_t *d)
@@ -175,7 +202,7 @@ int dirwalk_isdir (dirwalk_t *d)
 {
     if (!d->current)
         return 0;
-    return S_ISDIR (d->current->sb.st_mode);
+    return direntry_isdir (d->current);
 }
 
 static int is_dotted_dir (struct dirent *dent)
@@ -221,12 +248,12 @@ static int dirwalk_traverse (dirwalk_t *d, dirwalk_filter_f fn, void *arg)
     while ((dent = readdir (dirp)) && !d->stopped) {
         if (is_dotted_dir (dent))
             continue;
-        if (!(d->current = direntry_create (fd, path, dent))) {
+        if (!(d->current = direntry_create (fd, path, dent, d->flags))) {
             if (errno == ENOMEM)
                 dirwalk_stop (d, errno);
             continue;
         }
-        if (S_ISDIR (d->current->sb.st_mode)) {
+        if (direntry_isdir (d->current)) {
             /*
              *  Save current direntry onto stack and call traverse()
              */
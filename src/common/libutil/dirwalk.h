@@ -19,6 +19,8 @@ enum {
     DIRWALK_DEPTH =    1<<0,  /* Traverse in depth-first order             */
     DIRWALK_REALPATH = 1<<1,  /* Resolve all paths with realpath(3)        */
     DIRWALK_FIND_DIR = 1<<2,  /* Do not skip directories in dirwalk_find() */
+    DIRWALK_NO_STAT =  1<<3,  /* Elide per-entry stat(2) where dirent
+                               *  d_type is usable (stat on demand)         */
 };
 
 /*
@@ -61,7 +63,8 @@ const char * dirwalk_path (dirwalk_t *d);
 const char * dirwalk_name (dirwalk_t *d);
 
 /*  Return a pointer to the struct stat structure for the current file
- *   being visited during a dirwalk.
+ *   being visited during a dirwalk. With DIRWALK_NO_STAT, the stat is
+ *   performed on demand by this call. Returns NULL on stat failure.
  */
 const struct stat * dirwalk_stat (dirwalk_t *d);
 
@@ -108,6 +108,16 @@ void ev_zmq_stop (struct ev_loop *loop, ev_zmq *w)
     ev_idle_stop (loop, &w->idle_w);
 }
 
+/* Must be called while the watcher is stopped.
+ */
+void ev_zmq_set_priority (ev_zmq *w, int priority)
+{
+    ev_set_priority (&w->prepare_w, priority);
+    ev_set_priority (&w->check_w, priority);
+    ev_set_priority (&w->io_w, priority);
+    ev_set_priority (&w->idle_w, priority);
+}
+
 /*
  * vi:tabstop=4 shiftwidth=4 expandtab
  */
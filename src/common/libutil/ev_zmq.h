@@ -29,6 +29,7 @@ struct ev_zmq_struct {
 int ev_zmq_init (ev_zmq *w, ev_zmq_cb cb, void *zsock, int events);
 void ev_zmq_start (struct ev_loop *loop, ev_zmq *w);
 void ev_zmq_stop (struct ev_loop *loop, ev_zmq *w);
+void ev_zmq_set_priority (ev_zmq *w, int priority);
 
 /* Convert zeromq poll bits to libev's, for construction of 'events'
  * when registering a watcher.
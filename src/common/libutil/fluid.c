@@ -132,15 +132,21 @@ uint64_t fluid_get_timestamp (fluid_t fluid)
 }
 
 /* If sequence bits were exhausted (already 1024 allocated in this timestamp),
- * busy-wait, calling update_timestamp() until seq is cleared.
- * The busy-wait time is bounded by the timestamp quanta (1 msec).
+ * claim the next millisecond's block of sequence numbers rather than waiting
+ * for the clock to advance.  The timestamp may briefly lead the clock during
+ * a burst, but IDs remain unique and monotonic, and update_timestamp() will
+ * not move the timestamp backwards once the clock catches up.
  */
 int fluid_generate (struct fluid_generator *gen, fluid_t *fluid)
 {
-    do {
-        if (update_timestamp (gen) < 0)
-            return -1;
-    } while (gen->seq + 1 >= (1ULL<<bits_per_seq));
+    if (update_timestamp (gen) < 0)
+        return -1;
+    if (gen->seq + 1 >= (1ULL<<bits_per_seq)) {
+        if (gen->timestamp + 1 >= (1ULL<<bits_per_ts))
+            return -1; // (unlikely) lifetime of FLUID sequence is over
+        gen->timestamp++;
+        gen->seq = 0;
+    }
     *fluid = (gen->timestamp << (bits_per_seq + bits_per_id)
                     | (gen->id << bits_per_seq)
                     | gen->seq);
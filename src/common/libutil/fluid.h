@@ -43,8 +43,9 @@ int fluid_init (struct fluid_generator *gen, uint32_t id, uint64_t timestamp);
 
 /* Returns 0 on success, -1 on failure.
  * Failures include timestamp out of range, clock_gettime() error.
- * N.B. may occasionally call usleep(3) for up to 1 ms to throttle
- * demand on each generator to at most 1024 FLUID's per ms.
+ * N.B. if more than 1024 FLUIDs are requested in one ms, the generator
+ * allocates from future timestamp blocks rather than throttling, so the
+ * timestamp embedded in a FLUID may slightly lead the clock after a burst.
  */
 int fluid_generate (struct fluid_generator *gen, fluid_t *fluid);
 
@@ -0,0 +1,190 @@
+/************************************************************\
+ * Copyright 2014 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <sys/param.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <czmq.h>
+
+#include "hostcache.h"
+
+struct hostcache {
+    zhash_t *entries;           /* host -> numeric address */
+    char path[PATH_MAX + 1];
+};
+
+static int hostcache_default_path (char *buf, int bufsz)
+{
+    const char *tmpdir = getenv ("TMPDIR");
+
+    if (snprintf (buf,
+                  bufsz,
+                  "%s/flux-hostcache-%u",
+                  tmpdir ? tmpdir : "/tmp",
+                  getuid ()) >= bufsz) {
+        errno = EOVERFLOW;
+        return -1;
+    }
+    return 0;
+}
+
+/* Load cached entries, one "host address" pair per line.
+ * A missing file is not an error - the cache starts out empty.
+ * Malformed lines are ignored so a corrupt cache degrades to lookups.
+ */
+static int hostcache_load (struct hostcache *hc)
+{
+    FILE *f;
+    char line[2 * NI_MAXHOST];
+    char host[NI_MAXHOST];
+    char addr[NI_MAXHOST];
+
+    if (!(f = fopen (hc->path, "r"))) {
+        if (errno == ENOENT)
+            return 0;
+        return -1;
+    }
+    while (fgets (line, sizeof (line), f)) {
+        char *cpy;
+        if (sscanf (line, "%1024s %1024s", host, addr) != 2)
+            continue;
+        if (!(cpy = strdup (addr)))
+            continue;
+        zhash_update (hc->entries, host, cpy);
+        zhash_freefn (hc->entries, host, (zhash_free_fn *)free);
+    }
+    fclose (f);
+    return 0;
+}
+
+/* Append an entry to the cache file, creating it user-readable only.
+ * Failure to persist is not fatal - the in-memory entry still stands.
+ */
+static void hostcache_append (struct hostcache *hc,
+                              const char *host,
+                              const char *addr)
+{
+    int fd;
+
+    if ((fd = open (hc->path, O_WRONLY | O_CREAT | O_APPEND, 0600)) < 0)
+        return;
+    dprintf (fd, "%s %s\n", host, addr);
+    close (fd);
+}
+
+int hostcache_resolve (struct hostcache *hc,
+                       const char *host,
+                       char *buf,
+                       int bufsz)
+{
+    struct addrinfo hints, *res = NULL;
+    char addr[NI_MAXHOST];
+    unsigned char ia[sizeof (struct in6_addr)];
+    const char *val;
+    char *cpy;
+
+    if (!hc || !host || !buf) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* Numeric addresses pass through without a lookup.
+     */
+    if (inet_pton (AF_INET, host, ia) == 1
+            || inet_pton (AF_INET6, host, ia) == 1) {
+        val = host;
+        goto out;
+    }
+    if ((val = zhash_lookup (hc->entries, host)))
+        goto out;
+    memset (&hints, 0, sizeof (hints));
+    hints.ai_family = PF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo (host, NULL, &hints, &res) != 0 || res == NULL) {
+        errno = ENOENT;
+        return -1;
+    }
+    if (getnameinfo (res->ai_addr,
+                     res->ai_addrlen,
+                     addr,
+                     sizeof (addr),
+                     NULL,
+                     0,
+                     NI_NUMERICHOST) != 0) {
+        freeaddrinfo (res);
+        errno = ENOENT;
+        return -1;
+    }
+    freeaddrinfo (res);
+    if ((cpy = strdup (addr))) {
+        zhash_update (hc->entries, host, cpy);
+        zhash_freefn (hc->entries, host, (zhash_free_fn *)free);
+    }
+    hostcache_append (hc, host, addr);
+    val = addr;
+out:
+    if (snprintf (buf, bufsz, "%s", val) >= bufsz) {
+        errno = EOVERFLOW;
+        return -1;
+    }
+    return 0;
+}
+
+struct hostcache *hostcache_create (const char *path)
+{
+    struct hostcache *hc;
+
+    if (!(hc = calloc (1, sizeof (*hc))))
+        return NULL;
+    if (path) {
+        if (snprintf (hc->path, sizeof (hc->path), "%s", path)
+                                                >= sizeof (hc->path)) {
+            errno = EOVERFLOW;
+            goto error;
+        }
+    }
+    else if (hostcache_default_path (hc->path, sizeof (hc->path)) < 0)
+        goto error;
+    if (!(hc->entries = zhash_new ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (hostcache_load (hc) < 0)
+        goto error;
+    return hc;
+error:
+    hostcache_destroy (hc);
+    return NULL;
+}
+
+void hostcache_destroy (struct hostcache *hc)
+{
+    if (hc) {
+        int saved_errno = errno;
+        zhash_destroy (&hc->entries);
+        free (hc);
+        errno = saved_errno;
+    }
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
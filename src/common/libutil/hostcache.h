@@ -0,0 +1,48 @@
+/************************************************************\
+ * Copyright 2014 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _UTIL_HOSTCACHE_H
+#define _UTIL_HOSTCACHE_H
+
+/* hostcache - resolve hostnames to numeric addresses with a cache
+ * persisted across process restarts.
+ *
+ * Resolutions are cached in a per-user file so that a broker restart
+ * does not repeat DNS lookups performed by a previous instance, and a
+ * slow or unreachable DNS server cannot delay boot for names that have
+ * been resolved before.
+ */
+
+struct hostcache;
+
+/* Create a hostcache, loading any previously cached entries from 'path'.
+ * If path is NULL, a per-user default under TMPDIR is used.
+ * Returns cache on success, NULL on failure with errno set.
+ */
+struct hostcache *hostcache_create (const char *path);
+
+void hostcache_destroy (struct hostcache *hc);
+
+/* Resolve 'host' to a numeric address, copied to 'buf'.
+ * A host that is already a numeric IPv4/IPv6 address is copied through
+ * without a lookup.  A cache hit is returned without consulting DNS;
+ * a miss is resolved with getaddrinfo(3) and appended to the cache file.
+ * Returns 0 on success, -1 on failure with errno set.
+ */
+int hostcache_resolve (struct hostcache *hc,
+                       const char *host,
+                       char *buf,
+                       int bufsz);
+
+#endif /* !_UTIL_HOSTCACHE_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -8,7 +8,17 @@
  * SPDX-License-Identifier: LGPL-3.0
 \************************************************************/
 
-/* lru_cache.c - simple lru cache in c */
+/* lru_cache.c - simple lru cache in c
+ *
+ * The cache is segmented to resist scan pollution: new entries start
+ * on a probationary list and are only promoted to the protected list
+ * (capped at 2/3 of maxsize) when hit again, so a burst of one-shot
+ * keys cycles through probation without displacing the working set.
+ * Eviction takes the probationary tail first.
+ *
+ * In addition to the entry count limit, a caller-supplied weight
+ * function enables byte-size-aware eviction (see lru_cache_set_weight_f).
+ */
 
 #if HAVE_CONFIG_H
 #include "config.h"
@@ -18,10 +28,16 @@
 
 #include "lru_cache.h"
 
+struct lru_list {
+    struct lru_entry *first, *last;
+};
+
 struct lru_entry {
     lru_cache_t *lru;
     char *key;
     void *item;
+    size_t weight;
+    bool promoted;          /* entry is on protected, not probation list */
 
     struct lru_entry *prev;
     struct lru_entry *next;
@@ -31,10 +47,22 @@ struct lru_cache {
     int maxsize;
     int count;
 
+    size_t maxweight;       /* 0 = entry count limit only */
+    size_t total_weight;
+    lru_cache_weight_f weightfn;
+
+    int protected_count;
+    int protected_max;
+
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long evictions;
+
     lru_cache_free_f freefn;
 
     zhash_t *entries;
-    struct lru_entry *first, *last;
+    struct lru_list probation;
+    struct lru_list protected;
 };
 
 
@@ -48,6 +76,8 @@ lru_entry_create (lru_cache_t *lru, const char *key, void *item)
     }
     l->lru = lru;
     l->item = item;
+    l->weight = 0;
+    l->promoted = false;
     l->prev = l->next = NULL;
     return (l);
 }
@@ -63,15 +93,15 @@ static void lru_entry_destroy (struct lru_entry *l)
     }
 }
 
-static void lru_entry_remove (lru_cache_t *lru, struct lru_entry *l)
+static void lru_list_remove (struct lru_list *list, struct lru_entry *l)
 {
     /* Unlink l from queue first */
-    if (lru->first == l)
-        lru->first = l->next;
+    if (list->first == l)
+        list->first = l->next;
     else if (l->prev != NULL)
         l->prev->next = l->next;
-    if (lru->last == l)
-        lru->last = l->prev;
+    if (list->last == l)
+        list->last = l->prev;
     else if (l->next != NULL)
         l->next->prev = l->prev;
 
@@ -79,21 +109,29 @@ static void lru_entry_remove (lru_cache_t *lru, struct lru_entry *l)
     l->prev = l->next = NULL;
 }
 
-static void lru_entry_push (lru_cache_t *lru, struct lru_entry *l)
+static void lru_list_push (struct lru_list *list, struct lru_entry *l)
 {
     /* add to front of the LRU list */
-    l->next = lru->first;
-    if (lru->last == NULL) /* empty list */
-        lru->last = lru->first = l;
+    l->next = list->first;
+    if (list->last == NULL) /* empty list */
+        list->last = list->first = l;
     else { /* Update head of list */
-        lru->first->prev = l;
-        lru->first = l;
+        list->first->prev = l;
+        list->first = l;
     }
 }
 
+static struct lru_list *lru_entry_list (struct lru_entry *l)
+{
+    return l->promoted ? &l->lru->protected : &l->lru->probation;
+}
+
 static void lru_entry_purge (lru_cache_t *lru, struct lru_entry *l)
 {
-    lru_entry_remove (lru, l);
+    lru_list_remove (lru_entry_list (l), l);
+    if (l->promoted)
+        lru->protected_count--;
+    lru->total_weight -= l->weight;
 
     /* Now remove entry from hash, this will result in memory
      *  for `l` being freed.
@@ -102,24 +140,53 @@ static void lru_entry_purge (lru_cache_t *lru, struct lru_entry *l)
     lru->count--;
 }
 
+/* Evict the coldest entry: the probationary tail if there is one,
+ *  else the protected tail.
+ */
 static void lru_purge_last (lru_cache_t *lru)
 {
-    if (lru->last == NULL)
+    struct lru_entry *l;
+
+    if (!(l = lru->probation.last) && !(l = lru->protected.last))
         return;
-    lru_entry_purge (lru, lru->last);
+    lru_entry_purge (lru, l);
+    lru->evictions++;
+}
+
+/* When the protected list exceeds its cap, demote its tail back to
+ *  the front of the probation list (most-recent end, so it is still
+ *  the last probationary entry to be evicted).
+ */
+static void lru_protected_trim (lru_cache_t *lru)
+{
+    struct lru_entry *l;
+
+    while (lru->protected_count > lru->protected_max
+        && (l = lru->protected.last)) {
+        lru_list_remove (&lru->protected, l);
+        l->promoted = false;
+        lru->protected_count--;
+        lru_list_push (&lru->probation, l);
+    }
 }
 
 static void *
 lru_entry_enqueue (lru_cache_t *lru, const char *key, void *value)
 {
+    size_t weight = lru->weightfn ? lru->weightfn (value) : 0;
     struct lru_entry *l = lru_entry_create (lru, key, value);
     if (!l)
         return (NULL);
+    l->weight = weight;
 
-    if (lru->count == lru->maxsize)
+    while (lru->count > 0
+        && (lru->count >= lru->maxsize
+            || (lru->maxweight > 0
+                && lru->total_weight + weight > lru->maxweight)))
         lru_purge_last (lru);
-    lru_entry_push (lru, l);
+    lru_list_push (&lru->probation, l);
     lru->count++;
+    lru->total_weight += weight;
 
     /* Place entry on hash, and add cleanup function */
     if (zhash_insert (lru->entries, key, l) < 0)
@@ -132,10 +199,20 @@ lru_entry_enqueue (lru_cache_t *lru, const char *key, void *value)
 static void *
 lru_entry_requeue (lru_cache_t *lru, struct lru_entry *l)
 {
-    /*  If item is already at front of list, there is nothing to do */
-    if (lru->first != l) {
-        lru_entry_remove (lru, l);
-        lru_entry_push (lru, l);
+    if (l->promoted) {
+        /*  If item is already at front of list, there is nothing to do */
+        if (lru->protected.first != l) {
+            lru_list_remove (&lru->protected, l);
+            lru_list_push (&lru->protected, l);
+        }
+    }
+    else {
+        /*  Second hit promotes a probationary entry */
+        lru_list_remove (&lru->probation, l);
+        l->promoted = true;
+        lru->protected_count++;
+        lru_list_push (&lru->protected, l);
+        lru_protected_trim (lru);
     }
     return (l->item);
 }
@@ -145,29 +222,44 @@ lru_entry_requeue (lru_cache_t *lru, struct lru_entry *l)
  */
 
 /*
- *  Check cache for consistency between hash and list.
+ *  Check cache for consistency between hash and lists.
  *  Used for testing.
  */
 int lru_cache_selfcheck (lru_cache_t *lru)
 {
     int count = 0;
-    struct lru_entry *l = lru->first;
+    int protected_count = 0;
+    struct lru_entry *l;
 
-    /* front of list should never have a prev pointer */
-    if (l && l->prev != NULL)
+    /* front of lists should never have a prev pointer */
+    if (lru->probation.first && lru->probation.first->prev != NULL)
+        return (-1);
+    if (lru->protected.first && lru->protected.first->prev != NULL)
         return (-1);
 
-    while (l) {
+    for (l = lru->probation.first; l; l = l->next) {
         count++;
         /* an entry should never point to itself */
         if (l == l->next)
             return (-2);
-        l = l->next;
+        if (l->promoted)
+            return (-4);
+    }
+    for (l = lru->protected.first; l; l = l->next) {
+        count++;
+        protected_count++;
+        if (l == l->next)
+            return (-2);
+        if (!l->promoted)
+            return (-4);
     }
 
-    /* number of entries on list should equal count */
+    /* number of entries on lists should equal count */
     if (lru->count != count)
         return (-3);
+    if (lru->protected_count != protected_count
+        || lru->protected_count > lru->protected_max)
+        return (-5);
 
     return (0);
 }
@@ -183,17 +275,15 @@ lru_cache_t * lru_cache_create (int maxsize)
     lru_cache_t *lru = NULL;
     zhash_t *zh = NULL;
 
-    if (!(zh = zhash_new ()) || !(lru = malloc (sizeof (*lru)))) {
+    if (!(zh = zhash_new ()) || !(lru = calloc (1, sizeof (*lru)))) {
         free (lru);
-        free (zh);
+        zhash_destroy (&zh);
         return (NULL);
     }
 
     lru->maxsize = maxsize;
-    lru->count = 0;
+    lru->protected_max = maxsize > 1 ? maxsize * 2 / 3 : 1;
     lru->entries = zh;
-    lru->first = lru->last = NULL;
-    lru->freefn = NULL;
 
     return (lru);
 }
@@ -203,11 +293,22 @@ void lru_cache_set_free_f (lru_cache_t *lru, lru_cache_free_f fn)
     lru->freefn = fn;
 }
 
+void lru_cache_set_weight_f (lru_cache_t *lru,
+                             lru_cache_weight_f fn,
+                             size_t maxweight)
+{
+    lru->weightfn = fn;
+    lru->maxweight = maxweight;
+}
+
 void *lru_cache_get (lru_cache_t *lru, const char *key)
 {
     struct lru_entry *l;
-    if ((l = zhash_lookup (lru->entries, key)))
+    if ((l = zhash_lookup (lru->entries, key))) {
+        lru->hits++;
         return lru_entry_requeue (lru, l);
+    }
+    lru->misses++;
     return (NULL);
 }
 
@@ -220,7 +321,9 @@ bool lru_cache_check (lru_cache_t *lru, const char *key)
 
 int lru_cache_put (lru_cache_t *lru, const char *key, void *value)
 {
-    if (lru_cache_get (lru, key)) {
+    struct lru_entry *l;
+    if ((l = zhash_lookup (lru->entries, key))) {
+        lru_entry_requeue (lru, l);
         errno = EEXIST;
         return (-1);
     }
@@ -243,6 +346,24 @@ int lru_cache_size (lru_cache_t *lru)
     return (lru->count);
 }
 
+size_t lru_cache_weight (lru_cache_t *lru)
+{
+    return (lru->total_weight);
+}
+
+void lru_cache_get_stats (lru_cache_t *lru,
+                          unsigned long *hits,
+                          unsigned long *misses,
+                          unsigned long *evictions)
+{
+    if (hits)
+        *hits = lru->hits;
+    if (misses)
+        *misses = lru->misses;
+    if (evictions)
+        *evictions = lru->evictions;
+}
+
 /*
  * vi:tabstop=4 shiftwidth=4 expandtab
  */
@@ -17,8 +17,11 @@
 
 #include <stdbool.h>
 
+#include <stddef.h>
+
 typedef struct lru_cache lru_cache_t;
 typedef void (*lru_cache_free_f) (void *data);
+typedef size_t (*lru_cache_weight_f) (void *data);
 
 /*  Create a lru cache which holds at maximum `maxsize` objects
  */
@@ -30,10 +33,32 @@ void lru_cache_destroy (lru_cache_t *lru);
  */
 void lru_cache_set_free_f (lru_cache_t *lru, lru_cache_free_f fn);
 
+/*  Enable weight-based eviction: `fn` returns the weight (e.g. size in
+ *   bytes) of a cached item, and entries are evicted from the cold end
+ *   until total weight would not exceed `maxweight` (0 disables the
+ *   weight limit).  The entry count limit still applies.
+ *   Weights are sampled when an item is inserted.
+ */
+void lru_cache_set_weight_f (lru_cache_t *lru,
+                             lru_cache_weight_f fn,
+                             size_t maxweight);
+
 /*  Return current number of items stored in lru cache.
  */
 int lru_cache_size (lru_cache_t *lru);
 
+/*  Return current total weight of cached items (0 unless a weight
+ *   function has been set).
+ */
+size_t lru_cache_weight (lru_cache_t *lru);
+
+/*  Fetch hit/miss/eviction counters.  Any result pointer may be NULL.
+ */
+void lru_cache_get_stats (lru_cache_t *lru,
+                          unsigned long *hits,
+                          unsigned long *misses,
+                          unsigned long *evictions);
+
 /*  Put item `value` into cache, associated by key `key`.
  *  Returns 0 on success, -1 on failure, with EEXIST if item already cached.
  *
@@ -17,6 +17,17 @@
 #include <memory.h>
 #include "sha256.h"
 
+/* Use the x86 SHA extensions when the compiler can emit them via a
+ * function target attribute; availability is checked at run time with
+ * CPUID so the same binary still works on older machines.
+ */
+#if defined(__x86_64__) \
+    && (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5))
+#define USE_SHA_EXT 1
+#include <immintrin.h>
+#include <cpuid.h>
+#endif
+
 /****************************** MACROS ******************************/
 #define ROTLEFT(a,b) (((a) << (b)) | ((a) >> (32-(b))))
 #define ROTRIGHT(a,b) (((a) >> (b)) | ((a) << (32-(b))))
@@ -82,6 +93,249 @@ void sha256_transform(SHA256_CTX *ctx, const BYTE data[])
 	ctx->state[7] += h;
 }
 
+#ifdef USE_SHA_EXT
+/* Process nblk contiguous 64-byte blocks with the SHA-NI instructions
+ * (sha256rnds2/sha256msg1/sha256msg2).  Round constant pairs below are
+ * k[] packed two per 64-bit immediate.
+ */
+__attribute__((target("sha,sse4.1")))
+static void sha256_transform_ni(SHA256_CTX *ctx, const BYTE data[], size_t nblk)
+{
+	__m128i state0, state1, msg, tmp;
+	__m128i msg0, msg1, msg2, msg3;
+	__m128i abef_save, cdgh_save;
+	const __m128i shuf_mask =
+		_mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+	/* Load state and swizzle from ABCD,EFGH to the ABEF,CDGH layout
+	 * expected by sha256rnds2. */
+	tmp = _mm_loadu_si128((const __m128i *)&ctx->state[0]);
+	state1 = _mm_loadu_si128((const __m128i *)&ctx->state[4]);
+	tmp = _mm_shuffle_epi32(tmp, 0xB1);
+	state1 = _mm_shuffle_epi32(state1, 0x1B);
+	state0 = _mm_alignr_epi8(tmp, state1, 8);
+	state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+	while (nblk-- > 0) {
+		abef_save = state0;
+		cdgh_save = state1;
+
+		/* rounds 0-3 */
+		msg = _mm_loadu_si128((const __m128i *)(data + 0));
+		msg0 = _mm_shuffle_epi8(msg, shuf_mask);
+		msg = _mm_add_epi32(msg0,
+			_mm_set_epi64x(0xE9B5DBA5B5C0FBCFULL, 0x71374491428A2F98ULL));
+		state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+		msg = _mm_shuffle_epi32(msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+
+		/* rounds 4-7 */
+		msg1 = _mm_loadu_si128((const __m128i *)(data + 16));
+		msg1 = _mm_shuffle_epi8(msg1, shuf_mask);
+		msg = _mm_add_epi32(msg1,
+			_mm_set_epi64x(0xAB1C5ED5923F82A4ULL, 0x59F111F13956C25BULL));
+		state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+		msg = _mm_shuffle_epi32(msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+		msg0 = _mm_sha256msg1_epu32(msg0, msg1);
+
+		/* rounds 8-11 */
+		msg2 = _mm_loadu_si128((const __m128i *)(data + 32));
+		msg2 = _mm_shuffle_epi8(msg2, shuf_mask);
+		msg = _mm_add_epi32(msg2,
+			_mm_set_epi64x(0x550C7DC3243185BEULL, 0x12835B01D807AA98ULL));
+		state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+		msg = _mm_shuffle_epi32(msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+		msg1 = _mm_sha256msg1_epu32(msg1, msg2);
+
+		/* rounds 12-15 */
+		msg3 = _mm_loadu_si128((const __m128i *)(data + 48));
+		msg3 = _mm_shuffle_epi8(msg3, shuf_mask);
+		msg = _mm_add_epi32(msg3,
+			_mm_set_epi64x(0xC19BF1749BDC06A7ULL, 0x80DEB1FE72BE5D74ULL));
+		state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+		tmp = _mm_alignr_epi8(msg3, msg2, 4);
+		msg0 = _mm_add_epi32(msg0, tmp);
+		msg0 = _mm_sha256msg2_epu32(msg0, msg3);
+		msg = _mm_shuffle_epi32(msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+		msg2 = _mm_sha256msg1_epu32(msg2, msg3);
+
+		/* rounds 16-19 */
+		msg = _mm_add_epi32(msg0,
+			_mm_set_epi64x(0x240CA1CC0FC19DC6ULL, 0xEFBE4786E49B69C1ULL));
+		state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+		tmp = _mm_alignr_epi8(msg0, msg3, 4);
+		msg1 = _mm_add_epi32(msg1, tmp);
+		msg1 = _mm_sha256msg2_epu32(msg1, msg0);
+		msg = _mm_shuffle_epi32(msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+		msg3 = _mm_sha256msg1_epu32(msg3, msg0);
+
+		/* rounds 20-23 */
+		msg = _mm_add_epi32(msg1,
+			_mm_set_epi64x(0x76F988DA5CB0A9DCULL, 0x4A7484AA2DE92C6FULL));
+		state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+		tmp = _mm_alignr_epi8(msg1, msg0, 4);
+		msg2 = _mm_add_epi32(msg2, tmp);
+		msg2 = _mm_sha256msg2_epu32(msg2, msg1);
+		msg = _mm_shuffle_epi32(msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+		msg0 = _mm_sha256msg1_epu32(msg0, msg1);
+
+		/* rounds 24-27 */
+		msg = _mm_add_epi32(msg2,
+			_mm_set_epi64x(0xBF597FC7B00327C8ULL, 0xA831C66D983E5152ULL));
+		state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+		tmp = _mm_alignr_epi8(msg2, msg1, 4);
+		msg3 = _mm_add_epi32(msg3, tmp);
+		msg3 = _mm_sha256msg2_epu32(msg3, msg2);
+		msg = _mm_shuffle_epi32(msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+		msg1 = _mm_sha256msg1_epu32(msg1, msg2);
+
+		/* rounds 28-31 */
+		msg = _mm_add_epi32(msg3,
+			_mm_set_epi64x(0x1429296706CA6351ULL, 0xD5A79147C6E00BF3ULL));
+		state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+		tmp = _mm_alignr_epi8(msg3, msg2, 4);
+		msg0 = _mm_add_epi32(msg0, tmp);
+		msg0 = _mm_sha256msg2_epu32(msg0, msg3);
+		msg = _mm_shuffle_epi32(msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+		msg2 = _mm_sha256msg1_epu32(msg2, msg3);
+
+		/* rounds 32-35 */
+		msg = _mm_add_epi32(msg0,
+			_mm_set_epi64x(0x53380D134D2C6DFCULL, 0x2E1B213827B70A85ULL));
+		state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+		tmp = _mm_alignr_epi8(msg0, msg3, 4);
+		msg1 = _mm_add_epi32(msg1, tmp);
+		msg1 = _mm_sha256msg2_epu32(msg1, msg0);
+		msg = _mm_shuffle_epi32(msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+		msg3 = _mm_sha256msg1_epu32(msg3, msg0);
+
+		/* rounds 36-39 */
+		msg = _mm_add_epi32(msg1,
+			_mm_set_epi64x(0x92722C8581C2C92EULL, 0x766A0ABB650A7354ULL));
+		state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+		tmp = _mm_alignr_epi8(msg1, msg0, 4);
+		msg2 = _mm_add_epi32(msg2, tmp);
+		msg2 = _mm_sha256msg2_epu32(msg2, msg1);
+		msg = _mm_shuffle_epi32(msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+		msg0 = _mm_sha256msg1_epu32(msg0, msg1);
+
+		/* rounds 40-43 */
+		msg = _mm_add_epi32(msg2,
+			_mm_set_epi64x(0xC76C51A3C24B8B70ULL, 0xA81A664BA2BFE8A1ULL));
+		state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+		tmp = _mm_alignr_epi8(msg2, msg1, 4);
+		msg3 = _mm_add_epi32(msg3, tmp);
+		msg3 = _mm_sha256msg2_epu32(msg3, msg2);
+		msg = _mm_shuffle_epi32(msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+		msg1 = _mm_sha256msg1_epu32(msg1, msg2);
+
+		/* rounds 44-47 */
+		msg = _mm_add_epi32(msg3,
+			_mm_set_epi64x(0x106AA070F40E3585ULL, 0xD6990624D192E819ULL));
+		state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+		tmp = _mm_alignr_epi8(msg3, msg2, 4);
+		msg0 = _mm_add_epi32(msg0, tmp);
+		msg0 = _mm_sha256msg2_epu32(msg0, msg3);
+		msg = _mm_shuffle_epi32(msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+		msg2 = _mm_sha256msg1_epu32(msg2, msg3);
+
+		/* rounds 48-51 */
+		msg = _mm_add_epi32(msg0,
+			_mm_set_epi64x(0x34B0BCB52748774CULL, 0x1E376C0819A4C116ULL));
+		state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+		tmp = _mm_alignr_epi8(msg0, msg3, 4);
+		msg1 = _mm_add_epi32(msg1, tmp);
+		msg1 = _mm_sha256msg2_epu32(msg1, msg0);
+		msg = _mm_shuffle_epi32(msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+		msg3 = _mm_sha256msg1_epu32(msg3, msg0);
+
+		/* rounds 52-55 */
+		msg = _mm_add_epi32(msg1,
+			_mm_set_epi64x(0x682E6FF35B9CCA4FULL, 0x4ED8AA4A391C0CB3ULL));
+		state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+		tmp = _mm_alignr_epi8(msg1, msg0, 4);
+		msg2 = _mm_add_epi32(msg2, tmp);
+		msg2 = _mm_sha256msg2_epu32(msg2, msg1);
+		msg = _mm_shuffle_epi32(msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+
+		/* rounds 56-59 */
+		msg = _mm_add_epi32(msg2,
+			_mm_set_epi64x(0x8CC7020884C87814ULL, 0x78A5636F748F82EEULL));
+		state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+		tmp = _mm_alignr_epi8(msg2, msg1, 4);
+		msg3 = _mm_add_epi32(msg3, tmp);
+		msg3 = _mm_sha256msg2_epu32(msg3, msg2);
+		msg = _mm_shuffle_epi32(msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+
+		/* rounds 60-63 */
+		msg = _mm_add_epi32(msg3,
+			_mm_set_epi64x(0xC67178F2BEF9A3F7ULL, 0xA4506CEB90BEFFFAULL));
+		state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+		msg = _mm_shuffle_epi32(msg, 0x0E);
+		state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+
+		state0 = _mm_add_epi32(state0, abef_save);
+		state1 = _mm_add_epi32(state1, cdgh_save);
+		data += 64;
+	}
+
+	/* Swizzle back to ABCD,EFGH and store. */
+	tmp = _mm_shuffle_epi32(state0, 0x1B);
+	state1 = _mm_shuffle_epi32(state1, 0xB1);
+	state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+	state1 = _mm_alignr_epi8(state1, tmp, 8);
+	_mm_storeu_si128((__m128i *)&ctx->state[0], state0);
+	_mm_storeu_si128((__m128i *)&ctx->state[4], state1);
+}
+
+static int sha_ext_supported(void)
+{
+	static int supported = -1;
+
+	if (supported < 0) {
+		unsigned int eax, ebx, ecx, edx;
+		supported = 0;
+		if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)
+		    && (ecx & (1 << 19))			/* SSE4.1 */
+		    && __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)
+		    && (ebx & (1 << 29)))			/* SHA */
+			supported = 1;
+	}
+	return supported;
+}
+#endif /* USE_SHA_EXT */
+
+/* Process nblk contiguous 64-byte blocks, dispatching to the hardware
+ * path when available.
+ */
+static void sha256_transform_blocks(SHA256_CTX *ctx, const BYTE data[], size_t nblk)
+{
+#ifdef USE_SHA_EXT
+	if (sha_ext_supported()) {
+		sha256_transform_ni(ctx, data, nblk);
+		return;
+	}
+#endif
+	while (nblk-- > 0) {
+		sha256_transform(ctx, data);
+		data += 64;
+	}
+}
+
 void sha256_init(SHA256_CTX *ctx)
 {
 	ctx->datalen = 0;
@@ -98,17 +352,34 @@ void sha256_init(SHA256_CTX *ctx)
 
 void sha256_update(SHA256_CTX *ctx, const BYTE data[], size_t len)
 {
-	WORD i;
+	size_t n;
 
-	for (i = 0; i < len; ++i) {
-		ctx->data[ctx->datalen] = data[i];
-		ctx->datalen++;
+	// Top up and flush a partially filled block buffer first.
+	if (ctx->datalen > 0) {
+		n = 64 - ctx->datalen;
+		if (n > len)
+			n = len;
+		memcpy(ctx->data + ctx->datalen, data, n);
+		ctx->datalen += n;
+		data += n;
+		len -= n;
 		if (ctx->datalen == 64) {
-			sha256_transform(ctx, ctx->data);
+			sha256_transform_blocks(ctx, ctx->data, 1);
 			ctx->bitlen += 512;
 			ctx->datalen = 0;
 		}
 	}
+	// Hash whole blocks directly from the caller's buffer.
+	if ((n = len / 64) > 0) {
+		sha256_transform_blocks(ctx, data, n);
+		ctx->bitlen += 512 * (unsigned long long)n;
+		data += n * 64;
+		len -= n * 64;
+	}
+	if (len > 0) {
+		memcpy(ctx->data, data, len);
+		ctx->datalen = len;
+	}
 }
 
 void sha256_final(SHA256_CTX *ctx, BYTE hash[])
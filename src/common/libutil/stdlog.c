@@ -158,10 +158,35 @@ char *stdlog_split_message (const char *buf, int *len, const char *sep)
     return xtra;
 }
 
+/* Append formatted message at buf+m, masking to ascii and dropping
+ * trailing \r, \n as stdlog_vencodef () has always done.
+ * Returns message length including any overflow.
+ */
+static int append_message (char *buf, int len, int m,
+                           const char *fmt, va_list ap)
+{
+    int n, i;
+    int rc; // includes any overflow
+
+    n = vsnprintf (buf + m, len - m, fmt, ap);
+    rc = n;
+    if (n > len - m)
+        n = len - m;
+    for (i = 0; i < n; i++)
+        buf[m + i] &= 0x7f; // ensure only ascii chars are logged
+    for (i = n - 1; i >= 0; i--) {
+        if (buf[m + i] != '\r' && buf[m + i] != '\n')
+            break;
+        buf[m + i] = '\0';  // drop trailing \r, \n
+        rc--;
+    }
+    return rc;
+}
+
 int stdlog_vencodef (char *buf, int len, struct stdlog_header *hdr,
                      const char *sd, const char *fmt, va_list ap)
 {
-    int m, n, i;
+    int m;
     int rc; // includes any overflow
 
     m = snprintf (buf, len, "<%d>%d %.*s %.*s %.*s %.*s %.*s %s ",
@@ -175,19 +200,67 @@ int stdlog_vencodef (char *buf, int len, struct stdlog_header *hdr,
     rc = m;
     if (m > len)
         m = len;
+    rc += append_message (buf, len, m, fmt, ap);
+    return rc;
+}
 
-    n = vsnprintf (buf + m, len - m, fmt, ap);
-    rc += n;
+int stdlog_fixed_init (struct stdlog_fixed *fixed,
+                       const char *hostname,
+                       const char *appname,
+                       const char *procid,
+                       const char *sd)
+{
+    int n = snprintf (fixed->buf, sizeof (fixed->buf),
+                      " %.*s %.*s %.*s %s %s ",
+                      STDLOG_MAX_HOSTNAME,
+                      hostname ? hostname : STDLOG_NILVALUE,
+                      STDLOG_MAX_APPNAME,
+                      appname ? appname : STDLOG_NILVALUE,
+                      STDLOG_MAX_PROCID,
+                      procid ? procid : STDLOG_NILVALUE,
+                      STDLOG_NILVALUE,
+                      sd ? sd : STDLOG_NILVALUE);
+    if (n >= sizeof (fixed->buf)) {
+        errno = EINVAL;
+        return -1;
+    }
+    fixed->len = n;
+    return 0;
+}
+
+int stdlog_vencode_fast (char *buf, int len, const struct stdlog_fixed *fixed,
+                         int pri, const char *timestamp,
+                         const char *fmt, va_list ap)
+{
+    int m, n;
+    int rc; // includes any overflow
+
+    m = snprintf (buf, len, "<%d>1 %.*s",
+                  pri, STDLOG_MAX_TIMESTAMP,
+                  timestamp ? timestamp : STDLOG_NILVALUE);
+    rc = m;
+    if (m > len)
+        m = len;
+    n = fixed->len;
     if (n > len - m)
         n = len - m;
-    for (i = 0; i < n; i++)
-        buf[m + i] &= 0x7f; // ensure only ascii chars are logged
-    for (i = n - 1; i >= 0; i--) {
-        if (buf[m + i] != '\r' && buf[m + i] != '\n')
-            break;
-        buf[m + i] = '\0';  // drop trailing \r, \n
-        rc--;
-    }
+    memcpy (buf + m, fixed->buf, n);
+    rc += fixed->len;
+    m += n;
+    rc += append_message (buf, len, m, fmt, ap);
+    return rc;
+}
+
+int stdlog_encode_fast (char *buf, int len, const struct stdlog_fixed *fixed,
+                        int pri, const char *timestamp,
+                        const char *fmt, ...)
+{
+    va_list ap;
+    int rc;
+
+    va_start (ap, fmt);
+    rc = stdlog_vencode_fast (buf, len, fixed, pri, timestamp, fmt, ap);
+    va_end (ap);
     return rc;
 }
 
@@ -32,6 +32,12 @@
 #define STDLOG_FACILITY(pri)    ((pri)&7)
 #define STDLOG_PRI(sev,fac)     (((sev)<<3)|((fac)&7))
 
+/* Room for " HOSTNAME APPNAME PROCID MSGID", structured data,
+ * separating spaces and terminator.
+ */
+#define STDLOG_MAX_FIXED (6 + STDLOG_MAX_HOSTNAME + STDLOG_MAX_APPNAME \
+    + STDLOG_MAX_PROCID + STDLOG_MAX_MSGID + 64)
+
 struct stdlog_header {
     char buf[STDLOG_MAX_HEADER + 1];
     int pri;
@@ -55,6 +61,33 @@ int stdlog_vencodef (char *buf, int len, struct stdlog_header *hdr,
 int stdlog_encodef (char *buf, int len, struct stdlog_header *hdr,
                     const char *sd, const char *fmt, ...);
 
+/* Pre-rendered encoder state for the logging hot path. The rarely
+ * changing header tail (hostname, appname, procid, msgid, structured
+ * data) is formatted once by stdlog_fixed_init() and copied verbatim
+ * by each stdlog_encode_fast() call, which only formats the priority,
+ * timestamp, and message. Return value semantics match stdlog_encodef.
+ * stdlog_fixed_init() fails with EINVAL if the fields overflow the
+ * fixed buffer; NULL fields are encoded as the RFC 5424 nil value.
+ */
+struct stdlog_fixed {
+    char buf[STDLOG_MAX_FIXED + 1];
+    int len;
+};
+
+int stdlog_fixed_init (struct stdlog_fixed *fixed,
+                       const char *hostname,
+                       const char *appname,
+                       const char *procid,
+                       const char *sd);
+
+int stdlog_vencode_fast (char *buf, int len, const struct stdlog_fixed *fixed,
+                         int pri, const char *timestamp,
+                         const char *fmt, va_list ap);
+
+int stdlog_encode_fast (char *buf, int len, const struct stdlog_fixed *fixed,
+                        int pri, const char *timestamp,
+                        const char *fmt, ...);
+
 /* If encoded stdlog message in buf, *len contains chars from 'sep'
  * (in the message part), truncate the original message and return
  * buffer containing the rest, with NULL terminator.
@@ -101,6 +101,7 @@ int main (int argc, char *argv[])
     int i;
     int rc;
     double x;
+    time_t t;
     struct tm tm = {0};
     struct timeval tv;
     struct cronodate *d;
@@ -288,6 +289,16 @@ int main (int argc, char *argv[])
     x = cronodate_remaining (d, tv_to_double (&tv));
     ok (almost_is (x, 24*60*60), "cronodate_remaining works: got %.6fs", x);
 
+    // test cronodate_next_time ()
+    ok (cronodate_next_time (NULL, 0, &t) < 0 && errno == EINVAL,
+        "cronodate_next_time returns EINVAL on NULL cronodate");
+    ok (cronodate_next_time (d, 0, NULL) < 0 && errno == EINVAL,
+        "cronodate_next_time returns EINVAL on NULL result");
+    ok (string_to_tv ("2016-06-06 07:00:00", &tv), "string_to_tv");
+    ok (cronodate_next_time (d, tv.tv_sec, &t) == 0
+        && t == tv.tv_sec + 3600,
+        "cronodate_next_time returned next 8am");
+
     cronodate_destroy (d);
 
     done_testing ();
@@ -349,6 +349,17 @@ int main(int argc, char** argv)
     n = dirwalk (tmp, 0, check_dirfd, NULL);
     ok (n > 0, "dirwalk_dirfd works");
 
+    /*  DIRWALK_NO_STAT: traversal still works, and dirwalk_stat()
+     *   performs the elided stat on demand.
+     */
+    n = dirwalk (tmp, DIRWALK_NO_STAT, NULL, NULL);
+    ok (n == 7, "dirwalk with DIRWALK_NO_STAT visits all entries");
+    l = dirwalk_find (tmp, DIRWALK_NO_STAT, "foo", 0, NULL, 0);
+    ok (l && zlist_size (l) == 2, "dirwalk_find with DIRWALK_NO_STAT works");
+    zlist_destroy (&l);
+    n = dirwalk (tmp, DIRWALK_NO_STAT, check_stat, NULL);
+    ok (n > 0, "dirwalk_stat on demand works with DIRWALK_NO_STAT");
+
     /* Cleanup */
     n = dirwalk (tmp, DIRWALK_DEPTH, d_unlinkat, NULL);
     ok (n == 7, "dirwalk recursive unlink works");
@@ -268,6 +268,28 @@ void test_basic (void)
     ok (decode_errors == 0,
         "fluid_decode type=DOTHEX worked 64K times");
 
+    /* Generate 16K id's in a tight loop (>1024 per ms), verifying that
+     * they are strictly increasing and that fluid_save_timestamp() covers
+     * any timestamp blocks claimed ahead of the clock.
+     */
+    fluid_t prev;
+    uint64_t savedts;
+    int order_errors = 0;
+    if (fluid_generate (&gen, &prev) < 0)
+        BAIL_OUT ("fluid_generate unexpectedly failed");
+    for (i = 0; i < 16384; i++) {
+        if (fluid_generate (&gen, &id) < 0)
+            BAIL_OUT ("fluid_generate unexpectedly failed");
+        if (id <= prev)
+            order_errors++;
+        prev = id;
+    }
+    ok (order_errors == 0,
+        "fluid_generate burst of 16K id's is strictly increasing");
+    ok (fluid_save_timestamp (&gen, &savedts) == 0
+        && savedts >= fluid_get_timestamp (prev),
+        "fluid_save_timestamp covers timestamp blocks claimed in burst");
+
     /* Continue for another 4K with NMEMONIC encoding (slower).
      */
     generate_errors = 0;
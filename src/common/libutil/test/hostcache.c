@@ -0,0 +1,94 @@
+/************************************************************\
+ * Copyright 2014 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include "src/common/libutil/hostcache.h"
+#include "src/common/libtap/tap.h"
+
+int main (int argc, char *argv[])
+{
+    struct hostcache *hc;
+    char path[1024];
+    char buf[1024];
+    char small[4];
+    const char *tmpdir = getenv ("TMPDIR");
+    FILE *f;
+
+    plan (NO_PLAN);
+
+    snprintf (path, sizeof (path), "%s/hostcache-test-%d",
+              tmpdir ? tmpdir : "/tmp", getpid ());
+    (void)unlink (path);
+
+    hc = hostcache_create (path);
+    ok (hc != NULL,
+        "hostcache_create with missing file works");
+
+    errno = 0;
+    ok (hostcache_resolve (NULL, "foo", buf, sizeof (buf)) < 0
+        && errno == EINVAL,
+        "hostcache_resolve hc=NULL fails with EINVAL");
+    errno = 0;
+    ok (hostcache_resolve (hc, NULL, buf, sizeof (buf)) < 0
+        && errno == EINVAL,
+        "hostcache_resolve host=NULL fails with EINVAL");
+
+    ok (hostcache_resolve (hc, "127.0.0.1", buf, sizeof (buf)) == 0
+        && !strcmp (buf, "127.0.0.1"),
+        "numeric IPv4 address passes through unchanged");
+    ok (hostcache_resolve (hc, "::1", buf, sizeof (buf)) == 0
+        && !strcmp (buf, "::1"),
+        "numeric IPv6 address passes through unchanged");
+    errno = 0;
+    ok (hostcache_resolve (hc, "127.0.0.1", small, sizeof (small)) < 0
+        && errno == EOVERFLOW,
+        "hostcache_resolve fails with EOVERFLOW on short buffer");
+
+    hostcache_destroy (hc);
+
+    /* Pre-seed the cache file and verify a cached entry is honored
+     * without consulting the resolver.
+     */
+    if (!(f = fopen (path, "w")))
+        BAIL_OUT ("fopen %s failed", path);
+    fprintf (f, "fake-host-that-does-not-exist 10.1.2.3\n");
+    fprintf (f, "malformed-line-with-no-address\n");
+    fprintf (f, "other-fake-host 10.4.5.6\n");
+    fclose (f);
+
+    hc = hostcache_create (path);
+    ok (hc != NULL,
+        "hostcache_create with existing file works");
+    ok (hostcache_resolve (hc, "fake-host-that-does-not-exist",
+                           buf, sizeof (buf)) == 0
+        && !strcmp (buf, "10.1.2.3"),
+        "cached entry is returned without a lookup");
+    ok (hostcache_resolve (hc, "other-fake-host", buf, sizeof (buf)) == 0
+        && !strcmp (buf, "10.4.5.6"),
+        "entry following a malformed cache line is still loaded");
+    hostcache_destroy (hc);
+
+    (void)unlink (path);
+
+    done_testing ();
+    return 0;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
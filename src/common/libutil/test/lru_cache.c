@@ -112,12 +112,71 @@ void test_corruption ()
 }
 
 
+size_t ten_weight (void *data)
+{
+    return 10;
+}
+
+void test_weight ()
+{
+    int a = 1, b = 2, c = 3;
+    unsigned long hits, misses, evictions;
+    lru_cache_t *lru = lru_cache_create (100);
+
+    lru_cache_set_weight_f (lru, ten_weight, 25);
+
+    ok (lru_cache_put (lru, "a", &a) == 0, "lru_cache_put (a)");
+    ok (lru_cache_put (lru, "b", &b) == 0, "lru_cache_put (b)");
+    ok (lru_cache_weight (lru) == 20, "lru_cache_weight == 20");
+
+    /* third entry would exceed maxweight of 25, evicting coldest */
+    ok (lru_cache_put (lru, "c", &c) == 0, "lru_cache_put (c)");
+    ok (lru_cache_check (lru, "a") == false, "a evicted by weight");
+    ok (lru_cache_check (lru, "b") == true, "b still cached");
+    ok (lru_cache_weight (lru) == 20, "lru_cache_weight still 20");
+    ok (lru_cache_selfcheck (lru) == 0, "lru_cache_selfcheck ()");
+
+    ok (lru_cache_get (lru, "b") != NULL, "lru_cache_get (b)");
+    ok (lru_cache_get (lru, "a") == NULL, "lru_cache_get (a) fails");
+    lru_cache_get_stats (lru, &hits, &misses, &evictions);
+    ok (hits == 1 && misses == 1 && evictions == 1,
+        "stats report hits=1 misses=1 evictions=1");
+
+    lru_cache_destroy (lru);
+}
+
+void test_scan_resistance ()
+{
+    int *hot = xzmalloc (sizeof (*hot));
+    int i;
+    lru_cache_t *lru = lru_cache_create (5);
+    lru_cache_set_free_f (lru, free);
+
+    ok (lru_cache_put (lru, "hot", hot) == 0, "lru_cache_put (hot)");
+    ok (lru_cache_get (lru, "hot") != NULL, "get promotes hot entry");
+
+    /* a scan of one-shot keys must not displace the promoted entry */
+    for (i = 0; i < 10; i++) {
+        char *key = xasprintf ("scan.%d", i);
+        int *ip = xzmalloc (sizeof (*ip));
+        if (lru_cache_put (lru, key, ip) < 0)
+            BAIL_OUT ("lru_cache_put failed");
+        free (key);
+    }
+    ok (lru_cache_check (lru, "hot") == true, "hot entry survived scan");
+    ok (lru_cache_selfcheck (lru) == 0, "lru_cache_selfcheck ()");
+
+    lru_cache_destroy (lru);
+}
+
 int main (int argc, char *argv[])
 {
     plan (NO_PLAN);
     test_basic ();
     test_free_fn ();
     test_corruption ();
+    test_weight ();
+    test_scan_resistance ();
     done_testing ();
     return (0);
 }
@@ -25,7 +25,7 @@ int main (int argc, char *argv[])
     char *msg;
     struct pollfd pfd;
 
-    plan (19);
+    plan (24);
 
     ok ((ml = msglist_create (free)) != NULL,
         "msglist_create works");
@@ -79,6 +79,31 @@ int main (int argc, char *argv[])
     ok ((e = msglist_pollevents (ml)) >= 0 && e == (POLLOUT | POLLIN),
         "msglist_pollevents still returns POLLOUT | POLLIN");
 
+    /* A burst of appends raises the eventfd only once, and draining
+     * the list doesn't leave stale edges queued behind it.
+     */
+    free (msglist_pop (ml));
+    (void)msglist_pollevents (ml);
+    ok (msglist_append (ml, xstrdup ("a")) == 0
+        && msglist_append (ml, xstrdup ("b")) == 0
+        && msglist_append (ml, xstrdup ("c")) == 0,
+        "msglist_append burst of 3 works");
+    pfd.events = POLLIN,
+    pfd.revents = 0,
+    ok (poll (&pfd, 1, 0) == 1 && pfd.revents == POLLIN,
+        "pollfd suggests we read pollevents");
+    ok ((e = msglist_pollevents (ml)) >= 0 && e == (POLLOUT | POLLIN),
+        "msglist_pollevents on non-empty msglist returns POLLOUT | POLLIN");
+    free (msglist_pop (ml));
+    free (msglist_pop (ml));
+    free (msglist_pop (ml));
+    ok ((e = msglist_pollevents (ml)) >= 0 && e == POLLOUT,
+        "msglist_pollevents on drained msglist returns POLLOUT");
+    pfd.events = POLLIN,
+    pfd.revents = 0,
+    ok (poll (&pfd, 1, 0) == 0,
+        "pollfd has no stale edges after burst is drained");
+
     msglist_destroy (ml);
 
     done_testing ();
@@ -85,6 +85,46 @@ void test_split (void)
         "stdlog_split message got NULL");
 }
 
+void test_fast (void)
+{
+    char buf[2048];
+    struct stdlog_fixed fixed;
+    struct stdlog_header hdr;
+    int len, n;
+    const char *sd, *msg;
+    int sdlen, msglen;
+
+    ok (stdlog_fixed_init (&fixed, "42", "logger", "1234", NULL) == 0,
+        "stdlog_fixed_init works");
+    len = stdlog_encode_fast (buf, sizeof (buf), &fixed,
+                              STDLOG_PRI (5, 1),
+                              "2016-06-12T22:59:59.816857Z",
+                              "hello %s\r\n", "whorl");
+    ok (len >= 0,
+        "stdlog_encode_fast worked with message");
+    diag ("%.*s", len, buf);
+    n = stdlog_decode (buf, len, &hdr, &sd, &sdlen, &msg, &msglen);
+    ok (n == 0,
+        "stdlog_decode worked on fast-encoded buf");
+    ok (hdr.pri == STDLOG_PRI (5, 1) && hdr.version == 1,
+        "stdlog_decode decoded pri/version");
+    ok (strcmp (hdr.timestamp, "2016-06-12T22:59:59.816857Z") == 0,
+        "stdlog_decode decoded timestamp");
+    ok (strcmp (hdr.hostname, "42") == 0
+        && strcmp (hdr.appname, "logger") == 0
+        && strcmp (hdr.procid, "1234") == 0
+        && strcmp (hdr.msgid, STDLOG_NILVALUE) == 0,
+        "stdlog_decode decoded cached header fields");
+    ok (msglen == strlen ("hello whorl")
+        && strncmp (msg, "hello whorl", msglen) == 0,
+        "message formatted and trailing cr/lf truncated");
+
+    /* NULL fields encode as nil values */
+    ok (stdlog_fixed_init (&fixed, NULL, NULL, NULL, NULL) == 0
+        && strcmp (fixed.buf, " - - - - - ") == 0,
+        "stdlog_fixed_init encodes NULL fields as nil values");
+}
+
 int main(int argc, char** argv)
 {
     char buf[2048];
@@ -150,6 +190,7 @@ int main(int argc, char** argv)
     }
 
     test_split ();
+    test_fast ();
 
     done_testing();
 }
@@ -0,0 +1,93 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#include <string.h>
+#include <errno.h>
+
+#include "src/common/libtap/tap.h"
+#include "src/common/libutil/topictrie.h"
+
+int main (int argc, char **argv)
+{
+    struct topictrie *t;
+
+    plan (NO_PLAN);
+
+    t = topictrie_create ();
+    ok (t != NULL,
+        "topictrie_create works");
+    ok (topictrie_empty (t),
+        "topictrie_empty returns true on new trie");
+    ok (topictrie_match (t, "foo.bar") == false,
+        "topictrie_match returns false on empty trie");
+
+    ok (topictrie_add (NULL, "x") < 0 && errno == EINVAL,
+        "topictrie_add t=NULL fails with EINVAL");
+    ok (topictrie_remove (t, "nope") < 0 && errno == ENOENT,
+        "topictrie_remove on missing topic fails with ENOENT");
+
+    ok (topictrie_add (t, "kvs") == 0,
+        "topictrie_add kvs works");
+    ok (!topictrie_empty (t),
+        "topictrie_empty returns false after add");
+    ok (topictrie_match (t, "kvs"),
+        "kvs matches kvs");
+    ok (topictrie_match (t, "kvs.setroot"),
+        "kvs matches kvs.setroot");
+    ok (topictrie_match (t, "kvstest"),
+        "kvs matches kvstest (prefix rule)");
+    ok (!topictrie_match (t, "kv"),
+        "kvs does not match kv");
+    ok (!topictrie_match (t, "job.state"),
+        "kvs does not match job.state");
+
+    /* duplicate subscriptions are counted */
+    ok (topictrie_add (t, "kvs") == 0,
+        "topictrie_add kvs again works");
+    ok (topictrie_remove (t, "kvs") == 0,
+        "topictrie_remove kvs works");
+    ok (topictrie_match (t, "kvs.setroot"),
+        "kvs still matches after removing one of two refs");
+    ok (topictrie_remove (t, "kvs") == 0,
+        "topictrie_remove kvs again works");
+    ok (!topictrie_match (t, "kvs.setroot"),
+        "kvs no longer matches after removing last ref");
+    ok (topictrie_empty (t),
+        "trie is empty again (nodes pruned)");
+
+    /* empty subscription matches everything */
+    ok (topictrie_add (t, "") == 0,
+        "topictrie_add \"\" works");
+    ok (topictrie_match (t, "anything.at.all"),
+        "\"\" matches anything");
+    ok (topictrie_remove (t, "") == 0,
+        "topictrie_remove \"\" works");
+    ok (!topictrie_match (t, "anything.at.all"),
+        "nothing matches after remove");
+
+    /* overlapping prefixes */
+    ok (topictrie_add (t, "shell.") == 0
+        && topictrie_add (t, "shell.init") == 0,
+        "added shell. and shell.init");
+    ok (topictrie_remove (t, "shell.init") == 0,
+        "removed shell.init");
+    ok (topictrie_match (t, "shell.init"),
+        "shell. still matches shell.init");
+
+    topictrie_destroy (t);
+    topictrie_destroy (NULL);
+
+    done_testing ();
+    return 0;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -0,0 +1,115 @@
+/************************************************************\
+ * Copyright 2014 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "src/common/libtap/tap.h"
+#include "src/common/libutil/tstat.h"
+
+/* Allow percentile estimates one sub-bucket of slack (upper edge of
+ * the next bucket up), i.e. within ~13% of the exact value.
+ */
+static bool near (double x, double exact)
+{
+    return (x >= exact && x <= exact * (1. + 2. / TSTAT_HIST_SUB));
+}
+
+int main (int argc, char *argv[])
+{
+    tstat_t ts;
+    json_t *o;
+    int i;
+    double p50, p95, p99;
+
+    plan (NO_PLAN);
+
+    memset (&ts, 0, sizeof (ts));
+    ok (tstat_count (&ts) == 0 && tstat_mean (&ts) == 0.
+        && tstat_percentile (&ts, 50.) == 0.,
+        "empty tstat returns zeroes");
+
+    tstat_push (&ts, 1.);
+    tstat_push (&ts, 2.);
+    tstat_push (&ts, 3.);
+    ok (tstat_count (&ts) == 3,
+        "tstat_count works");
+    ok (tstat_min (&ts) == 1. && tstat_max (&ts) == 3.,
+        "tstat_min/max work");
+    ok (fabs (tstat_mean (&ts) - 2.) < 1e-9,
+        "tstat_mean works");
+    ok (fabs (tstat_stddev (&ts) - 1.) < 1e-9,
+        "tstat_stddev works");
+    ok (tstat_percentile (&ts, 0.) == 1. && tstat_percentile (&ts, 100.) == 3.,
+        "percentile endpoints are min and max");
+
+    /* uniform 1..1000: p50 ~ 500, p95 ~ 950, p99 ~ 990 */
+    memset (&ts, 0, sizeof (ts));
+    for (i = 1; i <= 1000; i++)
+        tstat_push (&ts, (double) i);
+    p50 = tstat_percentile (&ts, 50.);
+    p95 = tstat_percentile (&ts, 95.);
+    p99 = tstat_percentile (&ts, 99.);
+    ok (near (p50, 500.),
+        "p50 of uniform 1-1000 is %.1f", p50);
+    ok (near (p95, 950.),
+        "p95 of uniform 1-1000 is %.1f", p95);
+    ok (near (p99, 990.),
+        "p99 of uniform 1-1000 is %.1f", p99);
+
+    /* skewed: mostly small with a few large outliers */
+    memset (&ts, 0, sizeof (ts));
+    for (i = 0; i < 990; i++)
+        tstat_push (&ts, 1.);
+    for (i = 0; i < 10; i++)
+        tstat_push (&ts, 1000.);
+    p50 = tstat_percentile (&ts, 50.);
+    p99 = tstat_percentile (&ts, 99.);
+    ok (p50 <= 1. * (1. + 2. / TSTAT_HIST_SUB),
+        "p50 of skewed distribution stays small (%.2f)", p50);
+    ok (tstat_percentile (&ts, 99.9) == 1000.,
+        "p99.9 of skewed distribution captures outliers");
+
+    /* out of range and nonpositive samples are clamped, not lost */
+    memset (&ts, 0, sizeof (ts));
+    tstat_push (&ts, 0.);
+    tstat_push (&ts, -1.);
+    tstat_push (&ts, ldexp (1., 60));
+    ok (tstat_count (&ts) == 3 && tstat_percentile (&ts, 100.) == ldexp (1., 60),
+        "out of range samples are clamped into end buckets");
+
+    memset (&ts, 0, sizeof (ts));
+    tstat_push (&ts, 5.);
+    o = tstat_tojson (&ts);
+    ok (o != NULL,
+        "tstat_tojson works");
+    if (o) {
+        int count;
+        double min, max, p;
+        ok (json_unpack (o, "{s:i s:f s:f s:f}",
+                         "count", &count,
+                         "min", &min,
+                         "max", &max,
+                         "p50", &p) == 0
+            && count == 1 && min == 5. && max == 5. && p == 5.,
+            "tstat_tojson object has expected fields");
+    }
+    json_decref (o);
+
+    done_testing ();
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -0,0 +1,170 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "topictrie.h"
+
+/* Children are kept in a singly linked sibling list.  Topic strings
+ * have small branching factors in practice (topic words share long
+ * common prefixes), so a list walk per character is cheap and avoids
+ * the footprint of per-node child arrays.
+ */
+struct trie_node {
+    char c;
+    int terminal;               /* count of subscriptions ending here */
+    struct trie_node *child;
+    struct trie_node *sibling;
+};
+
+struct topictrie {
+    struct trie_node root;      /* root 'c' unused; terminal counts "" subs */
+};
+
+struct topictrie *topictrie_create (void)
+{
+    struct topictrie *t = calloc (1, sizeof (*t));
+    if (!t) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    return t;
+}
+
+static void trie_node_free (struct trie_node *n)
+{
+    while (n) {
+        struct trie_node *next = n->sibling;
+        trie_node_free (n->child);
+        free (n);
+        n = next;
+    }
+}
+
+void topictrie_destroy (struct topictrie *t)
+{
+    if (t) {
+        int saved_errno = errno;
+        trie_node_free (t->root.child);
+        free (t);
+        errno = saved_errno;
+    }
+}
+
+static struct trie_node *find_child (struct trie_node *n, char c)
+{
+    struct trie_node *child = n->child;
+
+    while (child && child->c != c)
+        child = child->sibling;
+    return child;
+}
+
+int topictrie_add (struct topictrie *t, const char *topic)
+{
+    struct trie_node *n;
+
+    if (!t || !topic) {
+        errno = EINVAL;
+        return -1;
+    }
+    n = &t->root;
+    while (*topic) {
+        struct trie_node *child = find_child (n, *topic);
+        if (!child) {
+            if (!(child = calloc (1, sizeof (*child)))) {
+                errno = ENOMEM;
+                return -1;
+            }
+            child->c = *topic;
+            child->sibling = n->child;
+            n->child = child;
+        }
+        n = child;
+        topic++;
+    }
+    n->terminal++;
+    return 0;
+}
+
+/* Recursively descend to the node for 'topic', decrement its terminal
+ * count, and prune childless non-terminal nodes on the way back up.
+ * Returns 0 on success, -1 if the topic was not stored.
+ */
+static int remove_recurse (struct trie_node *n, const char *topic)
+{
+    struct trie_node *child;
+
+    if (*topic == '\0') {
+        if (n->terminal == 0)
+            return -1;
+        n->terminal--;
+        return 0;
+    }
+    if (!(child = find_child (n, *topic)))
+        return -1;
+    if (remove_recurse (child, topic + 1) < 0)
+        return -1;
+    if (child->terminal == 0 && child->child == NULL) {
+        struct trie_node **pp = &n->child;
+        while (*pp != child)
+            pp = &(*pp)->sibling;
+        *pp = child->sibling;
+        free (child);
+    }
+    return 0;
+}
+
+int topictrie_remove (struct topictrie *t, const char *topic)
+{
+    if (!t || !topic) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (remove_recurse (&t->root, topic) < 0) {
+        errno = ENOENT;
+        return -1;
+    }
+    return 0;
+}
+
+bool topictrie_match (struct topictrie *t, const char *topic)
+{
+    struct trie_node *n;
+
+    if (!t || !topic)
+        return false;
+    n = &t->root;
+    for (;;) {
+        if (n->terminal > 0)
+            return true;
+        if (*topic == '\0')
+            return false;
+        if (!(n = find_child (n, *topic)))
+            return false;
+        topic++;
+    }
+}
+
+bool topictrie_empty (struct topictrie *t)
+{
+    if (!t)
+        return true;
+    return t->root.terminal == 0 && t->root.child == NULL;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -0,0 +1,50 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _UTIL_TOPICTRIE_H
+#define _UTIL_TOPICTRIE_H
+
+#include <stdbool.h>
+
+/* topictrie - counted prefix trie of event topic subscriptions
+ *
+ * Topics are stored with a reference count, so adding the same topic
+ * twice requires two removes.  topictrie_match() returns true if any
+ * stored topic is a prefix of 'topic' (the RFC 3 event matching rule),
+ * in time proportional to the topic length rather than the number of
+ * subscriptions.
+ */
+
+struct topictrie *topictrie_create (void);
+void topictrie_destroy (struct topictrie *t);
+
+/* Add a subscription topic (empty string matches everything).
+ * Returns 0 on success, -1 on failure with errno set.
+ */
+int topictrie_add (struct topictrie *t, const char *topic);
+
+/* Remove one reference on a subscription topic.
+ * Returns 0 on success, -1 with errno = ENOENT if not present.
+ */
+int topictrie_remove (struct topictrie *t, const char *topic);
+
+/* Return true if any stored topic is a prefix of 'topic'.
+ */
+bool topictrie_match (struct topictrie *t, const char *topic);
+
+/* Return true if no topics are stored.
+ */
+bool topictrie_empty (struct topictrie *t);
+
+#endif /* !_UTIL_TOPICTRIE_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -12,10 +12,43 @@
 #include "config.h"
 #endif
 #include <math.h>
+#include <errno.h>
 
 #include "tstat.h"
 #include "log.h"
 
+/* Map sample 'x' to a histogram bucket.  The mantissa from frexp(3)
+ * selects one of TSTAT_HIST_SUB linear sub-buckets within the sample's
+ * power-of-two octave.  Out of range samples land in the end buckets.
+ */
+static int hist_bucket (double x)
+{
+    int exp;
+    double frac;
+    int sub;
+
+    if (x <= 0.)
+        return 0;
+    frac = frexp (x, &exp);             // x = frac * 2^exp, frac in [0.5, 1)
+    if (exp <= TSTAT_HIST_MINEXP)
+        return 0;
+    if (exp > TSTAT_HIST_MAXEXP)
+        return TSTAT_HIST_BUCKETS - 1;
+    sub = (int) ((frac - 0.5) * 2 * TSTAT_HIST_SUB);
+    if (sub >= TSTAT_HIST_SUB)
+        sub = TSTAT_HIST_SUB - 1;
+    return (exp - 1 - TSTAT_HIST_MINEXP) * TSTAT_HIST_SUB + sub;
+}
+
+/* Return the upper edge of histogram bucket 'i'.
+ */
+static double hist_value (int i)
+{
+    int exp = i / TSTAT_HIST_SUB + TSTAT_HIST_MINEXP + 1;
+    int sub = i % TSTAT_HIST_SUB;
+
+    return ldexp (0.5 + (sub + 1.) / (2. * TSTAT_HIST_SUB), exp);
+}
 
 void tstat_push (tstat_t *ts, double x)
 {
@@ -23,6 +56,7 @@ void tstat_push (tstat_t *ts, double x)
         ts->min = x;
     if (ts->n == 0 || x > ts->max)
         ts->max = x;
+    ts->hist[hist_bucket (x)]++;
 /* running variance
  * ref Knuth TAOCP vol 2, 3rd edition, page 232
  * and http://www.johndcook.com/standard_deviation.html
@@ -63,6 +97,50 @@ int tstat_count (tstat_t *ts)
     return ts->n;
 }
 
+double tstat_percentile (tstat_t *ts, double p)
+{
+    double rank;
+    unsigned int cum = 0;
+    int i;
+
+    if (ts->n == 0)
+        return 0;
+    if (p <= 0.)
+        return ts->min;
+    if (p >= 100.)
+        return ts->max;
+    rank = p / 100. * ts->n;
+    for (i = 0; i < TSTAT_HIST_BUCKETS; i++) {
+        cum += ts->hist[i];
+        if (cum >= rank) {
+            double x = hist_value (i);
+            if (x < ts->min)
+                x = ts->min;
+            if (x > ts->max)
+                x = ts->max;
+            return x;
+        }
+    }
+    return ts->max;
+}
+
+json_t *tstat_tojson (tstat_t *ts)
+{
+    json_t *o;
+
+    if (!(o = json_pack ("{s:i s:f s:f s:f s:f s:f s:f s:f}",
+                         "count", tstat_count (ts),
+                         "min", tstat_min (ts),
+                         "mean", tstat_mean (ts),
+                         "stddev", tstat_stddev (ts),
+                         "max", tstat_max (ts),
+                         "p50", tstat_percentile (ts, 50.),
+                         "p95", tstat_percentile (ts, 95.),
+                         "p99", tstat_percentile (ts, 99.))))
+        errno = ENOMEM;
+    return o;
+}
+
 /*
  * vi:tabstop=4 shiftwidth=4 expandtab
  */
@@ -11,10 +11,24 @@
 #ifndef _UTIL_TSTAT_H
 #define _UTIL_TSTAT_H
 
+#include <jansson.h>
+
+/* Fixed-size log-linear histogram: TSTAT_HIST_SUB sub-buckets per
+ * power of two, spanning values from 2^TSTAT_HIST_MINEXP through
+ * 2^TSTAT_HIST_MAXEXP.  Constant memory, no allocation on push.
+ * Values outside the range are clamped into the end buckets.
+ */
+#define TSTAT_HIST_SUB      8
+#define TSTAT_HIST_MINEXP   (-16)
+#define TSTAT_HIST_MAXEXP   48
+#define TSTAT_HIST_BUCKETS  ((TSTAT_HIST_MAXEXP - TSTAT_HIST_MINEXP) \
+                             * TSTAT_HIST_SUB)
+
 typedef struct {
     double min, max;
     int n;
     double M, S, newM, newS;
+    unsigned int hist[TSTAT_HIST_BUCKETS];
 } tstat_t;
 
 void tstat_push (tstat_t *ts, double x);
@@ -25,6 +39,19 @@ double tstat_variance (tstat_t *ts);
 double tstat_stddev (tstat_t *ts);
 int tstat_count (tstat_t *ts);
 
+/* Estimate the p'th percentile (0 <= p <= 100) from the histogram.
+ * The estimate is the upper edge of the bucket containing the p'th
+ * sample, clamped to [min, max], so relative error is bounded by the
+ * sub-bucket width (about 6% with TSTAT_HIST_SUB = 8).
+ * Returns 0 if no samples have been pushed.
+ */
+double tstat_percentile (tstat_t *ts, double p);
+
+/* Pack count/min/mean/stddev/max plus p50/p95/p99 estimates into a
+ * JSON object for stats RPCs.  Returns NULL on failure with errno set.
+ */
+json_t *tstat_tojson (tstat_t *ts);
+
 #endif /* !_UTIL_TSTAT_H */
 /*
  * vi:tabstop=4 shiftwidth=4 expandtab
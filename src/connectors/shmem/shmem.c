@@ -30,8 +30,49 @@ typedef struct {
     flux_t *h;
     char *argz;
     size_t argz_len;
+    int pointer;        /* pass messages by pointer, not encoded frames */
 } shmem_ctx_t;
 
+/* Pointer transfer mode ("&ptr" path option):  both ends of the inproc
+ * pair live in the broker process, so a message can cross the socket as
+ * a single pointer-sized frame with ownership transferred to the
+ * receiver, skipping per-frame encode/decode while retaining zmq's
+ * poll/wakeup semantics.  Both ends must agree on the mode.
+ */
+
+static int msg_sendzsock_ptr (void *sock, flux_msg_t *msg)
+{
+    zframe_t *zf;
+
+    if (!(zf = zframe_new (&msg, sizeof (msg)))) {
+        errno = ENOMEM;
+        return -1;
+    }
+    if (zframe_send (&zf, sock, 0) < 0) {
+        zframe_destroy (&zf);
+        return -1;
+    }
+    return 0;
+}
+
+static flux_msg_t *msg_recvzsock_ptr (void *sock, bool nonblock)
+{
+    zmq_msg_t zm;
+    flux_msg_t *msg;
+
+    if (zmq_msg_init (&zm) < 0)
+        return NULL;
+    if (zmq_msg_recv (&zm, zsock_resolve (sock), nonblock ? ZMQ_DONTWAIT : 0)
+        < 0) {
+        (void)zmq_msg_close (&zm);
+        return NULL;
+    }
+    assert (zmq_msg_size (&zm) == sizeof (msg));
+    memcpy (&msg, zmq_msg_data (&zm), sizeof (msg));
+    (void)zmq_msg_close (&zm);
+    return msg;
+}
+
 static const struct flux_handle_ops handle_ops;
 
 static int op_pollevents (void *impl)
@@ -65,6 +106,18 @@ static int op_send (void *impl, const flux_msg_t *msg, int flags)
     shmem_ctx_t *ctx = impl;
     assert (ctx->magic == MODHANDLE_MAGIC);
 
+    if (ctx->pointer) {
+        flux_msg_t *cpy;
+        if (!(cpy = flux_msg_copy (msg, true)))
+            return -1;
+        if (msg_sendzsock_ptr (ctx->sock, cpy) < 0) {
+            int saved_errno = errno;
+            flux_msg_destroy (cpy);
+            errno = saved_errno;
+            return -1;
+        }
+        return 0;
+    }
     return flux_msg_sendzsock (ctx->sock, msg);
 }
 
@@ -80,6 +133,11 @@ static flux_msg_t *op_recv (void *impl, int flags)
     };
     flux_msg_t *msg = NULL;
 
+    /* Pointer mode receives non-blocking directly (EAGAIN maps to
+     * EWOULDBLOCK), skipping a zmq_poll round trip per message.
+     */
+    if (ctx->pointer)
+        return msg_recvzsock_ptr (ctx->sock, (flags & FLUX_O_NONBLOCK));
     if ((flags & FLUX_O_NONBLOCK)) {
         int n;
         if ((n = zmq_poll (&zp, 1, 0L)) <= 0) {
@@ -179,6 +237,8 @@ flux_t *connector_init (const char *path, int flags)
             bind_socket = 1;
         else if (!strcmp (item, "connect"))
             bind_socket = 0;
+        else if (!strcmp (item, "ptr"))
+            ctx->pointer = 1;
         else {
             errno = EINVAL;
             goto error;
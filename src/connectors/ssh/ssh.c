@@ -136,8 +136,33 @@ static char *which (const char *prog, char *buf, size_t size)
     return result;
 }
 
+/* Add OpenSSH connection-sharing options so all handles to the same
+ * [user@]host[:port] ride one ssh transport: the first flux_open()
+ * establishes a control master that later ones reuse, skipping the TCP
+ * and auth handshake.  'persist' is passed to ControlPersist, keeping
+ * the idle master alive that long (and letting a fresh handle respawn
+ * it after a network outage).  ServerAliveInterval makes a dead tunnel
+ * fail fast rather than hang in flux_open().
+ */
+static int add_mux_options (char **argz, size_t *argz_len, const char *persist)
+{
+    char buf[PATH_MAX + 1];
+
+    if (argz_add (argz, argz_len, "-oControlMaster=auto") != 0)
+        return -1;
+    if (argz_add (argz, argz_len, "-oControlPath=%d/.ssh/flux-mux-%C") != 0)
+        return -1;
+    (void)snprintf (buf, sizeof (buf), "-oControlPersist=%s", persist);
+    if (argz_add (argz, argz_len, buf) != 0)
+        return -1;
+    if (argz_add (argz, argz_len, "-oServerAliveInterval=30") != 0)
+        return -1;
+    return 0;
+}
+
 /* uri_path is interpreted as:
  *   [user@]hostname[:port]/unix-path
+ * If 'mux_persist' is non-NULL, enable ssh connection sharing (see above).
  * Sets *argvp, *argbuf (caller must free).
  * The last argv[] element is a NULL (required by popen2).
  * Returns 0 on success, -1 on failure with errno set.
@@ -145,6 +170,7 @@ static char *which (const char *prog, char *buf, size_t size)
 int build_ssh_command (const char *uri_path,
                        const char *ssh_cmd,
                        const char *flux_cmd,
+                       const char *mux_persist,
                        char ***argvp,
                        char **argbuf)
 {
@@ -170,6 +196,12 @@ int build_ssh_command (const char *uri_path,
     if (argz_add (&argz, &argz_len, ssh_cmd) != 0)
         goto nomem;
 
+    /* [connection sharing options] */
+    if (mux_persist) {
+        if (add_mux_options (&argz, &argz_len, mux_persist) != 0)
+            goto nomem;
+    }
+
     /* [-p port] */
     if (yuri.port != 0) {
         (void)snprintf (buf, sizeof (buf), "%d", yuri.port);
@@ -226,6 +258,7 @@ flux_t *connector_init (const char *path, int flags)
     char buf[PATH_MAX + 1];
     const char *ssh_cmd;
     const char *flux_cmd;
+    const char *mux_persist;
     char *argbuf = NULL;
     char **argv = NULL;
 
@@ -247,10 +280,23 @@ flux_t *connector_init (const char *path, int flags)
     if (!flux_cmd)
         flux_cmd = "flux"; // maybe this will work for installed version
 
+    /* FLUX_SSH_MULTIPLEX enables ssh connection sharing: set it to a
+     * ControlPersist value, e.g. "30s" or "yes" (forever).  Off by
+     * default since non-OpenSSH FLUX_SSH commands won't grok the options.
+     */
+    mux_persist = getenv ("FLUX_SSH_MULTIPLEX");
+    if (mux_persist && strlen (mux_persist) == 0)
+        mux_persist = NULL;
+
     /* Construct argv for ssh command from uri "path" (non-scheme part)
      * and flux and ssh command paths.
      */
-    if (build_ssh_command (path, ssh_cmd, flux_cmd, &argv, &argbuf) < 0)
+    if (build_ssh_command (path,
+                           ssh_cmd,
+                           flux_cmd,
+                           mux_persist,
+                           &argv,
+                           &argbuf) < 0)
         goto error;
 
     /* Start the ssh command
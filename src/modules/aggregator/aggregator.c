@@ -19,12 +19,14 @@
 #include <jansson.h>
 
 #include "src/common/libidset/idset.h"
+#include "src/common/libutil/monotime.h"
 
 struct aggregator {
     flux_t *h;
     uint32_t rank;
     double default_timeout;
     double timer_scale;
+    double rtt_avg;          /* EWMA of upstream push ack RTT in seconds  */
     zhash_t *aggregates;
 };
 
@@ -266,12 +268,59 @@ error:
     return (NULL);
 }
 
+/*  Fold one measured upstream ack RTT into the aggregator EWMA used
+ *   to adapt flush timeouts.
+ */
+static void aggregator_rtt_update (struct aggregator *ctx, double rtt)
+{
+    if (ctx->rtt_avg == 0.)
+        ctx->rtt_avg = rtt;
+    else
+        ctx->rtt_avg += (rtt - ctx->rtt_avg) / 8.;
+}
+
+/*  State for an in-flight upstream push. The aggregate itself is
+ *   destroyed as soon as it is flushed, so the continuation can't
+ *   reference it.
+ */
+struct forward_req {
+    struct aggregator *ctx;
+    char *key;
+    struct timespec t0;
+};
+
+static void forward_req_destroy (struct forward_req *fwd)
+{
+    if (fwd) {
+        int saved_errno = errno;
+        free (fwd->key);
+        free (fwd);
+        errno = saved_errno;
+    }
+}
+
+static struct forward_req *
+    forward_req_create (struct aggregator *ctx, const char *key)
+{
+    struct forward_req *fwd = calloc (1, sizeof (*fwd));
+    if (fwd == NULL || !(fwd->key = strdup (key))) {
+        forward_req_destroy (fwd);
+        return (NULL);
+    }
+    fwd->ctx = ctx;
+    monotime (&fwd->t0);
+    return (fwd);
+}
+
 static void forward_continuation (flux_future_t *f, void *arg)
 {
     flux_t *h = flux_future_get_flux (f);
-    struct aggregate *ag = arg;
+    struct forward_req *fwd = arg;
     if (flux_rpc_get (f, NULL) < 0)
-        flux_log_error (h, "aggregator.push: key=%s", ag->key);
+        flux_log_error (h, "aggregator.push: key=%s", fwd->key);
+    else
+        aggregator_rtt_update (fwd->ctx, monotime_since (fwd->t0) / 1000.);
+    forward_req_destroy (fwd);
     flux_future_destroy (f);
 }
 
@@ -282,12 +331,18 @@ static int aggregate_forward (flux_t *h, struct aggregate *ag)
 {
     int rc = 0;
     flux_future_t *f;
+    struct forward_req *fwd;
     json_t *o = aggregate_entries_tojson (ag);
 
     if (o == NULL) {
         flux_log (h, LOG_ERR, "forward: aggregate_entries_tojson failed");
         return (-1);
     }
+    if (!(fwd = forward_req_create (ag->ctx, ag->key))) {
+        flux_log_error (h, "forward: forward_req_create");
+        json_decref (o);
+        return (-1);
+    }
     flux_log (h, LOG_DEBUG, "forward: %s: count=%d total=%d",
                  ag->key, ag->count, ag->total);
     if (!(f = flux_rpc_pack (h, "aggregator.push", FLUX_NODEID_UPSTREAM, 0,
@@ -297,8 +352,9 @@ static int aggregate_forward (flux_t *h, struct aggregate *ag)
                                 "total", ag->total,
                                 "timeout", ag->timeout,
                                 "entries", o)) ||
-        (flux_future_then (f, -1., forward_continuation, (void *) ag) < 0)) {
+        (flux_future_then (f, -1., forward_continuation, (void *) fwd) < 0)) {
         flux_log_error (h, "flux_rpc: aggregator.push");
+        forward_req_destroy (fwd);
         flux_future_destroy (f);
         rc = -1;
     }
@@ -582,6 +638,24 @@ error:
     return (NULL);
 }
 
+/*  Compute the effective flush timeout for a new aggregate. The
+ *   requested per-hop timeout is scaled by remaining tree depth as
+ *   before, but when measured upstream ack RTT exceeds the requested
+ *   timeout the wait is stretched to match (capped at 10x requested),
+ *   so congested instances batch more and idle ones flush promptly
+ *   without per-scale manual tuning.
+ */
+static double aggregate_timeout (struct aggregator *ctx, double timeout)
+{
+    double t = timeout;
+    if (ctx->rtt_avg > t) {
+        t = ctx->rtt_avg;
+        if (timeout > 0. && t > 10. * timeout)
+            t = 10. * timeout;
+    }
+    return (t * ctx->timer_scale);
+}
+
 /*
  *  Add a new aggregate to aggregator `ctx`. Insert into entries
  *   hash, start the aggregate timeout, scaled by the current
@@ -603,7 +677,7 @@ aggregator_new_aggregate (struct aggregator *ctx, const char *key,
     zhash_freefn (ctx->aggregates, key, (zhash_free_fn *) aggregate_destroy);
     ag->timeout = timeout;
     ag->total = total;
-    aggregate_timer_start (ag, timeout * ctx->timer_scale);
+    aggregate_timer_start (ag, aggregate_timeout (ctx, timeout));
     return (ag);
 }
 
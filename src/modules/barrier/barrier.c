@@ -49,6 +49,8 @@
 #include "src/common/libutil/errno_safe.h"
 #include "src/common/libutil/log.h"
 #include "src/common/libutil/iterators.h"
+#include "src/common/libutil/monotime.h"
+#include "src/common/libutil/tstat.h"
 
 const double reduction_timeout = 0.001; // sec
 
@@ -56,6 +58,9 @@ struct barrier_ctx {
     zhash_t *barriers;
     flux_t *h;
     uint32_t rank;
+    tstat_t completion_time;    /* for barrier.stats.get */
+    int ncomplete;
+    int naborted;
 };
 
 struct barrier {
@@ -68,6 +73,7 @@ struct barrier {
     flux_watcher_t *timer;
     bool timer_armed;
     uint32_t owner;
+    struct timespec t_create;
 };
 
 static int exit_event_send (flux_t *h,
@@ -135,6 +141,7 @@ static struct barrier *barrier_create (struct barrier_ctx *ctx,
     if (!(b->name = strdup (name)))
         goto error;
     b->nprocs = nprocs;
+    monotime (&b->t_create);
     if (!(b->clients = zhash_new ())) {
         errno = ENOMEM;
         goto error;
@@ -428,6 +435,12 @@ static void exit_event_cb (flux_t *h, flux_msg_handler_t *mh,
     }
     if ((b = barrier_lookup (ctx, name, owner))) {
         b->errnum = errnum;
+        if (b->errnum == 0) {
+            tstat_push (&ctx->completion_time, monotime_since (b->t_create));
+            ctx->ncomplete++;
+        }
+        else
+            ctx->naborted++;
         FOREACH_ZHASH (b->clients, key, req) {
             int rc;
             if (b->errnum == 0)
@@ -454,6 +467,32 @@ static void reduction_timeout_cb (flux_reactor_t *r, flux_watcher_t *w,
     }
 }
 
+/* Answer barrier.stats.get with active barrier count and local
+ * completion time statistics (ms, from first local entry to exit).
+ */
+static void stats_get_cb (flux_t *h, flux_msg_handler_t *mh,
+                          const flux_msg_t *msg, void *arg)
+{
+    struct barrier_ctx *ctx = arg;
+    json_t *tstats;
+
+    if (!(tstats = tstat_tojson (&ctx->completion_time)))
+        goto error;
+    if (flux_respond_pack (h, msg,
+                           "{s:i s:i s:i s:o}",
+                           "#active", (int)zhash_size (ctx->barriers),
+                           "#complete", ctx->ncomplete,
+                           "#aborted", ctx->naborted,
+                           "completion time (ms)", tstats) < 0) {
+        json_decref (tstats);
+        flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+    }
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+}
+
 static struct flux_msg_handler_spec htab[] = {
     {   FLUX_MSGTYPE_REQUEST,
         "barrier.enter",
@@ -475,6 +514,11 @@ static struct flux_msg_handler_spec htab[] = {
         exit_event_cb,
         0
     },
+    {   FLUX_MSGTYPE_REQUEST,
+        "barrier.stats.get",
+        stats_get_cb,
+        0
+    },
     FLUX_MSGHANDLER_TABLE_END,
 };
 
@@ -27,6 +27,7 @@
 #include <ctype.h>
 #include <czmq.h>
 #include <inttypes.h>
+#include <jansson.h>
 #include <flux/core.h>
 
 #include "src/common/libutil/cleanup.h"
@@ -38,6 +39,13 @@ enum {
     DEBUG_OWNERDROP_ONESHOT = 4,/* drop OWNER role to USER on next connection */
 };
 
+/* Cap on messages queued for one client that has stopped reading its
+ * socket, so a stuck client cannot balloon broker memory.  Chosen to be
+ * well clear of what a healthy client ever accumulates.  Override with
+ * module option send-queue-limit=N (0 = unlimited).
+ */
+static const int default_send_queue_limit = 16384;
+
 struct connector_local {
     struct usock_server *server;
     struct router *router;
@@ -45,6 +53,7 @@ struct connector_local {
     uid_t instance_owner;
     int allow_guest_user;
     int allow_root_owner;
+    int send_queue_limit;
     flux_msg_handler_t **handlers;
 };
 
@@ -133,6 +142,9 @@ static void uconn_recv (struct usock_conn *uconn, flux_msg_t *msg, void *arg)
 
 /* Router sends message to a usock client.
  * If event is private, ensure user's credentials allow delivery.
+ * If the client's send queue is at its limit, events are silently
+ * dropped (the refusal is counted by usock), while requests and
+ * responses propagate ENOBUFS so the failure is logged.
  */
 static int uconn_send (const flux_msg_t *msg, void *arg)
 {
@@ -151,7 +163,12 @@ static int uconn_send (const flux_msg_t *msg, void *arg)
         default:
             break;
     }
-    return usock_conn_send (uconn, msg);
+    if (usock_conn_send (uconn, msg) < 0) {
+        if (type == FLUX_MSGTYPE_EVENT && errno == ENOBUFS)
+            return 0;
+        return -1;
+    }
+    return 0;
 }
 
 /* Accept a connection from new client.
@@ -183,6 +200,7 @@ static void acceptor_cb (struct usock_conn *uconn, void *arg)
     }
     usock_conn_set_error_cb (uconn, uconn_error, ctx);
     usock_conn_set_recv_cb (uconn, uconn_recv, ctx);
+    usock_conn_set_queue_limit (uconn, ctx->send_queue_limit);
     usock_conn_accept (uconn, &cred);
     return;
 error:
@@ -266,8 +284,78 @@ error:
         flux_log_error (h, "error responding to config-reload request");
 }
 
+/* usock_server_conn_f footprint - add one connection's send queue
+ * statistics to the stats object.
+ */
+static int conn_stats (struct usock_conn *uconn, void *arg)
+{
+    json_t *conns = arg;
+    json_t *entry;
+    int depth = 0;
+    int maxdepth = 0;
+    int full = 0;
+
+    (void)usock_conn_get_queue_stats (uconn, &depth, &maxdepth, &full);
+    if (!(entry = json_pack ("{s:i s:i s:i}",
+                             "send-queue-depth", depth,
+                             "send-queue-maxdepth", maxdepth,
+                             "send-queue-full", full)))
+        goto nomem;
+    if (json_object_set_new (conns, usock_conn_get_uuid (uconn), entry) < 0) {
+        json_decref (entry);
+        goto nomem;
+    }
+    return 0;
+nomem:
+    errno = ENOMEM;
+    return -1;
+}
+
+static void stats_get_cb (flux_t *h,
+                          flux_msg_handler_t *mh,
+                          const flux_msg_t *msg,
+                          void *arg)
+{
+    struct connector_local *ctx = arg;
+    json_t *conns;
+    int nevents = 0;
+    int nsent = 0;
+    double total_ms = 0.;
+    double max_ms = 0.;
+
+    if (!(conns = json_object ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (usock_server_foreach (ctx->server, conn_stats, conns) < 0)
+        goto error;
+    (void)router_get_fanout_stats (ctx->router,
+                                   &nevents,
+                                   &nsent,
+                                   &total_ms,
+                                   &max_ms);
+    if (flux_respond_pack (h,
+                           msg,
+                           "{s:i s:O s:{s:i s:i s:f s:f}}",
+                           "send-queue-limit", ctx->send_queue_limit,
+                           "connections", conns,
+                           "event-fanout",
+                             "events", nevents,
+                             "deliveries", nsent,
+                             "total-ms", total_ms,
+                             "max-ms", max_ms) < 0)
+        flux_log_error (h, "error responding to stats-get request");
+    json_decref (conns);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "error responding to stats-get request");
+    json_decref (conns);
+}
+
 static const struct flux_msg_handler_spec htab[] = {
     { FLUX_MSGTYPE_REQUEST,  "connector-local.config-reload", reload_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST,  "connector-local.stats.get", stats_get_cb, 0 },
     FLUX_MSGHANDLER_TABLE_END,
 };
 
@@ -283,6 +371,25 @@ int mod_main (flux_t *h, int argc, char **argv)
     memset (&ctx, 0, sizeof (ctx));
     ctx.h = h;
     ctx.instance_owner = getuid ();
+    ctx.send_queue_limit = default_send_queue_limit;
+
+    /* Parse module options
+     */
+    for (int i = 0; i < argc; i++) {
+        if (!strncmp (argv[i], "send-queue-limit=", 17)) {
+            char *endptr;
+            errno = 0;
+            ctx.send_queue_limit = strtol (argv[i] + 17, &endptr, 10);
+            if (errno || *endptr != '\0' || ctx.send_queue_limit < 0) {
+                flux_log (h, LOG_ERR, "malformed option: %s", argv[i]);
+                goto done;
+            }
+        }
+        else {
+            flux_log (h, LOG_ERR, "unknown option: %s", argv[i]);
+            goto done;
+        }
+    }
 
     /* Parse configuration
      */
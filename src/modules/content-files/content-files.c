@@ -11,8 +11,10 @@
 /* content-files.c - content addressable storage with files back end
  *
  * This is mainly for demo/experimentation purposes.
- * The "store" is a flat directory with blobrefs as filenames.
- * As such, it is hungry for inodes and may run the file system out of them
+ * The "store" is a directory tree with blobrefs as filenames, fanned
+ * out into two levels of subdirectories taken from the leading digest
+ * characters so directory sizes stay bounded as the store grows.
+ * It is still hungry for inodes and may run the file system out of them
  * if used in anger!
  *
  * There are four main operations (RPC handlers):
@@ -52,21 +54,64 @@
 #include "config.h"
 #endif
 #include <flux/core.h>
+#include <dirent.h>
+#include <jansson.h>
 
 #include "src/common/libutil/blobref.h"
 #include "src/common/libutil/log.h"
+#include "src/common/libutil/errno_safe.h"
 
 #include "src/common/libcontent/content-util.h"
+#include "src/common/libcontent/content-archive.h"
 
 #include "filedb.h"
 
 struct content_files {
     flux_msg_handler_t **handlers;
     char *dbpath;
+    int lease_epoch;            /* bumped per direct-read lease grant */
+    bool lease_active;
     flux_t *h;
     const char *hashfun;
 };
 
+/* Build the fanout directory path for 'blobref' in 'buf', e.g.
+ * <dbpath>/ab/cd for sha1-abcd...  If 'create' is true, make the
+ * directories as needed.  Checkpoint keys are not blobrefs and stay
+ * at the top level.
+ * Returns 0 on success, -1 on error with errno set.
+ */
+static int fanout_dir (char *buf,
+                       int size,
+                       const char *dbpath,
+                       const char *blobref,
+                       bool create)
+{
+    const char *digest = strchr (blobref, '-');
+    int n, m;
+
+    if (!digest || strlen (digest + 1) < 4) {
+        errno = EINVAL;
+        return -1;
+    }
+    digest++;
+    n = snprintf (buf, size, "%s/%.2s", dbpath, digest);
+    if (n < 0 || n >= size) {
+        errno = EOVERFLOW;
+        return -1;
+    }
+    if (create && mkdir (buf, 0700) < 0 && errno != EEXIST)
+        return -1;
+    m = snprintf (buf + n, size - n, "/%.2s", digest + 2);
+    if (m < 0 || m >= size - n) {
+        errno = EOVERFLOW;
+        return -1;
+    }
+    if (create && mkdir (buf, 0700) < 0 && errno != EEXIST)
+        return -1;
+    return 0;
+}
+
 /* Handle a content-backing.load request from the rank 0 broker's
  * content-cache service.  The raw request payload is a blobref string,
  * including NULL terminator.  The raw response payload is the blob content.
@@ -95,6 +140,22 @@ static void load_cb (flux_t *h,
         errstr = "invalid blobref";
         goto error;
     }
+    /* Serve the load from an mmapped blob file where possible, so
+     * repeated loads of hot blobs (e.g. eventlog replays on restart)
+     * come straight out of the page cache instead of being copied to
+     * a fresh heap buffer each time.
+     */
+    char dir[1024];
+    if (fanout_dir (dir, sizeof (dir), ctx->dbpath, blobref, false) == 0
+        && filedb_map (dir, blobref, &data, &size, &errstr) == 0) {
+        if (flux_respond_raw (h, msg, data, size) < 0)
+            flux_log_error (h, "error responding to load request");
+        filedb_unmap (data, size);
+        return;
+    }
+    /* fall back to flat layout for blobs stored before fanout */
+    errstr = NULL;
+    data = NULL;
     if (filedb_get (ctx->dbpath, blobref, &data, &size, &errstr) < 0)
         goto error;
     if (flux_respond_raw (h, msg, data, size) < 0)
@@ -131,7 +192,10 @@ void store_cb (flux_t *h,
                       blobref,
                       sizeof (blobref)) < 0)
         goto error;
-    if (filedb_put (ctx->dbpath, blobref, data, size, &errstr) < 0)
+    char dir[1024];
+    if (fanout_dir (dir, sizeof (dir), ctx->dbpath, blobref, true) < 0)
+        goto error;
+    if (filedb_put (dir, blobref, data, size, &errstr) < 0)
         goto error;
     if (flux_respond_raw (h, msg, blobref, strlen (blobref) + 1) < 0)
         flux_log_error (h, "error responding to store request");
@@ -208,6 +272,250 @@ error:
         flux_log_error (h, "error responding to kvs-checkpoint.put request");
 }
 
+/* Append every blobref-named file in 'dir' to archive 'w'.
+ * Non-blobref names (e.g. checkpoint keys at the top level) are skipped.
+ * Returns 0 on success, -1 on error with errno set.
+ */
+static int export_dir (struct content_archive_writer *w,
+                       const char *dir,
+                       int *countp,
+                       uint64_t *bytesp)
+{
+    DIR *d;
+    struct dirent *entry;
+    int rc = -1;
+
+    if (!(d = opendir (dir)))
+        return -1;
+    while ((entry = readdir (d))) {
+        void *data = NULL;
+        size_t size;
+
+        if (blobref_validate (entry->d_name) < 0)
+            continue;
+        if (filedb_get (dir, entry->d_name, &data, &size, NULL) < 0)
+            goto done;
+        if (content_archive_append (w, entry->d_name, data, size) < 0) {
+            ERRNO_SAFE_WRAP (free, data);
+            goto done;
+        }
+        free (data);
+        (*countp)++;
+        *bytesp += size;
+    }
+    rc = 0;
+done:
+    ERRNO_SAFE_WRAP (closedir, d);
+    return rc;
+}
+
+/* Handle a content-backing.export request from flux-content(1).
+ * Dump every blob (flat and fanout layout) to an archive at 'path',
+ * written sequentially through a large buffer so the copy runs at
+ * disk bandwidth.  Checkpoints are not included.
+ */
+static void export_cb (flux_t *h,
+                       flux_msg_handler_t *mh,
+                       const flux_msg_t *msg,
+                       void *arg)
+{
+    struct content_files *ctx = arg;
+    struct content_archive_writer *w = NULL;
+    DIR *d = NULL;
+    struct dirent *entry;
+    const char *path;
+    int count = 0;
+    uint64_t bytes = 0;
+
+    if (flux_request_unpack (msg, NULL, "{s:s}", "path", &path) < 0)
+        goto error;
+    if (!(w = content_archive_writer_create (path, ctx->hashfun)))
+        goto error;
+    /* flat blobs stored before fanout */
+    if (export_dir (w, ctx->dbpath, &count, &bytes) < 0)
+        goto error;
+    if (!(d = opendir (ctx->dbpath)))
+        goto error;
+    while ((entry = readdir (d))) {
+        DIR *sub;
+        struct dirent *subentry;
+        char dir[1024];
+        int n;
+
+        if (strlen (entry->d_name) != 2 || !strcmp (entry->d_name, ".."))
+            continue;
+        n = snprintf (dir, sizeof (dir), "%s/%s", ctx->dbpath, entry->d_name);
+        if (n < 0 || n >= sizeof (dir))
+            continue;
+        if (!(sub = opendir (dir)))
+            continue;
+        while ((subentry = readdir (sub))) {
+            char subdir[1024];
+
+            if (strlen (subentry->d_name) != 2)
+                continue;
+            n = snprintf (subdir,
+                          sizeof (subdir),
+                          "%s/%s",
+                          dir,
+                          subentry->d_name);
+            if (n < 0 || n >= sizeof (subdir))
+                continue;
+            if (export_dir (w, subdir, &count, &bytes) < 0) {
+                ERRNO_SAFE_WRAP (closedir, sub);
+                goto error;
+            }
+        }
+        closedir (sub);
+    }
+    closedir (d);
+    d = NULL;
+    if (content_archive_writer_close (w) < 0) {
+        w = NULL;
+        goto error;
+    }
+    if (flux_respond_pack (h,
+                           msg,
+                           "{s:i s:I}",
+                           "count", count,
+                           "bytes", (json_int_t)bytes) < 0)
+        flux_log_error (h, "error responding to export request");
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "error responding to export request");
+    if (d)
+        ERRNO_SAFE_WRAP (closedir, d);
+    content_archive_writer_destroy (w);
+}
+
+/* Handle a content-backing.import request from flux-content(1).
+ * Blobrefs are recomputed from the data rather than trusted from the
+ * archive index, so an archive written under a different hash function
+ * imports cleanly (though KVS references from the source instance will
+ * not resolve in that case).
+ */
+static void import_cb (flux_t *h,
+                       flux_msg_handler_t *mh,
+                       const flux_msg_t *msg,
+                       void *arg)
+{
+    struct content_files *ctx = arg;
+    struct content_archive_reader *r = NULL;
+    const char *path;
+    const char *errstr = NULL;
+    char hash_name[16];
+    const void *data;
+    uint32_t len;
+    int rc;
+    int count = 0;
+    uint64_t bytes = 0;
+
+    if (flux_request_unpack (msg, NULL, "{s:s}", "path", &path) < 0)
+        goto error;
+    if (!(r = content_archive_reader_create (path,
+                                             hash_name,
+                                             sizeof (hash_name))))
+        goto error;
+    while ((rc = content_archive_next (r, &data, &len)) == 1) {
+        char blobref[BLOBREF_MAX_STRING_SIZE];
+        char dir[1024];
+
+        if (blobref_hash (ctx->hashfun,
+                          (uint8_t *)data,
+                          len,
+                          blobref,
+                          sizeof (blobref)) < 0)
+            goto error;
+        if (fanout_dir (dir, sizeof (dir), ctx->dbpath, blobref, true) < 0)
+            goto error;
+        if (filedb_put (dir, blobref, data, len, &errstr) < 0)
+            goto error;
+        count++;
+        bytes += len;
+    }
+    if (rc < 0) {
+        errstr = "archive is corrupt or truncated";
+        goto error;
+    }
+    content_archive_reader_destroy (r);
+    if (flux_respond_pack (h,
+                           msg,
+                           "{s:i s:I}",
+                           "count", count,
+                           "bytes", (json_int_t)bytes) < 0)
+        flux_log_error (h, "error responding to import request");
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, errstr) < 0)
+        flux_log_error (h, "error responding to import request");
+    content_archive_reader_destroy (r);
+}
+
+/* Direct read-only access for trusted local tools (debug/backup),
+ * mirroring the lease protocol of content-sqlite.  Nothing needs to
+ * be frozen here: blob files are content-addressed and never modified
+ * after creation, so a lease holder may walk the store directory and
+ * read blobs at disk speed.  A torn read of an in-flight store fails
+ * verification against its blobref filename and can simply be retried
+ * or skipped.
+ */
+
+static void lease_acquire_cb (flux_t *h,
+                              flux_msg_handler_t *mh,
+                              const flux_msg_t *msg,
+                              void *arg)
+{
+    struct content_files *ctx = arg;
+    const char *errstr = NULL;
+
+    if (flux_request_decode (msg, NULL, NULL) < 0)
+        goto error;
+    if (ctx->lease_active) {
+        errno = EBUSY;
+        errstr = "a direct-read lease is already held";
+        goto error;
+    }
+    ctx->lease_active = true;
+    ctx->lease_epoch++;
+    if (flux_respond_pack (h,
+                           msg,
+                           "{s:s s:i s:s}",
+                           "path", ctx->dbpath,
+                           "epoch", ctx->lease_epoch,
+                           "hash", ctx->hashfun) < 0)
+        flux_log_error (h, "error responding to lease-acquire request");
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, errstr) < 0)
+        flux_log_error (h, "error responding to lease-acquire request");
+}
+
+static void lease_release_cb (flux_t *h,
+                              flux_msg_handler_t *mh,
+                              const flux_msg_t *msg,
+                              void *arg)
+{
+    struct content_files *ctx = arg;
+    const char *errstr = NULL;
+    int epoch;
+
+    if (flux_request_unpack (msg, NULL, "{s:i}", "epoch", &epoch) < 0)
+        goto error;
+    if (!ctx->lease_active || epoch != ctx->lease_epoch) {
+        errno = ENOENT;
+        errstr = "no matching lease is held";
+        goto error;
+    }
+    ctx->lease_active = false;
+    if (flux_respond (h, msg, NULL) < 0)
+        flux_log_error (h, "error responding to lease-release request");
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, errstr) < 0)
+        flux_log_error (h, "error responding to lease-release request");
+}
+
 /* Destroy module context.
  */
 static void content_files_destroy (struct content_files *ctx)
@@ -227,6 +535,12 @@ static void content_files_destroy (struct content_files *ctx)
 static const struct flux_msg_handler_spec htab[] = {
     { FLUX_MSGTYPE_REQUEST, "content-backing.load",    load_cb, 0 },
     { FLUX_MSGTYPE_REQUEST, "content-backing.store",   store_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "content-backing.export",  export_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "content-backing.import",  import_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "content-backing.lease-acquire",
+                                                       lease_acquire_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "content-backing.lease-release",
+                                                       lease_release_cb, 0 },
     { FLUX_MSGTYPE_REQUEST, "kvs-checkpoint.get", checkpoint_get_cb, 0 },
     { FLUX_MSGTYPE_REQUEST, "kvs-checkpoint.put", checkpoint_put_cb, 0 },
     FLUX_MSGHANDLER_TABLE_END,
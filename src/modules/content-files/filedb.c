@@ -13,6 +13,7 @@
 #endif
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <fcntl.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -65,6 +66,58 @@ int filedb_get (const char *dbpath,
     return 0;
 }
 
+int filedb_map (const char *dbpath,
+                const char *key,
+                void **datap,
+                size_t *sizep,
+                const char **errstr)
+{
+    char path[1024];
+    int fd;
+    struct stat sb;
+    void *data = NULL;
+
+    if (strlen (key) == 0 || strchr (key, '/') || !strcmp (key, "..")
+                          || !strcmp (key, ".")) {
+        errno = EINVAL;
+        if (errstr)
+            *errstr = "invalid key name";
+        return -1;
+    }
+    if (snprintf (path, sizeof (path), "%s/%s", dbpath, key) >= sizeof (path)) {
+        errno = EOVERFLOW;
+        if (errstr)
+            *errstr = "key name too long for internal buffer";
+        return -1;
+    }
+    if ((fd = open (path, O_RDONLY)) < 0)
+        return -1;
+    if (fstat (fd, &sb) < 0) {
+        ERRNO_SAFE_WRAP (close, fd);
+        return -1;
+    }
+    if (sb.st_size > 0) {
+        data = mmap (NULL, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            ERRNO_SAFE_WRAP (close, fd);
+            return -1;
+        }
+    }
+    if (close (fd) < 0) {
+        ERRNO_SAFE_WRAP (filedb_unmap, data, sb.st_size);
+        return -1;
+    }
+    *datap = data;
+    *sizep = sb.st_size;
+    return 0;
+}
+
+void filedb_unmap (void *data, size_t size)
+{
+    if (data != NULL && size > 0)
+        (void)munmap (data, size);
+}
+
 int filedb_put (const char *dbpath,
                 const char *key,
                 const void *data,
@@ -25,6 +25,23 @@ int filedb_get (const char *dbpath,
                 const char **errstr);
 
 
+/* Same as filedb_get() but the contents are mmapped read-only rather
+ * than copied to the heap, so repeated loads of the same blob are
+ * served from the page cache without a read(2) copy.  On success
+ * *datap must be released with filedb_unmap() (not free).  A
+ * zero-length file yields *datap == NULL, *sizep == 0.
+ * N.B. the mapping is not NULL padded like the filedb_get() result,
+ * so it is unsuitable for use as a string.
+ */
+int filedb_map (const char *dbpath,
+                const char *key,
+                void **datap,
+                size_t *sizep,
+                const char **errstr);
+
+void filedb_unmap (void *data, size_t size);
+
+
 /* Put file named 'key' with content 'data' and length 'size' to the
  * dbpath directory.  On success, 0 is returned.
  * On failure, -1 is returned with errno set.
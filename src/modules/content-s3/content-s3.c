@@ -16,6 +16,8 @@
 
 #include "src/common/libutil/blobref.h"
 #include "src/common/libutil/log.h"
+#include "src/common/libutil/monotime.h"
+#include "src/common/libutil/tstat.h"
 
 #include "src/common/libcontent/content-util.h"
 
@@ -31,8 +33,49 @@ struct content_s3 {
     struct s3_config *cfg;
     flux_t *h;
     const char *hashfun;
+    tstat_t put_stats;          /* request latency (ms) */
+    tstat_t get_stats;
+    int put_errors;
+    int get_errors;
 };
 
+/* Wrappers that accumulate per-request latency so backend slowdowns
+ * show up in content-s3.stats.get rather than only as slow flushes.
+ */
+static int s3_put_timed (struct content_s3 *ctx,
+                         const char *key,
+                         const void *data,
+                         size_t size,
+                         const char **errstr)
+{
+    struct timespec t0;
+    int rc;
+
+    monotime (&t0);
+    if ((rc = s3_put (ctx->cfg, key, data, size, errstr)) < 0)
+        ctx->put_errors++;
+    else
+        tstat_push (&ctx->put_stats, monotime_since (t0));
+    return rc;
+}
+
+static int s3_get_timed (struct content_s3 *ctx,
+                         const char *key,
+                         void **datap,
+                         size_t *sizep,
+                         const char **errstr)
+{
+    struct timespec t0;
+    int rc;
+
+    monotime (&t0);
+    if ((rc = s3_get (ctx->cfg, key, datap, sizep, errstr)) < 0)
+        ctx->get_errors++;
+    else
+        tstat_push (&ctx->get_stats, monotime_since (t0));
+    return rc;
+}
+
 static void s3_config_destroy (struct s3_config *ctx)
 {
     if (ctx) {
@@ -268,7 +311,7 @@ static void load_cb (flux_t *h, flux_msg_handler_t *mh, const flux_msg_t *msg, v
         errstr = "invalid blobref";
         goto error;
     }
-    if (s3_get (ctx->cfg, blobref, &data, &size, &errstr) < 0)
+    if (s3_get_timed (ctx, blobref, &data, &size, &errstr) < 0)
         goto error;
     if (flux_respond_raw (h, msg, data, size) < 0)
         flux_log_error (h, "error responding to load request");
@@ -302,7 +345,7 @@ void store_cb (flux_t *h, flux_msg_handler_t *mh, const flux_msg_t *msg, void *a
                       blobref,
                       sizeof (blobref)) < 0)
         goto error;
-    if (s3_put (ctx->cfg, blobref, data, size, &errstr) < 0)
+    if (s3_put_timed (ctx, blobref, data, size, &errstr) < 0)
         goto error;
     if (flux_respond_raw (h, msg, blobref, strlen (blobref) + 1) < 0)
         flux_log_error (h, "error responding to store request");
@@ -332,7 +375,7 @@ void checkpoint_get_cb (flux_t *h, flux_msg_handler_t *mh, const flux_msg_t *msg
     if (flux_request_unpack (msg, NULL, "{s:s}", "key", &key) < 0)
         goto error;
 
-    if (s3_get (ctx->cfg, key, &data, &size, &errstr) < 0)
+    if (s3_get_timed (ctx, key, &data, &size, &errstr) < 0)
         goto error;
 
     if (!(dup = strndup (data, size)))
@@ -375,7 +418,7 @@ void checkpoint_put_cb (flux_t *h, flux_msg_handler_t *mh, const flux_msg_t *msg
                              "value",
                              &value) < 0)
         goto error;
-    if (s3_put (ctx->cfg, key, value, strlen (value), &errstr) < 0)
+    if (s3_put_timed (ctx, key, value, strlen (value), &errstr) < 0)
         goto error;
     if (flux_respond (h, msg, NULL) < 0)
         flux_log_error (h, "error responding to kvs-checkpoint.put request (pack)");
@@ -386,6 +429,37 @@ error:
         flux_log_error (h, "error responding to kvs-checkpoint.put request");
 }
 
+/* Handle a content-s3.stats.get request, reporting per-request
+ * latency accumulated in the timed s3 wrappers above.
+ */
+static void stats_get_cb (flux_t *h,
+                          flux_msg_handler_t *mh,
+                          const flux_msg_t *msg,
+                          void *arg)
+{
+    struct content_s3 *ctx = arg;
+
+    if (flux_respond_pack (h,
+                           msg,
+                           "{ s:{s:i s:i s:f s:f s:f s:f} "
+                           "  s:{s:i s:i s:f s:f s:f s:f} }",
+                           "put (ms)",
+                           "count", tstat_count (&ctx->put_stats),
+                           "errors", ctx->put_errors,
+                           "min", tstat_min (&ctx->put_stats),
+                           "mean", tstat_mean (&ctx->put_stats),
+                           "stddev", tstat_stddev (&ctx->put_stats),
+                           "max", tstat_max (&ctx->put_stats),
+                           "get (ms)",
+                           "count", tstat_count (&ctx->get_stats),
+                           "errors", ctx->get_errors,
+                           "min", tstat_min (&ctx->get_stats),
+                           "mean", tstat_mean (&ctx->get_stats),
+                           "stddev", tstat_stddev (&ctx->get_stats),
+                           "max", tstat_max (&ctx->get_stats)) < 0)
+        flux_log_error (h, "error responding to stats.get request");
+}
+
 /* Table of message handler callbacks registered below.
  * The topic strings in the table consist of <service name>.<method>.
  */
@@ -395,6 +469,7 @@ static const struct flux_msg_handler_spec htab[] = {
     { FLUX_MSGTYPE_REQUEST, "kvs-checkpoint.get", checkpoint_get_cb, 0 },
     { FLUX_MSGTYPE_REQUEST, "kvs-checkpoint.put", checkpoint_put_cb, 0 },
     { FLUX_MSGTYPE_REQUEST, "content-s3.config-reload", config_reload_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "content-s3.stats.get", stats_get_cb, 0 },
     FLUX_MSGHANDLER_TABLE_END,
 };
 
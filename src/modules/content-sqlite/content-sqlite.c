@@ -15,6 +15,7 @@
 #endif
 #include <sqlite3.h>
 #include <czmq.h>
+#include <jansson.h>
 #include <lz4.h>
 #include <flux/core.h>
 
@@ -23,9 +24,12 @@
 #include "src/common/libutil/errno_safe.h"
 
 #include "src/common/libcontent/content-util.h"
+#include "src/common/libcontent/content-archive.h"
 
 const size_t lzo_buf_chunksize = 1024*1024;
 const size_t compression_threshold = 256; /* compress blobs >= this size */
+const int batch_limit = 256;    /* max stores per sqlite transaction */
+const size_t dict_target_size = 16384; /* sample bytes before dict is built */
 
 const char *sql_create_table = "CREATE TABLE if not exists objects("
                                "  hash CHAR(20) PRIMARY KEY,"
@@ -37,6 +41,19 @@ const char *sql_load = "SELECT object,size FROM objects"
 const char *sql_store = "INSERT INTO objects (hash,size,object) "
                         "  values (?1, ?2, ?3)";
 
+/* The 'size' column encodes how 'object' is stored:
+ *   size == -1   raw (blob was below the compression threshold)
+ *   size >= 0    lz4, 'size' is the uncompressed size
+ *   size <= -2   lz4 with dictionary, uncompressed size is -size - 2
+ */
+
+const char *sql_create_table_dict = "CREATE TABLE if not exists dict("
+                                    "  id INT PRIMARY KEY,"
+                                    "  data BLOB"
+                                    ");";
+const char *sql_dict_get = "SELECT data FROM dict WHERE id = 1";
+const char *sql_dict_put = "INSERT INTO dict (id,data) values (1, ?1)";
+
 const char *sql_create_table_checkpt = "CREATE TABLE if not exists checkpt("
                                        "  key TEXT UNIQUE,"
                                        "  value TEXT"
@@ -49,6 +66,8 @@ const char *sql_checkpt_put = "REPLACE INTO checkpt (key,value) "
 struct content_sqlite {
     flux_msg_handler_t **handlers;
     char *dbfile;
+    int lease_epoch;            /* bumped per direct-read lease grant */
+    bool lease_active;
     sqlite3 *db;
     sqlite3_stmt *load_stmt;
     sqlite3_stmt *store_stmt;
@@ -58,6 +77,13 @@ struct content_sqlite {
     const char *hashfun;
     size_t lzo_bufsize;
     void *lzo_buf;
+    flux_watcher_t *commit_w;
+    int batch_count;            /* stores in the open transaction */
+    char *dict;                 /* lz4 dictionary for small blobs */
+    int dict_len;
+    char *dict_samples;         /* sampled blobs until dict is built */
+    size_t dict_samples_len;
+    LZ4_stream_t *lz4_stream;
 };
 
 static void log_sqlite_error (struct content_sqlite *ctx, const char *fmt, ...)
@@ -123,6 +149,156 @@ static int grow_lzo_buf (struct content_sqlite *ctx, size_t size)
     return 0;
 }
 
+/* Commit the open store transaction, if any.  Stores are grouped
+ * into one sqlite transaction per reactor tick (or per 'batch_limit'
+ * blobs, whichever comes first) so checkpoint-heavy load does not
+ * turn into one tiny disk transaction per blob.  Loads are answered
+ * from the same connection, which sees the uncommitted inserts, so
+ * read-after-write is preserved.
+ */
+static void content_sqlite_commit (struct content_sqlite *ctx)
+{
+    if (ctx->batch_count > 0) {
+        if (sqlite3_exec (ctx->db, "COMMIT", NULL, NULL, NULL) != SQLITE_OK)
+            log_sqlite_error (ctx, "committing store batch");
+        ctx->batch_count = 0;
+    }
+    if (ctx->commit_w)
+        flux_watcher_stop (ctx->commit_w);
+}
+
+static void commit_timer_cb (flux_reactor_t *r,
+                             flux_watcher_t *w,
+                             int revents,
+                             void *arg)
+{
+    struct content_sqlite *ctx = arg;
+    content_sqlite_commit (ctx);
+}
+
+/* Open a store transaction if one isn't already open, and schedule
+ * its commit at the end of the current reactor tick.
+ * Returns 0 on success, -1 on error with errno set.
+ */
+static int content_sqlite_batch_begin (struct content_sqlite *ctx)
+{
+    if (ctx->batch_count == 0) {
+        if (sqlite3_exec (ctx->db, "BEGIN", NULL, NULL, NULL) != SQLITE_OK) {
+            log_sqlite_error (ctx, "beginning store batch");
+            set_errno_from_sqlite_error (ctx);
+            return -1;
+        }
+        if (ctx->commit_w) {
+            flux_timer_watcher_reset (ctx->commit_w, 0., 0.);
+            flux_watcher_start (ctx->commit_w);
+        }
+    }
+    return 0;
+}
+
+/* Persist ctx->dict to the dict table so blobs compressed against it
+ * remain readable when the database is reopened.
+ * Returns 0 on success, -1 on error with errno set.
+ */
+static int content_sqlite_dict_put (struct content_sqlite *ctx)
+{
+    sqlite3_stmt *stmt = NULL;
+    int rc = -1;
+
+    if (sqlite3_prepare_v2 (ctx->db, sql_dict_put, -1, &stmt, NULL)
+                                                            != SQLITE_OK) {
+        log_sqlite_error (ctx, "dict_put: preparing stmt");
+        goto error;
+    }
+    if (sqlite3_bind_blob (stmt,
+                           1,
+                           ctx->dict,
+                           ctx->dict_len,
+                           SQLITE_STATIC) != SQLITE_OK) {
+        log_sqlite_error (ctx, "dict_put: binding data");
+        goto error;
+    }
+    if (sqlite3_step (stmt) != SQLITE_DONE) {
+        log_sqlite_error (ctx, "dict_put: executing stmt");
+        goto error;
+    }
+    rc = 0;
+error:
+    if (rc < 0)
+        set_errno_from_sqlite_error (ctx);
+    ERRNO_SAFE_WRAP (sqlite3_finalize, stmt);
+    return rc;
+}
+
+/* Fetch a previously persisted dictionary, if any.
+ * Returns 0 on success (ctx->dict remains NULL if none stored),
+ * -1 on error with errno set.
+ */
+static int content_sqlite_dict_get (struct content_sqlite *ctx)
+{
+    sqlite3_stmt *stmt = NULL;
+    int rc = -1;
+
+    if (sqlite3_prepare_v2 (ctx->db, sql_dict_get, -1, &stmt, NULL)
+                                                            != SQLITE_OK) {
+        log_sqlite_error (ctx, "dict_get: preparing stmt");
+        set_errno_from_sqlite_error (ctx);
+        goto done;
+    }
+    if (sqlite3_step (stmt) == SQLITE_ROW) {
+        int len = sqlite3_column_bytes (stmt, 0);
+        const void *data = sqlite3_column_blob (stmt, 0);
+
+        if (len > 0) {
+            if (!(ctx->dict = malloc (len))) {
+                errno = ENOMEM;
+                goto done;
+            }
+            memcpy (ctx->dict, data, len);
+            ctx->dict_len = len;
+        }
+    }
+    rc = 0;
+done:
+    ERRNO_SAFE_WRAP (sqlite3_finalize, stmt);
+    return rc;
+}
+
+/* Accumulate small blobs until there is enough material to serve as
+ * an lz4 dictionary, then persist and activate it.  Small blobs are
+ * dominated by a few near-duplicate classes (jobspec, eventlog,
+ * dirobj), so early samples compress later arrivals well.  Sampling
+ * failures are not fatal; the store proceeds without a dictionary.
+ */
+static void content_sqlite_dict_sample (struct content_sqlite *ctx,
+                                        const void *data,
+                                        int size)
+{
+    char *samples;
+
+    if (!(samples = realloc (ctx->dict_samples,
+                             ctx->dict_samples_len + size)))
+        return;
+    memcpy (samples + ctx->dict_samples_len, data, size);
+    ctx->dict_samples = samples;
+    ctx->dict_samples_len += size;
+    if (ctx->dict_samples_len < dict_target_size)
+        return;
+    ctx->dict = ctx->dict_samples;
+    ctx->dict_len = ctx->dict_samples_len;
+    ctx->dict_samples = NULL;
+    ctx->dict_samples_len = 0;
+    if (content_sqlite_dict_put (ctx) < 0) {
+        flux_log (ctx->h, LOG_ERR, "failed to persist compression dict");
+        free (ctx->dict);
+        ctx->dict = NULL;
+        ctx->dict_len = 0;
+    }
+    else
+        flux_log (ctx->h, LOG_DEBUG, "compression dict built (%d bytes)",
+                  ctx->dict_len);
+}
+
 /* Load blob from objects table, uncompressing if necessary.
  * Returns 0 on success, -1 on error with errno set.
  * On successful return, must call sqlite3_reset (ctx->load_stmt),
@@ -172,10 +348,31 @@ static int content_sqlite_load (struct content_sqlite *ctx,
     }
     uncompressed_size = sqlite3_column_int (ctx->load_stmt, 1);
     if (uncompressed_size != -1) {
+        bool usedict = false;
+        int r;
+
+        if (uncompressed_size <= -2) {  /* dictionary-compressed */
+            uncompressed_size = -uncompressed_size - 2;
+            usedict = true;
+        }
         if (ctx->lzo_bufsize < uncompressed_size
                                 && grow_lzo_buf (ctx, uncompressed_size) < 0)
             goto error;
-        int r = LZ4_decompress_safe (data,
+        if (usedict) {
+            if (!ctx->dict) {
+                flux_log (ctx->h, LOG_ERR, "load: compression dict missing");
+                errno = EINVAL;
+                goto error;
+            }
+            r = LZ4_decompress_safe_usingDict (data,
+                                               ctx->lzo_buf,
+                                               size,
+                                               uncompressed_size,
+                                               ctx->dict,
+                                               ctx->dict_len);
+        }
+        else
+            r = LZ4_decompress_safe (data,
                                      ctx->lzo_buf,
                                      size,
                                      uncompressed_size);
@@ -221,6 +418,8 @@ static int content_sqlite_store (struct content_sqlite *ctx,
         return -1;
     if ((hash_len = blobref_strtohash (blobref, hash, sizeof (hash))) < 0)
         return -1;
+    if (content_sqlite_batch_begin (ctx) < 0)
+        return -1;
     if (size >= compression_threshold) {
         int r;
         int out_len = LZ4_compressBound(size);
@@ -235,6 +434,29 @@ static int content_sqlite_store (struct content_sqlite *ctx,
         size = r;
         data = ctx->lzo_buf;
     }
+    else if (size > 0) {
+        if (ctx->dict) {
+            int out_len = LZ4_compressBound (size);
+            int r;
+
+            if (ctx->lzo_bufsize < out_len && grow_lzo_buf (ctx, out_len) < 0)
+                return -1;
+            LZ4_loadDict (ctx->lz4_stream, ctx->dict, ctx->dict_len);
+            r = LZ4_compress_fast_continue (ctx->lz4_stream,
+                                            data,
+                                            ctx->lzo_buf,
+                                            size,
+                                            out_len,
+                                            1);
+            if (r > 0 && r < size) {
+                uncompressed_size = -size - 2;
+                size = r;
+                data = ctx->lzo_buf;
+            }
+        }
+        else
+            content_sqlite_dict_sample (ctx, data, size);
+    }
     if (sqlite3_bind_text (ctx->store_stmt,
                            1,
                            (char *)hash,
@@ -267,6 +489,8 @@ static int content_sqlite_store (struct content_sqlite *ctx,
         goto error;
     }
     sqlite3_reset (ctx->store_stmt);
+    if (++ctx->batch_count >= batch_limit)
+        content_sqlite_commit (ctx);
     return 0;
 error:
     ERRNO_SAFE_WRAP (sqlite3_reset, ctx->store_stmt);
@@ -423,10 +647,372 @@ error:
     (void )sqlite3_reset (ctx->checkpt_put_stmt);
 }
 
+/* Garbage collection support for the kvs.gc mark and sweep pass
+ * (see kvs module kvsgc.c).  gc-mark accumulates reachable blobrefs
+ * in a temp table; gc-sweep deletes everything else from the objects
+ * table in one anti-join and drops the mark table.  Checkpoints live
+ * in a separate table and are untouched.  These are rare admin
+ * operations, so statements are prepared per request.
+ */
+
+const char *sql_create_table_gc = "CREATE TEMP TABLE if not exists gc_mark("
+                                  "  hash TEXT PRIMARY KEY"
+                                  ");";
+const char *sql_gc_mark = "INSERT OR IGNORE INTO gc_mark (hash) "
+                          "  values (?1)";
+const char *sql_gc_sweep = "DELETE FROM objects WHERE hash NOT IN"
+                           "  (SELECT hash FROM gc_mark)";
+
+static void gc_mark_cb (flux_t *h,
+                        flux_msg_handler_t *mh,
+                        const flux_msg_t *msg,
+                        void *arg)
+{
+    struct content_sqlite *ctx = arg;
+    sqlite3_stmt *stmt = NULL;
+    json_t *refs;
+    size_t index;
+    json_t *entry;
+    const char *errstr = NULL;
+
+    if (flux_request_unpack (msg, NULL, "{s:o}", "refs", &refs) < 0)
+        goto error;
+    if (sqlite3_exec (ctx->db,
+                      sql_create_table_gc,
+                      NULL,
+                      NULL,
+                      NULL) != SQLITE_OK) {
+        log_sqlite_error (ctx, "gc-mark: creating mark table");
+        set_errno_from_sqlite_error (ctx);
+        goto error;
+    }
+    if (sqlite3_prepare_v2 (ctx->db,
+                            sql_gc_mark,
+                            -1,
+                            &stmt,
+                            NULL) != SQLITE_OK) {
+        log_sqlite_error (ctx, "gc-mark: preparing stmt");
+        set_errno_from_sqlite_error (ctx);
+        goto error;
+    }
+    json_array_foreach (refs, index, entry) {
+        uint8_t hash[BLOBREF_MAX_DIGEST_SIZE];
+        int hash_len;
+        const char *blobref = json_string_value (entry);
+
+        if (!blobref
+            || (hash_len = blobref_strtohash (blobref,
+                                              hash,
+                                              sizeof (hash))) < 0) {
+            errno = EPROTO;
+            errstr = "invalid blobref in mark set";
+            goto error;
+        }
+        if (sqlite3_bind_text (stmt,
+                               1,
+                               (char *)hash,
+                               hash_len,
+                               SQLITE_STATIC) != SQLITE_OK
+            || sqlite3_step (stmt) != SQLITE_DONE) {
+            log_sqlite_error (ctx, "gc-mark: inserting mark");
+            set_errno_from_sqlite_error (ctx);
+            goto error;
+        }
+        (void)sqlite3_reset (stmt);
+    }
+    sqlite3_finalize (stmt);
+    if (flux_respond (h, msg, NULL) < 0)
+        flux_log_error (h, "error responding to gc-mark request");
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, errstr) < 0)
+        flux_log_error (h, "error responding to gc-mark request");
+    if (stmt)
+        ERRNO_SAFE_WRAP (sqlite3_finalize, stmt);
+}
+
+static void gc_sweep_cb (flux_t *h,
+                         flux_msg_handler_t *mh,
+                         const flux_msg_t *msg,
+                         void *arg)
+{
+    struct content_sqlite *ctx = arg;
+    sqlite3_stmt *stmt = NULL;
+    const char *errstr = NULL;
+    int swept;
+    int remaining = 0;
+
+    if (flux_request_decode (msg, NULL, NULL) < 0)
+        goto error;
+    /* Flush any open store batch so the sweep runs outside it and a
+     * later rollback cannot resurrect swept rows inconsistently.
+     */
+    content_sqlite_commit (ctx);
+    if (sqlite3_exec (ctx->db, sql_gc_sweep, NULL, NULL, NULL) != SQLITE_OK) {
+        log_sqlite_error (ctx, "gc-sweep: deleting unmarked objects");
+        set_errno_from_sqlite_error (ctx);
+        errstr = "sweep failed (was gc-mark run first?)";
+        goto error;
+    }
+    swept = sqlite3_changes (ctx->db);
+    if (sqlite3_prepare_v2 (ctx->db,
+                            "SELECT count(*) FROM objects",
+                            -1,
+                            &stmt,
+                            NULL) == SQLITE_OK
+        && sqlite3_step (stmt) == SQLITE_ROW)
+        remaining = sqlite3_column_int (stmt, 0);
+    if (stmt)
+        sqlite3_finalize (stmt);
+    (void)sqlite3_exec (ctx->db,
+                        "DROP TABLE IF EXISTS gc_mark",
+                        NULL,
+                        NULL,
+                        NULL);
+    flux_log (h, LOG_INFO, "gc-sweep: %d swept, %d remaining",
+              swept, remaining);
+    if (flux_respond_pack (h,
+                           msg,
+                           "{s:i s:i}",
+                           "swept", swept,
+                           "remaining", remaining) < 0)
+        flux_log_error (h, "error responding to gc-sweep request");
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, errstr) < 0)
+        flux_log_error (h, "error responding to gc-sweep request");
+}
+
+/* Bulk migration support (see flux-content(1) export/import).  The
+ * archive is written/read directly by this module with sequential
+ * buffered I/O, so migrating a large store runs at disk bandwidth
+ * instead of one RPC round trip per blob.
+ */
+
+static void export_cb (flux_t *h,
+                       flux_msg_handler_t *mh,
+                       const flux_msg_t *msg,
+                       void *arg)
+{
+    struct content_sqlite *ctx = arg;
+    struct content_archive_writer *w = NULL;
+    sqlite3_stmt *stmt = NULL;
+    const char *path;
+    const char *errstr = NULL;
+    int count = 0;
+    uint64_t bytes = 0;
+
+    if (flux_request_unpack (msg, NULL, "{s:s}", "path", &path) < 0)
+        goto error;
+    if (!(w = content_archive_writer_create (path, ctx->hashfun)))
+        goto error;
+    if (sqlite3_prepare_v2 (ctx->db,
+                            "SELECT hash FROM objects",
+                            -1,
+                            &stmt,
+                            NULL) != SQLITE_OK) {
+        log_sqlite_error (ctx, "export: preparing stmt");
+        set_errno_from_sqlite_error (ctx);
+        goto error;
+    }
+    while (sqlite3_step (stmt) == SQLITE_ROW) {
+        char blobref[BLOBREF_MAX_STRING_SIZE];
+        const void *data;
+        int size;
+
+        if (blobref_hashtostr (ctx->hashfun,
+                               sqlite3_column_blob (stmt, 0),
+                               sqlite3_column_bytes (stmt, 0),
+                               blobref,
+                               sizeof (blobref)) < 0)
+            goto error;
+        if (content_sqlite_load (ctx, blobref, &data, &size) < 0)
+            goto error;
+        if (content_archive_append (w, blobref, data, size) < 0) {
+            ERRNO_SAFE_WRAP (sqlite3_reset, ctx->load_stmt);
+            goto error;
+        }
+        (void)sqlite3_reset (ctx->load_stmt);
+        count++;
+        bytes += size;
+    }
+    sqlite3_finalize (stmt);
+    stmt = NULL;
+    if (content_archive_writer_close (w) < 0) {
+        w = NULL;
+        goto error;
+    }
+    if (flux_respond_pack (h,
+                           msg,
+                           "{s:i s:I}",
+                           "count", count,
+                           "bytes", (json_int_t)bytes) < 0)
+        flux_log_error (h, "error responding to export request");
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, errstr) < 0)
+        flux_log_error (h, "error responding to export request");
+    if (stmt)
+        ERRNO_SAFE_WRAP (sqlite3_finalize, stmt);
+    content_archive_writer_destroy (w);
+}
+
+static void import_cb (flux_t *h,
+                       flux_msg_handler_t *mh,
+                       const flux_msg_t *msg,
+                       void *arg)
+{
+    struct content_sqlite *ctx = arg;
+    struct content_archive_reader *r = NULL;
+    const char *path;
+    const char *errstr = NULL;
+    char hash_name[16];
+    const void *data;
+    uint32_t len;
+    int rc;
+    int count = 0;
+    uint64_t bytes = 0;
+
+    if (flux_request_unpack (msg, NULL, "{s:s}", "path", &path) < 0)
+        goto error;
+    if (!(r = content_archive_reader_create (path,
+                                             hash_name,
+                                             sizeof (hash_name))))
+        goto error;
+    if (strcmp (hash_name, ctx->hashfun) != 0) {
+        errno = EINVAL;
+        errstr = "archive hash type does not match this instance";
+        goto error;
+    }
+    while ((rc = content_archive_next (r, &data, &len)) == 1) {
+        char blobref[BLOBREF_MAX_STRING_SIZE];
+
+        if (content_sqlite_store (ctx,
+                                  data,
+                                  len,
+                                  blobref,
+                                  sizeof (blobref)) < 0)
+            goto error;
+        count++;
+        bytes += len;
+    }
+    if (rc < 0) {
+        errstr = "archive is corrupt or truncated";
+        goto error;
+    }
+    content_archive_reader_destroy (r);
+    content_sqlite_commit (ctx);
+    if (flux_respond_pack (h,
+                           msg,
+                           "{s:i s:I}",
+                           "count", count,
+                           "bytes", (json_int_t)bytes) < 0)
+        flux_log_error (h, "error responding to import request");
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, errstr) < 0)
+        flux_log_error (h, "error responding to import request");
+    content_archive_reader_destroy (r);
+}
+
+/* Direct read-only access for trusted local tools (debug/backup).
+ * Streaming the whole store through content-backing.load RPCs moves
+ * gigabytes one round trip at a time; instead a local process may take
+ * a lease and bulk-read the database file at disk speed.
+ *
+ * While the lease is held, the open store batch is committed, WAL
+ * auto-checkpointing is disabled, and the log is checkpointed into the
+ * main database file, which then stays frozen: subsequent stores land
+ * only in the -wal file.  The lease holder opens the database file
+ * read-only (with the immutable=1 URI option, since this module holds
+ * an exclusive lock) and sees a consistent snapshot as of the lease
+ * epoch.  Releasing the lease re-enables auto-checkpointing.  One
+ * lease at a time; like all content-backing requests, owner only.
+ */
+
+static void lease_acquire_cb (flux_t *h,
+                              flux_msg_handler_t *mh,
+                              const flux_msg_t *msg,
+                              void *arg)
+{
+    struct content_sqlite *ctx = arg;
+    const char *errstr = NULL;
+
+    if (flux_request_decode (msg, NULL, NULL) < 0)
+        goto error;
+    if (ctx->lease_active) {
+        errno = EBUSY;
+        errstr = "a direct-read lease is already held";
+        goto error;
+    }
+    content_sqlite_commit (ctx);
+    if (sqlite3_exec (ctx->db,
+                      "PRAGMA wal_autocheckpoint=0",
+                      NULL,
+                      NULL,
+                      NULL) != SQLITE_OK
+        || sqlite3_exec (ctx->db,
+                         "PRAGMA wal_checkpoint(TRUNCATE)",
+                         NULL,
+                         NULL,
+                         NULL) != SQLITE_OK) {
+        log_sqlite_error (ctx, "lease-acquire: freezing database file");
+        set_errno_from_sqlite_error (ctx);
+        goto error;
+    }
+    ctx->lease_active = true;
+    ctx->lease_epoch++;
+    if (flux_respond_pack (h,
+                           msg,
+                           "{s:s s:i s:s}",
+                           "path", ctx->dbfile,
+                           "epoch", ctx->lease_epoch,
+                           "hash", ctx->hashfun) < 0)
+        flux_log_error (h, "error responding to lease-acquire request");
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, errstr) < 0)
+        flux_log_error (h, "error responding to lease-acquire request");
+}
+
+static void lease_release_cb (flux_t *h,
+                              flux_msg_handler_t *mh,
+                              const flux_msg_t *msg,
+                              void *arg)
+{
+    struct content_sqlite *ctx = arg;
+    const char *errstr = NULL;
+    int epoch;
+
+    if (flux_request_unpack (msg, NULL, "{s:i}", "epoch", &epoch) < 0)
+        goto error;
+    if (!ctx->lease_active || epoch != ctx->lease_epoch) {
+        errno = ENOENT;
+        errstr = "no matching lease is held";
+        goto error;
+    }
+    ctx->lease_active = false;
+    /* restore the sqlite default auto-checkpoint interval */
+    if (sqlite3_exec (ctx->db,
+                      "PRAGMA wal_autocheckpoint=1000",
+                      NULL,
+                      NULL,
+                      NULL) != SQLITE_OK)
+        log_sqlite_error (ctx, "lease-release: re-enabling checkpointing");
+    if (flux_respond (h, msg, NULL) < 0)
+        flux_log_error (h, "error responding to lease-release request");
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, errstr) < 0)
+        flux_log_error (h, "error responding to lease-release request");
+}
+
 static void content_sqlite_closedb (struct content_sqlite *ctx)
 {
     if (ctx) {
         int saved_errno = errno;
+        if (ctx->db)
+            content_sqlite_commit (ctx);
         if (ctx->store_stmt) {
             if (sqlite3_finalize (ctx->store_stmt) != SQLITE_OK)
                 log_sqlite_error (ctx, "sqlite_finalize store_stmt");
@@ -461,8 +1047,11 @@ static int content_sqlite_opendb (struct content_sqlite *ctx)
         log_sqlite_error (ctx, "opening %s", ctx->dbfile);
         goto error;
     }
+    /* WAL turns the batched store transactions into sequential log
+     * appends rather than in-place page rewrites.
+     */
     if (sqlite3_exec (ctx->db,
-                      "PRAGMA journal_mode=OFF",
+                      "PRAGMA journal_mode=WAL",
                       NULL,
                       NULL,
                       NULL) != SQLITE_OK) {
@@ -501,6 +1090,16 @@ static int content_sqlite_opendb (struct content_sqlite *ctx)
         log_sqlite_error (ctx, "creating checkpt table");
         goto error;
     }
+    if (sqlite3_exec (ctx->db,
+                      sql_create_table_dict,
+                      NULL,
+                      NULL,
+                      NULL) != SQLITE_OK) {
+        log_sqlite_error (ctx, "creating dict table");
+        goto error;
+    }
+    if (content_sqlite_dict_get (ctx) < 0)
+        goto error;
     if (sqlite3_prepare_v2 (ctx->db,
                             sql_load,
                             -1,
@@ -544,6 +1143,10 @@ static void content_sqlite_destroy (struct content_sqlite *ctx)
     if (ctx) {
         int saved_errno = errno;
         flux_msg_handler_delvec (ctx->handlers);
+        flux_watcher_destroy (ctx->commit_w);
+        LZ4_freeStream (ctx->lz4_stream);
+        free (ctx->dict);
+        free (ctx->dict_samples);
         free (ctx->dbfile);
         free (ctx->lzo_buf);
         free (ctx);
@@ -554,6 +1157,14 @@ static void content_sqlite_destroy (struct content_sqlite *ctx)
 static const struct flux_msg_handler_spec htab[] = {
     { FLUX_MSGTYPE_REQUEST, "content-backing.load",    load_cb, 0 },
     { FLUX_MSGTYPE_REQUEST, "content-backing.store",   store_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "content-backing.gc-mark",  gc_mark_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "content-backing.gc-sweep", gc_sweep_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "content-backing.export",  export_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "content-backing.import",  import_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "content-backing.lease-acquire",
+                                                       lease_acquire_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "content-backing.lease-release",
+                                                       lease_release_cb, 0 },
     { FLUX_MSGTYPE_REQUEST, "kvs-checkpoint.get", checkpoint_get_cb, 0 },
     { FLUX_MSGTYPE_REQUEST, "kvs-checkpoint.put", checkpoint_put_cb, 0 },
     FLUX_MSGHANDLER_TABLE_END,
@@ -569,6 +1180,10 @@ static struct content_sqlite *content_sqlite_create (flux_t *h)
     if (!(ctx->lzo_buf = calloc (1, lzo_buf_chunksize)))
         goto error;
     ctx->lzo_bufsize = lzo_buf_chunksize;
+    if (!(ctx->lz4_stream = LZ4_createStream ())) {
+        errno = ENOMEM;
+        goto error;
+    }
     ctx->h = h;
 
     /* Some tunables:
@@ -607,6 +1222,12 @@ static struct content_sqlite *content_sqlite_create (flux_t *h)
     }
     if (flux_msg_handler_addvec (h, htab, ctx, &ctx->handlers) < 0)
         goto error;
+    if (!(ctx->commit_w = flux_timer_watcher_create (flux_get_reactor (h),
+                                                     0.,
+                                                     0.,
+                                                     commit_timer_cb,
+                                                     ctx)))
+        goto error;
     return ctx;
 error:
     content_sqlite_destroy (ctx);
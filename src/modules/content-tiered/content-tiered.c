@@ -0,0 +1,735 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* content-tiered.c - tiered content backing store (sqlite + s3)
+ *
+ * Blobs are stored in a local sqlite "hot" tier and demoted to an S3
+ * "cold" tier once they have been idle longer than a TTL, so a
+ * long-lived instance does not fill local disk while keeping warm
+ * blobs at local latency.  Loads check the hot tier first; a cold hit
+ * is promoted back into sqlite.
+ *
+ * The hot tier records a last-access time per blob, updated on load,
+ * and a periodic timer demotes idle blobs in batches.
+ *
+ * Only one module may own the content-backing service, so this
+ * module cannot delegate to loaded content-sqlite/content-s3 modules;
+ * it drives sqlite directly and reuses the content-s3 module's s3
+ * request helpers.  S3 connection details are read from the same
+ * [content-s3] config table as the content-s3 module.
+ *
+ * Module options:
+ *   ttl=SECONDS       demote blobs idle this long (default 3600)
+ *   interval=SECONDS  demotion scan period (default 60)
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <sqlite3.h>
+#include <time.h>
+#include <flux/core.h>
+
+#include "src/common/libutil/blobref.h"
+#include "src/common/libutil/log.h"
+#include "src/common/libutil/errno_safe.h"
+
+#include "src/common/libcontent/content-util.h"
+
+#include "src/common/libtomlc99/toml.h"
+#include "src/common/libutil/tomltk.h"
+
+#include "src/common/libyuarel/yuarel.h"
+
+#include "src/modules/content-s3/s3.h"
+
+const int default_ttl = 3600;       /* seconds idle before demotion */
+const int default_interval = 60;    /* seconds between demotion scans */
+const int demote_batch_limit = 64;  /* max blobs demoted per scan */
+
+const char *sql_create_table = "CREATE TABLE if not exists objects("
+                               "  blobref TEXT PRIMARY KEY,"
+                               "  object BLOB,"
+                               "  atime INT"
+                               ");";
+const char *sql_load = "SELECT object FROM objects"
+                       "  WHERE blobref = ?1 LIMIT 1";
+const char *sql_store = "REPLACE INTO objects (blobref,object,atime) "
+                        "  values (?1, ?2, ?3)";
+const char *sql_touch = "UPDATE objects SET atime = ?1 WHERE blobref = ?2";
+const char *sql_idle = "SELECT blobref,object FROM objects"
+                       "  WHERE atime < ?1 LIMIT ?2";
+const char *sql_drop = "DELETE FROM objects WHERE blobref = ?1";
+
+struct content_tiered {
+    flux_msg_handler_t **handlers;
+    char *dbfile;
+    sqlite3 *db;
+    sqlite3_stmt *load_stmt;
+    sqlite3_stmt *store_stmt;
+    sqlite3_stmt *touch_stmt;
+    sqlite3_stmt *idle_stmt;
+    sqlite3_stmt *drop_stmt;
+    struct s3_config *cfg;
+    flux_watcher_t *demote_w;
+    flux_t *h;
+    const char *hashfun;
+    int ttl;
+    int interval;
+    int demoted;                /* lifetime demotion count, for logs */
+};
+
+static void log_sqlite_error (struct content_tiered *ctx, const char *fmt, ...)
+{
+    char buf[64];
+    va_list ap;
+
+    va_start (ap, fmt);
+    (void)vsnprintf (buf, sizeof (buf), fmt, ap);
+    va_end (ap);
+
+    if (ctx->db) {
+        const char *errmsg = sqlite3_errmsg (ctx->db);
+        flux_log (ctx->h,
+                  LOG_ERR,
+                  "%s: %s(%d)",
+                  buf,
+                  errmsg ? errmsg : "unknown error code",
+                  sqlite3_extended_errcode (ctx->db));
+    }
+    else
+        flux_log (ctx->h, LOG_ERR, "%s: unknown error, no sqlite3 handle", buf);
+}
+
+static void set_errno_from_sqlite_error (struct content_tiered *ctx)
+{
+    switch (sqlite3_errcode (ctx->db)) {
+        case SQLITE_IOERR:
+            errno = EIO;
+            break;
+        case SQLITE_NOMEM:
+            errno = ENOMEM;
+            break;
+        case SQLITE_ABORT:
+        case SQLITE_PERM:
+        case SQLITE_READONLY:
+            errno = EPERM;
+            break;
+        case SQLITE_TOOBIG:
+            errno = EFBIG;
+            break;
+        case SQLITE_FULL:
+            errno = ENOSPC;
+            break;
+        default:
+            errno = EINVAL;
+            break;
+    }
+}
+
+/* Insert/replace a blob in the hot tier with a fresh access time.
+ * Returns 0 on success, -1 on error with errno set.
+ */
+static int hot_store (struct content_tiered *ctx,
+                      const char *blobref,
+                      const void *data,
+                      int size)
+{
+    int rc = -1;
+
+    if (sqlite3_bind_text (ctx->store_stmt,
+                           1,
+                           blobref,
+                           strlen (blobref),
+                           SQLITE_STATIC) != SQLITE_OK
+        || sqlite3_bind_blob (ctx->store_stmt,
+                              2,
+                              data,
+                              size,
+                              SQLITE_STATIC) != SQLITE_OK
+        || sqlite3_bind_int64 (ctx->store_stmt,
+                               3,
+                               (sqlite3_int64)time (NULL)) != SQLITE_OK) {
+        log_sqlite_error (ctx, "store: binding parameters");
+        set_errno_from_sqlite_error (ctx);
+        goto done;
+    }
+    if (sqlite3_step (ctx->store_stmt) != SQLITE_DONE) {
+        log_sqlite_error (ctx, "store: executing stmt");
+        set_errno_from_sqlite_error (ctx);
+        goto done;
+    }
+    rc = 0;
+done:
+    ERRNO_SAFE_WRAP (sqlite3_reset, ctx->store_stmt);
+    return rc;
+}
+
+/* Look up a blob in the hot tier and refresh its access time.
+ * On successful return, caller must call sqlite3_reset (ctx->load_stmt),
+ * which invalidates returned data.
+ * Returns 0 on success, -1 on error with errno set (ENOENT if absent).
+ */
+static int hot_load (struct content_tiered *ctx,
+                     const char *blobref,
+                     const void **datap,
+                     int *sizep)
+{
+    if (sqlite3_bind_text (ctx->load_stmt,
+                           1,
+                           blobref,
+                           strlen (blobref),
+                           SQLITE_STATIC) != SQLITE_OK) {
+        log_sqlite_error (ctx, "load: binding key");
+        set_errno_from_sqlite_error (ctx);
+        goto error;
+    }
+    if (sqlite3_step (ctx->load_stmt) != SQLITE_ROW) {
+        errno = ENOENT;
+        goto error;
+    }
+    *datap = sqlite3_column_blob (ctx->load_stmt, 0);
+    *sizep = sqlite3_column_bytes (ctx->load_stmt, 0);
+
+    if (sqlite3_bind_int64 (ctx->touch_stmt,
+                            1,
+                            (sqlite3_int64)time (NULL)) == SQLITE_OK
+        && sqlite3_bind_text (ctx->touch_stmt,
+                              2,
+                              blobref,
+                              strlen (blobref),
+                              SQLITE_STATIC) == SQLITE_OK)
+        (void)sqlite3_step (ctx->touch_stmt);
+    (void)sqlite3_reset (ctx->touch_stmt);
+    return 0;
+error:
+    ERRNO_SAFE_WRAP (sqlite3_reset, ctx->load_stmt);
+    return -1;
+}
+
+/* Remove a blob from the hot tier (after successful demotion).
+ */
+static void hot_drop (struct content_tiered *ctx, const char *blobref)
+{
+    if (sqlite3_bind_text (ctx->drop_stmt,
+                           1,
+                           blobref,
+                           strlen (blobref),
+                           SQLITE_STATIC) != SQLITE_OK
+        || sqlite3_step (ctx->drop_stmt) != SQLITE_DONE)
+        log_sqlite_error (ctx, "drop: %s", blobref);
+    (void)sqlite3_reset (ctx->drop_stmt);
+}
+
+/* Demote a batch of idle blobs to the cold tier.  A blob is removed
+ * from sqlite only after its S3 PUT succeeds, so a failed or
+ * interrupted scan leaves blobs hot rather than lost.
+ */
+static void demote_cb (flux_reactor_t *r,
+                       flux_watcher_t *w,
+                       int revents,
+                       void *arg)
+{
+    struct content_tiered *ctx = arg;
+    sqlite3_int64 cutoff = (sqlite3_int64)time (NULL) - ctx->ttl;
+    int count = 0;
+
+    if (sqlite3_bind_int64 (ctx->idle_stmt, 1, cutoff) != SQLITE_OK
+        || sqlite3_bind_int (ctx->idle_stmt, 2, demote_batch_limit)
+                                                            != SQLITE_OK) {
+        log_sqlite_error (ctx, "demote: binding parameters");
+        goto done;
+    }
+    while (sqlite3_step (ctx->idle_stmt) == SQLITE_ROW) {
+        const char *blobref = (const char *)sqlite3_column_text (
+                                                        ctx->idle_stmt, 0);
+        const void *data = sqlite3_column_blob (ctx->idle_stmt, 1);
+        int size = sqlite3_column_bytes (ctx->idle_stmt, 1);
+        const char *errstr = NULL;
+
+        if (s3_put (ctx->cfg, blobref, data, size, &errstr) < 0) {
+            flux_log (ctx->h, LOG_ERR, "demote %s: %s",
+                      blobref, errstr ? errstr : "error");
+            break;  /* cold tier unhappy, retry next scan */
+        }
+        hot_drop (ctx, blobref);
+        count++;
+    }
+done:
+    (void)sqlite3_reset (ctx->idle_stmt);
+    if (count > 0) {
+        ctx->demoted += count;
+        flux_log (ctx->h, LOG_DEBUG, "demoted %d blobs (%d total)",
+                  count, ctx->demoted);
+    }
+}
+
+/* Handle a content-backing.load request.  Hot tier first; on a cold
+ * hit the blob is promoted back into sqlite.
+ */
+static void load_cb (flux_t *h,
+                     flux_msg_handler_t *mh,
+                     const flux_msg_t *msg,
+                     void *arg)
+{
+    struct content_tiered *ctx = arg;
+    const char *blobref;
+    int blobref_size;
+    const void *data;
+    int size;
+    void *cold_data = NULL;
+    size_t cold_size;
+    const char *errstr = NULL;
+
+    if (flux_request_decode_raw (msg,
+                                 NULL,
+                                 (const void **)&blobref,
+                                 &blobref_size) < 0)
+        goto error;
+    if (!blobref || blobref[blobref_size - 1] != '\0'
+                 || blobref_validate (blobref) < 0) {
+        errno = EPROTO;
+        errstr = "invalid blobref";
+        goto error;
+    }
+    if (hot_load (ctx, blobref, &data, &size) == 0) {
+        if (flux_respond_raw (h, msg, data, size) < 0)
+            flux_log_error (h, "error responding to load request");
+        (void)sqlite3_reset (ctx->load_stmt);
+        return;
+    }
+    if (s3_get (ctx->cfg, blobref, &cold_data, &cold_size, &errstr) < 0)
+        goto error;
+    if (hot_store (ctx, blobref, cold_data, cold_size) < 0)
+        flux_log_error (h, "promote %s", blobref); /* still answerable */
+    if (flux_respond_raw (h, msg, cold_data, cold_size) < 0)
+        flux_log_error (h, "error responding to load request");
+    free (cold_data);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, errstr) < 0)
+        flux_log_error (h, "error responding to load request");
+    free (cold_data);
+}
+
+/* Handle a content-backing.store request.  New blobs always land in
+ * the hot tier; the demotion timer moves them to S3 when idle.
+ */
+void store_cb (flux_t *h,
+               flux_msg_handler_t *mh,
+               const flux_msg_t *msg,
+               void *arg)
+{
+    struct content_tiered *ctx = arg;
+    const void *data;
+    int size;
+    char blobref[BLOBREF_MAX_STRING_SIZE];
+
+    if (flux_request_decode_raw (msg, NULL, &data, &size) < 0)
+        goto error;
+    if (blobref_hash (ctx->hashfun,
+                      (uint8_t *)data,
+                      size,
+                      blobref,
+                      sizeof (blobref)) < 0)
+        goto error;
+    if (hot_store (ctx, blobref, data, size) < 0)
+        goto error;
+    if (flux_respond_raw (h, msg, blobref, strlen (blobref) + 1) < 0)
+        flux_log_error (h, "error responding to store request");
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "error responding to store request");
+}
+
+/* Handle a kvs-checkpoint.get request.  Checkpoints are written
+ * through to the cold tier, so consult S3 directly; they are small
+ * and rarely read (instance restart only).
+ */
+void checkpoint_get_cb (flux_t *h,
+                        flux_msg_handler_t *mh,
+                        const flux_msg_t *msg,
+                        void *arg)
+{
+    struct content_tiered *ctx = arg;
+    const char *errstr = NULL;
+    const char *key;
+    void *data = NULL;
+    char *dup = NULL;
+    size_t size;
+
+    if (flux_request_unpack (msg, NULL, "{s:s}", "key", &key) < 0)
+        goto error;
+    if (s3_get (ctx->cfg, key, &data, &size, &errstr) < 0)
+        goto error;
+    if (!(dup = strndup (data, size)))
+        goto error;
+    if (flux_respond_pack (h,
+                           msg,
+                           "{s:s}",
+                           "value",
+                           size > 0 ? dup : "", 0) < 0)
+        flux_log_error (h, "error responding to kvs-checkpoint.get request");
+    free (data);
+    free (dup);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, errstr) < 0)
+        flux_log_error (h, "error responding to kvs-checkpoint.get request");
+    free (data);
+    free (dup);
+}
+
+/* Handle a kvs-checkpoint.put request.
+ */
+void checkpoint_put_cb (flux_t *h,
+                        flux_msg_handler_t *mh,
+                        const flux_msg_t *msg,
+                        void *arg)
+{
+    struct content_tiered *ctx = arg;
+    const char *key;
+    const char *value;
+    const char *errstr = NULL;
+
+    if (flux_request_unpack (msg,
+                             NULL,
+                             "{s:s s:s}",
+                             "key",
+                             &key,
+                             "value",
+                             &value) < 0)
+        goto error;
+    if (s3_put (ctx->cfg, key, value, strlen (value), &errstr) < 0)
+        goto error;
+    if (flux_respond (h, msg, NULL) < 0)
+        flux_log_error (h, "error responding to kvs-checkpoint.put request");
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, errstr) < 0)
+        flux_log_error (h, "error responding to kvs-checkpoint.put request");
+}
+
+static void content_tiered_closedb (struct content_tiered *ctx)
+{
+    if (ctx) {
+        int saved_errno = errno;
+        if (ctx->load_stmt)
+            sqlite3_finalize (ctx->load_stmt);
+        if (ctx->store_stmt)
+            sqlite3_finalize (ctx->store_stmt);
+        if (ctx->touch_stmt)
+            sqlite3_finalize (ctx->touch_stmt);
+        if (ctx->idle_stmt)
+            sqlite3_finalize (ctx->idle_stmt);
+        if (ctx->drop_stmt)
+            sqlite3_finalize (ctx->drop_stmt);
+        if (ctx->db)
+            sqlite3_close (ctx->db);
+        errno = saved_errno;
+    }
+}
+
+static int content_tiered_opendb (struct content_tiered *ctx)
+{
+    int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
+
+    if (sqlite3_open_v2 (ctx->dbfile, &ctx->db, flags, NULL) != SQLITE_OK) {
+        log_sqlite_error (ctx, "opening %s", ctx->dbfile);
+        goto error;
+    }
+    if (sqlite3_exec (ctx->db,
+                      "PRAGMA journal_mode=WAL",
+                      NULL,
+                      NULL,
+                      NULL) != SQLITE_OK
+        || sqlite3_exec (ctx->db,
+                         "PRAGMA synchronous=OFF",
+                         NULL,
+                         NULL,
+                         NULL) != SQLITE_OK) {
+        log_sqlite_error (ctx, "setting pragmas");
+        goto error;
+    }
+    if (sqlite3_exec (ctx->db,
+                      sql_create_table,
+                      NULL,
+                      NULL,
+                      NULL) != SQLITE_OK) {
+        log_sqlite_error (ctx, "creating object table");
+        goto error;
+    }
+    if (sqlite3_prepare_v2 (ctx->db, sql_load, -1, &ctx->load_stmt, NULL)
+                                                            != SQLITE_OK
+        || sqlite3_prepare_v2 (ctx->db, sql_store, -1, &ctx->store_stmt, NULL)
+                                                            != SQLITE_OK
+        || sqlite3_prepare_v2 (ctx->db, sql_touch, -1, &ctx->touch_stmt, NULL)
+                                                            != SQLITE_OK
+        || sqlite3_prepare_v2 (ctx->db, sql_idle, -1, &ctx->idle_stmt, NULL)
+                                                            != SQLITE_OK
+        || sqlite3_prepare_v2 (ctx->db, sql_drop, -1, &ctx->drop_stmt, NULL)
+                                                            != SQLITE_OK) {
+        log_sqlite_error (ctx, "preparing statements");
+        goto error;
+    }
+    return 0;
+error:
+    set_errno_from_sqlite_error (ctx);
+    return -1;
+}
+
+static void content_tiered_destroy (struct content_tiered *ctx)
+{
+    if (ctx) {
+        int saved_errno = errno;
+        flux_msg_handler_delvec (ctx->handlers);
+        flux_watcher_destroy (ctx->demote_w);
+        if (ctx->cfg) {
+            free (ctx->cfg->bucket);
+            free (ctx->cfg->hostname);
+            free (ctx->cfg->access_key);
+            free (ctx->cfg->secret_key);
+            free (ctx->cfg);
+        }
+        free (ctx->dbfile);
+        free (ctx);
+        errno = saved_errno;
+    }
+    s3_cleanup ();
+}
+
+static int parse_credentials (struct s3_config *cfg, const char *cred_file)
+{
+    struct tomltk_error toml_error;
+    toml_table_t *tbl = NULL;
+    const char *raw;
+    char *access_key;
+    char *secret_key;
+
+    if (!(tbl = tomltk_parse_file (cred_file, &toml_error)))
+        goto inval;
+    if (!(raw = toml_raw_in (tbl, "secret-access-key"))
+        || toml_rtos (raw, &secret_key))
+        goto inval;
+    if (!(raw = toml_raw_in (tbl, "access-key-id"))
+        || toml_rtos (raw, &access_key)) {
+        free (secret_key);
+        goto inval;
+    }
+    cfg->secret_key = secret_key;
+    cfg->access_key = access_key;
+    toml_free (tbl);
+    return 0;
+inval:
+    toml_free (tbl);
+    errno = EINVAL;
+    return -1;
+}
+
+/* Cold tier connection details come from the same [content-s3] config
+ * table used by the content-s3 module, so a site can switch between
+ * the plain and tiered backends without reconfiguring.
+ */
+static struct s3_config *parse_config (const flux_conf_t *conf,
+                                       char *errbuff,
+                                       int eb_size)
+{
+    struct s3_config *cfg;
+    flux_conf_error_t error;
+    const char *uri = NULL;
+    const char *bucket = NULL;
+    const char *cred_file = NULL;
+    int is_virtual_host = 0;
+    struct yuarel yuri;
+    char *cpy = NULL;
+    int saved_errno;
+
+    if (!(cfg = calloc (1, sizeof (*cfg))))
+        return NULL;
+    cfg->retries = 5;
+
+    if (flux_conf_unpack (conf,
+                          &error,
+                          "{s:{s:s, s:s, s:s, s?:b !} }",
+                          "content-s3",
+                          "credential-file",
+                          &cred_file,
+                          "bucket",
+                          &bucket,
+                          "uri",
+                          &uri,
+                          "virtual-host-style",
+                          &is_virtual_host) < 0) {
+        snprintf (errbuff, eb_size, "%s", error.errbuf);
+        goto error;
+    }
+    if (!(cpy = strdup (uri)))
+        goto error;
+    if (yuarel_parse (&yuri, cpy) < 0) {
+        snprintf (errbuff, eb_size, "failed to parse uri");
+        errno = EINVAL;
+        goto error;
+    }
+    if (yuri.port == 0) {
+        if (!(cfg->hostname = strdup (yuri.host)))
+            goto error;
+    }
+    else if (asprintf (&cfg->hostname, "%s:%d", yuri.host, yuri.port) < 0)
+        goto error;
+    if (!(cfg->bucket = strdup (bucket)))
+        goto error;
+    if (!strncmp (yuri.scheme, "https", 5))
+        cfg->is_secure = 1;
+    cfg->is_virtual_host = is_virtual_host;
+    if (parse_credentials (cfg, cred_file) < 0) {
+        snprintf (errbuff, eb_size, "failed to parse credentials");
+        goto error;
+    }
+    free (cpy);
+    return cfg;
+error:
+    saved_errno = errno;
+    free (cpy);
+    free (cfg->bucket);
+    free (cfg->hostname);
+    free (cfg);
+    errno = saved_errno;
+    return NULL;
+}
+
+static int parse_args (flux_t *h,
+                       int argc,
+                       char **argv,
+                       int *ttl,
+                       int *interval)
+{
+    int i;
+    for (i = 0; i < argc; i++) {
+        if (!strncmp (argv[i], "ttl=", 4))
+            *ttl = strtoul (argv[i] + 4, NULL, 10);
+        else if (!strncmp (argv[i], "interval=", 9))
+            *interval = strtoul (argv[i] + 9, NULL, 10);
+        else {
+            errno = EINVAL;
+            flux_log_error (h, "%s", argv[i]);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static const struct flux_msg_handler_spec htab[] = {
+    { FLUX_MSGTYPE_REQUEST, "content-backing.load",    load_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "content-backing.store",   store_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "kvs-checkpoint.get", checkpoint_get_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "kvs-checkpoint.put", checkpoint_put_cb, 0 },
+    FLUX_MSGHANDLER_TABLE_END,
+};
+
+static struct content_tiered *content_tiered_create (flux_t *h)
+{
+    struct content_tiered *ctx;
+    const char *backing_path;
+    const char *errstr = NULL;
+    char errbuff[256];
+
+    if (!(ctx = calloc (1, sizeof (*ctx))))
+        return NULL;
+    ctx->h = h;
+    ctx->ttl = default_ttl;
+    ctx->interval = default_interval;
+
+    if (!(ctx->hashfun = flux_attr_get (h, "content.hash"))) {
+        flux_log_error (h, "content.hash");
+        goto error;
+    }
+    backing_path = flux_attr_get (h, "content.backing-path");
+    if (backing_path) {
+        if (!(ctx->dbfile = strdup (backing_path)))
+            goto error;
+    }
+    else {
+        const char *rundir = flux_attr_get (h, "rundir");
+        if (!rundir) {
+            flux_log_error (h, "rundir");
+            goto error;
+        }
+        if (asprintf (&ctx->dbfile, "%s/content.tiered", rundir) < 0)
+            goto error;
+        if (flux_attr_set (h, "content.backing-path", ctx->dbfile) < 0)
+            goto error;
+    }
+    if (!(ctx->cfg = parse_config (flux_get_conf (h),
+                                   errbuff,
+                                   sizeof (errbuff)))) {
+        flux_log (h, LOG_ERR, "parsing config: %s", errbuff);
+        goto error;
+    }
+    if (s3_init (ctx->cfg, &errstr) < 0) {
+        flux_log (h, LOG_ERR, "s3 init: %s", errstr ? errstr : "error");
+        goto error;
+    }
+    if (s3_bucket_create (ctx->cfg, &errstr) < 0) {
+        flux_log (h, LOG_ERR, "s3 bucket: %s", errstr ? errstr : "error");
+        goto error;
+    }
+    if (flux_msg_handler_addvec (h, htab, ctx, &ctx->handlers) < 0)
+        goto error;
+    return ctx;
+error:
+    content_tiered_destroy (ctx);
+    return NULL;
+}
+
+int mod_main (flux_t *h, int argc, char **argv)
+{
+    struct content_tiered *ctx;
+    int rc = -1;
+
+    if (!(ctx = content_tiered_create (h))) {
+        flux_log_error (h, "content_tiered_create failed");
+        return -1;
+    }
+    if (parse_args (h, argc, argv, &ctx->ttl, &ctx->interval) < 0)
+        goto done;
+    if (content_tiered_opendb (ctx) < 0)
+        goto done;
+    if (!(ctx->demote_w = flux_timer_watcher_create (flux_get_reactor (h),
+                                                     ctx->interval,
+                                                     ctx->interval,
+                                                     demote_cb,
+                                                     ctx)))
+        goto done;
+    flux_watcher_start (ctx->demote_w);
+    if (content_register_backing_store (h, "content-tiered") < 0)
+        goto done;
+    if (content_register_service (h, "content-backing") < 0)
+        goto done;
+    if (content_register_service (h, "kvs-checkpoint") < 0)
+        goto done;
+    if (flux_reactor_run (flux_get_reactor (h), 0) < 0) {
+        flux_log_error (h, "flux_reactor_run");
+        goto done;
+    }
+    if (content_unregister_backing_store (h) < 0)
+        goto done;
+    rc = 0;
+done:
+    content_tiered_closedb (ctx);
+    content_tiered_destroy (ctx);
+    return rc;
+}
+
+MOD_NAME ("content-tiered");
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -23,14 +23,127 @@
 
 struct datetime_entry {
     flux_t *h;
-    flux_watcher_t *w;
+    cron_entry_t *e;
     cronodate_t *d;
+    time_t next;            /* next wakeup (epoch), 0 if not scheduled */
 };
 
+/*  All datetime entries on a handle share one timer, armed for the
+ *   earliest registered wakeup, so entries due in the same second get
+ *   a single reactor wakeup instead of a periodic watcher apiece.
+ */
+struct datetime_sched {
+    flux_t *h;
+    flux_watcher_t *timer;
+    zlist_t *entries;       /* scheduled struct datetime_entry list    */
+};
+
+static const char *sched_auxkey = "cron::datetime_sched";
+
+static void datetime_sched_cb (flux_reactor_t *r, flux_watcher_t *w,
+                               int revents, void *arg);
+
+static void datetime_sched_destroy (struct datetime_sched *sched)
+{
+    if (sched) {
+        flux_watcher_destroy (sched->timer);
+        zlist_destroy (&sched->entries);
+        free (sched);
+    }
+}
+
+static struct datetime_sched *datetime_sched_get (flux_t *h)
+{
+    struct datetime_sched *sched = flux_aux_get (h, sched_auxkey);
+    if (sched == NULL) {
+        if (!(sched = calloc (1, sizeof (*sched))))
+            return (NULL);
+        sched->h = h;
+        if (!(sched->entries = zlist_new ())
+            || !(sched->timer = flux_timer_watcher_create (
+                                               flux_get_reactor (h),
+                                               0., 0.,
+                                               datetime_sched_cb, sched))
+            || flux_aux_set (h, sched_auxkey, sched,
+                             (flux_free_f) datetime_sched_destroy) < 0) {
+            datetime_sched_destroy (sched);
+            return (NULL);
+        }
+    }
+    return (sched);
+}
+
+/*  Re-arm the shared timer for the earliest scheduled wakeup, or stop
+ *   it if nothing is scheduled.
+ */
+static void datetime_sched_rearm (struct datetime_sched *sched)
+{
+    struct datetime_entry *dt;
+    time_t earliest = 0;
+    double after;
+
+    dt = zlist_first (sched->entries);
+    while (dt) {
+        if (dt->next > 0 && (earliest == 0 || dt->next < earliest))
+            earliest = dt->next;
+        dt = zlist_next (sched->entries);
+    }
+    flux_watcher_stop (sched->timer);
+    if (earliest == 0)
+        return;
+    if ((after = (double) earliest - get_timestamp ()) < 0.)
+        after = 0.;
+    flux_timer_watcher_reset (sched->timer, after, 0.);
+    flux_watcher_start (sched->timer);
+}
+
+/*  Schedule the next occurrence for entry `dt`. On failure, log (unless
+ *   the entry has hit its repeat count) and stop the entry.
+ */
+static int datetime_entry_reschedule (struct datetime_entry *dt, time_t now)
+{
+    cron_entry_t *e = dt->e;
+
+    if (cronodate_next_time (dt->d, now, &dt->next) < 0) {
+        if (e->repeat == 0 || e->repeat < e->stats.count + 1) {
+            flux_log_error (dt->h,
+                    "cron-%ju: Unable to get next wakeup. Stopping.", e->id);
+        }
+        dt->next = 0;
+        cron_entry_stop_safe (e);
+        return (-1);
+    }
+    return (0);
+}
+
+static void datetime_sched_cb (flux_reactor_t *r, flux_watcher_t *w,
+                               int revents, void *arg)
+{
+    struct datetime_sched *sched = arg;
+    time_t now = (time_t) get_timestamp ();
+    struct datetime_entry *dt;
+
+    /*  Run every entry due by now in this single wakeup. Any entry stop
+     *   triggered here is deferred to a prepare callback, so the list is
+     *   stable across the loop.
+     */
+    dt = zlist_first (sched->entries);
+    while (dt) {
+        if (dt->next > 0 && dt->next <= now) {
+            if (datetime_entry_reschedule (dt, now) == 0)
+                cron_entry_schedule_task (dt->e);
+        }
+        dt = zlist_next (sched->entries);
+    }
+    datetime_sched_rearm (sched);
+}
+
 void datetime_entry_destroy (struct datetime_entry *dt)
 {
+    struct datetime_sched *sched;
+    if (dt->h && (sched = flux_aux_get (dt->h, sched_auxkey)))
+        zlist_remove (sched->entries, dt);
     dt->h = NULL;
-    flux_watcher_destroy (dt->w);
     cronodate_destroy (dt->d);
     free (dt);
 }
@@ -80,40 +193,34 @@ static struct datetime_entry * datetime_entry_from_json (json_t *o)
 static void cron_datetime_start (void *arg)
 {
     struct datetime_entry *dt = arg;
-    flux_watcher_start (dt->w);
+    struct datetime_sched *sched = datetime_sched_get (dt->h);
+
+    if (sched == NULL) {
+        flux_log_error (dt->h, "cron-%ju: datetime_sched_get", dt->e->id);
+        cron_entry_stop_safe (dt->e);
+        return;
+    }
+    if (datetime_entry_reschedule (dt, (time_t) get_timestamp ()) < 0)
+        return;
+    if (zlist_append (sched->entries, dt) < 0) {
+        flux_log_error (dt->h, "cron-%ju: zlist_append", dt->e->id);
+        dt->next = 0;
+        cron_entry_stop_safe (dt->e);
+        return;
+    }
+    datetime_sched_rearm (sched);
 }
 
 static void cron_datetime_stop (void *arg)
 {
     struct datetime_entry *dt = arg;
-    flux_watcher_stop (dt->w);
-}
-
-void datetime_cb (flux_reactor_t *r, flux_watcher_t *w, int revents, void *arg)
-{
-    cron_entry_t *e = arg;
-    cron_entry_schedule_task (e);
-}
+    struct datetime_sched *sched = flux_aux_get (dt->h, sched_auxkey);
 
-static double reschedule_cb (flux_watcher_t *w, double now, void *arg)
-{
-    cron_entry_t *e = arg;
-    struct datetime_entry *dt = cron_entry_type_data (e);
-    double next = now + cronodate_remaining (dt->d, now);
-    /* If we failed to get next timestamp, push timeout far into the future
-     *  and stop the cron entry in an ev_prepare callback. See ev(7).
-     */
-    if (next < now) {
-        /*  Only issue an error if this entry has more than one repeat:
-         */
-        if (e->repeat == 0 || e->repeat < e->stats.count + 1) {
-            flux_log_error (dt->h,
-                    "cron-%ju: Unable to get next wakeup. Stopping.", e->id);
-        }
-        cron_entry_stop_safe (e);
-        return now + 1.e19;
+    dt->next = 0;
+    if (sched) {
+        zlist_remove (sched->entries, dt);
+        datetime_sched_rearm (sched);
     }
-    return (next);
 }
 
 static void *cron_datetime_create (flux_t *h, cron_entry_t *e, json_t *arg)
@@ -122,15 +229,7 @@ static void *cron_datetime_create (flux_t *h, cron_entry_t *e, json_t *arg)
     if (dt == NULL)
         return (NULL);
     dt->h = h;
-    dt->w = flux_periodic_watcher_create (flux_get_reactor (h),
-                                         0., 0.,
-                                         reschedule_cb,
-                                         datetime_cb, (void *) e);
-    if (dt->w == NULL) {
-        flux_log_error (h, "periodic_watcher_create");
-        datetime_entry_destroy (dt);
-        return (NULL);
-    }
+    dt->e = e;
     return (dt);
 }
 
@@ -139,8 +238,8 @@ static json_t *cron_datetime_to_json (void *arg)
     int i;
     struct datetime_entry *dt = arg;
     json_t *o = json_object ();
-    if (dt->w) {
-        json_t *x = json_real (flux_watcher_next_wakeup (dt->w));
+    if (dt->next > 0) {
+        json_t *x = json_real ((double) dt->next);
         if (x)
             json_object_set_new (o, "next_wakeup", x);
     }
@@ -8,7 +8,19 @@
  * SPDX-License-Identifier: LGPL-3.0
 \************************************************************/
 
-/* job-archive: archive job data service for flux */
+/* job-archive: archive job data service for flux
+ *
+ * Jobs are archived as they complete: the module consumes job-state
+ * events (the same stream job-info's job_state.c follows), fetches a
+ * job's eventlog/jobspec/R once when it transitions to INACTIVE, and
+ * appends a row inside a batched sqlite transaction.  Batches are
+ * committed after BATCH_MAX rows or 'period' seconds, whichever comes
+ * first.  A one-shot backfill at module load picks up jobs that
+ * completed while the module was not loaded.
+ *
+ * Historical queries are answered from sqlite via job-archive.query
+ * without touching the KVS.
+ */
 
 #if HAVE_CONFIG_H
 #include "config.h"
@@ -28,9 +40,12 @@
 
 #include "src/common/libutil/log.h"
 #include "src/common/libutil/fsd.h"
+#include "src/common/libeventlog/eventlog.h"
+#include "src/common/libidset/idset.h"
 
-#define PERIOD_DEFAULT       60.0
+#define PERIOD_DEFAULT       5.0
 #define BUSY_TIMEOUT_DEFAULT 50
+#define BATCH_MAX            64
 #define BUFSIZE              1024
 
 const char *sql_create_table = "CREATE TABLE if not exists jobs("
@@ -59,16 +74,53 @@ const char *sql_store =                               \
 
 const char *sql_since = "SELECT MAX(t_inactive) FROM jobs;";
 
+/* ?1 < 0 disables the userid filter, ?3 <= 0 the 'before' filter,
+ * LIMIT -1 is unlimited.
+ */
+const char *sql_query =
+    "SELECT id,userid,ranks,t_submit,t_sched,t_run,t_cleanup,t_inactive"
+    "  FROM jobs"
+    "  WHERE (?1 < 0 OR userid = ?1)"
+    "    AND t_inactive > ?2"
+    "    AND (?3 <= 0.0 OR t_inactive < ?3)"
+    "  ORDER BY t_inactive DESC LIMIT ?4;";
+
+const char *sql_query_id =
+    "SELECT id,userid,ranks,t_submit,t_sched,t_run,t_cleanup,t_inactive,"
+    "       eventlog,jobspec,R"
+    "  FROM jobs WHERE id = ?1;";
+
 struct job_archive_ctx {
     flux_t *h;
     char *dbpath;
-    double period;
+    double period;              /* max batch commit latency */
     unsigned int busy_timeout;
-    flux_watcher_t *w;
+    flux_watcher_t *commit_w;   /* one-shot batch commit timer */
+    flux_msg_handler_t **handlers;
     sqlite3 *db;
     sqlite3_stmt *store_stmt;
+    sqlite3_stmt *query_stmt;
+    sqlite3_stmt *query_id_stmt;
     double since;
-    int kvs_lookup_count;
+    bool in_transaction;
+    int batch_count;
+};
+
+/* Per-job fetch state, carried through the lookup continuations.
+ */
+struct archive_job {
+    struct job_archive_ctx *ctx;
+    flux_jobid_t id;
+    uint32_t userid;
+    char *ranks;
+    double t_submit;
+    double t_sched;
+    double t_run;
+    double t_cleanup;
+    double t_inactive;
+    char *eventlog;
+    char *jobspec;
+    char *R;
 };
 
 static void log_sqlite_error (struct job_archive_ctx *ctx, const char *fmt, ...)
@@ -93,15 +145,36 @@ static void log_sqlite_error (struct job_archive_ctx *ctx, const char *fmt, ...)
         flux_log (ctx->h, LOG_ERR, "%s: unknown error, no sqlite3 handle", buf);
 }
 
+static void commit_batch (struct job_archive_ctx *ctx)
+{
+    if (ctx->in_transaction) {
+        if (sqlite3_exec (ctx->db, "COMMIT", NULL, NULL, NULL) != SQLITE_OK)
+            log_sqlite_error (ctx, "committing batch");
+        ctx->in_transaction = false;
+        ctx->batch_count = 0;
+        flux_watcher_stop (ctx->commit_w);
+    }
+}
+
 static void job_archive_ctx_destroy (struct job_archive_ctx *ctx)
 {
     if (ctx) {
+        commit_batch (ctx);
         free (ctx->dbpath);
-        flux_watcher_destroy (ctx->w);
+        flux_watcher_destroy (ctx->commit_w);
+        flux_msg_handler_delvec (ctx->handlers);
         if (ctx->store_stmt) {
             if (sqlite3_finalize (ctx->store_stmt) != SQLITE_OK)
                 log_sqlite_error (ctx, "sqlite_finalize store_stmt");
         }
+        if (ctx->query_stmt) {
+            if (sqlite3_finalize (ctx->query_stmt) != SQLITE_OK)
+                log_sqlite_error (ctx, "sqlite_finalize query_stmt");
+        }
+        if (ctx->query_id_stmt) {
+            if (sqlite3_finalize (ctx->query_id_stmt) != SQLITE_OK)
+                log_sqlite_error (ctx, "sqlite_finalize query_id_stmt");
+        }
         if (ctx->db) {
             if (sqlite3_close (ctx->db) != SQLITE_OK)
                 log_sqlite_error (ctx, "sqlite3_close");
@@ -129,6 +202,19 @@ static struct job_archive_ctx * job_archive_ctx_create (flux_t *h)
     return (NULL);
 }
 
+static void archive_job_destroy (struct archive_job *aj)
+{
+    if (aj) {
+        int saved_errno = errno;
+        free (aj->ranks);
+        free (aj->eventlog);
+        free (aj->jobspec);
+        free (aj->R);
+        free (aj);
+        errno = saved_errno;
+    }
+}
+
 int since_cb (void *arg, int argc, char **argv, char **colname)
 {
     struct job_archive_ctx *ctx = arg;
@@ -219,6 +305,22 @@ int job_archive_init (struct job_archive_ctx *ctx)
         log_sqlite_error (ctx, "preparing store stmt");
         goto error;
     }
+    if (sqlite3_prepare_v2 (ctx->db,
+                            sql_query,
+                            -1,
+                            &ctx->query_stmt,
+                            NULL) != SQLITE_OK) {
+        log_sqlite_error (ctx, "preparing query stmt");
+        goto error;
+    }
+    if (sqlite3_prepare_v2 (ctx->db,
+                            sql_query_id,
+                            -1,
+                            &ctx->query_id_stmt,
+                            NULL) != SQLITE_OK) {
+        log_sqlite_error (ctx, "preparing query id stmt");
+        goto error;
+    }
 
     if (job_archive_since_init (ctx) < 0)
         goto error;
@@ -228,74 +330,25 @@ error:
     return rc;
 }
 
-int append_key (struct job_archive_ctx *ctx, json_t *keys, const char *key)
-{
-    json_t *s = NULL;
-    int rc = -1;
-
-    if (!(s = json_string (key))) {
-        flux_log_error (ctx->h, "%s: json_string", __FUNCTION__);
-        goto error;
-    }
-    if (json_array_append_new (keys, s) < 0) {
-        flux_log_error (ctx->h, "%s: json_array_append_new", __FUNCTION__);
-        goto error;
-    }
-    return 0;
-error:
-    json_decref (s);
-    return rc;
-}
-
-void json_decref_wrapper (void *arg)
-{
-    json_decref ((json_t *)arg);
-}
-
-void job_info_lookup_continuation (flux_future_t *f, void *arg)
+/* Append one row inside the open batch transaction, opening one if
+ * necessary.  The batch is committed once BATCH_MAX rows accumulate;
+ * otherwise the commit timer bounds its latency.
+ */
+void store_job (struct job_archive_ctx *ctx, struct archive_job *aj)
 {
-    struct job_archive_ctx *ctx = arg;
-    json_t *job;
-    flux_jobid_t id;
-    uint32_t userid;
-    const char *ranks = NULL;
-    double t_submit = 0.0;
-    double t_sched = 0.0;
-    double t_run = 0.0;
-    double t_cleanup = 0.0;
-    double t_inactive = 0.0;
-    const char *eventlog = NULL;
-    const char *jobspec = NULL;
-    const char *R = NULL;
     char idbuf[64];
 
-    if (flux_rpc_get_unpack (f, "{s:s s:s s?:s}",
-                             "eventlog", &eventlog,
-                             "jobspec", &jobspec,
-                             "R", &R) < 0) {
-        flux_log_error (ctx->h, "%s: flux_rpc_get_unpack", __FUNCTION__);
-        goto out;
-    }
-
-    if (!(job = flux_future_aux_get (f, "job"))) {
-        flux_log_error (ctx->h, "%s: flux_future_aux_get", __FUNCTION__);
-        goto out;
-    }
-
-    if (json_unpack (job, "{s:I s:i s?:s s:f s?:f s?:f s?:f s:f}",
-                     "id", &id,
-                     "userid", &userid,
-                     "ranks", &ranks,
-                     "t_submit", &t_submit,
-                     "t_sched", &t_sched,
-                     "t_run", &t_run,
-                     "t_cleanup", &t_cleanup,
-                     "t_inactive", &t_inactive) < 0) {
-        flux_log (ctx->h, LOG_ERR, "%s: parse job", __FUNCTION__);
-        goto out;
+    if (!ctx->in_transaction) {
+        if (sqlite3_exec (ctx->db, "BEGIN", NULL, NULL, NULL) != SQLITE_OK) {
+            log_sqlite_error (ctx, "store: beginning batch");
+            goto out;
+        }
+        ctx->in_transaction = true;
+        flux_timer_watcher_reset (ctx->commit_w, ctx->period, 0.);
+        flux_watcher_start (ctx->commit_w);
     }
 
-    snprintf (idbuf, 64, "%llu", (unsigned long long)id);
+    snprintf (idbuf, 64, "%llu", (unsigned long long)aj->id);
     if (sqlite3_bind_text (ctx->store_stmt,
                            1,
                            idbuf,
@@ -306,68 +359,68 @@ void job_info_lookup_continuation (flux_future_t *f, void *arg)
     }
     if (sqlite3_bind_int (ctx->store_stmt,
                           2,
-                          userid) != SQLITE_OK) {
+                          aj->userid) != SQLITE_OK) {
         log_sqlite_error (ctx, "store: binding userid");
         goto out;
     }
     if (sqlite3_bind_text (ctx->store_stmt,
                            3,
-                           ranks ? ranks: "",
-                           ranks ? strlen (ranks) : 0,
+                           aj->ranks ? aj->ranks : "",
+                           aj->ranks ? strlen (aj->ranks) : 0,
                            SQLITE_STATIC) != SQLITE_OK) {
         log_sqlite_error (ctx, "store: binding ranks");
         goto out;
     }
     if (sqlite3_bind_double (ctx->store_stmt,
                              4,
-                             t_submit) != SQLITE_OK) {
+                             aj->t_submit) != SQLITE_OK) {
         log_sqlite_error (ctx, "store: binding t_submit");
         goto out;
     }
     if (sqlite3_bind_double (ctx->store_stmt,
                              5,
-                             t_sched) != SQLITE_OK) {
+                             aj->t_sched) != SQLITE_OK) {
         log_sqlite_error (ctx, "store: binding t_sched");
         goto out;
     }
     if (sqlite3_bind_double (ctx->store_stmt,
                              6,
-                             t_run) != SQLITE_OK) {
+                             aj->t_run) != SQLITE_OK) {
         log_sqlite_error (ctx, "store: binding t_run");
         goto out;
     }
     if (sqlite3_bind_double (ctx->store_stmt,
                              7,
-                             t_cleanup) != SQLITE_OK) {
+                             aj->t_cleanup) != SQLITE_OK) {
         log_sqlite_error (ctx, "store: binding t_cleanup");
         goto out;
     }
     if (sqlite3_bind_double (ctx->store_stmt,
                              8,
-                             t_inactive) != SQLITE_OK) {
+                             aj->t_inactive) != SQLITE_OK) {
         log_sqlite_error (ctx, "store: binding t_inactive");
         goto out;
     }
     if (sqlite3_bind_text (ctx->store_stmt,
                            9,
-                           eventlog,
-                           strlen (eventlog),
+                           aj->eventlog,
+                           strlen (aj->eventlog),
                            SQLITE_STATIC) != SQLITE_OK) {
         log_sqlite_error (ctx, "store: binding eventlog");
         goto out;
     }
     if (sqlite3_bind_text (ctx->store_stmt,
                            10,
-                           jobspec,
-                           strlen (jobspec),
+                           aj->jobspec,
+                           strlen (aj->jobspec),
                            SQLITE_STATIC) != SQLITE_OK) {
         log_sqlite_error (ctx, "store: binding jobspec");
         goto out;
     }
     if (sqlite3_bind_text (ctx->store_stmt,
                            11,
-                           R ? R: "",
-                           R ? strlen (R) : 0,
+                           aj->R ? aj->R : "",
+                           aj->R ? strlen (aj->R) : 0,
                            SQLITE_STATIC) != SQLITE_OK) {
         log_sqlite_error (ctx, "store: binding R");
         goto out;
@@ -394,49 +447,204 @@ void job_info_lookup_continuation (flux_future_t *f, void *arg)
         }
     }
 
-    if (t_inactive > ctx->since)
-        ctx->since = t_inactive;
+    if (aj->t_inactive > ctx->since)
+        ctx->since = aj->t_inactive;
+
+    if (++ctx->batch_count >= BATCH_MAX)
+        commit_batch (ctx);
 
 out:
     sqlite3_reset (ctx->store_stmt);
-    flux_future_destroy (f);
-    if (ctx->kvs_lookup_count
-        && (--(ctx->kvs_lookup_count)) == 0) {
-        flux_timer_watcher_reset (ctx->w, ctx->period, 0.);
-        flux_watcher_start (ctx->w);
+}
+
+void commit_timer_cb (flux_reactor_t *r,
+                      flux_watcher_t *w,
+                      int revents,
+                      void *arg)
+{
+    struct job_archive_ctx *ctx = arg;
+
+    commit_batch (ctx);
+}
+
+/* Extract everything the jobs table needs from the eventlog, mirroring
+ * the event-to-timestamp mapping job-info's job_state.c uses.
+ */
+static int eventlog_parse (struct job_archive_ctx *ctx,
+                           struct archive_job *aj)
+{
+    json_t *a = NULL;
+    size_t index;
+    json_t *value;
+    int rc = -1;
+
+    if (!(a = eventlog_decode (aj->eventlog))) {
+        flux_log_error (ctx->h, "%s: error parsing eventlog for %ju",
+                        __FUNCTION__, (uintmax_t)aj->id);
+        goto out;
+    }
+    json_array_foreach (a, index, value) {
+        const char *name;
+        double timestamp;
+        json_t *context = NULL;
+
+        if (eventlog_entry_parse (value, &timestamp, &name, &context) < 0) {
+            flux_log_error (ctx->h, "%s: error parsing entry for %ju",
+                            __FUNCTION__, (uintmax_t)aj->id);
+            goto out;
+        }
+        if (!strcmp (name, "submit")) {
+            int userid;
+            if (json_unpack (context, "{s:i}", "userid", &userid) < 0)
+                goto out;
+            aj->userid = userid;
+            aj->t_submit = timestamp;
+        }
+        else if (!strcmp (name, "depend"))
+            aj->t_sched = timestamp;
+        else if (!strcmp (name, "alloc"))
+            aj->t_run = timestamp;
+        else if (!strcmp (name, "finish")) {
+            if (aj->t_cleanup == 0.)
+                aj->t_cleanup = timestamp;
+        }
+        else if (!strcmp (name, "exception")) {
+            int severity;
+            if (aj->t_cleanup == 0.
+                && json_unpack (context, "{s:i}", "severity", &severity) == 0
+                && severity == 0)
+                aj->t_cleanup = timestamp;
+        }
+        else if (!strcmp (name, "clean"))
+            aj->t_inactive = timestamp;
     }
+    rc = 0;
+out:
+    json_decref (a);
+    return rc;
 }
 
-int job_info_lookup (struct job_archive_ctx *ctx, json_t *job)
+/* Condense R_lite rank strings into the 'ranks' column, as job-info
+ * does for its in-memory jobs.
+ */
+static int R_parse (struct job_archive_ctx *ctx, struct archive_job *aj)
 {
-    const char *topic = "job-info.lookup";
-    flux_future_t *f = NULL;
-    flux_jobid_t id;
-    json_t *keys = NULL;
-    double t_run = 0.0;
+    json_t *o = NULL;
+    json_t *R_lite;
+    struct idset *idset = NULL;
+    size_t index;
+    json_t *value;
+    int rc = -1;
 
-    if (json_unpack (job, "{s:I s?:f}", "id", &id, "t_run", &t_run) < 0) {
-        flux_log (ctx->h, LOG_ERR, "%s: parse t_inactive", __FUNCTION__);
-        goto error;
+    if (!(o = json_loads (aj->R, 0, NULL))
+        || json_unpack (o, "{s:{s:o}}", "execution", "R_lite", &R_lite) < 0) {
+        flux_log (ctx->h, LOG_ERR, "%s: job %ju invalid R",
+                  __FUNCTION__, (uintmax_t)aj->id);
+        goto out;
+    }
+    if (!(idset = idset_create (0, IDSET_FLAG_AUTOGROW)))
+        goto out;
+    json_array_foreach (R_lite, index, value) {
+        const char *ranks = NULL;
+        if (json_unpack (value, "{s:s}", "rank", &ranks) < 0
+            || idset_set_string (idset, ranks) < 0)
+            goto out;
+    }
+    if (!(aj->ranks = idset_encode (idset, IDSET_FLAG_RANGE)))
+        goto out;
+    rc = 0;
+out:
+    idset_destroy (idset);
+    json_decref (o);
+    return rc;
+}
+
+void R_lookup_continuation (flux_future_t *f, void *arg)
+{
+    struct archive_job *aj = arg;
+    struct job_archive_ctx *ctx = aj->ctx;
+    const char *R;
+
+    if (flux_rpc_get_unpack (f, "{s:s}", "R", &R) < 0) {
+        flux_log_error (ctx->h, "%s: error R for %ju",
+                        __FUNCTION__, (uintmax_t)aj->id);
+        goto out;
     }
+    if (!(aj->R = strdup (R)))
+        goto out;
+    (void)R_parse (ctx, aj);
 
-    if (!(keys = json_array ())) {
-        flux_log_error (ctx->h, "%s: json_array", __FUNCTION__);
+    store_job (ctx, aj);
+out:
+    archive_job_destroy (aj);
+    flux_future_destroy (f);
+}
+
+void job_info_lookup_continuation (flux_future_t *f, void *arg)
+{
+    struct archive_job *aj = arg;
+    struct job_archive_ctx *ctx = aj->ctx;
+    const char *eventlog;
+    const char *jobspec;
+
+    if (flux_rpc_get_unpack (f, "{s:s s:s}",
+                             "eventlog", &eventlog,
+                             "jobspec", &jobspec) < 0) {
+        flux_log_error (ctx->h, "%s: flux_rpc_get_unpack", __FUNCTION__);
         goto error;
     }
-    if (append_key (ctx, keys, "eventlog") < 0)
+    if (!(aj->eventlog = strdup (eventlog))
+        || !(aj->jobspec = strdup (jobspec)))
         goto error;
-    if (append_key (ctx, keys, "jobspec") < 0)
+
+    if (eventlog_parse (ctx, aj) < 0)
         goto error;
-    if (t_run > 0.0) {
-        if (append_key (ctx, keys, "R") < 0)
+
+    /* R only exists for jobs that reached RUN state; fetch it before
+     * storing, otherwise store now.
+     */
+    if (aj->t_run > 0.) {
+        flux_future_t *f2;
+        if (!(f2 = flux_rpc_pack (ctx->h, "job-info.lookup",
+                                  FLUX_NODEID_ANY, 0,
+                                  "{s:I s:[s] s:i}",
+                                  "id", aj->id,
+                                  "keys", "R",
+                                  "flags", 0))) {
+            flux_log_error (ctx->h, "%s: flux_rpc_pack", __FUNCTION__);
             goto error;
+        }
+        if (flux_future_then (f2, -1., R_lookup_continuation, aj) < 0) {
+            flux_log_error (ctx->h, "%s: flux_future_then", __FUNCTION__);
+            flux_future_destroy (f2);
+            goto error;
+        }
+        flux_future_destroy (f);
+        return;
     }
 
-    if (!(f = flux_rpc_pack (ctx->h, topic, FLUX_NODEID_ANY, 0,
-                             "{s:I s:O s:i}",
+    store_job (ctx, aj);
+error:
+    archive_job_destroy (aj);
+    flux_future_destroy (f);
+}
+
+/* Fetch and archive one inactive job by id.
+ */
+int archive_job_fetch (struct job_archive_ctx *ctx, flux_jobid_t id)
+{
+    struct archive_job *aj = NULL;
+    flux_future_t *f = NULL;
+
+    if (!(aj = calloc (1, sizeof (*aj))))
+        goto error;
+    aj->ctx = ctx;
+    aj->id = id;
+
+    if (!(f = flux_rpc_pack (ctx->h, "job-info.lookup", FLUX_NODEID_ANY, 0,
+                             "{s:I s:[ss] s:i}",
                              "id", id,
-                             "keys", keys,
+                             "keys", "eventlog", "jobspec",
                              "flags", 0))) {
         flux_log_error (ctx->h, "%s: flux_rpc_pack", __FUNCTION__);
         goto error;
@@ -444,29 +652,58 @@ int job_info_lookup (struct job_archive_ctx *ctx, json_t *job)
     if (flux_future_then (f,
                           -1.,
                           job_info_lookup_continuation,
-                          ctx) < 0) {
+                          aj) < 0) {
         flux_log_error (ctx->h, "%s: flux_future_then", __FUNCTION__);
         goto error;
     }
-    if (flux_future_aux_set (f,
-                             "job",
-                             json_incref (job),
-                             json_decref_wrapper) < 0) {
-        flux_log_error (ctx->h, "%s: flux_future_aux_set", __FUNCTION__);
-        goto error;
-    }
-
-    json_decref (keys);
-    ctx->kvs_lookup_count++;
     return 0;
 
 error:
+    archive_job_destroy (aj);
     flux_future_destroy (f);
-    json_decref (keys);
     return -1;
 }
 
-void job_list_inactive_continuation (flux_future_t *f, void *arg)
+/* Consume the job-state event stream, archiving jobs as they
+ * transition to INACTIVE.
+ */
+void job_state_cb (flux_t *h, flux_msg_handler_t *mh,
+                   const flux_msg_t *msg, void *arg)
+{
+    struct job_archive_ctx *ctx = arg;
+    json_t *transitions;
+    size_t index;
+    json_t *value;
+
+    if (flux_event_unpack (msg, NULL, "{s:o}",
+                           "transitions",
+                           &transitions) < 0) {
+        flux_log_error (h, "%s: flux_event_unpack", __FUNCTION__);
+        return;
+    }
+    if (!json_is_array (transitions)) {
+        flux_log (h, LOG_ERR, "%s: transitions EPROTO", __FUNCTION__);
+        return;
+    }
+    json_array_foreach (transitions, index, value) {
+        json_int_t id;
+        const char *state;
+
+        if (json_unpack (value, "[I,s]", &id, &state) < 0) {
+            flux_log (h, LOG_ERR, "%s: transition EPROTO", __FUNCTION__);
+            return;
+        }
+        if (!strcmp (state, "inactive")) {
+            if (archive_job_fetch (ctx, id) < 0)
+                flux_log_error (h, "%s: archive_job_fetch", __FUNCTION__);
+        }
+    }
+}
+
+/* One-shot backfill of jobs that went inactive while the module was
+ * not loaded (newer than the max t_inactive already archived).
+ */
+void backfill_continuation (flux_future_t *f, void *arg)
 {
     struct job_archive_ctx *ctx = arg;
     json_t *jobs;
@@ -475,38 +712,159 @@ void job_list_inactive_continuation (flux_future_t *f, void *arg)
 
     if (flux_rpc_get_unpack (f, "{s:o}", "jobs", &jobs) < 0) {
         flux_log_error (ctx->h, "%s: flux_rpc_get_unpack", __FUNCTION__);
-        return;
+        goto out;
     }
     json_array_foreach (jobs, index, value) {
-        if (job_info_lookup (ctx, value) < 0)
+        json_int_t id;
+        if (json_unpack (value, "{s:I}", "id", &id) < 0) {
+            flux_log (ctx->h, LOG_ERR, "%s: parse id", __FUNCTION__);
+            break;
+        }
+        if (archive_job_fetch (ctx, id) < 0)
             break;
     }
-    /* If no new inactive jobs, still need to reset timer */
-    if (!ctx->kvs_lookup_count) {
-        flux_timer_watcher_reset (ctx->w, ctx->period, 0.);
-        flux_watcher_start (ctx->w);
-    }
+out:
     flux_future_destroy (f);
 }
 
-void job_archive_cb (flux_reactor_t *r,
-                     flux_watcher_t *w,
-                     int revents,
-                     void *arg)
+int backfill (struct job_archive_ctx *ctx)
 {
-    struct job_archive_ctx *ctx = arg;
-    char *attrs = "[\"userid\", \"ranks\", \"t_submit\", \"t_sched\", " \
-                   "\"t_run\", \"t_cleanup\", \"t_inactive\"]";
     flux_future_t *f;
 
-    if (!(f = flux_job_list_inactive (ctx->h, 0, ctx->since, attrs))) {
+    if (!(f = flux_job_list_inactive (ctx->h, 0, ctx->since, "[]"))) {
         flux_log_error (ctx->h, "%s: flux_job_list_inactive", __FUNCTION__);
-        return;
+        return -1;
     }
-    if (flux_future_then (f, -1, job_list_inactive_continuation, ctx) < 0) {
+    if (flux_future_then (f, -1, backfill_continuation, ctx) < 0) {
         flux_log_error (ctx->h, "%s: flux_future_then", __FUNCTION__);
-        return;
+        flux_future_destroy (f);
+        return -1;
+    }
+    return 0;
+}
+
+/* Build a job object from the current query stmt row.  'full' rows
+ * carry eventlog/jobspec/R in columns 8-10.
+ */
+static json_t *query_row_to_json (sqlite3_stmt *stmt, bool full)
+{
+    json_t *o;
+
+    o = json_pack ("{s:I s:i s:s s:f s:f s:f s:f s:f}",
+                   "id", (json_int_t)strtoull ((const char *)
+                              sqlite3_column_text (stmt, 0), NULL, 10),
+                   "userid", sqlite3_column_int (stmt, 1),
+                   "ranks", (const char *)sqlite3_column_text (stmt, 2),
+                   "t_submit", sqlite3_column_double (stmt, 3),
+                   "t_sched", sqlite3_column_double (stmt, 4),
+                   "t_run", sqlite3_column_double (stmt, 5),
+                   "t_cleanup", sqlite3_column_double (stmt, 6),
+                   "t_inactive", sqlite3_column_double (stmt, 7));
+    if (o && full) {
+        json_t *extra = json_pack ("{s:s s:s s:s}",
+                                   "eventlog",
+                                   (const char *)sqlite3_column_text (stmt, 8),
+                                   "jobspec",
+                                   (const char *)sqlite3_column_text (stmt, 9),
+                                   "R",
+                                   (const char *)sqlite3_column_text (stmt, 10));
+        if (!extra || json_object_update (o, extra) < 0) {
+            json_decref (extra);
+            json_decref (o);
+            return NULL;
+        }
+        json_decref (extra);
+    }
+    return o;
+}
+
+/* job-archive.query - answer historical job queries from sqlite.
+ *
+ * With "id", return the full archived record for one job.  Otherwise
+ * return summary rows filtered by userid/since/before, newest first,
+ * up to max_entries (0=unlimited).
+ */
+void query_cb (flux_t *h, flux_msg_handler_t *mh,
+               const flux_msg_t *msg, void *arg)
+{
+    struct job_archive_ctx *ctx = arg;
+    json_t *jobs = NULL;
+    json_int_t id = -1;
+    int userid = -1;
+    double since = 0.;
+    double before = 0.;
+    int max_entries = 0;
+    sqlite3_stmt *stmt;
+    int ret;
+
+    if (flux_request_unpack (msg, NULL, "{s?:I s?:i s?:F s?:F s?:i}",
+                             "id", &id,
+                             "userid", &userid,
+                             "since", &since,
+                             "before", &before,
+                             "max_entries", &max_entries) < 0)
+        goto error;
+    if (max_entries < 0 || since < 0. || before < 0.) {
+        errno = EPROTO;
+        goto error;
+    }
+    if (!(jobs = json_array ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (id >= 0) {
+        char idbuf[64];
+        stmt = ctx->query_id_stmt;
+        snprintf (idbuf, 64, "%llu", (unsigned long long)id);
+        if (sqlite3_bind_text (stmt, 1, idbuf, strlen (idbuf),
+                               SQLITE_STATIC) != SQLITE_OK) {
+            log_sqlite_error (ctx, "query: binding id");
+            errno = EINVAL;
+            goto error;
+        }
+    }
+    else {
+        stmt = ctx->query_stmt;
+        if (sqlite3_bind_int (stmt, 1, userid) != SQLITE_OK
+            || sqlite3_bind_double (stmt, 2, since) != SQLITE_OK
+            || sqlite3_bind_double (stmt, 3, before) != SQLITE_OK
+            || sqlite3_bind_int (stmt, 4,
+                                 max_entries > 0 ? max_entries
+                                                 : -1) != SQLITE_OK) {
+            log_sqlite_error (ctx, "query: binding filters");
+            errno = EINVAL;
+            goto error;
+        }
+    }
+    while ((ret = sqlite3_step (stmt)) == SQLITE_ROW) {
+        json_t *o;
+        if (!(o = query_row_to_json (stmt, id >= 0))
+            || json_array_append_new (jobs, o) < 0) {
+            json_decref (o);
+            sqlite3_reset (stmt);
+            errno = ENOMEM;
+            goto error;
+        }
+    }
+    sqlite3_reset (stmt);
+    if (ret != SQLITE_DONE) {
+        log_sqlite_error (ctx, "query: executing stmt");
+        errno = EINVAL;
+        goto error;
+    }
+
+    if (flux_respond_pack (h, msg, "{s:O}", "jobs", jobs) < 0) {
+        flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+        goto error;
     }
+
+    json_decref (jobs);
+    return;
+
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+    json_decref (jobs);
 }
 
 static void process_config (struct job_archive_ctx *ctx, int ac, char **av)
@@ -559,6 +917,12 @@ static void process_config (struct job_archive_ctx *ctx, int ac, char **av)
     }
 }
 
+static const struct flux_msg_handler_spec htab[] = {
+    { FLUX_MSGTYPE_EVENT,   "job-state",         job_state_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "job-archive.query", query_cb, FLUX_ROLE_USER },
+    FLUX_MSGHANDLER_TABLE_END,
+};
+
 int mod_main (flux_t *h, int ac, char **av)
 {
     struct job_archive_ctx *ctx = job_archive_ctx_create (h);
@@ -574,16 +938,24 @@ int mod_main (flux_t *h, int ac, char **av)
         if (job_archive_init (ctx) < 0)
             goto done;
 
-        if ((ctx->w = flux_timer_watcher_create (flux_get_reactor (h),
-                                                 ctx->period,
-                                                 0.,
-                                                 job_archive_cb,
-                                                 ctx)) < 0) {
+        if (!(ctx->commit_w = flux_timer_watcher_create (flux_get_reactor (h),
+                                                         ctx->period,
+                                                         0.,
+                                                         commit_timer_cb,
+                                                         ctx))) {
             flux_log_error (h, "flux_timer_watcher_create");
             goto done;
         }
-
-        flux_watcher_start (ctx->w);
+        if (flux_event_subscribe (h, "job-state") < 0) {
+            flux_log_error (h, "flux_event_subscribe");
+            goto done;
+        }
+        if (flux_msg_handler_addvec (h, htab, ctx, &ctx->handlers) < 0) {
+            flux_log_error (h, "flux_msg_handler_addvec");
+            goto done;
+        }
+        if (backfill (ctx) < 0)
+            goto done;
     }
 
     if ((rc = flux_reactor_run (flux_get_reactor (h), 0)) < 0)
@@ -48,6 +48,7 @@ struct bulk_exec {
 
     struct idset *exit_batch;         /* Support for batched exit notify */
     flux_watcher_t *exit_batch_timer; /* Timer for batched exit notify */
+    double exit_batch_window;         /* Exit batch coalescing period (s) */
 
     flux_subprocess_ops_t ops;
 
@@ -132,9 +133,8 @@ static void exit_batch_append (struct bulk_exec *exec, flux_subprocess_t *p)
     }
     if (!exec->exit_batch_timer) {
         flux_reactor_t *r = flux_get_reactor (exec->h);
-        /*  XXX: batch timer should eventually be configurable by caller */
         exec->exit_batch_timer =
-            flux_timer_watcher_create (r, 0.01, 0.,
+            flux_timer_watcher_create (r, exec->exit_batch_window, 0.,
                                        exit_batch_cb,
                                        exec);
         if (!exec->exit_batch_timer) {
@@ -385,11 +385,29 @@ struct bulk_exec * bulk_exec_create (struct bulk_exec_ops *ops, void *arg)
     exec->processes = zlist_new ();
     exec->commands = zlist_new ();
     exec->exit_batch = idset_create (0, IDSET_FLAG_AUTOGROW);
-    exec->max_start_per_loop = 1;
+
+    /*  Submit rexec requests in batches so that RPCs for a large job
+     *   are pipelined to the remote ranks, while still returning to the
+     *   reactor periodically so responses and other events are serviced
+     *   during a lengthy launch.
+     */
+    exec->max_start_per_loop = 128;
+
+    exec->exit_batch_window = 0.01;
 
     return exec;
 }
 
+int bulk_exec_set_exit_batch_window (struct bulk_exec *exec, double window)
+{
+    if (window < 0.) {
+        errno = EINVAL;
+        return -1;
+    }
+    exec->exit_batch_window = window;
+    return 0;
+}
+
 int bulk_exec_set_max_per_loop (struct bulk_exec *exec, int max)
 {
     if (max == 0) {
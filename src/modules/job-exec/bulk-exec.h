@@ -55,6 +55,12 @@ int bulk_exec_aux_set (struct bulk_exec *exec,
  */
 int bulk_exec_set_max_per_loop (struct bulk_exec *exec, int max);
 
+/*  Set the period in seconds over which process exits are coalesced
+ *   into a single on_exit notification with an idset of exited ranks.
+ *   (default 0.01s. 0. notifies on the next reactor loop iteration)
+ */
+int bulk_exec_set_exit_batch_window (struct bulk_exec *exec, double window);
+
 void bulk_exec_destroy (struct bulk_exec *exec);
 
 int bulk_exec_push_cmd (struct bulk_exec *exec,
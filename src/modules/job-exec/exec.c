@@ -189,6 +189,15 @@ static int exec_init (struct jobinfo *job)
         flux_log_error (job->h, "exec_init: bulk_exec_create");
         goto err;
     }
+    /*  Widen the exit coalescing window for large jobs so the exit wave
+     *   of many shells is reduced to a handful of notifications at this
+     *   rank, rather than one per shell.
+     */
+    if (idset_count (ranks) > 64
+        && bulk_exec_set_exit_batch_window (exec, 0.1) < 0) {
+        flux_log_error (job->h, "exec_init: bulk_exec_set_exit_batch_window");
+        goto err;
+    }
     if (!(conf = exec_conf_create (job->jobspec))) {
         flux_log_error (job->h, "exec_init: exec_conf_create");
         goto err;
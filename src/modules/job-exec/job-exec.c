@@ -66,6 +66,18 @@
  *  - the final "release final=true" response is sent to the job manager
  *  - the local job object is destroyed
  *
+ * FAST PATH
+ *
+ * Sub-second jobs can be dominated by the serialized KVS commits for
+ * exec eventlog events.  A job with attributes.system.exec.fastpath
+ * set true buffers intermediate events (cleanup.start, cleanup.finish,
+ * and the usual fire-and-forget events) in memory and commits them in
+ * one batch at job completion, together with the terminating "done"
+ * event.  Responses to the job-manager ("start", "finish", exceptions)
+ * are direct RPCs in either mode, so the job-manager's view of the job
+ * is not delayed; only persistence of intermediate eventlog entries is
+ * deferred.
+ *
  * TEST CONFIGURATION
  *
  * The job-exec module supports an object in the jobspec under
@@ -97,13 +109,21 @@
 #include <flux/core.h>
 
 #include "src/common/libjob/job_hash.h"
+#include "src/common/libjob/jobspec_cache.h"
 #include "src/common/libeventlog/eventlog.h"
+#include "src/common/libeventlog/eventlogger.h"
 #include "src/common/libutil/fsd.h"
 #include "src/common/libutil/errno_safe.h"
 #include "job-exec.h"
 
 static double kill_timeout=5.0;
 
+/* Fast path jobs buffer eventlog entries until job completion; the
+ * batch timeout is only a safety net bounding how long entries can sit
+ * unpersisted if a job hangs.
+ */
+static double fastpath_batch_timeout = 30.;
+
 extern struct exec_implementation testexec;
 extern struct exec_implementation bulkexec;
 
@@ -139,6 +159,7 @@ void jobinfo_decref (struct jobinfo *job)
         free (job->J);
         resource_set_destroy (job->R);
         json_decref (job->jobspec);
+        eventlogger_destroy (job->ev);
         free (job);
         errno = saved_errno;
     }
@@ -151,6 +172,42 @@ static struct jobinfo * jobinfo_new (void)
     return job;
 }
 
+/* Fire-and-forget events are batched per job (one eventlogger per
+ * guest namespace) so bursts like starting/complete share one KVS
+ * commit.  The busy/idle ops hold a job reference while commits are
+ * in flight, keeping the namespace alive.  Events emitted through
+ * jobinfo_emit_event_vpack() below flush this batch first so eventlog
+ * entries always land in emission order.
+ */
+static void emit_eventlogger_busy (struct eventlogger *ev, void *arg)
+{
+    jobinfo_incref (arg);
+}
+
+static void emit_eventlogger_idle (struct eventlogger *ev, void *arg)
+{
+    jobinfo_decref (arg);
+}
+
+static struct eventlogger *jobinfo_eventlogger (struct jobinfo *job)
+{
+    if (!job->ev) {
+        struct eventlogger_ops ops = {
+            .busy = emit_eventlogger_busy,
+            .idle = emit_eventlogger_idle,
+        };
+        double timeout = job->fastpath ? fastpath_batch_timeout : 0.01;
+        if (!(job->ev = eventlogger_create (job->ctx->h, timeout, &ops, job)))
+            return NULL;
+        if (eventlogger_set_namespace (job->ev, job->ns) < 0) {
+            eventlogger_destroy (job->ev);
+            job->ev = NULL;
+            return NULL;
+        }
+    }
+    return job->ev;
+}
+
 /*  Emit an event to the exec system eventlog and return a future from
  *   flux_kvs_commit().
  */
@@ -167,7 +224,13 @@ static flux_future_t * jobinfo_emit_event_vpack (struct jobinfo *job,
     char *entrystr = NULL;
     const char *key = "exec.eventlog";
 
-    if (!(entry = eventlog_entry_vpack (0., name, fmt, ap))) {
+    /* Flush any batched nowait events first so this entry is applied
+     * to the eventlog after them (KVS commits apply in order).
+     */
+    if (job->ev && eventlogger_flush_async (job->ev) < 0)
+        flux_log_error (h, "emit event: eventlogger_flush_async");
+    if (!(entry = eventlog_entry_vpack (flux_reactor_now (flux_get_reactor (h)),
+                                        name, fmt, ap))) {
         flux_log_error (h, "emit event: eventlog_entry_vpack");
         return NULL;
     }
@@ -206,34 +269,34 @@ static flux_future_t * jobinfo_emit_event_pack (struct jobinfo *job,
     return f;
 }
 
-static void emit_event_continuation (flux_future_t *f, void *arg)
-{
-    struct jobinfo *job = arg;
-    if (flux_future_get (f, NULL) < 0)
-        flux_log_error (job->ctx->h, "%ju: emit_event", job->id);
-    flux_future_destroy (f);
-    jobinfo_decref (job);
-}
-
 static int jobinfo_emit_event_vpack_nowait (struct jobinfo *job,
                                             const char *name,
                                             const char *fmt,
                                             va_list ap)
 {
-    flux_future_t *f = jobinfo_emit_event_vpack (job, name, fmt, ap);
-    if (f == NULL)
+    flux_t *h = job->ctx->h;
+    struct eventlogger *ev;
+    json_t *entry = NULL;
+    int rc = -1;
+
+    if (!(ev = jobinfo_eventlogger (job))) {
+        flux_log_error (h, "emit event: eventlogger_create");
         return -1;
-    jobinfo_incref (job);
-    if (flux_future_then (f, -1., emit_event_continuation, job) < 0) {
-        flux_log_error (job->ctx->h, "jobinfo_emit_event");
-        goto error;
     }
-    return 0;
-error:
-    jobinfo_decref (job);
-    flux_future_destroy (f);
-    return -1;
-
+    if (!(entry = eventlog_entry_vpack (flux_reactor_now (flux_get_reactor (h)),
+                                        name, fmt, ap))) {
+        flux_log_error (h, "emit event: eventlog_entry_vpack");
+        return -1;
+    }
+    if (eventlogger_append_entry (ev, EVENTLOGGER_FLAG_ASYNC,
+                                  "exec.eventlog", entry) < 0) {
+        flux_log_error (h, "emit event: eventlogger_append_entry");
+        goto out;
+    }
+    rc = 0;
+out:
+    json_decref (entry);
+    return rc;
 }
 
 /*
@@ -532,6 +595,29 @@ void jobinfo_cleanup_complete (struct jobinfo *job,
      *   future and errno if rc < 0 for informational purposes,
      *   but do not generate an exception.
      */
+
+    /* Fast path: buffer the event and finalize immediately.  The
+     * terminating "done" event commit flushes the batch first, so the
+     * eventlog is complete and ordered before the namespace moves.
+     */
+    if (job->fastpath) {
+        if (rc < 0)
+            jobinfo_emit_event_pack_nowait (job, "cleanup.finish",
+                                            "{ s:s s:i s:s }",
+                                            "ranks", "all",
+                                            "rc", rc,
+                                            "note", strerror (errno));
+        else
+            jobinfo_emit_event_pack_nowait (job, "cleanup.finish",
+                                            "{ s:s s:i }",
+                                            "ranks", "all",
+                                            "rc", rc);
+        if (jobinfo_finalize (job) < 0) {
+            flux_log_error (job->h, "jobinfo_cleanup_complete: finalize");
+            jobinfo_decref (job);
+        }
+        return;
+    }
     if (rc < 0)
         f = jobinfo_emit_event_pack (job, "cleanup.finish",
                                      "{ s:s s:i s:s }",
@@ -570,6 +656,17 @@ static void jobinfo_start_cleanup (struct jobinfo *job,
 
     /* XXX: idset ignored for now */
 
+    /* Fast path: buffer the event and start cleanup immediately rather
+     * than waiting out a KVS commit.
+     */
+    if (job->fastpath) {
+        jobinfo_emit_event_pack_nowait (job, "cleanup.start",
+                                        "{ s:s }",
+                                        "ranks", "all");
+        if ((*job->impl->cleanup) (job, NULL) < 0)
+            flux_log_error (job->h, "%s: cleanup()", job->impl->name);
+        return;
+    }
     if (!(f = jobinfo_emit_event_pack (job, "cleanup.start",
                                             "{ s:s }",
                                             "ranks", "all"))) {
@@ -787,6 +884,7 @@ static void jobinfo_start_continue (flux_future_t *f, void *arg)
     json_error_t error;
     const char *R = NULL;
     const char *jobspec = NULL;
+    int fastpath = 0;
     struct jobinfo *job = arg;
 
     if (flux_future_get (flux_future_get_child (f, "ns"), NULL) < 0) {
@@ -822,10 +920,20 @@ static void jobinfo_start_continue (flux_future_t *f, void *arg)
             goto done;
         }
     }
-    if (!(job->jobspec = json_loads (jobspec, 0, &error))) {
+    /*  The parse is served from the shared per-thread jobspec cache,
+     *   so jobs with byte-identical jobspecs share one immutable
+     *   parsed object.
+     */
+    if (!(job->jobspec = jobspec_cache_parse (jobspec,
+                                              strlen (jobspec),
+                                              &error))) {
         jobinfo_fatal_error (job, errno, "reading jobspec: %s", error.text);
         goto done;
     }
+    (void)json_unpack (job->jobspec, "{s:{s:{s:{s:b}}}}",
+                       "attributes", "system", "exec",
+                       "fastpath", &fastpath);
+    job->fastpath = fastpath ? 1 : 0;
     if (jobinfo_load_implementation (job) < 0) {
         jobinfo_fatal_error (job, errno, "failed to initialize implementation");
         goto done;
@@ -1060,6 +1168,7 @@ static void job_exec_ctx_destroy (struct job_exec_ctx *ctx)
     if (ctx == NULL)
         return;
     zhashx_destroy (&ctx->jobs);
+    jobspec_cache_purge ();
     flux_msg_handler_delvec (ctx->handlers);
     free (ctx);
 }
@@ -20,6 +20,7 @@
 
 struct job_exec_ctx;
 struct jobinfo;
+struct eventlogger;
 
 /*  Exec implementation interface:
  *
@@ -71,6 +72,7 @@ struct jobinfo {
     uint8_t               multiuser:1;
     uint8_t               has_namespace:1;
     uint8_t               exception_in_progress:1;
+    uint8_t               fastpath:1;      /* defer eventlog commits    */
 
     uint8_t               started:1;     /* some or all shells are starting */
     uint8_t               running:1;     /* all shells are running */
@@ -89,6 +91,7 @@ struct jobinfo {
     /* Private job-exec module data */
     int                   refcount;
     struct job_exec_ctx * ctx;
+    struct eventlogger *  ev;        /* batches nowait eventlog appends */
 };
 
 void jobinfo_incref (struct jobinfo *job);
@@ -20,6 +20,52 @@
 #include "allow.h"
 
 #include "src/common/libeventlog/eventlog.h"
+#include "src/common/libjob/job_hash.h"
+
+/* A job's userid never changes, so remember it after the first access
+ * check rather than re-parsing the eventlog on every guest request.
+ * If an unlikely mix of jobs overflows the cap, start over.
+ */
+static const size_t owner_cache_max = 10000;
+
+struct owner {
+    flux_jobid_t id;
+    int userid;
+};
+
+static void owner_destroy (void **item)
+{
+    if (item) {
+        free (*item);
+        *item = NULL;
+    }
+}
+
+int owner_cache_setup (struct info_ctx *ctx)
+{
+    if (!(ctx->owner_cache = job_hash_create ()))
+        return -1;
+    zhashx_set_destructor (ctx->owner_cache, owner_destroy);
+    return 0;
+}
+
+/* Best effort - a failed insert only costs a re-parse later.
+ */
+static void owner_cache_insert (struct info_ctx *ctx,
+                                flux_jobid_t id,
+                                int userid)
+{
+    struct owner *o;
+
+    if (zhashx_size (ctx->owner_cache) >= owner_cache_max)
+        zhashx_purge (ctx->owner_cache);
+    if (!(o = calloc (1, sizeof (*o))))
+        return;
+    o->id = id;
+    o->userid = userid;
+    if (zhashx_insert (ctx->owner_cache, &o->id, o) < 0)
+        free (o);
+}
 
 /* Parse the submit userid from the event log.
  * Assume "submit" is the first event.
@@ -27,22 +73,18 @@
 static int eventlog_get_userid (struct info_ctx *ctx, const char *s,
                                 int *useridp)
 {
-    json_t *a = NULL;
     json_t *entry = NULL;
     const char *name = NULL;
     json_t *context = NULL;
     int rv = -1;
 
-    if (!(a = eventlog_decode (s))) {
-        flux_log_error (ctx->h, "%s: eventlog_decode", __FUNCTION__);
-        goto error;
-    }
-    if (!(entry = json_array_get (a, 0))) {
-        errno = EINVAL;
+    if (!(entry = eventlog_first_entry_decode (s))) {
+        flux_log_error (ctx->h, "%s: eventlog_first_entry_decode",
+                        __FUNCTION__);
         goto error;
     }
     if (eventlog_entry_parse (entry, NULL, &name, &context) < 0) {
-        flux_log_error (ctx->h, "%s: eventlog_decode", __FUNCTION__);
+        flux_log_error (ctx->h, "%s: eventlog_entry_parse", __FUNCTION__);
         goto error;
     }
     if (strcmp (name, "submit") != 0 || !context) {
@@ -56,7 +98,7 @@ static int eventlog_get_userid (struct info_ctx *ctx, const char *s,
     }
     rv = 0;
 error:
-    json_decref (a);
+    json_decref (entry);
     return rv;
 }
 
@@ -64,16 +106,23 @@ error:
  * Avoid calling eventlog_get_userid() if message cred has OWNER role.
  */
 int eventlog_allow (struct info_ctx *ctx, const flux_msg_t *msg,
-                    const char *s)
+                    flux_jobid_t id, const char *s)
 {
     struct flux_msg_cred cred;
-    int job_user;
 
     if (flux_msg_get_cred (msg, &cred) < 0)
         return -1;
     if (!(cred.rolemask & FLUX_ROLE_OWNER)) {
-        if (eventlog_get_userid (ctx, s, &job_user) < 0)
-            return -1;
+        struct owner *o;
+        int job_user;
+
+        if ((o = zhashx_lookup (ctx->owner_cache, &id)))
+            job_user = o->userid;
+        else {
+            if (eventlog_get_userid (ctx, s, &job_user) < 0)
+                return -1;
+            owner_cache_insert (ctx, id, job_user);
+        }
         if (flux_msg_cred_authorize (cred, job_user) < 0)
             return -1;
     }
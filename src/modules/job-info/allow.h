@@ -16,11 +16,16 @@
 #include "info.h"
 
 /* Determine if user who sent request 'msg' is allowed to
- * access job eventlog 's'.  Assume first event is the "submit"
+ * access eventlog 's' of job 'id'.  Assume first event is the "submit"
  * event which records the job owner.
  */
 int eventlog_allow (struct info_ctx *ctx, const flux_msg_t *msg,
-                    const char *s);
+                    flux_jobid_t id, const char *s);
+
+/* Create the cache of job owners consulted by eventlog_allow().
+ * Returns 0 on success, -1 on failure with errno set.
+ */
+int owner_cache_setup (struct info_ctx *ctx);
 
 #endif /* ! _FLUX_JOB_INFO_ALLOW_H */
 
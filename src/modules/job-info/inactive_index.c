@@ -0,0 +1,327 @@
+/************************************************************\
+ * Copyright 2020 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* inactive_index.c - columnar on-disk index of inactive jobs */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <czmq.h>
+#include <flux/core.h>
+
+#include "src/common/libutil/errno_safe.h"
+
+#include "inactive_index.h"
+
+struct inactive_index {
+    flux_t *h;
+    char *idx_path;
+    char *names_path;
+    FILE *idx_f;            /* append handle for records */
+    FILE *names_f;          /* append handle for string table */
+    char *names;            /* in-memory copy of string table */
+    size_t names_len;
+    size_t names_size;
+    zhash_t *names_hash;    /* name -> offset + 1 */
+    size_t count;           /* records on disk */
+    double last_t_inactive; /* timestamp of last appended record */
+};
+
+void inactive_index_destroy (struct inactive_index *idx)
+{
+    if (idx) {
+        int saved_errno = errno;
+        if (idx->idx_f)
+            fclose (idx->idx_f);
+        if (idx->names_f)
+            fclose (idx->names_f);
+        zhash_destroy (&idx->names_hash);
+        free (idx->names);
+        free (idx->idx_path);
+        free (idx->names_path);
+        free (idx);
+        errno = saved_errno;
+    }
+}
+
+/* Add 'name' (already present in idx->names at 'offset') to the
+ * dedup hash.  Offsets are stashed directly in the hash value,
+ * shifted by one so offset 0 is distinguishable from a miss.
+ */
+static int names_hash_insert (struct inactive_index *idx,
+                              const char *name,
+                              size_t offset)
+{
+    return zhash_insert (idx->names_hash, name,
+                         (void *)(uintptr_t)(offset + 1));
+}
+
+/* Load the string table into memory and rebuild the dedup hash.
+ * An empty/missing table is seeded with "" at offset 0 so records
+ * for nameless jobs have somewhere to point.
+ */
+static int names_load (struct inactive_index *idx)
+{
+    FILE *f;
+    long size;
+    size_t offset;
+
+    if (!(f = fopen (idx->names_path, "r"))) {
+        if (errno != ENOENT)
+            return -1;
+        size = 0;
+    }
+    else {
+        if (fseek (f, 0, SEEK_END) < 0 || (size = ftell (f)) < 0) {
+            fclose (f);
+            return -1;
+        }
+        rewind (f);
+    }
+    idx->names_size = size + 1;
+    if (!(idx->names = malloc (idx->names_size))) {
+        if (f)
+            fclose (f);
+        return -1;
+    }
+    if (f) {
+        if (fread (idx->names, 1, size, f) != (size_t)size) {
+            fclose (f);
+            errno = EIO;
+            return -1;
+        }
+        fclose (f);
+    }
+    idx->names_len = size;
+    /* Defend against a torn final entry - drop anything after the
+     * last NUL so offsets never reference an unterminated string.
+     */
+    while (idx->names_len > 0 && idx->names[idx->names_len - 1] != '\0')
+        idx->names_len--;
+    if (idx->names_len == 0) {
+        if (fputc ('\0', idx->names_f) == EOF || fflush (idx->names_f) < 0)
+            return -1;
+        idx->names[0] = '\0';
+        idx->names_len = 1;
+    }
+    offset = 0;
+    while (offset < idx->names_len) {
+        if (names_hash_insert (idx, idx->names + offset, offset) < 0
+            && !zhash_lookup (idx->names_hash, idx->names + offset)) {
+            errno = ENOMEM;
+            return -1;
+        }
+        offset += strlen (idx->names + offset) + 1;
+    }
+    return 0;
+}
+
+/* Validate the record file, truncating a torn final record, and
+ * recover the count and last timestamp.
+ */
+static int records_load (struct inactive_index *idx)
+{
+    struct inactive_index_record rec;
+    long size;
+
+    if (fseek (idx->idx_f, 0, SEEK_END) < 0
+        || (size = ftell (idx->idx_f)) < 0)
+        return -1;
+    if (size % sizeof (rec) != 0) {
+        flux_log (idx->h, LOG_ERR,
+                  "inactive index: truncating torn record in %s",
+                  idx->idx_path);
+        size -= size % sizeof (rec);
+        if (ftruncate (fileno (idx->idx_f), size) < 0)
+            return -1;
+    }
+    idx->count = size / sizeof (rec);
+    if (idx->count > 0) {
+        FILE *f;
+        if (!(f = fopen (idx->idx_path, "r")))
+            return -1;
+        if (fseek (f, (idx->count - 1) * sizeof (rec), SEEK_SET) < 0
+            || fread (&rec, sizeof (rec), 1, f) != 1) {
+            fclose (f);
+            errno = EIO;
+            return -1;
+        }
+        fclose (f);
+        idx->last_t_inactive = rec.t_inactive;
+    }
+    return 0;
+}
+
+struct inactive_index *inactive_index_create (flux_t *h, const char *dir)
+{
+    struct inactive_index *idx;
+
+    if (!h || !dir) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(idx = calloc (1, sizeof (*idx))))
+        return NULL;
+    idx->h = h;
+    if (asprintf (&idx->idx_path, "%s/inactive.idx", dir) < 0) {
+        idx->idx_path = NULL;
+        goto error;
+    }
+    if (asprintf (&idx->names_path, "%s/inactive.names", dir) < 0) {
+        idx->names_path = NULL;
+        goto error;
+    }
+    if (!(idx->names_hash = zhash_new ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (!(idx->idx_f = fopen (idx->idx_path, "a")))
+        goto error;
+    if (!(idx->names_f = fopen (idx->names_path, "a")))
+        goto error;
+    if (names_load (idx) < 0)
+        goto error;
+    if (records_load (idx) < 0)
+        goto error;
+    return idx;
+error:
+    inactive_index_destroy (idx);
+    return NULL;
+}
+
+/* Return the string table offset for 'name', appending it to the
+ * table (disk and memory) if not yet present.
+ */
+static int name_to_offset (struct inactive_index *idx,
+                           const char *name,
+                           uint64_t *offset)
+{
+    void *val;
+    size_t len = strlen (name) + 1;
+
+    if ((val = zhash_lookup (idx->names_hash, name))) {
+        *offset = (uintptr_t)val - 1;
+        return 0;
+    }
+    if (idx->names_len + len > idx->names_size) {
+        size_t nsize = (idx->names_size + len) * 2;
+        char *nnames;
+        if (!(nnames = realloc (idx->names, nsize)))
+            return -1;
+        idx->names = nnames;
+        idx->names_size = nsize;
+    }
+    if (fwrite (name, 1, len, idx->names_f) != len
+        || fflush (idx->names_f) < 0)
+        return -1;
+    memcpy (idx->names + idx->names_len, name, len);
+    if (names_hash_insert (idx, idx->names + idx->names_len,
+                           idx->names_len) < 0) {
+        errno = ENOMEM;
+        return -1;
+    }
+    *offset = idx->names_len;
+    idx->names_len += len;
+    return 0;
+}
+
+int inactive_index_append (struct inactive_index *idx, struct job *job)
+{
+    struct inactive_index_record rec;
+
+    if (!idx || !job) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (job->t_inactive <= idx->last_t_inactive)
+        return 0;
+    memset (&rec, 0, sizeof (rec));
+    rec.id = job->id;
+    rec.userid = job->userid;
+    rec.result = job->result;
+    rec.t_submit = job->t_submit;
+    rec.t_run = job->t_run;
+    rec.t_inactive = job->t_inactive;
+    if (name_to_offset (idx, job->name ? job->name : "",
+                        &rec.name_offset) < 0)
+        return -1;
+    if (fwrite (&rec, sizeof (rec), 1, idx->idx_f) != 1
+        || fflush (idx->idx_f) < 0)
+        return -1;
+    idx->count++;
+    idx->last_t_inactive = job->t_inactive;
+    return 0;
+}
+
+int inactive_index_scan (struct inactive_index *idx,
+                         uint32_t userid,
+                         int results,
+                         double since,
+                         double before,
+                         inactive_index_f cb,
+                         void *arg)
+{
+    struct inactive_index_record rec;
+    FILE *f;
+    size_t i;
+    int rc = -1;
+
+    if (!idx || !cb) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (idx->count == 0)
+        return 0;
+    /* Scan with an independent read handle so concurrent appends
+     * don't perturb the append handle's position.  Records past
+     * the count snapshotted here are newer than this scan.
+     */
+    if (!(f = fopen (idx->idx_path, "r")))
+        return -1;
+    for (i = idx->count; i > 0; i--) {
+        int n;
+        if (fseek (f, (i - 1) * sizeof (rec), SEEK_SET) < 0
+            || fread (&rec, sizeof (rec), 1, f) != 1) {
+            errno = EIO;
+            goto done;
+        }
+        if (since > 0. && rec.t_inactive <= since)
+            break;  /* records are in t_inactive order - nothing older */
+        if (before > 0. && rec.t_inactive >= before)
+            continue;
+        if (userid != FLUX_USERID_UNKNOWN && rec.userid != userid)
+            continue;
+        if (!(rec.result & results))
+            continue;
+        if (rec.name_offset >= idx->names_len) {
+            errno = EINVAL;
+            goto done;
+        }
+        if ((n = cb (&rec, idx->names + rec.name_offset, arg)) != 0) {
+            if (n < 0)
+                goto done;
+            break;
+        }
+    }
+    rc = 0;
+done:
+    ERRNO_SAFE_WRAP (fclose, f);
+    return rc;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
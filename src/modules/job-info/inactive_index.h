@@ -0,0 +1,87 @@
+/************************************************************\
+ * Copyright 2020 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _FLUX_JOB_INFO_INACTIVE_INDEX_H
+#define _FLUX_JOB_INFO_INACTIVE_INDEX_H
+
+#include <stdint.h>
+#include <flux/core.h>
+
+#include "job_state.h"
+
+/* On-disk index of inactive jobs, so listing queries over job history
+ * need not materialize full job metadata.  Two files are kept under
+ * the index directory:
+ *
+ * - inactive.idx - append-only array of fixed-width records holding
+ *   the columns queries filter and sort on (id, userid, result,
+ *   timestamps) plus an offset into the string table.
+ * - inactive.names - string table of NUL terminated job names,
+ *   referenced by offset and deduplicated on append.
+ *
+ * Records are appended as jobs transition to INACTIVE.  Appends at or
+ * before the timestamp of the last indexed record are dropped, which
+ * makes replaying transitions after a module reload idempotent.  The
+ * record layout uses host byte order; the index is a node-local cache,
+ * not an interchange format, and is rebuilt naturally as jobs complete.
+ */
+
+struct inactive_index_record {
+    uint64_t id;
+    uint32_t userid;
+    uint32_t result;        /* FLUX_JOB_RESULT_* */
+    double t_submit;
+    double t_run;           /* 0. if never ran */
+    double t_inactive;
+    uint64_t name_offset;   /* into string table */
+};
+
+struct inactive_index;
+
+/* Scan callback, invoked with records in newest-first order.
+ * Return 0 to continue scanning, 1 to stop, -1 on error (scan
+ * returns -1 with errno preserved).
+ */
+typedef int (*inactive_index_f) (const struct inactive_index_record *rec,
+                                 const char *name,
+                                 void *arg);
+
+/* Open (creating if necessary) the index files under 'dir'.
+ * Returns NULL with errno set on failure.
+ */
+struct inactive_index *inactive_index_create (flux_t *h, const char *dir);
+void inactive_index_destroy (struct inactive_index *idx);
+
+/* Append a record for 'job', which must have completed its
+ * transition to INACTIVE.  A duplicate append (t_inactive at or
+ * before the last indexed record) is silently dropped.
+ */
+int inactive_index_append (struct inactive_index *idx, struct job *job);
+
+/* Scan the fixed-width records newest-first, invoking 'cb' on each
+ * record that passes the filters:
+ * - 'userid' (FLUX_USERID_UNKNOWN to match any)
+ * - 'results' (mask of FLUX_JOB_RESULT_*)
+ * - 'since' (only records with t_inactive > since; 0. for all)
+ * - 'before' (only records with t_inactive < before; 0. for all)
+ */
+int inactive_index_scan (struct inactive_index *idx,
+                         uint32_t userid,
+                         int results,
+                         double since,
+                         double before,
+                         inactive_index_f cb,
+                         void *arg);
+
+#endif /* !_FLUX_JOB_INFO_INACTIVE_INDEX_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -16,6 +16,8 @@
 
 #include "job_state.h"
 
+struct inactive_index;
+
 struct info_ctx {
     flux_t *h;
     flux_msg_handler_t **handlers;
@@ -25,6 +27,8 @@ struct info_ctx {
     struct job_state_ctx *jsctx;
     zlistx_t *idsync_lookups;
     zhashx_t *idsync_waits;
+    zhashx_t *owner_cache;
+    struct inactive_index *idx;     /* NULL if index unavailable */
 };
 
 #endif /* _FLUX_JOB_INFO_INFO_H */
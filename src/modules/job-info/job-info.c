@@ -22,6 +22,7 @@
 #include "watch.h"
 #include "guest_watch.h"
 #include "idsync.h"
+#include "inactive_index.h"
 
 static void disconnect_cb (flux_t *h, flux_msg_handler_t *mh,
                            const flux_msg_t *msg, void *arg)
@@ -138,6 +139,11 @@ static const struct flux_msg_handler_spec htab[] = {
       .cb           = list_inactive_cb,
       .rolemask     = FLUX_ROLE_USER
     },
+    { .typemask     = FLUX_MSGTYPE_REQUEST,
+      .topic_glob   = "job-info.list-index",
+      .cb           = list_index_cb,
+      .rolemask     = FLUX_ROLE_USER
+    },
     { .typemask     = FLUX_MSGTYPE_REQUEST,
       .topic_glob   = "job-info.list-id",
       .cb           = list_id_cb,
@@ -206,6 +212,8 @@ static void info_ctx_destroy (struct info_ctx *ctx)
             job_state_destroy (ctx->jsctx);
         if (ctx->idsync_lookups)
             idsync_cleanup (ctx);
+        inactive_index_destroy (ctx->idx);
+        zhashx_destroy (&ctx->owner_cache);
         free (ctx);
         errno = saved_errno;
     }
@@ -225,6 +233,19 @@ static struct info_ctx *info_ctx_create (flux_t *h)
         goto error;
     if (!(ctx->guest_watchers = zlist_new ()))
         goto error;
+    if (owner_cache_setup (ctx) < 0)
+        goto error;
+    /* The inactive index accelerates job history queries but the
+     * module works without it, e.g. under test connectors with no
+     * rundir - degrade to the in-memory lists with a log message.
+     */
+    {
+        const char *rundir = flux_attr_get (h, "rundir");
+        if (!rundir || !(ctx->idx = inactive_index_create (h, rundir)))
+            flux_log (h, LOG_INFO,
+                      "inactive index disabled: %s",
+                      rundir ? flux_strerror (errno) : "no rundir attr");
+    }
     if (!(ctx->jsctx = job_state_create (h)))
         goto error;
     if (idsync_setup (ctx) < 0)
@@ -20,14 +20,21 @@
 #include "src/common/libeventlog/eventlog.h"
 #include "src/common/libutil/fluid.h"
 #include "src/common/libjob/job_hash.h"
+#include "src/common/libjob/jobspec_cache.h"
 #include "src/common/libidset/idset.h"
 
 #include "job_state.h"
 #include "idsync.h"
 #include "job_util.h"
+#include "inactive_index.h"
 
 #define NUMCMP(a,b) ((a)==(b)?0:((a)<(b)?-1:1))
 
+/* Maximum number of in-flight KVS lookups while reading jobs back
+ * from the KVS at startup.
+ */
+static const int restart_lookup_window = 256;
+
 struct state_transition {
     flux_job_state_t state;
     bool processed;
@@ -357,6 +364,14 @@ static void update_job_state_and_list (struct info_ctx *ctx,
 
     if (oldlist != newlist)
         job_change_list (jsctx, job, oldlist, newstate);
+
+    /* job->result was finalized before the INACTIVE transition was
+     * queued, so the job is ready to be indexed at this point.
+     */
+    if (newstate == FLUX_JOB_INACTIVE
+        && ctx->idx
+        && inactive_index_append (ctx->idx, job) < 0)
+        flux_log_error (ctx->h, "%s: inactive_index_append", __FUNCTION__);
 }
 
 static void list_id_respond (struct info_ctx *ctx,
@@ -507,7 +522,11 @@ static int jobspec_parse (struct info_ctx *ctx,
     json_t *tasks, *resources, *command, *jobspec_job = NULL;
     int rc = -1;
 
-    if (!(jobspec = json_loads (s, 0, &error))) {
+    /* Parse via the shared jobspec cache: bulk submissions of
+     * byte-identical jobspecs are parsed once and the immutable
+     * object shared.  Only read (or incref) the result below.
+     */
+    if (!(jobspec = jobspec_cache_parse (s, strlen (s), &error))) {
         flux_log (ctx->h, LOG_ERR,
                   "%s: job %ju invalid jobspec: %s",
                   __FUNCTION__, (uintmax_t)job->id, error.text);
@@ -1265,6 +1284,48 @@ static int parse_annotation (json_t *annotation, flux_jobid_t *id, json_t **aVal
     return 0;
 }
 
+/* Merge annotation delta 'new' into 'orig'.  A json null value deletes
+ * a key; empty sub-objects are pruned.  Mirrors the merge performed in
+ * job-manager, which publishes only changed fields.
+ */
+static int annotations_update_recursive (json_t *orig, json_t *new)
+{
+    const char *key;
+    json_t *value;
+
+    json_object_foreach (new, key, value) {
+        if (!json_is_null (value)) {
+            json_t *orig_value = json_object_get (orig, key);
+
+            if (json_is_object (value)) {
+                if (!json_is_object (orig_value)) {
+                    json_t *o = json_object ();
+                    if (!o || json_object_set_new (orig, key, o) < 0) {
+                        json_decref (o);
+                        errno = ENOMEM;
+                        return -1;
+                    }
+                    orig_value = o;
+                }
+                if (annotations_update_recursive (orig_value, value) < 0)
+                    return -1;
+                if (!json_object_size (orig_value))
+                    (void)json_object_del (orig, key);
+            }
+            else {
+                if (json_object_set (orig, key, value) < 0) {
+                    errno = ENOMEM;
+                    return -1;
+                }
+            }
+        }
+        else
+            (void)json_object_del (orig, key);
+    }
+
+    return 0;
+}
+
 static void update_annotations (struct info_ctx *ctx, json_t *annotations)
 {
     struct job_state_ctx *jsctx = ctx->jsctx;
@@ -1288,11 +1349,28 @@ static void update_annotations (struct info_ctx *ctx, json_t *annotations)
         }
 
         if ((job = zhashx_lookup (jsctx->index, &id))) {
-            json_decref (job->annotations);
-            if (json_is_null (aValue))
+            if (json_is_null (aValue)) {
+                json_decref (job->annotations);
                 job->annotations = NULL;
-            else
-                job->annotations = json_incref (aValue);
+            }
+            else {
+                if (!job->annotations
+                    && !(job->annotations = json_object ())) {
+                    flux_log_error (jsctx->h, "%s: json_object", __FUNCTION__);
+                    return;
+                }
+                if (annotations_update_recursive (job->annotations,
+                                                  aValue) < 0) {
+                    flux_log_error (jsctx->h,
+                                    "%s: annotations update for %ju",
+                                    __FUNCTION__, (uintmax_t)id);
+                    return;
+                }
+                if (!json_object_size (job->annotations)) {
+                    json_decref (job->annotations);
+                    job->annotations = NULL;
+                }
+            }
         }
         else
             flux_log_error (jsctx->h, "%s: job %ju not found",
@@ -1495,52 +1573,91 @@ static int depthfirst_count_depth (const char *s)
     return count;
 }
 
-static int depthfirst_map_one (struct info_ctx *ctx, const char *key,
-                               int dirskip)
-{
-    struct job *job = NULL;
+struct restart_lookup {
     flux_jobid_t id;
-    flux_future_t *f1 = NULL;
-    flux_future_t *f2 = NULL;
-    flux_future_t *f3 = NULL;
-    const char *eventlog, *jobspec, *R;
+    flux_future_t *f_eventlog;
+    flux_future_t *f_jobspec;
+};
+
+static void restart_lookup_destroy (struct restart_lookup *rl)
+{
+    if (rl) {
+        int saved_errno = errno;
+        flux_future_destroy (rl->f_eventlog);
+        flux_future_destroy (rl->f_jobspec);
+        free (rl);
+        errno = saved_errno;
+    }
+}
+
+/* Send eventlog and jobspec lookups for the job directory at 'key'
+ * without waiting for the responses, so many jobs' lookups can be
+ * in flight at once during restart.
+ */
+static struct restart_lookup *depthfirst_map_one_send (struct info_ctx *ctx,
+                                                       const char *key,
+                                                       int dirskip)
+{
+    struct restart_lookup *rl;
     char path[64];
-    int rc = -1;
 
     if (strlen (key) <= dirskip) {
         errno = EINVAL;
-        return -1;
+        return NULL;
     }
-    if (fluid_decode (key + dirskip + 1, &id, FLUID_STRING_DOTHEX) < 0)
-        return -1;
-    if (flux_job_kvs_key (path, sizeof (path), id, "eventlog") < 0) {
+    if (!(rl = calloc (1, sizeof (*rl))))
+        return NULL;
+    if (fluid_decode (key + dirskip + 1, &rl->id, FLUID_STRING_DOTHEX) < 0)
+        goto error;
+    if (flux_job_kvs_key (path, sizeof (path), rl->id, "eventlog") < 0) {
         errno = EINVAL;
-        return -1;
+        goto error;
     }
-    if (!(f1 = flux_kvs_lookup (ctx->h, NULL, 0, path)))
-        goto done;
-    if (flux_kvs_lookup_get (f1, &eventlog) < 0)
-        goto done;
+    if (!(rl->f_eventlog = flux_kvs_lookup (ctx->h, NULL, 0, path)))
+        goto error;
+    if (flux_job_kvs_key (path, sizeof (path), rl->id, "jobspec") < 0) {
+        errno = EINVAL;
+        goto error;
+    }
+    if (!(rl->f_jobspec = flux_kvs_lookup (ctx->h, NULL, 0, path)))
+        goto error;
+    return rl;
+error:
+    restart_lookup_destroy (rl);
+    return NULL;
+}
 
-    if (!(job = eventlog_restart_parse (ctx, eventlog, id)))
-        goto done;
+/* Wait for a job's lookup responses and reconstruct the job.
+ * Destroys 'rl'.
+ */
+static int depthfirst_map_one_finish (struct info_ctx *ctx,
+                                      struct restart_lookup *rl)
+{
+    struct job *job = NULL;
+    flux_future_t *f3 = NULL;
+    const char *eventlog, *jobspec, *R;
+    char path[64];
+    int rc = -1;
 
-    if (flux_job_kvs_key (path, sizeof (path), id, "jobspec") < 0) {
-        errno = EINVAL;
+    if (flux_kvs_lookup_get (rl->f_eventlog, &eventlog) < 0)
         goto done;
-    }
-    if (!(f2 = flux_kvs_lookup (ctx->h, NULL, 0, path)))
+
+    if (!(job = eventlog_restart_parse (ctx, eventlog, rl->id)))
         goto done;
-    if (flux_kvs_lookup_get (f2, &jobspec) < 0)
+
+    if (flux_kvs_lookup_get (rl->f_jobspec, &jobspec) < 0)
         goto done;
 
     if (jobspec_parse (ctx, job, jobspec) < 0)
         goto done;
 
+    /* R is only needed for jobs that reached RUN state, so this lookup
+     * cannot be issued until the eventlog has been parsed.
+     */
     if (job->states_mask & FLUX_JOB_RUN) {
-        if (flux_job_kvs_key (path, sizeof (path), id, "R") < 0) {
+        if (flux_job_kvs_key (path, sizeof (path), rl->id, "R") < 0) {
             errno = EINVAL;
-            return -1;
+            goto done;
         }
         if (!(f3 = flux_kvs_lookup (ctx->h, NULL, 0, path)))
             goto done;
@@ -1557,6 +1674,13 @@ static int depthfirst_map_one (struct info_ctx *ctx, const char *key,
 
         if (eventlog_inactive_finish (ctx, job) < 0)
             goto done;
+
+        /* A duplicate append (job indexed before the restart) is
+         * dropped by inactive_index_append().
+         */
+        if (ctx->idx && inactive_index_append (ctx->idx, job) < 0)
+            flux_log_error (ctx->h, "%s: inactive_index_append",
+                            __FUNCTION__);
     }
 
     if (zhashx_insert (ctx->jsctx->index, &job->id, job) < 0) {
@@ -1569,14 +1693,13 @@ static int depthfirst_map_one (struct info_ctx *ctx, const char *key,
 done:
     if (rc < 0)
         job_destroy (job);
-    flux_future_destroy (f1);
-    flux_future_destroy (f2);
     flux_future_destroy (f3);
+    restart_lookup_destroy (rl);
     return rc;
 }
 
 static int depthfirst_map (struct info_ctx *ctx, const char *key,
-                           int dirskip)
+                           int dirskip, zlist_t *pending)
 {
     flux_future_t *f;
     const flux_kvsdir_t *dir;
@@ -1598,15 +1721,27 @@ static int depthfirst_map (struct info_ctx *ctx, const char *key,
         goto done;
     while ((name = flux_kvsitr_next (itr))) {
         char *nkey;
-        int n;
+        int n = 0;
         if (!flux_kvsdir_isdir (dir, name))
             continue;
         if (!(nkey = flux_kvsdir_key_at (dir, name)))
             goto done_destroyitr;
-        if (path_level == 3) // orig 'key' = .A.B.C, thus 'nkey' is complete
-            n = depthfirst_map_one (ctx, nkey, dirskip);
+        if (path_level == 3) { // orig 'key' = .A.B.C, thus 'nkey' is complete
+            struct restart_lookup *rl;
+            if (!(rl = depthfirst_map_one_send (ctx, nkey, dirskip))
+                || zlist_append (pending, rl) < 0) {
+                restart_lookup_destroy (rl);
+                n = -1;
+            }
+            /* Retire the oldest lookup once the window is full.  It may
+             * belong to an earlier directory; the total count is what
+             * matters.
+             */
+            else if (zlist_size (pending) >= restart_lookup_window)
+                n = depthfirst_map_one_finish (ctx, zlist_pop (pending));
+        }
         else
-            n = depthfirst_map (ctx, nkey, dirskip);
+            n = depthfirst_map (ctx, nkey, dirskip, pending);
         if (n < 0) {
             int saved_errno = errno;
             free (nkey);
@@ -1630,8 +1765,27 @@ int job_state_init_from_kvs (struct info_ctx *ctx)
     const char *dirname = "job";
     int dirskip = strlen (dirname);
     int count;
+    int n;
+    zlist_t *pending;
+    struct restart_lookup *rl;
 
-    count = depthfirst_map (ctx, dirname, dirskip);
+    if (!(pending = zlist_new ())) {
+        errno = ENOMEM;
+        return -1;
+    }
+    count = depthfirst_map (ctx, dirname, dirskip, pending);
+    /* Retire lookups still in flight when the directory walk finished
+     * (or, on walk error, toss them).
+     */
+    while ((rl = zlist_pop (pending))) {
+        if (count < 0)
+            restart_lookup_destroy (rl);
+        else if ((n = depthfirst_map_one_finish (ctx, rl)) < 0)
+            count = -1;
+        else
+            count += n;
+    }
+    zlist_destroy (&pending);
     if (count < 0)
         return -1;
     flux_log (ctx->h, LOG_DEBUG, "%s: read %d jobs", __FUNCTION__, count);
@@ -23,6 +23,7 @@
 #include "list.h"
 #include "job_util.h"
 #include "job_state.h"
+#include "inactive_index.h"
 
 json_t *get_job_by_id (struct info_ctx *ctx,
                        job_info_error_t *errp,
@@ -49,6 +50,12 @@ bool job_filter (struct job *job, uint32_t userid, int states, int results)
  * one error with errno set:
  *
  * ENOMEM - out of memory
+ *
+ * 'before' > 0. is a pagination cursor for the inactive list:  only
+ * jobs that became inactive before that timestamp are returned, so a
+ * client can fetch the next page by passing the t_inactive of the last
+ * job it received.  New completions land at the head of the list, after
+ * the cursor, so pages remain stable while paginating.
  */
 int get_jobs_from_list (json_t *jobs,
                         job_info_error_t *errp,
@@ -57,12 +64,17 @@ int get_jobs_from_list (json_t *jobs,
                         json_t *attrs,
                         uint32_t userid,
                         int states,
-                        int results)
+                        int results,
+                        double before)
 {
     struct job *job;
 
     job = zlistx_first (list);
     while (job) {
+        if (before > 0. && job->t_inactive >= before) {
+            job = zlistx_next (list);
+            continue;
+        }
         if (job_filter (job, userid, states, results)) {
             json_t *o;
             if (!(o = job_to_json (job, attrs, errp)))
@@ -94,7 +106,8 @@ json_t *get_jobs (struct info_ctx *ctx,
                   json_t *attrs,
                   uint32_t userid,
                   int states,
-                  int results)
+                  int results,
+                  double before)
 {
     json_t *jobs = NULL;
     int saved_errno;
@@ -114,7 +127,8 @@ json_t *get_jobs (struct info_ctx *ctx,
                                        attrs,
                                        userid,
                                        states,
-                                       results)) < 0)
+                                       results,
+                                       0.)) < 0)
             goto error;
     }
 
@@ -127,7 +141,8 @@ json_t *get_jobs (struct info_ctx *ctx,
                                            attrs,
                                            userid,
                                            states,
-                                           results)) < 0)
+                                           results,
+                                           0.)) < 0)
                 goto error;
         }
     }
@@ -141,7 +156,8 @@ json_t *get_jobs (struct info_ctx *ctx,
                                            attrs,
                                            userid,
                                            states,
-                                           results)) < 0)
+                                           results,
+                                           before)) < 0)
                 goto error;
         }
     }
@@ -168,13 +184,15 @@ void list_cb (flux_t *h, flux_msg_handler_t *mh,
     uint32_t userid;
     int states;
     int results;
+    double before = 0.;
 
-    if (flux_request_unpack (msg, NULL, "{s:i s:o s:i s:i s:i}",
+    if (flux_request_unpack (msg, NULL, "{s:i s:o s:i s:i s:i s?:F}",
                              "max_entries", &max_entries,
                              "attrs", &attrs,
                              "userid", &userid,
                              "states", &states,
-                             "results", &results) < 0) {
+                             "results", &results,
+                             "before", &before) < 0) {
         seterror (&err, "invalid payload: %s", flux_msg_last_error (msg));
         errno = EPROTO;
         goto error;
@@ -184,6 +202,11 @@ void list_cb (flux_t *h, flux_msg_handler_t *mh,
         errno = EPROTO;
         goto error;
     }
+    if (before < 0.) {
+        seterror (&err, "invalid payload: before < 0 not allowed");
+        errno = EPROTO;
+        goto error;
+    }
     if (!json_is_array (attrs)) {
         seterror (&err, "invalid payload: attrs must be an array");
         errno = EPROTO;
@@ -203,7 +226,7 @@ void list_cb (flux_t *h, flux_msg_handler_t *mh,
                    | FLUX_JOB_RESULT_TIMEOUT);
 
     if (!(jobs = get_jobs (ctx, &err, max_entries,
-                           attrs, userid, states, results)))
+                           attrs, userid, states, results, before)))
         goto error;
 
     if (flux_respond_pack (h, msg, "{s:O}", "jobs", jobs) < 0) {
@@ -321,6 +344,118 @@ error:
     json_decref (jobs);
 }
 
+struct list_index_arg {
+    json_t *jobs;
+    int max_entries;
+    const char *name;
+};
+
+/* Append one indexed record to the jobs array.  Only the indexed
+ * columns are returned; callers needing full job metadata should
+ * follow up with job-info.list-id on the ids of interest.
+ */
+static int list_index_append (const struct inactive_index_record *rec,
+                              const char *name,
+                              void *arg)
+{
+    struct list_index_arg *la = arg;
+    json_t *o;
+
+    if (la->name && strcmp (name, la->name) != 0)
+        return 0;
+    if (!(o = json_pack ("{s:I s:i s:i s:f s:f s:f s:s}",
+                         "id", (json_int_t)rec->id,
+                         "userid", rec->userid,
+                         "result", rec->result,
+                         "t_submit", rec->t_submit,
+                         "t_run", rec->t_run,
+                         "t_inactive", rec->t_inactive,
+                         "name", name))) {
+        errno = ENOMEM;
+        return -1;
+    }
+    if (json_array_append_new (la->jobs, o) < 0) {
+        json_decref (o);
+        errno = ENOMEM;
+        return -1;
+    }
+    if (json_array_size (la->jobs) == la->max_entries)
+        return 1;
+    return 0;
+}
+
+/* Answer an inactive job query from the on-disk index, scanning only
+ * the fixed-width columns rather than materializing full job objects.
+ * Fails with ENOSYS if the index is unavailable on this rank.
+ */
+void list_index_cb (flux_t *h, flux_msg_handler_t *mh,
+                    const flux_msg_t *msg, void *arg)
+{
+    struct info_ctx *ctx = arg;
+    job_info_error_t err = {{0}};
+    struct list_index_arg la = {0};
+    int max_entries;
+    uint32_t userid;
+    int results;
+    double since = 0.;
+    double before = 0.;
+    const char *name = NULL;
+
+    if (flux_request_unpack (msg, NULL, "{s:i s:i s:i s?:F s?:F s?:s}",
+                             "max_entries", &max_entries,
+                             "userid", &userid,
+                             "results", &results,
+                             "since", &since,
+                             "before", &before,
+                             "name", &name) < 0) {
+        seterror (&err, "invalid payload: %s", flux_msg_last_error (msg));
+        errno = EPROTO;
+        goto error;
+    }
+    if (max_entries < 0) {
+        seterror (&err, "invalid payload: max_entries < 0 not allowed");
+        errno = EPROTO;
+        goto error;
+    }
+    if (since < 0. || before < 0.) {
+        seterror (&err, "invalid payload: negative timestamp not allowed");
+        errno = EPROTO;
+        goto error;
+    }
+    if (!ctx->idx) {
+        seterror (&err, "inactive index unavailable");
+        errno = ENOSYS;
+        goto error;
+    }
+    if (!results)
+        results = (FLUX_JOB_RESULT_COMPLETED
+                   | FLUX_JOB_RESULT_FAILED
+                   | FLUX_JOB_RESULT_CANCELLED
+                   | FLUX_JOB_RESULT_TIMEOUT);
+    if (!(la.jobs = json_array ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    la.max_entries = max_entries;
+    la.name = name;
+    if (inactive_index_scan (ctx->idx, userid, results, since, before,
+                             list_index_append, &la) < 0)
+        goto error;
+
+    if (flux_respond_pack (h, msg, "{s:O}", "jobs", la.jobs) < 0) {
+        flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+        goto error;
+    }
+
+    json_decref (la.jobs);
+    return;
+
+error:
+    if (flux_respond_error (h, msg, errno, err.text) < 0)
+        flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+    json_decref (la.jobs);
+}
+
 int wait_id_valid (struct info_ctx *ctx, struct idsync_data *isd)
 {
     zlistx_t *list_isd;
@@ -173,7 +173,7 @@ static void info_lookup_continuation (flux_future_t *fall, void *arg)
             goto error;
         }
 
-        if (eventlog_allow (ctx, l->msg, s) < 0)
+        if (eventlog_allow (ctx, l->msg, l->id, s) < 0)
             goto error;
         l->allow = true;
     }
@@ -9,7 +9,14 @@
 \************************************************************/
 
 /* watch.c - handle job-info.eventlog-watch &
- * job-info.eventlog-watch-cancel for job-info */
+ * job-info.eventlog-watch-cancel for job-info
+ *
+ * The request may contain optional server-side filters:
+ * - eventname:s - send only entries whose event name matches
+ * - since:F - send only entries with a timestamp greater than 'since'
+ * Filters are applied before the response is encoded, so uninteresting
+ * entries are never shipped to the client.
+ */
 
 #if HAVE_CONFIG_H
 #include "config.h"
@@ -32,6 +39,8 @@ struct watch_ctx {
     bool guest;
     char *path;
     int flags;
+    char *eventname;            /* optional event name filter */
+    double since;               /* optional timestamp filter, 0. = unset */
     flux_future_t *check_f;
     flux_future_t *watch_f;
     bool allow;
@@ -47,6 +56,7 @@ static void watch_ctx_destroy (void *data)
         struct watch_ctx *ctx = data;
         flux_msg_decref (ctx->msg);
         free (ctx->path);
+        free (ctx->eventname);
         flux_future_destroy (ctx->check_f);
         flux_future_destroy (ctx->watch_f);
         free (ctx);
@@ -58,7 +68,9 @@ static struct watch_ctx *watch_ctx_create (struct info_ctx *ctx,
                                            flux_jobid_t id,
                                            bool guest,
                                            const char *path,
-                                           int flags)
+                                           int flags,
+                                           const char *eventname,
+                                           double since)
 {
     struct watch_ctx *w = calloc (1, sizeof (*w));
     int saved_errno;
@@ -73,6 +85,11 @@ static struct watch_ctx *watch_ctx_create (struct info_ctx *ctx,
         errno = ENOMEM;
         goto error;
     }
+    if (eventname && !(w->eventname = strdup (eventname))) {
+        errno = ENOMEM;
+        goto error;
+    }
+    w->since = since;
     w->flags = flags;
 
     w->msg = flux_msg_incref (msg);
@@ -161,7 +178,7 @@ static void check_eventlog_continuation (flux_future_t *f, void *arg)
     }
 
     if (!w->allow) {
-        if (eventlog_allow (ctx, w->msg, s) < 0)
+        if (eventlog_allow (ctx, w->msg, w->id, s) < 0)
             goto error;
         w->allow = true;
     }
@@ -201,42 +218,6 @@ static bool eventlog_parse_next (const char **pp, const char **tok,
     return true;
 }
 
-static int check_eventlog_end (struct watch_ctx *w,
-                               const char *tok,
-                               size_t toklen)
-{
-    char *str = NULL;
-    json_t *o = NULL;
-    const char *name = NULL;
-    int saved_errno, rc = -1;
-
-    if (!(str = strndup (tok, toklen))) {
-        flux_log_error (w->ctx->h, "%s: strndup", __FUNCTION__);
-        goto error;
-    }
-
-    if (!(o = eventlog_entry_decode (str))) {
-        flux_log_error (w->ctx->h, "%s: eventlog_entry_decode", __FUNCTION__);
-        goto error;
-    }
-
-    if (eventlog_entry_parse (o, NULL, &name, NULL) < 0) {
-        flux_log_error (w->ctx->h, "%s: eventlog_entry_parse", __FUNCTION__);
-        goto error;
-    }
-
-    if (!strcmp (name, "clean"))
-        rc = 1;
-    else
-        rc = 0;
-error:
-    saved_errno = errno;
-    free (str);
-    json_decref (o);
-    errno = saved_errno;
-    return rc;
-}
-
 static void watch_continuation (flux_future_t *f, void *arg)
 {
     struct watch_ctx *w = arg;
@@ -258,19 +239,42 @@ static void watch_continuation (flux_future_t *f, void *arg)
     }
 
     if (!w->allow) {
-        if (eventlog_allow (ctx, w->msg, s) < 0)
+        if (eventlog_allow (ctx, w->msg, w->id, s) < 0)
             goto error_cancel;
         w->allow = true;
     }
 
     input = s;
     while (eventlog_parse_next (&input, &tok, &toklen)) {
-        if (flux_respond_pack (ctx->h, w->msg,
-                               "{s:s#}",
-                               "event", tok, toklen) < 0) {
-            flux_log_error (ctx->h, "%s: flux_respond_pack",
-                            __FUNCTION__);
-            goto error_cancel;
+        json_t *entry = NULL;
+        const char *name = NULL;
+        double timestamp = 0.;
+        bool main_eventlog = (!w->guest && !strcmp (w->path, "eventlog"));
+
+        /* Decode each entry at most once, shared by the server-side
+         * filters and end-of-eventlog detection.  'tok' points into
+         * the newline terminated log, so only the entry is parsed.
+         */
+        if (w->eventname || w->since > 0. || main_eventlog) {
+            if (!(entry = eventlog_first_entry_decode (tok))
+                || eventlog_entry_parse (entry, &timestamp, &name, NULL) < 0) {
+                flux_log_error (ctx->h, "%s: eventlog_entry_parse",
+                                __FUNCTION__);
+                json_decref (entry);
+                goto error_cancel;
+            }
+        }
+
+        if (!(w->eventname && strcmp (name, w->eventname))
+            && !(w->since > 0. && timestamp <= w->since)) {
+            if (flux_respond_pack (ctx->h, w->msg,
+                                   "{s:s#}",
+                                   "event", tok, toklen) < 0) {
+                flux_log_error (ctx->h, "%s: flux_respond_pack",
+                                __FUNCTION__);
+                json_decref (entry);
+                goto error_cancel;
+            }
         }
 
         /* When watching the main job eventlog, we return ENODATA back
@@ -279,19 +283,19 @@ static void watch_continuation (flux_future_t *f, void *arg)
          * An alternate main KVS namespace eventlog does not have a
          * known ruleset, so it will hang.
          */
-        if (!w->guest && !strcmp (w->path, "eventlog")) {
-            if (check_eventlog_end (w, tok, toklen) > 0) {
-                if (flux_kvs_lookup_cancel (w->watch_f) < 0) {
-                    flux_log_error (ctx->h, "%s: flux_kvs_lookup_cancel",
-                                    __FUNCTION__);
-                    goto error;
-                }
-                /* If by small chance there is an event after "clean"
-                 * (e.g. user appended), we won't send it */
-                errno = ENODATA;
+        if (main_eventlog && !strcmp (name, "clean")) {
+            json_decref (entry);
+            if (flux_kvs_lookup_cancel (w->watch_f) < 0) {
+                flux_log_error (ctx->h, "%s: flux_kvs_lookup_cancel",
+                                __FUNCTION__);
                 goto error;
             }
+            /* If by small chance there is an event after "clean"
+             * (e.g. user appended), we won't send it */
+            errno = ENODATA;
+            goto error;
         }
+        json_decref (entry);
     }
 
     flux_future_reset (f);
@@ -325,13 +329,17 @@ void watch_cb (flux_t *h, flux_msg_handler_t *mh,
     flux_jobid_t id;
     int guest = 0;
     const char *path = NULL;
+    const char *eventname = NULL;
+    double since = 0.;
     int flags;
     const char *errmsg = NULL;
 
-    if (flux_request_unpack (msg, NULL, "{s:I s:s s:i}",
+    if (flux_request_unpack (msg, NULL, "{s:I s:s s:i s?:s s?:F}",
                              "id", &id,
                              "path", &path,
-                             "flags", &flags) < 0) {
+                             "flags", &flags,
+                             "eventname", &eventname,
+                             "since", &since) < 0) {
         flux_log_error (h, "%s: flux_request_unpack", __FUNCTION__);
         goto error;
     }
@@ -340,9 +348,15 @@ void watch_cb (flux_t *h, flux_msg_handler_t *mh,
         errmsg = "eventlog-watch request rejected without streaming RPC flag";
         goto error;
     }
+    if (since < 0.) {
+        errno = EPROTO;
+        errmsg = "eventlog-watch since timestamp cannot be negative";
+        goto error;
+    }
     (void)flux_request_unpack (msg, NULL, "{s:b}", "guest", &guest);
 
-    if (!(w = watch_ctx_create (ctx, msg, id, guest, path, flags)))
+    if (!(w = watch_ctx_create (ctx, msg, id, guest, path, flags,
+                                eventname, since)))
         goto error;
 
     /* if user requested an alternate path and that alternate path is
@@ -21,6 +21,9 @@
 #endif
 
 #include "src/common/libutil/fluid.h"
+#include "src/common/libutil/blobref.h"
+#include "src/common/libutil/monotime.h"
+#include "src/common/libutil/tstat.h"
 #include "src/common/libjob/sign_none.h"
 #include "src/common/libeventlog/eventlog.h"
 
@@ -39,8 +42,17 @@
  * arrive within the 'batch_timeout' window, they are combined into one
  * KVS transaction and one job-manager request.
  *
+ * Note that jobspec bytes never traverse the broker a second time:
+ * J and the unwrapped jobspec are committed to the KVS here, and the
+ * job-manager.submit request carries only the jobid and attributes
+ * already extracted during ingest (userid, priority, t_submit, flags),
+ * which the job manager accepts without re-reading the jobspec.
+ *
  * The jobid is returned to the user in response to the job-ingest.submit RPC.
  * Responses are sent after the job has been successfully ingested.
+ * A batch of jobs sharing one priority and flags may also be submitted
+ * with a single job-ingest.bulk-submit RPC, whose response carries a
+ * jobid or error per job in request order.
  *
  * Currently all KVS data is committed under job.<fluid-dothex>,
  * where <fluid-dothex> is the jobid converted to 16-bit, 0-padded hex
@@ -74,6 +86,22 @@ const double batch_timeout = 0.01;
  */
 const double shutdown_timeout = 5.;
 
+/* Unwrapped-jobspec cache:  workflow engines resubmit byte-identical
+ * signed jobspecs in bulk, so keep recently unwrapped payloads for a
+ * short time, keyed by (userid, hash of J).  A hit skips the unwrap
+ * and signature envelope checks, which already passed for the same
+ * user and the same bytes.  The TTL bounds how long a stale result
+ * can be replayed; the entry cap bounds memory.
+ */
+static const double unwrap_cache_ttl = 10.;
+static const int unwrap_cache_max_entries = 1024;
+
+struct unwrap_entry {
+    char *jobspec;
+    int jobspecsz;
+    double ctime;       // reactor time when entry was cached
+};
+
 
 struct job_ingest_ctx {
     flux_t *h;
@@ -90,12 +118,17 @@ struct job_ingest_ctx {
     bool shutdown;              // no new jobs are accepted in shutdown mode
     int shutdown_process_count; // number of validators executing at shutdown
     flux_watcher_t *shutdown_timer;
+
+    zhash_t *unwrap_cache;      // "userid:hash(J)" => struct unwrap_entry
+    uint64_t unwrap_hits;
+    uint64_t unwrap_misses;
+    tstat_t unwrap_time;        // unwrap + envelope check latency (msec)
 };
 
 struct job {
     fluid_t id;         // jobid
 
-    const flux_msg_t *msg; // submit request message
+    const flux_msg_t *msg; // submit request message (NULL for bulk jobs)
     const char *J;      // signed jobspec
     struct flux_msg_cred cred;    // submitting user's creds
     int priority;       // requested job priority
@@ -104,6 +137,20 @@ struct job {
     char *jobspec;      // jobspec, not \0 terminated (unwrapped from signed)
     int jobspecsz;      // jobspec string length
 
+    struct bulk *bulk;  // bulk-submit request this job belongs to, if any
+    int index;          // position in bulk-submit jobs array
+
+    struct job_ingest_ctx *ctx;
+};
+
+/* A bulk-submit request in progress.  Per-job results accumulate in
+ * request order, and one response is sent once the last job has either
+ * failed or been ingested.
+ */
+struct bulk {
+    const flux_msg_t *msg; // bulk-submit request message
+    json_t *results;    // per-job result objects, in request order
+    int pending;        // jobs still in validation or KVS commit
     struct job_ingest_ctx *ctx;
 };
 
@@ -160,6 +207,129 @@ error:
     return NULL;
 }
 
+/* Create one job from a bulk-submit request.  'J' points into the bulk
+ * request message payload, which remains valid for the life of the job
+ * since 'bulk' holds a reference on the message until all of its jobs
+ * have completed.
+ */
+static struct job *job_create_bulk (struct bulk *bulk,
+                                    int index,
+                                    const char *J,
+                                    int priority,
+                                    int flags,
+                                    struct flux_msg_cred cred,
+                                    struct job_ingest_ctx *ctx)
+{
+    struct job *job;
+
+    if (!(job = calloc (1, sizeof (*job))))
+        return NULL;
+    job->bulk = bulk;
+    job->index = index;
+    job->J = J;
+    job->priority = priority;
+    job->flags = flags;
+    job->cred = cred;
+    job->ctx = ctx;
+    return job;
+}
+
+static void bulk_destroy (struct bulk *bulk)
+{
+    if (bulk) {
+        int saved_errno = errno;
+        flux_msg_decref (bulk->msg);
+        json_decref (bulk->results);
+        free (bulk);
+        errno = saved_errno;
+    }
+}
+
+static struct bulk *bulk_create (const flux_msg_t *msg,
+                                 int count,
+                                 struct job_ingest_ctx *ctx)
+{
+    struct bulk *bulk;
+    int i;
+
+    if (!(bulk = calloc (1, sizeof (*bulk))))
+        return NULL;
+    bulk->msg = flux_msg_incref (msg);
+    if (!(bulk->results = json_array ()))
+        goto nomem;
+    for (i = 0; i < count; i++) {
+        if (json_array_append_new (bulk->results, json_null ()) < 0)
+            goto nomem;
+    }
+    bulk->ctx = ctx;
+    return bulk;
+nomem:
+    errno = ENOMEM;
+    bulk_destroy (bulk);
+    return NULL;
+}
+
+/* Record the result for the job at 'index' of a bulk-submit request,
+ * responding once results are in for all jobs.  An 'errnum' of zero
+ * indicates success and 'id' is valid; otherwise 'errstr' (optional)
+ * describes the error.  The job itself is accounted for separately via
+ * bulk->pending, incremented as each job enters the ingest pipeline.
+ */
+static void bulk_set_result (struct bulk *bulk,
+                             int index,
+                             fluid_t id,
+                             int errnum,
+                             const char *errstr)
+{
+    flux_t *h = bulk->ctx->h;
+    json_t *entry;
+
+    if (errnum == 0)
+        entry = json_pack ("{s:I}", "id", id);
+    else
+        entry = json_pack ("{s:i s:s}",
+                           "errnum", errnum,
+                           "error", errstr ? errstr : flux_strerror (errnum));
+    if (!entry || json_array_set_new (bulk->results, index, entry) < 0) {
+        flux_log (h, LOG_ERR, "%s: error recording result", __FUNCTION__);
+        json_decref (entry);
+    }
+}
+
+/* Respond to a bulk-submit request once all jobs have a result.
+ */
+static void bulk_complete (struct bulk *bulk)
+{
+    flux_t *h = bulk->ctx->h;
+
+    if (flux_respond_pack (h, bulk->msg, "{s:O}",
+                           "jobs", bulk->results) < 0)
+        flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+    bulk_destroy (bulk);
+}
+
+/* Deliver the final disposition of one job to its requestor.  Jobs from
+ * a bulk-submit request contribute to a combined response instead of
+ * receiving their own.
+ */
+static void job_respond (flux_t *h, struct job *job,
+                         int errnum, const char *errstr)
+{
+    if (job->bulk) {
+        bulk_set_result (job->bulk, job->index, job->id, errnum, errstr);
+        if (--job->bulk->pending == 0)
+            bulk_complete (job->bulk);
+    }
+    else if (errnum == 0) {
+        if (flux_respond_pack (h, job->msg, "{s:I}", "id", job->id) < 0)
+            flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+    }
+    else {
+        if (flux_respond_error (h, job->msg, errnum, errstr) < 0)
+            flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+    }
+}
+
 static void batch_destroy (struct batch *batch)
 {
     if (batch) {
@@ -210,8 +380,7 @@ static void batch_respond_error (struct batch *batch,
     flux_t *h = batch->ctx->h;
     struct job *job = zlist_first (batch->jobs);
     while (job) {
-        if (flux_respond_error (h, job->msg, errnum, errstr) < 0)
-            flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+        job_respond (h, job, errnum, errstr);
         job = zlist_next (batch->jobs);
     }
 }
@@ -223,8 +392,7 @@ static void batch_respond_success (struct batch *batch)
     flux_t *h = batch->ctx->h;
     struct job *job = zlist_first (batch->jobs);
     while (job) {
-        if (flux_respond_pack (h, job->msg, "{s:I}", "id", job->id) < 0)
-            flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+        job_respond (h, job, 0, NULL);
         job = zlist_next (batch->jobs);
     }
 }
@@ -397,7 +565,8 @@ static int batch_add_job (struct batch *batch, struct job *job)
     if (flux_kvs_txn_put_raw (batch->txn, 0, key,
                               job->jobspec, job->jobspecsz) < 0)
         goto error;
-    entry = eventlog_entry_pack (0., "submit",
+    entry = eventlog_entry_pack (flux_reactor_now (flux_get_reactor (batch->ctx->h)),
+                                 "submit",
                                  "{ s:i s:i s:i }",
                                  "userid", job->cred.userid,
                                  "priority", job->priority,
@@ -470,8 +639,7 @@ void validate_continuation (flux_future_t *f, void *arg)
     flux_future_destroy (f);
     return;
 error:
-    if (flux_respond_error (h, job->msg, errno, errmsg) < 0)
-        flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+    job_respond (h, job, errno, errmsg);
     job_destroy (job);
     flux_future_destroy (f);
 }
@@ -486,77 +654,194 @@ static int valid_flags (int flags)
     return 0;
 }
 
-/* Handle "job-ingest.submit" request to add a new job.
+/* Validate submit flags, priority, and role-restricted options.
+ * On failure, return -1 with errno set, leaving a detailed message in
+ * errbuf with *errmsg pointing there.
  */
-static void submit_cb (flux_t *h, flux_msg_handler_t *mh,
-                       const flux_msg_t *msg, void *arg)
+static int check_submit_access (struct flux_msg_cred cred,
+                                int priority,
+                                int flags,
+                                char *errbuf,
+                                int errbufsz,
+                                const char **errmsg)
 {
-    struct job_ingest_ctx *ctx = arg;
-    struct job *job = NULL;
-    const char *errmsg = NULL;
-    char errbuf[256];
-    int64_t userid_signer;
-    const char *mech_type;
-    flux_future_t *f = NULL;
-
-    if (ctx->shutdown) {
-        errno = ENOSYS;
-        goto error;
-    }
-
-    /* Parse request.
-     */
-    if (!(job = job_create (msg, ctx)))
-        goto error;
     /* Validate submit flags.
      */
-    if (valid_flags (job->flags) < 0)
-        goto error;
+    if (valid_flags (flags) < 0)
+        return -1;
     /* Validate requested job priority.
      */
-    if (job->priority < FLUX_JOB_PRIORITY_MIN
-            || job->priority > FLUX_JOB_PRIORITY_MAX) {
-        snprintf (errbuf, sizeof (errbuf), "priority range is [%d:%d]",
+    if (priority < FLUX_JOB_PRIORITY_MIN
+            || priority > FLUX_JOB_PRIORITY_MAX) {
+        snprintf (errbuf, errbufsz, "priority range is [%d:%d]",
                   FLUX_JOB_PRIORITY_MIN, FLUX_JOB_PRIORITY_MAX);
-        errmsg = errbuf;
+        *errmsg = errbuf;
         errno = EINVAL;
-        goto error;
+        return -1;
     }
-    if (!(job->cred.rolemask & FLUX_ROLE_OWNER)
-           && job->priority > FLUX_JOB_PRIORITY_DEFAULT) {
-        snprintf (errbuf, sizeof (errbuf),
+    if (!(cred.rolemask & FLUX_ROLE_OWNER)
+           && priority > FLUX_JOB_PRIORITY_DEFAULT) {
+        snprintf (errbuf, errbufsz,
                   "only the instance owner can submit with priority >%d",
                   FLUX_JOB_PRIORITY_DEFAULT);
-        errmsg = errbuf;
+        *errmsg = errbuf;
         errno = EINVAL;
-        goto error;
+        return -1;
     }
     /* Only owner can set FLUX_JOB_WAITABLE.
      */
-    if (!(job->cred.rolemask & FLUX_ROLE_OWNER)
-            && (job->flags & FLUX_JOB_WAITABLE)) {
+    if (!(cred.rolemask & FLUX_ROLE_OWNER)
+            && (flags & FLUX_JOB_WAITABLE)) {
         snprintf (errbuf,
-                  sizeof (errbuf),
+                  errbufsz,
                   "only the instance onwer can submit with FLUX_JOB_WAITABLE");
-        errmsg = errbuf;
+        *errmsg = errbuf;
         errno = EINVAL;
-        goto error;
+        return -1;
+    }
+    return 0;
+}
+
+static void unwrap_entry_destroy (void *data)
+{
+    struct unwrap_entry *entry = data;
+    if (entry) {
+        int saved_errno = errno;
+        free (entry->jobspec);
+        free (entry);
+        errno = saved_errno;
+    }
+}
+
+/* Compute "userid:hash(J)" cache key.
+ * 'keybuf' must be at least UNWRAP_CACHE_KEY_SIZE in length.
+ */
+#define UNWRAP_CACHE_KEY_SIZE (16 + BLOBREF_MAX_STRING_SIZE)
+static int unwrap_cache_key (char *keybuf, int keybufsz,
+                             uint32_t userid, const char *J)
+{
+    char ref[BLOBREF_MAX_STRING_SIZE];
+    if (blobref_hash ("sha1", J, strlen (J), ref, sizeof (ref)) < 0)
+        return -1;
+    if (snprintf (keybuf, keybufsz, "%lu:%s",
+                  (unsigned long)userid, ref) >= keybufsz) {
+        errno = EOVERFLOW;
+        return -1;
     }
-    /* Validate jobspec signature, and unwrap(J) -> jobspec,  jobspecsz.
-     * Userid claimed by signature must match authenticated job->cred.userid.
-     * If not the instance owner, a strong signature is required
-     * to give the IMP permission to launch processes on behalf of the user.
+    return 0;
+}
+
+/* Look up cached unwrap result, expiring the entry if it has exceeded
+ * the cache TTL.  Returns entry on hit, NULL on miss.
+ */
+static struct unwrap_entry *unwrap_cache_lookup (struct job_ingest_ctx *ctx,
+                                                 const char *key)
+{
+    struct unwrap_entry *entry;
+    double now = flux_reactor_now (flux_get_reactor (ctx->h));
+
+    if (!(entry = zhash_lookup (ctx->unwrap_cache, key)))
+        return NULL;
+    if (now - entry->ctime > unwrap_cache_ttl) {
+        zhash_delete (ctx->unwrap_cache, key);
+        return NULL;
+    }
+    return entry;
+}
+
+/* Cache unwrap result under 'key'.  If the cache is full, purge expired
+ * entries first; if it remains full, skip the insert (failure to cache
+ * is not an error).
+ */
+static void unwrap_cache_insert (struct job_ingest_ctx *ctx, const char *key,
+                                 const char *jobspec, int jobspecsz)
+{
+    struct unwrap_entry *entry;
+    double now = flux_reactor_now (flux_get_reactor (ctx->h));
+
+    if ((int)zhash_size (ctx->unwrap_cache) >= unwrap_cache_max_entries) {
+        zlist_t *keys;
+        char *k;
+        if (!(keys = zhash_keys (ctx->unwrap_cache)))
+            return;
+        k = zlist_first (keys);
+        while (k) {
+            if ((entry = zhash_lookup (ctx->unwrap_cache, k))
+                    && now - entry->ctime > unwrap_cache_ttl)
+                zhash_delete (ctx->unwrap_cache, k);
+            k = zlist_next (keys);
+        }
+        zlist_destroy (&keys);
+        if ((int)zhash_size (ctx->unwrap_cache) >= unwrap_cache_max_entries)
+            return;
+    }
+    if (!(entry = calloc (1, sizeof (*entry))))
+        return;
+    if (!(entry->jobspec = malloc (jobspecsz))) {
+        unwrap_entry_destroy (entry);
+        return;
+    }
+    memcpy (entry->jobspec, jobspec, jobspecsz);
+    entry->jobspecsz = jobspecsz;
+    entry->ctime = now;
+    if (zhash_insert (ctx->unwrap_cache, key, entry) < 0) {
+        unwrap_entry_destroy (entry);
+        return;
+    }
+    zhash_freefn (ctx->unwrap_cache, key, unwrap_entry_destroy);
+}
+
+/* Validate jobspec signature, and unwrap(J) -> jobspec, jobspecsz,
+ * then start asynchronous jobspec validation.
+ * Userid claimed by signature must match authenticated job->cred.userid.
+ * If not the instance owner, a strong signature is required
+ * to give the IMP permission to launch processes on behalf of the user.
+ * On success, ownership of 'job' passes to validate_continuation().
+ * On failure, return -1 with errno set; a detailed message may be left
+ * in errbuf with *errmsg pointing there.
+ */
+static int submit_job (struct job_ingest_ctx *ctx,
+                       struct job *job,
+                       char *errbuf,
+                       int errbufsz,
+                       const char **errmsg)
+{
+    int64_t userid_signer;
+    const char *mech_type;
+    flux_future_t *f = NULL;
+    char key[UNWRAP_CACHE_KEY_SIZE];
+    bool have_key = false;
+    struct unwrap_entry *entry;
+    struct timespec t0;
+
+    monotime (&t0);
+
+    /* If this user recently submitted a byte-identical J, reuse the
+     * cached unwrap result.  The signer and mechanism checks below
+     * already passed for the same bytes and the same authenticated
+     * user, so they may be skipped as well.
      */
+    if (unwrap_cache_key (key, sizeof (key), job->cred.userid, job->J) == 0)
+        have_key = true;
+    if (have_key && (entry = unwrap_cache_lookup (ctx, key))) {
+        if (!(job->jobspec = malloc (entry->jobspecsz)))
+            return -1;
+        memcpy (job->jobspec, entry->jobspec, entry->jobspecsz);
+        job->jobspecsz = entry->jobspecsz;
+        ctx->unwrap_hits++;
+        goto validate;
+    }
+
 #if HAVE_FLUX_SECURITY
     const void *jobspec;
     if (flux_sign_unwrap_anymech (ctx->sec, job->J, &jobspec, &job->jobspecsz,
                                   &mech_type, &userid_signer,
                                   FLUX_SIGN_NOVERIFY) < 0) {
-        errmsg = flux_security_last_error (ctx->sec);
-        goto error;
+        *errmsg = flux_security_last_error (ctx->sec);
+        return -1;
     }
     if (!(job->jobspec = malloc (job->jobspecsz)))
-        goto error;
+        return -1;
     memcpy (job->jobspec, jobspec, job->jobspecsz);
 #else
     uint32_t userid_signer_u32;
@@ -566,42 +851,142 @@ static void submit_cb (flux_t *h, flux_msg_handler_t *mh,
      */
     if (sign_none_unwrap (job->J, (void **)&job->jobspec, &job->jobspecsz,
                           &userid_signer_u32) < 0) {
-        errmsg = "could not unwrap jobspec";
-        goto error;
+        *errmsg = "could not unwrap jobspec";
+        return -1;
     }
     mech_type = "none";
     userid_signer = userid_signer_u32;
 #endif
     if (userid_signer != job->cred.userid) {
-        snprintf (errbuf, sizeof (errbuf),
+        snprintf (errbuf, errbufsz,
                   "signer=%lu != requestor=%lu",
                   (unsigned long)userid_signer,
                   (unsigned long)job->cred.userid);
-        errmsg = errbuf;
+        *errmsg = errbuf;
         errno = EPERM;
-        goto error;
+        return -1;
     }
     if (!(job->cred.rolemask & FLUX_ROLE_OWNER)
                                 && !strcmp (mech_type, "none")) {
-        snprintf (errbuf, sizeof (errbuf),
+        snprintf (errbuf, errbufsz,
                   "only instance owner can use sign-type=none");
-        errmsg = errbuf;
+        *errmsg = errbuf;
         errno = EPERM;
-        goto error;
+        return -1;
     }
+    tstat_push (&ctx->unwrap_time, monotime_since (t0));
+    ctx->unwrap_misses++;
+    if (have_key)
+        unwrap_cache_insert (ctx, key, job->jobspec, job->jobspecsz);
+validate:
     /* Validate jobspec asynchronously.
      * Continue submission process in validate_continuation().
      */
     if (!(f = validate_jobspec (ctx->validate, job->jobspec, job->jobspecsz)))
+        return -1;
+    if (flux_future_then (f, -1., validate_continuation, job) < 0) {
+        flux_future_destroy (f);
+        return -1;
+    }
+    return 0;
+}
+
+/* Handle "job-ingest.submit" request to add a new job.
+ */
+static void submit_cb (flux_t *h, flux_msg_handler_t *mh,
+                       const flux_msg_t *msg, void *arg)
+{
+    struct job_ingest_ctx *ctx = arg;
+    struct job *job = NULL;
+    const char *errmsg = NULL;
+    char errbuf[256];
+
+    if (ctx->shutdown) {
+        errno = ENOSYS;
+        goto error;
+    }
+
+    /* Parse request.
+     */
+    if (!(job = job_create (msg, ctx)))
+        goto error;
+    if (check_submit_access (job->cred, job->priority, job->flags,
+                             errbuf, sizeof (errbuf), &errmsg) < 0)
         goto error;
-    if (flux_future_then (f, -1., validate_continuation, job) < 0)
+    if (submit_job (ctx, job, errbuf, sizeof (errbuf), &errmsg) < 0)
         goto error;
     return;
 error:
     if (flux_respond_error (h, msg, errno, errmsg) < 0)
         flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
     job_destroy (job);
-    flux_future_destroy (f);
+}
+
+/* Handle "job-ingest.bulk-submit" request to add an array of new jobs
+ * sharing one priority and flags.  Jobs enter the ingest pipeline
+ * together and a single response carries per-job jobids or errors in
+ * request order.
+ */
+static void bulk_submit_cb (flux_t *h, flux_msg_handler_t *mh,
+                            const flux_msg_t *msg, void *arg)
+{
+    struct job_ingest_ctx *ctx = arg;
+    struct bulk *bulk = NULL;
+    struct flux_msg_cred cred;
+    json_t *jobs;
+    int priority;
+    int flags;
+    const char *errmsg = NULL;
+    char errbuf[256];
+    size_t index;
+    json_t *el;
+
+    if (ctx->shutdown) {
+        errno = ENOSYS;
+        goto error;
+    }
+    if (flux_request_unpack (msg, NULL, "{s:o s:i s:i}",
+                             "jobs", &jobs,
+                             "priority", &priority,
+                             "flags", &flags) < 0)
+        goto error;
+    if (json_array_size (jobs) == 0) {
+        errno = EPROTO;
+        errmsg = "jobs array is empty";
+        goto error;
+    }
+    if (flux_msg_get_cred (msg, &cred) < 0)
+        goto error;
+    if (check_submit_access (cred, priority, flags,
+                             errbuf, sizeof (errbuf), &errmsg) < 0)
+        goto error;
+    if (!(bulk = bulk_create (msg, json_array_size (jobs), ctx)))
+        goto error;
+    json_array_foreach (jobs, index, el) {
+        const char *J = json_string_value (el);
+        struct job *job = NULL;
+        const char *errmsg2 = NULL;
+
+        if (!J) {
+            errno = EPROTO;
+            errmsg2 = "jobs array entry is not a string";
+        }
+        else if ((job = job_create_bulk (bulk, index, J, priority,
+                                         flags, cred, ctx))
+            && submit_job (ctx, job, errbuf, sizeof (errbuf), &errmsg2) == 0) {
+            bulk->pending++;
+            continue;
+        }
+        bulk_set_result (bulk, index, 0, errno, errmsg2);
+        job_destroy (job);
+    }
+    if (bulk->pending == 0)
+        bulk_complete (bulk);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, errmsg) < 0)
+        flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+    bulk_destroy (bulk);
 }
 
 static void exit_cb (void *arg)
@@ -674,9 +1059,42 @@ error:
         flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
 }
 
+/* Report validator pool status (per-worker queue depth and request
+ * counts), mainly for diagnosing submission latency.
+ */
+static void stats_cb (flux_t *h,
+                      flux_msg_handler_t *mh,
+                      const flux_msg_t *msg,
+                      void *arg)
+{
+    struct job_ingest_ctx *ctx = arg;
+    json_t *o;
+
+    if (flux_request_decode (msg, NULL, NULL) < 0)
+        goto error;
+    if (!(o = validate_stats_get (ctx->validate)))
+        goto error;
+    if (flux_respond_pack (h, msg, "{s:o s:{s:I s:I s:i s:f s:o}}",
+                           "validators", o,
+                           "unwrap-cache",
+                           "hits", (json_int_t)ctx->unwrap_hits,
+                           "misses", (json_int_t)ctx->unwrap_misses,
+                           "size", (int)zhash_size (ctx->unwrap_cache),
+                           "ttl", unwrap_cache_ttl,
+                           "unwrap (ms)", tstat_tojson (&ctx->unwrap_time)) < 0)
+        flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+}
+
 static const struct flux_msg_handler_spec htab[] = {
     { FLUX_MSGTYPE_REQUEST,  "job-ingest.getinfo", getinfo_cb, 0},
+    { FLUX_MSGTYPE_REQUEST,  "job-ingest.stats.get", stats_cb, 0},
     { FLUX_MSGTYPE_REQUEST,  "job-ingest.submit", submit_cb, FLUX_ROLE_USER },
+    { FLUX_MSGTYPE_REQUEST,  "job-ingest.bulk-submit", bulk_submit_cb,
+                             FLUX_ROLE_USER },
     { FLUX_MSGTYPE_REQUEST,  "job-ingest.shutdown", shutdown_cb, 0 },
     FLUX_MSGHANDLER_TABLE_END,
 };
@@ -692,10 +1110,13 @@ int validate_initialize (flux_t *h,
                          struct validate **validate)
 {
     const char *usage_message = "Usage: flux module load [OPTIONS] job-ingest "
-                                " [validator-args=ARGS] [validator=PATH]";
+                                " [validator-args=ARGS] [validator=PATH]"
+                                " [validator-workers=N] [validator-persist]";
     const char *valpath;
     const char *valargs;
     struct validate *v;
+    int workers = 0;
+    bool persist = false;
     int i;
 
     valpath = flux_conf_builtin_get ("jobspec_validate_path", FLUX_CONF_AUTO);
@@ -711,6 +1132,17 @@ int validate_initialize (flux_t *h,
                 return -1;
             }
         }
+        else if (!strncmp (argv[i], "validator-workers=", 18)) {
+            workers = strtol (argv[i] + 18, NULL, 10);
+            if (workers <= 0) {
+                flux_log (h, LOG_ERR, "invalid option %s", argv[i]);
+                errno = EINVAL;
+                return -1;
+            }
+        }
+        else if (!strcmp (argv[i], "validator-persist")) {
+            persist = true;
+        }
         else {
             flux_log (h, LOG_ERR, "invalid option %s", argv[i]);
             flux_log (h, LOG_ERR, "%s", usage_message);
@@ -718,7 +1150,7 @@ int validate_initialize (flux_t *h,
             return -1;
         }
     }
-    if (!(v = validate_create (h, valpath, valargs))) {
+    if (!(v = validate_create (h, valpath, valargs, workers, persist))) {
         flux_log_error (h, "validate_create");
         return -1;
     }
@@ -750,6 +1182,10 @@ int mod_main (flux_t *h, int argc, char **argv)
         flux_log_error (h, "flux_msghandler_add");
         goto done;
     }
+    if (!(ctx.unwrap_cache = zhash_new ())) {
+        flux_log_error (h, "zhash_new");
+        goto done;
+    }
     if (!(ctx.timer = flux_timer_watcher_create (r, 0., 0.,
                                                  batch_flush, &ctx))) {
         flux_log_error (h, "flux_timer_watcher_create");
@@ -834,6 +1270,7 @@ done:
     flux_security_destroy (ctx.sec);
 #endif
     validate_destroy (ctx.validate);
+    zhash_destroy (&ctx.unwrap_cache);
     return rc;
 }
 
@@ -36,21 +36,26 @@
 #include <jansson.h>
 #include <flux/core.h>
 
+#include "src/common/libjob/jobspec_cache.h"
+
 #include "validate.h"
 #include "worker.h"
 
 /* Tunables:
  */
 
-/* The maximum number of concurrent workers.
+/* The default and maximum number of concurrent workers
+ * (see validator-workers module option).
  */
-#define MAX_WORKER_COUNT 4
+#define DEFAULT_WORKER_COUNT 4
+#define MAX_WORKER_COUNT 16
 
 /* Start a new worker if backlog reaches this level for all active workers.
  */
 const int worker_queue_threshold = 32;
 
-/* Workers exit once they have been inactive for this many seconds.
+/* Workers exit once they have been inactive for this many seconds,
+ * unless the pool is persistent (see validator-persist module option).
  */
 const double worker_inactivity_timeout = 5.0;
 
@@ -58,6 +63,7 @@ const double worker_inactivity_timeout = 5.0;
 
 struct validate {
     flux_t *h;
+    int worker_count;
     struct worker *worker[MAX_WORKER_COUNT];
 };
 
@@ -71,7 +77,7 @@ static void validate_killall (struct validate *v)
         return;
     }
     flux_future_set_flux (cf, v->h);
-    for (i = 0; i < MAX_WORKER_COUNT; i++) {
+    for (i = 0; i < v->worker_count; i++) {
         if ((f = worker_kill (v->worker[i], SIGKILL)))
             flux_future_push (cf, NULL, f);
     }
@@ -92,7 +98,7 @@ int validate_stop_notify (struct validate *v, process_exit_f cb, void *arg)
     int count;
 
     count = 0;
-    for (i = 0; i < MAX_WORKER_COUNT; i++)
+    for (i = 0; i < v->worker_count; i++)
         count += worker_stop_notify (v->worker[i], cb, arg);
     return count;
 }
@@ -103,7 +109,7 @@ void validate_destroy (struct validate *v)
         int saved_errno = errno;
         int i;
         validate_killall (v);
-        for (i = 0; i < MAX_WORKER_COUNT; i++)
+        for (i = 0; i < v->worker_count; i++)
             worker_destroy (v->worker[i]);
         free (v);
         errno = saved_errno;
@@ -121,7 +127,9 @@ static bool str_ends_with (const char *str, const char *suffix)
 
 struct validate *validate_create (flux_t *h,
                                   const char *validate_path,
-                                  const char *validator_args)
+                                  const char *validator_args,
+                                  int worker_count,
+                                  bool persist)
 {
     struct validate *v;
     char *argv[5];
@@ -131,9 +139,16 @@ struct validate *validate_create (flux_t *h,
     char *validator_arg = NULL;
     size_t validator_argz_len = 0;
 
+    if (worker_count <= 0)
+        worker_count = DEFAULT_WORKER_COUNT;
+    if (worker_count > MAX_WORKER_COUNT) {
+        errno = EINVAL;
+        return NULL;
+    }
     if (!(v = calloc (1, sizeof (*v))))
         return NULL;
     v->h = h;
+    v->worker_count = worker_count;
 
     assert (validate_path != NULL);
 
@@ -162,8 +177,10 @@ struct validate *validate_create (flux_t *h,
     }
     argv[argc] = NULL;
 
-    for (i = 0; i < MAX_WORKER_COUNT; i++) {
-        if (!(v->worker[i] = worker_create (h, worker_inactivity_timeout,
+    for (i = 0; i < v->worker_count; i++) {
+        if (!(v->worker[i] = worker_create (h,
+                                            persist ? 0.
+                                                : worker_inactivity_timeout,
                                             validate_path,
                                             argc, argv)))
             goto error;
@@ -176,6 +193,38 @@ error:
     return NULL;
 }
 
+/* Report per-worker status for job-ingest.stats.get.
+ * Returns a JSON array (caller owns reference), or NULL with errno set.
+ */
+json_t *validate_stats_get (struct validate *v)
+{
+    json_t *a;
+    json_t *entry;
+    int i;
+
+    if (!(a = json_array ()))
+        goto nomem;
+    for (i = 0; i < v->worker_count; i++) {
+        struct worker *w = v->worker[i];
+
+        if (!(entry = json_pack ("{s:b s:i s:i s:i}",
+                                 "running", worker_is_running (w),
+                                 "queue_depth", worker_queue_depth (w),
+                                 "requests", worker_request_count (w),
+                                 "errors", worker_error_count (w))))
+            goto nomem;
+        if (json_array_append_new (a, entry) < 0) {
+            json_decref (entry);
+            goto nomem;
+        }
+    }
+    return a;
+nomem:
+    json_decref (a);
+    errno = ENOMEM;
+    return NULL;
+}
+
 /* Select worker with least backlog.  If none is running, or the best
  * has a backlog at or beyond threshold, activate a new one, if possible.
  */
@@ -185,7 +234,7 @@ struct worker *select_best_worker (struct validate *v)
     struct worker *idle = NULL;
     int i;
 
-    for (i = 0; i < MAX_WORKER_COUNT; i++) {
+    for (i = 0; i < v->worker_count; i++) {
         if (worker_is_running (v->worker[i])) {
             if (!best || (worker_queue_depth (v->worker[i])
                         < worker_queue_depth (best)))
@@ -212,8 +261,10 @@ flux_future_t *validate_jobspec (struct validate *v, const char *buf, int len)
     /* Make sure jobspec decodes as JSON (no YAML allowed here).
      * Capture any JSON parsing errors by returning them in a future.
      * Then re-encode in compact form to eliminate any white space (esp \n).
+     * The parse is served from the process jobspec cache, so bulk
+     * submissions of byte-identical jobspecs are only parsed once.
      */
-    if (!(o = json_loadb (buf, len, 0, &error))) {
+    if (!(o = jobspec_cache_parse (buf, len, &error))) {
         char errbuf[256];
         if (!(f = flux_future_create (NULL, NULL)))
             return NULL;
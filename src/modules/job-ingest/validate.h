@@ -11,7 +11,9 @@
 #ifndef _JOB_INGEST_VALIDATE_H
 #define _JOB_INGEST_VALIDATE_H
 
+#include <stdbool.h>
 #include <flux/core.h>
+#include <jansson.h>
 
 #include "types.h"
 
@@ -28,12 +30,23 @@ flux_future_t *validate_jobspec (struct validate *v, const char *buf, int len);
  */
 int validate_stop_notify (struct validate *v, process_exit_f cb, void *arg);
 
+/* Create a pool of 'worker_count' validation workers (0 selects the
+ * default).  If 'persist' is true, idle workers are kept running
+ * instead of exiting after the inactivity timeout.
+ */
 struct validate *validate_create (flux_t *h,
                                   const char *validate_path,
-                                  const char *validator_args);
+                                  const char *validator_args,
+                                  int worker_count,
+                                  bool persist);
 
 void validate_destroy (struct validate *v);
 
+/* Report per-worker status (running, queue_depth, requests, errors)
+ * as a JSON array.  Caller owns the returned reference.
+ */
+json_t *validate_stats_get (struct validate *v);
+
 #endif /* !_JOB_INGEST_VALIDATE_H */
 
 /*
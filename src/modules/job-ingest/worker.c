@@ -60,6 +60,8 @@ struct worker {
     zlist_t *trash;
     process_exit_f exit_cb;
     void *exit_arg;
+    int request_count;
+    int error_count;
 };
 
 static int worker_start (struct worker *w);
@@ -133,11 +135,14 @@ static void worker_timeout (flux_reactor_t *r, flux_watcher_t *timer,
 }
 
 /* Worker queue is empty - start inactivity timer.
+ * A timeout <= 0 means the worker is persistent (no churn).
  */
 static void worker_inactive (struct worker *w)
 {
-    flux_timer_watcher_reset (w->timer, w->inactivity_timeout, 0.);
-    flux_watcher_start (w->timer);
+    if (w->inactivity_timeout > 0.) {
+        flux_timer_watcher_reset (w->timer, w->inactivity_timeout, 0.);
+        flux_watcher_start (w->timer);
+    }
 }
 
 /* Worker queue is no longer empty - stop inactivity timer/start worker
@@ -185,6 +190,7 @@ static void worker_fulfill_future (struct worker *w, flux_future_t *f, const cha
     json_decref (o);
     return;
 error:
+    w->error_count++;
     flux_future_fulfill_error (f, errnum, errstr);
     json_decref (o);
 }
@@ -288,6 +294,7 @@ flux_future_t *worker_request (struct worker *w, const char *s)
     if (zlist_append (w->queue, f) < 0)
         goto error;
     flux_future_incref (f); // queue takes a reference on the future
+    w->request_count++;
     free (buf);
     return f;
 error:
@@ -364,6 +371,16 @@ int worker_queue_depth (struct worker *w)
     return zlist_size (w->queue);
 }
 
+int worker_request_count (struct worker *w)
+{
+    return w->request_count;
+}
+
+int worker_error_count (struct worker *w)
+{
+    return w->error_count;
+}
+
 bool worker_is_running (struct worker *w)
 {
     return (w->p ? true : false);
@@ -403,7 +420,9 @@ struct worker *worker_create (flux_t *h, double inactivity_timeout,
         return NULL;
     w->h = h;
     w->inactivity_timeout = inactivity_timeout;
-    if (!(w->timer = flux_timer_watcher_create (r, inactivity_timeout,
+    if (!(w->timer = flux_timer_watcher_create (r,
+                                                inactivity_timeout > 0.
+                                                    ? inactivity_timeout : 0.,
                                                 0., worker_timeout, w)))
         goto error;
     if (!(w->trash = zlist_new()))
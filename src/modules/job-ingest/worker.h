@@ -21,6 +21,8 @@ struct worker;
 flux_future_t *worker_request (struct worker *w, const char *s);
 
 int worker_queue_depth (struct worker *w);
+int worker_request_count (struct worker *w);
+int worker_error_count (struct worker *w);
 bool worker_is_running (struct worker *w);
 
 flux_future_t *worker_kill (struct worker *w, int signo);
@@ -26,7 +26,10 @@
 #include <flux/schedutil.h>
 #include <assert.h>
 
+#include "src/common/libutil/errno_safe.h"
+
 #include "job.h"
+#include "queue.h"
 #include "alloc.h"
 #include "event.h"
 #include "drain.h"
@@ -37,11 +40,17 @@ typedef enum {
     SCHED_UNLIMITED,    // send all sched.alloc requests immediately
 } sched_interface_t;
 
+/* Max jobs per sched.alloc request when the scheduler advertises
+ * batch support (see ready_cb).
+ */
+#define ALLOC_BATCH_COUNT 64
+
 struct alloc {
     struct job_manager *ctx;
     flux_msg_handler_t **handlers;
-    zlistx_t *queue;
+    struct queue *queue;
     sched_interface_t mode;
+    bool batch;         // scheduler can unpack batched alloc requests
     bool ready;
     bool disable;
     char *disable_reason;
@@ -70,18 +79,18 @@ static void interface_teardown (struct alloc *alloc, char *s, int errnum)
              * so they will automatically send alloc again.
              */
             if (job->alloc_pending) {
-                bool fwd = job->priority > FLUX_JOB_PRIORITY_DEFAULT ? true
-                                                                     : false;
                 bool cleared = false;
 
                 assert (job->handle == NULL);
-                if (!(job->handle = zlistx_insert (alloc->queue, job, fwd)))
+                if (queue_insert (alloc->queue, job) < 0)
                     flux_log_error (ctx->h, "%s: queue_insert", __FUNCTION__);
                 job->alloc_pending = 0;
                 job->alloc_queued = 1;
                 annotations_clear (job, &cleared);
                 if (cleared) {
-                    if (event_batch_pub_annotations (ctx->event, job) < 0)
+                    if (event_batch_pub_annotations (ctx->event,
+                                                     job,
+                                                     NULL) < 0)
                         flux_log_error (ctx->h,
                                         "%s: event_batch_pub_annotations",
                                         __FUNCTION__);
@@ -225,7 +234,7 @@ static void alloc_response_cb (flux_t *h, flux_msg_handler_t *mh,
         if (annotations_update (h, job, annotations) < 0)
             flux_log_error (h, "annotations_update: id=%ju", (uintmax_t)id);
         if (annotations) {
-            if (event_batch_pub_annotations (ctx->event, job) < 0)
+            if (event_batch_pub_annotations (ctx->event, job, annotations) < 0)
                 flux_log_error (ctx->h,
                                 "%s: event_batch_pub_annotations: id=%ju",
                                 __FUNCTION__, (uintmax_t)id);
@@ -248,7 +257,7 @@ static void alloc_response_cb (flux_t *h, flux_msg_handler_t *mh,
         }
         if (annotations_update (h, job, annotations) < 0)
             flux_log_error (h, "annotations_update: id=%ju", (uintmax_t)id);
-        if (event_batch_pub_annotations (ctx->event, job) < 0)
+        if (event_batch_pub_annotations (ctx->event, job, annotations) < 0)
             flux_log_error (ctx->h,
                             "%s: event_batch_pub_annotations: id=%ju",
                             __FUNCTION__, (uintmax_t)id);
@@ -258,7 +267,7 @@ static void alloc_response_cb (flux_t *h, flux_msg_handler_t *mh,
         job->alloc_pending = 0;
         annotations_clear (job, &cleared);
         if (cleared) {
-            if (event_batch_pub_annotations (ctx->event, job) < 0)
+            if (event_batch_pub_annotations (ctx->event, job, NULL) < 0)
                 flux_log_error (ctx->h,
                                 "%s: event_batch_pub_annotations: id=%ju",
                                 __FUNCTION__, (uintmax_t)id);
@@ -276,7 +285,7 @@ static void alloc_response_cb (flux_t *h, flux_msg_handler_t *mh,
         job->alloc_pending = 0;
         annotations_clear (job, &cleared);
         if (cleared) {
-            if (event_batch_pub_annotations (ctx->event, job) < 0)
+            if (event_batch_pub_annotations (ctx->event, job, NULL) < 0)
                 flux_log_error (ctx->h,
                                 "%s: event_batch_pub_annotations: id=%ju",
                                 __FUNCTION__, (uintmax_t)id);
@@ -322,6 +331,68 @@ error:
     return -1;
 }
 
+/* Send one sched.alloc request covering up to ALLOC_BATCH_COUNT jobs
+ * from the head of the queue (scheduler advertised batch support).
+ * Queue/flag updates are deferred until the send succeeds so a send
+ * failure leaves the queue untouched.
+ * Returns 0 on success, -1 on failure with errno set.
+ */
+static int alloc_batch_request (struct alloc *alloc)
+{
+    struct job_manager *ctx = alloc->ctx;
+    struct job *jobs[ALLOC_BATCH_COUNT];
+    struct job *job;
+    json_t *a = NULL;
+    json_t *entry;
+    flux_msg_t *msg = NULL;
+    int count = 0;
+    int i;
+
+    job = queue_first (alloc->queue);
+    while (job && count < ALLOC_BATCH_COUNT) {
+        jobs[count++] = job;
+        job = queue_next (alloc->queue);
+    }
+    if (!(a = json_array ()))
+        goto nomem;
+    for (i = 0; i < count; i++) {
+        if (!(entry = json_pack ("{s:I s:i s:i s:f}",
+                                 "id", jobs[i]->id,
+                                 "priority", jobs[i]->priority,
+                                 "userid", jobs[i]->userid,
+                                 "t_submit", jobs[i]->t_submit)))
+            goto nomem;
+        if (json_array_append_new (a, entry) < 0) {
+            json_decref (entry);
+            goto nomem;
+        }
+    }
+    if (!(msg = flux_request_encode ("sched.alloc", NULL)))
+        goto error;
+    if (flux_msg_pack (msg, "{s:O}", "jobs", a) < 0)
+        goto error;
+    if (flux_send (ctx->h, msg, 0) < 0)
+        goto error;
+    flux_msg_destroy (msg);
+    json_decref (a);
+    for (i = 0; i < count; i++) {
+        queue_delete (alloc->queue, jobs[i]);
+        jobs[i]->alloc_pending = 1;
+        jobs[i]->alloc_queued = 0;
+        alloc->alloc_pending_count++;
+        if ((jobs[i]->flags & FLUX_JOB_DEBUG))
+            (void)event_job_post_pack (ctx->event, jobs[i],
+                                       "debug.alloc-request", NULL);
+    }
+    return 0;
+nomem:
+    errno = ENOMEM;
+error:
+    ERRNO_SAFE_WRAP (flux_msg_destroy, msg);
+    ERRNO_SAFE_WRAP (json_decref, a);
+    return -1;
+}
+
 /* sched-hello:
  * Scheduler obtains a list of jobs that have resources allocated.
  */
@@ -376,10 +447,13 @@ static void ready_cb (flux_t *h, flux_msg_handler_t *mh,
 {
     struct job_manager *ctx = arg;
     const char *mode;
+    int batch = 0;
     int count;
     struct job *job;
 
-    if (flux_request_unpack (msg, NULL, "{s:s}", "mode", &mode) < 0)
+    if (flux_request_unpack (msg, NULL, "{s:s s?:b}",
+                                        "mode", &mode,
+                                        "batch", &batch) < 0)
         goto error;
     if (!strcmp (mode, "single"))
         ctx->alloc->mode = SCHED_SINGLE;
@@ -389,9 +463,11 @@ static void ready_cb (flux_t *h, flux_msg_handler_t *mh,
         errno = EPROTO;
         goto error;
     }
+    ctx->alloc->batch = batch ? true : false;
     ctx->alloc->ready = true;
-    flux_log (h, LOG_DEBUG, "scheduler: ready %s", mode);
-    count = zlistx_size (ctx->alloc->queue);
+    flux_log (h, LOG_DEBUG, "scheduler: ready %s%s",
+              mode, batch ? " (batched alloc)" : "");
+    count = queue_size (ctx->alloc->queue);
     if (flux_respond_pack (h, msg, "{s:i}", "count", count) < 0)
         flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
     /* Restart any free requests that might have been interrupted
@@ -428,7 +504,7 @@ static void prep_cb (flux_reactor_t *r, flux_watcher_t *w,
         return;
     if (alloc->mode == SCHED_SINGLE && alloc->alloc_pending_count > 0)
         return;
-    if (zlistx_first (alloc->queue))
+    if (queue_first (alloc->queue))
         flux_watcher_start (alloc->idle);
 }
 
@@ -448,14 +524,22 @@ static void check_cb (flux_reactor_t *r, flux_watcher_t *w,
         return;
     if (alloc->mode == SCHED_SINGLE && alloc->alloc_pending_count > 0)
         return;
-    if ((job = zlistx_first (alloc->queue))) {
+    if (alloc->mode == SCHED_UNLIMITED && alloc->batch) {
+        if (queue_first (alloc->queue)) {
+            if (alloc_batch_request (alloc) < 0) {
+                flux_log_error (ctx->h, "alloc_batch_request fatal error");
+                flux_reactor_stop_error (flux_get_reactor (ctx->h));
+            }
+        }
+        return;
+    }
+    if ((job = queue_first (alloc->queue))) {
         if (alloc_request (alloc, job) < 0) {
             flux_log_error (ctx->h, "alloc_request fatal error");
             flux_reactor_stop_error (flux_get_reactor (ctx->h));
             return;
         }
-        zlistx_delete (alloc->queue, job->handle);
-        job->handle = NULL;
+        queue_delete (alloc->queue, job);
         job->alloc_pending = 1;
         job->alloc_queued = 0;
         alloc->alloc_pending_count++;
@@ -487,9 +571,8 @@ int alloc_enqueue_alloc_request (struct alloc *alloc, struct job *job)
 {
     assert (job->state == FLUX_JOB_SCHED);
     if (!job->alloc_queued && !job->alloc_pending) {
-        bool fwd = job->priority > FLUX_JOB_PRIORITY_DEFAULT ? true : false;
         assert (job->handle == NULL);
-        if (!(job->handle = zlistx_insert (alloc->queue, job, fwd)))
+        if (queue_insert (alloc->queue, job) < 0)
             return -1;
         job->alloc_queued = 1;
     }
@@ -500,8 +583,7 @@ int alloc_enqueue_alloc_request (struct alloc *alloc, struct job *job)
 void alloc_dequeue_alloc_request (struct alloc *alloc, struct job *job)
 {
     if (job->alloc_queued) {
-        zlistx_delete (alloc->queue, job->handle);
-        job->handle = NULL;
+        queue_delete (alloc->queue, job);
         job->alloc_queued = 0;
     }
 }
@@ -519,20 +601,19 @@ int alloc_cancel_alloc_request (struct alloc *alloc, struct job *job)
 /* called from list_handle_request() */
 struct job *alloc_queue_first (struct alloc *alloc)
 {
-    return zlistx_first (alloc->queue);
+    return queue_first (alloc->queue);
 }
 
 struct job *alloc_queue_next (struct alloc *alloc)
 {
-    return zlistx_next (alloc->queue);
+    return queue_next (alloc->queue);
 }
 
 /* called from priority_handle_request() */
 void alloc_queue_reorder (struct alloc *alloc, struct job *job)
 {
-    bool fwd = job->priority > FLUX_JOB_PRIORITY_DEFAULT ? true : false;
-
-    zlistx_reorder (alloc->queue, job->handle, fwd);
+    if (queue_reorder (alloc->queue, job) < 0)
+        flux_log_error (alloc->ctx->h, "%s: queue_reorder", __FUNCTION__);
 }
 
 int alloc_pending_count (struct alloc *alloc)
@@ -624,7 +705,7 @@ static void alloc_admin_cb (flux_t *h,
                            "reason",
                            reason ? reason : "",
                            "queue_length",
-                           zlistx_size (alloc->queue),
+                           queue_size (alloc->queue),
                            "alloc_pending",
                            alloc->alloc_pending_count,
                            "free_pending",
@@ -646,7 +727,7 @@ void alloc_ctx_destroy (struct alloc *alloc)
         flux_watcher_destroy (alloc->prep);
         flux_watcher_destroy (alloc->check);
         flux_watcher_destroy (alloc->idle);
-        zlistx_destroy (&alloc->queue);
+        queue_destroy (alloc->queue);
         free (alloc->disable_reason);
         free (alloc);
         errno = saved_errno;
@@ -670,12 +751,8 @@ struct alloc *alloc_ctx_create (struct job_manager *ctx)
     if (!(alloc = calloc (1, sizeof (*alloc))))
         return NULL;
     alloc->ctx = ctx;
-    if (!(alloc->queue = zlistx_new()))
+    if (!(alloc->queue = queue_create ()))
         goto error;
-    zlistx_set_destructor (alloc->queue, job_destructor);
-    zlistx_set_comparator (alloc->queue, job_comparator);
-    zlistx_set_duplicator (alloc->queue, job_duplicator);
-
     if (flux_msg_handler_addvec (ctx->h, htab, ctx, &alloc->handlers) < 0)
         goto error;
     alloc->prep = flux_prepare_watcher_create (r, prep_cb, ctx);
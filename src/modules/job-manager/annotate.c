@@ -148,7 +148,7 @@ void annotate_handle_request (flux_t *h,
     }
     if (annotations_update (ctx->h, job, annotations) < 0)
         goto error;
-    if (event_batch_pub_annotations (ctx->event, job) < 0) {
+    if (event_batch_pub_annotations (ctx->event, job, annotations) < 0) {
         flux_log_error (h, "%s: event_batch_pub_annotations", __FUNCTION__);
         goto error;
     }
@@ -61,6 +61,7 @@ struct event {
 
 struct event_batch {
     struct event *event;
+    zhash_t *eventlogs; // eventlog key => entries accumulated this batch
     flux_kvs_txn_t *txn;
     flux_future_t *f;
     json_t *state_trans;
@@ -106,6 +107,30 @@ void publish_continuation (flux_future_t *f, void *arg)
     flux_future_destroy (f);
 }
 
+/* Add one KVS append per job eventlog touched this batch, then drop
+ * the accumulated entries.  Multiple events posted to the same job are
+ * concatenated into one append (entries are newline terminated, so
+ * concatenation is valid RFC 18).
+ */
+static int event_batch_flush_eventlogs (struct event_batch *batch)
+{
+    const char *entrystr;
+
+    if (!batch->txn && !(batch->txn = flux_kvs_txn_create ()))
+        return -1;
+    entrystr = zhash_first (batch->eventlogs);
+    while (entrystr) {
+        if (flux_kvs_txn_put (batch->txn,
+                              FLUX_KVS_APPEND,
+                              zhash_cursor (batch->eventlogs),
+                              entrystr) < 0)
+            return -1;
+        entrystr = zhash_next (batch->eventlogs);
+    }
+    zhash_destroy (&batch->eventlogs);
+    return 0;
+}
+
 /* Close the current batch, if any, and commit it.
  */
 void event_batch_commit (struct event *event)
@@ -115,6 +140,10 @@ void event_batch_commit (struct event *event)
 
     if (batch) {
         event->batch = NULL;
+        if (batch->eventlogs) {
+            if (event_batch_flush_eventlogs (batch) < 0)
+                goto error;
+        }
         if (batch->txn) {
             if (!(batch->f = flux_kvs_commit (ctx->h, NULL, 0, batch->txn)))
                 goto error;
@@ -181,6 +210,7 @@ void event_batch_destroy (struct event_batch *batch)
     if (batch) {
         int saved_errno = errno;
 
+        zhash_destroy (&batch->eventlogs);
         flux_kvs_txn_destroy (batch->txn);
         if (batch->f)
             (void)flux_future_wait_for (batch->f, -1);
@@ -245,24 +275,43 @@ static int event_batch_commit_event (struct event *event,
                                      json_t *entry)
 {
     char key[64];
-    char *entrystr = NULL;
+    char *entrystr;
+    char *prev;
 
     if (event_batch_start (event) < 0)
         return -1;
     if (flux_job_kvs_key (key, sizeof (key), job->id, "eventlog") < 0)
         return -1;
-    if (!event->batch->txn && !(event->batch->txn = flux_kvs_txn_create ()))
+    if (!event->batch->eventlogs
+        && !(event->batch->eventlogs = zhash_new ())) {
+        errno = ENOMEM;
         return -1;
+    }
     if (!(entrystr = eventlog_entry_encode (entry)))
         return -1;
-    if (flux_kvs_txn_put (event->batch->txn,
-                          FLUX_KVS_APPEND,
-                          key,
-                          entrystr) < 0) {
+    /* Accumulate entries per eventlog key so a job posting several events
+     * in one batch costs one KVS append, not one per event
+     * (see event_batch_flush_eventlogs()).
+     */
+    if ((prev = zhash_lookup (event->batch->eventlogs, key))) {
+        char *s;
+        if (asprintf (&s, "%s%s", prev, entrystr) < 0) {
+            free (entrystr);
+            errno = ENOMEM;
+            return -1;
+        }
         free (entrystr);
-        return -1;
+        zhash_update (event->batch->eventlogs, key, s);
+        zhash_freefn (event->batch->eventlogs, key, free);
+    }
+    else {
+        if (zhash_insert (event->batch->eventlogs, key, entrystr) < 0) {
+            free (entrystr);
+            errno = ENOMEM;
+            return -1;
+        }
+        zhash_freefn (event->batch->eventlogs, key, free);
     }
-    free (entrystr);
     return 0;
 }
 
@@ -293,22 +342,25 @@ error:
     return -1;
 }
 
-int event_batch_pub_annotations (struct event *event, struct job *job)
+int event_batch_pub_annotations (struct event *event,
+                                 struct job *job,
+                                 json_t *delta)
 {
     json_t *o;
 
-    /* do not check for job->annotations == NULL, all annotations
-     * being cleared is a possible change.
-     */
     if (event_batch_start (event) < 0)
         goto error;
     if (!event->batch->annotations) {
         if (!(event->batch->annotations = json_array ()))
             goto nomem;
     }
-    /* O? support in jansson 2.8 */
+    /* Publish only the fields changed by this update; consumers merge
+     * them with the same rules used here (a json null deletes a key).
+     * job->annotations == NULL means all annotations were cleared,
+     * represented as a json null delta.
+     * O? support in jansson 2.8 */
     if (job->annotations)
-        o = json_pack ("[I,O]", job->id, job->annotations);
+        o = json_pack ("[I,O]", job->id, delta);
     else
         o = json_pack ("[I,n]", job->id);
     if (!o)
@@ -539,15 +591,6 @@ error:
     return -1;
 }
 
-static int get_timestamp_now (double *timestamp)
-{
-    struct timespec ts;
-    if (clock_gettime (CLOCK_REALTIME, &ts) < 0)
-        return -1;
-    *timestamp = (1E-9 * ts.tv_nsec) + ts.tv_sec;
-    return 0;
-}
-
 int event_job_post_pack (struct event *event,
                          struct job *job,
                          const char *name,
@@ -561,8 +604,8 @@ int event_job_post_pack (struct event *event,
     flux_job_state_t old_state = job->state;
 
     va_start (ap, context_fmt);
-    if (get_timestamp_now (&timestamp) < 0)
-        goto error;
+    /* coarse reactor timestamp avoids a clock syscall per event */
+    timestamp = flux_reactor_now (flux_get_reactor (event->ctx->h));
     if (!(entry = eventlog_entry_vpack (timestamp, name, context_fmt, ap)))
         return -1;
     if (event_job_update (job, entry) < 0) // modifies job->state
@@ -36,8 +36,13 @@ int event_batch_pub_state (struct event *event, struct job *job,
                            double timestamp);
 
 /* Add notification of job's annotation change for publication.
+ * 'delta' holds only the fields changed by this update (a json null
+ * value deletes a key); it is ignored if the job's annotations were
+ * cleared, which is published as a json null.
  */
-int event_batch_pub_annotations (struct event *event, struct job *job);
+int event_batch_pub_annotations (struct event *event,
+                                 struct job *job,
+                                 json_t *delta);
 
 /* Add add response to batch, to be sent upon batch completion.
  */
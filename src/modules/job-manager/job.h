@@ -34,7 +34,8 @@ struct job {
 
     json_t *annotations;
 
-    void *handle;           // zlistx_t handle
+    void *handle;           // zlistx_t handle (managed by queue.c)
+    int queue_bucket;       // priority bucket containing job (queue.c)
     int refcount;           // private to job.c
 };
 
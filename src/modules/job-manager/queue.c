@@ -0,0 +1,165 @@
+/************************************************************\
+ * Copyright 2020 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* queue.c - priority-ordered queue of jobs awaiting allocation
+ *
+ * A sorted zlistx pays an O(n) comparator walk per insertion, which
+ * dominates the submit path once the queue gets deep.  Since RFC 16
+ * job priority is a small integer, the queue keeps one FIFO per
+ * priority level instead: insertion appends to the job's bucket
+ * (jobs usually arrive in t_submit order), and the front of the queue
+ * is the head of the highest non-empty bucket.  Cost is independent
+ * of queue depth, and iteration order is identical to the old sorted
+ * list: (1) priority, (2) t_submit.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <assert.h>
+#include <czmq.h>
+#include <flux/core.h>
+
+#include "queue.h"
+
+#define QUEUE_BUCKET_COUNT (FLUX_JOB_PRIORITY_MAX + 1)
+
+struct queue {
+    zlistx_t *bucket[QUEUE_BUCKET_COUNT];
+    int iter_bucket;        // bucket the iteration cursor is in
+    int size;
+};
+
+void queue_destroy (struct queue *queue)
+{
+    if (queue) {
+        int saved_errno = errno;
+        int i;
+        for (i = 0; i < QUEUE_BUCKET_COUNT; i++)
+            zlistx_destroy (&queue->bucket[i]);
+        free (queue);
+        errno = saved_errno;
+    }
+}
+
+struct queue *queue_create (void)
+{
+    struct queue *queue;
+    int i;
+
+    if (!(queue = calloc (1, sizeof (*queue))))
+        return NULL;
+    for (i = 0; i < QUEUE_BUCKET_COUNT; i++) {
+        if (!(queue->bucket[i] = zlistx_new ()))
+            goto error;
+        zlistx_set_destructor (queue->bucket[i], job_destructor);
+        zlistx_set_comparator (queue->bucket[i], job_comparator);
+        zlistx_set_duplicator (queue->bucket[i], job_duplicator);
+    }
+    queue->iter_bucket = -1;
+    return queue;
+error:
+    queue_destroy (queue);
+    return NULL;
+}
+
+int queue_insert (struct queue *queue, struct job *job)
+{
+    zlistx_t *l;
+    struct job *last;
+
+    assert (job->handle == NULL);
+    if (job->priority < 0 || job->priority >= QUEUE_BUCKET_COUNT) {
+        errno = EINVAL;
+        return -1;
+    }
+    l = queue->bucket[job->priority];
+    /* Jobs usually enter SCHED in t_submit order, so appending is the
+     * common case.  Fall back to a comparator insert when it isn't
+     * (e.g. requeue after scheduler reload).
+     */
+    if (!(last = zlistx_last (l)) || job_comparator (last, job) <= 0)
+        job->handle = zlistx_add_end (l, job);
+    else
+        job->handle = zlistx_insert (l, job, false);
+    if (!job->handle) {
+        errno = ENOMEM;
+        return -1;
+    }
+    job->queue_bucket = job->priority;
+    queue->size++;
+    return 0;
+}
+
+void queue_delete (struct queue *queue, struct job *job)
+{
+    assert (job->handle != NULL);
+    zlistx_delete (queue->bucket[job->queue_bucket], job->handle);
+    job->handle = NULL;
+    queue->size--;
+}
+
+int queue_reorder (struct queue *queue, struct job *job)
+{
+    void *handle = job->handle;
+    int bucket = job->queue_bucket;
+
+    assert (handle != NULL);
+    /* Position within a bucket depends only on t_submit, which never
+     * changes, so there is nothing to do unless the job changed buckets.
+     */
+    if (bucket == job->priority)
+        return 0;
+    job->handle = NULL;
+    if (queue_insert (queue, job) < 0) {
+        job->handle = handle;
+        return -1;
+    }
+    zlistx_delete (queue->bucket[bucket], handle);
+    queue->size--;
+    return 0;
+}
+
+struct job *queue_first (struct queue *queue)
+{
+    struct job *job;
+
+    queue->iter_bucket = QUEUE_BUCKET_COUNT - 1;
+    while (queue->iter_bucket >= 0) {
+        if ((job = zlistx_first (queue->bucket[queue->iter_bucket])))
+            return job;
+        queue->iter_bucket--;
+    }
+    return NULL;
+}
+
+struct job *queue_next (struct queue *queue)
+{
+    struct job *job;
+
+    if (queue->iter_bucket < 0)
+        return NULL;
+    if ((job = zlistx_next (queue->bucket[queue->iter_bucket])))
+        return job;
+    while (--queue->iter_bucket >= 0) {
+        if ((job = zlistx_first (queue->bucket[queue->iter_bucket])))
+            return job;
+    }
+    return NULL;
+}
+
+int queue_size (struct queue *queue)
+{
+    return queue->size;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
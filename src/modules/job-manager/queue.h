@@ -0,0 +1,59 @@
+/************************************************************\
+ * Copyright 2020 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _FLUX_JOB_MANAGER_QUEUE_H
+#define _FLUX_JOB_MANAGER_QUEUE_H
+
+#include "job.h"
+
+/* Priority-ordered container of jobs awaiting allocation.
+ *
+ * Jobs are bucketed by priority (one FIFO per priority level), so
+ * insertion and removal cost does not grow with queue depth, while
+ * iteration still visits jobs in (1) priority, (2) t_submit order.
+ * The queue takes a reference on each inserted job, and manages
+ * job->handle and job->queue_bucket internally.
+ */
+
+struct queue *queue_create (void);
+void queue_destroy (struct queue *queue);
+
+/* Insert 'job' at the position determined by its priority and t_submit.
+ * The job must not already be in the queue.
+ * Returns 0 on success, -1 on failure with errno set.
+ */
+int queue_insert (struct queue *queue, struct job *job);
+
+/* Remove 'job' from the queue.
+ * The job must be in the queue.
+ */
+void queue_delete (struct queue *queue, struct job *job);
+
+/* Re-position 'job' after its priority has changed.
+ * The job must be in the queue.
+ * Returns 0 on success, -1 on failure with errno set (job remains queued
+ * at its old position on failure).
+ */
+int queue_reorder (struct queue *queue, struct job *job);
+
+/* Iterate over queued jobs in priority, t_submit order.
+ * As with zlistx, the cursor is internal to the queue and is invalidated
+ * by insert/delete.
+ */
+struct job *queue_first (struct queue *queue);
+struct job *queue_next (struct queue *queue);
+
+int queue_size (struct queue *queue);
+
+#endif /* ! _FLUX_JOB_MANAGER_QUEUE_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
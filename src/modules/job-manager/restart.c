@@ -8,7 +8,12 @@
  * SPDX-License-Identifier: LGPL-3.0
 \************************************************************/
 
-/* restart - reload active jobs from the KVS */
+/* restart - reload active jobs from the KVS
+ *
+ * Eventlog lookups are pipelined:  up to 'lookup_window' lookup RPCs are
+ * kept in flight while the job directory is walked, so replay cost is
+ * dominated by KVS throughput rather than per-job round trip latency.
+ */
 
 #if HAVE_CONFIG_H
 #include "config.h"
@@ -16,9 +21,12 @@
 #include <stdlib.h>
 #include <argz.h>
 #include <envz.h>
+#include <czmq.h>
 #include <flux/core.h>
 
+#include "src/common/libutil/errno_safe.h"
 #include "src/common/libutil/fluid.h"
+#include "src/common/libutil/monotime.h"
 
 #include "job.h"
 #include "restart.h"
@@ -32,6 +40,10 @@ typedef int (*restart_map_f)(struct job *job, void *arg);
 
 const char *checkpoint_key = "checkpoint.job-manager";
 
+/* Maximum number of in-flight eventlog lookups during replay.
+ */
+const int lookup_window = 256;
+
 int restart_count_char (const char *s, char c)
 {
     int count = 0;
@@ -42,31 +54,54 @@ int restart_count_char (const char *s, char c)
     return count;
 }
 
-static int depthfirst_map_one (flux_t *h, const char *key, int dirskip,
-                               restart_map_f cb, void *arg)
+/* Send an eventlog lookup RPC for the job directory at 'key', without
+ * waiting for the response.  The jobid is attached to the returned future.
+ */
+static flux_future_t *depthfirst_map_one_send (flux_t *h, const char *key,
+                                               int dirskip)
 {
-    flux_jobid_t id;
-    flux_future_t *f;
-    const char *eventlog;
-    struct job *job = NULL;
+    flux_jobid_t *id;
+    flux_future_t *f = NULL;
     char path[64];
-    int rc = -1;
 
     if (strlen (key) <= dirskip) {
         errno = EINVAL;
-        return -1;
+        return NULL;
     }
-    if (fluid_decode (key + dirskip + 1, &id, FLUID_STRING_DOTHEX) < 0)
-        return -1;
-    if (flux_job_kvs_key (path, sizeof (path), id, "eventlog") < 0) {
+    if (!(id = malloc (sizeof (*id))))
+        return NULL;
+    if (fluid_decode (key + dirskip + 1, id, FLUID_STRING_DOTHEX) < 0)
+        goto error;
+    if (flux_job_kvs_key (path, sizeof (path), *id, "eventlog") < 0) {
         errno = EINVAL;
-        return -1;
+        goto error;
     }
     if (!(f = flux_kvs_lookup (h, NULL, 0, path)))
-        goto done;
+        goto error;
+    if (flux_future_aux_set (f, "jobid", id, free) < 0) {
+        flux_future_destroy (f);
+        return NULL;
+    }
+    return f;
+error:
+    ERRNO_SAFE_WRAP (free, id);
+    return NULL;
+}
+
+/* Wait for an eventlog lookup response, replay it, and pass the
+ * reconstructed job to 'cb'.  Destroys 'f'.
+ */
+static int depthfirst_map_one_finish (flux_future_t *f,
+                                      restart_map_f cb, void *arg)
+{
+    flux_jobid_t *id = flux_future_aux_get (f, "jobid");
+    const char *eventlog;
+    struct job *job = NULL;
+    int rc = -1;
+
     if (flux_kvs_lookup_get (f, &eventlog) < 0)
         goto done;
-    if (!(job = job_create_from_eventlog (id, eventlog)))
+    if (!(job = job_create_from_eventlog (*id, eventlog)))
         goto done;
     if (cb (job, arg) < 0)
         goto done;
@@ -78,7 +113,8 @@ done:
 }
 
 static int depthfirst_map (flux_t *h, const char *key,
-                           int dirskip, restart_map_f cb, void *arg)
+                           int dirskip, zlist_t *pending,
+                           restart_map_f cb, void *arg)
 {
     flux_future_t *f;
     const flux_kvsdir_t *dir;
@@ -100,15 +136,27 @@ static int depthfirst_map (flux_t *h, const char *key,
         goto done;
     while ((name = flux_kvsitr_next (itr))) {
         char *nkey;
-        int n;
+        int n = 0;
         if (!flux_kvsdir_isdir (dir, name))
             continue;
         if (!(nkey = flux_kvsdir_key_at (dir, name)))
             goto done_destroyitr;
-        if (path_level == 3) // orig 'key' = .A.B.C, thus 'nkey' is complete
-            n = depthfirst_map_one (h, nkey, dirskip, cb, arg);
+        if (path_level == 3) { // orig 'key' = .A.B.C, thus 'nkey' is complete
+            flux_future_t *f;
+            if (!(f = depthfirst_map_one_send (h, nkey, dirskip))
+                || zlist_append (pending, f) < 0) {
+                flux_future_destroy (f);
+                n = -1;
+            }
+            /* Once the lookup window is full, retire the oldest lookup
+             * before sending more.  Completions may belong to an earlier
+             * directory; the total count is what matters.
+             */
+            else if (zlist_size (pending) >= lookup_window)
+                n = depthfirst_map_one_finish (zlist_pop (pending), cb, arg);
+        }
         else
-            n = depthfirst_map (h, nkey, dirskip, cb, arg);
+            n = depthfirst_map (h, nkey, dirskip, pending, cb, arg);
         if (n < 0) {
             int saved_errno = errno;
             free (nkey);
@@ -193,14 +241,37 @@ int restart_from_kvs (struct job_manager *ctx)
     const char *dirname = "job";
     int dirskip = strlen (dirname);
     int count;
+    int n;
     struct job *job;
+    zlist_t *pending;
+    flux_future_t *f;
+    struct timespec t0;
 
     /* Load any active jobs present in the KVS at startup.
      */
-    count = depthfirst_map (ctx->h, dirname, dirskip, restart_map_cb, ctx);
+    monotime (&t0);
+    if (!(pending = zlist_new ())) {
+        errno = ENOMEM;
+        return -1;
+    }
+    count = depthfirst_map (ctx->h, dirname, dirskip, pending,
+                            restart_map_cb, ctx);
+    /* Retire lookups still in flight when the directory walk finished
+     * (or, on walk error, toss them).
+     */
+    while ((f = zlist_pop (pending))) {
+        if (count < 0)
+            flux_future_destroy (f);
+        else if ((n = depthfirst_map_one_finish (f, restart_map_cb, ctx)) < 0)
+            count = -1;
+        else
+            count += n;
+    }
+    zlist_destroy (&pending);
     if (count < 0)
         return -1;
-    flux_log (ctx->h, LOG_INFO, "restart: %d jobs", count);
+    flux_log (ctx->h, LOG_INFO, "restart: %d jobs (%.1fs)",
+              count, monotime_since (t0) / 1000);
     /* Initialize the count of "running" jobs
      */
     job = zhashx_first (ctx->active_jobs);
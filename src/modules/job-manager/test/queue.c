@@ -0,0 +1,130 @@
+/************************************************************\
+ * Copyright 2020 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <jansson.h>
+#include <flux/core.h>
+
+#include "src/common/libtap/tap.h"
+#include "src/modules/job-manager/queue.h"
+
+static struct job *make_job (flux_jobid_t id, int priority, double t_submit)
+{
+    struct job *job;
+
+    if (!(job = job_create ()))
+        BAIL_OUT ("job_create failed");
+    job->id = id;
+    job->priority = priority;
+    job->t_submit = t_submit;
+    return job;
+}
+
+void test_order (void)
+{
+    struct queue *queue;
+    struct job *job[4];
+    struct job *j;
+    int i;
+
+    if (!(queue = queue_create ()))
+        BAIL_OUT ("queue_create failed");
+    ok (queue_size (queue) == 0 && queue_first (queue) == NULL,
+        "new queue is empty");
+
+    /* Insert out of order and check that iteration is ordered by
+     * (1) priority, (2) t_submit.
+     */
+    job[0] = make_job (1, FLUX_JOB_PRIORITY_DEFAULT, 1.0);
+    job[1] = make_job (2, FLUX_JOB_PRIORITY_MAX, 3.0);
+    job[2] = make_job (3, FLUX_JOB_PRIORITY_DEFAULT, 2.0);
+    job[3] = make_job (4, FLUX_JOB_PRIORITY_MIN, 0.5);
+    ok (queue_insert (queue, job[0]) == 0
+        && queue_insert (queue, job[1]) == 0
+        && queue_insert (queue, job[2]) == 0
+        && queue_insert (queue, job[3]) == 0,
+        "inserted 4 jobs");
+    ok (queue_size (queue) == 4,
+        "queue_size returns 4");
+    ok (job[0]->handle != NULL,
+        "queue_insert set job->handle");
+
+    j = queue_first (queue);
+    ok (j != NULL && j->id == 2,
+        "queue_first returns highest priority job");
+    j = queue_next (queue);
+    ok (j != NULL && j->id == 1,
+        "queue_next breaks priority tie on t_submit");
+    j = queue_next (queue);
+    ok (j != NULL && j->id == 3,
+        "queue_next returns next default priority job");
+    j = queue_next (queue);
+    ok (j != NULL && j->id == 4,
+        "queue_next returns lowest priority job");
+    ok (queue_next (queue) == NULL,
+        "queue_next returns NULL at end of queue");
+
+    /* Raise job 4's priority above the default bucket and verify
+     * it is repositioned.
+     */
+    job[3]->priority = FLUX_JOB_PRIORITY_DEFAULT + 1;
+    ok (queue_reorder (queue, job[3]) == 0,
+        "queue_reorder works");
+    ok (queue_size (queue) == 4,
+        "queue_size is unchanged after reorder");
+    j = queue_first (queue);
+    j = queue_next (queue);
+    ok (j != NULL && j->id == 4,
+        "reordered job moved ahead of default priority jobs");
+
+    queue_delete (queue, job[3]);
+    ok (queue_size (queue) == 3 && job[3]->handle == NULL,
+        "queue_delete removed job and cleared handle");
+    j = queue_first (queue);
+    j = queue_next (queue);
+    ok (j != NULL && j->id == 1,
+        "deleted job no longer appears in iteration");
+
+    for (i = 0; i < 4; i++)
+        job_decref (job[i]);
+    queue_destroy (queue);
+}
+
+void test_badpriority (void)
+{
+    struct queue *queue;
+    struct job *job;
+
+    if (!(queue = queue_create ()))
+        BAIL_OUT ("queue_create failed");
+    job = make_job (1, FLUX_JOB_PRIORITY_MAX + 1, 1.0);
+    errno = 0;
+    ok (queue_insert (queue, job) < 0 && errno == EINVAL,
+        "queue_insert with out of range priority fails with EINVAL");
+    job_decref (job);
+    queue_destroy (queue);
+}
+
+int main (int argc, char *argv[])
+{
+    plan (NO_PLAN);
+
+    test_order ();
+    test_badpriority ();
+
+    done_testing ();
+    return 0;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
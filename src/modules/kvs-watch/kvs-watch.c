@@ -40,6 +40,26 @@ struct watcher {
     struct ns_monitor *nsm;     // back pointer for removal
     json_t *prev;               // previous watch value for KVS_WATCH_FULL/UNIQ
     int append_offset;          // offset for KVS_WATCH_APPEND
+    int start_offset;           // first byte of value to replay, or -1 for
+                                //  all (KVS_WATCH_APPEND)
+    int credit;                 // response credits remaining, -1 = unlimited
+                                //  (requestor has not opted in, see credit_cb)
+    zlist_t *backlog;           // responses (json val) queued awaiting credit
+};
+
+/* A lookup in flight at a given root version.  Watchers of the same
+ * (key, flags, cred) share one lookup per root transition rather than
+ * each sending their own, so the lookup cost of a commit is independent
+ * of the number of watchers on a key.  A shareable lookup is registered
+ * in nsm->lookups under 'hashkey' until its response arrives; 'watchers'
+ * are the watchers awaiting fan-out of the result.
+ */
+struct lookup {
+    flux_future_t *f;           // kvs.lookup-plus response future
+    char *hashkey;              // nsm->lookups key, NULL if not shareable
+    struct ns_monitor *nsm;     // back pointer for de-registration
+    zlist_t *watchers;          // watchers awaiting this result (borrowed)
+    int refcount;
 };
 
 /* Current KVS root.
@@ -66,6 +86,7 @@ struct ns_monitor {
     char *topic;                // topic string for subscription
     bool subscribed;            // subscription active
     flux_future_t *getrootf;    // initial getroot future
+    zhash_t *lookups;           // in-flight shared lookups (struct lookup)
 };
 
 /* Module state.
@@ -76,6 +97,25 @@ struct watch_ctx {
     zhash_t *namespaces;        // hash of monitored namespaces
 };
 
+static void lookup_decref (struct lookup *l)
+{
+    if (l && --l->refcount == 0) {
+        int saved_errno = errno;
+        flux_future_destroy (l->f);
+        zlist_destroy (&l->watchers);
+        free (l->hashkey);
+        free (l);
+        errno = saved_errno;
+    }
+}
+
+static struct lookup *lookup_incref (struct lookup *l)
+{
+    if (l)
+        l->refcount++;
+    return l;
+}
+
 static void watcher_destroy (struct watcher *w)
 {
     if (w) {
@@ -83,11 +123,19 @@ static void watcher_destroy (struct watcher *w)
         flux_msg_decref (w->request);
         free (w->key);
         if (w->lookups) {
-            flux_future_t *f;
-            while ((f = zlist_pop (w->lookups)))
-                flux_future_destroy (f);
+            struct lookup *l;
+            while ((l = zlist_pop (w->lookups))) {
+                zlist_remove (l->watchers, w);
+                lookup_decref (l);
+            }
             zlist_destroy (&w->lookups);
         }
+        if (w->backlog) {
+            json_t *val;
+            while ((val = zlist_pop (w->backlog)))
+                json_decref (val);
+            zlist_destroy (&w->backlog);
+        }
         json_decref (w->prev);
         free (w);
         errno = saved_errno;
@@ -95,7 +143,7 @@ static void watcher_destroy (struct watcher *w)
 }
 
 static struct watcher *watcher_create (const flux_msg_t *msg, const char *key,
-                                       int flags)
+                                       int flags, int start_offset)
 {
     struct watcher *w;
 
@@ -108,8 +156,12 @@ static struct watcher *watcher_create (const flux_msg_t *msg, const char *key,
         goto error;
     if (!(w->lookups = zlist_new ()))
         goto error_nomem;
+    if (!(w->backlog = zlist_new ()))
+        goto error_nomem;
     w->flags = flags;
     w->rootseq = -1;
+    w->start_offset = start_offset;
+    w->credit = -1;
     return w;
 error_nomem:
     errno = ENOMEM;
@@ -157,6 +209,7 @@ static void namespace_destroy (struct ns_monitor *nsm)
                 watcher_destroy (w);
             zlist_destroy (&nsm->watchers);
         }
+        zhash_destroy (&nsm->lookups);
         if (nsm->subscribed)
             (void)flux_event_unsubscribe (nsm->ctx->h, nsm->topic);
         free (nsm->topic);
@@ -175,6 +228,8 @@ static struct ns_monitor *namespace_create (struct watch_ctx *ctx,
         return NULL;
     if (!(nsm->watchers = zlist_new ()))
         goto error;
+    if (!(nsm->lookups = zhash_new ()))
+        goto error;
     if (!(nsm->ns_name = strdup (ns)))
         goto error;
     /* We are subscribing to the kvs.namespace-<NS> substring.
@@ -208,7 +263,26 @@ error:
     return NULL;
 }
 
-/* Helper for watcher_respond - is key a member of array?
+/* Helper for array_match - does a changed key affect a watched key?
+ * True if they are identical or one is a path prefix of the other
+ * ('.' separated components): a change to "a.b" invalidates a watch
+ * on "a.b.c" (parent was rewritten), and a change to "a.b.c"
+ * invalidates a watch on directory "a.b".
+ */
+static bool key_match (const char *changed, const char *key)
+{
+    int n = 0;
+
+    while (changed[n] && changed[n] == key[n])
+        n++;
+    if (changed[n] == '\0' && (key[n] == '\0' || key[n] == '.'))
+        return true;
+    if (key[n] == '\0' && changed[n] == '.')
+        return true;
+    return false;
+}
+
+/* Helper for watcher_respond - does any key in array affect watched key?
  * N.B. array 'a' can be NULL
  */
 static bool array_match (json_t *a, const char *key)
@@ -218,7 +292,7 @@ static bool array_match (json_t *a, const char *key)
 
     json_array_foreach (a, index, value) {
         const char *s = json_string_value (value);
-        if (s && !strcmp (s, key))
+        if (s && key_match (s, key))
             return true;
     }
     return false;
@@ -237,6 +311,86 @@ static void watcher_cleanup (struct ns_monitor *nsm, struct watcher *w)
         zhash_delete (nsm->ctx->namespaces, nsm->ns_name);
 }
 
+static void watcher_flush_backlog (flux_t *h, struct watcher *w)
+{
+    json_t *val;
+
+    while (w->credit != 0 && (val = zlist_pop (w->backlog))) {
+        if (flux_respond_pack (h, w->request, "{ s:o }", "val", val) < 0) {
+            json_decref (val);
+            flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+        }
+        if (w->credit > 0)
+            w->credit--;
+    }
+}
+
+/* Send a watch response containing 'val', stealing the caller's
+ * reference.  If the requestor has opted in to flow control and
+ * exhausted its response credits, queue the response until more are
+ * granted (see credit_cb()).
+ */
+static int watcher_send_response (flux_t *h, struct watcher *w, json_t *val)
+{
+    watcher_flush_backlog (h, w);
+    if (w->credit == 0 || zlist_size (w->backlog) > 0) {
+        if (zlist_append (w->backlog, val) < 0) {
+            json_decref (val);
+            errno = ENOMEM;
+            return -1;
+        }
+        return 0;
+    }
+    if (flux_respond_pack (h, w->request, "{ s:o }", "val", val) < 0) {
+        json_decref (val);
+        flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+        return -1;
+    }
+    if (w->credit > 0)
+        w->credit--;
+    return 0;
+}
+
+/* Send the first KVS_WATCH_APPEND response, where 'val' contains the
+ * full historical value.  Initialize w->append_offset and trim the
+ * replay to the watcher's start offset: the end of the value for
+ * FLUX_KVS_WATCH_TAIL, w->start_offset (clamped to the end) if the
+ * requestor supplied one, else the beginning, i.e. the whole value.
+ */
+static int respond_initial_append (flux_t *h, struct watcher *w, json_t *val)
+{
+    void *data = NULL;
+    int len;
+    int start = 0;
+    json_t *new_val;
+
+    if (treeobj_decode_val (val, &data, &len) < 0) {
+        flux_log_error (h, "%s: treeobj_decode_val", __FUNCTION__);
+        return -1;
+    }
+    if ((w->flags & FLUX_KVS_WATCH_TAIL))
+        start = len;
+    else if (w->start_offset >= 0)
+        start = w->start_offset < len ? w->start_offset : len;
+    w->append_offset = len;
+    if (start == 0) {
+        free (data);
+        if (watcher_send_response (h, w, json_incref (val)) < 0)
+            return -1;
+    }
+    else {
+        if (!(new_val = treeobj_create_val ((char *)data + start,
+                                            len - start))) {
+            free (data);
+            return -1;
+        }
+        free (data);
+        if (watcher_send_response (h, w, new_val) < 0)
+            return -1;
+    }
+    return 0;
+}
+
 static int handle_initial_response (flux_t *h,
                                     struct watcher *w,
                                     json_t *val,
@@ -249,18 +403,11 @@ static int handle_initial_response (flux_t *h,
         w->prev = json_incref (val);
 
     if ((w->flags & FLUX_KVS_WATCH_APPEND)) {
-        if (treeobj_decode_val (val,
-                                NULL,
-                                &w->append_offset) < 0) {
-            flux_log_error (h, "%s: treeobj_decode_val", __FUNCTION__);
+        if (respond_initial_append (h, w, val) < 0)
             return -1;
-        }
     }
-
-    if (flux_respond_pack (h, w->request, "{ s:O }", "val", val) < 0) {
-        flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+    else if (watcher_send_response (h, w, json_incref (val)) < 0)
         return -1;
-    }
 
     w->initial_rootseq = root_seq;
     w->responded = true;
@@ -277,10 +424,8 @@ static int handle_compare_response (flux_t *h,
          * ENOENT case */
         w->prev = json_incref (val);
 
-        if (flux_respond_pack (h, w->request, "{ s:O }", "val", val) < 0) {
-            flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+        if (watcher_send_response (h, w, json_incref (val)) < 0)
             return -1;
-        }
 
         w->responded = true;
     }
@@ -293,10 +438,8 @@ static int handle_compare_response (flux_t *h,
         json_decref (w->prev);
         w->prev = json_incref (val);
 
-        if (flux_respond_pack (h, w->request, "{ s:O }", "val", val) < 0) {
-            flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+        if (watcher_send_response (h, w, json_incref (val)) < 0)
             return -1;
-        }
     }
 
     return 0;
@@ -310,17 +453,8 @@ static int handle_append_response (flux_t *h,
         /* this is the first response case, store the first response
          * info.  This is here b/c initial response could have been
          * ENOENT case */
-        if (treeobj_decode_val (val,
-                                NULL,
-                                &w->append_offset) < 0) {
-            flux_log_error (h, "%s: treeobj_decode_val", __FUNCTION__);
-            return -1;
-        }
-
-        if (flux_respond_pack (h, w->request, "{ s:O }", "val", val) < 0) {
-            flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+        if (respond_initial_append (h, w, val) < 0)
             return -1;
-        }
 
         w->responded = true;
     }
@@ -358,11 +492,8 @@ static int handle_append_response (flux_t *h,
         free (new_data);
         w->append_offset = new_offset;
 
-        if (flux_respond_pack (h, w->request, "{ s:o }", "val", new_val) < 0) {
-            json_decref (new_val);
-            flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+        if (watcher_send_response (h, w, new_val) < 0)
             return -1;
-        }
     }
 
     return 0;
@@ -372,10 +503,8 @@ static int handle_normal_response (flux_t *h,
                                    struct watcher *w,
                                    json_t *val)
 {
-    if (flux_respond_pack (h, w->request, "{ s:O }", "val", val) < 0) {
-        flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+    if (watcher_send_response (h, w, json_incref (val)) < 0)
         return -1;
-    }
 
     w->responded = true;
     return 0;
@@ -485,20 +614,20 @@ error:
     w->finished = true;
 }
 
-/* One lookup has completed.
- * Pop ready futures off w->lookups and send responses, until
- * the list is empty, or a non-ready future is encountered.
+/* Pop ready lookups off w->lookups and send responses, until
+ * the list is empty, or a non-ready lookup is encountered.
  */
-static void lookup_continuation (flux_future_t *f, void *arg)
+static void watcher_drain (struct watcher *w)
 {
-    struct watcher *w = arg;
     struct ns_monitor *nsm = w->nsm;
+    struct lookup *l;
 
-    while ((f = zlist_first (w->lookups)) && flux_future_is_ready (f)) {
-        f = zlist_pop (w->lookups);
+    while ((l = zlist_first (w->lookups)) && flux_future_is_ready (l->f)) {
+        l = zlist_pop (w->lookups);
+        zlist_remove (l->watchers, w);
         if (!w->finished)
-            handle_lookup_response (f, w);
-        flux_future_destroy (f);
+            handle_lookup_response (l->f, w);
+        lookup_decref (l);
         /* if WAITCREATE and !WATCH, then we only care about sending
          * one response and being done.  We can use the responded flag
          * to indicate that condition.
@@ -512,6 +641,35 @@ static void lookup_continuation (flux_future_t *f, void *arg)
         watcher_cleanup (nsm, w);
 }
 
+/* One lookup has completed.
+ * De-register it so lookups at later commits start fresh, then fan the
+ * result out to each attached watcher.  Per-watcher response ordering
+ * is enforced by watcher_drain().
+ * N.B. draining a watcher may destroy it (and with it the namespace),
+ * and popping the last watcher reference destroys 'l', so iterate a
+ * duplicate of l->watchers and hold a reference on 'l' across the loop.
+ */
+static void lookup_continuation (flux_future_t *f, void *arg)
+{
+    struct lookup *l = arg;
+    struct watcher *w;
+    zlist_t *dup;
+
+    lookup_incref (l);
+    if (l->hashkey)
+        zhash_delete (l->nsm->lookups, l->hashkey);
+    if (!(dup = zlist_dup (l->watchers))) {
+        flux_log_error (flux_future_get_flux (f), "%s: zlist_dup",
+                        __FUNCTION__);
+        lookup_decref (l);
+        return;
+    }
+    while ((w = zlist_pop (dup)))
+        watcher_drain (w);
+    zlist_destroy (&dup);
+    lookup_decref (l);
+}
+
 /* Like flux_kvs_lookupat() except:
  * - targets kvs.lookup-plus, so root_ref & root_seq are available in
  *   response
@@ -579,26 +737,111 @@ error:
     return NULL;
 }
 
+/* Construct nsm->lookups hash key for watcher 'w' at the current commit.
+ * Credentials are part of the key since lookups are performed with the
+ * requestor's creds (see security note in watcher_respond()).
+ */
+static char *lookup_hashkey (struct ns_monitor *nsm, struct watcher *w)
+{
+    char *hashkey;
+
+    if (asprintf (&hashkey, "%d:%lu:%lu:%d:%s",
+                  nsm->commit->rootseq,
+                  (unsigned long)w->cred.userid,
+                  (unsigned long)w->cred.rolemask,
+                  w->flags,
+                  w->key) < 0)
+        return NULL;
+    return hashkey;
+}
+
+/* Send a lookup at the current commit on behalf of watcher 'w', and
+ * register it in nsm->lookups for sharing, unless it is the watcher's
+ * initial lookup (different request format, one per watcher by nature).
+ * Returns a lookup with one reference held by the caller.
+ */
+static struct lookup *lookup_create (struct ns_monitor *nsm, struct watcher *w)
+{
+    struct lookup *l;
+    bool initial = !w->initial_rpc_sent;
+
+    if (!(l = calloc (1, sizeof (*l))))
+        return NULL;
+    l->refcount = 1;
+    l->nsm = nsm;
+    if (!(l->watchers = zlist_new ()))
+        goto error_nomem;
+    if (!(l->f = lookupat (nsm->ctx->h,
+                           w,
+                           nsm->commit->rootref,
+                           nsm->commit->rootseq,
+                           nsm->ns_name)))
+        goto error;
+    if (flux_future_then (l->f, -1., lookup_continuation, l) < 0)
+        goto error;
+    if (!initial) {
+        if (!(l->hashkey = lookup_hashkey (nsm, w)))
+            goto error;
+        if (zhash_insert (nsm->lookups, l->hashkey, lookup_incref (l)) < 0) {
+            /* cannot happen - process_lookup_response() would have found
+             * the entry - but back out the reference for form's sake */
+            lookup_decref (l);
+            errno = EEXIST;
+            goto error;
+        }
+        zhash_freefn (nsm->lookups, l->hashkey,
+                      (zhash_free_fn *)lookup_decref);
+    }
+    return l;
+error_nomem:
+    errno = ENOMEM;
+error:
+    lookup_decref (l);
+    return NULL;
+}
+
+/* Attach watcher 'w' to lookup 'l' so the result is fanned out to it.
+ * The watcher's reference is dropped when the lookup is popped in
+ * watcher_drain() (or in watcher_destroy() at teardown).
+ */
+static int lookup_attach (struct lookup *l, struct watcher *w)
+{
+    if (zlist_append (w->lookups, lookup_incref (l)) < 0)
+        goto error;
+    if (zlist_append (l->watchers, w) < 0) {
+        zlist_remove (w->lookups, l);
+        goto error;
+    }
+    return 0;
+error:
+    lookup_decref (l);
+    errno = ENOMEM;
+    return -1;
+}
+
 static int process_lookup_response (struct ns_monitor *nsm, struct watcher *w)
 {
-    flux_future_t *f;
-    if (!(f = lookupat (nsm->ctx->h,
-                        w,
-                        nsm->commit->rootref,
-                        nsm->commit->rootseq,
-                        nsm->ns_name))) {
-        flux_log_error (nsm->ctx->h, "%s: lookupat", __FUNCTION__);
-        return -1;
+    struct lookup *l = NULL;
+    char *hashkey;
+
+    /* Share an in-flight lookup issued for another watcher of the same
+     * (key, flags, cred) at this commit, if there is one.
+     */
+    if (w->initial_rpc_sent) {
+        if (!(hashkey = lookup_hashkey (nsm, w)))
+            return -1;
+        l = lookup_incref (zhash_lookup (nsm->lookups, hashkey));
+        free (hashkey);
     }
-    if (zlist_append (w->lookups, f) < 0) {
-        flux_future_destroy (f);
-        errno = ENOMEM;
+    if (!l && !(l = lookup_create (nsm, w))) {
+        flux_log_error (nsm->ctx->h, "%s: lookup_create", __FUNCTION__);
         return -1;
     }
-    if (flux_future_then (f, -1., lookup_continuation, w) < 0) {
-        flux_future_destroy (f);
+    if (lookup_attach (l, w) < 0) {
+        lookup_decref (l);
         return -1;
     }
+    lookup_decref (l);
     w->rootseq = nsm->commit->rootseq;
     return 0;
 }
@@ -648,10 +891,10 @@ static void watcher_respond (struct ns_monitor *nsm, struct watcher *w)
     }
     /* flux_kvs_lookup (FLUX_KVS_WATCH)
      *
-     * Ordering note: KVS lookups can be returned out of order.  KVS lookup
-     * futures are added to the w->lookups zlist in commit order here, and
-     * in lookup_continuation(), fulfilled futures are popped off the head
-     * of w->lookups until an unfulfilled future is encountered, so that
+     * Ordering note: KVS lookups can be returned out of order.  Lookups
+     * are added to the w->lookups zlist in commit order here, and in
+     * watcher_drain(), fulfilled lookups are popped off the head of
+     * w->lookups until an unfulfilled lookup is encountered, so that
      * responses are always returned to the watcher in commit order.
      *
      * Security note: although the requestor has already been authenticated
@@ -772,6 +1015,60 @@ static void watcher_cancel_all (struct watch_ctx *ctx,
         flux_log_error (ctx->h, "%s: zhash_keys", __FUNCTION__);
 }
 
+/* Grant 'credits' response credits to watcher 'w' if it matches
+ * (sender, matchtag), and flush any responses queued awaiting credit.
+ * The first grant switches the watcher from unlimited responses to
+ * credit-based flow control.
+ */
+static void watcher_credit (struct ns_monitor *nsm, struct watcher *w,
+                            const char *sender, uint32_t matchtag,
+                            int credits)
+{
+    uint32_t t;
+    char *s;
+
+    if (flux_msg_get_matchtag (w->request, &t) < 0 || matchtag != t)
+        return;
+    if (flux_msg_get_route_first (w->request, &s) < 0)
+        return;
+    if (!strcmp (sender, s)) {
+        if (w->credit < 0)
+            w->credit = credits;
+        else
+            w->credit += credits;
+        watcher_flush_backlog (nsm->ctx->h, w);
+    }
+    free (s);
+}
+
+/* Grant credits to any namespace watcher matching (sender, matchtag).
+ */
+static void watcher_credit_all (struct watch_ctx *ctx,
+                                const char *sender, uint32_t matchtag,
+                                int credits)
+{
+    zlist_t *l;
+    char *name;
+    struct ns_monitor *nsm;
+    struct watcher *w;
+
+    if ((l = zhash_keys (ctx->namespaces))) {
+        name = zlist_first (l);
+        while (name) {
+            nsm = zhash_lookup (ctx->namespaces, name);
+            w = zlist_first (nsm->watchers);
+            while (w) {
+                watcher_credit (nsm, w, sender, matchtag, credits);
+                w = zlist_next (nsm->watchers);
+            }
+            name = zlist_next (l);
+        }
+        zlist_destroy (&l);
+    }
+    else
+        flux_log_error (ctx->h, "%s: zhash_keys", __FUNCTION__);
+}
+
 /* kvs.namespace-removed-* event
  * A namespace has been removed.  All watchers should receive ENOTSUP.
  */
@@ -959,18 +1256,27 @@ static void lookup_cb (flux_t *h, flux_msg_handler_t *mh,
     int flags;
     struct ns_monitor *nsm;
     struct watcher *w;
+    int offset = -1;
     const char *errmsg = NULL;
 
-    if (flux_request_unpack (msg, NULL, "{s:s s:s s:i}",
+    if (flux_request_unpack (msg, NULL, "{s:s s:s s:i s?:i}",
                              "namespace", &ns,
                              "key", &key,
-                             "flags", &flags) < 0)
+                             "flags", &flags,
+                             "offset", &offset) < 0)
         goto error;
     if ((flags & FLUX_KVS_WATCH) && !flux_msg_is_streaming (msg)) {
         errno = EPROTO;
         errmsg = "KVS watch request rejected without streaming RPC flag";
         goto error;
     }
+    if ((offset >= 0 || (flags & FLUX_KVS_WATCH_TAIL))
+        && (!(flags & FLUX_KVS_WATCH)
+            || !(flags & FLUX_KVS_WATCH_APPEND))) {
+        errno = EPROTO;
+        errmsg = "KVS watch offset requires WATCH and WATCH_APPEND flags";
+        goto error;
+    }
     if (!(nsm = namespace_monitor (ctx, ns)))
         goto error;
 
@@ -979,7 +1285,7 @@ static void lookup_cb (flux_t *h, flux_msg_handler_t *mh,
      * otherwise initial rpc will be sent upon getroot RPC response
      * or setroot event.
      */
-    if (!(w = watcher_create (msg, key, flags)))
+    if (!(w = watcher_create (msg, key, flags, offset)))
         goto error;
     w->nsm = nsm;
     if (zlist_append (nsm->watchers, w) < 0) {
@@ -1020,6 +1326,38 @@ static void cancel_cb (flux_t *h, flux_msg_handler_t *mh,
     free (sender);
 }
 
+/* kvs-watch.credit request
+ * The user called flux_rpc_credit() on a watch future, granting
+ * response credits to the stream identified by (sender, matchtag).
+ * No response is expected.
+ */
+static void credit_cb (flux_t *h, flux_msg_handler_t *mh,
+                       const flux_msg_t *msg, void *arg)
+{
+    struct watch_ctx *ctx = arg;
+    uint32_t matchtag;
+    int credits;
+    char *sender;
+
+    if (flux_request_unpack (msg, NULL, "{s:i s:i}",
+                             "matchtag", &matchtag,
+                             "credits", &credits) < 0) {
+        flux_log_error (h, "%s: flux_request_unpack", __FUNCTION__);
+        return;
+    }
+    if (credits <= 0) {
+        flux_log (h, LOG_ERR, "%s: invalid credits=%d", __FUNCTION__,
+                  credits);
+        return;
+    }
+    if (flux_msg_get_route_first (msg, &sender) < 0) {
+        flux_log_error (h, "%s: flux_msg_get_route_first", __FUNCTION__);
+        return;
+    }
+    watcher_credit_all (ctx, sender, matchtag, credits);
+    free (sender);
+}
+
 /* kvs-watch.disconnect request
  * This is sent automatically upon local connector disconnect.
  * The disconnect sender is used to find any watchers to be cancelled.
@@ -1056,13 +1394,25 @@ static void stats_cb (flux_t *h, flux_msg_handler_t *mh,
         goto nomem;
     nsm = zhash_first (ctx->namespaces);
     while (nsm) {
-        json_t *o = json_pack ("{s:i s:i s:s s:i}",
-                               "owner", (int)nsm->owner,
-                               "rootseq", nsm->commit ? nsm->commit->rootseq
-                                                      : -1,
-                               "rootref", nsm->commit ? nsm->commit->rootref
-                                                      : "(null)",
-                               "watchers", (int)zlist_size (nsm->watchers));
+        struct watcher *w;
+        int queued = 0;
+        json_t *o;
+
+        w = zlist_first (nsm->watchers);
+        while (w) {
+            queued += zlist_size (w->backlog);
+            w = zlist_next (nsm->watchers);
+        }
+        o = json_pack ("{s:i s:i s:s s:i s:i s:i}",
+                       "owner", (int)nsm->owner,
+                       "rootseq", nsm->commit ? nsm->commit->rootseq
+                                              : -1,
+                       "rootref", nsm->commit ? nsm->commit->rootref
+                                              : "(null)",
+                       "watchers", (int)zlist_size (nsm->watchers),
+                       "lookups-in-flight",
+                       (int)zhash_size (nsm->lookups),
+                       "responses-queued", queued);
         if (!o)
             goto nomem;
         if (json_object_set_new (stats, nsm->ns_name, o) < 0) {
@@ -1118,6 +1468,11 @@ static const struct flux_msg_handler_spec htab[] = {
       .cb           = cancel_cb,
       .rolemask     = FLUX_ROLE_USER
     },
+    { .typemask     = FLUX_MSGTYPE_REQUEST,
+      .topic_glob   = "kvs-watch.credit",
+      .cb           = credit_cb,
+      .rolemask     = FLUX_ROLE_USER
+    },
     { .typemask     = FLUX_MSGTYPE_REQUEST,
       .topic_glob   = "kvs-watch.disconnect",
       .cb           = disconnect_cb,
@@ -21,7 +21,11 @@
 #include <unistd.h>
 #include <stdbool.h>
 #include <ctype.h>
+#include <stdint.h>
+#include <fcntl.h>
 #include <sys/time.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
 #include <czmq.h>
 #include <flux/core.h>
 #include <jansson.h>
@@ -50,10 +54,12 @@ struct cache_entry {
     int errnum;
     char *blobref;
     int refcount;
+    struct cache *cache;    /* back pointer for occupancy accounting */
 };
 
 struct cache {
     zhashx_t *zhx;
+    int total_bytes;        /* sum of raw data lengths of valid entries */
 };
 
 struct cache_entry *cache_entry_create (const char *ref)
@@ -192,6 +198,8 @@ int cache_entry_set_raw (struct cache_entry *entry, const void *data, int len)
         if (wait_runqueue (entry->waitlist_valid) < 0)
             goto reset_invalid;
     }
+    if (entry->cache)
+        entry->cache->total_bytes += entry->len;
     return 0;
 reset_invalid:
     free (entry->data);
@@ -258,10 +266,27 @@ const json_t *cache_entry_get_treeobj (struct cache_entry *entry)
     return entry->o;
 }
 
+/* Drop the decoded treeobj representation, retaining the compact raw
+ * form.  It will be decoded again on the next cache_entry_get_treeobj().
+ * A no-op unless the entry is clean and unreferenced.
+ */
+static void cache_entry_compact (struct cache_entry *entry)
+{
+    if (entry
+        && entry->o
+        && !entry->dirty
+        && !entry->refcount) {
+        json_decref (entry->o);
+        entry->o = NULL;
+    }
+}
+
 void cache_entry_destroy (void *arg)
 {
     struct cache_entry *entry = arg;
     if (entry) {
+        if (entry->cache && entry->valid)
+            entry->cache->total_bytes -= entry->len;
         free (entry->data);
         json_decref (entry->o);
         if (entry->waitlist_notdirty)
@@ -315,6 +340,9 @@ int cache_insert (struct cache *cache, struct cache_entry *entry)
     if (cache && entry) {
         rc = zhashx_insert (cache->zhx, entry->blobref, entry);
         assert (rc == 0);
+        entry->cache = cache;
+        if (entry->valid)
+            cache->total_bytes += entry->len;
     }
     return 0;
 }
@@ -340,6 +368,11 @@ int cache_count_entries (struct cache *cache)
     return zhashx_size (cache->zhx);
 }
 
+int cache_total_bytes (struct cache *cache)
+{
+    return cache->total_bytes;
+}
+
 static int cache_entry_age (struct cache_entry *entry, int current_epoch)
 {
     if (!entry)
@@ -373,6 +406,13 @@ int cache_expire_entries (struct cache *cache, int current_epoch, int thresh)
                 zhashx_delete (cache->zhx, ref);
                 count++;
         }
+        /* Entries surviving expiry that were not used this epoch keep
+         * only their compact raw form; the decoded treeobj is dropped.
+         */
+        else if (entry
+                 && cache_entry_get_valid (entry)
+                 && cache_entry_age (entry, current_epoch) > 0)
+            cache_entry_compact (entry);
         ref = zlistx_next (keys);
     }
     zlistx_destroy (&keys);
@@ -435,11 +475,169 @@ done:
     return rc;
 }
 
+int cache_wait_destroy_sender (struct cache *cache, const char *sender)
+{
+    const char *key;
+    struct cache_entry *entry;
+    int n, count = 0;
+    int rc = -1;
+
+    FOREACH_ZHASHX (cache->zhx, key, entry) {
+        if (entry->waitlist_valid) {
+            if ((n = wait_destroy_sender (entry->waitlist_valid, sender)) < 0)
+                goto done;
+            count += n;
+        }
+        if (entry->waitlist_notdirty) {
+            if ((n = wait_destroy_sender (entry->waitlist_notdirty,
+                                          sender)) < 0)
+                goto done;
+            count += n;
+        }
+    }
+    rc = count;
+done:
+    return rc;
+}
+
 const char *cache_entry_get_blobref (struct cache_entry *entry)
 {
     return entry ? entry->blobref : NULL;
 }
 
+/* Snapshot file layout: 8 byte magic, 4 byte version, then per entry
+ * 4 byte blobref length, 4 byte data length, blobref (no NUL), data.
+ * The file is trusted local state; data is not re-hashed on restore.
+ */
+#define CACHE_SNAPSHOT_MAGIC   "kvscache"
+#define CACHE_SNAPSHOT_VERSION 1
+
+int cache_dump (struct cache *cache, const char *path)
+{
+    FILE *f;
+    struct cache_entry *entry;
+    const char *key;
+    uint32_t version = CACHE_SNAPSHOT_VERSION;
+    int count = 0;
+    int saved_errno;
+
+    if (!cache || !path) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!(f = fopen (path, "w")))
+        return -1;
+    if (fwrite (CACHE_SNAPSHOT_MAGIC, 8, 1, f) != 1
+        || fwrite (&version, sizeof (version), 1, f) != 1)
+        goto error;
+    FOREACH_ZHASHX (cache->zhx, key, entry) {
+        uint32_t reflen, datalen;
+
+        if (!entry->valid || entry->dirty || entry->len <= 0)
+            continue;
+        reflen = strlen (entry->blobref);
+        datalen = entry->len;
+        if (fwrite (&reflen, sizeof (reflen), 1, f) != 1
+            || fwrite (&datalen, sizeof (datalen), 1, f) != 1
+            || fwrite (entry->blobref, reflen, 1, f) != 1
+            || fwrite (entry->data, datalen, 1, f) != 1)
+            goto error;
+        count++;
+    }
+    if (fclose (f) != 0) {
+        f = NULL;
+        goto error;
+    }
+    return count;
+error:
+    saved_errno = errno;
+    if (f)
+        (void)fclose (f);
+    (void)unlink (path);
+    errno = saved_errno;
+    return -1;
+}
+
+int cache_restore (struct cache *cache, const char *path)
+{
+    int fd = -1;
+    struct stat sb;
+    const uint8_t *base = MAP_FAILED;
+    const uint8_t *cur, *end;
+    uint32_t version;
+    int count = 0;
+    int saved_errno;
+
+    if (!cache || !path) {
+        errno = EINVAL;
+        return -1;
+    }
+    if ((fd = open (path, O_RDONLY)) < 0)
+        return -1;
+    if (fstat (fd, &sb) < 0)
+        goto error;
+    if (sb.st_size < 8 + sizeof (version)) {
+        errno = EINVAL;
+        goto error;
+    }
+    if ((base = mmap (NULL, sb.st_size, PROT_READ, MAP_PRIVATE,
+                      fd, 0)) == MAP_FAILED)
+        goto error;
+    memcpy (&version, base + 8, sizeof (version));
+    if (memcmp (base, CACHE_SNAPSHOT_MAGIC, 8) != 0
+        || version != CACHE_SNAPSHOT_VERSION) {
+        errno = EINVAL;
+        goto error;
+    }
+    cur = base + 8 + sizeof (version);
+    end = base + sb.st_size;
+    while (cur < end) {
+        uint32_t reflen, datalen;
+        char ref[BLOBREF_MAX_STRING_SIZE];
+        struct cache_entry *entry;
+
+        if ((size_t)(end - cur) < 2 * sizeof (uint32_t)) {
+            errno = EINVAL;
+            goto error;
+        }
+        memcpy (&reflen, cur, sizeof (reflen));
+        memcpy (&datalen, cur + sizeof (reflen), sizeof (datalen));
+        cur += 2 * sizeof (uint32_t);
+        if (reflen == 0
+            || reflen >= sizeof (ref)
+            || datalen == 0
+            || (size_t)(end - cur) < (size_t)reflen + datalen) {
+            errno = EINVAL;
+            goto error;
+        }
+        memcpy (ref, cur, reflen);
+        ref[reflen] = '\0';
+        cur += reflen;
+        if (!zhashx_lookup (cache->zhx, ref)) {
+            if (!(entry = cache_entry_create (ref)))
+                goto error;
+            if (cache_entry_set_raw (entry, cur, datalen) < 0
+                || cache_insert (cache, entry) < 0) {
+                cache_entry_destroy (entry);
+                goto error;
+            }
+            count++;
+        }
+        cur += datalen;
+    }
+    munmap ((void *)base, sb.st_size);
+    close (fd);
+    return count;
+error:
+    saved_errno = errno;
+    if (base != MAP_FAILED)
+        munmap ((void *)base, sb.st_size);
+    if (fd >= 0)
+        close (fd);
+    errno = saved_errno;
+    return -1;
+}
+
 static void cache_entry_destroy_wrapper (void **arg)
 {
     struct cache_entry **entry = (struct cache_entry **)arg;
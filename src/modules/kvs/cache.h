@@ -137,8 +137,16 @@ int cache_remove_entry (struct cache *cache, const char *ref);
  */
 int cache_count_entries (struct cache *cache);
 
+/* Return the total size in bytes of raw data held by valid cache
+ * entries, maintained incrementally as entries are filled and
+ * removed.  Cheaper than cache_get_stats() for expiry decisions.
+ */
+int cache_total_bytes (struct cache *cache);
+
 /* Expire cache entries that are not dirty, not incomplete, and last
- * used more than 'thresh' epoch's ago.
+ * used more than 'thresh' epoch's ago.  Clean entries that survive
+ * expiry but were not used this epoch are compacted down to their raw
+ * data representation, dropping any decoded treeobj object.
  * Returns -1 on error, expired count on success.
  */
 int cache_expire_entries (struct cache *cache, int current_epoch, int thresh);
@@ -149,11 +157,26 @@ int cache_expire_entries (struct cache *cache, int current_epoch, int thresh);
 int cache_get_stats (struct cache *cache, tstat_t *ts, int *size,
                      int *incomplete, int *dirty);
 
+/* Dump clean, valid cache entries (blobref + raw data) to a snapshot
+ * file at 'path', and load such a snapshot back, skipping blobrefs
+ * already present.  Restored entries are clean and unreferenced, so
+ * they are subject to normal expiry.  The snapshot is trusted local
+ * state; data is not verified against its blobref on restore.
+ * Both return entry count on success, -1 on error.
+ */
+int cache_dump (struct cache *cache, const char *path);
+int cache_restore (struct cache *cache, const char *path);
+
 /* Destroy wait_t's on the waitqueue_t of any cache entry
  * if they meet match criteria.
  */
 int cache_wait_destroy_msg (struct cache *cache, wait_test_msg_f cb, void *arg);
 
+/* Destroy wait_t's on the waitqueue_t of any cache entry whose
+ * message was sent by 'sender', using the waitqueue sender index.
+ */
+int cache_wait_destroy_sender (struct cache *cache, const char *sender);
+
 #endif /* !_FLUX_KVS_CACHE_H */
 
 /*
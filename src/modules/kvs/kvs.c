@@ -39,6 +39,7 @@
 #include "kvstxn.h"
 #include "kvsroot.h"
 #include "kvssync.h"
+#include "kvsgc.h"
 
 /* Expire cache_entry after 'max_lastuse_age' heartbeats.
  */
@@ -51,6 +52,17 @@ const int max_lastuse_age = 5;
  */
 const int max_namespace_age = 1000;
 
+/* Tear down at most 'root_teardown_per_tick' removed namespace roots
+ * per pass over the teardown list.
+ *
+ * Bulk job completion can mark thousands of guest namespace roots for
+ * removal at nearly the same time.  Destroying them all inline would
+ * stall request processing, so quiesced roots are queued and released
+ * in bounded chunks from an idle watcher (with a fallback pass per
+ * heartbeat so teardown progresses even if the reactor never idles).
+ */
+const int root_teardown_per_tick = 100;
+
 /* Include root directory in kvs.namespace-<NS>-setroot event.
  */
 const bool event_includes_rootdir = true;
@@ -65,10 +77,19 @@ typedef struct {
     flux_watcher_t *prep_w;
     flux_watcher_t *idle_w;
     flux_watcher_t *check_w;
+    flux_watcher_t *merge_window_w;
+    zlist_t *teardownlist;  /* quiesced roots awaiting final teardown */
+    flux_watcher_t *teardown_idle_w;
     int transaction_merge;
+    double transaction_merge_window_ms; /* hold commits this long to merge */
+    int transaction_merge_window_max;   /* process early at this ready count */
+    const char *cache_snapshot;     /* path for cache dump/restore, or NULL */
     bool events_init;            /* flag */
     const char *hash_name;
     unsigned int seq;           /* for commit transactions */
+    kvsgc_t *gc;                /* created on first kvs.gc request (rank 0) */
+    char empty_rootref[BLOBREF_MAX_STRING_SIZE]; /* see get_empty_rootref() */
+    bool empty_rootref_valid;
 } kvs_ctx_t;
 
 struct kvs_cb_data {
@@ -77,6 +98,7 @@ struct kvs_cb_data {
     wait_t *wait;
     int errnum;
     bool ready;
+    double merge_window_wait_ms;
     char *sender;
 };
 
@@ -85,6 +107,8 @@ static void transaction_prep_cb (flux_reactor_t *r, flux_watcher_t *w,
 static void transaction_check_cb (flux_reactor_t *r, flux_watcher_t *w,
                                   int revents, void *arg);
 static void start_root_remove (kvs_ctx_t *ctx, const char *ns);
+static void root_teardown_idle_cb (flux_reactor_t *r, flux_watcher_t *w,
+                                   int revents, void *arg);
 
 /*
  * kvs_ctx_t functions
@@ -93,11 +117,15 @@ static void freectx (void *arg)
 {
     kvs_ctx_t *ctx = arg;
     if (ctx) {
+        kvsgc_destroy (ctx->gc);
         cache_destroy (ctx->cache);
         kvsroot_mgr_destroy (ctx->krm);
         flux_watcher_destroy (ctx->prep_w);
         flux_watcher_destroy (ctx->check_w);
         flux_watcher_destroy (ctx->idle_w);
+        flux_watcher_destroy (ctx->merge_window_w);
+        flux_watcher_destroy (ctx->teardown_idle_w);
+        zlist_destroy (&ctx->teardownlist);
         free (ctx);
     }
 }
@@ -152,9 +180,29 @@ static kvs_ctx_t *getctx (flux_t *h)
                 saved_errno = errno;
                 goto error;
             }
+            /* wakes the reactor when a commit aggregation window
+             * closes, no callback needed */
+            ctx->merge_window_w = flux_timer_watcher_create (r, 0., 0.,
+                                                             NULL, NULL);
+            if (!ctx->merge_window_w) {
+                saved_errno = errno;
+                goto error;
+            }
             flux_watcher_start (ctx->prep_w);
             flux_watcher_start (ctx->check_w);
         }
+        if (!(ctx->teardownlist = zlist_new ())) {
+            saved_errno = ENOMEM;
+            goto error;
+        }
+        zlist_autofree (ctx->teardownlist);
+        ctx->teardown_idle_w = flux_idle_watcher_create (r,
+                                                         root_teardown_idle_cb,
+                                                         ctx);
+        if (!ctx->teardown_idle_w) {
+            saved_errno = errno;
+            goto error;
+        }
         ctx->transaction_merge = 1;
         if (flux_aux_set (h, "kvssrv", ctx, freectx) < 0) {
             saved_errno = errno;
@@ -543,13 +591,15 @@ error:
 
 /* Return 0 on success, -1 on error.  Set stall variable appropriately
  */
+/* 'wait' may be NULL for a speculative load, in which case no waiter
+ * is parked on the cache entry; the caller only wants the content RPC
+ * in flight.
+ */
 static int load (kvs_ctx_t *ctx, const char *ref, wait_t *wait, bool *stall)
 {
     struct cache_entry *entry = cache_lookup (ctx->cache, ref, ctx->epoch);
     int saved_errno, ret;
 
-    assert (wait != NULL);
-
     /* Create an incomplete hash entry if none found.
      */
     if (!entry) {
@@ -587,7 +637,7 @@ static int load (kvs_ctx_t *ctx, const char *ref, wait_t *wait, bool *stall)
          * RPCs (the cache entry chck above protects against this),
          * but could be improved later.  See Issue #1751.
          */
-        if (cache_entry_wait_valid (entry, wait) < 0) {
+        if (wait && cache_entry_wait_valid (entry, wait) < 0) {
             /* no cleanup in this path, if an rpc was sent, it will
              * complete, but not call a waiter on this load.  Return
              * error so caller can handle error appropriately.
@@ -774,6 +824,10 @@ static int kvstxn_cache_cb (kvstxn_t *kt, struct cache_entry *entry, void *data)
         kvstxn_cleanup_dirty_cache_entry (kt, entry);
         return -1;
     }
+    /* Protect blobs stored mid-trace from an active gc pass.
+     */
+    if (kvsgc_active (cbd->ctx->gc))
+        kvsgc_mark_external (cbd->ctx->gc, blobref);
     if (cache_entry_wait_notdirty (entry, cbd->wait) < 0) {
         cbd->errnum = errno;
         flux_log_error (cbd->ctx->h, "cache_entry_wait_notdirty");
@@ -1037,6 +1091,7 @@ done:
             flux_log (ctx->h, LOG_DEBUG, "aggregated %d transactions (%d ops)",
                       count, opcount);
         }
+        tstat_push (&root->commit_stats, kvstxn_get_elapsed_ms (kt));
         setroot (ctx, root, kvstxn_get_newroot_ref (kt), root->seq + 1);
         setroot_event_send (ctx, root, names, kvstxn_get_keys (kt));
     } else {
@@ -1073,6 +1128,21 @@ static int kvstxn_prep_root_cb (struct kvsroot *root, void *arg)
     struct kvs_cb_data *cbd = arg;
 
     if (kvstxn_mgr_transaction_ready (root->ktm)) {
+        double rem = 0.;
+
+        if (cbd->ctx->transaction_merge)
+            rem = kvstxn_mgr_merge_window_remaining (
+                      root->ktm,
+                      cbd->ctx->transaction_merge_window_ms,
+                      cbd->ctx->transaction_merge_window_max);
+        /* within aggregation window, wait for more commits to arrive
+         * instead of spinning the reactor */
+        if (rem > 0.) {
+            if (cbd->merge_window_wait_ms == 0.
+                || rem < cbd->merge_window_wait_ms)
+                cbd->merge_window_wait_ms = rem;
+            return 0;
+        }
         cbd->ready = true;
         return 1;
     }
@@ -1093,6 +1163,11 @@ static void transaction_prep_cb (flux_reactor_t *r, flux_watcher_t *w,
 
     if (cbd.ready)
         flux_watcher_start (ctx->idle_w);
+    else if (cbd.merge_window_wait_ms > 0.) {
+        flux_timer_watcher_reset (ctx->merge_window_w,
+                                  cbd.merge_window_wait_ms / 1000., 0.);
+        flux_watcher_start (ctx->merge_window_w);
+    }
 }
 
 static int kvstxn_check_root_cb (struct kvsroot *root, void *arg)
@@ -1100,6 +1175,15 @@ static int kvstxn_check_root_cb (struct kvsroot *root, void *arg)
     struct kvs_cb_data *cbd = arg;
     kvstxn_t *kt;
 
+    /* aggregation window for this root still open, handled by
+     * transaction_prep_cb() on the next loop iteration */
+    if (cbd->ctx->transaction_merge
+        && kvstxn_mgr_merge_window_remaining (
+               root->ktm,
+               cbd->ctx->transaction_merge_window_ms,
+               cbd->ctx->transaction_merge_window_max) > 0.)
+        return 0;
+
     if ((kt = kvstxn_mgr_get_ready_transaction (root->ktm))) {
         if (cbd->ctx->transaction_merge) {
             /* if merge fails, set errnum in txn_t, let
@@ -1189,31 +1273,77 @@ static void dropcache_event_cb (flux_t *h, flux_msg_handler_t *mh,
                   expcount, size);
 }
 
-static int heartbeat_root_cb (struct kvsroot *root, void *arg)
+/* Final teardown of a root previously marked for removal, once it has
+ * quiesced (no watchers, no transactions in flight).
+ */
+static void root_teardown (kvs_ctx_t *ctx, struct kvsroot *root)
 {
-    kvs_ctx_t *ctx = arg;
+    if (event_unsubscribe (ctx, root->ns_name) < 0)
+        flux_log_error (ctx->h, "%s: event_unsubscribe", __FUNCTION__);
 
-    if (root->remove) {
-        if (!zlist_size (root->synclist)
+    if (kvsroot_mgr_remove_root (ctx->krm, root->ns_name) < 0)
+        flux_log_error (ctx->h, "%s: kvsroot_mgr_remove_root", __FUNCTION__);
+}
+
+static bool root_quiesced (struct kvsroot *root)
+{
+    return (!zlist_size (root->synclist)
             && !treq_mgr_transactions_count (root->trm)
-            && !kvstxn_mgr_ready_transaction_count (root->ktm)) {
+            && !kvstxn_mgr_ready_transaction_count (root->ktm));
+}
 
-            if (event_unsubscribe (ctx, root->ns_name) < 0)
-                flux_log_error (ctx->h, "%s: event_unsubscribe",
-                                __FUNCTION__);
+/* Tear down at most 'root_teardown_per_tick' queued roots, re-checking
+ * quiescence since a sync or transaction may have raced in after the
+ * root was queued (if so it is requeued on a later heartbeat).
+ */
+static void root_teardown_drain (kvs_ctx_t *ctx)
+{
+    int n = root_teardown_per_tick;
+    char *ns;
 
-            if (kvsroot_mgr_remove_root (ctx->krm, root->ns_name) < 0)
-                flux_log_error (ctx->h, "%s: kvsroot_mgr_remove_root",
-                                __FUNCTION__);
+    while (n > 0 && (ns = zlist_pop (ctx->teardownlist))) {
+        struct kvsroot *root;
+
+        if ((root = kvsroot_mgr_lookup_root (ctx->krm, ns))) {
+            root->remove_queued = false;
+            if (root->remove && root_quiesced (root)) {
+                root_teardown (ctx, root);
+                n--;
+            }
+        }
+        free (ns);
+    }
+    if (!zlist_size (ctx->teardownlist))
+        flux_watcher_stop (ctx->teardown_idle_w);
+}
+
+static void root_teardown_idle_cb (flux_reactor_t *r, flux_watcher_t *w,
+                                   int revents, void *arg)
+{
+    root_teardown_drain (arg);
+}
+
+static int heartbeat_root_cb (struct kvsroot *root, void *arg)
+{
+    kvs_ctx_t *ctx = arg;
+
+    if (root->remove) {
+        if (!root->remove_queued && root_quiesced (root)) {
+            if (zlist_append (ctx->teardownlist, root->ns_name) < 0) {
+                /* queue cannot grow - fall back to immediate teardown
+                 * so nothing leaks */
+                root_teardown (ctx, root);
+                return 0;
+            }
+            root->remove_queued = true;
+            flux_watcher_start (ctx->teardown_idle_w);
         }
     }
     else if (ctx->rank != 0
              && !root->remove
              && strcasecmp (root->ns_name, KVS_PRIMARY_NAMESPACE)
              && (ctx->epoch - root->last_update_epoch) > max_namespace_age
-             && !zlist_size (root->synclist)
-             && !treq_mgr_transactions_count (root->trm)
-             && !kvstxn_mgr_ready_transaction_count (root->ktm)) {
+             && root_quiesced (root)) {
         /* remove a root if it not the primary one, has timed out
          * on a follower node, and it does not have any watchers,
          * and no one is trying to write/change something.
@@ -1240,6 +1370,11 @@ static void heartbeat_cb (flux_t *h, flux_msg_handler_t *mh,
     if (kvsroot_mgr_iter_roots (ctx->krm, heartbeat_root_cb, ctx) < 0)
         flux_log_error (ctx->h, "%s: kvsroot_mgr_iter_roots", __FUNCTION__);
 
+    /* one bounded pass per heartbeat guarantees teardown progress even
+     * if the reactor never goes idle */
+    if (zlist_size (ctx->teardownlist) > 0)
+        root_teardown_drain (ctx);
+
     if (cache_expire_entries (ctx->cache, ctx->epoch, max_lastuse_age) < 0)
         flux_log_error (ctx->h, "%s: cache_expire_entries", __FUNCTION__);
 }
@@ -1259,6 +1394,19 @@ static int lookup_load_cb (lookup_t *lh, const char *ref, void *data)
     return 0;
 }
 
+/* Speculative load of a reference the lookup does not require but will
+ * likely want soon.  No waiter is registered and errors are ignored;
+ * at worst the prefetch is lost.
+ */
+static int lookup_prefetch_cb (lookup_t *lh, const char *ref, void *data)
+{
+    struct kvs_cb_data *cbd = data;
+
+    if (load (cbd->ctx, ref, NULL, NULL) < 0)
+        flux_log_error (cbd->ctx->h, "%s: load", __FUNCTION__);
+    return 0;
+}
+
 static void lookup_wait_error_cb (wait_t *w, int errnum, void *arg)
 {
     lookup_t *lh = arg;
@@ -1406,6 +1554,9 @@ static lookup_t *lookup_common (flux_t *h, flux_msg_handler_t *mh,
             goto done;
         }
 
+        /* overlap loads of references the walk will likely need next */
+        (void)lookup_iter_prefetch_refs (lh, lookup_prefetch_cb, &cbd);
+
         assert (wait_get_usecount (wait) > 0);
         goto stall;
     }
@@ -1426,13 +1577,82 @@ stall:
     return NULL;
 }
 
+/* Return true if 'msg' is a kvs.lookup that can be answered ENOENT
+ * straight from the namespace's miss cache, i.e. the key got ENOENT
+ * earlier at the same root sequence.  Only lookups against a
+ * namespace's current root qualify; explicit rootdir/rootseq lookups
+ * and replays go through the normal walk.
+ */
+static bool lookup_misscache_check (kvs_ctx_t *ctx, const flux_msg_t *msg)
+{
+    struct flux_msg_cred cred;
+    struct kvsroot *root;
+    const char *ns = NULL;
+    const char *key;
+    json_t *obj;
+    char *key_norm;
+    int flags, seq;
+    bool hit = false;
+
+    if (flux_msg_aux_get (msg, "lookup_handle"))
+        return false;
+    if (flux_request_unpack (msg, NULL, "{ s:s s:i }",
+                             "key", &key,
+                             "flags", &flags) < 0)
+        return false;
+    (void)flux_request_unpack (msg, NULL, "{ s:s }", "namespace", &ns);
+    if (!ns
+        || flux_request_unpack (msg, NULL, "{ s:o }", "rootdir", &obj) == 0
+        || flux_request_unpack (msg, NULL, "{ s:i }", "rootseq", &seq) == 0)
+        return false;
+    if (!(root = kvsroot_mgr_lookup_root_safe (ctx->krm, ns)))
+        return false;
+    if (flux_msg_get_cred (msg, &cred) < 0
+        || kvsroot_check_user (ctx->krm, root, cred) < 0)
+        return false;
+    if (!(key_norm = kvs_util_normalize_key (key, NULL)))
+        return false;
+    hit = kvsroot_misscache_check (root, key_norm);
+    free (key_norm);
+    return hit;
+}
+
+/* Record an ENOENT lookup result in the namespace's miss cache, so
+ * repeated polls for the key skip the walk until the root changes.
+ * The result must be pinned to the namespace's current root and not
+ * depend on another namespace via a symlink.
+ */
+static void lookup_misscache_insert (kvs_ctx_t *ctx, lookup_t *lh)
+{
+    struct kvsroot *root;
+    const char *ns;
+    const char *root_ref;
+
+    if (!(ns = lookup_get_namespace (lh))
+        || lookup_crossed_namespace (lh))
+        return;
+    if (!(root = kvsroot_mgr_lookup_root_safe (ctx->krm, ns)))
+        return;
+    if (root->seq != lookup_get_root_seq (lh)
+        || !(root_ref = lookup_get_root_ref (lh))
+        || strcmp (root->ref, root_ref) != 0)
+        return;
+    (void)kvsroot_misscache_add (root, lookup_get_path (lh));
+}
+
 static void lookup_request_cb (flux_t *h, flux_msg_handler_t *mh,
                                const flux_msg_t *msg, void *arg)
 {
-    lookup_t *lh;
+    kvs_ctx_t *ctx = arg;
+    lookup_t *lh = NULL;
     json_t *val;
     bool stall = false;
 
+    if (lookup_misscache_check (ctx, msg)) {
+        errno = ENOENT;
+        goto error;
+    }
+
     if (!(lh = lookup_common (h, mh, msg, arg, lookup_request_cb,
                               &stall))) {
         if (stall)
@@ -1441,6 +1661,7 @@ static void lookup_request_cb (flux_t *h, flux_msg_handler_t *mh,
     }
 
     if (!(val = lookup_get_value (lh))) {
+        lookup_misscache_insert (ctx, lh);
         errno = ENOENT;
         goto error;
     }
@@ -2195,8 +2416,8 @@ static void disconnect_request_cb (flux_t *h, flux_msg_handler_t *mh,
     if (kvsroot_mgr_iter_roots (ctx->krm, disconnect_request_root_cb, &cbd) < 0)
         flux_log_error (h, "%s: kvsroot_mgr_iter_roots", __FUNCTION__);
 
-    if (cache_wait_destroy_msg (ctx->cache, disconnect_cmp, sender) < 0)
-        flux_log_error (h, "%s: wait_destroy_msg", __FUNCTION__);
+    if (cache_wait_destroy_sender (ctx->cache, sender) < 0)
+        flux_log_error (h, "%s: cache_wait_destroy_sender", __FUNCTION__);
     free (sender);
 }
 
@@ -2204,8 +2425,11 @@ static int stats_get_root_cb (struct kvsroot *root, void *arg)
 {
     json_t *nsstats = arg;
     json_t *s;
+    json_t *tstats;
 
-    if (!(s = json_pack ("{ s:i s:i s:i s:i s:i }",
+    if (!(tstats = tstat_tojson (&root->commit_stats)))
+        return -1;
+    if (!(s = json_pack ("{ s:i s:i s:i s:i s:i s:o }",
                          "#syncers",
                          zlist_size (root->synclist),
                          "#no-op stores",
@@ -2214,7 +2438,9 @@ static int stats_get_root_cb (struct kvsroot *root, void *arg)
                          treq_mgr_transactions_count (root->trm),
                          "#readytransactions",
                          kvstxn_mgr_ready_transaction_count (root->ktm),
-                         "store revision", root->seq))) {
+                         "store revision", root->seq,
+                         "commit time (ms)", tstats))) {
+        json_decref (tstats);
         errno = ENOMEM;
         return -1;
     }
@@ -2252,12 +2478,13 @@ static void stats_get_cb (flux_t *h, flux_msg_handler_t *mh,
                               "max", tstat_max (&ts)*scale)))
         goto nomem;
 
-    if (!(cstats = json_pack ("{ s:f s:O s:i s:i s:i }",
+    if (!(cstats = json_pack ("{ s:f s:O s:i s:i s:i s:i }",
                               "obj size total (MiB)", (double)size/1048576,
                               "obj size (KiB)", tstats,
                               "#obj dirty", dirty,
                               "#obj incomplete", incomplete,
-                              "#faults", ctx->faults)))
+                              "#faults", ctx->faults,
+                              "#waiters", wait_queue_waiter_count ())))
         goto nomem;
 
     if (!(nsstats = json_object ()))
@@ -2308,6 +2535,7 @@ error:
 static int stats_clear_root_cb (struct kvsroot *root, void *arg)
 {
     kvstxn_mgr_clear_noop_stores (root->ktm);
+    memset (&root->commit_stats, 0, sizeof (root->commit_stats));
     return 0;
 }
 
@@ -2338,16 +2566,58 @@ static void stats_clear_request_cb (flux_t *h, flux_msg_handler_t *mh,
         flux_log_error (h, "%s: flux_respond", __FUNCTION__);
 }
 
+/* Copy the blobref of the empty root directory into 'ref'.  Every new
+ * namespace starts from this template root, and its blobref depends
+ * only on the configured hash, so it is computed once and reused for
+ * every namespace created thereafter.  The empty directory blob itself
+ * is stored by store_initial_rootdir() at startup.
+ */
+static int get_empty_rootref (kvs_ctx_t *ctx, char *ref, int ref_len)
+{
+    if (!ctx->empty_rootref_valid) {
+        json_t *rootdir = NULL;
+        void *data = NULL;
+        int len;
+        int saved_errno;
+
+        if (!(rootdir = treeobj_create_dir ())) {
+            flux_log_error (ctx->h, "%s: treeobj_create_dir", __FUNCTION__);
+            return -1;
+        }
+        if (!(data = treeobj_encode (rootdir))) {
+            flux_log_error (ctx->h, "%s: treeobj_encode", __FUNCTION__);
+            json_decref (rootdir);
+            return -1;
+        }
+        len = strlen (data);
+        if (blobref_hash (ctx->hash_name, data, len, ctx->empty_rootref,
+                          sizeof (ctx->empty_rootref)) < 0) {
+            saved_errno = errno;
+            flux_log_error (ctx->h, "%s: blobref_hash", __FUNCTION__);
+            free (data);
+            json_decref (rootdir);
+            errno = saved_errno;
+            return -1;
+        }
+        ctx->empty_rootref_valid = true;
+        free (data);
+        json_decref (rootdir);
+    }
+    if ((int)strlen (ctx->empty_rootref) >= ref_len) {
+        errno = EINVAL;
+        return -1;
+    }
+    strcpy (ref, ctx->empty_rootref);
+    return 0;
+}
+
 static int namespace_create (kvs_ctx_t *ctx, const char *ns,
                              uint32_t owner, int flags)
 {
     struct kvsroot *root;
-    json_t *rootdir = NULL;
     char ref[BLOBREF_MAX_STRING_SIZE];
-    void *data = NULL;
     flux_msg_t *msg = NULL;
     char *topic = NULL;
-    int len;
     int rv = -1;
 
     /* If namespace already exists, return EEXIST.  Doesn't matter if
@@ -2367,21 +2637,8 @@ static int namespace_create (kvs_ctx_t *ctx, const char *ns,
         return -1;
     }
 
-    if (!(rootdir = treeobj_create_dir ())) {
-        flux_log_error (ctx->h, "%s: treeobj_create_dir", __FUNCTION__);
+    if (get_empty_rootref (ctx, ref, sizeof (ref)) < 0)
         goto cleanup;
-    }
-
-    if (!(data = treeobj_encode (rootdir))) {
-        flux_log_error (ctx->h, "%s: treeobj_encode", __FUNCTION__);
-        goto cleanup;
-    }
-    len = strlen (data);
-
-    if (blobref_hash (ctx->hash_name, data, len, ref, sizeof (ref)) < 0) {
-        flux_log_error (ctx->h, "%s: blobref_hash", __FUNCTION__);
-        goto cleanup;
-    }
 
     setroot (ctx, root, ref, 0);
 
@@ -2417,8 +2674,6 @@ static int namespace_create (kvs_ctx_t *ctx, const char *ns,
 cleanup:
     if (rv < 0)
         kvsroot_mgr_remove_root (ctx->krm, ns);
-    free (data);
-    json_decref (rootdir);
     free (topic);
     flux_msg_destroy (msg);
     return rv;
@@ -2457,6 +2712,61 @@ error:
         flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
 }
 
+/* Create several namespaces in one request, e.g. for job-manager
+ * namespace churn at high job throughput.  Creations are applied in
+ * order; on failure, namespaces created before the failing entry
+ * remain, and the error names the failing namespace.
+ */
+static void namespace_create_multi_request_cb (flux_t *h,
+                                               flux_msg_handler_t *mh,
+                                               const flux_msg_t *msg,
+                                               void *arg)
+{
+    kvs_ctx_t *ctx = arg;
+    json_t *namespaces;
+    json_t *entry;
+    size_t index;
+    const char *errns = NULL;
+
+    assert (ctx->rank == 0);
+
+    if (flux_request_unpack (msg, NULL, "{ s:o }",
+                             "namespaces", &namespaces) < 0) {
+        flux_log_error (h, "%s: flux_request_unpack", __FUNCTION__);
+        goto error;
+    }
+    if (!json_is_array (namespaces) || json_array_size (namespaces) == 0) {
+        errno = EPROTO;
+        goto error;
+    }
+    json_array_foreach (namespaces, index, entry) {
+        const char *ns;
+        uint32_t owner;
+        int flags;
+
+        /* N.B. owner read into uint32_t */
+        if (json_unpack (entry, "{ s:s s:i s:i }",
+                         "namespace", &ns,
+                         "owner", &owner,
+                         "flags", &flags) < 0) {
+            errno = EPROTO;
+            goto error;
+        }
+        if (owner == FLUX_USERID_UNKNOWN)
+            owner = getuid ();
+        if (namespace_create (ctx, ns, owner, flags) < 0) {
+            errns = ns;
+            goto error;
+        }
+    }
+    if (flux_respond (h, msg, NULL) < 0)
+        flux_log_error (h, "%s: flux_respond", __FUNCTION__);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, errns) < 0)
+        flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+}
+
 static int root_remove_process_transactions (treq_t *tr, void *data)
 {
     struct kvs_cb_data *cbd = data;
@@ -2589,6 +2899,58 @@ error:
         flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
 }
 
+/* Remove several namespaces in one request.  Removals are applied in
+ * order; on failure, namespaces removed before the failing entry stay
+ * removed, and the error names the failing namespace.
+ */
+static void namespace_remove_multi_request_cb (flux_t *h,
+                                               flux_msg_handler_t *mh,
+                                               const flux_msg_t *msg,
+                                               void *arg)
+{
+    kvs_ctx_t *ctx = arg;
+    json_t *namespaces;
+    json_t *entry;
+    size_t index;
+    const char *errns = NULL;
+
+    assert (ctx->rank == 0);
+
+    if (flux_request_unpack (msg, NULL, "{ s:o }",
+                             "namespaces", &namespaces) < 0) {
+        flux_log_error (h, "%s: flux_request_unpack", __FUNCTION__);
+        goto error;
+    }
+    if (!json_is_array (namespaces) || json_array_size (namespaces) == 0) {
+        errno = EPROTO;
+        goto error;
+    }
+    json_array_foreach (namespaces, index, entry) {
+        const char *ns = json_string_value (entry);
+
+        if (!ns) {
+            errno = EPROTO;
+            goto error;
+        }
+        if (!strcasecmp (ns, KVS_PRIMARY_NAMESPACE)) {
+            errno = ENOTSUP;
+            errns = ns;
+            goto error;
+        }
+        if (namespace_remove (ctx, ns) < 0) {
+            flux_log_error (h, "%s: namespace_remove", __FUNCTION__);
+            errns = ns;
+            goto error;
+        }
+    }
+    if (flux_respond (h, msg, NULL) < 0)
+        flux_log_error (h, "%s: flux_respond", __FUNCTION__);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, errns) < 0)
+        flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+}
+
 static void namespace_removed_event_cb (flux_t *h, flux_msg_handler_t *mh,
                                         const flux_msg_t *msg, void *arg)
 {
@@ -2780,8 +3142,39 @@ error:
 
 /* see comments above in event_subscribe() regarding event
  * subscriptions to kvs.namespace */
+/* Garbage collect unreachable blobs from the content backing store.
+ * The mark and sweep pass runs asynchronously (see kvsgc.c); the
+ * response carries progress/occupancy stats when the pass completes.
+ */
+static void gc_request_cb (flux_t *h, flux_msg_handler_t *mh,
+                           const flux_msg_t *msg, void *arg)
+{
+    kvs_ctx_t *ctx = arg;
+    const char *errstr = NULL;
+
+    if (flux_request_decode (msg, NULL, NULL) < 0)
+        goto error;
+    if (ctx->rank != 0) {
+        errno = EPROTO;
+        errstr = "kvs.gc request must be sent to rank 0";
+        goto error;
+    }
+    if (!ctx->gc && !(ctx->gc = kvsgc_create (h, ctx->krm)))
+        goto error;
+    if (kvsgc_start (ctx->gc, msg) < 0) {
+        if (errno == EINPROGRESS)
+            errstr = "garbage collection already in progress";
+        goto error;
+    }
+    return; /* response sent when the pass completes */
+error:
+    if (flux_respond_error (h, msg, errno, errstr) < 0)
+        flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+}
+
 static const struct flux_msg_handler_spec htab[] = {
     { FLUX_MSGTYPE_REQUEST, "kvs.stats.get",  stats_get_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "kvs.gc",         gc_request_cb, 0 },
     { FLUX_MSGTYPE_REQUEST, "kvs.stats.clear",stats_clear_request_cb, 0 },
     { FLUX_MSGTYPE_EVENT,   "kvs.stats.clear",stats_clear_event_cb, 0 },
     { FLUX_MSGTYPE_EVENT,   "kvs.namespace-*-setroot",  setroot_event_cb, 0 },
@@ -2806,8 +3199,12 @@ static const struct flux_msg_handler_spec htab[] = {
     { FLUX_MSGTYPE_REQUEST, "kvs.relayfence", relayfence_request_cb, 0 },
     { FLUX_MSGTYPE_REQUEST, "kvs.namespace-create",
                             namespace_create_request_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "kvs.namespace-create-multi",
+                            namespace_create_multi_request_cb, 0 },
     { FLUX_MSGTYPE_REQUEST, "kvs.namespace-remove",
                             namespace_remove_request_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "kvs.namespace-remove-multi",
+                            namespace_remove_multi_request_cb, 0 },
     { FLUX_MSGTYPE_EVENT,   "kvs.namespace-*-removed",
                             namespace_removed_event_cb, 0 },
     { FLUX_MSGTYPE_REQUEST, "kvs.namespace-list",
@@ -2824,8 +3221,17 @@ static void process_args (kvs_ctx_t *ctx, int ac, char **av)
     int i;
 
     for (i = 0; i < ac; i++) {
-        if (strncmp (av[i], "transaction-merge=", 13) == 0)
+        if (strncmp (av[i], "transaction-merge-window-ms=", 28) == 0)
+            ctx->transaction_merge_window_ms = strtod (av[i]+28, NULL);
+        else if (strncmp (av[i], "transaction-merge-window-max=", 29) == 0)
+            ctx->transaction_merge_window_max = strtoul (av[i]+29, NULL, 10);
+        else if (strncmp (av[i], "transaction-merge=", 13) == 0)
             ctx->transaction_merge = strtoul (av[i]+13, NULL, 10);
+        else if (strncmp (av[i], "cache-snapshot=", 15) == 0)
+            ctx->cache_snapshot = av[i]+15;
+        else if (strncmp (av[i], "inline-val-max=", 15) == 0)
+            kvsroot_mgr_set_inline_val_max (ctx->krm,
+                                            strtoul (av[i]+15, NULL, 10));
         else
             flux_log (ctx->h, LOG_ERR, "Unknown option `%s'", av[i]);
     }
@@ -2911,6 +3317,11 @@ static int store_initial_rootdir (kvs_ctx_t *ctx, char *ref, int ref_len)
         flux_log_error (ctx->h, "%s: blobref_hash", __FUNCTION__);
         goto error;
     }
+    /* prime the template root used by namespace_create() */
+    if (strlen (ref) < sizeof (ctx->empty_rootref)) {
+        strcpy (ctx->empty_rootref, ref);
+        ctx->empty_rootref_valid = true;
+    }
     if (!(entry = cache_lookup (ctx->cache, ref, ctx->epoch))) {
         if (!(entry = cache_entry_create (ref))) {
             flux_log_error (ctx->h, "%s: cache_entry_create", __FUNCTION__);
@@ -2970,6 +3381,27 @@ int mod_main (flux_t *h, int argc, char **argv)
         goto done;
     }
     process_args (ctx, argc, argv);
+    /* The kvs handles bursts of lookups and setroot events; drain a
+     * batch of messages per reactor loop rather than paying full loop
+     * overhead per message.
+     */
+    if (flux_dispatch_set_batch_limit (h, 16) < 0)
+        flux_log_error (h, "error setting dispatch batch limit");
+    /* Warm the cache from a snapshot saved by a previous instance of
+     * this module, if one is present, before any lookups arrive.
+     */
+    if (ctx->cache_snapshot) {
+        int n;
+
+        if ((n = cache_restore (ctx->cache, ctx->cache_snapshot)) < 0) {
+            if (errno != ENOENT)
+                flux_log_error (h, "error restoring cache snapshot from %s",
+                                ctx->cache_snapshot);
+        }
+        else
+            flux_log (h, LOG_INFO, "restored %d cache entries from %s",
+                      n, ctx->cache_snapshot);
+    }
     if (ctx->rank == 0) {
         struct kvsroot *root;
         char rootref[BLOBREF_MAX_STRING_SIZE];
@@ -3037,6 +3469,16 @@ int mod_main (flux_t *h, int argc, char **argv)
             }
         }
     }
+    if (ctx->cache_snapshot) {
+        int n;
+
+        if ((n = cache_dump (ctx->cache, ctx->cache_snapshot)) < 0)
+            flux_log_error (h, "error saving cache snapshot to %s",
+                            ctx->cache_snapshot);
+        else
+            flux_log (h, LOG_INFO, "saved %d cache entries to %s",
+                      n, ctx->cache_snapshot);
+    }
     rc = 0;
 done:
     flux_msg_handler_delvec (handlers);
@@ -0,0 +1,421 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* kvsgc.c - garbage collect unreachable blobs from the backing store
+ *
+ * A mark and sweep pass runs in two phases, both asynchronous and with
+ * bounded work per reactor callback so the kvs module stays responsive:
+ *
+ * mark: trace blobrefs reachable from the current root of every
+ * namespace.  Directory blobs are fetched with CONTENT_FLAG_CACHE_BYPASS
+ * (straight from the backing store, without polluting the rank 0
+ * content cache) with at most gc_max_inflight loads outstanding.
+ * Reachable refs are shipped to the backing store in batches via
+ * content-backing.gc-mark.  Blobs stored by transactions that commit
+ * while the trace runs are added to the mark set as they are written
+ * (see kvsgc_mark_external()), and the root set is re-scanned each time
+ * the walk drains, so a moving root does not invalidate the pass.
+ *
+ * sweep: once the trace is stable, content-backing.gc-sweep directs the
+ * backing store to delete everything not in the mark set.  A blob that
+ * becomes newly referenced between the final mark flush and the sweep
+ * executing could in principle be lost; in practice only a transaction
+ * that re-references an existing unreachable blob without storing it
+ * (e.g. a hand-built treeobj) can hit that window, so running gc while
+ * such writers are active is not supported.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <czmq.h>
+#include <jansson.h>
+#include <flux/core.h>
+
+#include "src/common/libkvs/treeobj.h"
+#include "src/common/libutil/blobref.h"
+#include "src/common/libutil/monotime.h"
+#include "src/common/libutil/log.h"
+
+#include "kvsroot.h"
+#include "kvsgc.h"
+
+static const int gc_max_inflight = 16;      /* outstanding dir loads */
+static const int gc_mark_batch_limit = 1024; /* refs per gc-mark RPC */
+
+struct kvsgc {
+    flux_t *h;
+    kvsroot_mgr_t *krm;
+    zhashx_t *seen;             /* marked blobrefs */
+    zlist_t *queue;             /* dirref targets awaiting load+walk */
+    json_t *batch;              /* marks not yet shipped to backing store */
+    const flux_msg_t *request;  /* kvs.gc request awaiting response */
+    int load_inflight;
+    int mark_inflight;          /* outstanding gc-mark RPCs */
+    bool active;
+    bool sweep_sent;
+    bool failed;
+    int errnum;
+    int reachable;
+    int dirs_walked;
+    struct timespec t0;
+};
+
+static void gc_advance (kvsgc_t *gc);
+
+static void gc_fail (kvsgc_t *gc, int errnum)
+{
+    if (!gc->failed) {
+        gc->failed = true;
+        gc->errnum = errnum;
+    }
+}
+
+static void gc_finish (kvsgc_t *gc)
+{
+    flux_msg_decref (gc->request);
+    gc->request = NULL;
+    zhashx_destroy (&gc->seen);
+    zlist_destroy (&gc->queue);
+    json_decref (gc->batch);
+    gc->batch = NULL;
+    gc->active = false;
+}
+
+static void gc_mark_continuation (flux_future_t *f, void *arg)
+{
+    kvsgc_t *gc = arg;
+
+    gc->mark_inflight--;
+    if (flux_rpc_get (f, NULL) < 0) {
+        flux_log_error (gc->h, "gc: content-backing.gc-mark");
+        gc_fail (gc, errno);
+    }
+    flux_future_destroy (f);
+    gc_advance (gc);
+}
+
+static int gc_mark_flush (kvsgc_t *gc)
+{
+    flux_future_t *f;
+
+    if (json_array_size (gc->batch) == 0)
+        return 0;
+    if (!(f = flux_rpc_pack (gc->h,
+                             "content-backing.gc-mark",
+                             FLUX_NODEID_ANY,
+                             0,
+                             "{s:O}",
+                             "refs", gc->batch)))
+        return -1;
+    if (flux_future_then (f, -1., gc_mark_continuation, gc) < 0) {
+        flux_future_destroy (f);
+        return -1;
+    }
+    gc->mark_inflight++;
+    json_decref (gc->batch);
+    if (!(gc->batch = json_array ())) {
+        errno = ENOMEM;
+        return -1;
+    }
+    return 0;
+}
+
+/* Add 'ref' to the mark set if not already present.
+ * Returns 1 if newly marked, 0 if already marked, -1 on error.
+ */
+static int gc_mark (kvsgc_t *gc, const char *ref)
+{
+    json_t *o;
+
+    if (zhashx_lookup (gc->seen, ref))
+        return 0;
+    if (zhashx_insert (gc->seen, ref, gc) < 0)
+        goto nomem;
+    gc->reachable++;
+    if (!(o = json_string (ref)))
+        goto nomem;
+    if (json_array_append_new (gc->batch, o) < 0)
+        goto nomem;
+    if (json_array_size (gc->batch) >= gc_mark_batch_limit) {
+        if (gc_mark_flush (gc) < 0)
+            return -1;
+    }
+    return 1;
+nomem:
+    errno = ENOMEM;
+    return -1;
+}
+
+/* Mark the blobrefs in a treeobj and queue dirref targets for loading.
+ * Inline dir entries are walked recursively.
+ */
+static int gc_walk_treeobj (kvsgc_t *gc, json_t *obj)
+{
+    if (treeobj_is_dirref (obj) || treeobj_is_valref (obj)) {
+        int count = treeobj_get_count (obj);
+        int i;
+        for (i = 0; i < count; i++) {
+            const char *ref = treeobj_get_blobref (obj, i);
+            int rc;
+            if (!ref)
+                return -1;
+            if ((rc = gc_mark (gc, ref)) < 0)
+                return -1;
+            if (rc == 1 && treeobj_is_dirref (obj)) {
+                if (zlist_append (gc->queue, (void *)ref) < 0) {
+                    errno = ENOMEM;
+                    return -1;
+                }
+            }
+        }
+    }
+    else if (treeobj_is_dir (obj)) {
+        json_t *data = treeobj_get_data (obj);
+        const char *name;
+        json_t *entry;
+        json_object_foreach (data, name, entry) {
+            if (gc_walk_treeobj (gc, entry) < 0)
+                return -1;
+        }
+    }
+    /* val, symlink: no blobrefs */
+    return 0;
+}
+
+static void gc_load_continuation (flux_future_t *f, void *arg)
+{
+    kvsgc_t *gc = arg;
+    const void *data;
+    int len;
+    json_t *dir = NULL;
+
+    gc->load_inflight--;
+    if (flux_content_load_get (f, &data, &len) < 0) {
+        flux_log_error (gc->h, "gc: content load");
+        gc_fail (gc, errno);
+        goto done;
+    }
+    if (!(dir = treeobj_decodeb (data, len))) {
+        flux_log_error (gc->h, "gc: treeobj decode");
+        gc_fail (gc, errno);
+        goto done;
+    }
+    gc->dirs_walked++;
+    if (gc_walk_treeobj (gc, dir) < 0) {
+        flux_log_error (gc->h, "gc: treeobj walk");
+        gc_fail (gc, errno);
+    }
+done:
+    json_decref (dir);
+    flux_future_destroy (f);
+    gc_advance (gc);
+}
+
+/* Issue dir loads until the in-flight limit is reached or the queue
+ * drains.
+ */
+static void gc_pump (kvsgc_t *gc)
+{
+    char *ref;
+
+    while (!gc->failed && gc->load_inflight < gc_max_inflight
+                       && (ref = zlist_pop (gc->queue))) {
+        flux_future_t *f;
+        if (!(f = flux_content_load (gc->h,
+                                     ref,
+                                     CONTENT_FLAG_CACHE_BYPASS))
+            || flux_future_then (f, -1., gc_load_continuation, gc) < 0) {
+            flux_log_error (gc->h, "gc: flux_content_load");
+            gc_fail (gc, errno);
+            flux_future_destroy (f);
+            free (ref);
+            return;
+        }
+        gc->load_inflight++;
+        free (ref);
+    }
+}
+
+/* Mark a namespace root and queue it for walking.  Skips namespaces
+ * marked for removal.
+ */
+static int gc_root_cb (struct kvsroot *root, void *arg)
+{
+    kvsgc_t *gc = arg;
+    int rc;
+
+    if (root->remove)
+        return 0;
+    if ((rc = gc_mark (gc, root->ref)) < 0)
+        return -1;
+    if (rc == 1 && zlist_append (gc->queue, root->ref) < 0) {
+        errno = ENOMEM;
+        return -1;
+    }
+    return 0;
+}
+
+static void gc_sweep_continuation (flux_future_t *f, void *arg)
+{
+    kvsgc_t *gc = arg;
+    int swept, remaining;
+
+    if (flux_rpc_get_unpack (f,
+                             "{s:i s:i}",
+                             "swept", &swept,
+                             "remaining", &remaining) < 0) {
+        flux_log_error (gc->h, "gc: content-backing.gc-sweep");
+        gc_fail (gc, errno);
+        flux_future_destroy (f);
+        gc_advance (gc);
+        return;
+    }
+    flux_log (gc->h, LOG_INFO, "gc: %d reachable, %d swept, %d remaining",
+              gc->reachable, swept, remaining);
+    if (flux_respond_pack (gc->h,
+                           gc->request,
+                           "{s:i s:i s:i s:i s:f}",
+                           "reachable", gc->reachable,
+                           "dirs", gc->dirs_walked,
+                           "swept", swept,
+                           "remaining", remaining,
+                           "elapsed (ms)", monotime_since (gc->t0)) < 0)
+        flux_log_error (gc->h, "gc: error responding to kvs.gc request");
+    flux_future_destroy (f);
+    gc_finish (gc);
+}
+
+/* Drive the pass forward.  Called after every load/mark completion.
+ */
+static void gc_advance (kvsgc_t *gc)
+{
+    flux_future_t *f;
+
+    if (!gc->active || gc->sweep_sent)
+        return;
+    gc_pump (gc);
+    if (gc->load_inflight > 0)
+        return;
+    if (!gc->failed) {
+        /* Walk drained: pick up roots that moved during the trace,
+         * then quit only once the root set is fully marked.
+         */
+        if (kvsroot_mgr_iter_roots (gc->krm, gc_root_cb, gc) < 0)
+            gc_fail (gc, errno);
+        else if (zlist_size (gc->queue) > 0) {
+            gc_pump (gc);
+            if (gc->load_inflight > 0)
+                return;
+        }
+    }
+    if (!gc->failed && gc_mark_flush (gc) < 0)
+        gc_fail (gc, errno);
+    if (gc->mark_inflight > 0)
+        return;
+    if (gc->failed) {
+        if (flux_respond_error (gc->h, gc->request, gc->errnum, NULL) < 0)
+            flux_log_error (gc->h, "gc: error responding to kvs.gc request");
+        gc_finish (gc);
+        return;
+    }
+    if (!(f = flux_rpc (gc->h,
+                        "content-backing.gc-sweep",
+                        NULL,
+                        FLUX_NODEID_ANY,
+                        0))
+        || flux_future_then (f, -1., gc_sweep_continuation, gc) < 0) {
+        flux_log_error (gc->h, "gc: content-backing.gc-sweep");
+        if (flux_respond_error (gc->h, gc->request, errno, NULL) < 0)
+            flux_log_error (gc->h, "gc: error responding to kvs.gc request");
+        flux_future_destroy (f);
+        gc_finish (gc);
+        return;
+    }
+    gc->sweep_sent = true;
+}
+
+int kvsgc_start (kvsgc_t *gc, const flux_msg_t *msg)
+{
+    if (gc->active) {
+        errno = EINPROGRESS;
+        return -1;
+    }
+    if (!(gc->seen = zhashx_new ())
+        || !(gc->queue = zlist_new ())
+        || !(gc->batch = json_array ())) {
+        gc_finish (gc);
+        errno = ENOMEM;
+        return -1;
+    }
+    zlist_autofree (gc->queue);
+    gc->request = flux_msg_incref (msg);
+    gc->load_inflight = 0;
+    gc->mark_inflight = 0;
+    gc->sweep_sent = false;
+    gc->failed = false;
+    gc->errnum = 0;
+    gc->reachable = 0;
+    gc->dirs_walked = 0;
+    monotime (&gc->t0);
+    gc->active = true;
+    if (kvsroot_mgr_iter_roots (gc->krm, gc_root_cb, gc) < 0) {
+        int saved_errno = errno;
+        gc_finish (gc);
+        errno = saved_errno;
+        return -1;
+    }
+    gc_advance (gc);
+    return 0;
+}
+
+bool kvsgc_active (kvsgc_t *gc)
+{
+    return (gc && gc->active);
+}
+
+void kvsgc_mark_external (kvsgc_t *gc, const char *ref)
+{
+    if (gc && gc->active && !gc->sweep_sent) {
+        if (gc_mark (gc, ref) < 0)
+            gc_fail (gc, errno);
+    }
+}
+
+kvsgc_t *kvsgc_create (flux_t *h, kvsroot_mgr_t *krm)
+{
+    kvsgc_t *gc;
+
+    if (!(gc = calloc (1, sizeof (*gc)))) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    gc->h = h;
+    gc->krm = krm;
+    return gc;
+}
+
+void kvsgc_destroy (kvsgc_t *gc)
+{
+    if (gc) {
+        int saved_errno = errno;
+        if (gc->active && gc->request) {
+            if (flux_respond_error (gc->h, gc->request, ENOSYS, NULL) < 0)
+                flux_log_error (gc->h, "gc: error responding to kvs.gc");
+        }
+        gc_finish (gc);
+        free (gc);
+        errno = saved_errno;
+    }
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
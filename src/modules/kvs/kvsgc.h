@@ -0,0 +1,44 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _FLUX_KVS_KVSGC_H
+#define _FLUX_KVS_KVSGC_H
+
+#include <stdbool.h>
+#include <flux/core.h>
+
+#include "kvsroot.h"
+
+typedef struct kvsgc kvsgc_t;
+
+kvsgc_t *kvsgc_create (flux_t *h, kvsroot_mgr_t *krm);
+void kvsgc_destroy (kvsgc_t *gc);
+
+/* Start a mark and sweep pass over the content backing store, tracing
+ * reachable blobrefs from the current root of every namespace.  The
+ * response to 'msg' is sent when the pass completes.
+ * Returns 0 on success, -1 with errno set (EINPROGRESS if a pass is
+ * already running).
+ */
+int kvsgc_start (kvsgc_t *gc, const flux_msg_t *msg);
+
+bool kvsgc_active (kvsgc_t *gc);
+
+/* Add a blobref stored outside the tracer's view (e.g. by an in-flight
+ * transaction) to the mark set of the active pass.  No-op if no pass
+ * is active.
+ */
+void kvsgc_mark_external (kvsgc_t *gc, const char *ref);
+
+#endif /* !_FLUX_KVS_KVSGC_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
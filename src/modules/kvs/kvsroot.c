@@ -24,10 +24,14 @@
 
 #include "kvsroot.h"
 
+/* don't let one polled-for key pattern grow the miss cache unbounded */
+#define MISSCACHE_MAX_ENTRIES 4096
+
 struct kvsroot_mgr {
     zhash_t *roothash;
     zlist_t *removelist;
     bool iterating_roots;
+    int inline_val_max;         /* applied to new roots (-1 = ktm default) */
     flux_t *h;
     void *arg;
 };
@@ -50,6 +54,7 @@ kvsroot_mgr_t *kvsroot_mgr_create (flux_t *h, void *arg)
         goto error;
     }
     krm->iterating_roots = false;
+    krm->inline_val_max = -1;
     krm->h = h;
     krm->arg = arg;
     return krm;
@@ -76,6 +81,12 @@ int kvsroot_mgr_root_count (kvsroot_mgr_t *krm)
     return zhash_size (krm->roothash);
 }
 
+void kvsroot_mgr_set_inline_val_max (kvsroot_mgr_t *krm, int max)
+{
+    if (krm && max >= 0)
+        krm->inline_val_max = max;
+}
+
 static void kvsroot_destroy (void *data)
 {
     if (data) {
@@ -90,6 +101,8 @@ static void kvsroot_destroy (void *data)
             zlist_destroy (&root->synclist);
         if (root->setroot_queue)
             zlist_destroy (&root->setroot_queue);
+        if (root->misscache)
+            zhashx_destroy (&root->misscache);
         free (data);
     }
 }
@@ -128,6 +141,8 @@ struct kvsroot *kvsroot_mgr_create_root (kvsroot_mgr_t *krm,
         flux_log_error (krm->h, "kvstxn_mgr_create");
         goto error;
     }
+    if (krm->inline_val_max >= 0)
+        kvstxn_mgr_set_inline_val_max (root->ktm, krm->inline_val_max);
 
     if (!(root->trm = treq_mgr_create ())) {
         flux_log_error (krm->h, "treq_mgr_create");
@@ -255,6 +270,36 @@ void kvsroot_setroot (kvsroot_mgr_t *krm, struct kvsroot *root,
 
     strcpy (root->ref, root_ref);
     root->seq = root_seq;
+
+    /* new root generation, previously absent keys may now exist */
+    if (root->misscache)
+        zhashx_purge (root->misscache);
+}
+
+int kvsroot_misscache_add (struct kvsroot *root, const char *key)
+{
+    if (!root || !key) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!root->misscache) {
+        if (!(root->misscache = zhashx_new ())) {
+            errno = ENOMEM;
+            return -1;
+        }
+    }
+    if (zhashx_size (root->misscache) >= MISSCACHE_MAX_ENTRIES)
+        return 0;
+    /* zhashx duplicates the key, value is an arbitrary non-NULL marker */
+    (void)zhashx_insert (root->misscache, key, root);
+    return 0;
+}
+
+bool kvsroot_misscache_check (struct kvsroot *root, const char *key)
+{
+    if (!root || !key || !root->misscache)
+        return false;
+    return (zhashx_lookup (root->misscache, key) != NULL);
 }
 
 int kvsroot_check_user (kvsroot_mgr_t *krm, struct kvsroot *root,
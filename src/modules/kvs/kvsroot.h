@@ -19,6 +19,7 @@
 #include "treq.h"
 #include "waitqueue.h"
 #include "src/common/libutil/blobref.h"
+#include "src/common/libutil/tstat.h"
 
 typedef struct kvsroot_mgr kvsroot_mgr_t;
 
@@ -31,8 +32,11 @@ struct kvsroot {
     treq_mgr_t *trm;
     zlist_t *synclist;
     int last_update_epoch;
+    tstat_t commit_stats;       /* commit latency (ms), for kvs.stats.get */
+    zhashx_t *misscache;        /* keys known absent at current seq */
     int flags;
     bool remove;
+    bool remove_queued;         /* on kvs module's deferred teardown list */
     bool setroot_pause;
     zlist_t *setroot_queue;
 };
@@ -48,6 +52,11 @@ void kvsroot_mgr_destroy (kvsroot_mgr_t *krm);
 
 int kvsroot_mgr_root_count (kvsroot_mgr_t *krm);
 
+/* Set the inline val threshold applied to subsequently created roots
+ * (see kvstxn_mgr_set_inline_val_max()).  Existing roots are unaffected.
+ */
+void kvsroot_mgr_set_inline_val_max (kvsroot_mgr_t *krm, int max);
+
 struct kvsroot *kvsroot_mgr_create_root (kvsroot_mgr_t *krm,
                                          struct cache *cache,
                                          const char *hash_name,
@@ -77,6 +86,16 @@ void kvsroot_setroot (kvsroot_mgr_t *krm, struct kvsroot *root,
 int kvsroot_check_user (kvsroot_mgr_t *krm,struct kvsroot *root,
                         struct flux_msg_cred cred);
 
+/* Cache of normalized keys known to not exist at the root's current
+ * sequence number, cleared on kvsroot_setroot().  Additions past an
+ * internal size cap are silently dropped.
+ *
+ * kvsroot_misscache_add() returns -1 on error, 0 on success.
+ * kvsroot_misscache_check() returns true if 'key' is known absent.
+ */
+int kvsroot_misscache_add (struct kvsroot *root, const char *key);
+bool kvsroot_misscache_check (struct kvsroot *root, const char *key);
+
 #endif /* !_FLUX_KVS_KVSROOT_H */
 
 /*
@@ -25,6 +25,7 @@
 
 #include "src/common/libutil/macros.h"
 #include "src/common/libutil/blobref.h"
+#include "src/common/libutil/monotime.h"
 #include "src/common/libkvs/treeobj.h"
 #include "src/common/libkvs/kvs_txn_private.h"
 #include "src/common/libkvs/kvs_util_private.h"
@@ -33,13 +34,22 @@
 
 #define KVSTXN_PROCESSING      0x01
 #define KVSTXN_MERGED          0x02 /* kvstxn is a merger of transactions */
+
+/* Rewrite a valref chain into a single blob once it grows past
+ * COALESCE_MIN_BLOBREFS entries, provided the combined data stays
+ * under COALESCE_MAX_BYTES.
+ */
+#define COALESCE_MIN_BLOBREFS  32
+#define COALESCE_MAX_BYTES     (1024*1024)
 #define KVSTXN_MERGE_COMPONENT 0x04 /* kvstxn is member of a merger */
 
 struct kvstxn_mgr {
     struct cache *cache;
     const char *ns_name;
     const char *hash_name;
+    int inline_val_max;         /* max encoded val length stored inline */
     int noop_stores;            /* for kvs.stats.get, etc.*/
+    struct timespec ready_since; /* time head of ready list became ready */
     zlist_t *ready;
     flux_t *h;
     void *aux;
@@ -53,6 +63,7 @@ struct kvstxn {
     json_t *keys;
     json_t *names;
     int flags;
+    struct timespec t_created;  /* time added to ready list, for stats */
     json_t *rootcpy;   /* working copy of root dir */
     const json_t *rootdir;      /* source of rootcpy above */
     struct cache_entry *entry;  /* for reference counting rootdir above */
@@ -116,6 +127,7 @@ static kvstxn_t *kvstxn_create (kvstxn_mgr_t *ktm,
         }
     }
     kt->flags = flags;
+    monotime (&kt->t_created);
     if (!(kt->missing_refs_list = zlist_new ()))
         goto error_enomem;
     if (!(kt->dirty_cache_entries_list = zlist_new ()))
@@ -191,6 +203,11 @@ json_t *kvstxn_get_keys (kvstxn_t *kt)
     return NULL;
 }
 
+double kvstxn_get_elapsed_ms (kvstxn_t *kt)
+{
+    return monotime_since (kt->t_created);
+}
+
 /* On error we should cleanup anything on the dirty cache list
  * that has not yet been passed to the user.  Because this has not
  * been passed to the user, there should be no waiters and the
@@ -238,6 +255,58 @@ static void cleanup_dirty_cache_list (kvstxn_t *kt)
         kvstxn_cleanup_dirty_cache_entry (kt, entry);
 }
 
+/* Store raw data buffer under key 'ref' in local cache.
+ * Buffer is copied into the cache entry, caller retains ownership.
+ * Returns -1 on error, 0 on success entry already there, 1 on success
+ * entry needs to be flushed to content store
+ */
+static int store_cache_raw (kvstxn_t *kt, int current_epoch,
+                            const void *data, int len,
+                            char *ref, int ref_len,
+                            struct cache_entry **entryp)
+{
+    struct cache_entry *entry;
+    int rc;
+
+    if (blobref_hash (kt->ktm->hash_name, data, len, ref, ref_len) < 0) {
+        flux_log_error (kt->ktm->h, "%s: blobref_hash", __FUNCTION__);
+        return -1;
+    }
+    if (!(entry = cache_lookup (kt->ktm->cache, ref, current_epoch))) {
+        if (!(entry = cache_entry_create (ref))) {
+            flux_log_error (kt->ktm->h, "%s: cache_entry_create", __FUNCTION__);
+            return -1;
+        }
+        if (cache_insert (kt->ktm->cache, entry) < 0) {
+            cache_entry_destroy (entry);
+            flux_log_error (kt->ktm->h, "%s: cache_insert", __FUNCTION__);
+            return -1;
+        }
+    }
+    if (cache_entry_get_valid (entry)) {
+        kt->ktm->noop_stores++;
+        rc = 0;
+    }
+    else {
+        if (cache_entry_set_raw (entry, data, len) < 0) {
+            int ret;
+            ret = cache_remove_entry (kt->ktm->cache, ref);
+            assert (ret == 1);
+            return -1;
+        }
+        if (cache_entry_set_dirty (entry, true) < 0) {
+            flux_log_error (kt->ktm->h, "%s: cache_entry_set_dirty",__FUNCTION__);
+            int ret;
+            ret = cache_remove_entry (kt->ktm->cache, ref);
+            assert (ret == 1);
+            return -1;
+        }
+        rc = 1;
+    }
+    *entryp = entry;
+    return rc;
+}
+
 /* Store object 'o' under key 'ref' in local cache.
  * Object reference is still owned by the caller.
  * 'is_raw' indicates this data is a json string w/ base64 value and
@@ -250,7 +319,6 @@ static int store_cache (kvstxn_t *kt, int current_epoch, json_t *o,
                         bool is_raw, char *ref, int ref_len,
                         struct cache_entry **entryp)
 {
-    struct cache_entry *entry;
     int saved_errno, rc;
     const char *xdata;
     char *data = NULL;
@@ -280,42 +348,9 @@ static int store_cache (kvstxn_t *kt, int current_epoch, json_t *o,
         }
         len = strlen (data);
     }
-    if (blobref_hash (kt->ktm->hash_name, data, len, ref, ref_len) < 0) {
-        flux_log_error (kt->ktm->h, "%s: blobref_hash", __FUNCTION__);
+    if ((rc = store_cache_raw (kt, current_epoch, data, len,
+                               ref, ref_len, entryp)) < 0)
         goto error;
-    }
-    if (!(entry = cache_lookup (kt->ktm->cache, ref, current_epoch))) {
-        if (!(entry = cache_entry_create (ref))) {
-            flux_log_error (kt->ktm->h, "%s: cache_entry_create", __FUNCTION__);
-            goto error;
-        }
-        if (cache_insert (kt->ktm->cache, entry) < 0) {
-            cache_entry_destroy (entry);
-            flux_log_error (kt->ktm->h, "%s: cache_insert", __FUNCTION__);
-            goto error;
-        }
-    }
-    if (cache_entry_get_valid (entry)) {
-        kt->ktm->noop_stores++;
-        rc = 0;
-    }
-    else {
-        if (cache_entry_set_raw (entry, data, len) < 0) {
-            int ret;
-            ret = cache_remove_entry (kt->ktm->cache, ref);
-            assert (ret == 1);
-            goto error;
-        }
-        if (cache_entry_set_dirty (entry, true) < 0) {
-            flux_log_error (kt->ktm->h, "%s: cache_entry_set_dirty",__FUNCTION__);
-            int ret;
-            ret = cache_remove_entry (kt->ktm->cache, ref);
-            assert (ret == 1);
-            goto error;
-        }
-        rc = 1;
-    }
-    *entryp = entry;
     free (data);
     return rc;
 
@@ -382,7 +417,12 @@ static int kvstxn_unroll (kvstxn_t *kt, int current_epoch, json_t *dir)
             /* jansson >= 2.7 could use json_string_length() instead */
             str = json_string_value (val_data);
             assert (str);
-            if (strlen (str) > BLOBREF_MAX_STRING_SIZE) {
+            /* Values whose encoding fits within the inline threshold
+             * stay packed in the directory object, avoiding a content
+             * store + hash + cache entry per value.  Larger values are
+             * converted to valrefs.
+             */
+            if (strlen (str) > (size_t)kt->ktm->inline_val_max) {
                 if ((ret = store_cache (kt, current_epoch, val_data,
                                         true, ref, sizeof (ref), &entry)) < 0)
                     return -1;
@@ -433,6 +473,82 @@ static int kvstxn_val_data_to_cache (kvstxn_t *kt, int current_epoch,
     return 0;
 }
 
+/* Best effort rewrite of a long valref chain 'valref' into a valref
+ * with a single blobref covering the concatenated data.  Appends grow
+ * valref arrays one small blob at a time (e.g. eventlogs), so reads
+ * of heavily appended keys fan out into many tiny content loads.
+ *
+ * Sets (*newvalref) to the replacement treeobj, or to NULL if the
+ * chain is below the coalescing threshold, any chained blob is not
+ * available in the local cache, or the combined data would be too
+ * large.  The caller should fall back to the original valref in the
+ * NULL case.  Returns 0 on success, -1 on error.
+ */
+static int kvstxn_coalesce_valref (kvstxn_t *kt, int current_epoch,
+                                   json_t *valref, json_t **newvalref)
+{
+    char ref[BLOBREF_MAX_STRING_SIZE];
+    struct cache_entry *entry;
+    char *buf = NULL;
+    char *tmp;
+    int saved_errno;
+    int total = 0;
+    int count, i, ret;
+
+    (*newvalref) = NULL;
+
+    if ((count = treeobj_get_count (valref)) < COALESCE_MIN_BLOBREFS)
+        return 0;
+
+    for (i = 0; i < count; i++) {
+        const char *blobref;
+        const void *data;
+        int len;
+
+        if (!(blobref = treeobj_get_blobref (valref, i)))
+            goto error;
+        if (!(entry = cache_lookup (kt->ktm->cache, blobref, current_epoch))
+            || !cache_entry_get_valid (entry))
+            goto nocoalesce;
+        if (cache_entry_get_raw (entry, &data, &len) < 0)
+            goto error;
+        if (len <= 0 || total + len > COALESCE_MAX_BYTES)
+            goto nocoalesce;
+        if (!(tmp = realloc (buf, total + len))) {
+            errno = ENOMEM;
+            goto error;
+        }
+        buf = tmp;
+        memcpy (buf + total, data, len);
+        total += len;
+    }
+
+    if ((ret = store_cache_raw (kt, current_epoch, buf, total,
+                                ref, sizeof (ref), &entry)) < 0)
+        goto error;
+
+    if (ret) {
+        if (zlist_push (kt->dirty_cache_entries_list, entry) < 0) {
+            kvstxn_cleanup_dirty_cache_entry (kt, entry);
+            errno = ENOMEM;
+            goto error;
+        }
+    }
+
+    if (!((*newvalref) = treeobj_create_valref (ref)))
+        goto error;
+
+ nocoalesce:
+    free (buf);
+    return 0;
+
+ error:
+    saved_errno = errno;
+    free (buf);
+    errno = saved_errno;
+    return -1;
+}
+
 static int kvstxn_append (kvstxn_t *kt, int current_epoch, json_t *dirent,
                           json_t *dir, const char *final_name, bool *append)
 {
@@ -453,6 +569,7 @@ static int kvstxn_append (kvstxn_t *kt, int current_epoch, json_t *dirent,
     else if (treeobj_is_valref (entry)) {
         char ref[BLOBREF_MAX_STRING_SIZE];
         json_t *cpy;
+        json_t *ktmp;
 
         /* treeobj is valref, so we need to append the new data's
          * blobref to this tree object.  Before doing so, we must save
@@ -477,6 +594,20 @@ static int kvstxn_append (kvstxn_t *kt, int current_epoch, json_t *dirent,
             return -1;
         }
 
+        /* If the valref chain has grown long, opportunistically
+         * rewrite it as a single larger blob so later reads don't fan
+         * out into many tiny content loads.  Best effort - on a miss
+         * the unmodified chain is used.
+         */
+        if (kvstxn_coalesce_valref (kt, current_epoch, cpy, &ktmp) < 0) {
+            json_decref (cpy);
+            return -1;
+        }
+        if (ktmp) {
+            json_decref (cpy);
+            cpy = ktmp;
+        }
+
         /* To improve performance, call
          * treeobj_insert_entry_novalidate() instead of
          * treeobj_insert_entry(), as the former will not call
@@ -1116,6 +1247,7 @@ kvstxn_mgr_t *kvstxn_mgr_create (struct cache *cache,
     ktm->cache = cache;
     ktm->ns_name = ns;
     ktm->hash_name = hash_name;
+    ktm->inline_val_max = BLOBREF_MAX_STRING_SIZE;
     if (!(ktm->ready = zlist_new ())) {
         saved_errno = ENOMEM;
         goto error;
@@ -1164,6 +1296,9 @@ int kvstxn_mgr_add_transaction (kvstxn_mgr_t *ktm,
     }
     zlist_freefn (ktm->ready, kt, (zlist_free_fn *)kvstxn_destroy, true);
 
+    if (zlist_size (ktm->ready) == 1)
+        monotime (&ktm->ready_since);
+
     return 0;
 }
 
@@ -1213,6 +1348,17 @@ void kvstxn_mgr_remove_transaction (kvstxn_mgr_t *ktm, kvstxn_t *kt,
     }
 }
 
+void kvstxn_mgr_set_inline_val_max (kvstxn_mgr_t *ktm, int max)
+{
+    if (ktm && max >= 0)
+        ktm->inline_val_max = max;
+}
+
+int kvstxn_mgr_get_inline_val_max (kvstxn_mgr_t *ktm)
+{
+    return ktm->inline_val_max;
+}
+
 int kvstxn_mgr_get_noop_stores (kvstxn_mgr_t *ktm)
 {
     return ktm->noop_stores;
@@ -1228,6 +1374,33 @@ int kvstxn_mgr_ready_transaction_count (kvstxn_mgr_t *ktm)
     return zlist_size (ktm->ready);
 }
 
+double kvstxn_mgr_merge_window_remaining (kvstxn_mgr_t *ktm,
+                                          double window_ms,
+                                          int max_count)
+{
+    kvstxn_t *kt;
+    double since;
+
+    if (window_ms <= 0.)
+        return 0.;
+    if (!(kt = zlist_first (ktm->ready)))
+        return 0.;
+    /* Only transactions that have not begun processing and that the
+     * flags-compatibility checks in kvstxn_mgr_merge_ready_transactions()
+     * could accept are worth holding for merge candidates.
+     */
+    if (kt->blocked
+        || kt->state != KVSTXN_STATE_INIT
+        || (kt->flags & FLUX_KVS_NO_MERGE)
+        || (kt->internal_flags & (KVSTXN_PROCESSING | KVSTXN_MERGED)))
+        return 0.;
+    if (max_count > 0 && zlist_size (ktm->ready) >= max_count)
+        return 0.;
+    if ((since = monotime_since (ktm->ready_since)) >= window_ms)
+        return 0.;
+    return window_ms - since;
+}
+
 static int kvstxn_merge (kvstxn_t *dest, kvstxn_t *src)
 {
     int i, len;
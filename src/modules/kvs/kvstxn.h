@@ -74,6 +74,10 @@ const char *kvstxn_get_newroot_ref (kvstxn_t *kt);
  * (i.e. kvstxn_process() returns KVSTXN_PROCESS_FINISHED) */
 json_t *kvstxn_get_keys (kvstxn_t *kt);
 
+/* milliseconds since the transaction was created (i.e. made ready),
+ * for commit latency stats */
+double kvstxn_get_elapsed_ms (kvstxn_t *kt);
+
 /* Primary transaction processing function.
  *
  * Pass in a kvstxn_t that was obtained via
@@ -175,12 +179,35 @@ kvstxn_t *kvstxn_mgr_get_ready_transaction (kvstxn_mgr_t *ktm);
 void kvstxn_mgr_remove_transaction (kvstxn_mgr_t *ktm, kvstxn_t *kt,
                                     bool fallback);
 
+/* Get/set the maximum encoded length of a val treeobj that is packed
+ * inline in its directory object rather than stored as a valref to a
+ * separate content blob.  The default preserves historical behavior
+ * (BLOBREF_MAX_STRING_SIZE).  Raising it trades slightly larger
+ * directory objects for fewer content store operations when many small
+ * values are written.  May be set per namespace since each has its own
+ * transaction manager.
+ */
+void kvstxn_mgr_set_inline_val_max (kvstxn_mgr_t *ktm, int max);
+int kvstxn_mgr_get_inline_val_max (kvstxn_mgr_t *ktm);
+
 int kvstxn_mgr_get_noop_stores (kvstxn_mgr_t *ktm);
 void kvstxn_mgr_clear_noop_stores (kvstxn_mgr_t *ktm);
 
 /* return count of ready transactions */
 int kvstxn_mgr_ready_transaction_count (kvstxn_mgr_t *ktm);
 
+/* Return milliseconds to wait before processing the head ready
+ * transaction, so that a burst of independent commits can aggregate
+ * into one merged transaction (i.e. one new root and one batch of
+ * content.store ops).  Returns 0. if it should be processed now:
+ * no window configured ('window_ms' <= 0.), no ready transaction,
+ * head transaction not mergeable or already being processed, ready
+ * count has reached 'max_count' (if > 0), or window expired.
+ */
+double kvstxn_mgr_merge_window_remaining (kvstxn_mgr_t *ktm,
+                                          double window_ms,
+                                          int max_count);
+
 /* In internally stored ready transactions (moved to ready status via
  * kvstxn_mgr_add_transaction()), merge them into a new ready transaction
  * if they are capable of being merged.
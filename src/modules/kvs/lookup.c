@@ -35,6 +35,10 @@
  */
 #define SYMLINK_CYCLE_LIMIT 10
 
+/* Max sibling dirrefs collected for speculative prefetch per stall.
+ */
+#define PREFETCH_LIMIT 16
+
 typedef struct {
     int depth;
     char *path_copy;            /* for internal parsing, do not use */
@@ -84,10 +88,13 @@ struct lookup {
 
     char *missing_namespace;
 
+    bool ns_crossed;            /* walk followed a namespace symlink */
+
     int errnum;                 /* errnum if error */
     int aux_errnum;
 
     /* API internal */
+    zlist_t *prefetch_refs;     /* blobrefs worth loading speculatively */
     zlist_t *levels;
     const json_t *wdirent;       /* result after walk() */
     enum {
@@ -238,6 +245,8 @@ static lookup_process_t symlink_check_namespace (lookup_t *lh,
     struct kvsroot *root = NULL;
     lookup_process_t ret = LOOKUP_PROCESS_ERROR;
 
+    lh->ns_crossed = true;
+
     root = kvsroot_mgr_lookup_root (lh->krm, ns);
 
     if (!root) {
@@ -349,6 +358,47 @@ cleanup:
     return ret;
 }
 
+/* Collect blobrefs of dirref entries in the directory containing the
+ * dirent we are stalled on, so the caller can overlap their content
+ * loads with the one we must wait for.  A deep walk that descends
+ * through the directory later finds these entries warm instead of
+ * paying one RTT per level.  Failures here only lose the speculative
+ * loads, so they are ignored.
+ */
+static void walk_prefetch_dir (lookup_t *lh,
+                               struct cache_entry *entry,
+                               const char *skip_ref)
+{
+    const json_t *dir;
+    json_t *dir_data;
+    const char *name;
+    json_t *dirent;
+
+    if (!entry || !(dir = cache_entry_get_treeobj (entry)))
+        return;
+    if (!(dir_data = treeobj_get_data ((json_t *)dir)))
+        return;
+    json_object_foreach (dir_data, name, dirent) {
+        const char *ref;
+        struct cache_entry *e;
+
+        if (zlist_size (lh->prefetch_refs) >= PREFETCH_LIMIT)
+            break;
+        if (!treeobj_is_dirref (dirent)
+            || treeobj_get_count (dirent) != 1
+            || !(ref = treeobj_get_blobref (dirent, 0)))
+            continue;
+        if (!strcmp (ref, skip_ref))
+            continue;
+        if ((e = cache_lookup (lh->cache, ref, lh->current_epoch))
+            && cache_entry_get_valid (e))
+            continue;
+        /* prefetch_refs has autofree set, append duplicates ref */
+        if (zlist_append (lh->prefetch_refs, (char *)ref) < 0)
+            break;
+    }
+}
+
 /* Get dirent of the requested path starting at the given root.
  *
  * Return true on success or error, error code is returned in ep and
@@ -396,6 +446,7 @@ static lookup_process_t walk (lookup_t *lh)
             if (!(entry = cache_lookup (lh->cache, refstr, lh->current_epoch))
                 || !cache_entry_get_valid (entry)) {
                 lh->missing_ref = refstr;
+                walk_prefetch_dir (lh, wl->entry, refstr);
                 return LOOKUP_PROCESS_LOAD_MISSING_REFS;
             }
             if (!(dir = cache_entry_get_treeobj (entry))) {
@@ -581,6 +632,12 @@ lookup_t *lookup_create (struct cache *cache,
         goto cleanup;
     }
 
+    if (!(lh->prefetch_refs = zlist_new ())) {
+        saved_errno = ENOMEM;
+        goto cleanup;
+    }
+    zlist_autofree (lh->prefetch_refs);
+
     lh->wdirent = NULL;
     lh->state = LOOKUP_STATE_INIT;
 
@@ -600,6 +657,7 @@ void lookup_destroy (lookup_t *lh)
         free (lh->path);
         json_decref (lh->val);
         free (lh->missing_namespace);
+        zlist_destroy (&lh->prefetch_refs);
         zlist_destroy (&lh->levels);
         free (lh);
     }
@@ -688,6 +746,24 @@ int lookup_iter_missing_refs (lookup_t *lh, lookup_ref_f cb, void *data)
     return -1;
 }
 
+int lookup_iter_prefetch_refs (lookup_t *lh, lookup_ref_f cb, void *data)
+{
+    char *ref;
+    int rc = 0;
+
+    if (!lh) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* one-shot: each ref is handed to the callback then discarded */
+    while ((ref = zlist_pop (lh->prefetch_refs))) {
+        if (rc == 0 && cb (lh, ref, data) < 0)
+            rc = -1;
+        free (ref);
+    }
+    return rc;
+}
+
 const char *lookup_missing_namespace (lookup_t *lh)
 {
    if (lh
@@ -713,6 +789,20 @@ const char *lookup_get_namespace (lookup_t *lh)
     return NULL;
 }
 
+const char *lookup_get_path (lookup_t *lh)
+{
+    if (lh)
+        return lh->path;
+    return NULL;
+}
+
+bool lookup_crossed_namespace (lookup_t *lh)
+{
+    if (lh)
+        return lh->ns_crossed;
+    return false;
+}
+
 const char *lookup_get_root_ref (lookup_t *lh)
 {
     if (lh && lh->state == LOOKUP_STATE_FINISHED)
@@ -75,6 +75,15 @@ json_t *lookup_get_value (lookup_t *lh);
  */
 int lookup_iter_missing_refs (lookup_t *lh, lookup_ref_f cb, void *data);
 
+/* On lookup stall, get references that are not required to complete
+ * this lookup but are likely needed soon (e.g. sibling dirrefs of a
+ * missing directory).  Caller may load them into the KVS cache without
+ * waiting on them.  References are discarded as they are iterated.
+ *
+ * return -1 in callback to break iteration
+ */
+int lookup_iter_prefetch_refs (lookup_t *lh, lookup_ref_f cb, void *data);
+
 /* On lookup stall b/c of missing namespace, get missing namespace
  * returned by this function.
  *
@@ -93,6 +102,14 @@ int lookup_get_current_epoch (lookup_t *lh);
  */
 const char *lookup_get_namespace (lookup_t *lh);
 
+/* Get normalized key path from earlier instantiation. */
+const char *lookup_get_path (lookup_t *lh);
+
+/* Return true if the walk followed a symlink with a namespace target,
+ * i.e. the result depends on more than the initial namespace's root.
+ */
+bool lookup_crossed_namespace (lookup_t *lh);
+
 /* Convenience functions to get root ref & seq used in lookup.
  * root_ref will be the root_ref passed in via lookup_create() or the
  * root_ref used from the namespace.  The root_seq is only if the
@@ -12,6 +12,10 @@
 #include "config.h"
 #endif
 #include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
 #include <jansson.h>
 
 #include "src/common/libkvs/treeobj.h"
@@ -671,6 +675,8 @@ void cache_expiration_tests (void)
         "cache_entry_set_raw success");
     ok (cache_insert (cache, e5) == 0,
         "cache_insert works");
+    ok (cache_total_bytes (cache) >= 6,
+        "cache_total_bytes accounts for inserted entry");
     ok (cache_count_entries (cache) == 2,
         "cache contains 2 entries after insert");
     ok (cache_lookup (cache, "yyy3", 0) == NULL,
@@ -696,10 +702,71 @@ void cache_expiration_tests (void)
         "cache_expire_entries now=44 thresh=1 expired 1");
     ok (cache_count_entries (cache) == 1,
         "cache contains 1 entry");
+    ok (cache_total_bytes (cache) == 0,
+        "cache_total_bytes drops back to 0 after expiry");
 
     cache_destroy (cache);
 }
 
+void cache_snapshot_tests (void)
+{
+    struct cache *cache;
+    struct cache_entry *e1, *e2;
+    const void *data;
+    int len;
+    char path[] = "/tmp/kvs_test_cache_snapshot.XXXXXX";
+    int fd;
+
+    ok ((fd = mkstemp (path)) >= 0,
+        "mkstemp works");
+    close (fd);
+
+    ok ((cache = cache_create ()) != NULL,
+        "cache_create works");
+    ok ((e1 = cache_entry_create ("snap1")) != NULL,
+        "cache_entry_create works");
+    ok (cache_entry_set_raw (e1, "abcd", 4) == 0,
+        "cache_entry_set_raw success");
+    ok (cache_insert (cache, e1) == 0,
+        "cache_insert works");
+    /* invalid entry, should not be dumped */
+    ok ((e2 = cache_entry_create ("snap2")) != NULL,
+        "cache_entry_create works");
+    ok (cache_insert (cache, e2) == 0,
+        "cache_insert works");
+    ok (cache_dump (cache, path) == 1,
+        "cache_dump dumped 1 valid entry");
+    cache_destroy (cache);
+
+    ok ((cache = cache_create ()) != NULL,
+        "cache_create works");
+    ok (cache_restore (cache, path) == 1,
+        "cache_restore restored 1 entry");
+    ok (cache_count_entries (cache) == 1,
+        "cache contains 1 entry after restore");
+    ok ((e1 = cache_lookup (cache, "snap1", 0)) != NULL,
+        "cache_lookup of restored entry works");
+    ok (cache_entry_get_valid (e1) == true,
+        "restored entry is valid");
+    ok (cache_entry_get_raw (e1, &data, &len) == 0
+        && len == 4
+        && memcmp (data, "abcd", len) == 0,
+        "restored entry contains correct data");
+    /* restoring again should skip the existing blobref */
+    ok (cache_restore (cache, path) == 0,
+        "cache_restore skipped existing entry");
+    cache_destroy (cache);
+
+    ok (cache_restore (NULL, path) < 0 && errno == EINVAL,
+        "cache_restore fails with EINVAL on bad input");
+    unlink (path);
+    ok ((cache = cache_create ()) != NULL,
+        "cache_create works");
+    ok (cache_restore (cache, path) < 0 && errno == ENOENT,
+        "cache_restore fails with ENOENT on missing file");
+    cache_destroy (cache);
+}
+
 int main (int argc, char *argv[])
 {
     plan (NO_PLAN);
@@ -712,6 +779,7 @@ int main (int argc, char *argv[])
     cache_expiration_tests ();
     cache_blobref_tests ();
     cache_remove_entry_tests ();
+    cache_snapshot_tests ();
 
     done_testing ();
     return (0);
@@ -82,6 +82,27 @@ void basic_api_tests (void)
     ok (root->seq == 18,
         "kvsroot_setroot set seq correctly");
 
+    ok (kvsroot_misscache_add (NULL, "a.b") < 0
+        && errno == EINVAL,
+        "kvsroot_misscache_add failed with EINVAL on bad input");
+
+    ok (!kvsroot_misscache_check (root, "a.b"),
+        "kvsroot_misscache_check returns false on empty cache");
+
+    ok (kvsroot_misscache_add (root, "a.b") == 0,
+        "kvsroot_misscache_add works");
+
+    ok (kvsroot_misscache_check (root, "a.b"),
+        "kvsroot_misscache_check returns true on cached key");
+
+    ok (!kvsroot_misscache_check (root, "a.c"),
+        "kvsroot_misscache_check returns false on uncached key");
+
+    kvsroot_setroot (krm, root, "foobaz", 19);
+
+    ok (!kvsroot_misscache_check (root, "a.b"),
+        "kvsroot_misscache_check returns false after root change");
+
     cred.rolemask = FLUX_ROLE_OWNER;
     cred.userid = 0;
     ok (kvsroot_check_user (krm, NULL, cred) < 0
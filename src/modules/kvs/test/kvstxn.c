@@ -2697,6 +2697,89 @@ void kvstxn_process_big_fileval (void)
     json_decref (root);
 }
 
+/* With the inline val threshold raised, a value that would normally be
+ * converted into a valref stays inline in the directory object, so only
+ * the treeobj entry is dirtied.
+ */
+void kvstxn_process_inline_val_max (void)
+{
+    struct cache *cache;
+    kvsroot_mgr_t *krm;
+    kvstxn_mgr_t *ktm;
+    kvstxn_t *kt;
+    char rootref[BLOBREF_MAX_STRING_SIZE];
+    const char *newroot;
+    int bigstrsize = BLOBREF_MAX_STRING_SIZE * 2;
+    char bigstr[bigstrsize];
+    struct cache_count cache_count;
+    int i;
+
+    cache = create_cache_with_empty_rootdir (rootref, sizeof (rootref));
+
+    ok ((krm = kvsroot_mgr_create (NULL, NULL)) != NULL,
+        "kvsroot_mgr_create works");
+
+    setup_kvsroot (krm, KVS_PRIMARY_NAMESPACE, cache, ref_dummy);
+
+    ok ((ktm = kvstxn_mgr_create (cache,
+                                  KVS_PRIMARY_NAMESPACE,
+                                  "sha1",
+                                  NULL,
+                                  &test_global)) != NULL,
+        "kvstxn_mgr_create works");
+
+    ok (kvstxn_mgr_get_inline_val_max (ktm) == BLOBREF_MAX_STRING_SIZE,
+        "kvstxn_mgr_get_inline_val_max returns default");
+
+    kvstxn_mgr_set_inline_val_max (ktm, 4096);
+
+    ok (kvstxn_mgr_get_inline_val_max (ktm) == 4096,
+        "kvstxn_mgr_get_inline_val_max returns new max");
+
+    memset (bigstr, '\0', bigstrsize);
+    for (i = 0; i < bigstrsize - 1; i++)
+        bigstr[i] = 'a';
+
+    create_ready_kvstxn (ktm, "transaction1", "val", bigstr, 0, 0);
+
+    ok ((kt = kvstxn_mgr_get_ready_transaction (ktm)) != NULL,
+        "kvstxn_mgr_get_ready_transaction returns ready kvstxn");
+
+    ok (kvstxn_process (kt, 1, rootref) == KVSTXN_PROCESS_DIRTY_CACHE_ENTRIES,
+        "kvstxn_process returns KVSTXN_PROCESS_DIRTY_CACHE_ENTRIES");
+
+    cache_count.treeobj_count = 0;
+    cache_count.total_count = 0;
+    ok (kvstxn_iter_dirty_cache_entries (kt, cache_count_treeobj_cb,
+                                         &cache_count) == 0,
+        "kvstxn_iter_dirty_cache_entries works for dirty cache entries");
+
+    /* unlike kvstxn_process_big_fileval() above, the big value stays
+     * inline, so there is no separate raw entry for it */
+
+    ok (cache_count.treeobj_count == 1,
+        "correct number of cache entries were treeobj");
+
+    ok (cache_count.total_count == 1,
+        "correct number of cache entries were dirty");
+
+    ok (kvstxn_process (kt, 1, rootref) == KVSTXN_PROCESS_FINISHED,
+        "kvstxn_process returns KVSTXN_PROCESS_FINISHED");
+
+    ok ((newroot = kvstxn_get_newroot_ref (kt)) != NULL,
+        "kvstxn_get_newroot_ref returns != NULL when processing complete");
+
+    verify_keys_and_ops_standard (kt);
+
+    verify_value (cache, krm, KVS_PRIMARY_NAMESPACE, newroot, "val", bigstr);
+
+    kvstxn_mgr_remove_transaction (ktm, kt, false);
+
+    kvstxn_mgr_destroy (ktm);
+    kvsroot_mgr_destroy (krm);
+    cache_destroy (cache);
+}
+
 /* Test giant directory entry, as large json objects will iterate through
  * their entries randomly based on the internal hash data structure.
  */
@@ -3398,6 +3481,7 @@ int main (int argc, char *argv[])
     kvstxn_process_delete_filevalinpath_test ();
     kvstxn_process_bad_dirrefs ();
     kvstxn_process_big_fileval ();
+    kvstxn_process_inline_val_max ();
     kvstxn_process_giant_dir ();
     kvstxn_process_append ();
     kvstxn_process_append_errors ();
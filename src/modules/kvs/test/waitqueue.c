@@ -269,6 +269,40 @@ int main (int argc, char *argv[])
     ok (count == 0,
         "wait_t callback has not run");
 
+    /* Add waiters from two senders, destroy one sender's waiters via
+     * the sender index, callbacks not run
+     */
+
+    count = 0;
+    for (i = 0; i < 6; i++) {
+        const char *s = (i < 4) ? "sender1" : "sender2";
+        if (!(msg = flux_msg_create (FLUX_MSGTYPE_REQUEST)))
+            break;
+        if (flux_msg_enable_route (msg) < 0 || flux_msg_push_route (msg, s) < 0)
+            break;
+        if (!(w = wait_create_msg_handler (NULL, NULL, msg, &count, msghand)))
+            break;
+        flux_msg_destroy (msg); /* msg was copied into wait_t */
+        if (wait_addqueue (q, w) < 0)
+            break;
+    }
+    ok (wait_queue_length (q) == 6,
+        "wait_queue_length 6 after 6 wait_addqueues");
+    ok (wait_queue_waiter_count () >= 6,
+        "wait_queue_waiter_count accounts for added waiters");
+    ok ((i = wait_destroy_sender (q, "sender1")) == 4,
+        "wait_destroy_sender destroyed 4 waiters");
+    ok (wait_queue_length (q) == 2,
+        "wait_queue_length 2 after sender1 deletions");
+    ok ((i = wait_destroy_sender (q, "nosuchsender")) == 0,
+        "wait_destroy_sender of unknown sender destroyed 0 waiters");
+    ok ((i = wait_destroy_sender (q, "sender2")) == 2,
+        "wait_destroy_sender destroyed 2 waiters");
+    ok (wait_queue_length (q) == 0,
+        "wait_queue_length 0 after sender2 deletions");
+    ok (count == 0,
+        "wait_t callback has not run");
+
     wait_queue_destroy (q);
     wait_queue_destroy (q2);
 
@@ -31,6 +31,7 @@ struct wait_struct {
     wait_cb_f cb;
     void *cb_arg;
     struct handler hand; /* optional special case */
+    char *sender;        /* route of hand.msg, for sender-indexed removal */
     int errnum;
     wait_error_f error_cb;
     void *error_arg;
@@ -40,8 +41,14 @@ struct wait_struct {
 struct waitqueue_struct {
     int magic;
     zlist_t *q;
+    zhash_t *bysender;   /* sender uuid => zlist_t of wait_t, lazily created */
 };
 
+/* Total wait_t's parked on all waitqueue_t's in this process, for
+ * queue depth stats.
+ */
+static int waiter_count = 0;
+
 int wait_get_usecount (wait_t *w)
 {
     return w->usecount;
@@ -71,6 +78,8 @@ wait_t *wait_create_msg_handler (flux_t *h, flux_msg_handler_t *mh,
         w->hand.h = h;
         w->hand.mh = mh;
         w->hand.msg = flux_msg_incref (msg);
+        /* messages without a route (e.g. in test) simply aren't indexed */
+        (void)flux_msg_get_route_first (msg, &w->sender);
     }
     return w;
 }
@@ -81,6 +90,7 @@ void wait_destroy (wait_t *w)
         assert (w->magic == WAIT_MAGIC);
         assert (w->usecount == 0);
         flux_msg_decref (w->hand.msg);
+        free (w->sender);
         w->magic = ~WAIT_MAGIC;
         free (w);
     }
@@ -123,15 +133,22 @@ void wait_queue_destroy (waitqueue_t *q)
         wait_t *w;
         assert (q->magic == WAITQUEUE_MAGIC);
         while ((w = zlist_pop (q->q))) {
+            waiter_count--;
             if (--w->usecount == 0)
                 wait_destroy (w);
         }
         zlist_destroy (&q->q);
+        zhash_destroy (&q->bysender);
         q->magic = ~WAITQUEUE_MAGIC;
         free (q);
     }
 }
 
+int wait_queue_waiter_count (void)
+{
+    return waiter_count;
+}
+
 int wait_queue_length (waitqueue_t *q)
 {
     assert (q->magic == WAITQUEUE_MAGIC);
@@ -152,6 +169,45 @@ int wait_queue_iter (waitqueue_t *q, wait_iter_cb_f cb, void *arg)
     return 0;
 }
 
+static void sender_list_destroy (void *arg)
+{
+    zlist_t *l = arg;
+    zlist_destroy (&l);
+}
+
+static int bysender_add (waitqueue_t *q, wait_t *w)
+{
+    zlist_t *l;
+
+    if (!q->bysender && !(q->bysender = zhash_new ()))
+        return -1;
+    if (!(l = zhash_lookup (q->bysender, w->sender))) {
+        if (!(l = zlist_new ()))
+            return -1;
+        if (zhash_insert (q->bysender, w->sender, l) < 0) {
+            zlist_destroy (&l);
+            return -1;
+        }
+        zhash_freefn (q->bysender, w->sender, sender_list_destroy);
+    }
+    if (zlist_append (l, w) < 0)
+        return -1;
+    return 0;
+}
+
+static void bysender_remove (waitqueue_t *q, wait_t *w)
+{
+    zlist_t *l;
+
+    if (w->sender
+        && q->bysender
+        && (l = zhash_lookup (q->bysender, w->sender))) {
+        zlist_remove (l, w);
+        if (!zlist_size (l))
+            zhash_delete (q->bysender, w->sender);
+    }
+}
+
 int wait_addqueue (waitqueue_t *q, wait_t *w)
 {
     assert (q->magic == WAITQUEUE_MAGIC);
@@ -160,7 +216,13 @@ int wait_addqueue (waitqueue_t *q, wait_t *w)
         errno = ENOMEM;
         return -1;
     }
+    if (w->sender && bysender_add (q, w) < 0) {
+        zlist_remove (q->q, w);
+        errno = ENOMEM;
+        return -1;
+    }
     w->usecount++;
+    waiter_count++;
     return 0;
 }
 
@@ -196,7 +258,9 @@ int wait_runqueue (waitqueue_t *q)
             errno = ENOMEM;
             return -1;
         }
+        waiter_count -= zlist_size (q->q);
         zlist_purge (q->q);
+        zhash_destroy (&q->bysender);
         while ((w = zlist_pop (cpy)))
             wait_runone (w);
         zlist_destroy (&cpy);
@@ -263,6 +327,8 @@ int wait_destroy_msg (waitqueue_t *q, wait_test_msg_f cb, void *arg)
     if (tmp) {
         while ((w = zlist_pop (tmp))) {
             zlist_remove (q->q, w);
+            bysender_remove (q, w);
+            waiter_count--;
             if (--w->usecount == 0)
                 wait_destroy (w);
         }
@@ -280,6 +346,33 @@ error:
     return rc;
 }
 
+int wait_destroy_sender (waitqueue_t *q, const char *sender)
+{
+    zlist_t *l;
+    wait_t *w;
+    int count = 0;
+
+    assert (q->magic == WAITQUEUE_MAGIC);
+    if (!sender) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!q->bysender || !(l = zhash_lookup (q->bysender, sender)))
+        return 0;
+    while ((w = zlist_pop (l))) {
+        /* prevent wait_runone from restarting handler by clearing
+         * callback function (i.e. if wait is on multiple queues) */
+        w->hand.cb = NULL;
+        zlist_remove (q->q, w);
+        waiter_count--;
+        if (--w->usecount == 0)
+            wait_destroy (w);
+        count++;
+    }
+    zhash_delete (q->bysender, sender);
+    return count;
+}
+
 /*
  * vi:tabstop=4 shiftwidth=4 expandtab
  */
@@ -47,6 +47,11 @@ waitqueue_t *wait_queue_create (void);
 void wait_queue_destroy (waitqueue_t *q);
 int wait_queue_length (waitqueue_t *q);
 
+/* Total count of wait_t's parked on all waitqueue_t's in this
+ * process, for queue depth stats.
+ */
+int wait_queue_waiter_count (void);
+
 /* Add a wait_t to a queue.
  * Returns -1 on error, 0 on success
  */
@@ -95,6 +100,13 @@ int wait_set_error_cb (wait_t *w, wait_error_f cb, void *arg);
 typedef bool (*wait_test_msg_f)(const flux_msg_t *msg, void *arg);
 int wait_destroy_msg (waitqueue_t *q, wait_test_msg_f cb, void *arg);
 
+/* Destroy all wait_t's whose message was sent by 'sender' (first
+ * route), using an internal index so cost is proportional to that
+ * sender's waiters rather than queue length.
+ * Returns destroyed count on success, -1 on error.
+ */
+int wait_destroy_sender (waitqueue_t *q, const char *sender);
+
 #endif /* !_FLUX_KVS_WAITQUEUE_H */
 
 /*
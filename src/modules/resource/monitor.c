@@ -16,6 +16,11 @@
  *
  * Post online/offline events with incremental changes to execution
  * target availability since resource-init was posted.
+ *
+ * Transitions are debounced: changes arriving within a short window
+ * (e.g. a rack power event taking many ranks down at once) coalesce
+ * into one online and/or offline event covering the whole idset,
+ * so consumers see one eventlog entry and one acquire update.
  */
 
 #if HAVE_CONFIG_H
@@ -39,10 +44,18 @@ struct monitor {
     struct idset *up;
     struct idset *down; // only updated on access
 
+    struct idset *pending_up;   // transitions awaiting batched post
+    struct idset *pending_dn;
+    flux_watcher_t *batch_timer;
+
     monitor_cb_f cb;
     void *cb_arg;
 };
 
+/* Transition coalescing period (s).
+ */
+static const double batch_window = 0.1;
+
 const struct idset *monitor_get_up (struct monitor *monitor)
 {
     return monitor->up;
@@ -66,30 +79,18 @@ const struct idset *monitor_get_down (struct monitor *monitor)
     return monitor->down;
 }
 
-/* Handle updates to the idset of available brokers.
- * Post online/offline events for any newly up or down ranks.
- * Update monitor->up and call callback if any.
+/* Post online/offline events for batched transitions, if any, and
+ * clear the pending sets.  Ranks that went down and came back (or vice
+ * versa) within one batch window cancel out in update_pending() below
+ * and generate no event.
  */
-static void hello_idset_continuation (flux_future_t *f, void *arg)
+static void post_pending (struct monitor *monitor)
 {
-    struct monitor *monitor = arg;
     flux_t *h = monitor->ctx->h;
-    const char *s;
-    struct idset *idset, *up, *dn;
 
-    if (flux_rpc_get_unpack (f, "{s:s}", "idset", &s) < 0
-            || !(idset = idset_decode (s))) {
-        flux_log_error (h, "error parsing hello.idset response");
-        return;
-    }
-    if (rutil_idset_diff (monitor->up, idset, &up, &dn) < 0) {
-        flux_log_error (h, "error analyzing hello.idset response");
-        idset_destroy (idset);
-        return;
-    }
-    if (up && idset_count (up) > 0) {
+    if (monitor->pending_up && idset_count (monitor->pending_up) > 0) {
         char *online;
-        if (!(online = idset_encode (up, IDSET_FLAG_RANGE))
+        if (!(online = idset_encode (monitor->pending_up, IDSET_FLAG_RANGE))
             || reslog_post_pack (monitor->ctx->reslog,
                                  NULL,
                                  "online",
@@ -98,11 +99,10 @@ static void hello_idset_continuation (flux_future_t *f, void *arg)
                                  online) < 0)
             flux_log_error (h, "error posting online event");
         free (online);
-        idset_destroy (up);
     }
-    if (dn && idset_count (dn) > 0) {
+    if (monitor->pending_dn && idset_count (monitor->pending_dn) > 0) {
         char *offline;
-        if (!(offline = idset_encode (dn, IDSET_FLAG_RANGE))
+        if (!(offline = idset_encode (monitor->pending_dn, IDSET_FLAG_RANGE))
             || reslog_post_pack (monitor->ctx->reslog,
                                  NULL,
                                  "offline",
@@ -111,8 +111,92 @@ static void hello_idset_continuation (flux_future_t *f, void *arg)
                                  offline) < 0)
             flux_log_error (h, "error posting offline event");
         free (offline);
-        idset_destroy (dn);
     }
+    idset_destroy (monitor->pending_up);
+    idset_destroy (monitor->pending_dn);
+    monitor->pending_up = NULL;
+    monitor->pending_dn = NULL;
+}
+
+static void batch_timer_cb (flux_reactor_t *r,
+                            flux_watcher_t *w,
+                            int revents,
+                            void *arg)
+{
+    struct monitor *monitor = arg;
+
+    post_pending (monitor);
+    flux_watcher_destroy (monitor->batch_timer);
+    monitor->batch_timer = NULL;
+}
+
+/* Fold newly up/down ranks into the pending transition sets, starting
+ * the batch timer on the first change of a window.
+ */
+static int update_pending (struct monitor *monitor,
+                           const struct idset *up,
+                           const struct idset *dn)
+{
+    uint32_t size = monitor->ctx->size;
+
+    if (up && idset_count (up) > 0) {
+        if (!monitor->pending_up
+            && !(monitor->pending_up = idset_create (size, 0)))
+            return -1;
+        if (rutil_idset_add (monitor->pending_up, up) < 0)
+            return -1;
+        if (monitor->pending_dn
+            && rutil_idset_sub (monitor->pending_dn, up) < 0)
+            return -1;
+    }
+    if (dn && idset_count (dn) > 0) {
+        if (!monitor->pending_dn
+            && !(monitor->pending_dn = idset_create (size, 0)))
+            return -1;
+        if (rutil_idset_add (monitor->pending_dn, dn) < 0)
+            return -1;
+        if (monitor->pending_up
+            && rutil_idset_sub (monitor->pending_up, dn) < 0)
+            return -1;
+    }
+    if (!monitor->batch_timer) {
+        flux_reactor_t *r = flux_get_reactor (monitor->ctx->h);
+        if (!(monitor->batch_timer = flux_timer_watcher_create (r,
+                                                                batch_window,
+                                                                0.,
+                                                                batch_timer_cb,
+                                                                monitor)))
+            return -1;
+        flux_watcher_start (monitor->batch_timer);
+    }
+    return 0;
+}
+
+/* Handle updates to the idset of available brokers.
+ * Queue online/offline events for any newly up or down ranks.
+ * Update monitor->up and call callback if any.
+ */
+static void hello_idset_continuation (flux_future_t *f, void *arg)
+{
+    struct monitor *monitor = arg;
+    flux_t *h = monitor->ctx->h;
+    const char *s;
+    struct idset *idset, *up, *dn;
+
+    if (flux_rpc_get_unpack (f, "{s:s}", "idset", &s) < 0
+            || !(idset = idset_decode (s))) {
+        flux_log_error (h, "error parsing hello.idset response");
+        return;
+    }
+    if (rutil_idset_diff (monitor->up, idset, &up, &dn) < 0) {
+        flux_log_error (h, "error analyzing hello.idset response");
+        idset_destroy (idset);
+        return;
+    }
+    if (update_pending (monitor, up, dn) < 0)
+        flux_log_error (h, "error batching online/offline events");
+    idset_destroy (up);
+    idset_destroy (dn);
     idset_destroy (monitor->up);
     monitor->up = idset;
     if (monitor->cb)
@@ -161,6 +245,8 @@ void monitor_destroy (struct monitor *monitor)
 {
     if (monitor) {
         int saved_errno = errno;
+        post_pending (monitor); // flush any batched transitions
+        flux_watcher_destroy (monitor->batch_timer);
         flux_future_destroy (monitor->f);
         idset_destroy (monitor->up);
         idset_destroy (monitor->down);
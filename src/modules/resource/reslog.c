@@ -26,12 +26,21 @@ struct event_info {
 
 struct reslog {
     flux_t *h;
-    zlist_t *pending;       // list of pending futures
+    flux_kvs_txn_t *txn;    // transaction accumulating batched events
+    zlist_t *batch;         // event_info list covered by 'txn'
+    zlist_t *inflight;      // event_info list covered by 'commit'
+    flux_future_t *commit;  // commit in progress, if any
     reslog_cb_f cb;
     void *cb_arg;
+    int post_count;         // events posted since last snapshot
+    reslog_snapshot_f snapshot_cb;
+    void *snapshot_arg;
 };
 
-static const char *auxkey = "flux::event_info";
+/* Number of events accumulated before the snapshot callback is invoked
+ * to fold state into a fresh RESLOG_SNAPSHOT_EVENT entry.
+ */
+static const int snapshot_interval = 1000;
 
 /* Call registered callback, if any, with the event name that just completed.
  */
@@ -69,29 +78,64 @@ static struct event_info *event_info_create (json_t *event,
     return info;
 }
 
+static void post_continuation (flux_future_t *f, void *arg);
+
+/* Commit the accumulated transaction, if any.  Events posted while the
+ * commit is in flight accumulate in a new transaction, so a burst of
+ * posts (e.g. draining hundreds of ranks for a maintenance window)
+ * coalesces into few commits instead of one commit per event.
+ */
+static int commit_flush (struct reslog *reslog)
+{
+    flux_future_t *f;
+    zlist_t *tmp;
+
+    if (!reslog->txn || reslog->commit)
+        return 0;
+    if (!(f = flux_kvs_commit (reslog->h, NULL, 0, reslog->txn)))
+        return -1;
+    if (flux_future_then (f, -1, post_continuation, reslog) < 0) {
+        flux_future_destroy (f);
+        return -1;
+    }
+    flux_kvs_txn_destroy (reslog->txn);
+    reslog->txn = NULL;
+    tmp = reslog->inflight; // empty - only one commit in flight at a time
+    reslog->inflight = reslog->batch;
+    reslog->batch = tmp;
+    reslog->commit = f;
+    return 0;
+}
+
 int post_handler (struct reslog *reslog, flux_future_t *f)
 {
-    struct event_info *info = flux_future_aux_get (f, auxkey);
+    struct event_info *info;
     int rc;
 
-    if ((rc = flux_rpc_get (f, NULL)) < 0) {
+    if ((rc = flux_rpc_get (f, NULL)) < 0)
         flux_log_error (reslog->h, "committing to %s", RESLOG_KEY);
-        if (info->msg) {
-            if (flux_respond_error (reslog->h, info->msg, errno, NULL) < 0)
-                flux_log_error (reslog->h, "responding to request after post");
+    while ((info = zlist_pop (reslog->inflight))) {
+        if (rc < 0) {
+            if (info->msg) {
+                if (flux_respond_error (reslog->h, info->msg, errno, NULL) < 0)
+                    flux_log_error (reslog->h,
+                                    "responding to request after post");
+            }
         }
-        goto done;
-    }
-    else {
-        if (info->msg) {
-            if (flux_respond (reslog->h, info->msg, NULL) < 0)
-                flux_log_error (reslog->h, "responding to request after post");
+        else {
+            if (info->msg) {
+                if (flux_respond (reslog->h, info->msg, NULL) < 0)
+                    flux_log_error (reslog->h,
+                                    "responding to request after post");
+            }
+            notify_callback (reslog, info->event);
         }
+        event_info_destroy (info);
     }
-    notify_callback (reslog, info->event);
-done:
-    zlist_remove (reslog->pending, f);
+    reslog->commit = NULL;
     flux_future_destroy (f);
+    if (commit_flush (reslog) < 0)
+        rc = -1;
     return rc;
 }
 
@@ -104,9 +148,8 @@ static void post_continuation (flux_future_t *f, void *arg)
 
 int reslog_sync (struct reslog *reslog)
 {
-    flux_future_t *f;
-    while ((f = zlist_pop (reslog->pending))) {
-        if (post_handler (reslog, f) < 0)
+    while (reslog->commit) {
+        if (post_handler (reslog, reslog->commit) < 0)
             return -1;
     }
     return 0;
@@ -121,46 +164,49 @@ int reslog_post_pack (struct reslog *reslog,
     va_list ap;
     json_t *event;
     char *val = NULL;
-    flux_kvs_txn_t *txn = NULL;
-    flux_future_t *f = NULL;
-    struct event_info *info;
+    struct event_info *info = NULL;
 
     va_start (ap, fmt);
-    event = eventlog_entry_vpack (0., name, fmt, ap);
+    event = eventlog_entry_vpack (flux_reactor_now (flux_get_reactor (reslog->h)),
+                                  name, fmt, ap);
     va_end (ap);
 
     if (!event)
         return -1;
     if (!(val = eventlog_entry_encode (event)))
         goto error;
-    if (!(txn = flux_kvs_txn_create ()))
-        goto error;
-    if (flux_kvs_txn_put (txn, FLUX_KVS_APPEND, RESLOG_KEY, val) < 0)
-        goto error;
-    if (!(f = flux_kvs_commit (reslog->h, NULL, 0, txn)))
+    if (!reslog->txn && !(reslog->txn = flux_kvs_txn_create ()))
         goto error;
     if (!(info = event_info_create (event, request)))
         goto error;
-    if (flux_future_aux_set (f,
-                             auxkey,
-                             info,
-                             (flux_free_f)event_info_destroy) < 0) {
-        event_info_destroy (info);
+    if (zlist_append (reslog->batch, info) < 0) {
+        errno = ENOMEM;
         goto error;
     }
-    if (flux_future_then (f, -1, post_continuation, reslog) < 0)
+    if (flux_kvs_txn_put (reslog->txn, FLUX_KVS_APPEND, RESLOG_KEY, val) < 0) {
+        zlist_remove (reslog->batch, info);
         goto error;
-    if (zlist_append (reslog->pending, f) < 0) {
-        errno = ENOMEM;
+    }
+    if (commit_flush (reslog) < 0) {
+        zlist_remove (reslog->batch, info);
         goto error;
     }
-    flux_kvs_txn_destroy (txn);
     free (val);
     json_decref (event);
+    /* Trigger a state snapshot once enough events pile up, so replay
+     * after a restart need not walk an arbitrarily long log.  Posting
+     * the snapshot re-enters this function and resets the count.
+     */
+    if (!strcmp (name, RESLOG_SNAPSHOT_EVENT))
+        reslog->post_count = 0;
+    else if (++reslog->post_count >= snapshot_interval
+             && reslog->snapshot_cb) {
+        reslog->post_count = 0;
+        reslog->snapshot_cb (reslog, reslog->snapshot_arg);
+    }
     return 0;
 error:
-    flux_future_destroy (f);
-    flux_kvs_txn_destroy (txn);
+    event_info_destroy (info);
     ERRNO_SAFE_WRAP (free, val);
     ERRNO_SAFE_WRAP (json_decref, event);
     return -1;
@@ -172,16 +218,28 @@ void reslog_set_callback (struct reslog *reslog, reslog_cb_f cb, void *arg)
     reslog->cb_arg = arg;
 }
 
+void reslog_set_snapshot_callback (struct reslog *reslog,
+                                   reslog_snapshot_f cb,
+                                   void *arg)
+{
+    reslog->snapshot_cb = cb;
+    reslog->snapshot_arg = arg;
+}
+
 void reslog_destroy (struct reslog *reslog)
 {
     if (reslog) {
         int saved_errno = errno;
-        if (reslog->pending) {
-            flux_future_t *f;
-            while ((f = zlist_pop (reslog->pending)))
-                (void)post_handler (reslog, f);
-            zlist_destroy (&reslog->pending);
+        while (reslog->commit)
+            (void)post_handler (reslog, reslog->commit);
+        if (reslog->batch) {
+            struct event_info *info;
+            while ((info = zlist_pop (reslog->batch)))
+                event_info_destroy (info);
+            zlist_destroy (&reslog->batch);
         }
+        zlist_destroy (&reslog->inflight);
+        flux_kvs_txn_destroy (reslog->txn);
         free (reslog);
         errno = saved_errno;
     }
@@ -194,7 +252,12 @@ struct reslog *reslog_create (flux_t *h)
     if (!(reslog = calloc (1, sizeof (*reslog))))
         return NULL;
     reslog->h = h;
-    if (!(reslog->pending = zlist_new ())) {
+    /* Events may be posted before the reactor runs, so refresh the
+     * cached reactor timestamp used by reslog_post_pack().
+     */
+    flux_reactor_now_update (flux_get_reactor (h));
+    if (!(reslog->batch = zlist_new ())
+            || !(reslog->inflight = zlist_new ())) {
         errno = ENOMEM;
         goto error;
     }
@@ -17,6 +17,9 @@ typedef void (*reslog_cb_f)(struct reslog *reslog,
                             const char *name,
                             void *arg);
 
+typedef void (*reslog_snapshot_f)(struct reslog *reslog,
+                                  void *arg);
+
 struct reslog *reslog_create (flux_t *h);
 void reslog_destroy (struct reslog *reslog);
 
@@ -39,7 +42,17 @@ int reslog_sync (struct reslog *reslog);
  */
 void reslog_set_callback (struct reslog *reslog, reslog_cb_f cb, void *arg);
 
+/* Get a callback when enough events have accumulated since the last
+ * RESLOG_SNAPSHOT_EVENT that a fresh state snapshot should be posted.
+ * The callback is expected to post one via reslog_post_pack(), which
+ * bounds replay at the next module load regardless of eventlog age.
+ */
+void reslog_set_snapshot_callback (struct reslog *reslog,
+                                   reslog_snapshot_f cb,
+                                   void *arg);
+
 #define RESLOG_KEY "resource.eventlog"
+#define RESLOG_SNAPSHOT_EVENT "resource-init"
 
 #endif /* !_FLUX_RESOURCE_RESLOG_H */
 
@@ -17,6 +17,7 @@
 
 #include <flux/core.h>
 #include <jansson.h>
+#include <string.h>
 
 #include "src/common/libutil/errno_safe.h"
 #include "src/common/libidset/idset.h"
@@ -182,7 +183,7 @@ int post_restart_event (struct resource_ctx *ctx, int restart)
         goto error;
     if (reslog_post_pack (ctx->reslog,
                           NULL,
-                          "resource-init",
+                          RESLOG_SNAPSHOT_EVENT,
                           "O",
                           o) < 0)
         goto error;
@@ -195,32 +196,56 @@ error:
     return -1;
 }
 
-/* Remove entries prior to the most recent 'resource-init' event from
- * 'eventlog'. N.B. they remain in the KVS.
+/* Periodic snapshot requested by reslog after a batch of events has
+ * accumulated.  Folding current state into a fresh 'resource-init'
+ * entry bounds replay at the next module load.
  */
-static int prune_eventlog (json_t *eventlog)
+static void snapshot_cb (struct reslog *reslog, void *arg)
 {
-    size_t index;
-    json_t *entry;
-    size_t last_entry = json_array_size (eventlog);
-    const char *name;
+    struct resource_ctx *ctx = arg;
+
+    if (post_restart_event (ctx, 0) < 0)
+        flux_log_error (ctx->h, "error posting snapshot to eventlog");
+}
+
+/* Find the start of the most recent 'resource-init' event in raw
+ * eventlog 's', scanning entries from the end so that only events
+ * after the last snapshot need be decoded.  Entries prior to that
+ * point are irrelevant for replay (N.B. they remain in the KVS).
+ * Returns 's' if no snapshot is found or the log is malformed.
+ */
+static const char *eventlog_replay_start (const char *s)
+{
+    const char *end = s + strlen (s);
 
-    json_array_foreach (eventlog, index, entry) {
+    while (end > s) {
+        const char *begin = end - 1;
+        json_t *entry;
+        const char *name = NULL;
+        char *line;
+
+        while (begin > s && *(begin - 1) != '\n')
+            begin--;
+        if (!(line = strndup (begin, end - begin)))
+            return s;
+        entry = eventlog_entry_decode (line);
+        free (line);
+        if (!entry)
+            return s;
         if (eventlog_entry_parse (entry, NULL, &name, NULL) == 0
-                && !strcmp (name, "resource-init"))
-            last_entry = index;
-    }
-    if (last_entry < json_array_size (eventlog)) {
-        for (index = 0; index < last_entry; index++) {
-            if (json_array_remove (eventlog, 0) < 0)
-                return -1;
+                && !strcmp (name, RESLOG_SNAPSHOT_EVENT)) {
+            json_decref (entry);
+            return begin;
         }
+        json_decref (entry);
+        end = begin;
     }
-    return 0;
+    return s;
 }
 
-/* Synchronously read resource.eventlog, and parse into
- * a JSON array for replay by the various subsystems.
+/* Synchronously read resource.eventlog, and parse entries from the
+ * most recent snapshot onward into a JSON array for replay by the
+ * various subsystems.
  * 'eventlog' is set to NULL if it doesn't exist (no error).
  */
 static int reload_eventlog (flux_t *h, json_t **eventlog)
@@ -239,15 +264,10 @@ static int reload_eventlog (flux_t *h, json_t **eventlog)
         o = NULL;
     }
     else {
-        if (!(o = eventlog_decode (s))) {
+        if (!(o = eventlog_decode (eventlog_replay_start (s)))) {
             flux_log_error (h, "%s: decode error", RESLOG_KEY);
             goto error;
         }
-        if (prune_eventlog (o) < 0) {
-            flux_log (h, LOG_ERR, "%s: pruning error", RESLOG_KEY);
-            ERRNO_SAFE_WRAP (json_decref, o);
-            goto error;
-        }
     }
     *eventlog = o;
     flux_future_destroy (f);
@@ -294,6 +314,7 @@ int mod_main (flux_t *h, int argc, char **argv)
         goto error;
     if (reslog_sync (ctx->reslog) < 0)
         goto error;
+    reslog_set_snapshot_callback (ctx->reslog, snapshot_cb, ctx);
     if (flux_msg_handler_addvec (h, htab, ctx, &ctx->handlers) < 0)
         goto error;
     if (flux_reactor_run (flux_get_reactor (h), 0) < 0) {
@@ -27,16 +27,7 @@ int rutil_idset_sub (struct idset *ids1, const struct idset *ids2)
         errno = EINVAL;
         return -1;
     }
-    if (ids2) {
-        unsigned int id;
-        id = idset_first (ids2);
-        while (id != IDSET_INVALID_ID) {
-            if (idset_clear (ids1, id) < 0)
-                return -1;
-            id = idset_next (ids2, id);
-        }
-    }
-    return 0;
+    return idset_subtract (ids1, ids2);
 }
 
 int rutil_idset_add (struct idset *ids1, const struct idset *ids2)
@@ -45,16 +36,7 @@ int rutil_idset_add (struct idset *ids1, const struct idset *ids2)
         errno = EINVAL;
         return -1;
     }
-    if (ids2) {
-        unsigned int id;
-        id = idset_first (ids2);
-        while (id != IDSET_INVALID_ID) {
-            if (idset_set (ids1, id) < 0)
-                return -1;
-            id = idset_next (ids2, id);
-        }
-    }
-    return 0;
+    return idset_add (ids1, ids2);
 }
 
 int rutil_idset_diff (const struct idset *ids1,
@@ -27,6 +27,7 @@
 void rlist_destroy (struct rlist *rl)
 {
     if (rl) {
+        zhashx_destroy (&rl->noderef);
         zlistx_destroy (&rl->nodes);
         free (rl);
     }
@@ -38,18 +39,53 @@ static void rn_free_fn (void **x)
     *x = NULL;
 }
 
+/*  Hash and comparator for the rank => rnode index. Keys are pointers
+ *   to the rank member of each rnode.
+ */
+static size_t rank_hasher (const void *key)
+{
+    return *(const uint32_t *) key;
+}
+
+static int rank_hash_cmp (const void *key1, const void *key2)
+{
+    uint32_t a = *(const uint32_t *) key1;
+    uint32_t b = *(const uint32_t *) key2;
+    return (a == b ? 0 : (a < b ? -1 : 1));
+}
+
 struct rlist *rlist_create (void)
 {
     struct rlist *rl = calloc (1, sizeof (*rl));
     if (!(rl->nodes = zlistx_new ()))
         goto err;
     zlistx_set_destructor (rl->nodes, rn_free_fn);
+    if (!(rl->noderef = zhashx_new ()))
+        goto err;
+    zhashx_set_key_hasher (rl->noderef, rank_hasher);
+    zhashx_set_key_comparator (rl->noderef, rank_hash_cmp);
+    zhashx_set_key_duplicator (rl->noderef, NULL);
+    zhashx_set_key_destructor (rl->noderef, NULL);
     return (rl);
 err:
     rlist_destroy (rl);
     return (NULL);
 }
 
+/*  Add rnode `n` to both the node list and rank index of `rl`.
+ */
+static int rlist_node_add (struct rlist *rl, struct rnode *n)
+{
+    void *handle = zlistx_add_end (rl->nodes, n);
+    if (!handle)
+        return -1;
+    if (zhashx_insert (rl->noderef, &n->rank, n) < 0) {
+        zlistx_detach (rl->nodes, handle);
+        return -1;
+    }
+    return 0;
+}
+
 struct rlist *rlist_copy_empty (const struct rlist *orig)
 {
     struct rnode *n;
@@ -59,7 +95,7 @@ struct rlist *rlist_copy_empty (const struct rlist *orig)
     n = zlistx_first (orig->nodes);
     while (n) {
         n = rnode_create_idset (n->rank, n->ids);
-        if (!n || !zlistx_add_end (rl->nodes, n))
+        if (!n || rlist_node_add (rl, n) < 0)
             goto fail;
         rl->total += rnode_count (n);
         n = zlistx_next (orig->nodes);
@@ -81,7 +117,7 @@ struct rlist *rlist_copy_down (const struct rlist *orig)
     while (n) {
         if (!n->up) {
             n = rnode_create_idset (n->rank, n->ids);
-            if (!n || !zlistx_add_end (rl->nodes, n))
+            if (!n || rlist_node_add (rl, n) < 0)
                 goto fail;
             rl->total += rnode_count (n);
         }
@@ -94,26 +130,10 @@ fail:
     return NULL;
 }
 
-static struct idset *idset_subtract (const struct idset *orig, struct idset *x)
-{
-    struct idset *ids = idset_copy (orig);
-    unsigned int i;
-
-    if (!ids)
-        return NULL;
-
-    i = idset_first (x);
-    while (i != IDSET_INVALID_ID) {
-        idset_clear (ids, i);
-        i = idset_next (x, i);
-    }
-    return ids;
-}
-
 static struct rnode *rnode_create_alloc (const struct rnode *n)
 {
     struct rnode *result;
-    struct idset *ids = idset_subtract (n->ids, n->avail);
+    struct idset *ids = idset_difference (n->ids, n->avail);
     if (!ids)
         return NULL;
     result = rnode_create_idset (n->rank, ids);
@@ -132,7 +152,7 @@ struct rlist *rlist_copy_allocated (const struct rlist *orig)
         int nalloc = idset_count (n->ids) - idset_count (n->avail);
         if (nalloc > 0) {
             n = rnode_create_alloc (n);
-            if (!n || !zlistx_add_end (rl->nodes, n))
+            if (!n || rlist_node_add (rl, n) < 0)
                 goto fail;
             rl->total += nalloc;
         }
@@ -147,13 +167,7 @@ fail:
 
 static struct rnode *rlist_find_rank (struct rlist *rl, uint32_t rank)
 {
-    struct rnode *n = zlistx_first (rl->nodes);
-    while (n) {
-        if (n->rank == rank)
-            return (n);
-        n = zlistx_next (rl->nodes);
-    }
-    return NULL;
+    return zhashx_lookup (rl->noderef, &rank);
 }
 
 /*  Compare two values from idset_first()/idset_next():
@@ -233,7 +247,7 @@ static int rlist_add_rnode (struct rlist *rl, struct rnode *n)
             return (-1);
         }
     }
-    else if (!zlistx_add_end (rl->nodes, n))
+    else if (rlist_node_add (rl, n) < 0)
         return -1;
     rl->total += rnode_count (n);
     if (n->up)
@@ -254,18 +268,29 @@ static int rlist_append (struct rlist *rl,
     const char *corelist = NULL;
     struct rnode *node;
     struct idset *ids = idset_decode (ranks);
+    struct idset *cores = NULL;
     json_error_t err;
 
     if (!ids || json_unpack_ex (e, &err, 0, "{s:i,s?s}",
                                 "Core", &n,
                                 name, &corelist) < 0)
         goto out;
+    /* Decode the core set once per entry rather than once per rank,
+     * since an aggregated by_rank entry typically covers many ranks
+     * with identical resources.
+     */
+    if (corelist) {
+        if (!(cores = idset_decode (corelist)))
+            goto out;
+    }
+    else {
+        if (!(cores = idset_create (0, IDSET_FLAG_AUTOGROW))
+            || idset_range_set (cores, 0, n - 1) < 0)
+            goto out;
+    }
     i = idset_first (ids);
     while (i != IDSET_INVALID_ID) {
-        if (corelist)
-            node = rnode_create (i, corelist);
-        else
-            node = rnode_create_count (i, n);
+        node = rnode_create_idset (i, cores);
         if (!node || rlist_add_rnode (rl, node) < 0) {
             rnode_destroy (node);
             goto out;
@@ -274,35 +299,45 @@ static int rlist_append (struct rlist *rl,
     }
     rc = 0;
 out:
+    idset_destroy (cores);
     idset_destroy (ids);
     return rc;
 }
 
-struct rlist *rlist_from_hwloc_by_rank (const char *by_rank, bool sched_pus)
+struct rlist *rlist_from_hwloc_by_rank_obj (json_t *o, bool sched_pus)
 {
     struct rlist *rl = NULL;
     const char *key = NULL;
     json_t *entry = NULL;
 
-    json_t *o = json_loads (by_rank, 0, NULL);
-    if (o == NULL)
+    if (o == NULL) {
+        errno = EINVAL;
         return NULL;
+    }
     if (!(rl = rlist_create ()))
-        goto err;
+        return NULL;
 
     json_object_foreach (o, key, entry) {
         if (rlist_append (rl, key, entry, sched_pus ? "cpuset" : "coreids") < 0)
             goto err;
     }
-    json_decref (o);
-
     return (rl);
 err:
-    json_decref (o);
     rlist_destroy (rl);
     return NULL;
 }
 
+struct rlist *rlist_from_hwloc_by_rank (const char *by_rank, bool sched_pus)
+{
+    struct rlist *rl = NULL;
+    json_t *o = json_loads (by_rank, 0, NULL);
+    if (o == NULL)
+        return NULL;
+    rl = rlist_from_hwloc_by_rank_obj (o, sched_pus);
+    json_decref (o);
+    return (rl);
+}
+
 int rlist_append_rank (struct rlist *rl, unsigned int rank, const char *ids)
 {
     struct rnode *n = rnode_create (rank, ids);
@@ -1011,7 +1046,7 @@ static int rlist_mark_all (struct rlist *rl, bool up)
     struct rnode *n = zlistx_first (rl->nodes);
     while (n) {
         if (n->up != up)
-            count += idset_count (n->avail);
+            count += n->navail;
         n->up = up;
         n = zlistx_next (rl->nodes);
     }
@@ -1028,9 +1063,11 @@ static int rlist_mark_state (struct rlist *rl, bool up, const char *ids)
     i = idset_first (idset);
     while (i != IDSET_INVALID_ID) {
         struct rnode *n = rlist_find_rank (rl, i);
-        if (n->up != up)
-            count += idset_count (n->avail);
-        n->up = up;
+        if (n) {
+            if (n->up != up)
+                count += n->navail;
+            n->up = up;
+        }
         i = idset_next (idset, i);
     }
     idset_destroy (idset);
@@ -24,6 +24,11 @@ struct rlist {
     int total;
     int avail;
     zlistx_t *nodes;
+
+    /* Index of nodes by rank for O(1) lookup. Values are borrowed
+     *  references to entries owned by the `nodes` list above.
+     */
+    zhashx_t *noderef;
 };
 
 /*  Create an empty rlist object */
@@ -51,6 +56,12 @@ struct rlist *rlist_copy_allocated (const struct rlist *orig);
  */
 struct rlist *rlist_from_hwloc_by_rank (const char *by_rank, bool sched_pus);
 
+/*  Same as rlist_from_hwloc_by_rank(), but takes a decoded JSON object,
+ *  avoiding a serialize/re-parse round trip when the caller already has
+ *  one (e.g. from a resource.acquire response).
+ */
+struct rlist *rlist_from_hwloc_by_rank_obj (json_t *o, bool sched_pus);
+
 /*  Destroy an rlist object */
 void rlist_destroy (struct rlist *rl);
 
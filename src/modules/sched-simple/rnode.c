@@ -38,6 +38,7 @@ struct rnode *rnode_create (uint32_t rank, const char *ids)
     if (!(n->ids = idset_decode (ids))
         || !(n->avail = idset_copy (n->ids)))
         goto fail;
+    n->navail = idset_count (n->avail);
     n->up = true;
     return (n);
 fail:
@@ -54,6 +55,7 @@ struct rnode *rnode_create_idset (uint32_t rank, struct idset *ids)
     if (!(n->ids = idset_copy (ids))
         || !(n->avail = idset_copy (ids)))
         goto fail;
+    n->navail = idset_count (n->avail);
     n->up = true;
     return (n);
 fail:
@@ -71,6 +73,7 @@ struct rnode *rnode_create_count (uint32_t rank, int count)
         || (idset_range_set (n->ids, 0, count-1) < 0)
         || !(n->avail = idset_copy (n->ids)))
         goto fail;
+    n->navail = idset_count (n->avail);
     n->up = true;
     return (n);
 fail:
@@ -86,12 +89,13 @@ int rnode_alloc (struct rnode *n, int count, struct idset **setp)
         errno = EHOSTDOWN;
         return -1;
     }
-    if (idset_count (n->avail) < count) {
+    if (n->navail < count) {
         errno = ENOSPC;
         return -1;
     }
     if (!(ids = idset_create (0, IDSET_FLAG_AUTOGROW)))
         return -1;
+    n->navail -= count;
     i = idset_first (n->avail);
     while (count--) {
         idset_set (ids, i);
@@ -136,6 +140,7 @@ int rnode_alloc_idset (struct rnode *n, struct idset *ids)
     i = idset_first (ids);
     while (i != IDSET_INVALID_ID) {
         idset_clear (n->avail, i);
+        n->navail--;
         i = idset_next (ids, i);
     }
     return 0;
@@ -174,6 +179,7 @@ int rnode_free_idset (struct rnode *n, struct idset *ids)
     i = idset_first (ids);
     while (i != IDSET_INVALID_ID) {
         idset_set (n->avail, i);
+        n->navail++;
         i = idset_next (ids, i);
     }
     return 0;
@@ -193,7 +199,7 @@ int rnode_free (struct rnode *n, const char *s)
 size_t rnode_avail (const struct rnode *n)
 {
     if (n->up)
-        return (idset_count (n->avail));
+        return (n->navail);
     return 0;
 }
 
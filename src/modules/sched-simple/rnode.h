@@ -25,6 +25,11 @@ struct rnode {
     uint32_t rank;
     struct idset * ids;
     struct idset * avail;
+
+    /* Cached count of ids in `avail`, kept in sync by the alloc/free
+     *  functions below so rnode_avail() does not have to walk the idset.
+     */
+    size_t navail;
 };
 
 /*  Create a resource node object from an existing idset `set`
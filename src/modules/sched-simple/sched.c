@@ -17,10 +17,28 @@
 #include <flux/schedutil.h>
 
 #include "src/common/libutil/errno_safe.h"
+#include "src/common/libutil/monotime.h"
 #include "src/common/libjob/job.h"
 #include "libjj.h"
 #include "rlist.h"
 
+/*  Number of scheduling cycle duration histogram buckets. Bucket i
+ *   counts cycles that took less than 0.01 * 10^i ms, with the final
+ *   bucket counting everything slower.
+ */
+#define CYCLE_HIST_SIZE 8
+
+struct sched_stats {
+    int ncycles;                    /* scheduling cycles (try_alloc calls) */
+    int nallocs;                    /* successful allocations */
+    int ndenied;                    /* alloc requests denied */
+    int nblocked;                   /* cycles blocked on insufficient cores */
+    int nfrees;                     /* successful frees */
+    double cycle_total;             /* total time in try_alloc (ms) */
+    double cycle_max;               /* longest try_alloc (ms) */
+    int cycle_hist[CYCLE_HIST_SIZE];
+};
+
 struct jobreq {
     void *handle;
     const flux_msg_t *msg;
@@ -42,6 +60,7 @@ struct simple_sched {
     struct rlist *rlist;    /* list of resources */
     zlistx_t *queue;        /* job queue */
     schedutil_t *util_ctx;
+    struct sched_stats stats;
 
     flux_watcher_t *prep;
     flux_watcher_t *check;
@@ -177,6 +196,28 @@ out:
     return (s);
 }
 
+/*  Account for one completed scheduling cycle which started at 't0'.
+ *   Counters are preallocated in struct simple_sched so this stays off
+ *   the allocator in the hot path.
+ */
+static void sched_stats_cycle_update (struct simple_sched *ss,
+                                      struct timespec t0)
+{
+    double ms = monotime_since (t0);
+    double limit = 0.01;
+    int bucket = 0;
+
+    ss->stats.ncycles++;
+    ss->stats.cycle_total += ms;
+    if (ms > ss->stats.cycle_max)
+        ss->stats.cycle_max = ms;
+    while (bucket < CYCLE_HIST_SIZE - 1 && ms >= limit) {
+        bucket++;
+        limit *= 10.;
+    }
+    ss->stats.cycle_hist[bucket]++;
+}
+
 static int try_alloc (flux_t *h, struct simple_sched *ss)
 {
     int rc = -1;
@@ -186,9 +227,11 @@ static int try_alloc (flux_t *h, struct simple_sched *ss)
     char *R = NULL;
     struct jobreq *job = zlistx_first (ss->queue);
     double now = flux_reactor_now (flux_get_reactor (h));
+    struct timespec t0;
 
     if (!job)
         return -1;
+    monotime (&t0);
     jj = &job->jj;
     alloc = rlist_alloc (ss->rlist, ss->mode,
                          jj->nnodes, jj->nslots, jj->slot_size);
@@ -202,10 +245,14 @@ static int try_alloc (flux_t *h, struct simple_sched *ss)
                 flux_log_error (h, "try_alloc: rlist_free");
             rlist_destroy (alloc);
             alloc = NULL;
-        } else if (errno == ENOSPC)
+        } else if (errno == ENOSPC) {
+            ss->stats.nblocked++;
+            sched_stats_cycle_update (ss, t0);
             return rc;
+        }
         else if (errno == EOVERFLOW)
             note = "unsatisfiable request";
+        ss->stats.ndenied++;
         if (schedutil_alloc_respond_deny (ss->util_ctx,
                                           job->msg,
                                           note) < 0)
@@ -222,6 +269,7 @@ static int try_alloc (flux_t *h, struct simple_sched *ss)
         flux_log_error (h, "schedutil_alloc_respond_success_pack");
 
     flux_log (h, LOG_DEBUG, "alloc: %ju: %s", (uintmax_t) job->id, s);
+    ss->stats.nallocs++;
     rc = 0;
 
 out:
@@ -229,6 +277,7 @@ out:
     rlist_destroy (alloc);
     free (R);
     free (s);
+    sched_stats_cycle_update (ss, t0);
     return rc;
 }
 
@@ -272,8 +321,10 @@ static int try_free (flux_t *h, struct simple_sched *ss, const char *R)
     r = rlist_dumps (alloc);
     if ((rc = rlist_free (ss->rlist, alloc)) < 0)
         flux_log_error (h, "free: %s", r);
-    else
+    else {
+        ss->stats.nfrees++;
         flux_log (h, LOG_DEBUG, "free: %s", r);
+    }
     free (r);
     rlist_destroy (alloc);
     return rc;
@@ -438,6 +489,46 @@ err:
         flux_log_error (h, "flux_respond_error");
 }
 
+static void stats_cb (flux_t *h, flux_msg_handler_t *mh,
+                      const flux_msg_t *msg, void *arg)
+{
+    struct simple_sched *ss = arg;
+    struct sched_stats *s = &ss->stats;
+    double avg = s->ncycles > 0 ? s->cycle_total / s->ncycles : 0.;
+    json_t *hist;
+    int i;
+
+    /*  Histogram bucket i counts cycles under 0.01 * 10^i ms.
+     */
+    if (!(hist = json_array ()))
+        goto enomem;
+    for (i = 0; i < CYCLE_HIST_SIZE; i++) {
+        json_t *o = json_integer (s->cycle_hist[i]);
+        if (!o || json_array_append_new (hist, o) < 0) {
+            json_decref (o);
+            goto enomem;
+        }
+    }
+    if (flux_respond_pack (h, msg,
+                           "{s:{s:i s:i s:i s:i s:i s:i s:f s:f s:o}}",
+                           "sched",
+                           "queue_depth", (int) zlistx_size (ss->queue),
+                           "cycles", s->ncycles,
+                           "allocs", s->nallocs,
+                           "denied", s->ndenied,
+                           "blocked", s->nblocked,
+                           "frees", s->nfrees,
+                           "cycle_avg_ms", avg,
+                           "cycle_max_ms", s->cycle_max,
+                           "cycle_hist", hist) < 0)
+        flux_log_error (h, "stats_cb: flux_respond_pack");
+    return;
+enomem:
+    json_decref (hist);
+    if (flux_respond_error (h, msg, ENOMEM, NULL) < 0)
+        flux_log_error (h, "stats_cb: flux_respond_error");
+}
+
 static int ss_resource_update (struct simple_sched *ss, flux_future_t *f)
 {
     const char *up = NULL;
@@ -490,7 +581,6 @@ static int ss_acquire_resources (flux_t *h, struct simple_sched *ss)
     int rc = -1;
     flux_future_t *f = NULL;
     json_t *o;
-    char *by_rank = NULL;
 
     if (!(f = flux_rpc (h, "resource.acquire",
                         NULL,
@@ -504,11 +594,7 @@ static int ss_acquire_resources (flux_t *h, struct simple_sched *ss)
         flux_log_error (h, "rpc_get (resource.acquire)");
         goto out;
     }
-    if (!(by_rank = json_dumps (o, JSON_COMPACT))) {
-        flux_log_error (h, "json_dumps (by_rank)");
-        goto out;
-    }
-    if (!(ss->rlist = rlist_from_hwloc_by_rank (by_rank, ss->sched_pus))) {
+    if (!(ss->rlist = rlist_from_hwloc_by_rank_obj (o, ss->sched_pus))) {
         flux_log_error (h, "rank_list_create");
         goto out;
     }
@@ -534,7 +620,6 @@ static int ss_acquire_resources (flux_t *h, struct simple_sched *ss)
     }
     rc = 0;
 out:
-    free (by_rank);
     return rc;
 }
 
@@ -605,6 +690,7 @@ static int process_args (flux_t *h, struct simple_sched *ss,
 
 static const struct flux_msg_handler_spec htab[] = {
     { FLUX_MSGTYPE_REQUEST, "*.resource-status", status_cb, FLUX_ROLE_USER },
+    { FLUX_MSGTYPE_REQUEST, "*.stats.get", stats_cb, FLUX_ROLE_USER },
     FLUX_MSGHANDLER_TABLE_END,
 };
 
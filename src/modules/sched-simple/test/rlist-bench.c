@@ -0,0 +1,257 @@
+/************************************************************\
+ * Copyright 2020 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* rlist-bench.c - drive the rlist alloc/free loop with a synthetic queue
+ *
+ * Allocates 'njobs' synthetic jobs against an rlist of configurable
+ * size, keeping at most 'depth' allocations outstanding to model queue
+ * churn, and reports throughput plus allocation latency percentiles.
+ * This exercises the same rlist_alloc()/rlist_free() calls made by
+ * sched-simple's alloc/free loop, without a live instance, so rlist
+ * changes can be quantified in isolation, e.g.
+ *
+ *   rlist-bench -N 4096 -c 64 -n 100000 -q 2048 -m worst-fit
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+
+#include "src/common/libutil/monotime.h"
+#include "rlist.h"
+
+struct bench_opts {
+    int nnodes;             /* number of nodes in synthetic resource set */
+    int cores_per_node;     /* cores per node */
+    int njobs;              /* total allocations to perform */
+    int depth;              /* max outstanding allocations (queue churn) */
+    int max_nslots;         /* slots per job drawn from [1:max_nslots] */
+    int max_slot_size;      /* slot size drawn from [1:max_slot_size] */
+    const char *mode;       /* rlist_alloc mode */
+    unsigned int seed;      /* PRNG seed for reproducible queues */
+};
+
+static const struct bench_opts defaults = {
+    .nnodes = 1024,
+    .cores_per_node = 16,
+    .njobs = 10000,
+    .depth = 512,
+    .max_nslots = 16,
+    .max_slot_size = 4,
+    .mode = NULL,
+    .seed = 42,
+};
+
+static void usage (void)
+{
+    fprintf (stderr,
+        "Usage: rlist-bench [OPTIONS]\n"
+        " -N COUNT   number of nodes (default %d)\n"
+        " -c COUNT   cores per node (default %d)\n"
+        " -n COUNT   jobs to allocate (default %d)\n"
+        " -q DEPTH   max outstanding allocations (default %d)\n"
+        " -S COUNT   max slots per job (default %d)\n"
+        " -z COUNT   max cores per slot (default %d)\n"
+        " -m MODE    allocation mode (worst-fit, best-fit, first-fit)\n"
+        " -s SEED    PRNG seed (default %u)\n",
+        defaults.nnodes,
+        defaults.cores_per_node,
+        defaults.njobs,
+        defaults.depth,
+        defaults.max_nslots,
+        defaults.max_slot_size,
+        defaults.seed);
+    exit (1);
+}
+
+static void die (const char *msg)
+{
+    fprintf (stderr, "rlist-bench: %s: %s\n", msg, strerror (errno));
+    exit (1);
+}
+
+static int cmp_double (const void *x, const void *y)
+{
+    const double *a = x;
+    const double *b = y;
+    return (*a < *b ? -1 : (*a > *b ? 1 : 0));
+}
+
+static double percentile (double *sorted, int n, double p)
+{
+    int i = (int)(p * (n - 1));
+    return sorted[i];
+}
+
+int main (int argc, char *argv[])
+{
+    struct bench_opts opts = defaults;
+    struct rlist *rl = NULL;
+    struct rlist **outstanding = NULL;
+    double *latency = NULL;
+    struct timespec t_run;
+    struct timespec t0;
+    int pending = 0;
+    int completed = 0;
+    int failed = 0;
+    int ch;
+    int i;
+
+    while ((ch = getopt (argc, argv, "N:c:n:q:S:z:m:s:h")) != -1) {
+        switch (ch) {
+            case 'N':
+                opts.nnodes = atoi (optarg);
+                break;
+            case 'c':
+                opts.cores_per_node = atoi (optarg);
+                break;
+            case 'n':
+                opts.njobs = atoi (optarg);
+                break;
+            case 'q':
+                opts.depth = atoi (optarg);
+                break;
+            case 'S':
+                opts.max_nslots = atoi (optarg);
+                break;
+            case 'z':
+                opts.max_slot_size = atoi (optarg);
+                break;
+            case 'm':
+                opts.mode = optarg;
+                break;
+            case 's':
+                opts.seed = strtoul (optarg, NULL, 10);
+                break;
+            case 'h':
+            default:
+                usage ();
+        }
+    }
+    if (opts.nnodes <= 0
+        || opts.cores_per_node <= 0
+        || opts.njobs <= 0
+        || opts.depth <= 0
+        || opts.max_nslots <= 0
+        || opts.max_slot_size > opts.cores_per_node)
+        usage ();
+
+    srandom (opts.seed);
+
+    if (!(rl = rlist_create ()))
+        die ("rlist_create");
+    for (i = 0; i < opts.nnodes; i++) {
+        struct idset *ids = idset_create (0, IDSET_FLAG_AUTOGROW);
+        if (!ids || idset_range_set (ids, 0, opts.cores_per_node - 1) < 0
+            || rlist_append_idset (rl, i, ids) < 0)
+            die ("rlist_append_idset");
+        idset_destroy (ids);
+    }
+    if (!(outstanding = calloc (opts.depth, sizeof (*outstanding)))
+        || !(latency = calloc (opts.njobs, sizeof (*latency))))
+        die ("calloc");
+
+    monotime (&t_run);
+    while (completed + failed < opts.njobs) {
+        int nslots = 1 + random () % opts.max_nslots;
+        int slot_size = 1 + random () % opts.max_slot_size;
+        struct rlist *alloc;
+
+        monotime (&t0);
+        alloc = rlist_alloc (rl, opts.mode, 0, nslots, slot_size);
+        if (alloc) {
+            latency[completed++] = monotime_since (t0);
+            /*  Model churn: free a random victim once the queue is full,
+             *   otherwise park the allocation in a free slot.
+             */
+            i = random () % opts.depth;
+            if (pending == opts.depth) {
+                if (rlist_free (rl, outstanding[i]) < 0)
+                    die ("rlist_free");
+                rlist_destroy (outstanding[i]);
+                pending--;
+            }
+            else {
+                while (outstanding[i])
+                    i = (i + 1) % opts.depth;
+            }
+            outstanding[i] = alloc;
+            pending++;
+        }
+        else if (errno == ENOSPC || errno == EOVERFLOW) {
+            /*  Not enough free or total resources: free the oldest
+             *   allocations until the request could fit, or count the
+             *   job as unsatisfiable if the queue is already empty.
+             */
+            if (pending == 0) {
+                failed++;
+                continue;
+            }
+            for (i = 0; i < opts.depth && pending > 0; i++) {
+                if (outstanding[i]) {
+                    if (rlist_free (rl, outstanding[i]) < 0)
+                        die ("rlist_free");
+                    rlist_destroy (outstanding[i]);
+                    outstanding[i] = NULL;
+                    pending--;
+                }
+            }
+        }
+        else
+            die ("rlist_alloc");
+    }
+
+    if (completed > 0) {
+        double elapsed = monotime_since (t_run) / 1000.;
+        double sum = 0.;
+
+        for (i = 0; i < completed; i++)
+            sum += latency[i];
+        qsort (latency, completed, sizeof (*latency), cmp_double);
+
+        printf ("nodes=%d cores/node=%d mode=%s depth=%d\n",
+                opts.nnodes,
+                opts.cores_per_node,
+                opts.mode ? opts.mode : "worst-fit",
+                opts.depth);
+        printf ("jobs: %d allocated, %d unsatisfiable, %.1f jobs/s\n",
+                completed,
+                failed,
+                completed / elapsed);
+        printf ("alloc latency (ms): avg=%.3f p50=%.3f p90=%.3f p99=%.3f "
+                "max=%.3f\n",
+                sum / completed,
+                percentile (latency, completed, 0.50),
+                percentile (latency, completed, 0.90),
+                percentile (latency, completed, 0.99),
+                latency[completed - 1]);
+    }
+
+    for (i = 0; i < opts.depth; i++) {
+        if (outstanding[i]) {
+            if (rlist_free (rl, outstanding[i]) < 0)
+                die ("rlist_free");
+            rlist_destroy (outstanding[i]);
+        }
+    }
+    free (outstanding);
+    free (latency);
+    rlist_destroy (rl);
+    return 0;
+}
+
+/* vi: ts=4 sw=4 expandtab
+ */
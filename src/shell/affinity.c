@@ -14,6 +14,8 @@
 #include "config.h"
 #endif
 
+#include <stdlib.h>
+#include <string.h>
 #include <hwloc.h>
 #include <flux/core.h>
 #include <flux/shell.h>
@@ -154,14 +156,84 @@ static void shell_affinity_destroy (void *arg)
     free (sa);
 }
 
+/*  Point the topology at hwloc XML saved by a previous discovery so
+ *   that hwloc_topology_load() parses XML instead of scanning the OS,
+ *   which can take hundreds of milliseconds on large SMP nodes.
+ *
+ *  Sources are tried in order:
+ *   - a file named by FLUX_HWLOC_XMLFILE in the environment
+ *   - this broker rank's resource.hwloc.xml.<rank> key in the KVS
+ *
+ *  Returns 0 if an XML source was set, with the lookup future (if any)
+ *   returned in 'fp' since the XML buffer belongs to it. Returns -1 if
+ *   no cached XML is available (e.g. standalone mode, hwloc not yet
+ *   loaded, or a guest unable to read the primary KVS namespace), in
+ *   which case the caller should fall back to a full scan.
+ */
+static int topology_set_xml_cache (struct shell_affinity *sa,
+                                   flux_shell_t *shell,
+                                   flux_future_t **fp)
+{
+    const char *path = getenv ("FLUX_HWLOC_XMLFILE");
+    flux_future_t *f = NULL;
+    flux_t *h;
+    const char *xml;
+    char key[64];
+    int rank;
+    int standalone;
+
+    if (path && hwloc_topology_set_xml (sa->topo, path) == 0)
+        return 0;
+    if (flux_shell_info_unpack (shell,
+                                "{s:{s:b}}",
+                                "options",
+                                  "standalone", &standalone) < 0
+        || standalone
+        || !(h = flux_shell_get_flux (shell)))
+        return -1;
+    if (flux_shell_rank_info_unpack (shell,
+                                     -1,
+                                     "{s:i}",
+                                     "broker_rank", &rank) < 0)
+        return -1;
+    if (snprintf (key, sizeof (key), "resource.hwloc.xml.%d", rank)
+        >= sizeof (key))
+        return -1;
+    if (!(f = flux_kvs_lookup (h, NULL, 0, key)))
+        return -1;
+    if (flux_kvs_lookup_get (f, &xml) < 0
+        || hwloc_topology_set_xmlbuffer (sa->topo, xml, strlen (xml) + 1) < 0) {
+        flux_future_destroy (f);
+        return -1;
+    }
+    *fp = f;
+    return 0;
+}
+
 /*  Initialize topology object for affinity processing.
  */
-static int shell_affinity_topology_init (struct shell_affinity *sa)
+static int shell_affinity_topology_init (struct shell_affinity *sa,
+                                         flux_shell_t *shell)
 {
+    flux_future_t *f = NULL;
+
     if (hwloc_topology_init (&sa->topo) < 0)
         return shell_log_errno ("hwloc_topology_init");
-    if (hwloc_topology_load (sa->topo) < 0)
+
+    /*  When loading from cached XML, hwloc must be told the XML
+     *   describes the current system or cpubind calls become no-ops.
+     */
+    if (topology_set_xml_cache (sa, shell, &f) == 0
+        && hwloc_topology_set_flags (sa->topo,
+                                     HWLOC_TOPOLOGY_FLAG_IS_THISSYSTEM) < 0) {
+        flux_future_destroy (f);
+        return shell_log_errno ("hwloc_topology_set_flags");
+    }
+    if (hwloc_topology_load (sa->topo) < 0) {
+        flux_future_destroy (f);
         return shell_log_errno ("hwloc_topology_load");
+    }
+    flux_future_destroy (f);
     if (topology_restrict_current (sa->topo) < 0)
         return shell_log_errno ("topology_restrict_current");
     return 0;
@@ -176,7 +248,7 @@ static struct shell_affinity * shell_affinity_create (flux_shell_t *shell)
     struct shell_affinity *sa = calloc (1, sizeof (*sa));
     if (!sa)
         return NULL;
-    if (shell_affinity_topology_init (sa) < 0)
+    if (shell_affinity_topology_init (sa, shell) < 0)
         goto err;
     if (flux_shell_rank_info_unpack (shell,
                                      -1,
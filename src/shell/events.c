@@ -21,7 +21,7 @@
 
 #include <flux/shell.h>
 
-#include "eventlogger.h"
+#include "src/common/libeventlog/eventlogger.h"
 
 struct shell_eventlogger {
     flux_shell_t *shell;
@@ -87,8 +87,14 @@ int shell_eventlogger_emit_event (struct shell_eventlogger *shev,
     json_t *o = zhashx_lookup (shev->contexts, event);
     if (o != NULL)
         context = json_dumps (o, JSON_COMPACT);
+
+    /*  Events are batched and committed write-behind by default so
+     *   that a burst of shell events costs one KVS commit. Callers
+     *   that require the entry to be committed before proceeding pass
+     *   EVENTLOGGER_FLAG_WAIT.
+     */
     rc = eventlogger_append (shev->ev,
-                             EVENTLOGGER_FLAG_WAIT,
+                             flags,
                              "exec.eventlog",
                              event,
                              context);
@@ -96,6 +102,15 @@ int shell_eventlogger_emit_event (struct shell_eventlogger *shev,
     return rc;
 }
 
+int shell_eventlogger_flush (struct shell_eventlogger *shev)
+{
+    if (!shev) {
+        errno = EINVAL;
+        return -1;
+    }
+    return eventlogger_flush (shev->ev);
+}
+
 static int context_set (struct shell_eventlogger *shev,
                         const char *name,
                         int flags,
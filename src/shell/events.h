@@ -16,10 +16,18 @@ struct shell_eventlogger;
 void shell_eventlogger_destroy (struct shell_eventlogger *shev);
 struct shell_eventlogger *shell_eventlogger_create (flux_shell_t *shell);
 
+/*  Emit event 'event' to the shell exec.eventlog, with any context
+ *   previously registered for the event. 'flags' are eventlogger
+ *   flags, e.g. EVENTLOGGER_FLAG_WAIT for a synchronous append.
+ */
 int shell_eventlogger_emit_event (struct shell_eventlogger *shev,
                                   int flags,
                                   const char *event);
 
+/*  Synchronously commit any events not yet written to the KVS.
+ */
+int shell_eventlogger_flush (struct shell_eventlogger *shev);
+
 int shell_eventlogger_context_vpack (struct shell_eventlogger *shev,
                                      const char *event,
                                      int flags,
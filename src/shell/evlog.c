@@ -40,7 +40,7 @@
 #include "info.h"
 #include "internal.h"
 #include "builtins.h"
-#include "eventlogger.h"
+#include "src/common/libeventlog/eventlogger.h"
 
 struct evlog {
     int sync_mode;
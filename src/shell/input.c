@@ -44,16 +44,11 @@ enum {
     FLUX_TASK_INPUT_KVS = 1,
 };
 
-struct shell_task_input_kvs {
-    flux_future_t *input_f;
-    bool input_header_parsed;
-};
-
 struct shell_task_input {
     struct shell_input *in;
     struct shell_task *task;
     int type;
-    struct shell_task_input_kvs input_kvs;
+    bool eof_received;
 };
 
 struct shell_input_type_file {
@@ -63,25 +58,33 @@ struct shell_input_type_file {
     char *rankstr;
 };
 
+/*  The guest.input eventlog is watched once per shell, with each data
+ *   entry decoded once and fanned out to the local tasks it targets,
+ *   rather than one eventlog watch and decode per task.
+ */
+struct shell_input_kvs {
+    flux_future_t *input_f;
+    bool input_header_parsed;
+    bool watch_cancelled;
+};
+
 struct shell_input {
     flux_shell_t *shell;
     int stdin_type;
     struct shell_task_input *task_inputs;
     int ntasks;
+    int ntasks_eof;
+    int ntasks_exited;
+    struct shell_input_kvs input_kvs;
     struct shell_input_type_file stdin_file;
 };
 
-static void shell_task_input_kvs_cleanup (struct shell_task_input_kvs *kp)
+static void shell_input_kvs_cleanup (struct shell_input_kvs *kp)
 {
     flux_future_destroy (kp->input_f);
     kp->input_f = NULL;
 }
 
-static void shell_task_input_cleanup (struct shell_task_input *tp)
-{
-    shell_task_input_kvs_cleanup (&(tp->input_kvs));
-}
-
 static void shell_input_type_file_cleanup (struct shell_input_type_file *fp)
 {
     close (fp->fd);
@@ -93,10 +96,8 @@ void shell_input_destroy (struct shell_input *in)
 {
     if (in) {
         int saved_errno = errno;
-        int i;
         shell_input_type_file_cleanup (&(in->stdin_file));
-        for (i = 0; i < in->ntasks; i++)
-            shell_task_input_cleanup (&(in->task_inputs[i]));
+        shell_input_kvs_cleanup (&(in->input_kvs));
         free (in->task_inputs);
         free (in);
         errno = saved_errno;
@@ -435,26 +436,47 @@ static int shell_input_init (flux_plugin_t *p,
     return 0;
 }
 
-/*  Return 1 if idset string 'set' contains the integer id.
- *  O/w, return 0, or -1 on failure to decode 'set'.
+static void shell_input_kvs_watch_cancel (struct shell_input *in)
+{
+    struct shell_input_kvs *kp = &(in->input_kvs);
+
+    if (kp->input_f && !kp->watch_cancelled) {
+        if (flux_job_event_watch_cancel (kp->input_f) < 0)
+            shell_log_errno ("flux_job_event_watch_cancel");
+        kp->watch_cancelled = true;
+    }
+}
+
+/*  Deliver one decoded input chunk to task 'ti'.
  */
-static int idset_string_contains (const char *set, uint32_t id)
+static void shell_task_input_deliver (struct shell_task_input *ti,
+                                      const char *stream,
+                                      const char *data,
+                                      int len,
+                                      bool eof)
 {
-    int rc;
-    struct idset *idset;
-    if (strcmp (set, "all") == 0)
-        return 1;
-    if (!(idset = idset_decode (set)))
-        return shell_log_errno ("idset_decode (%s)", set);
-    rc = idset_test (idset, id);
-    idset_destroy (idset);
-    return rc;
+    flux_shell_task_t *task = ti->task;
+
+    if (len > 0) {
+        if (flux_subprocess_write (task->proc, stream, data, len) < 0) {
+            if (errno != EPIPE)
+                shell_die_errno (1, "flux_subprocess_write");
+            else
+                eof = true; /* Pretend that we got eof */
+        }
+    }
+    if (eof) {
+        if (flux_subprocess_close (task->proc, stream) < 0)
+            shell_die_errno (1, "flux_subprocess_close");
+        ti->eof_received = true;
+        ti->in->ntasks_eof++;
+    }
 }
 
-static void shell_task_input_kvs_input_cb (flux_future_t *f, void *arg)
+static void shell_input_kvs_input_cb (flux_future_t *f, void *arg)
 {
-    struct shell_task_input *task_input = arg;
-    struct shell_task_input_kvs *kp = &(task_input->input_kvs);
+    struct shell_input *in = arg;
+    struct shell_input_kvs *kp = &(in->input_kvs);
     const char *entry;
     json_t *o;
     const char *name;
@@ -476,61 +498,60 @@ static void shell_task_input_kvs_input_cb (flux_future_t *f, void *arg)
         kp->input_header_parsed = true;
     }
     else if (!strcmp (name, "data")) {
-        flux_shell_task_t *task = task_input->task;
         const char *rank = NULL;
+        const char *stream;
+        const char *data = NULL;
+        int len;
+        bool eof;
+        bool all;
+        struct idset *ids = NULL;
+        int i;
+
         if (!kp->input_header_parsed)
             shell_die (1, "stream data read before header");
-        if (iodecode (context, NULL, &rank, NULL, NULL, NULL) < 0)
+        if (iodecode_ref (context, &stream, &rank, &data, &len, &eof) < 0)
             shell_die (1, "malformed event context");
-        if (idset_string_contains (rank, task->rank) == 1) {
-            const char *stream;
-            char *data = NULL;
-            int len;
-            bool eof;
-            if (iodecode (context, &stream, NULL, &data, &len, &eof) < 0)
-                shell_die (1, "malformed event context");
-            if (len > 0) {
-                if (flux_subprocess_write (task->proc,
-                                           stream,
-                                           data,
-                                           len) < 0) {
-                    if (errno != EPIPE)
-                        shell_die_errno (1, "flux_subprocess_write");
-                    else
-                        eof = true; /* Pretend that we got eof */
-                }
-            }
-            if (eof) {
-                if (flux_subprocess_close (task->proc, stream) < 0)
-                    shell_die_errno (1, "flux_subprocess_close");
-                if (flux_job_event_watch_cancel (f) < 0)
-                    shell_die_errno (1, "flux_job_event_watch_cancel");
-            }
-            free (data);
+
+        /*  Decode the chunk and target idset once, then fan the single
+         *   buffer out to all local tasks in the target set.
+         */
+        all = (strcmp (rank, "all") == 0);
+        if (!all && !(ids = idset_decode (rank)))
+            shell_die_errno (1, "idset_decode (%s)", rank);
+        for (i = 0; i < in->ntasks; i++) {
+            struct shell_task_input *ti = &in->task_inputs[i];
+            if (!ti->task || ti->eof_received)
+                continue;
+            if (all || idset_test (ids, ti->task->rank))
+                shell_task_input_deliver (ti, stream, data, len, eof);
         }
+        idset_destroy (ids);
+
+        if (in->ntasks_eof == in->ntasks)
+            shell_input_kvs_watch_cancel (in);
     }
     json_decref (o);
     flux_future_reset (f);
     return;
 done:
-    shell_task_input_kvs_cleanup (kp);
+    shell_input_kvs_cleanup (kp);
 }
 
-static int shell_task_input_kvs_start (struct shell_task_input *ti)
+static int shell_input_kvs_start (struct shell_input *in)
 {
-    struct shell_task_input_kvs *kp = &(ti->input_kvs);
+    struct shell_input_kvs *kp = &(in->input_kvs);
     flux_future_t *f = NULL;
     /*  Start watching kvs guest.input eventlog.
      *  Since this function is called after shell initialization
      *   barrier, we are guaranteed that input eventlog exists.
      */
-    if (!(f = flux_job_event_watch (ti->in->shell->h,
-                                    ti->in->shell->info->jobid,
+    if (!(f = flux_job_event_watch (in->shell->h,
+                                    in->shell->info->jobid,
                                     "guest.input",
                                     0)))
             shell_die_errno (1, "flux_job_event_watch");
 
-    if (flux_future_then (f, -1., shell_task_input_kvs_input_cb, ti) < 0) {
+    if (flux_future_then (f, -1., shell_input_kvs_input_cb, in) < 0) {
         flux_future_destroy (f);
         shell_die_errno (1, "flux_future_then");
     }
@@ -562,10 +583,14 @@ static int shell_input_task_init (flux_plugin_t *p,
     task_input->task = task;
 
     if (task_input->type == FLUX_TASK_INPUT_KVS) {
-        /* can't read stdin in standalone mode, no KVS to read from */
-        if (!task_input->in->shell->standalone
-            && shell_task_input_kvs_start (task_input) < 0)
-            shell_die_errno (1, "shell_input_start_task_watch");
+        /* can't read stdin in standalone mode, no KVS to read from.
+         * The eventlog watch is shared by all local tasks, so start
+         *  it on the first task only.
+         */
+        if (!in->shell->standalone
+            && !in->input_kvs.input_f
+            && shell_input_kvs_start (in) < 0)
+            shell_die_errno (1, "shell_input_kvs_start");
     }
     return 0;
 }
@@ -584,11 +609,14 @@ static int shell_input_task_exit (flux_plugin_t *p,
         return -1;
 
     task_input = get_task_input (in, task);
+    task_input->task = NULL;
+
+    /*  Cancel the shared eventlog watch once the last local task
+     *   has exited.
+     */
     if (task_input->type == FLUX_TASK_INPUT_KVS
-        && task_input->input_kvs.input_f) {
-        if (flux_job_event_watch_cancel (task_input->input_kvs.input_f) < 0)
-            shell_log_errno ("flux_job_event_watch_cancel");
-    }
+        && ++in->ntasks_exited == in->ntasks)
+        shell_input_kvs_watch_cancel (in);
     return 0;
 }
 
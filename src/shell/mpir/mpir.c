@@ -30,12 +30,22 @@
 #include "mpir/proctable.h"
 
 
-/*  Structure for use during proctable gather from shell rank 0.
+/*  Proctables are gathered up a k-ary tree over shell ranks: each shell
+ *   merges its children's subtree tables into its own and responds to
+ *   its parent, so the leader assembles the full table in O(log size)
+ *   round trips instead of serially draining one response per shell.
+ *   The entries themselves are already compact - hostnames and
+ *   executables are interned in nodelists and taskids/pids delta
+ *   encoded in rangelists - so merged tables stay small on the wire.
+ */
+static const int proctable_gather_fanout = 32;
+
+/*  Structure for use during proctable gather from child shells.
  */
 struct proctable_gather {
     flux_t *h;
     flux_shell_t *shell;
-    int shell_size;
+    int expected;                  /* local table plus one per child */
     const flux_msg_t *req;
     zlistx_t *proctables;
     zlistx_t *futures;
@@ -45,6 +55,12 @@ struct proctable_gather {
  */
 static char hostname [1024] = "";
 
+/*  Merged result of the last gather, so repeated tool attaches are
+ *   served without walking the tree again.  Pids are stable for the
+ *   life of the job, so the cache never goes stale.
+ */
+static struct proctable *proctable_cache = NULL;
+
 static int shell_task_rank (flux_shell_task_t *task)
 {
     int rank = -1;
@@ -184,7 +200,7 @@ static void proctable_gather_destroy (struct proctable_gather *pg)
 }
 
 static struct proctable_gather *proctable_gather_create (flux_shell_t *shell,
-                                                         int shell_size,
+                                                         int expected,
                                                          const flux_msg_t *msg)
 {
     struct proctable_gather *pg = calloc (1, sizeof (*pg));
@@ -197,7 +213,7 @@ static struct proctable_gather *proctable_gather_create (flux_shell_t *shell,
      */
     flux_shell_add_completion_ref (pg->shell, "proctable.get");
 
-    pg->shell_size = shell_size;
+    pg->expected = expected;
     pg->h = flux_shell_get_flux (shell);
     pg->req = flux_msg_incref (msg);
     if (!(pg->proctables = zlistx_new ())
@@ -215,10 +231,10 @@ err:
 
 static int proctable_gather_complete (struct proctable_gather *pg)
 {
-    /*  Once we've stored all local/remote proctables, reduce the
-     *   list and respond to original request.
+    /*  Once we've stored the local and all child subtree proctables,
+     *   reduce the list and respond to original request.
      */
-    if (zlistx_size (pg->proctables) == pg->shell_size) {
+    if (zlistx_size (pg->proctables) == pg->expected) {
         struct proctable *p = zlistx_detach (pg->proctables, NULL);
         struct proctable *next = zlistx_detach (pg->proctables, NULL);
 
@@ -235,12 +251,13 @@ static int proctable_gather_complete (struct proctable_gather *pg)
         shell_debug ("proctable gather complete. size=%d",
                      proctable_get_size (p));
 
-        /*  Respond to the original request with the full proctable:
+        /*  Respond to the original request with the merged proctable:
          */
         if (respond_proctable (pg->h, pg->req, p) < 0)
             return shell_log_errno ("proctable respond");
 
-        proctable_destroy (p);
+        proctable_destroy (proctable_cache);
+        proctable_cache = p;
         proctable_gather_destroy (pg);
     }
     return 0;
@@ -291,31 +308,50 @@ err:
     proctable_gather_cancel (pg);
 }
 
-static int request_all_proctables (flux_shell_t *shell,
-                                   int shell_size,
-                                   const flux_msg_t *msg,
-                                   struct proctable *p)
+/*  Return the number of tree children of shell 'rank' in a job of
+ *   'size' shells.
+ */
+static int proctable_gather_nchildren (int rank, int size)
+{
+    int n = 0;
+
+    for (int i = 1; i <= proctable_gather_fanout; i++)
+        if (proctable_gather_fanout * rank + i < size)
+            n++;
+    return n;
+}
+
+static int request_child_proctables (flux_shell_t *shell,
+                                     int rank,
+                                     int size,
+                                     int nchildren,
+                                     const flux_msg_t *msg,
+                                     struct proctable *p)
 {
     struct proctable_gather *pg;
 
-    if (!(pg = proctable_gather_create (shell, shell_size, msg))
+    if (!(pg = proctable_gather_create (shell, nchildren + 1, msg))
         || !zlistx_insert (pg->proctables, p, false)) {
         shell_log_errno ("failed to create proctable gather struct");
         goto err;
     }
 
-    shell_debug ("requesting proctables from %d ranks", pg->shell_size - 1);
-    for (int i = 1; i < pg->shell_size; i++) {
+    shell_debug ("requesting proctables from %d children", nchildren);
+    for (int i = 1; i <= proctable_gather_fanout; i++) {
+        int child = proctable_gather_fanout * rank + i;
         flux_future_t *f;
-        /*  Request proctable from remote shell:
+
+        if (child >= size)
+            break;
+        /*  Request merged subtree proctable from child shell:
          */
-        if (!(f = flux_shell_rpc_pack (shell, "proctable", i, 0, "{}"))) {
+        if (!(f = flux_shell_rpc_pack (shell, "proctable", child, 0, "{}"))) {
             shell_log_errno ("flux_shell_rpc_pack");
             goto err;
         }
         /*  Give 5.0s for shells to respond. This timeout is required
          *   in case remote shells have already exited or are exiting
-         *   at the time the leader shell requests proctables. In that
+         *   at the time the parent shell requests proctables. In that
          *   case the request RPC is dropped without any ENOSYS response.
          */
         if (flux_future_then (f, 5., proctable_get_cb, pg) < 0) {
@@ -337,26 +373,37 @@ static void mpir_proctable_get (flux_t *h,
 {
     flux_shell_t *shell = arg;
     int size = shell_size (shell);
-    struct proctable *p = local_proctable_create (shell);
+    int rank = shell_rank (shell);
+    int nchildren;
+    struct proctable *p;
 
-    if (p == NULL)
+    /*  Serve repeated requests from the cached merge:
+     */
+    if (proctable_cache) {
+        if (respond_proctable (h, msg, proctable_cache) < 0)
+            shell_log_errno ("unable to send proctable");
+        return;
+    }
+
+    if (size < 0 || rank < 0 || !(p = local_proctable_create (shell)))
         goto error;
 
-    /*  For non-leader shells, or a job size of 1, immediately respond
-     *   to the request with the local proctable.
+    /*  Shells with no tree children immediately respond to the request
+     *   with the local proctable.
      */
-    if (shell_rank (shell) != 0 || size == 1) {
+    nchildren = proctable_gather_nchildren (rank, size);
+    if (nchildren == 0) {
         if (respond_proctable (h, msg, p) < 0)
             shell_log_errno ("unable to send proctable");
-        proctable_destroy (p);
+        proctable_cache = p;
         return;
     }
 
-    /*  On a leader shell in a job with size > 1, initiate requests to
-     *   all other shells for their local proctables.
+    /*  Otherwise initiate requests to this shell's tree children for
+     *   their merged subtree proctables.
      */
-    if (request_all_proctables (shell, size, msg, p) < 0)
-        shell_log_errno ("request_all_proctables");
+    if (request_child_proctables (shell, rank, size, nchildren, msg, p) < 0)
+        shell_log_errno ("request_child_proctables");
     return;
 error:
     if (flux_respond_error (h, msg, errno, NULL) < 0)
@@ -384,9 +431,20 @@ static int mpir_service_init (flux_plugin_t *p,
     return 0;
 }
 
+static int mpir_service_exit (flux_plugin_t *p,
+                              const char *topic,
+                              flux_plugin_arg_t *args,
+                              void *data)
+{
+    proctable_destroy (proctable_cache);
+    proctable_cache = NULL;
+    return 0;
+}
+
 struct shell_builtin builtin_mpir = {
     .name = "mpir",
     .init = mpir_service_init,
+    .exit = mpir_service_exit,
 };
 
 /*
@@ -56,7 +56,7 @@
 #include "svc.h"
 #include "internal.h"
 #include "builtins.h"
-#include "eventlogger.h"
+#include "src/common/libeventlog/eventlogger.h"
 
 enum {
     FLUX_OUTPUT_TYPE_TERM = 1,
@@ -72,12 +72,15 @@ struct shell_output_type_file {
     struct shell_output_fd *fdp;
     char *path;
     int label;
+    int per_shell;      /* path contained {{node}}, one file per shell */
 };
 
 struct shell_output {
     flux_shell_t *shell;
     struct eventlogger *ev;
     double batch_timeout;
+    int line_buffer;
+    int direct;
     int refcount;
     int eof_pending;
     zlist_t *pending_writes;
@@ -149,9 +152,9 @@ static int shell_output_term (struct shell_output *out)
             FILE *f;
             const char *stream = NULL;
             const char *rank = NULL;
-            char *data = NULL;
+            const char *data = NULL;
             int len = 0;
-            if (iodecode (context, &stream, &rank, &data, &len, NULL) < 0) {
+            if (iodecode_ref (context, &stream, &rank, &data, &len, NULL) < 0) {
                 shell_log_errno ("iodecode");
                 return -1;
             }
@@ -167,7 +170,6 @@ static int shell_output_term (struct shell_output *out)
                 fprintf (f, "%s: ", rank);
                 fwrite (data, len, 1, f);
             }
-            free (data);
         }
     }
     return 0;
@@ -338,6 +340,40 @@ static int shell_output_write_fd (int fd, const void *buf, size_t len)
     return n;
 }
 
+/* check if output of this type is written locally by each shell
+ *  instead of being routed to the leader */
+static bool output_type_is_direct (struct shell_output *out, int type)
+{
+    return (out->direct && type == FLUX_OUTPUT_TYPE_FILE);
+}
+
+/*  Write local task output directly to the stream's output file,
+ *   bypassing the leader shell and KVS entirely.
+ */
+static int shell_output_direct (struct shell_output *out,
+                                int rank,
+                                const char *stream,
+                                const char *data,
+                                int len)
+{
+    struct shell_output_type_file *ofp;
+
+    if (!strcmp (stream, "stdout"))
+        ofp = &out->stdout_file;
+    else
+        ofp = &out->stderr_file;
+
+    if (len <= 0)
+        return 0;
+    if (ofp->label) {
+        char buf[64];
+        int buflen = snprintf (buf, sizeof (buf), "%d: ", rank);
+        if (shell_output_write_fd (ofp->fdp->fd, buf, buflen) < 0)
+            return -1;
+    }
+    return shell_output_write_fd (ofp->fdp->fd, data, len);
+}
+
 static int shell_output_file (struct shell_output *out)
 {
     json_t *entry;
@@ -355,9 +391,9 @@ static int shell_output_file (struct shell_output *out)
             int output_type;
             const char *stream = NULL;
             const char *rank = NULL;
-            char *data = NULL;
+            const char *data = NULL;
             int len = 0;
-            if (iodecode (context, &stream, &rank, &data, &len, NULL) < 0) {
+            if (iodecode_ref (context, &stream, &rank, &data, &len, NULL) < 0) {
                 shell_log_errno ("iodecode");
                 return -1;
             }
@@ -384,7 +420,6 @@ static int shell_output_file (struct shell_output *out)
                 if (shell_output_write_fd (ofp->fdp->fd, data, len) < 0)
                     return -1;
             }
-            free (data);
         }
     }
     return 0;
@@ -505,6 +540,23 @@ error:
     return -1;
 }
 
+/*  Dispose of local task output on 'stream': written locally in
+ *   direct mode, otherwise sent to the leader shell.
+ */
+static int shell_output_deliver (struct shell_output *out,
+                                 int rank,
+                                 const char *stream,
+                                 const char *data,
+                                 int len,
+                                 bool eof)
+{
+    int type = !strcmp (stream, "stdout") ? out->stdout_type
+                                          : out->stderr_type;
+    if (output_type_is_direct (out, type))
+        return shell_output_direct (out, rank, stream, data, len);
+    return shell_output_write (out, rank, stream, data, len, eof);
+}
+
 static void shell_output_type_file_cleanup (struct shell_output_type_file *ofp)
 {
     if (ofp->path)
@@ -569,6 +621,13 @@ static bool output_type_requires_service (int type)
     return false;
 }
 
+/* check if output of this type is routed to the leader shell */
+static bool output_type_is_routed (struct shell_output *out, int type)
+{
+    return (output_type_requires_service (type)
+            && !output_type_is_direct (out, type));
+}
+
 static int shell_output_parse_type (struct shell_output *out,
                                     const char *typestr,
                                     int *typep)
@@ -586,37 +645,69 @@ static int shell_output_parse_type (struct shell_output *out,
     return 0;
 }
 
-/* handle mustache templates and the similar special cases */
-static char *shell_output_get_path (struct shell_output *out, const char *path)
+/* Replace first occurrence of 'tag' in 'path' with 'val', returning
+ *  a newly allocated string, or NULL with errno set. ENOENT indicates
+ *  'tag' was not present in 'path'.
+ */
+static char *shell_output_replace_tag (const char *path,
+                                       const char *tag,
+                                       const char *val)
 {
     char *rv = NULL;
     char *ptr;
+    int len, taglen, vallen, total_len;
+
+    if (!(ptr = strstr (path, tag))) {
+        errno = ENOENT;
+        return NULL;
+    }
+    len = strlen (path);
+    taglen = strlen (tag);
+    vallen = strlen (val);
+    /* +1 for NUL */
+    total_len = len - taglen + vallen + 1;
+    if (total_len > (PATH_MAX + 1)) {
+        errno = EOVERFLOW;
+        return NULL;
+    }
+    if (!(rv = calloc (1, total_len)))
+        return NULL;
+    memcpy (rv, path, ptr - path);
+    memcpy (rv + (ptr - path), val, vallen);
+    memcpy (rv + (ptr - path) + vallen, ptr + taglen, len - (ptr - path) - taglen);
+    return rv;
+}
+
+/* handle mustache templates and the similar special cases */
+static char *shell_output_get_path (struct shell_output *out,
+                                    const char *path,
+                                    int *per_shell)
+{
+    char buf[32];
+    char *rv = NULL;
+    char *s = NULL;
 
     /* replace {{id}} with jobid */
-    if ((ptr = strstr (path, "{{id}}"))) {
-        char buf[32];
-        int len, buflen, total_len;
-
-        len = strlen (path);
-        buflen = snprintf (buf, sizeof (buf), "%ju",
-                           (uintmax_t)out->shell->info->jobid);
-        /* -6 for {{id}}, +1 for NUL */
-        total_len = len - 6 + buflen + 1;
-        if (total_len > (PATH_MAX + 1)) {
-            errno = EOVERFLOW;
+    snprintf (buf, sizeof (buf), "%ju", (uintmax_t)out->shell->info->jobid);
+    if (!(s = shell_output_replace_tag (path, "{{id}}", buf))) {
+        if (errno != ENOENT)
             return NULL;
-        }
-        if (!(rv = calloc (1, total_len)))
+        if (!(s = strdup (path)))
             return NULL;
-        memcpy (rv, path, ptr - path);
-        memcpy (rv + (ptr - path), buf, buflen);
-        memcpy (rv + (ptr - path) + buflen, ptr + 6, len - (ptr - path) - 6);
     }
-    else {
-        if (!(rv = strdup (path)))
-            return NULL;
+    /* replace {{node}} with shell rank, for one output file per shell */
+    snprintf (buf, sizeof (buf), "%d", out->shell->info->shell_rank);
+    if ((rv = shell_output_replace_tag (s, "{{node}}", buf))) {
+        if (per_shell)
+            (*per_shell) = 1;
+        free (s);
+        return rv;
     }
-    return rv;
+    if (errno != ENOENT) {
+        free (s);
+        return NULL;
+    }
+    return s;
 }
 
 static int
@@ -637,7 +728,7 @@ shell_output_setup_type_file (struct shell_output *out,
         return -1;
     }
 
-    if (!(ofp->path = shell_output_get_path (out, path)))
+    if (!(ofp->path = shell_output_get_path (out, path, &ofp->per_shell)))
         return -1;
 
     if (flux_shell_getopt_unpack (out->shell, "output",
@@ -649,6 +740,7 @@ shell_output_setup_type_file (struct shell_output *out,
         if (!(ofp_copy->path = strdup (ofp->path)))
             return -1;
         ofp_copy->label = ofp->label;
+        ofp_copy->per_shell = ofp->per_shell;
     }
 
     return 0;
@@ -764,6 +856,16 @@ static int shell_output_type_file_setup (struct shell_output *out,
     struct shell_output_fd *fdp = NULL;
     int saved_errno, fd = -1;
 
+    /*  In direct mode multiple shells may append to a shared file, so
+     *   writes must go through O_APPEND, and only the leader (or the
+     *   sole writer of a per-shell file) truncates.
+     */
+    if (out->direct) {
+        open_flags = O_CREAT | O_WRONLY | O_APPEND;
+        if (out->shell->info->shell_rank == 0 || ofp->per_shell)
+            open_flags |= O_TRUNC;
+    }
+
     /* check if we're outputting to the same file as another stream */
     if ((fdp = zhash_lookup (out->fds, ofp->path))) {
         ofp->fdp = fdp;
@@ -881,6 +983,33 @@ struct shell_output *shell_output_create (flux_shell_t *shell)
     if (!(out = calloc (1, sizeof (*out))))
         return NULL;
     out->shell = shell;
+
+    /*  Output is line buffered by default so interleaved output from
+     *   multiple tasks remains readable. IO-heavy jobs can disable it
+     *   to batch output by subprocess buffer content instead, reducing
+     *   the number of writes to the leader shell.
+     */
+    out->line_buffer = 1;
+    if (flux_shell_getopt_unpack (out->shell, "output",
+                                  "{s?:b}",
+                                  "line-buffer", &out->line_buffer) < 0) {
+        shell_log_error ("invalid output.line-buffer option");
+        goto error;
+    }
+
+    /*  In direct mode, file output is written locally by each shell
+     *   instead of being routed through the leader, so job IO never
+     *   transits the TBON or KVS. Only the redirect event is logged.
+     *   Use a {{node}} path template for one file per shell, or a
+     *   shared path for interleaved appends.
+     */
+    if (flux_shell_getopt_unpack (out->shell, "output",
+                                  "{s?:b}",
+                                  "direct", &out->direct) < 0) {
+        shell_log_error ("invalid output.direct option");
+        goto error;
+    }
+
     if (out->shell->standalone) {
         out->stdout_type = FLUX_OUTPUT_TYPE_TERM;
         out->stderr_type = FLUX_OUTPUT_TYPE_TERM;
@@ -896,16 +1025,16 @@ struct shell_output *shell_output_create (flux_shell_t *shell)
     if (!(out->pending_writes = zlist_new ()))
         goto error;
     if (shell->info->shell_rank == 0) {
-        if (output_type_requires_service (out->stdout_type)
-            || output_type_requires_service (out->stderr_type)) {
+        if (output_type_is_routed (out, out->stdout_type)
+            || output_type_is_routed (out, out->stderr_type)) {
             if (flux_shell_service_register (shell,
                                              "write",
                                              shell_output_write_cb,
                                              out) < 0)
                 goto error;
-            if (output_type_requires_service (out->stdout_type))
+            if (output_type_is_routed (out, out->stdout_type))
                 out->eof_pending += shell->info->total_ntasks;
-            if (output_type_requires_service (out->stderr_type))
+            if (output_type_is_routed (out, out->stderr_type))
                 out->eof_pending += shell->info->total_ntasks;
             if (flux_shell_add_completion_ref (shell, "output.write") < 0)
                 goto error;
@@ -914,6 +1043,11 @@ struct shell_output *shell_output_create (flux_shell_t *shell)
                 goto error;
             }
         }
+    }
+    /*  File output is opened by the leader, or by every shell when
+     *   writing directly.
+     */
+    if (shell->info->shell_rank == 0 || out->direct) {
         if (out->stdout_type == FLUX_OUTPUT_TYPE_FILE
             || out->stderr_type == FLUX_OUTPUT_TYPE_FILE) {
             if (!(out->fds = zhash_new ())) {
@@ -929,6 +1063,8 @@ struct shell_output *shell_output_create (flux_shell_t *shell)
                     goto error;
             }
         }
+    }
+    if (shell->info->shell_rank == 0) {
         if (output_eventlogger_start (out) < 0)
             goto error;
         if (shell_output_header (out) < 0)
@@ -948,17 +1084,46 @@ static void task_output_cb (struct shell_task *task,
     const char *data;
     int len;
 
-    data = flux_subprocess_getline (task->proc, stream, &len);
-    if (len < 0) {
-        shell_log_errno ("read %s task %d", stream, task->rank);
-    }
-    else if (len > 0) {
-        if (shell_output_write (out, task->rank, stream, data, len, false) < 0)
-            shell_log_errno ("write %s task %d", stream, task->rank);
+    if (out->line_buffer) {
+        data = flux_subprocess_getline (task->proc, stream, &len);
+        if (len < 0) {
+            shell_log_errno ("read %s task %d", stream, task->rank);
+        }
+        else if (len > 0) {
+            if (shell_output_deliver (out,
+                                    task->rank,
+                                    stream,
+                                    data,
+                                    len,
+                                    false) < 0)
+                shell_log_errno ("write %s task %d", stream, task->rank);
+        }
+        else if (flux_subprocess_read_stream_closed (task->proc, stream)) {
+            if (shell_output_deliver (out, task->rank, stream, NULL, 0, true) < 0)
+                shell_log_errno ("write eof %s task %d", stream, task->rank);
+        }
     }
-    else if (flux_subprocess_read_stream_closed (task->proc, stream)) {
-        if (shell_output_write (out, task->rank, stream, NULL, 0, true) < 0)
-            shell_log_errno ("write eof %s task %d", stream, task->rank);
+    else {
+        /*  With line buffering disabled, forward whatever is in the
+         *   subprocess buffer in one write so overhead scales with
+         *   bytes rather than lines. A zero length read means EOF.
+         */
+        if (!(data = flux_subprocess_read (task->proc, stream, -1, &len))) {
+            shell_log_errno ("read %s task %d", stream, task->rank);
+        }
+        else if (len > 0) {
+            if (shell_output_deliver (out,
+                                    task->rank,
+                                    stream,
+                                    data,
+                                    len,
+                                    false) < 0)
+                shell_log_errno ("write %s task %d", stream, task->rank);
+        }
+        else {
+            if (shell_output_deliver (out, task->rank, stream, NULL, 0, true) < 0)
+                shell_log_errno ("write eof %s task %d", stream, task->rank);
+        }
     }
 }
 
@@ -975,11 +1140,17 @@ static int shell_output_task_init (flux_plugin_t *p,
         return -1;
 
     if (output_type_requires_service (out->stdout_type)) {
+        if (!out->line_buffer
+            && flux_cmd_setopt (task->cmd, "stdout_LINE_BUFFER", "false") < 0)
+            return -1;
         if (flux_shell_task_channel_subscribe (task, "stdout",
                                                task_output_cb, out) < 0)
             return -1;
     }
     if (output_type_requires_service (out->stderr_type)) {
+        if (!out->line_buffer
+            && flux_cmd_setopt (task->cmd, "stderr_LINE_BUFFER", "false") < 0)
+            return -1;
         if (flux_shell_task_channel_subscribe (task, "stderr",
                                                task_output_cb, out) < 0)
             return -1;
@@ -18,10 +18,12 @@
 #include <dlfcn.h>
 #include <czmq.h>
 #include <stdarg.h>
+#include <jansson.h>
 #include <flux/core.h>
 #include <flux/shell.h>
 
 #include "src/common/libutil/iterators.h"
+#include "src/common/libutil/monotime.h"
 
 #include "plugstack.h"
 
@@ -38,6 +40,13 @@ struct plugstack {
     zlistx_t *plugins;  /* Ordered list of loaded plugins                  */
     zhashx_t *names;    /* Hash for lookup of plugins by name              */
     zlistx_t *current;  /* stack holding current plugin in plugstack_call  */
+    zhashx_t *stats;    /* topic::plugin -> struct call_stats              */
+};
+
+struct call_stats {
+    int count;
+    double total_ms;
+    double max_ms;
 };
 
 void plugstack_unload_name (struct plugstack *st, const char *name)
@@ -111,6 +120,7 @@ void plugstack_destroy (struct plugstack *st)
         zlistx_destroy (&st->current);
         zhashx_destroy (&st->names);
         zhashx_destroy (&st->aux);
+        zhashx_destroy (&st->stats);
         free (st->searchpath);
         free (st);
         errno = saved_errno;
@@ -123,6 +133,14 @@ static void plugin_destroy (flux_plugin_t **pp)
     *pp = NULL;
 }
 
+static void call_stats_free (void **item)
+{
+    if (*item) {
+        free (*item);
+        *item = NULL;
+    }
+}
+
 struct plugstack * plugstack_create (void)
 {
     struct plugstack *st = calloc (1, sizeof (*st));
@@ -130,11 +148,13 @@ struct plugstack * plugstack_create (void)
         || !(st->plugins = zlistx_new ())
         || !(st->current = zlistx_new ())
         || !(st->names = zhashx_new ())
-        || !(st->aux = zhashx_new ())) {
+        || !(st->aux = zhashx_new ())
+        || !(st->stats = zhashx_new ())) {
         plugstack_destroy (st);
         return NULL;
     }
     zlistx_set_destructor (st->plugins, (czmq_destructor *) plugin_destroy);
+    zhashx_set_destructor (st->stats, call_stats_free);
     return (st);
 }
 
@@ -160,12 +180,41 @@ static zlistx_t *plugstack_list_dup (struct plugstack *st)
     return l;
 }
 
+/*  Accumulate a call duration under key "topic::plugin" for later
+ *   retrieval with plugstack_get_stats().
+ */
+static void call_stats_update (struct plugstack *st,
+                               flux_plugin_t *p,
+                               const char *topic,
+                               double ms)
+{
+    char key[256];
+    struct call_stats *stats;
+
+    if (snprintf (key,
+                  sizeof (key),
+                  "%s::%s",
+                  topic,
+                  flux_plugin_get_name (p)) >= sizeof (key))
+        return;
+    if (!(stats = zhashx_lookup (st->stats, key))) {
+        if (!(stats = calloc (1, sizeof (*stats))))
+            return;
+        zhashx_update (st->stats, key, stats);
+    }
+    stats->count++;
+    stats->total_ms += ms;
+    if (ms > stats->max_ms)
+        stats->max_ms = ms;
+}
+
 int plugstack_call (struct plugstack *st,
                     const char *name,
                     flux_plugin_arg_t *args)
 {
     int rc = 0;
     flux_plugin_t *p = NULL;
+    struct timespec t0;
 
     /* Duplicate list to make plugstack_call() reentrant.
      */
@@ -175,22 +224,59 @@ int plugstack_call (struct plugstack *st,
 
     p = zlistx_first (l);
     while (p) {
-        /*  Push plugin onto the current plugin stack */
-        void * item = zlistx_add_start (st->current, p);
-        if (flux_plugin_call (p, name, args) < 0) {
-            shell_log_error ("plugin '%s': %s failed",
-                             plugstack_current_name (st),
-                             name);
-            rc = -1;
+        /*  Skip plugins with no handler matching this topic so that
+         *   hot topics (e.g. task.exec) don't pay a no-op call into
+         *   every loaded plugin.
+         */
+        if (flux_plugin_match_handler (p, name)) {
+            /*  Push plugin onto the current plugin stack */
+            void * item = zlistx_add_start (st->current, p);
+            monotime (&t0);
+            if (flux_plugin_call (p, name, args) < 0) {
+                shell_log_error ("plugin '%s': %s failed",
+                                 plugstack_current_name (st),
+                                 name);
+                rc = -1;
+            }
+            call_stats_update (st, p, name, monotime_since (t0));
+            /* Pop plugin from the current plugin stack */
+            zlistx_detach (st->current, item);
         }
-        /* Pop plugin from the current plugin stack */
-        zlistx_detach (st->current, item);
         p = zlistx_next (l);
     }
     zlistx_destroy (&l);
     return rc;
 }
 
+json_t *plugstack_get_stats (struct plugstack *st)
+{
+    json_t *o;
+    const char *key;
+    struct call_stats *stats;
+
+    if (!st) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(o = json_object ()))
+        goto nomem;
+    FOREACH_ZHASHX (st->stats, key, stats) {
+        json_t *entry = json_pack ("{s:i s:f s:f}",
+                                   "count", stats->count,
+                                   "total_ms", stats->total_ms,
+                                   "max_ms", stats->max_ms);
+        if (!entry || json_object_set_new (o, key, entry) < 0) {
+            json_decref (entry);
+            json_decref (o);
+            goto nomem;
+        }
+    }
+    return o;
+nomem:
+    errno = ENOMEM;
+    return NULL;
+}
+
 static int plugin_aux_from_zhashx (flux_plugin_t *p, zhashx_t *aux)
 {
     const char *key;
@@ -11,6 +11,7 @@
 #ifndef _SHELL_PLUGSTACK_H
 #define _SHELL_PLUGSTACK_H
 
+#include <jansson.h>
 #include <flux/core.h>
 
 struct plugstack * plugstack_create (void);
@@ -65,6 +66,12 @@ int plugstack_call (struct plugstack *st,
  */
 const char * plugstack_current_name (struct plugstack *st);
 
+/*  Return json object of per-topic, per-plugin call counts and
+ *   durations accumulated by plugstack_call(), keyed by
+ *   "topic::plugin". Caller must release result with json_decref().
+ */
+json_t *plugstack_get_stats (struct plugstack *st);
+
 #endif /* !_SHELL_PLUGSTACK_H */
 
 /* vi: ts=4 sw=4 expandtab
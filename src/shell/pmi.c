@@ -71,10 +71,12 @@
 #include <stdlib.h>
 #include <czmq.h>
 #include <assert.h>
+#include <jansson.h>
 #include <flux/core.h>
 
 #include "src/common/libpmi/simple_server.h"
 #include "src/common/libpmi/clique.h"
+#include "src/common/libkvs/treeobj.h"
 
 #include "builtins.h"
 #include "internal.h"
@@ -197,12 +199,82 @@ out:
     return -1; // cause PMI_KVS_Get() to fail with INVALID_KEY
 }
 
+/*  Populate the local kvs cache from the exchanged pmi directory,
+ *   fetched in one lookup.  Small values are stored inline in the
+ *   directory object, so they can be decoded here without further
+ *   KVS traffic.  Anything else (e.g. a valref to an outsized value)
+ *   is left to the per-key fallback in shell_pmi_kvs_get().
+ */
+static void kvs_prefetch_continuation (flux_future_t *f, void *arg)
+{
+    struct shell_pmi *pmi = arg;
+    const char *s;
+    json_t *dir = NULL;
+    json_t *entries;
+    const char *key;
+    json_t *entry;
+
+    if (flux_kvs_lookup_get_treeobj (f, &s) < 0
+        || !(dir = treeobj_decode (s))
+        || !(entries = treeobj_get_data (dir))) {
+        if (errno != ENOENT) // no keys were exchanged
+            shell_log_errno ("pmi kvs prefetch failed");
+        goto done;
+    }
+    json_object_foreach (entries, key, entry) {
+        void *data;
+        int len;
+
+        if (!treeobj_is_val (entry))
+            continue;
+        if (treeobj_decode_val (entry, &data, &len) < 0) {
+            shell_log_errno ("pmi kvs prefetch: %s", key);
+            continue;
+        }
+        if (data) {
+            zhashx_update (pmi->kvs, key, data);
+            free (data);
+        }
+    }
+done:
+    json_decref (dir);
+    pmi_simple_server_barrier_complete (pmi->server, 0);
+    flux_future_destroy (f);
+}
+
 static void kvs_fence_continuation (flux_future_t *f, void *arg)
 {
     struct shell_pmi *pmi = arg;
     int rc;
 
     rc = flux_future_get (f, NULL);
+
+    /*  On success, prefetch the merged exchange directory before
+     *   releasing the tasks from the barrier, so the gets that follow
+     *   are serviced from the local cache instead of one KVS lookup
+     *   per key per shell.
+     */
+    if (rc == 0) {
+        char nkey[FQ_KVS_KEY_MAX];
+        flux_future_t *f2 = NULL;
+
+        if (flux_job_kvs_guest_key (nkey,
+                                    sizeof (nkey),
+                                    pmi->shell->jobid,
+                                    "pmi") < 0
+            || !(f2 = flux_kvs_lookup (pmi->shell->h,
+                                       NULL,
+                                       FLUX_KVS_READDIR,
+                                       nkey))
+            || flux_future_then (f2, -1., kvs_prefetch_continuation, pmi) < 0) {
+            shell_log_errno ("pmi kvs prefetch setup failed");
+            flux_future_destroy (f2);
+        }
+        else {
+            flux_future_destroy (f);
+            return; // barrier completed by kvs_prefetch_continuation()
+        }
+    }
     pmi_simple_server_barrier_complete (pmi->server, rc);
     flux_future_destroy (f);
 }
@@ -144,80 +144,70 @@ static int cstr_count (const char *str)
     return CPU_COUNT (&set);
 }
 
-static int rankinfo_get (json_t *o, struct rankinfo *ri)
+/* Count the total number of ranks represented by R version 1 R_lite
+ * array, where each entry specifies its ranks as an idset.
+ */
+static int rank_count (json_t *R_lite)
 {
-    json_error_t error;
-    int rc = json_unpack_ex (o, &error, 0, "{s:i, s:{s:s,s?:s}}",
-                "rank", &ri->rank,
-                "children",
-                "core", &ri->cores,
-                "gpu",  &ri->gpus);
-    if (rc < 0) {
-        fprintf (stderr, "json_unpack: %s\n", error.text);
-        return -1;
-    }
-
-    if (!ri->cores || cstr_to_cpuset (&ri->cpuset, ri->cores))
-        return -1;
+    json_t *entry;
+    size_t index;
+    int count = 0;
 
-    ri->ncores = CPU_COUNT (&ri->cpuset);
-    ri->ngpus = cstr_count (ri->gpus);
-    return (0);
+    json_array_foreach (R_lite, index, entry) {
+        const char *rank;
+        struct idset *ids;
+        if (json_unpack_ex (entry, NULL, 0, "{s:s}", "rank", &rank) < 0)
+            return -1;
+        if (!(ids = idset_decode (rank)))
+            return -1;
+        count += idset_count (ids);
+        idset_destroy (ids);
+    }
+    return count;
 }
 
-static int expand_rank_ranges_one (json_t *out, json_t *entry)
+/* Expand one R_lite entry into the flat rankinfo array starting at
+ * index '*ip'. The core and gpu sets are parsed once per entry and the
+ * result copied to every rank in the entry's idset, rather than
+ * re-parsed for each rank.
+ */
+static int rankinfo_expand (json_t *entry, struct rankinfo *ranks, int *ip)
 {
+    struct rankinfo proto = {0};
+    json_error_t error;
     const char *rank;
-    json_t *children;
     struct idset *ids;
     unsigned int id;
-    json_t *n;
 
-    if (json_unpack_ex (entry, NULL, 0,
-                        "{s:s s:o}",
-                        "rank", &rank,
-                        "children", &children) < 0)
+    if (json_unpack_ex (entry, &error, 0, "{s:s, s:{s:s,s?:s}}",
+                "rank", &rank,
+                "children",
+                "core", &proto.cores,
+                "gpu",  &proto.gpus) < 0) {
+        fprintf (stderr, "json_unpack: %s\n", error.text);
+        return -1;
+    }
+
+    if (!proto.cores || cstr_to_cpuset (&proto.cpuset, proto.cores))
         return -1;
+
+    proto.ncores = CPU_COUNT (&proto.cpuset);
+    proto.ngpus = cstr_count (proto.gpus);
+
     if (!(ids = idset_decode (rank)))
         return -1;
     id = idset_first (ids);
     while (id != IDSET_INVALID_ID) {
-        if (!(n = json_pack ("{s:i s:O}",
-                             "rank", id,
-                             "children", children)))
-            return -1;
-        if (json_array_append_new (out, n) < 0) {
-            json_decref (n);
-            return -1;
-        }
+        struct rankinfo *ri = &ranks[*ip];
+        *ri = proto;
+        ri->id = (*ip)++;
+        ri->rank = id;
         id = idset_next (ids, id);
     }
     idset_destroy (ids);
     return 0;
 }
 
-/* Convert from R version 1 internal R_lite object to the earlier wreck R_lite
- * object understood by this module.  They are the same except Rv1 specifies
- * ranks as an idset rather than integer, allowing for compact representation.
- */
-static json_t *expand_rank_ranges (json_t *R_lite)
-{
-    json_t *out;
-    json_t *entry;
-    size_t index;
-
-    if (!(out = json_array ())) // accumulate new array
-        return NULL;
-    json_array_foreach (R_lite, index, entry) {
-        if (expand_rank_ranges_one (out, entry) < 0)
-            goto error;
-    }
-    return out;
-error:
-    json_decref (out);
-    return NULL;
-}
-
 void rcalc_destroy (rcalc_t *r)
 {
     if (r == NULL)
@@ -232,8 +222,11 @@ void rcalc_destroy (rcalc_t *r)
 rcalc_t * rcalc_create_json (json_t *o)
 {
     int i;
+    int n = 0;
     int version;
     json_t *R_lite;
+    json_t *entry;
+    size_t index;
     rcalc_t *r = calloc (1, sizeof (*r));
     if (!r)
         return (NULL);
@@ -247,17 +240,24 @@ rcalc_t * rcalc_create_json (json_t *o)
         errno = EINVAL;
         goto fail;
     }
-    if (!(r->json = expand_rank_ranges (R_lite))) {
+    /*  Keep a reference on R_lite since rankinfo core/gpu strings
+     *   point into it.
+     */
+    r->json = json_incref (R_lite);
+    if ((r->nranks = rank_count (R_lite)) < 0) {
         errno = EINVAL;
         goto fail;
     }
-    r->nranks = json_array_size (r->json);
-    r->ranks = calloc (r->nranks, sizeof (struct rankinfo));
-    r->alloc = calloc (r->nranks, sizeof (struct allocinfo));
-    for (i = 0; i < r->nranks; i++) {
-        r->ranks[i].id = i;
-        if (rankinfo_get (json_array_get (r->json, i), &r->ranks[i]) < 0)
+    if (!(r->ranks = calloc (r->nranks, sizeof (struct rankinfo)))
+        || !(r->alloc = calloc (r->nranks, sizeof (struct allocinfo))))
+        goto fail;
+    json_array_foreach (R_lite, index, entry) {
+        if (rankinfo_expand (entry, r->ranks, &n) < 0) {
+            errno = EINVAL;
             goto fail;
+        }
+    }
+    for (i = 0; i < r->nranks; i++) {
         r->ncores += r->ranks[i].ncores;
         r->ngpus += r->ranks[i].ngpus;
     }
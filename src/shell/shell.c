@@ -1074,6 +1074,36 @@ static void shell_log_info (flux_shell_t *shell)
     }
 }
 
+/*  Log plugin call counts and durations gathered by the plugin stack,
+ *   for attribution of shell overhead to individual plugins.
+ */
+static void shell_log_plugin_stats (flux_shell_t *shell)
+{
+    json_t *o;
+    const char *key;
+    json_t *entry;
+
+    if (shell->verbose < 2
+        || !(o = plugstack_get_stats (shell->plugstack)))
+        return;
+    json_object_foreach (o, key, entry) {
+        int count;
+        double total_ms;
+        double max_ms;
+        if (json_unpack (entry,
+                         "{s:i s:f s:f}",
+                         "count", &count,
+                         "total_ms", &total_ms,
+                         "max_ms", &max_ms) == 0)
+            shell_trace ("%s: count=%d total=%.3fms max=%.3fms",
+                         key,
+                         count,
+                         total_ms,
+                         max_ms);
+    }
+    json_decref (o);
+}
+
 /*  Add default event context for standard shell emitted events -
  *   shell.init and shell.start.
  */
@@ -1099,6 +1129,7 @@ static int shell_register_event_context (flux_shell_t *shell)
 int main (int argc, char *argv[])
 {
     flux_shell_t shell;
+    flux_cmd_t *task_cmd_template = NULL;
     int i;
 
     /* Initialize locale from environment
@@ -1174,10 +1205,17 @@ int main (int argc, char *argv[])
      */
     if (!(shell.tasks = zlist_new ()))
         shell_die (1, "zlist_new failed");
+
+    /*  Build the shared argv/environment once rather than re-deriving
+     *   it from the jobspec for every task.
+     */
+    if (!(task_cmd_template = shell_task_cmd_template_create (shell.info)))
+        shell_die (1, "shell_task_cmd_template_create");
+
     for (i = 0; i < shell.info->rankinfo.ntasks; i++) {
         struct shell_task *task;
 
-        if (!(task = shell_task_create (shell.info, i)))
+        if (!(task = shell_task_create (shell.info, task_cmd_template, i)))
             shell_die (1, "shell_task_create index=%d", i);
 
         task->pre_exec_cb = shell_task_exec;
@@ -1218,6 +1256,7 @@ int main (int argc, char *argv[])
     /*  Reset current task since we've left task-specific context:
      */
     shell.current_task = NULL;
+    flux_cmd_destroy (task_cmd_template);
 
     if (shell_start (&shell) < 0)
         shell_die_errno (1, "shell.start callback(s) failed");
@@ -1249,6 +1288,14 @@ int main (int argc, char *argv[])
         shell.rc = 1;
     }
 
+    /*  Ensure any write-behind shell events are committed before the
+     *   shell exits, since job completion may be ordered after them.
+     */
+    if (shell.ev && shell_eventlogger_flush (shell.ev) < 0)
+        shell_log_errno ("shell_eventlogger_flush");
+
+    shell_log_plugin_stats (&shell);
+
     shell.rc = shell_max_task_exit (&shell);
     shell_debug ("exit %d", shell.rc);
 
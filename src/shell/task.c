@@ -86,33 +86,30 @@ error:
     return NULL;
 }
 
-struct shell_task *shell_task_create (struct shell_info *info,
-                                      int index)
+/*  Build the argv and environment shared by all of this shell's tasks
+ *   once, so per-task creation only has to copy it and layer on the
+ *   task-specific variables.
+ */
+flux_cmd_t *shell_task_cmd_template_create (struct shell_info *info)
 {
-    struct shell_task *task;
+    flux_cmd_t *cmd;
     const char *key;
     json_t *entry;
     size_t i;
     char buf[64];
 
-    if (!(task = shell_task_new ()))
+    if (!(cmd = flux_cmd_create (0,
+                                 NULL,
+                                 info->jobspec->environment ? NULL
+                                                            : environ)))
         return NULL;
-
-    task->index = index;
-    task->rank = info->rankinfo.global_basis + index;
-    task->size = info->total_ntasks;
-    if (!(task->cmd = flux_cmd_create (0,
-                                       NULL,
-                                       info->jobspec->environment ? NULL
-                                                                  : environ)))
-        goto error;
     json_array_foreach (info->jobspec->command, i, entry) {
-        if (flux_cmd_argv_append (task->cmd, json_string_value (entry)) < 0)
+        if (flux_cmd_argv_append (cmd, json_string_value (entry)) < 0)
             goto error;
     }
     if (info->jobspec->environment) {
         json_object_foreach (info->jobspec->environment, key, entry) {
-            if (flux_cmd_setenvf (task->cmd,
+            if (flux_cmd_setenvf (cmd,
                                   1,
                                   key,
                                   "%s",
@@ -120,34 +117,55 @@ struct shell_task *shell_task_create (struct shell_info *info,
                 goto error;
         }
     }
-    if (flux_cmd_setenvf (task->cmd, 1, "FLUX_TASK_LOCAL_ID", "%d", index) < 0)
-        goto error;
-    if (flux_cmd_setenvf (task->cmd, 1, "FLUX_TASK_RANK", "%d", task->rank) < 0)
+    if (flux_cmd_setenvf (cmd, 1, "FLUX_JOB_SIZE", "%d",
+                          info->total_ntasks) < 0)
         goto error;
-    if (flux_cmd_setenvf (task->cmd, 1, "FLUX_JOB_SIZE", "%d", task->size) < 0)
-        goto error;
-    if (flux_cmd_setenvf (task->cmd, 1, "FLUX_JOB_NNODES", "%d",
+    if (flux_cmd_setenvf (cmd, 1, "FLUX_JOB_NNODES", "%d",
                           info->shell_size) < 0)
         goto error;
 
     /* Attempt to encode jobid as F58 by default */
     if (flux_job_id_encode (info->jobid, "f58", buf, sizeof (buf)) < 0)
        snprintf (buf, sizeof (buf), "%ju", (uintmax_t)info->jobid);
-    if (flux_cmd_setenvf (task->cmd, 1, "FLUX_JOB_ID", "%s", buf) < 0)
+    if (flux_cmd_setenvf (cmd, 1, "FLUX_JOB_ID", "%s", buf) < 0)
         goto error;
 
-    flux_cmd_unsetenv (task->cmd, "FLUX_URI");
+    flux_cmd_unsetenv (cmd, "FLUX_URI");
     if (getenv ("FLUX_URI")) {
-        if (flux_cmd_setenvf (task->cmd, 1, "FLUX_URI", "%s",
+        if (flux_cmd_setenvf (cmd, 1, "FLUX_URI", "%s",
                               getenv ("FLUX_URI")) < 0)
             goto error;
     }
-    flux_cmd_unsetenv (task->cmd, "FLUX_KVS_NAMESPACE");
+    flux_cmd_unsetenv (cmd, "FLUX_KVS_NAMESPACE");
     if (getenv ("FLUX_KVS_NAMESPACE")) {
-        if (flux_cmd_setenvf (task->cmd, 1, "FLUX_KVS_NAMESPACE", "%s",
+        if (flux_cmd_setenvf (cmd, 1, "FLUX_KVS_NAMESPACE", "%s",
                               getenv ("FLUX_KVS_NAMESPACE")) < 0)
             goto error;
     }
+    return cmd;
+error:
+    flux_cmd_destroy (cmd);
+    return NULL;
+}
+
+struct shell_task *shell_task_create (struct shell_info *info,
+                                      const flux_cmd_t *cmd_template,
+                                      int index)
+{
+    struct shell_task *task;
+
+    if (!(task = shell_task_new ()))
+        return NULL;
+
+    task->index = index;
+    task->rank = info->rankinfo.global_basis + index;
+    task->size = info->total_ntasks;
+    if (!(task->cmd = flux_cmd_copy (cmd_template)))
+        goto error;
+    if (flux_cmd_setenvf (task->cmd, 1, "FLUX_TASK_LOCAL_ID", "%d", index) < 0)
+        goto error;
+    if (flux_cmd_setenvf (task->cmd, 1, "FLUX_TASK_RANK", "%d", task->rank) < 0)
+        goto error;
     return task;
 error:
     shell_task_destroy (task);
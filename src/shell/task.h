@@ -53,7 +53,14 @@ struct shell_task {
 
 void shell_task_destroy (struct shell_task *task);
 
-struct shell_task *shell_task_create (struct shell_info *info, int index);
+/* Build the command template (argv plus environment) shared by all
+ *  local tasks.
+ */
+flux_cmd_t *shell_task_cmd_template_create (struct shell_info *info);
+
+struct shell_task *shell_task_create (struct shell_info *info,
+                                      const flux_cmd_t *cmd_template,
+                                      int index);
 
 int shell_task_start (struct shell_task *task,
                       flux_reactor_t *r,
@@ -157,6 +157,8 @@ void test_load (void)
 int main (int argc, char **argv)
 {
     const char *result;
+    json_t *stats = NULL;
+    int count;
     struct plugstack *st = NULL;
     flux_plugin_t *p1 = NULL;
     flux_plugin_t *p2 = NULL;
@@ -251,6 +253,26 @@ int main (int argc, char **argv)
     ok (called_bar == 2 && called_foo == 0,
         "plugstack_call didn't call foo() only bar()");
 
+    /*  Check per-topic call stats, including that no stats entry was
+     *   created for a plugin with no matching handler.
+     */
+    ok ((stats = plugstack_get_stats (st)) != NULL,
+        "plugstack_get_stats works");
+    ok (json_unpack (stats, "{s:{s:i}}",
+                     "callback::mikey", "count", &count) == 0
+        && count == 3,
+        "stats show callback::mikey called 3 times");
+    ok (json_unpack (stats, "{s:{s:i}}",
+                     "callback::joey", "count", &count) == 0
+        && count == 2,
+        "stats show callback::joey called 2 times");
+    ok (json_object_get (stats, "check.name::joey") == NULL,
+        "no stats entry for plugin without matching handler");
+    json_decref (stats);
+    errno = 0;
+    ok (plugstack_get_stats (NULL) == NULL && errno == EINVAL,
+        "plugstack_get_stats (NULL) returns EINVAL");
+
     plugstack_destroy (st);
     flux_plugin_arg_destroy (args);
 
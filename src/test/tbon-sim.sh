@@ -0,0 +1,72 @@
+#!/bin/bash
+#
+# Run a single-node TBON scaling experiment: start SIZE brokers on
+# this node with the requested tree arity and per-hop injected
+# latency, then measure request latency to the deepest rank and
+# across all ranks with flux-ping.
+#
+# The broker's tbon.inject-latency-msec attribute holds each overlay
+# send for the configured time, so a workstation-sized instance
+# approximates the hop behavior of a large distributed one.  Useful
+# for validating TBON changes (batching, flow control) at simulated
+# scale before touching real hardware.
+#
+declare prog=$(basename $0)
+
+declare SIZE=64
+declare ARITY=2
+declare LATENCY=0
+declare COUNT=50
+declare CONCURRENCY=16
+
+declare -r long_opts="help,size:,arity:,latency:,count:,concurrency:"
+declare -r short_opts="hs:k:l:c:n:"
+declare -r usage="\
+\n\
+Usage: $prog [OPTIONS]\n\
+Single-node TBON scaling simulator.\n\
+\n\
+Options:\n\
+ -h, --help            display this message\n\
+ -s, --size=N          number of brokers to start (default=${SIZE})\n\
+ -k, --arity=K         TBON tree arity (default=${ARITY})\n\
+ -l, --latency=MSEC    injected per-hop latency in msec (default=${LATENCY})\n\
+ -c, --count=N         pings per rank (default=${COUNT})\n\
+ -n, --concurrency=N   pings kept in flight (default=${CONCURRENCY})\n"
+
+log() { local fmt=$1; shift; printf >&2 "$prog: $fmt" "$@"; }
+die() { log "$@" && exit 1; }
+
+GETOPTS=$(/usr/bin/getopt -u -o $short_opts -l $long_opts -n $prog -- $@)
+if test $? != 0; then
+    echo "$usage"
+    exit 1
+fi
+
+eval set -- "$GETOPTS"
+while true; do
+    case "$1" in
+      -s|--size)        SIZE=$2;        shift 2 ;;
+      -k|--arity)       ARITY=$2;       shift 2 ;;
+      -l|--latency)     LATENCY=$2;     shift 2 ;;
+      -c|--count)       COUNT=$2;       shift 2 ;;
+      -n|--concurrency) CONCURRENCY=$2; shift 2 ;;
+      --)               shift; break            ;;
+      -h|--help)        echo -e "$usage"; exit 0 ;;
+      *)                die "Invalid option '$1'\n$usage" ;;
+    esac
+done
+
+log "starting %d brokers, arity %d, %d msec/hop injected latency\n" \
+    $SIZE $ARITY $LATENCY
+
+exec flux start --size=$SIZE \
+    -o,-k,$ARITY,--setattr=tbon.inject-latency-msec=$LATENCY \
+    bash -c "
+        maxlevel=\$(flux getattr tbon.maxlevel)
+        echo \"tbon depth: \$maxlevel\"
+        echo '=== deepest rank ==='
+        flux ping --count=$COUNT --interval=0 $(($SIZE - 1))!cmb
+        echo '=== all ranks ==='
+        flux ping --bench --count=$COUNT --concurrency=$CONCURRENCY cmb
+    "
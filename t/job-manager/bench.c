@@ -0,0 +1,415 @@
+/************************************************************\
+ * Copyright 2014 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* bench - end-to-end job throughput benchmark with phase breakdown
+ *
+ * Submit N copies of a jobspec through job-ingest, at an optional
+ * fixed rate, while consuming job-state events to timestamp each
+ * job's state transitions.  When all jobs reach INACTIVE, report
+ * per-phase latency percentiles:
+ *
+ *   submit RPC       client send to ingest response (client clock)
+ *   depend->sched    dependency resolution in job-manager
+ *   sched->run       scheduler alloc plus exec start
+ *   run->cleanup     job execution
+ *   cleanup->inactive  cleanup and resource free
+ *
+ * plus end-to-end latency (DEPEND to INACTIVE) and sustained
+ * jobs/sec, so the module limiting throughput can be identified.
+ * Phase timestamps come from the job-state event stream and share
+ * one clock; only the submit RPC phase is measured client side.
+ *
+ * Run under an instance with scheduler and exec services loaded
+ * (or sched-dummy/exec-service for job-manager-only measurement).
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <czmq.h>
+#include <jansson.h>
+#include <flux/core.h>
+#include <flux/optparse.h>
+
+#include "src/common/libutil/log.h"
+#include "src/common/libutil/monotime.h"
+#include "src/common/libutil/tstat.h"
+#include "src/common/libutil/read_all.h"
+#include "src/common/libutil/xzmalloc.h"
+#include "src/common/libjob/job.h"
+
+/* Per-job record: submit RPC latency plus one event timestamp per
+ * state, zero until the transition is seen.
+ */
+struct jobrec {
+    double submit_ms;
+    double t_depend;
+    double t_sched;
+    double t_run;
+    double t_cleanup;
+    double t_inactive;
+};
+
+struct bench_ctx {
+    flux_t *h;
+    optparse_t *p;
+    void *jobspec;
+    int jobspecsz;
+    int totcount;
+    int txcount;
+    int rxcount;        /* submit responses */
+    int donecount;      /* jobs that reached INACTIVE */
+    int fanout;
+    double rate;        /* submissions/sec, 0=unthrottled */
+    flux_watcher_t *pace;
+    flux_msg_handler_t *mh;
+    zhash_t *jobs;      /* jobid (decimal string) => struct jobrec */
+};
+
+const char *usage_msg = "[OPTIONS] jobspec";
+static struct optparse_option opts[] =  {
+    { .name = "repeat", .key = 'r', .has_arg = 1, .arginfo = "N",
+      .usage = "Submit N instances of jobspec (default 100)",
+    },
+    { .name = "fanout", .key = 'f', .has_arg = 1, .arginfo = "N",
+      .usage = "Run at most N submit RPCs in parallel (default 256)",
+    },
+    { .name = "rate", .key = 'R', .has_arg = 1, .arginfo = "N",
+      .usage = "Submit at N jobs/sec instead of as fast as possible",
+    },
+    OPTPARSE_TABLE_END
+};
+
+/* Read entire file 'name' ("-" for stdin).  Exit program on error.
+ */
+size_t read_jobspec (const char *name, void **bufp)
+{
+    int fd;
+    ssize_t size;
+    void *buf;
+
+    if (!strcmp (name, "-"))
+        fd = STDIN_FILENO;
+    else {
+        if ((fd = open (name, O_RDONLY)) < 0)
+            log_err_exit ("%s", name);
+    }
+    if ((size = read_all (fd, &buf)) < 0)
+        log_err_exit ("%s", name);
+    if (fd != STDIN_FILENO)
+        (void)close (fd);
+    *bufp = buf;
+    return size;
+}
+
+static void submit_next (struct bench_ctx *ctx);
+
+static struct jobrec *jobrec_lookup (struct bench_ctx *ctx, flux_jobid_t id)
+{
+    char key[32];
+    struct jobrec *rec;
+
+    snprintf (key, sizeof (key), "%ju", (uintmax_t)id);
+    if (!(rec = zhash_lookup (ctx->jobs, key))) {
+        rec = xzmalloc (sizeof (*rec));
+        if (zhash_insert (ctx->jobs, key, rec) < 0)
+            log_msg_exit ("zhash_insert %s", key);
+        zhash_freefn (ctx->jobs, key, free);
+    }
+    return rec;
+}
+
+static void submit_continuation (flux_future_t *f, void *arg)
+{
+    struct bench_ctx *ctx = arg;
+    struct timespec *t0 = flux_future_aux_get (f, "t0");
+    flux_jobid_t id;
+    struct jobrec *rec;
+
+    if (flux_job_submit_get_id (f, &id) < 0) {
+        if (errno == ENOSYS)
+            log_msg_exit ("submit: job-ingest module is not loaded");
+        else
+            log_msg_exit ("submit: %s", future_strerror (f, errno));
+    }
+    rec = jobrec_lookup (ctx, id);
+    rec->submit_ms = monotime_since (*t0);
+    ctx->rxcount++;
+    flux_future_destroy (f);
+    if (!ctx->pace)
+        submit_next (ctx);
+}
+
+static void submit_one (struct bench_ctx *ctx)
+{
+    flux_future_t *f;
+    struct timespec *t0 = xzmalloc (sizeof (*t0));
+
+    monotime (t0);
+    if (!(f = flux_job_submit (ctx->h,
+                               ctx->jobspec,
+                               FLUX_JOB_PRIORITY_DEFAULT,
+                               0)))
+        log_err_exit ("flux_job_submit");
+    if (flux_future_aux_set (f, "t0", t0, free) < 0)
+        log_err_exit ("flux_future_aux_set");
+    if (flux_future_then (f, -1., submit_continuation, ctx) < 0)
+        log_err_exit ("flux_future_then");
+    ctx->txcount++;
+}
+
+/* Keep up to 'fanout' submit RPCs outstanding until all jobs have
+ * been submitted (unthrottled mode).
+ */
+static void submit_next (struct bench_ctx *ctx)
+{
+    while (ctx->txcount < ctx->totcount
+        && (ctx->txcount - ctx->rxcount) < ctx->fanout)
+        submit_one (ctx);
+}
+
+static void pace_cb (flux_reactor_t *r,
+                     flux_watcher_t *w,
+                     int revents,
+                     void *arg)
+{
+    struct bench_ctx *ctx = arg;
+
+    if (ctx->txcount < ctx->totcount
+        && (ctx->txcount - ctx->rxcount) < ctx->fanout)
+        submit_one (ctx);
+    if (ctx->txcount == ctx->totcount)
+        flux_watcher_stop (w);
+}
+
+static void job_state_cb (flux_t *h,
+                          flux_msg_handler_t *mh,
+                          const flux_msg_t *msg,
+                          void *arg)
+{
+    struct bench_ctx *ctx = arg;
+    json_t *transitions;
+    size_t index;
+    json_t *value;
+
+    if (flux_event_unpack (msg,
+                           NULL,
+                           "{s:o}",
+                           "transitions",
+                           &transitions) < 0)
+        log_err_exit ("error decoding job-state event");
+    json_array_foreach (transitions, index, value) {
+        flux_jobid_t id;
+        const char *statestr;
+        double timestamp;
+        flux_job_state_t state;
+        struct jobrec *rec;
+
+        if (json_unpack (value,
+                         "[I,s,f]",
+                         &id,
+                         &statestr,
+                         &timestamp) < 0)
+            log_msg_exit ("error decoding job-state transition");
+        if (flux_job_strtostate (statestr, &state) < 0)
+            log_msg_exit ("unknown job state %s", statestr);
+        rec = jobrec_lookup (ctx, id);
+        switch (state) {
+            case FLUX_JOB_DEPEND:
+                rec->t_depend = timestamp;
+                break;
+            case FLUX_JOB_SCHED:
+                rec->t_sched = timestamp;
+                break;
+            case FLUX_JOB_RUN:
+                rec->t_run = timestamp;
+                break;
+            case FLUX_JOB_CLEANUP:
+                rec->t_cleanup = timestamp;
+                break;
+            case FLUX_JOB_INACTIVE:
+                rec->t_inactive = timestamp;
+                ctx->donecount++;
+                break;
+            default:
+                break;
+        }
+    }
+    /* All jobs inactive - stop the event handler so the reactor can
+     * exit once remaining submit responses (if any) are consumed.
+     */
+    if (ctx->donecount == ctx->totcount) {
+        flux_msg_handler_stop (ctx->mh);
+        if (flux_event_unsubscribe (h, "job-state") < 0)
+            log_err_exit ("flux_event_unsubscribe");
+    }
+}
+
+static json_t *phase_stats (tstat_t *ts)
+{
+    json_t *o;
+
+    if (!(o = json_pack ("{s:f s:f s:f s:f s:f}",
+                         "min", tstat_min (ts),
+                         "p50", tstat_percentile (ts, 50.),
+                         "p95", tstat_percentile (ts, 95.),
+                         "p99", tstat_percentile (ts, 99.),
+                         "max", tstat_max (ts))))
+        log_err_exit ("json_pack");
+    return o;
+}
+
+static void report (struct bench_ctx *ctx)
+{
+    tstat_t submit_ts, depend_ts, sched_ts, run_ts, cleanup_ts, e2e_ts;
+    double first_depend = 0;
+    double last_inactive = 0;
+    struct jobrec *rec;
+    json_t *o;
+    char *s;
+
+    memset (&submit_ts, 0, sizeof (submit_ts));
+    memset (&depend_ts, 0, sizeof (depend_ts));
+    memset (&sched_ts, 0, sizeof (sched_ts));
+    memset (&run_ts, 0, sizeof (run_ts));
+    memset (&cleanup_ts, 0, sizeof (cleanup_ts));
+    memset (&e2e_ts, 0, sizeof (e2e_ts));
+
+    rec = zhash_first (ctx->jobs);
+    while (rec) {
+        tstat_push (&submit_ts, rec->submit_ms);
+        if (rec->t_depend > 0 && rec->t_sched > 0)
+            tstat_push (&depend_ts, (rec->t_sched - rec->t_depend) * 1E3);
+        if (rec->t_sched > 0 && rec->t_run > 0)
+            tstat_push (&sched_ts, (rec->t_run - rec->t_sched) * 1E3);
+        if (rec->t_run > 0 && rec->t_cleanup > 0)
+            tstat_push (&run_ts, (rec->t_cleanup - rec->t_run) * 1E3);
+        if (rec->t_cleanup > 0 && rec->t_inactive > 0)
+            tstat_push (&cleanup_ts,
+                        (rec->t_inactive - rec->t_cleanup) * 1E3);
+        if (rec->t_depend > 0 && rec->t_inactive > 0)
+            tstat_push (&e2e_ts, (rec->t_inactive - rec->t_depend) * 1E3);
+        if (first_depend == 0 || rec->t_depend < first_depend)
+            first_depend = rec->t_depend;
+        if (rec->t_inactive > last_inactive)
+            last_inactive = rec->t_inactive;
+        rec = zhash_next (ctx->jobs);
+    }
+
+    if (!(o = json_pack ("{s:i s:f s:{s:o s:o s:o s:o s:o s:o}}",
+                         "jobs", ctx->totcount,
+                         "throughput (jobs/sec)",
+                         last_inactive > first_depend
+                             ? ctx->totcount / (last_inactive - first_depend)
+                             : 0.,
+                         "phase latency (ms)",
+                             "submit rpc", phase_stats (&submit_ts),
+                             "depend->sched", phase_stats (&depend_ts),
+                             "sched->run", phase_stats (&sched_ts),
+                             "run->cleanup", phase_stats (&run_ts),
+                             "cleanup->inactive", phase_stats (&cleanup_ts),
+                             "end-to-end", phase_stats (&e2e_ts))))
+        log_err_exit ("json_pack");
+    if (!(s = json_dumps (o, JSON_INDENT(2))))
+        log_err_exit ("json_dumps");
+    printf ("%s\n", s);
+    json_decref (o);
+    free (s);
+}
+
+int main (int argc, char *argv[])
+{
+    optparse_t *p;
+    int optindex;
+    struct bench_ctx ctx;
+    flux_reactor_t *r;
+    struct flux_match match = FLUX_MATCH_EVENT;
+
+    memset (&ctx, 0, sizeof (ctx));
+
+    log_init ("job-bench");
+
+    p = optparse_create ("job-bench");
+    if (optparse_add_option_table (p, opts) != OPTPARSE_SUCCESS)
+        log_msg_exit ("optparse_add_option_table");
+    if (optparse_set (p, OPTPARSE_USAGE, usage_msg) != OPTPARSE_SUCCESS)
+        log_msg_exit ("optparse_set (USAGE)");
+    if ((optindex = optparse_parse_args (p, argc, argv)) < 0)
+        exit (1);
+    if (optindex != argc - 1) {
+        optparse_print_usage (p);
+        exit (1);
+    }
+    ctx.p = p;
+    ctx.totcount = optparse_get_int (p, "repeat", 100);
+    ctx.fanout = optparse_get_int (p, "fanout", 256);
+    ctx.rate = optparse_get_double (p, "rate", 0.);
+    if (ctx.totcount < 1 || ctx.fanout < 1 || ctx.rate < 0.)
+        log_msg_exit ("invalid --repeat, --fanout, or --rate");
+    ctx.jobspecsz = read_jobspec (argv[optindex++], &ctx.jobspec);
+
+    if (!(ctx.h = flux_open (NULL, 0)))
+        log_err_exit ("flux_open");
+    if (!(r = flux_get_reactor (ctx.h)))
+        log_err_exit ("flux_get_reactor");
+    if (!(ctx.jobs = zhash_new ()))
+        log_msg_exit ("zhash_new");
+
+    /* Subscribe to job-state before the first submission so no
+     * transition can be missed.
+     */
+    match.topic_glob = "job-state";
+    if (!(ctx.mh = flux_msg_handler_create (ctx.h,
+                                            match,
+                                            job_state_cb,
+                                            &ctx)))
+        log_err_exit ("flux_msg_handler_create");
+    flux_msg_handler_start (ctx.mh);
+    if (flux_event_subscribe (ctx.h, "job-state") < 0)
+        log_err_exit ("flux_event_subscribe");
+
+    if (ctx.rate > 0.) {
+        if (!(ctx.pace = flux_timer_watcher_create (r,
+                                                    1. / ctx.rate,
+                                                    1. / ctx.rate,
+                                                    pace_cb,
+                                                    &ctx)))
+            log_err_exit ("flux_timer_watcher_create");
+        flux_watcher_start (ctx.pace);
+    }
+    else
+        submit_next (&ctx);
+
+    if (flux_reactor_run (r, 0) < 0)
+        log_err_exit ("flux_reactor_run");
+
+    report (&ctx);
+
+    flux_watcher_destroy (ctx.pace);
+    flux_msg_handler_destroy (ctx.mh);
+    zhash_destroy (&ctx.jobs);
+    free (ctx.jobspec);
+    flux_close (ctx.h);
+    optparse_destroy (p);
+    log_fini ();
+
+    return 0;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
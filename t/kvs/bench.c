@@ -0,0 +1,448 @@
+/************************************************************\
+ * Copyright 2014 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* bench - parameterized KVS throughput benchmark
+ *
+ * Drive a mixed commit/lookup/watch workload against a live KVS
+ * module for a fixed duration, entirely with the async libkvs API on
+ * one reactor so the module, not the client, is the bottleneck:
+ *
+ *   - N writers, each keeping one commit in flight (or pacing at a
+ *     fixed rate), writing values with sizes drawn uniformly from a
+ *     configurable range
+ *   - M readers, each keeping one lookup in flight against keys the
+ *     writers produce
+ *   - W watchers on writer keys, counting change notifications
+ *
+ * At the end, commit latency percentiles, lookup throughput, and
+ * watch event counts are reported as JSON.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <libgen.h>
+#include <getopt.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <jansson.h>
+#include <flux/core.h>
+
+#include "src/common/libutil/log.h"
+#include "src/common/libutil/xzmalloc.h"
+#include "src/common/libutil/monotime.h"
+#include "src/common/libutil/tstat.h"
+
+struct bench;
+
+struct writer {
+    struct bench *ctx;
+    int n;
+    char *key;
+    struct timespec t0;         /* time current commit was sent */
+    flux_watcher_t *pace;       /* NULL if unthrottled */
+    bool inflight;
+    int count;
+};
+
+struct reader {
+    struct bench *ctx;
+    int n;
+    int count;
+};
+
+struct watcher {
+    struct bench *ctx;
+    int n;
+    flux_future_t *f;
+    int count;
+};
+
+struct bench {
+    flux_t *h;
+    flux_reactor_t *reactor;
+    const char *prefix;
+    int nwriters;
+    int nreaders;
+    int nwatchers;
+    double rate;                /* commits/sec per writer, 0=unthrottled */
+    double duration;            /* seconds */
+    int size_min;
+    int size_max;
+    char *value;                /* size_max bytes of fill */
+    struct writer *writers;
+    struct reader *readers;
+    struct watcher *watchers;
+    struct timespec start;
+    tstat_t commit_ts;
+    bool done;
+};
+
+#define OPTIONS "w:r:W:R:d:s:"
+static const struct option longopts[] = {
+   {"writers",     required_argument,  0, 'w'},
+   {"readers",     required_argument,  0, 'r'},
+   {"watchers",    required_argument,  0, 'W'},
+   {"rate",        required_argument,  0, 'R'},
+   {"duration",    required_argument,  0, 'd'},
+   {"value-size",  required_argument,  0, 's'},
+   {0, 0, 0, 0},
+};
+
+static void usage (void)
+{
+    fprintf (stderr,
+"Usage: bench [OPTIONS] prefix\n"
+"  -w,--writers N      number of concurrent committers (default 1)\n"
+"  -r,--readers M      number of concurrent lookups (default 1)\n"
+"  -W,--watchers W     number of watchers on writer keys (default 0)\n"
+"  -R,--rate R         commits/sec per writer (default 0=unthrottled)\n"
+"  -d,--duration S     benchmark duration in seconds (default 10)\n"
+"  -s,--value-size N[:MAX]  value size, or uniform range (default 16)\n");
+    exit (1);
+}
+
+static void writer_send (struct writer *w);
+static void reader_send (struct reader *r);
+
+static int value_size (struct bench *ctx)
+{
+    if (ctx->size_max == ctx->size_min)
+        return ctx->size_min;
+    return ctx->size_min + rand () % (ctx->size_max - ctx->size_min + 1);
+}
+
+static void commit_continuation (flux_future_t *f, void *arg)
+{
+    struct writer *w = arg;
+    struct bench *ctx = w->ctx;
+
+    if (flux_future_get (f, NULL) < 0)
+        log_err_exit ("commit %s", w->key);
+    tstat_push (&ctx->commit_ts, monotime_since (w->t0));
+    w->count++;
+    w->inflight = false;
+    flux_future_destroy (f);
+    if (!ctx->done && !w->pace)
+        writer_send (w);
+}
+
+static void writer_send (struct writer *w)
+{
+    struct bench *ctx = w->ctx;
+    flux_kvs_txn_t *txn;
+    flux_future_t *f;
+    int size = value_size (ctx);
+    char save;
+
+    if (!(txn = flux_kvs_txn_create ()))
+        log_err_exit ("flux_kvs_txn_create");
+    /* Truncate the preallocated fill string in place to avoid a
+     * per-commit allocation.
+     */
+    save = ctx->value[size];
+    ctx->value[size] = '\0';
+    if (flux_kvs_txn_pack (txn, 0, w->key, "s", ctx->value) < 0)
+        log_err_exit ("flux_kvs_txn_pack");
+    ctx->value[size] = save;
+    monotime (&w->t0);
+    if (!(f = flux_kvs_commit (ctx->h, NULL, 0, txn)))
+        log_err_exit ("flux_kvs_commit");
+    if (flux_future_then (f, -1., commit_continuation, w) < 0)
+        log_err_exit ("flux_future_then");
+    w->inflight = true;
+    flux_kvs_txn_destroy (txn);
+}
+
+static void pace_cb (flux_reactor_t *r,
+                     flux_watcher_t *watcher,
+                     int revents,
+                     void *arg)
+{
+    struct writer *w = arg;
+
+    /* If the previous commit is still in flight, the module can't
+     * sustain the requested rate; skip this tick rather than queue.
+     */
+    if (!w->ctx->done && !w->inflight)
+        writer_send (w);
+}
+
+static void lookup_continuation (flux_future_t *f, void *arg)
+{
+    struct reader *r = arg;
+
+    /* ENOENT is expected until the writers' first commits land.
+     */
+    if (flux_kvs_lookup_get (f, NULL) < 0 && errno != ENOENT)
+        log_err_exit ("flux_kvs_lookup_get");
+    r->count++;
+    flux_future_destroy (f);
+    if (!r->ctx->done)
+        reader_send (r);
+}
+
+static void reader_send (struct reader *r)
+{
+    struct bench *ctx = r->ctx;
+    flux_future_t *f;
+    char key[256];
+
+    /* Read keys the writers are producing, spread across writers.
+     */
+    snprintf (key,
+              sizeof (key),
+              "%s.w%d",
+              ctx->prefix,
+              (r->n + r->count) % ctx->nwriters);
+    if (!(f = flux_kvs_lookup (ctx->h, 0, key)))
+        log_err_exit ("flux_kvs_lookup");
+    if (flux_future_then (f, -1., lookup_continuation, r) < 0)
+        log_err_exit ("flux_future_then");
+}
+
+static void watch_continuation (flux_future_t *f, void *arg)
+{
+    struct watcher *w = arg;
+
+    if (flux_kvs_lookup_get (f, NULL) < 0) {
+        if (errno == ENODATA) {
+            flux_future_destroy (f);
+            w->f = NULL;
+            return;
+        }
+        if (errno != ENOENT)
+            log_err_exit ("watch %d", w->n);
+    }
+    w->count++;
+    flux_future_reset (f);
+}
+
+static void watcher_start (struct watcher *w)
+{
+    struct bench *ctx = w->ctx;
+    char key[256];
+
+    snprintf (key,
+              sizeof (key),
+              "%s.w%d",
+              ctx->prefix,
+              w->n % ctx->nwriters);
+    if (!(w->f = flux_kvs_lookup (ctx->h,
+                                  FLUX_KVS_WATCH | FLUX_KVS_WAITCREATE,
+                                  key)))
+        log_err_exit ("flux_kvs_lookup (watch)");
+    if (flux_future_then (w->f, -1., watch_continuation, w) < 0)
+        log_err_exit ("flux_future_then");
+}
+
+static void done_cb (flux_reactor_t *r,
+                     flux_watcher_t *watcher,
+                     int revents,
+                     void *arg)
+{
+    struct bench *ctx = arg;
+    int i;
+
+    ctx->done = true;
+    for (i = 0; i < ctx->nwriters; i++)
+        flux_watcher_stop (ctx->writers[i].pace);
+    for (i = 0; i < ctx->nwatchers; i++) {
+        if (ctx->watchers[i].f
+            && flux_kvs_lookup_cancel (ctx->watchers[i].f) < 0)
+            log_err_exit ("flux_kvs_lookup_cancel");
+    }
+    /* In-flight commits/lookups complete and the reactor exits once
+     * nothing remains pending.
+     */
+}
+
+static void report (struct bench *ctx)
+{
+    double elapsed = monotime_since (ctx->start) * 1E-3;
+    json_t *o;
+    char *s;
+    int commits = 0;
+    int lookups = 0;
+    int watch_events = 0;
+    int i;
+
+    for (i = 0; i < ctx->nwriters; i++)
+        commits += ctx->writers[i].count;
+    for (i = 0; i < ctx->nreaders; i++)
+        lookups += ctx->readers[i].count;
+    for (i = 0; i < ctx->nwatchers; i++)
+        watch_events += ctx->watchers[i].count;
+
+    if (!(o = json_pack ("{s:f s:{s:i s:f s:{s:f s:f s:f s:f s:f}}"
+                         " s:{s:i s:f} s:{s:i s:f}}",
+                         "elapsed (sec)", elapsed,
+                         "commits",
+                             "count", commits,
+                             "throughput (#/sec)", commits / elapsed,
+                             "latency (ms)",
+                                 "min", tstat_min (&ctx->commit_ts),
+                                 "p50", tstat_percentile (&ctx->commit_ts,
+                                                          50.),
+                                 "p95", tstat_percentile (&ctx->commit_ts,
+                                                          95.),
+                                 "p99", tstat_percentile (&ctx->commit_ts,
+                                                          99.),
+                                 "max", tstat_max (&ctx->commit_ts),
+                         "lookups",
+                             "count", lookups,
+                             "throughput (#/sec)", lookups / elapsed,
+                         "watch",
+                             "events", watch_events,
+                             "events/sec", watch_events / elapsed)))
+        log_err_exit ("json_pack");
+    if (!(s = json_dumps (o, JSON_INDENT(2))))
+        log_err_exit ("json_dumps");
+    printf ("%s\n", s);
+    json_decref (o);
+    free (s);
+}
+
+static void parse_value_size (struct bench *ctx, const char *s)
+{
+    char *cpy = xstrdup (s);
+    char *max;
+
+    if ((max = strchr (cpy, ':')))
+        *max++ = '\0';
+    ctx->size_min = strtoul (cpy, NULL, 10);
+    ctx->size_max = max ? strtoul (max, NULL, 10) : ctx->size_min;
+    if (ctx->size_min < 1 || ctx->size_max < ctx->size_min)
+        log_msg_exit ("invalid --value-size");
+    free (cpy);
+}
+
+int main (int argc, char *argv[])
+{
+    struct bench ctx;
+    flux_watcher_t *dw;
+    int ch, i;
+
+    log_init (basename (argv[0]));
+
+    memset (&ctx, 0, sizeof (ctx));
+    ctx.nwriters = 1;
+    ctx.nreaders = 1;
+    ctx.duration = 10.;
+    ctx.size_min = 16;
+    ctx.size_max = 16;
+
+    while ((ch = getopt_long (argc, argv, OPTIONS, longopts, NULL)) != -1) {
+        switch (ch) {
+            case 'w':
+                ctx.nwriters = strtoul (optarg, NULL, 10);
+                break;
+            case 'r':
+                ctx.nreaders = strtoul (optarg, NULL, 10);
+                break;
+            case 'W':
+                ctx.nwatchers = strtoul (optarg, NULL, 10);
+                break;
+            case 'R':
+                ctx.rate = strtod (optarg, NULL);
+                break;
+            case 'd':
+                ctx.duration = strtod (optarg, NULL);
+                break;
+            case 's':
+                parse_value_size (&ctx, optarg);
+                break;
+            default:
+                usage ();
+        }
+    }
+    if (argc - optind != 1)
+        usage ();
+    ctx.prefix = argv[optind++];
+    if (ctx.nwriters < 1 || ctx.duration <= 0.)
+        log_msg_exit ("writers must be > 0 and duration > 0");
+
+    ctx.value = xzmalloc (ctx.size_max + 1);
+    memset (ctx.value, 'v', ctx.size_max);
+
+    if (!(ctx.h = flux_open (NULL, 0)))
+        log_err_exit ("flux_open");
+    if (!(ctx.reactor = flux_get_reactor (ctx.h)))
+        log_err_exit ("flux_get_reactor");
+
+    ctx.writers = xzmalloc (sizeof (ctx.writers[0]) * ctx.nwriters);
+    for (i = 0; i < ctx.nwriters; i++) {
+        struct writer *w = &ctx.writers[i];
+        w->ctx = &ctx;
+        w->n = i;
+        w->key = xasprintf ("%s.w%d", ctx.prefix, i);
+        if (ctx.rate > 0.) {
+            if (!(w->pace = flux_timer_watcher_create (ctx.reactor,
+                                                       1. / ctx.rate,
+                                                       1. / ctx.rate,
+                                                       pace_cb,
+                                                       w)))
+                log_err_exit ("flux_timer_watcher_create");
+            flux_watcher_start (w->pace);
+        }
+    }
+    if (ctx.nreaders > 0)
+        ctx.readers = xzmalloc (sizeof (ctx.readers[0]) * ctx.nreaders);
+    for (i = 0; i < ctx.nreaders; i++) {
+        ctx.readers[i].ctx = &ctx;
+        ctx.readers[i].n = i;
+    }
+    if (ctx.nwatchers > 0)
+        ctx.watchers = xzmalloc (sizeof (ctx.watchers[0]) * ctx.nwatchers);
+    for (i = 0; i < ctx.nwatchers; i++) {
+        ctx.watchers[i].ctx = &ctx;
+        ctx.watchers[i].n = i;
+        watcher_start (&ctx.watchers[i]);
+    }
+
+    if (!(dw = flux_timer_watcher_create (ctx.reactor,
+                                          ctx.duration,
+                                          0.,
+                                          done_cb,
+                                          &ctx)))
+        log_err_exit ("flux_timer_watcher_create");
+    flux_watcher_start (dw);
+
+    monotime (&ctx.start);
+    for (i = 0; i < ctx.nwriters; i++) {
+        if (ctx.rate == 0.)
+            writer_send (&ctx.writers[i]);
+    }
+    for (i = 0; i < ctx.nreaders; i++)
+        reader_send (&ctx.readers[i]);
+
+    if (flux_reactor_run (ctx.reactor, 0) < 0)
+        log_err_exit ("flux_reactor_run");
+
+    report (&ctx);
+
+    flux_watcher_destroy (dw);
+    for (i = 0; i < ctx.nwriters; i++) {
+        flux_watcher_destroy (ctx.writers[i].pace);
+        free (ctx.writers[i].key);
+    }
+    free (ctx.writers);
+    free (ctx.readers);
+    free (ctx.watchers);
+    free (ctx.value);
+    flux_close (ctx.h);
+    log_fini ();
+
+    return 0;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -445,6 +445,44 @@ test_expect_success 'kvs: put --raw a=- b=- works with a getting all of stdin' '
 	test_cmp /dev/null rawstdin3b.actual
 '
 
+#
+# get/put --stream tests
+#
+test_expect_success 'kvs: put/get --stream roundtrips a small value' '
+	flux kvs unlink -Rf $DIR &&
+	printf "%s" "abc" | flux kvs put --stream $DIR.a=- &&
+	printf "%s" "abc" >stream.expected &&
+	flux kvs get --stream $DIR.a >stream.actual &&
+	test_cmp stream.expected stream.actual
+'
+test_expect_success 'kvs: put/get --stream roundtrips a multi-chunk value' '
+	flux kvs unlink -Rf $DIR &&
+	dd if=/dev/urandom of=stream.large bs=1M count=3 2>/dev/null &&
+	flux kvs put --stream $DIR.a=- <stream.large &&
+	flux kvs get --stream $DIR.a >stream.large.actual &&
+	test_cmp stream.large stream.large.actual
+'
+test_expect_success 'kvs: put --stream stores multi-chunk value as valref' '
+	flux kvs get --treeobj $DIR.a | grep -q valref
+'
+test_expect_success 'kvs: get --stream works on a value stored with put --raw' '
+	flux kvs put --raw $DIR.b=foo &&
+	printf "%s" "foo" >streamval.expected &&
+	flux kvs get --stream $DIR.b >streamval.actual &&
+	test_cmp streamval.expected streamval.actual
+'
+test_expect_success 'kvs: put/get --stream roundtrips an empty value' '
+	printf "%s" "" | flux kvs put --stream $DIR.c=- &&
+	flux kvs get --stream $DIR.c >stream.empty.actual &&
+	test_cmp /dev/null stream.empty.actual
+'
+test_expect_success 'kvs: put --stream requires key=-' '
+	test_must_fail flux kvs put --stream $DIR.d=42
+'
+test_expect_success 'kvs: get --stream fails on a directory' '
+	test_must_fail flux kvs get --stream $DIR
+'
+
 #
 # get/put --treeobj tests
 #
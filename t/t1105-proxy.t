@@ -80,4 +80,43 @@ test_expect_success 'flux-proxy fails with unknown URI path (ENOENT)' '
 	grep "No such file or directory" badpath.err
 '
 
+test_expect_success 'flux-proxy --daemon rejects COMMAND' '
+	test_must_fail flux proxy --daemon $TEST_URI /bin/true
+'
+
+test_expect_success 'flux-proxy --stop fails when no daemon is running' '
+	test_must_fail flux proxy --stop $TEST_URI 2>nodaemon.err &&
+	grep "no proxy daemon" nodaemon.err
+'
+
+test_expect_success 'flux-proxy --daemon starts and is reused' '
+	flux proxy --daemon $TEST_URI &&
+	PROXY_URI1=$(flux proxy $TEST_URI printenv FLUX_URI) &&
+	PROXY_URI2=$(flux proxy $TEST_URI printenv FLUX_URI) &&
+	test "$PROXY_URI1" = "$PROXY_URI2" &&
+	test "$PROXY_URI1" != "$TEST_URI"
+'
+
+test_expect_success 'flux-proxy --daemon is idempotent' '
+	flux proxy --daemon $TEST_URI 2>daemon2.err &&
+	grep "already running" daemon2.err
+'
+
+test_expect_success 'flux-proxy commands work through the daemon' '
+	ATTR_SIZE=$(flux proxy $TEST_URI flux getattr size) &&
+	test "$ATTR_SIZE" = "$SIZE" &&
+	flux proxy $TEST_URI /bin/true &&
+	! flux proxy $TEST_URI /bin/false
+'
+
+test_expect_success 'flux-proxy --stop terminates the daemon' '
+	flux proxy --stop $TEST_URI &&
+	for i in $(seq 1 50); do
+		PROXY_URI=$(flux proxy $TEST_URI printenv FLUX_URI)
+		test "$PROXY_URI" != "$PROXY_URI1" && break
+		sleep 0.1
+	done &&
+	test "$PROXY_URI" != "$PROXY_URI1"
+'
+
 test_done